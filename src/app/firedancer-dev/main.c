@@ -27,6 +27,7 @@ extern fd_topo_obj_callbacks_t fd_obj_cb_bank_hash_cmp;
 
 extern fd_topo_obj_callbacks_t fd_obj_cb_vinyl_meta;
 extern fd_topo_obj_callbacks_t fd_obj_cb_vinyl_meta_ele;
+extern fd_topo_obj_callbacks_t fd_obj_cb_vinyl_data;
 
 fd_topo_obj_callbacks_t * CALLBACKS[] = {
   &fd_obj_cb_mcache,
@@ -47,6 +48,7 @@ fd_topo_obj_callbacks_t * CALLBACKS[] = {
   &fd_obj_cb_bank_hash_cmp,
   &fd_obj_cb_vinyl_meta,
   &fd_obj_cb_vinyl_meta_ele,
+  &fd_obj_cb_vinyl_data,
   NULL,
 };
 
@@ -112,6 +114,8 @@ extern fd_topo_run_tile_t fd_tile_snapld;
 extern fd_topo_run_tile_t fd_tile_snapdc;
 extern fd_topo_run_tile_t fd_tile_snapin;
 extern fd_topo_run_tile_t fd_tile_snapwr;
+extern fd_topo_run_tile_t fd_tile_ledger;
+extern fd_topo_run_tile_t fd_tile_vinyl;
 
 fd_topo_run_tile_t * TILES[] = {
   &fd_tile_net,
@@ -159,6 +163,8 @@ fd_topo_run_tile_t * TILES[] = {
   &fd_tile_snapdc,
   &fd_tile_snapin,
   &fd_tile_snapwr,
+  &fd_tile_ledger,
+  &fd_tile_vinyl,
   &fd_tile_genesi,
   &fd_tile_ipecho,
   NULL,
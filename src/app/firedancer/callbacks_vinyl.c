@@ -82,3 +82,25 @@ fd_topo_obj_callbacks_t fd_obj_cb_vinyl_meta_ele = {
   .align     = vinyl_meta_ele_align,
   .new       = vinyl_meta_ele_new,
 };
+
+/* vinyl_data: data region of the vinyl tile, shared with its clients
+   (initialized by the vinyl tile) */
+
+static ulong
+vinyl_data_align( fd_topo_t const *     topo,
+                  fd_topo_obj_t const * obj ) {
+  (void)topo; (void)obj;
+  return fd_vinyl_data_align();
+}
+
+static ulong
+vinyl_data_footprint( fd_topo_t const *     topo,
+                      fd_topo_obj_t const * obj ) {
+  return fd_vinyl_data_footprint( VAL("line_cnt"), VAL("val_max") );
+}
+
+fd_topo_obj_callbacks_t fd_obj_cb_vinyl_data = {
+  .name      = "vinyl_data",
+  .footprint = vinyl_data_footprint,
+  .align     = vinyl_data_align,
+};
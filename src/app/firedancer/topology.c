@@ -4,6 +4,7 @@
 #include "../../discof/reasm/fd_reasm.h"
 #include "../../discof/poh/fd_poh.h"
 #include "../../discof/replay/fd_exec.h"
+#include "../../discof/replay/fd_rdisp.h"
 #include "../../discof/gossip/fd_gossip_tile.h"
 #include "../../discof/tower/fd_tower_tile.h"
 #include "../../discof/resolv/fd_resolv_tile.h"
@@ -16,12 +17,16 @@
 #include "../../disco/tiles.h"
 #include "../../disco/topo/fd_topob.h"
 #include "../../disco/topo/fd_cpu_topo.h"
+#include "../../disco/verify/fd_verify_tile.h"
 #include "../../util/pod/fd_pod_format.h"
 #include "../../util/tile/fd_tile_private.h"
 #include "../../discof/restore/utils/fd_ssctrl.h"
 #include "../../discof/restore/utils/fd_ssmsg.h"
 #include "../../flamenco/progcache/fd_progcache_admin.h"
+#include "../../flamenco/runtime/fd_runtime_const.h"
+#include "../../vinyl/io/fd_vinyl_io.h"
 #include "../../vinyl/meta/fd_vinyl_meta.h"
+#include "../../vinyl/rq/fd_vinyl_rq.h"
 
 #include <sys/random.h>
 #include <sys/types.h>
@@ -151,6 +156,13 @@ setup_topo_txncache( fd_topo_t *  topo,
   return obj;
 }
 
+/* VINYL_LINE_CNT is the number of data lines of the vinyl tile (the
+   max number of accounts Replay roots per request) and VINYL_VAL_MAX
+   fits the largest account. */
+
+#define VINYL_LINE_CNT (16UL)
+#define VINYL_VAL_MAX  (sizeof(fd_account_meta_t)+FD_RUNTIME_ACC_SZ_MAX)
+
 void
 setup_topo_vinyl( fd_topo_t *    topo,
                   fd_configf_t * config ) {
@@ -265,6 +277,7 @@ fd_topo_initialize( config_t * config ) {
 
   int snapshots_enabled = !!config->gossip.entrypoints_cnt;
   int vinyl_enabled     = !!config->firedancer.vinyl.enabled;
+  int ledger_enabled    = !!config->firedancer.store.ledger_path[0];
 
   fd_topo_t * topo = fd_topob_new( &config->topo, config->name );
 
@@ -309,6 +322,7 @@ fd_topo_initialize( config_t * config ) {
 
   fd_topob_wksp( topo, "shred_out"    );
   fd_topob_wksp( topo, "replay_stake" );
+  fd_topob_wksp( topo, "replay_stage" );
   fd_topob_wksp( topo, "replay_exec"  );
   fd_topob_wksp( topo, "replay_out"   );
   fd_topob_wksp( topo, "tower_out"    );
@@ -350,6 +364,12 @@ fd_topo_initialize( config_t * config ) {
 
   fd_topob_wksp( topo, "exec_sig"     );
 
+  if( ledger_enabled ) {
+    fd_topob_wksp( topo, "ledger"       );
+    fd_topob_wksp( topo, "replay_ledgr" );
+    fd_topob_wksp( topo, "ledger_out"   );
+  }
+
   fd_topob_wksp( topo, "cswtch"       );
 
   if( FD_LIKELY( snapshots_enabled ) ) {
@@ -374,6 +394,13 @@ fd_topo_initialize( config_t * config ) {
     fd_topob_wksp( topo, "snapct_repr"  );
   }
 
+  if( vinyl_enabled ) {
+    setup_topo_vinyl( topo, &config->firedancer ); /* creates the vinyl wksp */
+
+    fd_topob_wksp( topo, "replay_vinyl" );
+    fd_topob_wksp( topo, "vinyl_replay" );
+  }
+
   #define FOR(cnt) for( ulong i=0UL; i<cnt; i++ )
 
   /* TODO: Explain this .... USHORT_MAX is not dcache max */
@@ -410,11 +437,21 @@ fd_topo_initialize( config_t * config ) {
   /**/                 fd_topob_link( topo, "gossip_out",   "gossip_out",   65536UL*4UL,                              sizeof(fd_gossip_update_message_t), 1UL ); /* TODO: Unclear where this depth comes from ... fix */
 
   FOR(quic_tile_cnt)   fd_topob_link( topo, "quic_verify",  "quic_verify",  config->tiles.verify.receive_buffer_size, FD_TPU_REASM_MTU,              config->tiles.quic.txn_reassembly_count );
-  FOR(verify_tile_cnt) fd_topob_link( topo, "verify_dedup", "verify_dedup", config->tiles.verify.receive_buffer_size, FD_TPU_PARSED_MTU,             1UL );
+  FOR(verify_tile_cnt) fd_topob_link( topo, "verify_dedup", "verify_dedup", config->tiles.verify.receive_buffer_size, FD_TPU_PARSED_MTU,             FD_VERIFY_BATCH_TXN_MAX );
   /**/                 fd_topob_link( topo, "dedup_resolv", "dedup_resolv", 65536UL,                                  FD_TPU_PARSED_MTU,             1UL );
   FOR(resolv_tile_cnt) fd_topob_link( topo, "resolv_pack",  "resolv_pack",  65536UL,                                  FD_TPU_RESOLVED_MTU,           1UL );
   /**/                 fd_topob_link( topo, "replay_stake", "replay_stake", 128UL,                                    FD_STAKE_OUT_MTU,              1UL ); /* TODO: This should be 2 but requires fixing STEM_BURST */
+  /**/                 fd_topob_link( topo, "replay_stage", "replay_stage", 16UL,                                     FD_STAKE_OUT_MTU,              1UL ); /* Once per epoch */
   /**/                 fd_topob_link( topo, "replay_out",   "replay_out",   8192UL,                                   sizeof(fd_replay_message_t),   1UL );
+  if( vinyl_enabled ) {
+    /* Replay has at most one request in flight */
+                       fd_topob_link( topo, "replay_vinyl", "replay_vinyl", 16UL,                                     fd_vinyl_req_sz ( FD_VINYL_REQ_BATCH_MAX ), 1UL );
+                       fd_topob_link( topo, "vinyl_replay", "vinyl_replay", 16UL,                                     fd_vinyl_comp_sz( FD_VINYL_REQ_BATCH_MAX ), 1UL );
+  }
+  if( ledger_enabled ) {
+                       fd_topob_link( topo, "replay_ledgr", "replay_ledgr", 128UL,                                    sizeof(fd_hash_t),             1UL );
+                       fd_topob_link( topo, "ledger_out",   "ledger_out",   4096UL,                                   FD_SHRED_OUT_MTU,              1UL );
+  }
   /**/                 fd_topob_link( topo, "pack_poh",     "pack_poh",     128UL,                                    sizeof(fd_done_packing_t),     1UL );
   /* pack_bank is shared across all banks, so if one bank stalls due to complex transactions, the buffer neeeds to be large so that
      other banks can keep proceeding. */
@@ -497,6 +534,8 @@ fd_topo_initialize( config_t * config ) {
   FOR(shred_tile_cnt)  fd_topob_tile( topo, "shred",   "shred",   "metric_in",  tile_to_cpu[ topo->tile_cnt ], 0,        1 );
   /**/                 fd_topob_tile( topo, "repair",  "repair",  "metric_in",  tile_to_cpu[ topo->tile_cnt ], 0,        0 ); /* TODO: Wrong? Needs to use keyswitch as signs */
   /**/                 fd_topob_tile( topo, "replay",  "replay",  "metric_in",  tile_to_cpu[ topo->tile_cnt ], 0,        0 );
+  if( ledger_enabled ) fd_topob_tile( topo, "ledger",  "ledger",  "metric_in",  tile_to_cpu[ topo->tile_cnt ], 0,        0 );
+  if( vinyl_enabled )  fd_topob_tile( topo, "vinyl",   "vinyl",   "metric_in",  tile_to_cpu[ topo->tile_cnt ], 0,        0 );
   FOR(exec_tile_cnt)   fd_topob_tile( topo, "exec",    "exec",    "metric_in",  tile_to_cpu[ topo->tile_cnt ], 0,        0 );
   /**/                 fd_topob_tile( topo, "tower",   "tower",   "metric_in",  tile_to_cpu[ topo->tile_cnt ], 0,        0 );
   /**/                 fd_topob_tile( topo, "send",    "send",    "metric_in",  tile_to_cpu[ topo->tile_cnt ], 0,        0 );
@@ -520,8 +559,7 @@ fd_topo_initialize( config_t * config ) {
   FOR(net_tile_cnt)   fd_topob_tile_in(     topo, "repair",  0UL,          "metric_in", "net_repair",   i,            FD_TOPOB_UNRELIABLE, FD_TOPOB_POLLED ); /* No reliable consumers of networking fragments, may be dropped or overrun */
   /**/                fd_topob_tile_out(    topo, "repair",  0UL,                       "repair_net",   0UL                                                );
   FOR(net_tile_cnt)   fd_topob_tile_in (    topo, "send",    0UL,          "metric_in", "net_send",     i,            FD_TOPOB_UNRELIABLE, FD_TOPOB_POLLED ); /* No reliable consumers of networking fragments, may be dropped or overrun */
-  FOR(quic_tile_cnt) for( ulong j=0UL; j<net_tile_cnt; j++ )
-                      fd_topob_tile_in(     topo, "quic",    i,            "metric_in", "net_quic",     j,            FD_TOPOB_UNRELIABLE, FD_TOPOB_POLLED ); /* No reliable consumers of networking fragments, may be dropped or overrun */
+  FOR(quic_tile_cnt)   fd_topos_tile_in_net_rx( topo, "quic", i, "metric_in", "net_quic", config->tiles.quic.net_affinity ); /* No reliable consumers of networking fragments, may be dropped or overrun */
 
   FOR(shred_tile_cnt) fd_topos_tile_in_net( topo,                          "metric_in", "shred_net",    i,            FD_TOPOB_UNRELIABLE, FD_TOPOB_POLLED ); /* No reliable consumers of networking fragments, may be dropped or overrun */
   /**/                fd_topos_tile_in_net( topo,                          "metric_in", "gossip_net",   0UL,          FD_TOPOB_UNRELIABLE, FD_TOPOB_POLLED ); /* No reliable consumers of networking fragments, may be dropped or overrun */
@@ -587,6 +625,7 @@ fd_topo_initialize( config_t * config ) {
   /**/                 fd_topob_tile_in (   topo, "replay",  0UL,          "metric_in", "genesi_out",   0UL,          FD_TOPOB_RELIABLE,   FD_TOPOB_POLLED );
   /**/                 fd_topob_tile_out(   topo, "replay",  0UL,                       "replay_out",   0UL                                                );
   /**/                 fd_topob_tile_out(   topo, "replay",  0UL,                       "replay_stake", 0UL                                                );
+  /**/                 fd_topob_tile_out(   topo, "replay",  0UL,                       "replay_stage", 0UL                                                );
   /**/                 fd_topob_tile_out(   topo, "replay",  0UL,                       "executed_txn", 0UL                                                );
   /**/                 fd_topob_tile_out(   topo, "replay",  0UL,                       "replay_exec",  0UL                                                );
   /**/                 fd_topob_tile_in (   topo, "replay",  0UL,          "metric_in", "tower_out",    0UL,          FD_TOPOB_RELIABLE,   FD_TOPOB_POLLED );
@@ -597,6 +636,19 @@ fd_topo_initialize( config_t * config ) {
   }
 
   /**/                 fd_topob_tile_in(    topo, "replay",  0UL,          "metric_in", "poh_replay",   0UL,          FD_TOPOB_RELIABLE,   FD_TOPOB_POLLED );
+  if( ledger_enabled ) {
+                       fd_topob_tile_out(   topo, "replay",  0UL,                       "replay_ledgr", 0UL                                                );
+                       fd_topob_tile_in (   topo, "ledger",  0UL,          "metric_in", "replay_ledgr", 0UL,          FD_TOPOB_RELIABLE,   FD_TOPOB_POLLED );
+                       fd_topob_tile_in (   topo, "ledger",  0UL,          "metric_in", "replay_out",   0UL,          FD_TOPOB_UNRELIABLE, FD_TOPOB_POLLED ); /* Replay waits on ledger_out, so must not be backpressured by the ledger tile */
+                       fd_topob_tile_out(   topo, "ledger",  0UL,                       "ledger_out",   0UL                                                );
+                       fd_topob_tile_in (   topo, "replay",  0UL,          "metric_in", "ledger_out",   0UL,          FD_TOPOB_RELIABLE,   FD_TOPOB_POLLED );
+  }
+  if( vinyl_enabled ) {
+                       fd_topob_tile_out(   topo, "replay",  0UL,                       "replay_vinyl", 0UL                                                );
+                       fd_topob_tile_in (   topo, "vinyl",   0UL,          "metric_in", "replay_vinyl", 0UL,          FD_TOPOB_RELIABLE,   FD_TOPOB_POLLED   );
+                       fd_topob_tile_out(   topo, "vinyl",   0UL,                       "vinyl_replay", 0UL                                                );
+                       fd_topob_tile_in (   topo, "replay",  0UL,          "metric_in", "vinyl_replay", 0UL,          FD_TOPOB_UNRELIABLE, FD_TOPOB_UNPOLLED ); /* Read by Replay's vinyl client while rooting */
+  }
   FOR(exec_tile_cnt)   fd_topob_tile_in(    topo, "exec",    i,            "metric_in", "replay_exec",  0UL,          FD_TOPOB_RELIABLE,   FD_TOPOB_POLLED );
   /**/                 fd_topob_tile_in (   topo, "tower",   0UL,          "metric_in", "genesi_out",   0UL,          FD_TOPOB_RELIABLE,   FD_TOPOB_POLLED );
   /**/                 fd_topob_tile_in (   topo, "tower",   0UL,          "metric_in", "replay_out",   0UL,          FD_TOPOB_RELIABLE,   FD_TOPOB_POLLED );
@@ -642,6 +694,7 @@ fd_topo_initialize( config_t * config ) {
   /**/                 fd_topob_tile_out(   topo, "poh",     0UL,                       "poh_shred",    0UL                                                );
   /**/                 fd_topob_tile_out(   topo, "poh",     0UL,                       "poh_replay",   0UL                                                );
   FOR(shred_tile_cnt)  fd_topob_tile_in (   topo, "shred",   i,            "metric_in", "replay_stake", 0UL,          FD_TOPOB_RELIABLE,   FD_TOPOB_POLLED );
+  FOR(shred_tile_cnt)  fd_topob_tile_in (   topo, "shred",   i,            "metric_in", "replay_stage", 0UL,          FD_TOPOB_RELIABLE,   FD_TOPOB_POLLED );
   FOR(shred_tile_cnt)  fd_topob_tile_in (   topo, "shred",   i,            "metric_in", "gossip_out",   0UL,          FD_TOPOB_RELIABLE,   FD_TOPOB_POLLED );
   FOR(shred_tile_cnt)  fd_topob_tile_out(   topo, "shred",   i,                         "shred_out",    i                                                  );
   FOR(shred_tile_cnt)  fd_topob_tile_in (   topo, "shred",   i,            "metric_in", "repair_shred", i,            FD_TOPOB_RELIABLE,   FD_TOPOB_POLLED );
@@ -871,8 +924,11 @@ fd_topo_initialize( config_t * config ) {
   fd_topob_tile_uses( topo, &topo->tiles[ fd_topo_find_tile( topo, "repair", 0UL ) ], fec_sets_obj, FD_SHMEM_JOIN_MODE_READ_ONLY );
   FD_TEST( fd_pod_insertf_ulong( topo->props, fec_sets_obj->id, "fec_sets" ) );
 
-  fd_topo_obj_t * store_obj = setup_topo_store( topo, "store", config->firedancer.store.max_completed_shred_sets, (uint)shred_tile_cnt );
+  /* The ledger tile writes to the store when feeding rooted slots back
+     on restart, so it gets the partition after the Shred tiles. */
+  fd_topo_obj_t * store_obj = setup_topo_store( topo, "store", config->firedancer.store.max_completed_shred_sets, (uint)(shred_tile_cnt+(ulong)ledger_enabled) );
   FOR(shred_tile_cnt) fd_topob_tile_uses( topo, &topo->tiles[ fd_topo_find_tile( topo, "shred", i ) ], store_obj, FD_SHMEM_JOIN_MODE_READ_WRITE );
+  if( ledger_enabled ) fd_topob_tile_uses( topo, &topo->tiles[ fd_topo_find_tile( topo, "ledger", 0UL ) ], store_obj, FD_SHMEM_JOIN_MODE_READ_WRITE );
   fd_topob_tile_uses( topo, &topo->tiles[ fd_topo_find_tile( topo, "repair", 0UL ) ], store_obj, FD_SHMEM_JOIN_MODE_READ_WRITE );
   fd_topob_tile_uses( topo, &topo->tiles[ fd_topo_find_tile( topo, "replay", 0UL ) ], store_obj, FD_SHMEM_JOIN_MODE_READ_WRITE );
   FD_TEST( fd_pod_insertf_ulong( topo->props, store_obj->id, "store" ) );
@@ -891,6 +947,32 @@ fd_topo_initialize( config_t * config ) {
   fd_topob_tile_uses( topo, &topo->tiles[ fd_topo_find_tile( topo, "genesi", 0UL ) ], funk_obj, FD_SHMEM_JOIN_MODE_READ_WRITE );
   if( FD_LIKELY( snapshots_enabled ) ) fd_topob_tile_uses( topo, &topo->tiles[ fd_topo_find_tile( topo, "snapin", 0UL ) ], funk_obj, FD_SHMEM_JOIN_MODE_READ_WRITE );
 
+  if( vinyl_enabled ) {
+    /* Snapin populates the meta, the vinyl tile then owns it.  Replay
+       queries it and copies rooted accounts into the data region. */
+    fd_topo_obj_t * vinyl_map_obj  = &topo->objs[ fd_pod_query_ulong( topo->props, "vinyl.meta_map",  ULONG_MAX ) ];
+    fd_topo_obj_t * vinyl_pool_obj = &topo->objs[ fd_pod_query_ulong( topo->props, "vinyl.meta_pool", ULONG_MAX ) ];
+
+    fd_topo_obj_t * vinyl_data_obj = fd_topob_obj( topo, "vinyl_data", "vinyl" );
+    FD_TEST( fd_pod_insertf_ulong( topo->props, VINYL_LINE_CNT, "obj.%lu.line_cnt", vinyl_data_obj->id ) );
+    FD_TEST( fd_pod_insertf_ulong( topo->props, VINYL_VAL_MAX,  "obj.%lu.val_max",  vinyl_data_obj->id ) );
+    FD_TEST( fd_pod_insert_ulong ( topo->props, "vinyl.data", vinyl_data_obj->id ) );
+
+    fd_topo_tile_t * vinyl_tile  = &topo->tiles[ fd_topo_find_tile( topo, "vinyl",  0UL ) ];
+    fd_topo_tile_t * replay_tile = &topo->tiles[ fd_topo_find_tile( topo, "replay", 0UL ) ];
+    fd_topob_tile_uses( topo, vinyl_tile,  vinyl_map_obj,  FD_SHMEM_JOIN_MODE_READ_WRITE );
+    fd_topob_tile_uses( topo, vinyl_tile,  vinyl_pool_obj, FD_SHMEM_JOIN_MODE_READ_WRITE );
+    fd_topob_tile_uses( topo, vinyl_tile,  vinyl_data_obj, FD_SHMEM_JOIN_MODE_READ_WRITE );
+    fd_topob_tile_uses( topo, replay_tile, vinyl_map_obj,  FD_SHMEM_JOIN_MODE_READ_ONLY  );
+    fd_topob_tile_uses( topo, replay_tile, vinyl_pool_obj, FD_SHMEM_JOIN_MODE_READ_ONLY  );
+    fd_topob_tile_uses( topo, replay_tile, vinyl_data_obj, FD_SHMEM_JOIN_MODE_READ_WRITE );
+    if( FD_LIKELY( snapshots_enabled ) ) {
+      fd_topo_tile_t * snapin_tile = &topo->tiles[ fd_topo_find_tile( topo, "snapin", 0UL ) ];
+      fd_topob_tile_uses( topo, snapin_tile, vinyl_map_obj,  FD_SHMEM_JOIN_MODE_READ_WRITE );
+      fd_topob_tile_uses( topo, snapin_tile, vinyl_pool_obj, FD_SHMEM_JOIN_MODE_READ_WRITE );
+    }
+  }
+
   if( FD_UNLIKELY( rpc_enabled ) ) {
     fd_topob_tile_uses( topo, &topo->tiles[ fd_topo_find_tile( topo, "rpcsrv", 0UL ) ], funk_obj, FD_SHMEM_JOIN_MODE_READ_WRITE );
     fd_topob_tile_uses( topo, &topo->tiles[ fd_topo_find_tile( topo, "rpcsrv", 0UL ) ], store_obj, FD_SHMEM_JOIN_MODE_READ_WRITE );
@@ -1039,10 +1121,40 @@ fd_topo_configure_tile( fd_topo_tile_t * tile,
       tile->snapin.snapwr_depth = in_wr_link->depth;
     }
 
+  } else if( FD_UNLIKELY( !strcmp( tile->name, "ledger" ) ) ) {
+
+    strncpy( tile->ledger.path, config->firedancer.store.ledger_path, sizeof(tile->ledger.path) );
+    tile->ledger.file_sz = config->firedancer.store.ledger_size_gib<<30;
+    tile->ledger.fec_max = config->firedancer.store.max_completed_shred_sets;
+
   } else if( FD_UNLIKELY( !strcmp( tile->name, "snapwr" ) ) ) {
 
     strcpy( tile->snapwr.vinyl_path, config->paths.accounts );
 
+  } else if( FD_UNLIKELY( !strcmp( tile->name, "vinyl" ) ) ) {
+
+    strcpy( tile->vinyl.vinyl_path, config->paths.accounts );
+    tile->vinyl.reset            = fd_topo_find_tile( &config->topo, "snapin", 0UL )==ULONG_MAX; /* booting from genesis */
+    tile->vinyl.meta_map_obj_id  = fd_pod_query_ulong( config->topo.props, "vinyl.meta_map",  ULONG_MAX ); FD_TEST( tile->vinyl.meta_map_obj_id !=ULONG_MAX );
+    tile->vinyl.meta_pool_obj_id = fd_pod_query_ulong( config->topo.props, "vinyl.meta_pool", ULONG_MAX ); FD_TEST( tile->vinyl.meta_pool_obj_id!=ULONG_MAX );
+    tile->vinyl.data_obj_id      = fd_pod_query_ulong( config->topo.props, "vinyl.data",      ULONG_MAX ); FD_TEST( tile->vinyl.data_obj_id     !=ULONG_MAX );
+    tile->vinyl.line_cnt         = fd_pod_queryf_ulong( config->topo.props, ULONG_MAX, "obj.%lu.line_cnt", tile->vinyl.data_obj_id );
+    tile->vinyl.val_max          = fd_pod_queryf_ulong( config->topo.props, ULONG_MAX, "obj.%lu.val_max",  tile->vinyl.data_obj_id );
+
+    if(      FD_LIKELY( !strcmp( config->tiles.vinyl.io_backend, "io_uring" ) ) ) tile->vinyl.io_type = FD_VINYL_IO_TYPE_UR;
+    else if( FD_LIKELY( !strcmp( config->tiles.vinyl.io_backend, "pread"    ) ) ) tile->vinyl.io_type = FD_VINYL_IO_TYPE_BD;
+    else FD_LOG_ERR(( "[tiles.vinyl.io_backend] %s not recognized", config->tiles.vinyl.io_backend ));
+    tile->vinyl.io_uring_depth = config->tiles.vinyl.io_uring_depth;
+
+    tile->vinyl.gc_thresh = config->tiles.vinyl.compaction_threshold_mib<<20;
+    tile->vinyl.gc_lg_eps = (int)config->tiles.vinyl.compaction_garbage_lg;
+    tile->vinyl.bw_rate   = (float)( (double)( config->tiles.vinyl.compaction_bandwidth_mib<<20 ) / 1e9 ); /* bytes per ns */
+    tile->vinyl.bw_burst  = (long)( config->tiles.vinyl.compaction_burst_mib<<20 );
+
+    if(      FD_LIKELY( !strcmp( config->tiles.vinyl.cold_compression, "lz4"  ) ) ) tile->vinyl.cold_style = FD_VINYL_BSTREAM_CTL_STYLE_LZ4;
+    else if( FD_LIKELY( !strcmp( config->tiles.vinyl.cold_compression, "none" ) ) ) tile->vinyl.cold_style = FD_VINYL_BSTREAM_CTL_STYLE_RAW;
+    else FD_LOG_ERR(( "[tiles.vinyl.cold_compression] %s not recognized", config->tiles.vinyl.cold_compression ));
+
   } else if( FD_UNLIKELY( !strcmp( tile->name, "repair" ) ) ) {
     tile->repair.max_pending_shred_sets    = config->tiles.shred.max_pending_shred_sets;
     tile->repair.repair_intake_listen_port = config->tiles.repair.repair_intake_listen_port;
@@ -1082,6 +1194,10 @@ fd_topo_configure_tile( fd_topo_tile_t * tile,
 
     strncpy( tile->replay.cluster_version, config->tiles.replay.cluster_version, sizeof(tile->replay.cluster_version) );
 
+    if(      FD_LIKELY( !strcmp( config->tiles.replay.scheduling_priority, "conflict"      ) ) ) tile->replay.sched_priority = FD_RDISP_PRIORITY_CONFLICT;
+    else if( FD_LIKELY( !strcmp( config->tiles.replay.scheduling_priority, "critical_path" ) ) ) tile->replay.sched_priority = FD_RDISP_PRIORITY_CRITICAL_PATH;
+    else FD_LOG_ERR(( "[tiles.replay.scheduling_priority] %s not recognized", config->tiles.replay.scheduling_priority ));
+
     tile->replay.max_live_slots = config->firedancer.runtime.max_live_slots;
 
     tile->replay.expected_shred_version = config->consensus.expected_shred_version;
@@ -1098,6 +1214,16 @@ fd_topo_configure_tile( fd_topo_tile_t * tile,
     strncpy( tile->replay.dump_proto_dir, config->capture.dump_proto_dir, sizeof(tile->replay.dump_proto_dir) );
     tile->replay.dump_block_to_pb = config->capture.dump_block_to_pb;
 
+    tile->replay.vinyl_path[0] = '\0';
+    if( fd_topo_find_link( &config->topo, "replay_vinyl", 0UL )!=ULONG_MAX ) {
+      strcpy( tile->replay.vinyl_path, config->paths.accounts );
+      tile->replay.vinyl_meta_map_obj_id  = fd_pod_query_ulong( config->topo.props, "vinyl.meta_map",  ULONG_MAX ); FD_TEST( tile->replay.vinyl_meta_map_obj_id !=ULONG_MAX );
+      tile->replay.vinyl_meta_pool_obj_id = fd_pod_query_ulong( config->topo.props, "vinyl.meta_pool", ULONG_MAX ); FD_TEST( tile->replay.vinyl_meta_pool_obj_id!=ULONG_MAX );
+      tile->replay.vinyl_data_obj_id      = fd_pod_query_ulong( config->topo.props, "vinyl.data",      ULONG_MAX ); FD_TEST( tile->replay.vinyl_data_obj_id     !=ULONG_MAX );
+      tile->replay.vinyl_line_cnt         = fd_pod_queryf_ulong( config->topo.props, ULONG_MAX, "obj.%lu.line_cnt", tile->replay.vinyl_data_obj_id );
+      tile->replay.vinyl_val_max          = fd_pod_queryf_ulong( config->topo.props, ULONG_MAX, "obj.%lu.val_max",  tile->replay.vinyl_data_obj_id );
+    }
+
     FD_TEST( tile->replay.funk_obj_id == fd_pod_query_ulong( config->topo.props, "funk", ULONG_MAX ) );
 
   } else if( FD_UNLIKELY( !strcmp( tile->name, "exec" ) ) ) {
@@ -1107,6 +1233,7 @@ fd_topo_configure_tile( fd_topo_tile_t * tile,
     tile->exec.progcache_obj_id = fd_pod_query_ulong( config->topo.props, "progcache", ULONG_MAX ); FD_TEST( tile->exec.progcache_obj_id!=ULONG_MAX );
 
     tile->exec.max_live_slots = config->firedancer.runtime.max_live_slots;
+    tile->exec.jit_code_max   = config->firedancer.runtime.program_cache.jit_code_size_mib<<20;
 
     tile->exec.capture_start_slot = config->capture.capture_start_slot;
     strncpy( tile->exec.solcap_capture, config->capture.solcap_capture, sizeof(tile->exec.solcap_capture) );
@@ -1125,6 +1252,7 @@ fd_topo_configure_tile( fd_topo_tile_t * tile,
   } else if( FD_UNLIKELY( !strcmp( tile->name, "send" ) ) ) {
 
     tile->send.send_src_port = config->tiles.send.send_src_port;
+    tile->send.cc_algo       = config->tiles.send.congestion_control_enum;
     tile->send.ip_addr = config->net.ip_addr;
     strncpy( tile->send.identity_key_path, config->paths.identity_key, sizeof(tile->send.identity_key_path) );
 
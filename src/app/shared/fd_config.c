@@ -6,6 +6,7 @@
 #include "../platform/fd_sys_util.h"
 #include "../../ballet/toml/fd_toml.h"
 #include "../../disco/genesis/fd_genesis_cluster.h"
+#include "../../waltz/quic/fd_quic_cc.h"
 
 #include <unistd.h>
 #include <errno.h>
@@ -97,7 +98,10 @@ fd_config_load_buf( fd_config_t * out,
 
 static void
 fd_config_fillf( fd_config_t * config ) {
-  (void)config;
+  if(      FD_LIKELY( !strcmp( config->tiles.send.congestion_control, "none"    ) ) ) config->tiles.send.congestion_control_enum = FD_QUIC_CC_ALGO_NONE;
+  else if( FD_LIKELY( !strcmp( config->tiles.send.congestion_control, "newreno" ) ) ) config->tiles.send.congestion_control_enum = FD_QUIC_CC_ALGO_NEWRENO;
+  else if( FD_LIKELY( !strcmp( config->tiles.send.congestion_control, "bbr"     ) ) ) config->tiles.send.congestion_control_enum = FD_QUIC_CC_ALGO_BBR;
+  else FD_LOG_ERR(( "[tiles.send.congestion_control] %s not recognized", config->tiles.send.congestion_control ));
 }
 
 static void
@@ -563,6 +567,14 @@ fd_config_validate( fd_config_t const * config ) {
 
   if( config->is_firedancer ) {
     CFG_HAS_POW2( tiles.repair.slot_max );
+
+    if( config->firedancer.vinyl.enabled ) {
+      if( !strcmp( config->tiles.vinyl.io_backend, "io_uring" ) ) CFG_HAS_POW2( tiles.vinyl.io_uring_depth );
+      if( FD_UNLIKELY( config->tiles.vinyl.compaction_garbage_lg>63U ) ) {
+        FD_LOG_ERR(( "`tiles.vinyl.compaction_garbage_lg` must be in range [0,63]" ));
+      }
+      CFG_HAS_NON_ZERO( tiles.vinyl.compaction_burst_mib );
+    }
   }
 
   if( FD_UNLIKELY( config->tiles.bundle.keepalive_interval_millis <    3000 ||
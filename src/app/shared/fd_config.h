@@ -122,6 +122,7 @@ struct fd_configf {
     struct {
       ulong heap_size_mib;
       ulong mean_cache_entry_size;
+      ulong jit_code_size_mib;
     } program_cache;
   } runtime;
 
@@ -155,6 +156,8 @@ struct fd_configf {
 
   struct {
     ulong max_completed_shred_sets;
+    char  ledger_path[ PATH_MAX ];
+    ulong ledger_size_gib;
   } store;
 };
 
@@ -183,6 +186,8 @@ struct fd_config_net {
   struct {
     uint receive_buffer_size;
     uint send_buffer_size;
+    int  udp_gso;
+    int  udp_gro;
   } socket;
 };
 typedef struct fd_config_net fd_config_net_t;
@@ -367,12 +372,15 @@ struct fd_config {
       uint idle_timeout_millis;
       uint ack_delay_millis;
       int  retry;
+      int  net_affinity;
 
       char ssl_key_log_file[ PATH_MAX ];
     } quic;
 
     struct {
       ushort send_src_port;
+      char   congestion_control[ 16 ];
+      uint   congestion_control_enum;
     } send;
 
     struct {
@@ -449,10 +457,21 @@ struct fd_config {
 
     struct {
       char  cluster_version[ 32 ];
+      char  scheduling_priority[ 16 ];
       ulong enable_features_cnt;
       char  enable_features[ 16 ][ FD_BASE58_ENCODED_32_SZ ];
     } replay;
 
+    struct {
+      char  io_backend[ 16 ];
+      uint  io_uring_depth;
+      ulong compaction_threshold_mib;
+      uint  compaction_garbage_lg;
+      ulong compaction_bandwidth_mib;
+      ulong compaction_burst_mib;
+      char  cold_compression[ 16 ];
+    } vinyl;
+
     struct {
       char  slots_pending[PATH_MAX];
       char  shred_cap_archive[ PATH_MAX ];
@@ -98,8 +98,11 @@ fd_config_extract_podf( uchar *        pod,
 
   CFG_POP      ( ulong,  runtime.program_cache.heap_size_mib                 );
   CFG_POP      ( ulong,  runtime.program_cache.mean_cache_entry_size         );
+  CFG_POP      ( ulong,  runtime.program_cache.jit_code_size_mib             );
 
   CFG_POP      ( ulong,  store.max_completed_shred_sets                      );
+  CFG_POP      ( cstr,   store.ledger_path                                   );
+  CFG_POP      ( ulong,  store.ledger_size_gib                               );
 
   CFG_POP      ( uint,   snapshots.sources.max_local_full_effective_age      );
   CFG_POP      ( uint,   snapshots.sources.max_local_incremental_age         );
@@ -174,6 +177,8 @@ fd_config_extract_pod( uchar *       pod,
   CFG_POP      ( cstr,   net.xdp.rss_queue_mode                           );
   CFG_POP      ( uint,   net.socket.receive_buffer_size                   );
   CFG_POP      ( uint,   net.socket.send_buffer_size                      );
+  CFG_POP      ( bool,   net.socket.udp_gso                               );
+  CFG_POP      ( bool,   net.socket.udp_gro                               );
 
   CFG_POP      ( ulong,  tiles.netlink.max_routes                         );
   CFG_POP      ( ulong,  tiles.netlink.max_peer_routes                    );
@@ -189,6 +194,7 @@ fd_config_extract_pod( uchar *       pod,
   CFG_POP      ( uint,   tiles.quic.idle_timeout_millis                   );
   CFG_POP      ( uint,   tiles.quic.ack_delay_millis                      );
   CFG_POP      ( bool,   tiles.quic.retry                                 );
+  CFG_POP      ( bool,   tiles.quic.net_affinity                          );
   CFG_POP      ( cstr,   tiles.quic.ssl_key_log_file                      );
 
   CFG_POP      ( uint,   tiles.verify.signature_cache_size                );
@@ -250,14 +256,24 @@ fd_config_extract_pod( uchar *       pod,
   CFG_POP      ( bool,   capture.dump_block_to_pb                         );
 
   CFG_POP      ( cstr,   tiles.replay.cluster_version                     );
+  CFG_POP      ( cstr,   tiles.replay.scheduling_priority                 );
   CFG_POP_ARRAY( cstr,   tiles.replay.enable_features                     );
 
+  CFG_POP      ( cstr,   tiles.vinyl.io_backend                           );
+  CFG_POP      ( uint,   tiles.vinyl.io_uring_depth                       );
+  CFG_POP      ( ulong,  tiles.vinyl.compaction_threshold_mib             );
+  CFG_POP      ( uint,   tiles.vinyl.compaction_garbage_lg                );
+  CFG_POP      ( ulong,  tiles.vinyl.compaction_bandwidth_mib             );
+  CFG_POP      ( ulong,  tiles.vinyl.compaction_burst_mib                 );
+  CFG_POP      ( cstr,   tiles.vinyl.cold_compression                     );
+
   CFG_POP      ( cstr,   tiles.store_int.slots_pending                    );
   CFG_POP      ( cstr,   tiles.store_int.shred_cap_archive                );
   CFG_POP      ( cstr,   tiles.store_int.shred_cap_replay                 );
   CFG_POP      ( ulong,  tiles.store_int.shred_cap_end_slot               );
 
   CFG_POP      ( ushort, tiles.send.send_src_port                         );
+  CFG_POP      ( cstr,   tiles.send.congestion_control                    );
 
   CFG_POP      ( bool,   tiles.archiver.enabled                           );
   CFG_POP      ( ulong,  tiles.archiver.end_slot                          );
@@ -80,6 +80,7 @@ typedef struct fd_aes_gcm_avx10_state fd_aes_gcm_avx10_t;
   #define fd_aes_128_gcm_init fd_aes_128_gcm_init_ref
   #define fd_aes_gcm_encrypt  fd_aes_gcm_encrypt_ref
   #define fd_aes_gcm_decrypt  fd_aes_gcm_decrypt_ref
+  #define fd_aes_gcm_set_iv   fd_aes_gcm_set_iv_ref
 
 #elif FD_AES_GCM_IMPL == 1
 
@@ -87,6 +88,7 @@ typedef struct fd_aes_gcm_avx10_state fd_aes_gcm_avx10_t;
   #define fd_aes_128_gcm_init fd_aes_128_gcm_init_aesni
   #define fd_aes_gcm_encrypt  fd_aes_gcm_encrypt_aesni
   #define fd_aes_gcm_decrypt  fd_aes_gcm_decrypt_aesni
+  #define fd_aes_gcm_set_iv   fd_aes_gcm_set_iv_aesni
 
 #elif FD_AES_GCM_IMPL == 2
 
@@ -94,6 +96,7 @@ typedef struct fd_aes_gcm_avx10_state fd_aes_gcm_avx10_t;
   #define fd_aes_128_gcm_init fd_aes_128_gcm_init_avx2
   #define fd_aes_gcm_encrypt  fd_aes_gcm_encrypt_avx2
   #define fd_aes_gcm_decrypt  fd_aes_gcm_decrypt_avx2
+  #define fd_aes_gcm_set_iv   fd_aes_gcm_set_iv_aesni
 
 #elif FD_AES_GCM_IMPL == 3
 
@@ -101,6 +104,7 @@ typedef struct fd_aes_gcm_avx10_state fd_aes_gcm_avx10_t;
   #define fd_aes_128_gcm_init fd_aes_128_gcm_init_avx10_512
   #define fd_aes_gcm_encrypt  fd_aes_gcm_encrypt_avx10_512
   #define fd_aes_gcm_decrypt  fd_aes_gcm_decrypt_avx10_512
+  #define fd_aes_gcm_set_iv   fd_aes_gcm_set_iv_avx10_512
 
 #endif
 
@@ -164,6 +168,18 @@ fd_aes_gcm_decrypt( fd_aes_gcm_t * aes_gcm,
                     ulong          aad_sz,
                     uchar const    tag[ 16 ] );
 
+/* fd_aes_gcm_set_iv replaces the IV of an fd_aes_gcm_t object that
+   was previously initialized with fd_aes_128_gcm_init.  Equivalent to
+   re-running fd_aes_128_gcm_init with the same key and the new IV, but
+   skips the key schedule and GHASH key precomputation.  Useful for
+   protocols that encrypt many short messages with one key and a
+   per-message nonce (e.g. QUIC).  Must be called before each encrypt or
+   decrypt call other than the first one after init. */
+
+void
+fd_aes_gcm_set_iv( fd_aes_gcm_t * aes_gcm,
+                   uchar const    iv[ 12 ] );
+
 #define FD_AES_GCM_DECRYPT_FAIL (0)
 #define FD_AES_GCM_DECRYPT_OK   (1)
 
@@ -527,6 +527,47 @@ test_aes_128_gcm_unroll( void ) {
   }
 }
 
+/* test_aes_128_gcm_set_iv checks that re-keying a GCM state with a new
+   IV produces the same results as a fresh init. */
+
+static void
+test_aes_128_gcm_set_iv( fd_rng_t * rng ) {
+  uchar key[ 16 ];
+  for( ulong j=0UL; j<16UL; j++ ) key[ j ] = fd_rng_uchar( rng );
+
+  uchar aad[ 24 ];
+  for( ulong j=0UL; j<sizeof(aad); j++ ) aad[ j ] = fd_rng_uchar( rng );
+
+  uchar p[ 1200 ];
+  for( ulong j=0UL; j<sizeof(p); j++ ) p[ j ] = fd_rng_uchar( rng );
+
+  fd_aes_gcm_t cached[1];
+  uchar iv0[ 12 ] = {0};
+  fd_aes_128_gcm_init( cached, key, iv0 );
+
+  for( ulong iter=0UL; iter<64UL; iter++ ) {
+    uchar iv[ 12 ];
+    for( ulong j=0UL; j<12UL; j++ ) iv[ j ] = fd_rng_uchar( rng );
+    ulong sz = fd_rng_ulong_roll( rng, sizeof(p)+1UL );
+
+    uchar c0[ 1200 ]; uchar tag0[ 16 ];
+    fd_aes_gcm_t fresh[1];
+    fd_aes_128_gcm_init( fresh, key, iv );
+    fd_aes_gcm_encrypt( fresh, c0, p, sz, aad, sizeof(aad), tag0 );
+
+    uchar c1[ 1200 ]; uchar tag1[ 16 ];
+    fd_aes_gcm_set_iv( cached, iv );
+    fd_aes_gcm_encrypt( cached, c1, p, sz, aad, sizeof(aad), tag1 );
+    FD_TEST( 0==memcmp( c0,   c1,   sz ) );
+    FD_TEST( 0==memcmp( tag0, tag1, 16 ) );
+
+    uchar p1[ 1200 ];
+    fd_aes_gcm_set_iv( cached, iv );
+    FD_TEST( fd_aes_gcm_decrypt( cached, c1, p1, sz, aad, sizeof(aad), tag1 )==FD_AES_GCM_DECRYPT_OK );
+    FD_TEST( 0==memcmp( p, p1, sz ) );
+  }
+}
+
 /* Main ***************************************************************/
 
 int
@@ -558,6 +599,7 @@ main( int     argc,
   test_aes_128_gcm_bounds( rng );
   test_aes_128_gcm();
   test_aes_128_gcm_unroll();
+  test_aes_128_gcm_set_iv( rng );
 
   fd_rng_delete( fd_rng_leave( rng ) );
   FD_LOG_NOTICE(( "pass" ));
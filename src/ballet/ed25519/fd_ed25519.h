@@ -72,6 +72,47 @@ fd_ed25519_sign( uchar         sig[ 64 ],
                  uchar const   private_key[ 32 ],
                  fd_sha512_t * sha );
 
+/* FD_ED25519_SIGN_BATCH_MAX is the max batch_sz supported by
+   fd_ed25519_sign_batch. */
+
+#define FD_ED25519_SIGN_BATCH_MAX (16UL)
+
+/* fd_ed25519_sign_batch signs a batch of messages with a single key
+   pair, according to the ED25519 standard.  The j-th signature is
+   exactly the signature computed by fd_ed25519_sign on the j-th
+   message (Ed25519 signing is deterministic).  Compared to signing
+   each message separately, the private key is expanded once per batch
+   and the SHA-512 computations of the batch are done in parallel (see
+   fd_sha512_batch_t).
+
+   sigs[j] is assumed to point to the first byte of a 64-byte memory
+   region which will hold the j-th signature on return.  msgs[j] is
+   assumed to point to the first byte of a msg_szs[j] byte memory
+   region which holds the j-th message.
+
+   scratch[j] is assumed to point to a memory region of at least
+   64+msg_szs[j] bytes (used to hold the preimages of the j-th SHA-512
+   computations).  Scratch regions must not overlap.  On return, the
+   scratch regions only hold public values.
+
+   public_key, private_key and sha are as in fd_ed25519_sign.
+
+   batch_sz is in [0,FD_ED25519_SIGN_BATCH_MAX].  Returns
+   FD_ED25519_SUCCESS on success, or FD_ED25519_ERR_SIG (without
+   signing any message) if batch_sz is too large.  Sanitizes the sha
+   and stack to minimize risk of leaking private key info after
+   return. */
+
+int FD_FN_SENSITIVE
+fd_ed25519_sign_batch( uchar * const       sigs[],     /* batch_sz */
+                       uchar const * const msgs[],     /* batch_sz */
+                       ulong const         msg_szs[],  /* batch_sz */
+                       uchar * const       scratch[],  /* batch_sz */
+                       ulong               batch_sz,
+                       uchar const         public_key [ 32 ],
+                       uchar const         private_key[ 32 ],
+                       fd_sha512_t *       sha );
+
 /* fd_ed25519_verify verifies message according to the ED25519 standard.
 
    msg is assumed to point to the first byte of a sz byte memory region
@@ -129,6 +170,51 @@ fd_ed25519_verify_batch_single_msg( uchar const   msg[], /* msg_sz */
                                     fd_sha512_t * shas[ 1 ],               /* batch_sz */
                                     uchar const   batch_sz );
 
+/* FD_ED25519_VERIFY_BATCH_MAX is the max batch_sz supported by
+   fd_ed25519_verify_batch_multi_msg. */
+
+#define FD_ED25519_VERIFY_BATCH_MAX (32UL)
+
+/* fd_ed25519_verify_batch_multi_msg verifies a batch of independent
+   signatures, each over its own message, according to the ED25519
+   standard.  The result for each signature is exactly the result of
+   fd_ed25519_verify on the same inputs.  (This is not a randomized
+   batch check of the sum of the group equations: such a check can
+   accept signatures that fd_ed25519_verify rejects, because the check
+   done by fd_ed25519_verify is cofactorless.)  Instead, the SHA-512
+   computations of the batch are done in parallel (see
+   fd_sha512_batch_t).
+
+   msgs[j] is assumed to point to the first byte of a msg_szs[j] byte
+   memory region which holds the j-th message.  signatures[j] and
+   pubkeys[j] are assumed to point to the 64-byte signature and the
+   32-byte public key to use to verify the j-th message.  Messages,
+   signatures and public keys can be shared by multiple entries of the
+   batch (e.g. all the signatures of a transaction).
+
+   hram[j] is assumed to point to a scratch memory region of at least
+   64+msg_szs[j] bytes (used to hold the preimage of the j-th SHA-512
+   computation).  Scratch regions must not overlap.
+
+   On return, errs[j] holds FD_ED25519_SUCCESS (0) if the j-th signature
+   verified successfully or a FD_ED25519_ERR_* code indicating the
+   failure reason otherwise.  Returns FD_ED25519_SUCCESS if all the
+   signatures of the batch verified successfully or the errs[j] of the
+   first failing signature otherwise.
+
+   batch_sz is in [0,FD_ED25519_VERIFY_BATCH_MAX].  Returns
+   FD_ED25519_ERR_SIG (without verifying any signature) if batch_sz is
+   too large. */
+
+int
+fd_ed25519_verify_batch_multi_msg( uchar const * const msgs[],       /* batch_sz */
+                                   ulong const         msg_szs[],    /* batch_sz */
+                                   uchar const * const signatures[], /* batch_sz */
+                                   uchar const * const pubkeys[],    /* batch_sz */
+                                   uchar * const       hram[],       /* batch_sz */
+                                   int                 errs[],       /* batch_sz */
+                                   ulong               batch_sz );
+
 /* fd_ed25519_strerror converts an FD_ED25519_SUCCESS / FD_ED25519_ERR_*
    code into a human readable cstr.  The lifetime of the returned
    pointer is infinite.  The returned pointer is always to a non-NULL
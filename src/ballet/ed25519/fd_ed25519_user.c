@@ -132,6 +132,78 @@ fd_ed25519_sign( uchar         sig[ static 64 ],
   return sig;
 }
 
+int FD_FN_SENSITIVE
+fd_ed25519_sign_batch( uchar * const       sigs[],
+                       uchar const * const msgs[],
+                       ulong const         msg_szs[],
+                       uchar * const       scratch[],
+                       ulong               batch_sz,
+                       uchar const         public_key [ static 32 ],
+                       uchar const         private_key[ static 32 ],
+                       fd_sha512_t *       sha ) {
+  if( FD_UNLIKELY( batch_sz>FD_ED25519_SIGN_BATCH_MAX ) ) {
+    return FD_ED25519_ERR_SIG;
+  }
+
+  /* Same steps as fd_ed25519_sign (RFC 8032, 5.1.6), but the private
+     key is only expanded once, and the two SHA-512 computations of
+     each signature are batched across the messages. */
+
+  uchar s[ FD_SHA512_HASH_SZ ];
+  fd_sha512_fini( fd_sha512_append( fd_sha512_init( sha ), private_key, 32UL ), s );
+  s[ 0] &= (uchar)0xF8;
+  s[31] &= (uchar)0x7F;
+  s[31] |= (uchar)0x40;
+  uchar * h = s + 32;
+
+  /* r_j = SHA512( prefix || msg_j ) */
+
+  uchar r[ FD_ED25519_SIGN_BATCH_MAX ][ FD_SHA512_HASH_SZ ];
+  uchar k[ FD_ED25519_SIGN_BATCH_MAX ][ FD_SHA512_HASH_SZ ];
+
+  fd_sha512_batch_t _sha_batch[1];
+  fd_sha512_batch_t * sha_batch = fd_sha512_batch_init( _sha_batch );
+  for( ulong j=0UL; j<batch_sz; j++ ) {
+    fd_memcpy( scratch[ j ],      h,         32UL         );
+    fd_memcpy( scratch[ j ]+32UL, msgs[ j ], msg_szs[ j ] );
+    fd_sha512_batch_add( sha_batch, scratch[ j ], 32UL+msg_szs[ j ], r[ j ] );
+  }
+  fd_sha512_batch_fini( sha_batch );
+
+  /* R_j = [r_j]B.  k_j = SHA512( R_j || A || msg_j ).  Note that the
+     preimage of k_j overwrites the secret preimage of r_j. */
+
+  sha_batch = fd_sha512_batch_init( _sha_batch );
+  for( ulong j=0UL; j<batch_sz; j++ ) {
+    fd_curve25519_scalar_reduce( r[ j ], r[ j ] );
+    fd_ed25519_point_t R[1];
+    fd_ed25519_scalar_mul_base_const_time( R, r[ j ] );
+    fd_ed25519_point_tobytes( sigs[ j ], R );
+
+    fd_memcpy( scratch[ j ],      sigs[ j ],  32UL         );
+    fd_memcpy( scratch[ j ]+32UL, public_key, 32UL         );
+    fd_memcpy( scratch[ j ]+64UL, msgs[ j ],  msg_szs[ j ] );
+    fd_sha512_batch_add( sha_batch, scratch[ j ], 64UL+msg_szs[ j ], k[ j ] );
+  }
+  fd_sha512_batch_fini( sha_batch );
+
+  /* S_j = (r_j + k_j * s) mod L */
+
+  for( ulong j=0UL; j<batch_sz; j++ ) {
+    fd_curve25519_scalar_reduce( k[ j ], k[ j ] );
+    fd_curve25519_scalar_muladd( sigs[ j ]+32, k[ j ], s, r[ j ] );
+  }
+
+  /* Sanitize */
+
+  /* note: no need to sanitize k as all inputs to k are public values */
+  fd_memset_explicit( s, 0, FD_SHA512_HASH_SZ );
+  fd_memset_explicit( r, 0, FD_ED25519_SIGN_BATCH_MAX*FD_SHA512_HASH_SZ );
+  fd_sha512_clear( sha );
+
+  return FD_ED25519_SUCCESS;
+}
+
 int
 fd_ed25519_verify( uchar const   msg[], /* msg_sz */
                    ulong         msg_sz,
@@ -309,6 +381,76 @@ int fd_ed25519_verify_batch_single_msg( uchar const   msg[], /* msg_sz */
 #undef MAX
 }
 
+int
+fd_ed25519_verify_batch_multi_msg( uchar const * const msgs[],       /* batch_sz */
+                                   ulong const         msg_szs[],    /* batch_sz */
+                                   uchar const * const signatures[], /* batch_sz */
+                                   uchar const * const pubkeys[],    /* batch_sz */
+                                   uchar * const       hram[],       /* batch_sz */
+                                   int                 errs[],       /* batch_sz */
+                                   ulong               batch_sz ) {
+  if( FD_UNLIKELY( batch_sz>FD_ED25519_VERIFY_BATCH_MAX ) ) {
+    return FD_ED25519_ERR_SIG;
+  }
+
+  fd_ed25519_point_t R     [ FD_ED25519_VERIFY_BATCH_MAX ];
+  fd_ed25519_point_t Aprime[ FD_ED25519_VERIFY_BATCH_MAX ];
+  uchar              k     [ FD_ED25519_VERIFY_BATCH_MAX ][ 64 ];
+
+  /* First, we validate scalars, decompress public keys and points R_j
+     and check low order points, exactly as in fd_ed25519_verify.  The
+     computations of k_j of the signatures that pass are queued in a
+     SHA-512 batch. */
+
+  fd_sha512_batch_t _sha_batch[1];
+  fd_sha512_batch_t * sha_batch = fd_sha512_batch_init( _sha_batch );
+
+  for( ulong j=0UL; j<batch_sz; j++ ) {
+    uchar const * r          = signatures[ j ];
+    uchar const * S          = signatures[ j ] + 32;
+    uchar const * public_key = pubkeys   [ j ];
+
+    int err = FD_ED25519_SUCCESS;
+    if( FD_UNLIKELY( !fd_curve25519_scalar_validate( S ) ) ) {
+      err = FD_ED25519_ERR_SIG;
+    } else {
+      int res = fd_ed25519_point_frombytes_2x( &Aprime[j], public_key, &R[j], r );
+      if(      FD_UNLIKELY( res                                        ) ) err = res==1 ? FD_ED25519_ERR_PUBKEY : FD_ED25519_ERR_SIG;
+      else if( FD_UNLIKELY( fd_ed25519_affine_is_small_order(&Aprime[j]) ) ) err = FD_ED25519_ERR_PUBKEY;
+      else if( FD_UNLIKELY( fd_ed25519_affine_is_small_order(&R[j]     ) ) ) err = FD_ED25519_ERR_SIG;
+    }
+    errs[ j ] = err;
+    if( FD_UNLIKELY( err ) ) continue;
+
+    /* k_j = SHA512( r || public_key || msg ) */
+    uchar * h = hram[ j ];
+    fd_memcpy( h,      r,          32UL         );
+    fd_memcpy( h+32UL, public_key, 32UL         );
+    fd_memcpy( h+64UL, msgs[ j ],  msg_szs[ j ] );
+    fd_sha512_batch_add( sha_batch, h, 64UL+msg_szs[ j ], k[ j ] );
+  }
+  fd_sha512_batch_fini( sha_batch );
+
+  /* Then, we check the group equation of each signature (see
+     fd_ed25519_verify). */
+
+  int ret = FD_ED25519_SUCCESS;
+  for( ulong j=0UL; j<batch_sz; j++ ) {
+    if( FD_LIKELY( !errs[ j ] ) ) {
+      uchar const * S = signatures[ j ] + 32;
+
+      fd_curve25519_scalar_reduce( k[ j ], k[ j ] );
+
+      fd_ed25519_point_t Rcmp[1];
+      fd_ed25519_point_neg( &Aprime[j], &Aprime[j] );
+      fd_ed25519_double_scalar_mul_base( Rcmp, k[ j ], &Aprime[j], S );
+      if( FD_UNLIKELY( !fd_ed25519_point_eq_z1( Rcmp, &R[j] ) ) ) errs[ j ] = FD_ED25519_ERR_MSG;
+    }
+    if( FD_UNLIKELY( errs[ j ] && !ret ) ) ret = errs[ j ];
+  }
+  return ret;
+}
+
 char const *
 fd_ed25519_strerror( int err ) {
   switch( err ) {
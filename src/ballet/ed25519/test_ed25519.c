@@ -902,6 +902,58 @@ test_sign( fd_rng_t *    rng,
   }
 }
 
+void
+test_sign_batch( fd_rng_t *    rng,
+                 fd_sha512_t * sha ) {
+  static uchar _msg    [ FD_ED25519_SIGN_BATCH_MAX ][ 1024 ];
+  static uchar _scratch[ FD_ED25519_SIGN_BATCH_MAX ][ 64UL+1024UL ];
+  static uchar _sig    [ FD_ED25519_SIGN_BATCH_MAX ][ 64 ];
+
+  uchar const * msgs   [ FD_ED25519_SIGN_BATCH_MAX ];
+  ulong         szs    [ FD_ED25519_SIGN_BATCH_MAX ];
+  uchar *       scratch[ FD_ED25519_SIGN_BATCH_MAX ];
+  uchar *       sigs   [ FD_ED25519_SIGN_BATCH_MAX ];
+  for( ulong j=0UL; j<FD_ED25519_SIGN_BATCH_MAX; j++ ) {
+    msgs[j] = _msg[j]; scratch[j] = _scratch[j]; sigs[j] = _sig[j];
+  }
+
+  uchar pub[ 32 ];
+  uchar prv[ 32 ];
+  uchar exp[ 64 ];
+
+  /* Every signature of the batch matches fd_ed25519_sign */
+  for( ulong rem=1000UL; rem; rem-- ) {
+    fd_ed25519_public_from_private( pub, fd_rng_b256( rng, prv ), sha );
+    ulong batch_sz = fd_rng_ulong_roll( rng, FD_ED25519_SIGN_BATCH_MAX+1UL );
+    for( ulong j=0UL; j<batch_sz; j++ ) {
+      szs[j] = fd_rng_ulong_roll( rng, 1025UL );
+      for( ulong b=0UL; b<szs[j]; b++ ) _msg[j][b] = fd_rng_uchar( rng );
+    }
+    FD_TEST( fd_ed25519_sign_batch( sigs, msgs, szs, scratch, batch_sz, pub, prv, sha )==FD_ED25519_SUCCESS );
+    for( ulong j=0UL; j<batch_sz; j++ ) {
+      fd_ed25519_sign( exp, msgs[j], szs[j], pub, prv, sha );
+      FD_TEST( fd_memeq( sigs[j], exp, 64UL ) );
+      FD_TEST( fd_ed25519_verify( msgs[j], szs[j], sigs[j], pub, sha )==FD_ED25519_SUCCESS );
+    }
+  }
+
+  /* bench (32 byte messages, e.g. shred Merkle roots) */
+  ulong iter = 10000UL;
+  for( ulong j=0UL; j<FD_ED25519_SIGN_BATCH_MAX; j++ ) szs[j] = 32UL;
+  FD_TEST( fd_ed25519_sign_batch( sigs, msgs, szs, scratch, FD_ED25519_SIGN_BATCH_MAX+1UL, pub, prv, sha )==FD_ED25519_ERR_SIG );
+  for( ulong batch_sz=1UL; batch_sz<=FD_ED25519_SIGN_BATCH_MAX; batch_sz*=2UL ) {
+    long dt = fd_log_wallclock();
+    for( ulong rem=iter/batch_sz; rem; rem-- ) {
+      FD_COMPILER_MFENCE();
+      fd_ed25519_sign_batch( sigs, msgs, szs, scratch, batch_sz, pub, prv, sha );
+    }
+    dt = fd_log_wallclock() - dt;
+
+    char cstr[128];
+    log_bench( fd_cstr_printf( cstr, 128UL, NULL, "fd_ed25519_sign_batch(32 / %lu)", batch_sz ), (iter/batch_sz)*batch_sz, dt );
+  }
+}
+
 void
 test_verify( fd_rng_t *    rng,
              fd_sha512_t * sha ) {
@@ -1141,6 +1193,83 @@ test_cctv_batch( fd_rng_t * rng, fd_sha512_t * sha ) {
   FD_LOG_NOTICE(( "fd_ed25519_verify_cctv_batch: ok" ));
 }
 
+void
+test_cctv_batch_multi_msg( fd_rng_t * rng, fd_sha512_t * sha ) {
+  char cstr[128];
+
+  static uchar _hram[ FD_ED25519_VERIFY_BATCH_MAX ][ 64UL+1024UL ];
+
+  uchar const * msgs[ FD_ED25519_VERIFY_BATCH_MAX ];
+  ulong         szs [ FD_ED25519_VERIFY_BATCH_MAX ];
+  uchar const * sigs[ FD_ED25519_VERIFY_BATCH_MAX ];
+  uchar const * pubs[ FD_ED25519_VERIFY_BATCH_MAX ];
+  uchar *       hram[ FD_ED25519_VERIFY_BATCH_MAX ];
+  int           errs[ FD_ED25519_VERIFY_BATCH_MAX ];
+  for( ulong j=0UL; j<FD_ED25519_VERIFY_BATCH_MAX; j++ ) hram[j] = _hram[j];
+
+  /* valid signatures over different messages */
+  static uchar _msg[ FD_ED25519_VERIFY_BATCH_MAX ][ 1024 ];
+  static uchar _sig[ FD_ED25519_VERIFY_BATCH_MAX ][ 64 ];
+  static uchar _pub[ FD_ED25519_VERIFY_BATCH_MAX ][ 32 ];
+  static ulong _sz [ FD_ED25519_VERIFY_BATCH_MAX ];
+  for( ulong j=0UL; j<FD_ED25519_VERIFY_BATCH_MAX; j++ ) {
+    uchar prv[ 32 ];
+    szs[j] = _sz[j] = fd_rng_ulong_roll( rng, 1025UL );
+    for( ulong b=0UL; b<szs[j]; b++ ) _msg[j][b] = fd_rng_uchar( rng );
+    fd_ed25519_public_from_private( _pub[j], fd_rng_b256( rng, prv ), sha );
+    fd_ed25519_sign( _sig[j], _msg[j], szs[j], _pub[j], prv, sha );
+    msgs[j] = _msg[j]; sigs[j] = _sig[j]; pubs[j] = _pub[j];
+  }
+  FD_TEST( fd_ed25519_verify_batch_multi_msg( msgs, szs, sigs, pubs, hram, errs, 0UL )==FD_ED25519_SUCCESS );
+  FD_TEST( fd_ed25519_verify_batch_multi_msg( msgs, szs, sigs, pubs, hram, errs, FD_ED25519_VERIFY_BATCH_MAX+1UL )==FD_ED25519_ERR_SIG );
+  for( ulong batch_sz=1UL; batch_sz<=FD_ED25519_VERIFY_BATCH_MAX; batch_sz++ ) {
+    FD_TEST( fd_ed25519_verify_batch_multi_msg( msgs, szs, sigs, pubs, hram, errs, batch_sz )==FD_ED25519_SUCCESS );
+    for( ulong j=0UL; j<batch_sz; j++ ) FD_TEST( !errs[j] );
+  }
+
+  /* mix the test vectors with valid signatures, results must match
+     fd_ed25519_verify */
+  ulong cnt = 0UL;
+  for( fd_ed25519_verify_cctv_t const * proof = ed25519_verify_cctvs;
+       proof->msg;
+       proof++ ) {
+    ulong j = fd_rng_ulong_roll( rng, FD_ED25519_VERIFY_BATCH_MAX );
+    msgs[j] = proof->msg;
+    szs [j] = proof->msg_sz;
+    sigs[j] = (uchar const *)proof->sig;
+    pubs[j] = (uchar const *)proof->pub;
+
+    int exp = fd_ed25519_verify( proof->msg, proof->msg_sz, (uchar const *)proof->sig, (uchar const *)proof->pub, sha );
+    int ret = fd_ed25519_verify_batch_multi_msg( msgs, szs, sigs, pubs, hram, errs, FD_ED25519_VERIFY_BATCH_MAX );
+    FD_TEST_CUSTOM( errs[j]==exp, fd_cstr_printf( cstr, 128UL, NULL, "fd_ed25519_verify_batch_multi_msg id=%u", proof->tc_id ) );
+    FD_TEST( ret==exp );
+
+    msgs[j] = _msg[j]; szs[j] = _sz[j]; sigs[j] = _sig[j]; pubs[j] = _pub[j];
+    cnt++;
+  }
+  FD_TEST( fd_ed25519_verify_batch_multi_msg( msgs, szs, sigs, pubs, hram, errs, FD_ED25519_VERIFY_BATCH_MAX )==FD_ED25519_SUCCESS );
+  FD_LOG_NOTICE(( "fd_ed25519_verify_batch_multi_msg: ok (%lu vectors)", cnt ));
+
+  /* bench */
+  ulong iter = 10000UL;
+  for( ulong j=0UL; j<FD_ED25519_VERIFY_BATCH_MAX; j++ ) {
+    uchar prv[ 32 ];
+    szs[j] = 1024UL;
+    fd_ed25519_public_from_private( _pub[j], fd_rng_b256( rng, prv ), sha );
+    fd_ed25519_sign( _sig[j], _msg[j], szs[j], _pub[j], prv, sha );
+  }
+  for( ulong batch_sz=1UL; batch_sz<=FD_ED25519_VERIFY_BATCH_MAX; batch_sz*=2UL ) {
+    FD_TEST( fd_ed25519_verify_batch_multi_msg( msgs, szs, sigs, pubs, hram, errs, batch_sz )==FD_ED25519_SUCCESS );
+    long dt = fd_log_wallclock();
+    for( ulong rem=iter/batch_sz; rem; rem-- ) {
+      FD_COMPILER_MFENCE();
+      fd_ed25519_verify_batch_multi_msg( msgs, szs, sigs, pubs, hram, errs, batch_sz );
+    }
+    dt = fd_log_wallclock() - dt;
+    log_bench( fd_cstr_printf( cstr, 128UL, NULL, "fd_..._verify_batch_multi_msg(1024 / %lu)", batch_sz ), (iter/batch_sz)*batch_sz, dt );
+  }
+}
+
 /**********************************************************************/
 
 int
@@ -1175,11 +1304,13 @@ main( int     argc,
 
   test_public_from_private( rng, sha );
   test_sign               ( rng, sha );
+  test_sign_batch         ( rng, sha );
   test_verify             ( rng, sha );
 
   test_wycheproofs( sha );
   test_cctv       ( sha );
   test_cctv_batch ( rng, sha );
+  test_cctv_batch_multi_msg( rng, sha );
 
   fd_sha512_delete( fd_sha512_leave( sha ) );
   fd_rng_delete( fd_rng_leave( rng ) );
@@ -17,3 +17,45 @@ fd_poh_mixin( void *        FD_RESTRICT poh,
   fd_sha256_fini( &sha, poh );
   return poh;
 }
+
+ulong
+fd_poh_verify_entries( uchar const *          start,
+                       fd_poh_entry_t const * entry,
+                       ulong                  entry_cnt ) {
+
+  /* Verify in chunks of at most BATCH_MAX entries to bound the stack
+     usage.  The chunks are large enough to keep all lanes busy. */
+
+# define BATCH_MAX (64UL)
+
+  uchar        hash[ BATCH_MAX ][ 32 ];
+  void const * data[ BATCH_MAX ];
+  void *       out [ BATCH_MAX ];
+  ulong        cnt [ BATCH_MAX ];
+
+  for( ulong entry0=0UL; entry0<entry_cnt; entry0+=BATCH_MAX ) {
+    ulong batch_cnt = fd_ulong_min( entry_cnt-entry0, BATCH_MAX );
+
+    /* An entry with transactions does hashcnt-1 plain hashes followed
+       by one mixin hash.  A tick does hashcnt plain hashes. */
+
+    for( ulong i=0UL; i<batch_cnt; i++ ) {
+      fd_poh_entry_t const * e = entry + entry0 + i;
+      data[ i ] = entry0+i ? entry[ entry0+i-1UL ].hash : start;
+      out [ i ] = hash[ i ];
+      cnt [ i ] = e->has_mixin ? fd_ulong_sat_sub( e->hashcnt, 1UL ) : e->hashcnt;
+    }
+
+    fd_sha256_hash_32_repeated_batch( batch_cnt, data, out, cnt );
+
+    for( ulong i=0UL; i<batch_cnt; i++ ) {
+      fd_poh_entry_t const * e = entry + entry0 + i;
+      if( e->has_mixin ) fd_poh_mixin( hash[ i ], e->mixin );
+      if( FD_UNLIKELY( memcmp( hash[ i ], e->hash, 32UL ) ) ) return entry0+i;
+    }
+  }
+
+# undef BATCH_MAX
+
+  return entry_cnt;
+}
@@ -29,6 +29,36 @@ void *
 fd_poh_mixin( void *        FD_RESTRICT poh,
               uchar const * FD_RESTRICT mixin );
 
+/* fd_poh_entry_t describes a PoH entry (i.e. a microblock header and
+   the transactions that follow it) for verification.  hashcnt is the
+   number of hashes since the previous entry, hash is the PoH hash
+   claimed by the entry.  If has_mixin is set, the entry contains
+   transactions and mixin is the Merkle root of their signatures (see
+   fd_bmtree), mixed into the last of the hashcnt hashes. */
+
+struct fd_poh_entry {
+  ulong hashcnt;
+  ulong has_mixin;
+  uchar hash [ 32 ];
+  uchar mixin[ 32 ];
+};
+
+typedef struct fd_poh_entry fd_poh_entry_t;
+
+/* fd_poh_verify_entries verifies that entry_cnt consecutive entries
+   form a valid PoH chain starting from the 32 byte PoH hash pointed to
+   by start (the hash claimed by the entry preceding entry[0]).  Each
+   entry is verified against the hash claimed by its predecessor, so
+   the entries are verified in parallel (see
+   fd_sha256_hash_32_repeated_batch).  Returns the index of the first
+   entry whose claimed hash is wrong, or entry_cnt if all entries are
+   valid. */
+
+ulong
+fd_poh_verify_entries( uchar const *          start,
+                       fd_poh_entry_t const * entry,
+                       ulong                  entry_cnt );
+
 FD_PROTOTYPES_END
 
 #endif /* HEADER_fd_src_ballet_poh_fd_poh_h */
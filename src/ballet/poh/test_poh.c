@@ -167,6 +167,75 @@ static fd_poh_test_vector_t const poh_test_vectors[] = {
 
 #undef _
 
+/* Ensure that fd_poh_verify_entries matches sequential PoH for entries
+   split out of the test vectors and for random entries, and that it
+   reports the first bad entry. */
+static void
+test_poh_verify_entries( fd_rng_t * rng ) {
+# define ENTRY_MAX (200UL)
+  static fd_poh_entry_t entry[ ENTRY_MAX ];
+
+  for( fd_poh_test_vector_t const * v = poh_test_vectors; v->name; v++ ) {
+    uchar poh[32];
+    memcpy( poh, v->pre, 32UL );
+    ulong entry_cnt = 0UL;
+    for( fd_poh_test_step_t const * step = v->steps; step->n >= 0; step++ ) {
+      fd_poh_entry_t * e = entry + entry_cnt;
+      if( step->n == 0 ) {
+        /* Fold the mixin into the entry of the preceding append */
+        FD_TEST( entry_cnt );
+        e--;
+        e->hashcnt++;
+        e->has_mixin = 1UL;
+        memcpy( e->mixin, step->mixin, 32UL );
+        fd_poh_mixin( poh, step->mixin );
+      } else {
+        e->hashcnt   = (ulong)step->n;
+        e->has_mixin = 0UL;
+        fd_poh_append( poh, (ulong)step->n );
+        entry_cnt++;
+      }
+      memcpy( entry[ entry_cnt-1UL ].hash, poh, 32UL );
+    }
+    FD_TEST( !memcmp( poh, v->post, 32UL ) );
+    FD_TEST( fd_poh_verify_entries( v->pre, entry, entry_cnt )==entry_cnt );
+  }
+
+  for( ulong trial=0UL; trial<64UL; trial++ ) {
+    uchar start[32];
+    for( ulong b=0UL; b<32UL; b++ ) start[ b ] = fd_rng_uchar( rng );
+    ulong entry_cnt = fd_rng_ulong_roll( rng, ENTRY_MAX+1UL );
+    uchar poh[32];
+    memcpy( poh, start, 32UL );
+    for( ulong i=0UL; i<entry_cnt; i++ ) {
+      fd_poh_entry_t * e = entry + i;
+      e->hashcnt   = fd_rng_ulong_roll( rng, 1UL<<fd_rng_uint_roll( rng, 12U ) );
+      e->has_mixin = (ulong)fd_rng_uint_roll( rng, 2U );
+      for( ulong b=0UL; b<32UL; b++ ) e->mixin[ b ] = fd_rng_uchar( rng );
+      if( e->has_mixin ) {
+        fd_poh_append( poh, fd_ulong_sat_sub( e->hashcnt, 1UL ) );
+        fd_poh_mixin( poh, e->mixin );
+      } else {
+        fd_poh_append( poh, e->hashcnt );
+      }
+      memcpy( e->hash, poh, 32UL );
+    }
+    FD_TEST( fd_poh_verify_entries( start, entry, entry_cnt )==entry_cnt );
+    if( !entry_cnt ) continue;
+
+    /* Corrupt an entry.  Its successors are still verified against its
+       claimed hash, so only it fails. */
+    ulong bad = fd_rng_ulong_roll( rng, entry_cnt );
+    switch( fd_rng_uint_roll( rng, 3U ) ) {
+    case 0U: entry[ bad ].hash[ fd_rng_uint_roll( rng, 32U ) ]++; break;
+    case 1U: entry[ bad ].hashcnt += 2UL;                          break; /* hashcnt 0 and 1 are equivalent with a mixin */
+    case 2U: entry[ bad ].has_mixin ^= 1UL;                        break;
+    }
+    FD_TEST( fd_poh_verify_entries( start, entry, entry_cnt )==bad );
+  }
+# undef ENTRY_MAX
+}
+
 static void
 bench_poh_sequential( void ) {
   uchar poh[FD_SHA256_HASH_SZ] = {0};
@@ -203,6 +272,10 @@ int main( int argc,
     test_poh_vector( v );
   }
 
+  fd_rng_t _rng[1]; fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, 0U, 0UL ) );
+  test_poh_verify_entries( rng );
+  fd_rng_delete( fd_rng_leave( rng ) );
+
   bench_poh_sequential();
 
   FD_LOG_NOTICE(( "pass" ));
@@ -12,6 +12,12 @@ $(call add-objs,fd_reedsol_recover_32,fd_reedsol)
 $(call add-objs,fd_reedsol_recover_64,fd_reedsol)
 $(call add-objs,fd_reedsol_recover_128,fd_reedsol)
 $(call add-objs,fd_reedsol_recover_256,fd_reedsol)
+ifdef FD_HAS_GFNI
+ifdef FD_HAS_AVX512
+$(call add-objs,fd_reedsol_recover_x2_32,fd_reedsol)
+$(call add-objs,fd_reedsol_recover_x2_64,fd_reedsol)
+endif
+endif
 $(call add-objs,fd_reedsol_pi,fd_reedsol)
 ifdef FD_HAS_HOSTED
 $(call make-unit-test,test_reedsol,test_reedsol,fd_reedsol fd_util)
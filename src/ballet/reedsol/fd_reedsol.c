@@ -31,6 +31,24 @@ fd_reedsol_encode_fini( fd_reedsol_t * rs ) {
   rs->parity_shred_cnt = 0UL;
 }
 
+/* recover_span returns how many shreds a recover operation needs to
+   consider in order to find data_shred_cnt un-erased ones (minus one,
+   which is what selects the kernel below), or ULONG_MAX if there
+   aren't enough un-erased shreds. */
+
+static ulong
+recover_span( uchar const * erased,
+              ulong         data_shred_cnt,
+              ulong         parity_shred_cnt ) {
+  ulong unerased = 0UL;
+  ulong i        = 0UL;
+  for( ; i<data_shred_cnt + parity_shred_cnt; i++ ) {
+    unerased += !erased[ i ];
+    if( unerased==data_shred_cnt ) break;
+  }
+  return fd_ulong_if( unerased==data_shred_cnt, i, ULONG_MAX );
+}
+
 int
 fd_reedsol_recover_fini( fd_reedsol_t * rs ) {
 
@@ -43,13 +61,8 @@ fd_reedsol_recover_fini( fd_reedsol_t * rs ) {
   /* How many shreds do we need to consider in order to find
      rs->data_shred_cnt un-erased? */
 
-  ulong unerased = 0UL;
-  ulong i        = 0UL;
-  for( ; i<data_shred_cnt + parity_shred_cnt; i++ ) {
-    unerased += !rs->recover.erased[ i ];
-    if( unerased==data_shred_cnt ) break;
-  }
-  if( FD_UNLIKELY( unerased!=data_shred_cnt ) ) return FD_REEDSOL_ERR_PARTIAL;
+  ulong i = recover_span( rs->recover.erased, data_shred_cnt, parity_shred_cnt );
+  if( FD_UNLIKELY( i==ULONG_MAX ) ) return FD_REEDSOL_ERR_PARTIAL;
 
 # if 0 /* TODO: Add first variant for slightly more performance */
   if( FD_LIKELY( i==data_shred_cnt ) ) {
@@ -64,6 +77,26 @@ fd_reedsol_recover_fini( fd_reedsol_t * rs ) {
   }
 # endif
 
+# if FD_REEDSOL_ARITH_IMPL==3
+  /* The common cases (e.g. 32:32 with some loss) fit in the two lane
+     kernels, so recover the front and back halves of the shreds at the
+     same time.  The halves overlap by a byte when shred_sz is odd,
+     which is harmless since both lanes compute the same value there. */
+  if( FD_LIKELY( (16UL<=i) & (i<64UL) & (rs->shred_sz>=2UL*32UL) ) ) {
+    ulong   half      = rs->shred_sz/2UL;
+    ulong   shred_cnt = data_shred_cnt + parity_shred_cnt;
+    uchar * back[ FD_REEDSOL_DATA_SHREDS_MAX + FD_REEDSOL_PARITY_SHREDS_MAX ];
+    for( ulong j=0UL; j<shred_cnt; j++ ) back[ j ] = rs->recover.shred[ j ] + half;
+
+    int err[ 2 ];
+    if( i<32UL ) fd_reedsol_private_recover_var_x2_32( rs->shred_sz-half, rs->recover.shred, back, data_shred_cnt, parity_shred_cnt,
+                                                       rs->recover.erased, rs->recover.erased, err );
+    else         fd_reedsol_private_recover_var_x2_64( rs->shred_sz-half, rs->recover.shred, back, data_shred_cnt, parity_shred_cnt,
+                                                       rs->recover.erased, rs->recover.erased, err );
+    return fd_int_min( err[ 0 ], err[ 1 ] );
+  }
+# endif
+
   if( FD_UNLIKELY( i<16UL ) )
     return fd_reedsol_private_recover_var_16( rs->shred_sz, rs->recover.shred, data_shred_cnt, parity_shred_cnt, rs->recover.erased );
   if( FD_LIKELY(   i<32UL ) )
@@ -76,6 +109,39 @@ fd_reedsol_recover_fini( fd_reedsol_t * rs ) {
   return fd_reedsol_private_recover_var_256( rs->shred_sz, rs->recover.shred, data_shred_cnt, parity_shred_cnt, rs->recover.erased );
 }
 
+void
+fd_reedsol_recover_fini_pair( fd_reedsol_t * rs_a,
+                              fd_reedsol_t * rs_b,
+                              int            err[2] ) {
+
+# if FD_REEDSOL_ARITH_IMPL==3
+  ulong data_shred_cnt   = rs_a->data_shred_cnt;
+  ulong parity_shred_cnt = rs_a->parity_shred_cnt;
+
+  if( FD_LIKELY( (rs_a->shred_sz==rs_b->shred_sz) & (data_shred_cnt==rs_b->data_shred_cnt) & (parity_shred_cnt==rs_b->parity_shred_cnt) ) ) {
+    ulong i_a = recover_span( rs_a->recover.erased, data_shred_cnt, parity_shred_cnt );
+    ulong i_b = recover_span( rs_b->recover.erased, data_shred_cnt, parity_shred_cnt );
+    ulong i   = fd_ulong_max( i_a, i_b );
+
+    /* Both operations need to fit in the same kernel.  Anything else
+       (including either one being partial) is done one at a time
+       below. */
+    if( FD_LIKELY( (16UL<=i) & (i<64UL) ) ) {
+      rs_a->data_shred_cnt   = 0UL; rs_b->data_shred_cnt   = 0UL;
+      rs_a->parity_shred_cnt = 0UL; rs_b->parity_shred_cnt = 0UL;
+      if( i<32UL ) fd_reedsol_private_recover_var_x2_32( rs_a->shred_sz, rs_a->recover.shred, rs_b->recover.shred, data_shred_cnt, parity_shred_cnt,
+                                                         rs_a->recover.erased, rs_b->recover.erased, err );
+      else         fd_reedsol_private_recover_var_x2_64( rs_a->shred_sz, rs_a->recover.shred, rs_b->recover.shred, data_shred_cnt, parity_shred_cnt,
+                                                         rs_a->recover.erased, rs_b->recover.erased, err );
+      return;
+    }
+  }
+# endif
+
+  err[ 0 ] = fd_reedsol_recover_fini( rs_a );
+  err[ 1 ] = fd_reedsol_recover_fini( rs_b );
+}
+
 char const *
 fd_reedsol_strerror( int err ) {
   switch( err ) {
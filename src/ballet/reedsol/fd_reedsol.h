@@ -320,6 +320,22 @@ fd_reedsol_recover_abort( fd_reedsol_t * rs ) {
 int
 fd_reedsol_recover_fini( fd_reedsol_t * rs );
 
+/* fd_reedsol_recover_fini_pair finishes two independent in-progress
+   recover operations.  On return, err[0] and err[1] hold what
+   fd_reedsol_recover_fini would have returned for rs_a and rs_b
+   (respectively).  On targets with GFNI and AVX-512, when both
+   operations have the same shred size and shred counts (e.g. two 32:32
+   FEC sets), they are done together in the two halves of each vector,
+   which is faster than finishing them one after the other.  rs_a and
+   rs_b must be distinct and must not share any erased shreds.  Assumes
+   both are initialized as recoverers, neither will be initialized on
+   return. */
+
+void
+fd_reedsol_recover_fini_pair( fd_reedsol_t * rs_a,
+                              fd_reedsol_t * rs_b,
+                              int            err[2] );
+
 /* Misc APIs */
 
 /* fd_reedsol_strerror converts a FD_REEDSOL_SUCCESS / FD_REEDSOL_ERR_*
@@ -0,0 +1,70 @@
+#ifndef HEADER_fd_src_ballet_reedsol_fd_reedsol_arith_gfni_x2_h
+#define HEADER_fd_src_ballet_reedsol_fd_reedsol_arith_gfni_x2_h
+
+#ifndef HEADER_fd_src_ballet_reedsol_fd_reedsol_private_h
+#error "Do not include this file directly; use fd_reedsol_private.h"
+#endif
+
+/* This is a two lane variant of fd_reedsol_arith_gfni.h.  A gf_t is a
+   512-bit vector where the low 256 bits and the high 256 bits hold 32
+   bytes from two independent Reed-Solomon operations (e.g. two FEC
+   sets, or two halves of the same shreds).  GF_WIDTH is the number of
+   bytes of each lane, i.e. the amount a kernel advances shred_pos by.
+
+   Since the affine matrix for multiplication by a constant is the same
+   8 bytes for each 64-bit word, the GFNI constant table (32 bytes per
+   constant) doubles as a table of 64-bit broadcasts.  GF_MUL multiplies
+   both lanes by the same compile time constant.  Multiplying the lanes
+   by different runtime constants is done by building the matrix once
+   with GF_MAT2 and then using GF_MUL_MAT. */
+
+#include "../../util/simd/fd_avx.h"
+#include "../../util/simd/fd_avx512.h"
+
+#if !FD_USING_CLANG && (__GNUC__ < 10)
+#error "FD_REEDSOL_ARITH_IMPL 4 requires GCC 10 or newer"
+#endif
+
+typedef wwb_t gf_t;
+
+#define GF_WIDTH W_FOOTPRINT
+
+FD_PROTOTYPES_BEGIN
+
+#define gf_zero wwb_zero
+
+/* gf_ldu2 returns the vector with the 32 bytes at pa in the low lane
+   and the 32 bytes at pb in the high lane.  gf_lo and gf_hi extract the
+   lanes and gf_join combines them. */
+
+#define gf_ldu2( pa, pb ) _mm512_inserti64x4( _mm512_castsi256_si512( wb_ldu( (pa) ) ), wb_ldu( (pb) ), 1 )
+#define gf_lo( x )        _mm512_castsi512_si256( (x) )
+#define gf_hi( x )        _mm512_extracti64x4_epi64( (x), 1 )
+#define gf_join( lo, hi ) _mm512_inserti64x4( _mm512_castsi256_si512( (lo) ), (hi), 1 )
+
+extern uchar const fd_reedsol_arith_consts_gfni_mul[]  __attribute__((aligned(128)));
+
+#define GF_ADD wwb_xor
+
+#define GF_OR  wwb_or
+
+#define GF_MAT( c ) _mm512_set1_epi64( FD_LOAD( long, fd_reedsol_arith_consts_gfni_mul + 32*(c) ) )
+
+#define GF_MUL( a, c ) (__extension__({                                                        \
+    wwb_t _a = (a);                                                                            \
+    int   _c = (c);                                                                            \
+    /* c is known at compile time, so this is not a runtime branch */                          \
+    ((_c==0) ? wwb_zero() : ((_c==1) ? _a : _mm512_gf2p8affine_epi64_epi8( _a, GF_MAT( _c ), 0 ) )); \
+  }))
+
+#define GF_MUL_VAR( a, c ) (_mm512_gf2p8affine_epi64_epi8( (a), GF_MAT( (c) ), 0 ))
+
+/* GF_MAT2 returns the matrix for multiplying the low lane by ca and the
+   high lane by cb.  GF_MUL_MAT multiplies a by such a matrix. */
+
+#define GF_MAT2( ca, cb )  _mm512_mask_blend_epi64( (__mmask8)0xF0, GF_MAT( (ca) ), GF_MAT( (cb) ) )
+#define GF_MUL_MAT( a, m ) (_mm512_gf2p8affine_epi64_epi8( (a), (m), 0 ))
+
+FD_PROTOTYPES_END
+
+#endif /* HEADER_fd_src_ballet_reedsol_fd_reedsol_arith_gfni_x2_h */
@@ -13,7 +13,9 @@
      0 - unaccelerated
      1 - AVX accelerated
      2 - GFNI accelerated with AVX2
-     3 - GFNI accelerated with AVX512 */
+     3 - GFNI accelerated with AVX512
+     4 - GFNI accelerated with AVX512, two independent lanes per vector
+         (never the default, see fd_reedsol_arith_gfni_x2.h) */
 
 #ifndef FD_REEDSOL_ARITH_IMPL
 #if FD_HAS_GFNI && FD_HAS_AVX512
@@ -33,6 +35,8 @@
 #include "fd_reedsol_arith_avx2.h"
 #elif FD_REEDSOL_ARITH_IMPL==2 || FD_REEDSOL_ARITH_IMPL==3
 #include "fd_reedsol_arith_gfni.h"
+#elif FD_REEDSOL_ARITH_IMPL==4
+#include "fd_reedsol_arith_gfni_x2.h"
 #else
 #error "Unsupported FD_REEDSOL_ARITH_IMPL"
 #endif
@@ -155,6 +159,43 @@ fd_reedsol_private_recover_var_256( ulong           shred_sz,
                                     ulong           parity_shred_cnt,
                                     uchar const *   erased );
 
+#if FD_HAS_GFNI && FD_HAS_AVX512
+
+/* fd_reedsol_private_recover_var_x2_{n}: Performs two independent
+   recover operations at once, using one 256-bit lane of each AVX-512
+   vector for each.  Operation a recovers the shreds in shred_a given
+   erased_a, and operation b the shreds in shred_b given erased_b, each
+   exactly as fd_reedsol_private_recover_var_{n} would.  Both operations
+   must have the same shred_sz, data_shred_cnt, and parity_shred_cnt.
+   shred_b may alias shred_a at an offset (e.g. to process the two
+   halves of the same shreds), as long as erased_a and erased_b agree.
+
+   On return, err[0] and err[1] hold the result of operation a and b
+   (respectively), as fd_reedsol_private_recover_var_{n} would return
+   it. */
+
+void
+fd_reedsol_private_recover_var_x2_32( ulong           shred_sz,
+                                      uchar * const * shred_a,
+                                      uchar * const * shred_b,
+                                      ulong           data_shred_cnt,
+                                      ulong           parity_shred_cnt,
+                                      uchar const *   erased_a,
+                                      uchar const *   erased_b,
+                                      int *           err );
+
+void
+fd_reedsol_private_recover_var_x2_64( ulong           shred_sz,
+                                      uchar * const * shred_a,
+                                      uchar * const * shred_b,
+                                      ulong           data_shred_cnt,
+                                      ulong           parity_shred_cnt,
+                                      uchar const *   erased_a,
+                                      uchar const *   erased_b,
+                                      int *           err );
+
+#endif
+
 /* This below functions generate what:
 
      S. -J. Lin, T. Y. Al-Naffouri, Y. S. Han and W. -H. Chung, "Novel
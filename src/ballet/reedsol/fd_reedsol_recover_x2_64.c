@@ -0,0 +1,425 @@
+/* Note: This file is auto generated. */
+#define FD_REEDSOL_ARITH_IMPL 4
+#include "fd_reedsol_ppt.h"
+#include "fd_reedsol_fderiv.h"
+
+/* Erased vectors are loaded from here instead of branching. */
+static uchar const zero[ GF_WIDTH ] W_ATTR = { 0 };
+
+FD_FN_UNSANITIZED void
+fd_reedsol_private_recover_var_x2_64( ulong           shred_sz,
+                                      uchar * const * shred_a,
+                                      uchar * const * shred_b,
+                                      ulong           data_shred_cnt,
+                                      ulong           parity_shred_cnt,
+                                      uchar const *   erased_a,
+                                      uchar const *   erased_b,
+                                      int *           err ) {
+  uchar _erased_a[ 64 ] W_ATTR;
+  uchar _erased_b[ 64 ] W_ATTR;
+  uchar pi_a[      64 ] W_ATTR;
+  uchar pi_b[      64 ] W_ATTR;
+  ulong shred_cnt = data_shred_cnt + parity_shred_cnt;
+  ulong loaded_cnt_a = 0UL;
+  ulong loaded_cnt_b = 0UL;
+  for( ulong i=0UL; i<64UL; i++) {
+    int load_shred_a = ((i<shred_cnt)&(loaded_cnt_a<data_shred_cnt))&&( erased_a[ i ]==0 );
+    int load_shred_b = ((i<shred_cnt)&(loaded_cnt_b<data_shred_cnt))&&( erased_b[ i ]==0 );
+    _erased_a[ i ] = !load_shred_a;
+    _erased_b[ i ] = !load_shred_b;
+    loaded_cnt_a += (ulong)load_shred_a;
+    loaded_cnt_b += (ulong)load_shred_b;
+  }
+  /* If either operation can't be done in this bucket, do the other
+     one by itself. */
+  if( FD_UNLIKELY( (loaded_cnt_a<data_shred_cnt) | (loaded_cnt_b<data_shred_cnt) ) ) {
+    err[ 0 ] = fd_reedsol_private_recover_var_64( shred_sz, shred_a, data_shred_cnt, parity_shred_cnt, erased_a );
+    err[ 1 ] = fd_reedsol_private_recover_var_64( shred_sz, shred_b, data_shred_cnt, parity_shred_cnt, erased_b );
+    return;
+  }
+
+  fd_reedsol_private_gen_pi_64( _erased_a, pi_a );
+  fd_reedsol_private_gen_pi_64( _erased_b, pi_b );
+
+  /* The multipliers differ between the lanes, so build the matrices
+     once rather than in every iteration. */
+  gf_t pi[ 64 ];
+  for( ulong i=0UL; i<64UL; i++ ) pi[ i ] = GF_MAT2( pi_a[ i ], pi_b[ i ] );
+
+  /* Store the difference for each shred that was regenerated.  This
+     must be 0.  Otherwise there's a corrupt shred. */
+  wb_t diff_a = wb_zero();
+  wb_t diff_b = wb_zero();
+
+  for( ulong shred_pos=0UL; shred_pos<shred_sz; /* advanced manually at end of loop */ ) {
+    /* Load exactly data_shred_cnt un-erased input shreds into
+       their respective vector.  Fill the erased vectors with 0. */
+    gf_t in00 = gf_ldu2( _erased_a[  0 ] ? zero : shred_a[  0 ] + shred_pos, _erased_b[  0 ] ? zero : shred_b[  0 ] + shred_pos );
+    gf_t in01 = gf_ldu2( _erased_a[  1 ] ? zero : shred_a[  1 ] + shred_pos, _erased_b[  1 ] ? zero : shred_b[  1 ] + shred_pos );
+    gf_t in02 = gf_ldu2( _erased_a[  2 ] ? zero : shred_a[  2 ] + shred_pos, _erased_b[  2 ] ? zero : shred_b[  2 ] + shred_pos );
+    gf_t in03 = gf_ldu2( _erased_a[  3 ] ? zero : shred_a[  3 ] + shred_pos, _erased_b[  3 ] ? zero : shred_b[  3 ] + shred_pos );
+    gf_t in04 = gf_ldu2( _erased_a[  4 ] ? zero : shred_a[  4 ] + shred_pos, _erased_b[  4 ] ? zero : shred_b[  4 ] + shred_pos );
+    gf_t in05 = gf_ldu2( _erased_a[  5 ] ? zero : shred_a[  5 ] + shred_pos, _erased_b[  5 ] ? zero : shred_b[  5 ] + shred_pos );
+    gf_t in06 = gf_ldu2( _erased_a[  6 ] ? zero : shred_a[  6 ] + shred_pos, _erased_b[  6 ] ? zero : shred_b[  6 ] + shred_pos );
+    gf_t in07 = gf_ldu2( _erased_a[  7 ] ? zero : shred_a[  7 ] + shred_pos, _erased_b[  7 ] ? zero : shred_b[  7 ] + shred_pos );
+    gf_t in08 = gf_ldu2( _erased_a[  8 ] ? zero : shred_a[  8 ] + shred_pos, _erased_b[  8 ] ? zero : shred_b[  8 ] + shred_pos );
+    gf_t in09 = gf_ldu2( _erased_a[  9 ] ? zero : shred_a[  9 ] + shred_pos, _erased_b[  9 ] ? zero : shred_b[  9 ] + shred_pos );
+    gf_t in10 = gf_ldu2( _erased_a[ 10 ] ? zero : shred_a[ 10 ] + shred_pos, _erased_b[ 10 ] ? zero : shred_b[ 10 ] + shred_pos );
+    gf_t in11 = gf_ldu2( _erased_a[ 11 ] ? zero : shred_a[ 11 ] + shred_pos, _erased_b[ 11 ] ? zero : shred_b[ 11 ] + shred_pos );
+    gf_t in12 = gf_ldu2( _erased_a[ 12 ] ? zero : shred_a[ 12 ] + shred_pos, _erased_b[ 12 ] ? zero : shred_b[ 12 ] + shred_pos );
+    gf_t in13 = gf_ldu2( _erased_a[ 13 ] ? zero : shred_a[ 13 ] + shred_pos, _erased_b[ 13 ] ? zero : shred_b[ 13 ] + shred_pos );
+    gf_t in14 = gf_ldu2( _erased_a[ 14 ] ? zero : shred_a[ 14 ] + shred_pos, _erased_b[ 14 ] ? zero : shred_b[ 14 ] + shred_pos );
+    gf_t in15 = gf_ldu2( _erased_a[ 15 ] ? zero : shred_a[ 15 ] + shred_pos, _erased_b[ 15 ] ? zero : shred_b[ 15 ] + shred_pos );
+    gf_t in16 = gf_ldu2( _erased_a[ 16 ] ? zero : shred_a[ 16 ] + shred_pos, _erased_b[ 16 ] ? zero : shred_b[ 16 ] + shred_pos );
+    gf_t in17 = gf_ldu2( _erased_a[ 17 ] ? zero : shred_a[ 17 ] + shred_pos, _erased_b[ 17 ] ? zero : shred_b[ 17 ] + shred_pos );
+    gf_t in18 = gf_ldu2( _erased_a[ 18 ] ? zero : shred_a[ 18 ] + shred_pos, _erased_b[ 18 ] ? zero : shred_b[ 18 ] + shred_pos );
+    gf_t in19 = gf_ldu2( _erased_a[ 19 ] ? zero : shred_a[ 19 ] + shred_pos, _erased_b[ 19 ] ? zero : shred_b[ 19 ] + shred_pos );
+    gf_t in20 = gf_ldu2( _erased_a[ 20 ] ? zero : shred_a[ 20 ] + shred_pos, _erased_b[ 20 ] ? zero : shred_b[ 20 ] + shred_pos );
+    gf_t in21 = gf_ldu2( _erased_a[ 21 ] ? zero : shred_a[ 21 ] + shred_pos, _erased_b[ 21 ] ? zero : shred_b[ 21 ] + shred_pos );
+    gf_t in22 = gf_ldu2( _erased_a[ 22 ] ? zero : shred_a[ 22 ] + shred_pos, _erased_b[ 22 ] ? zero : shred_b[ 22 ] + shred_pos );
+    gf_t in23 = gf_ldu2( _erased_a[ 23 ] ? zero : shred_a[ 23 ] + shred_pos, _erased_b[ 23 ] ? zero : shred_b[ 23 ] + shred_pos );
+    gf_t in24 = gf_ldu2( _erased_a[ 24 ] ? zero : shred_a[ 24 ] + shred_pos, _erased_b[ 24 ] ? zero : shred_b[ 24 ] + shred_pos );
+    gf_t in25 = gf_ldu2( _erased_a[ 25 ] ? zero : shred_a[ 25 ] + shred_pos, _erased_b[ 25 ] ? zero : shred_b[ 25 ] + shred_pos );
+    gf_t in26 = gf_ldu2( _erased_a[ 26 ] ? zero : shred_a[ 26 ] + shred_pos, _erased_b[ 26 ] ? zero : shred_b[ 26 ] + shred_pos );
+    gf_t in27 = gf_ldu2( _erased_a[ 27 ] ? zero : shred_a[ 27 ] + shred_pos, _erased_b[ 27 ] ? zero : shred_b[ 27 ] + shred_pos );
+    gf_t in28 = gf_ldu2( _erased_a[ 28 ] ? zero : shred_a[ 28 ] + shred_pos, _erased_b[ 28 ] ? zero : shred_b[ 28 ] + shred_pos );
+    gf_t in29 = gf_ldu2( _erased_a[ 29 ] ? zero : shred_a[ 29 ] + shred_pos, _erased_b[ 29 ] ? zero : shred_b[ 29 ] + shred_pos );
+    gf_t in30 = gf_ldu2( _erased_a[ 30 ] ? zero : shred_a[ 30 ] + shred_pos, _erased_b[ 30 ] ? zero : shred_b[ 30 ] + shred_pos );
+    gf_t in31 = gf_ldu2( _erased_a[ 31 ] ? zero : shred_a[ 31 ] + shred_pos, _erased_b[ 31 ] ? zero : shred_b[ 31 ] + shred_pos );
+    gf_t in32 = gf_ldu2( _erased_a[ 32 ] ? zero : shred_a[ 32 ] + shred_pos, _erased_b[ 32 ] ? zero : shred_b[ 32 ] + shred_pos );
+    gf_t in33 = gf_ldu2( _erased_a[ 33 ] ? zero : shred_a[ 33 ] + shred_pos, _erased_b[ 33 ] ? zero : shred_b[ 33 ] + shred_pos );
+    gf_t in34 = gf_ldu2( _erased_a[ 34 ] ? zero : shred_a[ 34 ] + shred_pos, _erased_b[ 34 ] ? zero : shred_b[ 34 ] + shred_pos );
+    gf_t in35 = gf_ldu2( _erased_a[ 35 ] ? zero : shred_a[ 35 ] + shred_pos, _erased_b[ 35 ] ? zero : shred_b[ 35 ] + shred_pos );
+    gf_t in36 = gf_ldu2( _erased_a[ 36 ] ? zero : shred_a[ 36 ] + shred_pos, _erased_b[ 36 ] ? zero : shred_b[ 36 ] + shred_pos );
+    gf_t in37 = gf_ldu2( _erased_a[ 37 ] ? zero : shred_a[ 37 ] + shred_pos, _erased_b[ 37 ] ? zero : shred_b[ 37 ] + shred_pos );
+    gf_t in38 = gf_ldu2( _erased_a[ 38 ] ? zero : shred_a[ 38 ] + shred_pos, _erased_b[ 38 ] ? zero : shred_b[ 38 ] + shred_pos );
+    gf_t in39 = gf_ldu2( _erased_a[ 39 ] ? zero : shred_a[ 39 ] + shred_pos, _erased_b[ 39 ] ? zero : shred_b[ 39 ] + shred_pos );
+    gf_t in40 = gf_ldu2( _erased_a[ 40 ] ? zero : shred_a[ 40 ] + shred_pos, _erased_b[ 40 ] ? zero : shred_b[ 40 ] + shred_pos );
+    gf_t in41 = gf_ldu2( _erased_a[ 41 ] ? zero : shred_a[ 41 ] + shred_pos, _erased_b[ 41 ] ? zero : shred_b[ 41 ] + shred_pos );
+    gf_t in42 = gf_ldu2( _erased_a[ 42 ] ? zero : shred_a[ 42 ] + shred_pos, _erased_b[ 42 ] ? zero : shred_b[ 42 ] + shred_pos );
+    gf_t in43 = gf_ldu2( _erased_a[ 43 ] ? zero : shred_a[ 43 ] + shred_pos, _erased_b[ 43 ] ? zero : shred_b[ 43 ] + shred_pos );
+    gf_t in44 = gf_ldu2( _erased_a[ 44 ] ? zero : shred_a[ 44 ] + shred_pos, _erased_b[ 44 ] ? zero : shred_b[ 44 ] + shred_pos );
+    gf_t in45 = gf_ldu2( _erased_a[ 45 ] ? zero : shred_a[ 45 ] + shred_pos, _erased_b[ 45 ] ? zero : shred_b[ 45 ] + shred_pos );
+    gf_t in46 = gf_ldu2( _erased_a[ 46 ] ? zero : shred_a[ 46 ] + shred_pos, _erased_b[ 46 ] ? zero : shred_b[ 46 ] + shred_pos );
+    gf_t in47 = gf_ldu2( _erased_a[ 47 ] ? zero : shred_a[ 47 ] + shred_pos, _erased_b[ 47 ] ? zero : shred_b[ 47 ] + shred_pos );
+    gf_t in48 = gf_ldu2( _erased_a[ 48 ] ? zero : shred_a[ 48 ] + shred_pos, _erased_b[ 48 ] ? zero : shred_b[ 48 ] + shred_pos );
+    gf_t in49 = gf_ldu2( _erased_a[ 49 ] ? zero : shred_a[ 49 ] + shred_pos, _erased_b[ 49 ] ? zero : shred_b[ 49 ] + shred_pos );
+    gf_t in50 = gf_ldu2( _erased_a[ 50 ] ? zero : shred_a[ 50 ] + shred_pos, _erased_b[ 50 ] ? zero : shred_b[ 50 ] + shred_pos );
+    gf_t in51 = gf_ldu2( _erased_a[ 51 ] ? zero : shred_a[ 51 ] + shred_pos, _erased_b[ 51 ] ? zero : shred_b[ 51 ] + shred_pos );
+    gf_t in52 = gf_ldu2( _erased_a[ 52 ] ? zero : shred_a[ 52 ] + shred_pos, _erased_b[ 52 ] ? zero : shred_b[ 52 ] + shred_pos );
+    gf_t in53 = gf_ldu2( _erased_a[ 53 ] ? zero : shred_a[ 53 ] + shred_pos, _erased_b[ 53 ] ? zero : shred_b[ 53 ] + shred_pos );
+    gf_t in54 = gf_ldu2( _erased_a[ 54 ] ? zero : shred_a[ 54 ] + shred_pos, _erased_b[ 54 ] ? zero : shred_b[ 54 ] + shred_pos );
+    gf_t in55 = gf_ldu2( _erased_a[ 55 ] ? zero : shred_a[ 55 ] + shred_pos, _erased_b[ 55 ] ? zero : shred_b[ 55 ] + shred_pos );
+    gf_t in56 = gf_ldu2( _erased_a[ 56 ] ? zero : shred_a[ 56 ] + shred_pos, _erased_b[ 56 ] ? zero : shred_b[ 56 ] + shred_pos );
+    gf_t in57 = gf_ldu2( _erased_a[ 57 ] ? zero : shred_a[ 57 ] + shred_pos, _erased_b[ 57 ] ? zero : shred_b[ 57 ] + shred_pos );
+    gf_t in58 = gf_ldu2( _erased_a[ 58 ] ? zero : shred_a[ 58 ] + shred_pos, _erased_b[ 58 ] ? zero : shred_b[ 58 ] + shred_pos );
+    gf_t in59 = gf_ldu2( _erased_a[ 59 ] ? zero : shred_a[ 59 ] + shred_pos, _erased_b[ 59 ] ? zero : shred_b[ 59 ] + shred_pos );
+    gf_t in60 = gf_ldu2( _erased_a[ 60 ] ? zero : shred_a[ 60 ] + shred_pos, _erased_b[ 60 ] ? zero : shred_b[ 60 ] + shred_pos );
+    gf_t in61 = gf_ldu2( _erased_a[ 61 ] ? zero : shred_a[ 61 ] + shred_pos, _erased_b[ 61 ] ? zero : shred_b[ 61 ] + shred_pos );
+    gf_t in62 = gf_ldu2( _erased_a[ 62 ] ? zero : shred_a[ 62 ] + shred_pos, _erased_b[ 62 ] ? zero : shred_b[ 62 ] + shred_pos );
+    gf_t in63 = gf_ldu2( _erased_a[ 63 ] ? zero : shred_a[ 63 ] + shred_pos, _erased_b[ 63 ] ? zero : shred_b[ 63 ] + shred_pos );
+    in00 = GF_MUL_MAT( in00, pi[  0 ] );
+    in01 = GF_MUL_MAT( in01, pi[  1 ] );
+    in02 = GF_MUL_MAT( in02, pi[  2 ] );
+    in03 = GF_MUL_MAT( in03, pi[  3 ] );
+    in04 = GF_MUL_MAT( in04, pi[  4 ] );
+    in05 = GF_MUL_MAT( in05, pi[  5 ] );
+    in06 = GF_MUL_MAT( in06, pi[  6 ] );
+    in07 = GF_MUL_MAT( in07, pi[  7 ] );
+    in08 = GF_MUL_MAT( in08, pi[  8 ] );
+    in09 = GF_MUL_MAT( in09, pi[  9 ] );
+    in10 = GF_MUL_MAT( in10, pi[ 10 ] );
+    in11 = GF_MUL_MAT( in11, pi[ 11 ] );
+    in12 = GF_MUL_MAT( in12, pi[ 12 ] );
+    in13 = GF_MUL_MAT( in13, pi[ 13 ] );
+    in14 = GF_MUL_MAT( in14, pi[ 14 ] );
+    in15 = GF_MUL_MAT( in15, pi[ 15 ] );
+    in16 = GF_MUL_MAT( in16, pi[ 16 ] );
+    in17 = GF_MUL_MAT( in17, pi[ 17 ] );
+    in18 = GF_MUL_MAT( in18, pi[ 18 ] );
+    in19 = GF_MUL_MAT( in19, pi[ 19 ] );
+    in20 = GF_MUL_MAT( in20, pi[ 20 ] );
+    in21 = GF_MUL_MAT( in21, pi[ 21 ] );
+    in22 = GF_MUL_MAT( in22, pi[ 22 ] );
+    in23 = GF_MUL_MAT( in23, pi[ 23 ] );
+    in24 = GF_MUL_MAT( in24, pi[ 24 ] );
+    in25 = GF_MUL_MAT( in25, pi[ 25 ] );
+    in26 = GF_MUL_MAT( in26, pi[ 26 ] );
+    in27 = GF_MUL_MAT( in27, pi[ 27 ] );
+    in28 = GF_MUL_MAT( in28, pi[ 28 ] );
+    in29 = GF_MUL_MAT( in29, pi[ 29 ] );
+    in30 = GF_MUL_MAT( in30, pi[ 30 ] );
+    in31 = GF_MUL_MAT( in31, pi[ 31 ] );
+    in32 = GF_MUL_MAT( in32, pi[ 32 ] );
+    in33 = GF_MUL_MAT( in33, pi[ 33 ] );
+    in34 = GF_MUL_MAT( in34, pi[ 34 ] );
+    in35 = GF_MUL_MAT( in35, pi[ 35 ] );
+    in36 = GF_MUL_MAT( in36, pi[ 36 ] );
+    in37 = GF_MUL_MAT( in37, pi[ 37 ] );
+    in38 = GF_MUL_MAT( in38, pi[ 38 ] );
+    in39 = GF_MUL_MAT( in39, pi[ 39 ] );
+    in40 = GF_MUL_MAT( in40, pi[ 40 ] );
+    in41 = GF_MUL_MAT( in41, pi[ 41 ] );
+    in42 = GF_MUL_MAT( in42, pi[ 42 ] );
+    in43 = GF_MUL_MAT( in43, pi[ 43 ] );
+    in44 = GF_MUL_MAT( in44, pi[ 44 ] );
+    in45 = GF_MUL_MAT( in45, pi[ 45 ] );
+    in46 = GF_MUL_MAT( in46, pi[ 46 ] );
+    in47 = GF_MUL_MAT( in47, pi[ 47 ] );
+    in48 = GF_MUL_MAT( in48, pi[ 48 ] );
+    in49 = GF_MUL_MAT( in49, pi[ 49 ] );
+    in50 = GF_MUL_MAT( in50, pi[ 50 ] );
+    in51 = GF_MUL_MAT( in51, pi[ 51 ] );
+    in52 = GF_MUL_MAT( in52, pi[ 52 ] );
+    in53 = GF_MUL_MAT( in53, pi[ 53 ] );
+    in54 = GF_MUL_MAT( in54, pi[ 54 ] );
+    in55 = GF_MUL_MAT( in55, pi[ 55 ] );
+    in56 = GF_MUL_MAT( in56, pi[ 56 ] );
+    in57 = GF_MUL_MAT( in57, pi[ 57 ] );
+    in58 = GF_MUL_MAT( in58, pi[ 58 ] );
+    in59 = GF_MUL_MAT( in59, pi[ 59 ] );
+    in60 = GF_MUL_MAT( in60, pi[ 60 ] );
+    in61 = GF_MUL_MAT( in61, pi[ 61 ] );
+    in62 = GF_MUL_MAT( in62, pi[ 62 ] );
+    in63 = GF_MUL_MAT( in63, pi[ 63 ] );
+    #define ALL_VARS in00, in01, in02, in03, in04, in05, in06, in07, in08, in09, in10, in11, in12, in13, in14, in15, in16, in17, in18, in19, in20, in21, in22, in23, in24, in25, in26, in27, in28, in29, in30, in31, in32, in33, in34, in35, in36, in37, in38, in39, in40, in41, in42, in43, in44, in45, in46, in47, in48, in49, in50, in51, in52, in53, in54, in55, in56, in57, in58, in59, in60, in61, in62, in63
+
+    FD_REEDSOL_GENERATE_IFFT( 64, 0, ALL_VARS );
+
+    FD_REEDSOL_GENERATE_FDERIV( 64, ALL_VARS );
+
+    FD_REEDSOL_GENERATE_FFT( 64, 0, ALL_VARS );
+
+    in00 = GF_MUL_MAT( in00, pi[  0 ] );
+    in01 = GF_MUL_MAT( in01, pi[  1 ] );
+    in02 = GF_MUL_MAT( in02, pi[  2 ] );
+    in03 = GF_MUL_MAT( in03, pi[  3 ] );
+    in04 = GF_MUL_MAT( in04, pi[  4 ] );
+    in05 = GF_MUL_MAT( in05, pi[  5 ] );
+    in06 = GF_MUL_MAT( in06, pi[  6 ] );
+    in07 = GF_MUL_MAT( in07, pi[  7 ] );
+    in08 = GF_MUL_MAT( in08, pi[  8 ] );
+    in09 = GF_MUL_MAT( in09, pi[  9 ] );
+    in10 = GF_MUL_MAT( in10, pi[ 10 ] );
+    in11 = GF_MUL_MAT( in11, pi[ 11 ] );
+    in12 = GF_MUL_MAT( in12, pi[ 12 ] );
+    in13 = GF_MUL_MAT( in13, pi[ 13 ] );
+    in14 = GF_MUL_MAT( in14, pi[ 14 ] );
+    in15 = GF_MUL_MAT( in15, pi[ 15 ] );
+    in16 = GF_MUL_MAT( in16, pi[ 16 ] );
+    in17 = GF_MUL_MAT( in17, pi[ 17 ] );
+    in18 = GF_MUL_MAT( in18, pi[ 18 ] );
+    in19 = GF_MUL_MAT( in19, pi[ 19 ] );
+    in20 = GF_MUL_MAT( in20, pi[ 20 ] );
+    in21 = GF_MUL_MAT( in21, pi[ 21 ] );
+    in22 = GF_MUL_MAT( in22, pi[ 22 ] );
+    in23 = GF_MUL_MAT( in23, pi[ 23 ] );
+    in24 = GF_MUL_MAT( in24, pi[ 24 ] );
+    in25 = GF_MUL_MAT( in25, pi[ 25 ] );
+    in26 = GF_MUL_MAT( in26, pi[ 26 ] );
+    in27 = GF_MUL_MAT( in27, pi[ 27 ] );
+    in28 = GF_MUL_MAT( in28, pi[ 28 ] );
+    in29 = GF_MUL_MAT( in29, pi[ 29 ] );
+    in30 = GF_MUL_MAT( in30, pi[ 30 ] );
+    in31 = GF_MUL_MAT( in31, pi[ 31 ] );
+    in32 = GF_MUL_MAT( in32, pi[ 32 ] );
+    in33 = GF_MUL_MAT( in33, pi[ 33 ] );
+    in34 = GF_MUL_MAT( in34, pi[ 34 ] );
+    in35 = GF_MUL_MAT( in35, pi[ 35 ] );
+    in36 = GF_MUL_MAT( in36, pi[ 36 ] );
+    in37 = GF_MUL_MAT( in37, pi[ 37 ] );
+    in38 = GF_MUL_MAT( in38, pi[ 38 ] );
+    in39 = GF_MUL_MAT( in39, pi[ 39 ] );
+    in40 = GF_MUL_MAT( in40, pi[ 40 ] );
+    in41 = GF_MUL_MAT( in41, pi[ 41 ] );
+    in42 = GF_MUL_MAT( in42, pi[ 42 ] );
+    in43 = GF_MUL_MAT( in43, pi[ 43 ] );
+    in44 = GF_MUL_MAT( in44, pi[ 44 ] );
+    in45 = GF_MUL_MAT( in45, pi[ 45 ] );
+    in46 = GF_MUL_MAT( in46, pi[ 46 ] );
+    in47 = GF_MUL_MAT( in47, pi[ 47 ] );
+    in48 = GF_MUL_MAT( in48, pi[ 48 ] );
+    in49 = GF_MUL_MAT( in49, pi[ 49 ] );
+    in50 = GF_MUL_MAT( in50, pi[ 50 ] );
+    in51 = GF_MUL_MAT( in51, pi[ 51 ] );
+    in52 = GF_MUL_MAT( in52, pi[ 52 ] );
+    in53 = GF_MUL_MAT( in53, pi[ 53 ] );
+    in54 = GF_MUL_MAT( in54, pi[ 54 ] );
+    in55 = GF_MUL_MAT( in55, pi[ 55 ] );
+    in56 = GF_MUL_MAT( in56, pi[ 56 ] );
+    in57 = GF_MUL_MAT( in57, pi[ 57 ] );
+    in58 = GF_MUL_MAT( in58, pi[ 58 ] );
+    in59 = GF_MUL_MAT( in59, pi[ 59 ] );
+    in60 = GF_MUL_MAT( in60, pi[ 60 ] );
+    in61 = GF_MUL_MAT( in61, pi[ 61 ] );
+    in62 = GF_MUL_MAT( in62, pi[ 62 ] );
+    in63 = GF_MUL_MAT( in63, pi[ 63 ] );
+  /* Same cases as fd_reedsol_private_recover_var_{n}, but handled
+       separately for each lane. */
+  #define STORE_COMPARE_RELOAD_LANE( n, v, shred, erased, _erased, diff ) do{                                  if(       erased[ n ] )        wb_stu( shred[ n ] + shred_pos, v );                                          else if( _erased[ n ] ) diff = wb_or( diff, wb_xor( v, wb_ldu( shred[ n ] + shred_pos ) ) );                 else                    v    = wb_ldu( shred[ n ] + shred_pos );                                           } while( 0 )
+  #define STORE_COMPARE_LANE( n, v, shred, erased, diff ) do{                                                   if(       erased[ n ] )        wb_stu( shred[ n ] + shred_pos, v );                                          else                    diff = wb_or( diff, wb_xor( v, wb_ldu( shred[ n ] + shred_pos ) ) );               } while( 0 )
+  #define STORE_COMPARE_RELOAD( n, var ) do{                                                                     wb_t _va = gf_lo( var );                                                                                     wb_t _vb = gf_hi( var );                                                                                     STORE_COMPARE_RELOAD_LANE( n, _va, shred_a, erased_a, _erased_a, diff_a );                                   STORE_COMPARE_RELOAD_LANE( n, _vb, shred_b, erased_b, _erased_b, diff_b );                                   var = gf_join( _va, _vb );                                                                                 } while( 0 )
+  #define STORE_COMPARE( n, var ) do{                                                                        STORE_COMPARE_LANE( n, gf_lo( var ), shred_a, erased_a, diff_a );                                            STORE_COMPARE_LANE( n, gf_hi( var ), shred_b, erased_b, diff_b );                                          } while( 0 )
+    switch( fd_ulong_min( shred_cnt, 64UL ) ) {
+      case 64UL: STORE_COMPARE_RELOAD( 63, in63 ); FALLTHRU
+      case 63UL: STORE_COMPARE_RELOAD( 62, in62 ); FALLTHRU
+      case 62UL: STORE_COMPARE_RELOAD( 61, in61 ); FALLTHRU
+      case 61UL: STORE_COMPARE_RELOAD( 60, in60 ); FALLTHRU
+      case 60UL: STORE_COMPARE_RELOAD( 59, in59 ); FALLTHRU
+      case 59UL: STORE_COMPARE_RELOAD( 58, in58 ); FALLTHRU
+      case 58UL: STORE_COMPARE_RELOAD( 57, in57 ); FALLTHRU
+      case 57UL: STORE_COMPARE_RELOAD( 56, in56 ); FALLTHRU
+      case 56UL: STORE_COMPARE_RELOAD( 55, in55 ); FALLTHRU
+      case 55UL: STORE_COMPARE_RELOAD( 54, in54 ); FALLTHRU
+      case 54UL: STORE_COMPARE_RELOAD( 53, in53 ); FALLTHRU
+      case 53UL: STORE_COMPARE_RELOAD( 52, in52 ); FALLTHRU
+      case 52UL: STORE_COMPARE_RELOAD( 51, in51 ); FALLTHRU
+      case 51UL: STORE_COMPARE_RELOAD( 50, in50 ); FALLTHRU
+      case 50UL: STORE_COMPARE_RELOAD( 49, in49 ); FALLTHRU
+      case 49UL: STORE_COMPARE_RELOAD( 48, in48 ); FALLTHRU
+      case 48UL: STORE_COMPARE_RELOAD( 47, in47 ); FALLTHRU
+      case 47UL: STORE_COMPARE_RELOAD( 46, in46 ); FALLTHRU
+      case 46UL: STORE_COMPARE_RELOAD( 45, in45 ); FALLTHRU
+      case 45UL: STORE_COMPARE_RELOAD( 44, in44 ); FALLTHRU
+      case 44UL: STORE_COMPARE_RELOAD( 43, in43 ); FALLTHRU
+      case 43UL: STORE_COMPARE_RELOAD( 42, in42 ); FALLTHRU
+      case 42UL: STORE_COMPARE_RELOAD( 41, in41 ); FALLTHRU
+      case 41UL: STORE_COMPARE_RELOAD( 40, in40 ); FALLTHRU
+      case 40UL: STORE_COMPARE_RELOAD( 39, in39 ); FALLTHRU
+      case 39UL: STORE_COMPARE_RELOAD( 38, in38 ); FALLTHRU
+      case 38UL: STORE_COMPARE_RELOAD( 37, in37 ); FALLTHRU
+      case 37UL: STORE_COMPARE_RELOAD( 36, in36 ); FALLTHRU
+      case 36UL: STORE_COMPARE_RELOAD( 35, in35 ); FALLTHRU
+      case 35UL: STORE_COMPARE_RELOAD( 34, in34 ); FALLTHRU
+      case 34UL: STORE_COMPARE_RELOAD( 33, in33 ); FALLTHRU
+      case 33UL: STORE_COMPARE_RELOAD( 32, in32 ); FALLTHRU
+      case 32UL: STORE_COMPARE_RELOAD( 31, in31 ); FALLTHRU
+      case 31UL: STORE_COMPARE_RELOAD( 30, in30 ); FALLTHRU
+      case 30UL: STORE_COMPARE_RELOAD( 29, in29 ); FALLTHRU
+      case 29UL: STORE_COMPARE_RELOAD( 28, in28 ); FALLTHRU
+      case 28UL: STORE_COMPARE_RELOAD( 27, in27 ); FALLTHRU
+      case 27UL: STORE_COMPARE_RELOAD( 26, in26 ); FALLTHRU
+      case 26UL: STORE_COMPARE_RELOAD( 25, in25 ); FALLTHRU
+      case 25UL: STORE_COMPARE_RELOAD( 24, in24 ); FALLTHRU
+      case 24UL: STORE_COMPARE_RELOAD( 23, in23 ); FALLTHRU
+      case 23UL: STORE_COMPARE_RELOAD( 22, in22 ); FALLTHRU
+      case 22UL: STORE_COMPARE_RELOAD( 21, in21 ); FALLTHRU
+      case 21UL: STORE_COMPARE_RELOAD( 20, in20 ); FALLTHRU
+      case 20UL: STORE_COMPARE_RELOAD( 19, in19 ); FALLTHRU
+      case 19UL: STORE_COMPARE_RELOAD( 18, in18 ); FALLTHRU
+      case 18UL: STORE_COMPARE_RELOAD( 17, in17 ); FALLTHRU
+      case 17UL: STORE_COMPARE_RELOAD( 16, in16 ); FALLTHRU
+      case 16UL: STORE_COMPARE_RELOAD( 15, in15 ); FALLTHRU
+      case 15UL: STORE_COMPARE_RELOAD( 14, in14 ); FALLTHRU
+      case 14UL: STORE_COMPARE_RELOAD( 13, in13 ); FALLTHRU
+      case 13UL: STORE_COMPARE_RELOAD( 12, in12 ); FALLTHRU
+      case 12UL: STORE_COMPARE_RELOAD( 11, in11 ); FALLTHRU
+      case 11UL: STORE_COMPARE_RELOAD( 10, in10 ); FALLTHRU
+      case 10UL: STORE_COMPARE_RELOAD(  9, in09 ); FALLTHRU
+      case  9UL: STORE_COMPARE_RELOAD(  8, in08 ); FALLTHRU
+      case  8UL: STORE_COMPARE_RELOAD(  7, in07 ); FALLTHRU
+      case  7UL: STORE_COMPARE_RELOAD(  6, in06 ); FALLTHRU
+      case  6UL: STORE_COMPARE_RELOAD(  5, in05 ); FALLTHRU
+      case  5UL: STORE_COMPARE_RELOAD(  4, in04 ); FALLTHRU
+      case  4UL: STORE_COMPARE_RELOAD(  3, in03 ); FALLTHRU
+      case  3UL: STORE_COMPARE_RELOAD(  2, in02 ); FALLTHRU
+      case  2UL: STORE_COMPARE_RELOAD(  1, in01 ); FALLTHRU
+      case  1UL: STORE_COMPARE_RELOAD(  0, in00 );
+    }
+
+    ulong shreds_remaining = shred_cnt-fd_ulong_min( shred_cnt, 64UL );
+    if( shreds_remaining>0UL ) {
+      FD_REEDSOL_GENERATE_IFFT( 64,  0, ALL_VARS );
+      FD_REEDSOL_GENERATE_FFT(  64, 64, ALL_VARS );
+
+      switch( fd_ulong_min( shreds_remaining, 64UL ) ) {
+        case 64UL: STORE_COMPARE( 127, in63 ); FALLTHRU
+        case 63UL: STORE_COMPARE( 126, in62 ); FALLTHRU
+        case 62UL: STORE_COMPARE( 125, in61 ); FALLTHRU
+        case 61UL: STORE_COMPARE( 124, in60 ); FALLTHRU
+        case 60UL: STORE_COMPARE( 123, in59 ); FALLTHRU
+        case 59UL: STORE_COMPARE( 122, in58 ); FALLTHRU
+        case 58UL: STORE_COMPARE( 121, in57 ); FALLTHRU
+        case 57UL: STORE_COMPARE( 120, in56 ); FALLTHRU
+        case 56UL: STORE_COMPARE( 119, in55 ); FALLTHRU
+        case 55UL: STORE_COMPARE( 118, in54 ); FALLTHRU
+        case 54UL: STORE_COMPARE( 117, in53 ); FALLTHRU
+        case 53UL: STORE_COMPARE( 116, in52 ); FALLTHRU
+        case 52UL: STORE_COMPARE( 115, in51 ); FALLTHRU
+        case 51UL: STORE_COMPARE( 114, in50 ); FALLTHRU
+        case 50UL: STORE_COMPARE( 113, in49 ); FALLTHRU
+        case 49UL: STORE_COMPARE( 112, in48 ); FALLTHRU
+        case 48UL: STORE_COMPARE( 111, in47 ); FALLTHRU
+        case 47UL: STORE_COMPARE( 110, in46 ); FALLTHRU
+        case 46UL: STORE_COMPARE( 109, in45 ); FALLTHRU
+        case 45UL: STORE_COMPARE( 108, in44 ); FALLTHRU
+        case 44UL: STORE_COMPARE( 107, in43 ); FALLTHRU
+        case 43UL: STORE_COMPARE( 106, in42 ); FALLTHRU
+        case 42UL: STORE_COMPARE( 105, in41 ); FALLTHRU
+        case 41UL: STORE_COMPARE( 104, in40 ); FALLTHRU
+        case 40UL: STORE_COMPARE( 103, in39 ); FALLTHRU
+        case 39UL: STORE_COMPARE( 102, in38 ); FALLTHRU
+        case 38UL: STORE_COMPARE( 101, in37 ); FALLTHRU
+        case 37UL: STORE_COMPARE( 100, in36 ); FALLTHRU
+        case 36UL: STORE_COMPARE( 99, in35 ); FALLTHRU
+        case 35UL: STORE_COMPARE( 98, in34 ); FALLTHRU
+        case 34UL: STORE_COMPARE( 97, in33 ); FALLTHRU
+        case 33UL: STORE_COMPARE( 96, in32 ); FALLTHRU
+        case 32UL: STORE_COMPARE( 95, in31 ); FALLTHRU
+        case 31UL: STORE_COMPARE( 94, in30 ); FALLTHRU
+        case 30UL: STORE_COMPARE( 93, in29 ); FALLTHRU
+        case 29UL: STORE_COMPARE( 92, in28 ); FALLTHRU
+        case 28UL: STORE_COMPARE( 91, in27 ); FALLTHRU
+        case 27UL: STORE_COMPARE( 90, in26 ); FALLTHRU
+        case 26UL: STORE_COMPARE( 89, in25 ); FALLTHRU
+        case 25UL: STORE_COMPARE( 88, in24 ); FALLTHRU
+        case 24UL: STORE_COMPARE( 87, in23 ); FALLTHRU
+        case 23UL: STORE_COMPARE( 86, in22 ); FALLTHRU
+        case 22UL: STORE_COMPARE( 85, in21 ); FALLTHRU
+        case 21UL: STORE_COMPARE( 84, in20 ); FALLTHRU
+        case 20UL: STORE_COMPARE( 83, in19 ); FALLTHRU
+        case 19UL: STORE_COMPARE( 82, in18 ); FALLTHRU
+        case 18UL: STORE_COMPARE( 81, in17 ); FALLTHRU
+        case 17UL: STORE_COMPARE( 80, in16 ); FALLTHRU
+        case 16UL: STORE_COMPARE( 79, in15 ); FALLTHRU
+        case 15UL: STORE_COMPARE( 78, in14 ); FALLTHRU
+        case 14UL: STORE_COMPARE( 77, in13 ); FALLTHRU
+        case 13UL: STORE_COMPARE( 76, in12 ); FALLTHRU
+        case 12UL: STORE_COMPARE( 75, in11 ); FALLTHRU
+        case 11UL: STORE_COMPARE( 74, in10 ); FALLTHRU
+        case 10UL: STORE_COMPARE( 73, in09 ); FALLTHRU
+        case  9UL: STORE_COMPARE( 72, in08 ); FALLTHRU
+        case  8UL: STORE_COMPARE( 71, in07 ); FALLTHRU
+        case  7UL: STORE_COMPARE( 70, in06 ); FALLTHRU
+        case  6UL: STORE_COMPARE( 69, in05 ); FALLTHRU
+        case  5UL: STORE_COMPARE( 68, in04 ); FALLTHRU
+        case  4UL: STORE_COMPARE( 67, in03 ); FALLTHRU
+        case  3UL: STORE_COMPARE( 66, in02 ); FALLTHRU
+        case  2UL: STORE_COMPARE( 65, in01 ); FALLTHRU
+        case  1UL: STORE_COMPARE( 64, in00 );
+      }
+      shreds_remaining -= fd_ulong_min( shreds_remaining, 64UL );
+    }
+    if( shreds_remaining>0UL ) {
+      FD_REEDSOL_GENERATE_IFFT( 64, 64, ALL_VARS );
+      FD_REEDSOL_GENERATE_FFT(  64, 128, ALL_VARS );
+
+      switch( fd_ulong_min( shreds_remaining, 64UL ) ) {
+        case  7UL: STORE_COMPARE( 134, in06 ); FALLTHRU
+        case  6UL: STORE_COMPARE( 133, in05 ); FALLTHRU
+        case  5UL: STORE_COMPARE( 132, in04 ); FALLTHRU
+        case  4UL: STORE_COMPARE( 131, in03 ); FALLTHRU
+        case  3UL: STORE_COMPARE( 130, in02 ); FALLTHRU
+        case  2UL: STORE_COMPARE( 129, in01 ); FALLTHRU
+        case  1UL: STORE_COMPARE( 128, in00 );
+      }
+      shreds_remaining -= fd_ulong_min( shreds_remaining, 64UL );
+    }
+    /* Unlike the single lane version, keep going on corruption so
+       that the other lane completes. */
+    shred_pos += GF_WIDTH;
+    shred_pos = fd_ulong_if( ((shred_sz-GF_WIDTH)<shred_pos) & (shred_pos<shred_sz), shred_sz-GF_WIDTH, shred_pos );
+  }
+  err[ 0 ] = fd_int_if( wb_any( diff_a ), FD_REEDSOL_ERR_CORRUPT, FD_REEDSOL_SUCCESS );
+  err[ 1 ] = fd_int_if( wb_any( diff_b ), FD_REEDSOL_ERR_CORRUPT, FD_REEDSOL_SUCCESS );
+}
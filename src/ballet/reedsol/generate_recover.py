@@ -153,8 +153,164 @@ def make_recover_var(n, max_shreds):
         cprint('return FD_REEDSOL_SUCCESS;')
         cprint('}')
 
+def make_recover_var_x2(n, max_shreds):
+    global outf
+    with open(f'fd_reedsol_recover_x2_{n}.c', 'wt') as outf:
+        cprint('/* Note: This file is auto generated. */')
+        cprint('#define FD_REEDSOL_ARITH_IMPL 4')
+        cprint('#include "fd_reedsol_ppt.h"')
+        cprint('#include "fd_reedsol_fderiv.h"')
+        cprint('')
+        cprint('/* Erased vectors are loaded from here instead of branching. */')
+        cprint('static uchar const zero[ GF_WIDTH ] W_ATTR = { 0 };')
+        cprint('')
+
+        cprint('FD_FN_UNSANITIZED void')
+        fn_name = f'fd_reedsol_private_recover_var_x2_{n}('
+        cprint(fn_name +          " ulong           shred_sz,")
+        cprint(" "*len(fn_name) + " uchar * const * shred_a,")
+        cprint(" "*len(fn_name) + " uchar * const * shred_b,")
+        cprint(" "*len(fn_name) + " ulong           data_shred_cnt,")
+        cprint(" "*len(fn_name) + " ulong           parity_shred_cnt,")
+        cprint(" "*len(fn_name) + " uchar const *   erased_a,")
+        cprint(" "*len(fn_name) + " uchar const *   erased_b,")
+        cprint(" "*len(fn_name) + " int *           err ) {")
+
+        cprint(f"uchar _erased_a[ {n} ] W_ATTR;")
+        cprint(f"uchar _erased_b[ {n} ] W_ATTR;")
+        cprint(f"uchar pi_a[      {n} ] W_ATTR;")
+        cprint(f"uchar pi_b[      {n} ] W_ATTR;")
+        cprint(f"ulong shred_cnt = data_shred_cnt + parity_shred_cnt;")
+
+        cprint(f'ulong loaded_cnt_a = 0UL;')
+        cprint(f'ulong loaded_cnt_b = 0UL;')
+        cprint(f'for( ulong i=0UL; i<{n}UL; i++) ' + '{')
+        cprint(f'int load_shred_a = ((i<shred_cnt)&(loaded_cnt_a<data_shred_cnt))&&( erased_a[ i ]==0 );')
+        cprint(f'int load_shred_b = ((i<shred_cnt)&(loaded_cnt_b<data_shred_cnt))&&( erased_b[ i ]==0 );')
+        cprint(f'_erased_a[ i ] = !load_shred_a;')
+        cprint(f'_erased_b[ i ] = !load_shred_b;')
+        cprint(f'loaded_cnt_a += (ulong)load_shred_a;')
+        cprint(f'loaded_cnt_b += (ulong)load_shred_b;')
+        cprint('}')
+
+        cprint("/* If either operation can't be done in this bucket, do the other")
+        cprint("   one by itself. */")
+        cprint(f'if( FD_UNLIKELY( (loaded_cnt_a<data_shred_cnt) | (loaded_cnt_b<data_shred_cnt) ) ) ' + '{')
+        cprint(f'err[ 0 ] = fd_reedsol_private_recover_var_{n}( shred_sz, shred_a, data_shred_cnt, parity_shred_cnt, erased_a );')
+        cprint(f'err[ 1 ] = fd_reedsol_private_recover_var_{n}( shred_sz, shred_b, data_shred_cnt, parity_shred_cnt, erased_b );')
+        cprint('return;')
+        cprint('}')
+
+        cprint('')
+        cprint(f'fd_reedsol_private_gen_pi_{n}( _erased_a, pi_a );')
+        cprint(f'fd_reedsol_private_gen_pi_{n}( _erased_b, pi_b );')
+        cprint('')
+        cprint('/* The multipliers differ between the lanes, so build the matrices')
+        cprint('   once rather than in every iteration. */')
+        cprint(f'gf_t pi[ {min(n, max_shreds)} ];')
+        cprint(f'for( ulong i=0UL; i<{min(n, max_shreds)}UL; i++ ) pi[ i ] = GF_MAT2( pi_a[ i ], pi_b[ i ] );')
+        cprint('')
+
+        cprint("/* Store the difference for each shred that was regenerated.  This")
+        cprint("   must be 0.  Otherwise there's a corrupt shred. */")
+        cprint("wb_t diff_a = wb_zero();")
+        cprint("wb_t diff_b = wb_zero();")
+
+        cprint('')
+        cprint("for( ulong shred_pos=0UL; shred_pos<shred_sz; /* advanced manually at end of loop */ ) {")
+
+        cprint('/* Load exactly data_shred_cnt un-erased input shreds into')
+        cprint('   their respective vector.  Fill the erased vectors with 0. */')
+        for k in range(min(n, max_shreds)):
+            cprint(f"gf_t in{k:02} = gf_ldu2( _erased_a[ {k:2} ] ? zero : shred_a[ {k:2} ] + shred_pos, _erased_b[ {k:2} ] ? zero : shred_b[ {k:2} ] + shred_pos );")
+        for k in range(min(n, max_shreds),n):
+            cprint(f"gf_t in{k:02} = gf_zero();")
+
+        for k in range(min(n, max_shreds)):
+            cprint(f'in{k:02} = GF_MUL_MAT( in{k:02}, pi[ {k:2} ] );')
+
+        all_vars = [ f'in{k:02}' for k in range(n) ]
+        cprint(f"#define ALL_VARS " + ", ".join(all_vars))
+        cprint('')
+        cprint(f'FD_REEDSOL_GENERATE_IFFT( {n}, 0, ALL_VARS );')
+        cprint('')
+        cprint(f'FD_REEDSOL_GENERATE_FDERIV( {n}, ALL_VARS );')
+        cprint('')
+        cprint(f'FD_REEDSOL_GENERATE_FFT( {n}, 0, ALL_VARS );')
+        cprint('')
+
+        for k in range(min(n, max_shreds)):
+            cprint(f'in{k:02} = GF_MUL_MAT( in{k:02}, pi[ {k:2} ] );')
+
+        cprint("/* Same cases as fd_reedsol_private_recover_var_{n}, but handled")
+        cprint("   separately for each lane. */")
+
+        cprint("""#define STORE_COMPARE_RELOAD_LANE( n, v, shred, erased, _erased, diff ) do{                      \
+            if(       erased[ n ] )        wb_stu( shred[ n ] + shred_pos, v );                              \
+            else if( _erased[ n ] ) diff = wb_or( diff, wb_xor( v, wb_ldu( shred[ n ] + shred_pos ) ) );     \
+            else                    v    = wb_ldu( shred[ n ] + shred_pos );                                 \
+          } while( 0 )""")
+        cprint("""#define STORE_COMPARE_LANE( n, v, shred, erased, diff ) do{                                         \
+          if(       erased[ n ] )        wb_stu( shred[ n ] + shred_pos, v );                                \
+          else                    diff = wb_or( diff, wb_xor( v, wb_ldu( shred[ n ] + shred_pos ) ) );       \
+        } while( 0 )""")
+        cprint("""#define STORE_COMPARE_RELOAD( n, var ) do{                                                         \
+            wb_t _va = gf_lo( var );                                                                         \
+            wb_t _vb = gf_hi( var );                                                                         \
+            STORE_COMPARE_RELOAD_LANE( n, _va, shred_a, erased_a, _erased_a, diff_a );                       \
+            STORE_COMPARE_RELOAD_LANE( n, _vb, shred_b, erased_b, _erased_b, diff_b );                       \
+            var = gf_join( _va, _vb );                                                                       \
+          } while( 0 )""")
+        cprint("""#define STORE_COMPARE( n, var ) do{                                                              \
+          STORE_COMPARE_LANE( n, gf_lo( var ), shred_a, erased_a, diff_a );                                  \
+          STORE_COMPARE_LANE( n, gf_hi( var ), shred_b, erased_b, diff_b );                                  \
+        } while( 0 )""")
+        cprint(f"switch( fd_ulong_min( shred_cnt, {n}UL ) ) " + "{")
+        for k in range(min(n, max_shreds)-1, -1, -1):
+            fallthru = ""
+            if k>0:
+                fallthru = " FALLTHRU"
+            cprint(f"case {k+1:2}UL: STORE_COMPARE_RELOAD( {k:2}, in{k:02} );{fallthru}")
+        cprint("}")
+        cprint("")
+
+        if max_shreds > n:
+            cprint(f"ulong shreds_remaining = shred_cnt-fd_ulong_min( shred_cnt, {n}UL );")
+
+        potential_shreds_remaining = max_shreds - n
+        chunk_cnt = 0
+        while potential_shreds_remaining>0:
+            cprint("if( shreds_remaining>0UL ) {")
+            cprint(f"FD_REEDSOL_GENERATE_IFFT( {n}, {n*chunk_cnt:2}, ALL_VARS );")
+            cprint(f"FD_REEDSOL_GENERATE_FFT(  {n}, {n*(chunk_cnt+1):2}, ALL_VARS );")
+            cprint("")
+            cprint(f"switch( fd_ulong_min( shreds_remaining, {n}UL ) ) " + "{")
+            for k in range(min(n-1, potential_shreds_remaining), -1, -1):
+                fallthru = ""
+                if k>0:
+                    fallthru = " FALLTHRU"
+                cprint(f"case {k+1:2}UL: STORE_COMPARE( {k+n*(chunk_cnt+1):2}, in{k:02} );{fallthru}")
+            cprint("}")
+            cprint(f'shreds_remaining -= fd_ulong_min( shreds_remaining, {n}UL );')
+            cprint("}")
+
+            potential_shreds_remaining -= n
+            chunk_cnt += 1
+
+        cprint("/* Unlike the single lane version, keep going on corruption so")
+        cprint("   that the other lane completes. */")
+        cprint('shred_pos += GF_WIDTH;')
+        cprint('shred_pos = fd_ulong_if( ((shred_sz-GF_WIDTH)<shred_pos) & (shred_pos<shred_sz), shred_sz-GF_WIDTH, shred_pos );')
+        cprint('}')
+        cprint('err[ 0 ] = fd_int_if( wb_any( diff_a ), FD_REEDSOL_ERR_CORRUPT, FD_REEDSOL_SUCCESS );')
+        cprint('err[ 1 ] = fd_int_if( wb_any( diff_b ), FD_REEDSOL_ERR_CORRUPT, FD_REEDSOL_SUCCESS );')
+        cprint('}')
+
 make_recover_var( 16, 67*2)
 make_recover_var( 32, 67*2)
 make_recover_var( 64, 67*2)
 make_recover_var(128, 67*2)
 make_recover_var(256, 67*2)
+
+make_recover_var_x2( 32, 67*2)
+make_recover_var_x2( 64, 67*2)
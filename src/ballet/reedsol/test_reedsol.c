@@ -843,6 +843,93 @@ test_recover( fd_rng_t * rng ) {
   }
 }
 
+uchar mem_b[ FD_REEDSOL_FOOTPRINT ] __attribute__((aligned(FD_REEDSOL_ALIGN)));
+
+/* test_recover_pair checks fd_reedsol_recover_fini_pair against the
+   known original shreds for two random FEC sets at a time, including
+   when only one of them is partial or corrupt, and when their shred
+   counts differ.  The shred size is odd to also exercise how
+   fd_reedsol_recover_fini splits shreds. */
+
+static void
+test_recover_pair( fd_rng_t * rng ) {
+  ulong const shred_sz = SHRED_SZ-31UL;
+
+  uchar * d[ FD_REEDSOL_DATA_SHREDS_MAX   ];
+  uchar * p[ FD_REEDSOL_PARITY_SHREDS_MAX ];
+  uchar * r[ FD_REEDSOL_PARITY_SHREDS_MAX ];
+  for( ulong i=0UL; i<FD_REEDSOL_DATA_SHREDS_MAX;   i++ )  d[ i ] = data_shreds + SHRED_SZ*i;
+  for( ulong i=0UL; i<FD_REEDSOL_PARITY_SHREDS_MAX; i++ )  p[ i ] = parity_shreds + SHRED_SZ*i;
+  for( ulong i=0UL; i<FD_REEDSOL_PARITY_SHREDS_MAX; i++ )  r[ i ] = recovered_shreds + SHRED_SZ*i;
+
+  for( ulong i=0UL; i<FD_REEDSOL_DATA_SHREDS_MAX; i++ ) for( ulong j=0UL; j<SHRED_SZ; j++ ) d[ i ][ j ] = fd_rng_uchar( rng );
+
+  for( ulong rep=0UL; rep<4096UL; rep++ ) {
+    /* Set a uses d[ 0, d_cnt[0] ) and p[ 0, p_cnt[0] ), set b the ones
+       right after.  Each set has at most 33 data and 32 parity shreds,
+       so at most 33 erasures, which all fits. */
+    ulong d_cnt[ 2 ]; ulong p_cnt[ 2 ];
+    d_cnt[ 0 ] = 1UL+fd_rng_ulong_roll( rng, 33UL );
+    p_cnt[ 0 ] = 1UL+fd_rng_ulong_roll( rng, 32UL );
+    int same = fd_rng_uint_roll( rng, 8U )>0U;
+    d_cnt[ 1 ] = fd_ulong_if( same, d_cnt[ 0 ], 1UL+fd_rng_ulong_roll( rng, 33UL ) );
+    p_cnt[ 1 ] = fd_ulong_if( same, p_cnt[ 0 ], 1UL+fd_rng_ulong_roll( rng, 32UL ) );
+
+    uchar *      * sd[ 2 ] = { d, d+d_cnt[ 0 ] };
+    uchar *      * sp[ 2 ] = { p, p+p_cnt[ 0 ] };
+    uchar *      * sr[ 2 ];
+    fd_reedsol_t * rs[ 2 ];
+    void         * rs_mem[ 2 ] = { mem, mem_b };
+    uchar *        erased_truth[ 2 ][ FD_REEDSOL_PARITY_SHREDS_MAX+1UL ];
+    ulong          e_cnt[ 2 ];
+    uchar *        corrupt[ 2 ] = { NULL, NULL };
+
+    for( ulong s=0UL; s<2UL; s++ ) {
+      rs[ s ] = fd_reedsol_encode_init( rs_mem[ s ], shred_sz );
+      for( ulong i=0UL; i<d_cnt[ s ]; i++ ) fd_reedsol_encode_add_data_shred(   rs[ s ], sd[ s ][ i ] );
+      for( ulong i=0UL; i<p_cnt[ s ]; i++ ) fd_reedsol_encode_add_parity_shred( rs[ s ], sp[ s ][ i ] );
+      fd_reedsol_encode_fini( rs[ s ] );
+    }
+
+    sr[ 0 ] = r;
+    for( ulong s=0UL; s<2UL; s++ ) {
+      e_cnt[ s ] = fd_rng_ulong_roll( rng, p_cnt[ s ]+2UL ); /* Occasionally partial */
+      ulong erased_cnt = 0UL;
+      rs[ s ] = fd_reedsol_recover_init( rs_mem[ s ], shred_sz );
+      for( ulong i=0UL; i<d_cnt[ s ]+p_cnt[ s ]; i++ ) {
+        int     is_data = i<d_cnt[ s ];
+        uchar * shred   = is_data ? sd[ s ][ i ] : sp[ s ][ i-d_cnt[ s ] ];
+        if( fd_rng_ulong_roll( rng, d_cnt[ s ]+p_cnt[ s ]-i ) < (e_cnt[ s ]-erased_cnt) ) {
+          erased_truth[ s ][ erased_cnt ] = shred;
+          fd_reedsol_recover_add_erased_shred( rs[ s ], is_data, sr[ s ][ erased_cnt++ ] );
+        } else {
+          fd_reedsol_recover_add_rcvd_shred( rs[ s ], is_data, shred );
+          if( !corrupt[ s ] && !fd_rng_uint_roll( rng, 64U ) ) corrupt[ s ] = shred;
+        }
+      }
+      FD_TEST( erased_cnt==e_cnt[ s ] ); /* If this fails, the test is wrong. */
+      if( !s ) sr[ 1 ] = r+erased_cnt;
+    }
+
+    ulong byte_idx = fd_rng_ulong_roll( rng, shred_sz );
+    for( ulong s=0UL; s<2UL; s++ ) if( corrupt[ s ] ) corrupt[ s ][ byte_idx ] ^= (uchar)1;
+
+    int err[ 2 ];
+    fd_reedsol_recover_fini_pair( rs[ 0 ], rs[ 1 ], err );
+
+    for( ulong s=0UL; s<2UL; s++ ) {
+      if( corrupt[ s ] ) corrupt[ s ][ byte_idx ] ^= (uchar)1;
+
+      if( e_cnt[ s ]>p_cnt[ s ] ) { FD_TEST( err[ s ]==FD_REEDSOL_ERR_PARTIAL ); continue; }
+      /* With no redundancy left, corruption can't be detected */
+      if( corrupt[ s ]          ) { if( e_cnt[ s ]<p_cnt[ s ] ) FD_TEST( err[ s ]==FD_REEDSOL_ERR_CORRUPT ); continue; }
+
+      FD_TEST( err[ s ]==FD_REEDSOL_SUCCESS );
+      for( ulong i=0UL; i<e_cnt[ s ]; i++ ) FD_TEST( 0==memcmp( erased_truth[ s ][ i ], sr[ s ][ i ], shred_sz ) );
+    }
+  }
+}
+
 static void
 test_recover_performance( fd_rng_t *    rng ) {
   ulong const test_count = 90000UL;
@@ -983,6 +1070,45 @@ test_recover_performance( fd_rng_t *    rng ) {
                   (double)(test_count * 64UL * SHRED_SZ) / ((double)(recover)*1.0737),
                   (double)(test_count * 64UL * SHRED_SZ * 8UL) / ((double)(recover))
         ));
+
+  /* Test two FEC sets at once, with the even shreds of one and the odd
+     shreds of the other erased.  Both read the same shreds, which is
+     fine since each only writes to its own erased shreds. */
+  uchar * r2[ 32 ];
+  for( ulong i=0UL; i<32UL; i++ ) r2[ i ] = recovered_shreds + SHRED_SZ*(32UL+i);
+  fd_reedsol_t * rs_b;
+  int err[ 2 ];
+
+  /* Warm up instruction cache */
+  rs   = fd_reedsol_recover_init( mem,   SHRED_SZ );
+  rs_b = fd_reedsol_recover_init( mem_b, SHRED_SZ );
+  for( ulong i=0UL; i<32UL; i+=2UL ) { fd_reedsol_recover_add_erased_shred( rs, 1, r[ i/2UL ] );      fd_reedsol_recover_add_rcvd_shred( rs, 1, d[ i+1UL ] ); }
+  for( ulong i=0UL; i<32UL; i+=2UL ) { fd_reedsol_recover_add_erased_shred( rs, 0, r[ 16UL+i/2UL ] ); fd_reedsol_recover_add_rcvd_shred( rs, 0, p[ i+1UL ] ); }
+  for( ulong i=0UL; i<32UL; i+=2UL ) { fd_reedsol_recover_add_rcvd_shred( rs_b, 1, d[ i ] ); fd_reedsol_recover_add_erased_shred( rs_b, 1, r2[ i/2UL ]      ); }
+  for( ulong i=0UL; i<32UL; i+=2UL ) { fd_reedsol_recover_add_rcvd_shred( rs_b, 0, p[ i ] ); fd_reedsol_recover_add_erased_shred( rs_b, 0, r2[ 16UL+i/2UL ] ); }
+  fd_reedsol_recover_fini_pair( rs, rs_b, err );
+  FD_TEST( (err[ 0 ]==FD_REEDSOL_SUCCESS) & (err[ 1 ]==FD_REEDSOL_SUCCESS) );
+
+  /* Measure recover */
+  recover = -fd_log_wallclock();
+
+  for( ulong i=0UL; i<test_count; i++ ) {
+    rs   = fd_reedsol_recover_init( mem,   SHRED_SZ );
+    rs_b = fd_reedsol_recover_init( mem_b, SHRED_SZ );
+    for( ulong i=0UL; i<32UL; i+=2UL ) { fd_reedsol_recover_add_erased_shred( rs, 1, r[ i/2UL ] );      fd_reedsol_recover_add_rcvd_shred( rs, 1, d[ i+1UL ] ); }
+    for( ulong i=0UL; i<32UL; i+=2UL ) { fd_reedsol_recover_add_erased_shred( rs, 0, r[ 16UL+i/2UL ] ); fd_reedsol_recover_add_rcvd_shred( rs, 0, p[ i+1UL ] ); }
+    for( ulong i=0UL; i<32UL; i+=2UL ) { fd_reedsol_recover_add_rcvd_shred( rs_b, 1, d[ i ] ); fd_reedsol_recover_add_erased_shred( rs_b, 1, r2[ i/2UL ]      ); }
+    for( ulong i=0UL; i<32UL; i+=2UL ) { fd_reedsol_recover_add_rcvd_shred( rs_b, 0, p[ i ] ); fd_reedsol_recover_add_erased_shred( rs_b, 0, r2[ 16UL+i/2UL ] ); }
+    fd_reedsol_recover_fini_pair( rs, rs_b, err );
+  }
+
+  recover += fd_log_wallclock();
+
+  FD_LOG_NOTICE(( "average time per recover pair (even/odd erased) call %f ns ( %f GiB/s, %f Gbps )",
+                  (double)(recover        )/(double)test_count,
+                  (double)(test_count * 128UL * SHRED_SZ) / ((double)(recover)*1.0737),
+                  (double)(test_count * 128UL * SHRED_SZ * 8UL) / ((double)(recover))
+        ));
 }
 
 int
@@ -997,6 +1123,7 @@ main( int     argc,
   battery_performance_generic( rng, 32UL, 32UL, 5000UL );
   test_encode_vs_ref( rng );
   test_recover( rng );
+  test_recover_pair( rng );
   test_recover_performance( rng );
   test_pi_all( rng );
   test_linearity_all( rng );
@@ -608,3 +608,100 @@ fd_sha256_hash_32_repeated( void const * _data,
 }
 
 #undef fd_sha256_core
+
+void
+fd_sha256_hash_32_repeated_batch( ulong                chain_cnt,
+                                  void const * const * data,
+                                  void * const *       hash,
+                                  ulong const *        cnt ) {
+
+#if FD_SHA256_BATCH_IMPL==0
+
+  for( ulong chain_idx=0UL; chain_idx<chain_cnt; chain_idx++ )
+    fd_sha256_hash_32_repeated( data[ chain_idx ], hash[ chain_idx ], cnt[ chain_idx ] );
+
+#else
+
+# if FD_SHA256_BATCH_IMPL==1
+# define BATCH_32_REPEATED fd_sha256_private_batch_32_repeated_avx
+# else
+# define BATCH_32_REPEATED fd_sha256_private_batch_32_repeated_avx512
+# endif
+
+  /* Once fewer than MIN_LANE_CNT chains are left, it is faster to
+     finish them sequentially.  With SHA-NI, a sequential chain runs
+     several times faster than a single lane of the batch. */
+
+# if FD_HAS_SHANI
+# define MIN_LANE_CNT ((3UL*FD_SHA256_BATCH_MAX)/8UL)
+# else
+# define MIN_LANE_CNT (1UL)
+# endif
+
+  uchar  lane_state[ FD_SHA256_BATCH_MAX ][ 32 ] __attribute__((aligned(64)));
+  void * lane_hash [ FD_SHA256_BATCH_MAX ];
+  ulong  lane_chain[ FD_SHA256_BATCH_MAX ]; /* ULONG_MAX if the lane is idle */
+  ulong  lane_rem  [ FD_SHA256_BATCH_MAX ];
+
+  for( ulong lane=0UL; lane<FD_SHA256_BATCH_MAX; lane++ ) {
+    lane_hash [ lane ] = lane_state[ lane ];
+    lane_chain[ lane ] = ULONG_MAX;
+    lane_rem  [ lane ] = 0UL;
+  }
+
+  ulong next = 0UL;
+  for(;;) {
+
+    /* Refill idle lanes with the next chains.  Zero length chains are
+       completed immediately. */
+
+    ulong active_cnt = 0UL;
+    ulong iter_cnt   = ULONG_MAX;
+    for( ulong lane=0UL; lane<FD_SHA256_BATCH_MAX; lane++ ) {
+      if( lane_chain[ lane ]==ULONG_MAX ) {
+        while( next<chain_cnt && !cnt[ next ] ) { memmove( hash[ next ], data[ next ], 32UL ); next++; }
+        if( next<chain_cnt ) {
+          memcpy( lane_state[ lane ], data[ next ], 32UL );
+          lane_chain[ lane ] = next;
+          lane_rem  [ lane ] = cnt[ next ];
+          next++;
+        }
+      }
+      if( lane_chain[ lane ]!=ULONG_MAX ) {
+        active_cnt++;
+        iter_cnt = fd_ulong_min( iter_cnt, lane_rem[ lane ] );
+      }
+    }
+
+    if( FD_UNLIKELY( !active_cnt ) ) break;
+
+    if( FD_UNLIKELY( active_cnt<MIN_LANE_CNT ) ) {
+      /* All chains have been assigned a lane at this point */
+      for( ulong lane=0UL; lane<FD_SHA256_BATCH_MAX; lane++ ) {
+        ulong chain_idx = lane_chain[ lane ];
+        if( chain_idx!=ULONG_MAX ) fd_sha256_hash_32_repeated( lane_state[ lane ], hash[ chain_idx ], lane_rem[ lane ] );
+      }
+      break;
+    }
+
+    /* Advance all lanes by the length of the shortest active chain and
+       retire the chains that completed.  Idle lanes hash garbage. */
+
+    BATCH_32_REPEATED( lane_hash, iter_cnt );
+
+    for( ulong lane=0UL; lane<FD_SHA256_BATCH_MAX; lane++ ) {
+      ulong chain_idx = lane_chain[ lane ];
+      if( chain_idx==ULONG_MAX ) continue;
+      lane_rem[ lane ] -= iter_cnt;
+      if( !lane_rem[ lane ] ) {
+        memcpy( hash[ chain_idx ], lane_state[ lane ], 32UL );
+        lane_chain[ lane ] = ULONG_MAX;
+      }
+    }
+  }
+
+# undef MIN_LANE_CNT
+# undef BATCH_32_REPEATED
+
+#endif
+}
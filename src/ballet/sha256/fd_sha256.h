@@ -167,6 +167,25 @@ fd_sha256_hash_32_repeated( void const * data,
                             void *       hash,
                             ulong        cnt );
 
+/* fd_sha256_hash_32_repeated_batch computes chain_cnt independent
+   fd_sha256_hash_32_repeated chains.  It is equivalent to:
+
+   for( ulong i=0UL; i<chain_cnt; i++ )
+     fd_sha256_hash_32_repeated( data[i], hash[i], cnt[i] );
+
+   but runs the chains in parallel in the lanes of the batch
+   implementation (e.g. verifying many Proof-of-History entries at
+   once).  Whenever a chain completes, its lane is refilled with the
+   next chain, so chains of very different lengths are fine.  data[i]
+   may be equal to hash[i].  hash regions should not overlap each other
+   or any data region of another chain. */
+
+void
+fd_sha256_hash_32_repeated_batch( ulong                chain_cnt,
+                                  void const * const * data,
+                                  void * const *       hash,
+                                  ulong const *        cnt );
+
 FD_PROTOTYPES_END
 
 #if 0 /* SHA256 batch API details */
@@ -339,6 +358,11 @@ fd_sha256_private_batch_avx( ulong          batch_cnt,    /* In [1,FD_SHA256_BAT
                              void * const * batch_hash ); /* Indexed [0,FD_SHA256_BATCH_MAX), aligned 32,
                                                              only [0,batch_cnt) used */
 
+void
+fd_sha256_private_batch_32_repeated_avx( void * const * batch_hash, /* Indexed [0,FD_SHA256_BATCH_MAX), all used,
+                                                                       each a 32 byte state hashed in place */
+                                         ulong          cnt );      /* Number of repeated hashes per lane */
+
 FD_FN_CONST static inline ulong fd_sha256_batch_align    ( void ) { return alignof(fd_sha256_batch_t); }
 FD_FN_CONST static inline ulong fd_sha256_batch_footprint( void ) { return sizeof (fd_sha256_batch_t); }
 
@@ -411,6 +435,11 @@ fd_sha256_private_batch_avx512( ulong          batch_cnt,    /* In [1,FD_SHA256_
                                 void * const * batch_hash ); /* Indexed [0,FD_SHA256_BATCH_MAX), aligned 32,
                                                                 only [0,batch_cnt) used */
 
+void
+fd_sha256_private_batch_32_repeated_avx512( void * const * batch_hash, /* Indexed [0,FD_SHA256_BATCH_MAX), all used,
+                                                                          each a 32 byte state hashed in place */
+                                            ulong          cnt );      /* Number of repeated hashes per lane */
+
 FD_FN_CONST static inline ulong fd_sha256_batch_align    ( void ) { return alignof(fd_sha256_batch_t); }
 FD_FN_CONST static inline ulong fd_sha256_batch_footprint( void ) { return sizeof (fd_sha256_batch_t); }
 
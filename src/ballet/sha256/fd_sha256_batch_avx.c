@@ -299,3 +299,132 @@ fd_sha256_private_batch_avx( ulong          batch_cnt,
   default: break;
   }
 }
+
+void
+fd_sha256_private_batch_32_repeated_avx( void * const * _batch_hash,
+                                         ulong          cnt ) {
+
+  /* Load the 8 lanes' 32 byte states and transpose them such that xj
+     holds word j of every lane's state.  The state stays in this form
+     for all cnt iterations. */
+
+  uchar * const * batch_hash = (uchar * const *)_batch_hash;
+
+  wu_t x0; wu_t x1; wu_t x2; wu_t x3; wu_t x4; wu_t x5; wu_t x6; wu_t x7;
+  wu_transpose_8x8( wu_bswap( wu_ldu( batch_hash[0] ) ), wu_bswap( wu_ldu( batch_hash[1] ) ),
+                    wu_bswap( wu_ldu( batch_hash[2] ) ), wu_bswap( wu_ldu( batch_hash[3] ) ),
+                    wu_bswap( wu_ldu( batch_hash[4] ) ), wu_bswap( wu_ldu( batch_hash[5] ) ),
+                    wu_bswap( wu_ldu( batch_hash[6] ) ), wu_bswap( wu_ldu( batch_hash[7] ) ),
+                    x0, x1, x2, x3, x4, x5, x6, x7 );
+
+  /* Each iteration hashes exactly one block: the 32 byte state, the
+     message terminator and the message size in bits (256). */
+
+  wu_t const zero = wu_zero();
+  wu_t const x8_0 = wu_bcast( 0x80000000U );
+  wu_t const xf_0 = wu_bcast( 256U );
+
+  wu_t const s0 = wu_bcast( FD_SHA256_INITIAL_A );
+  wu_t const s1 = wu_bcast( FD_SHA256_INITIAL_B );
+  wu_t const s2 = wu_bcast( FD_SHA256_INITIAL_C );
+  wu_t const s3 = wu_bcast( FD_SHA256_INITIAL_D );
+  wu_t const s4 = wu_bcast( FD_SHA256_INITIAL_E );
+  wu_t const s5 = wu_bcast( FD_SHA256_INITIAL_F );
+  wu_t const s6 = wu_bcast( FD_SHA256_INITIAL_G );
+  wu_t const s7 = wu_bcast( FD_SHA256_INITIAL_H );
+
+# define Sigma0(x)  wu_xor( wu_rol(x,30), wu_xor( wu_rol(x,19), wu_rol(x,10) ) )
+# define Sigma1(x)  wu_xor( wu_rol(x,26), wu_xor( wu_rol(x,21), wu_rol(x, 7) ) )
+# define sigma0(x)  wu_xor( wu_rol(x,25), wu_xor( wu_rol(x,14), wu_shr(x, 3) ) )
+# define sigma1(x)  wu_xor( wu_rol(x,15), wu_xor( wu_rol(x,13), wu_shr(x,10) ) )
+# define Ch(x,y,z)  wu_xor( wu_and(x,y), wu_andnot(x,z) )
+# define Maj(x,y,z) wu_xor( wu_and(x,y), wu_xor( wu_and(x,z), wu_and(y,z) ) )
+# define SHA_CORE(xi,ki)                                                       \
+  T1 = wu_add( wu_add(xi,ki), wu_add( wu_add( h, Sigma1(e) ), Ch(e, f, g) ) ); \
+  T2 = wu_add( Sigma0(a), Maj(a, b, c) );                                      \
+  h = g;                                                                       \
+  g = f;                                                                       \
+  f = e;                                                                       \
+  e = wu_add( d, T1 );                                                         \
+  d = c;                                                                       \
+  c = b;                                                                       \
+  b = a;                                                                       \
+  a = wu_add( T1, T2 )
+
+  for( ulong iter=0UL; iter<cnt; iter++ ) {
+    wu_t w0 = x0;   wu_t w1 = x1;   wu_t w2 = x2;   wu_t w3 = x3;
+    wu_t w4 = x4;   wu_t w5 = x5;   wu_t w6 = x6;   wu_t w7 = x7;
+    wu_t w8 = x8_0; wu_t w9 = zero; wu_t wa = zero; wu_t wb = zero;
+    wu_t wc = zero; wu_t wd = zero; wu_t we = zero; wu_t wf = xf_0;
+
+    wu_t a = s0; wu_t b = s1; wu_t c = s2; wu_t d = s3; wu_t e = s4; wu_t f = s5; wu_t g = s6; wu_t h = s7;
+
+    wu_t T1;
+    wu_t T2;
+
+    SHA_CORE( w0, wu_bcast( fd_sha256_K[ 0] ) );
+    SHA_CORE( w1, wu_bcast( fd_sha256_K[ 1] ) );
+    SHA_CORE( w2, wu_bcast( fd_sha256_K[ 2] ) );
+    SHA_CORE( w3, wu_bcast( fd_sha256_K[ 3] ) );
+    SHA_CORE( w4, wu_bcast( fd_sha256_K[ 4] ) );
+    SHA_CORE( w5, wu_bcast( fd_sha256_K[ 5] ) );
+    SHA_CORE( w6, wu_bcast( fd_sha256_K[ 6] ) );
+    SHA_CORE( w7, wu_bcast( fd_sha256_K[ 7] ) );
+    SHA_CORE( w8, wu_bcast( fd_sha256_K[ 8] ) );
+    SHA_CORE( w9, wu_bcast( fd_sha256_K[ 9] ) );
+    SHA_CORE( wa, wu_bcast( fd_sha256_K[10] ) );
+    SHA_CORE( wb, wu_bcast( fd_sha256_K[11] ) );
+    SHA_CORE( wc, wu_bcast( fd_sha256_K[12] ) );
+    SHA_CORE( wd, wu_bcast( fd_sha256_K[13] ) );
+    SHA_CORE( we, wu_bcast( fd_sha256_K[14] ) );
+    SHA_CORE( wf, wu_bcast( fd_sha256_K[15] ) );
+    for( ulong i=16UL; i<64UL; i+=16UL ) {
+      w0 = wu_add( wu_add( w0, sigma0(w1) ), wu_add( sigma1(we), w9 ) ); SHA_CORE( w0, wu_bcast( fd_sha256_K[i     ] ) );
+      w1 = wu_add( wu_add( w1, sigma0(w2) ), wu_add( sigma1(wf), wa ) ); SHA_CORE( w1, wu_bcast( fd_sha256_K[i+ 1UL] ) );
+      w2 = wu_add( wu_add( w2, sigma0(w3) ), wu_add( sigma1(w0), wb ) ); SHA_CORE( w2, wu_bcast( fd_sha256_K[i+ 2UL] ) );
+      w3 = wu_add( wu_add( w3, sigma0(w4) ), wu_add( sigma1(w1), wc ) ); SHA_CORE( w3, wu_bcast( fd_sha256_K[i+ 3UL] ) );
+      w4 = wu_add( wu_add( w4, sigma0(w5) ), wu_add( sigma1(w2), wd ) ); SHA_CORE( w4, wu_bcast( fd_sha256_K[i+ 4UL] ) );
+      w5 = wu_add( wu_add( w5, sigma0(w6) ), wu_add( sigma1(w3), we ) ); SHA_CORE( w5, wu_bcast( fd_sha256_K[i+ 5UL] ) );
+      w6 = wu_add( wu_add( w6, sigma0(w7) ), wu_add( sigma1(w4), wf ) ); SHA_CORE( w6, wu_bcast( fd_sha256_K[i+ 6UL] ) );
+      w7 = wu_add( wu_add( w7, sigma0(w8) ), wu_add( sigma1(w5), w0 ) ); SHA_CORE( w7, wu_bcast( fd_sha256_K[i+ 7UL] ) );
+      w8 = wu_add( wu_add( w8, sigma0(w9) ), wu_add( sigma1(w6), w1 ) ); SHA_CORE( w8, wu_bcast( fd_sha256_K[i+ 8UL] ) );
+      w9 = wu_add( wu_add( w9, sigma0(wa) ), wu_add( sigma1(w7), w2 ) ); SHA_CORE( w9, wu_bcast( fd_sha256_K[i+ 9UL] ) );
+      wa = wu_add( wu_add( wa, sigma0(wb) ), wu_add( sigma1(w8), w3 ) ); SHA_CORE( wa, wu_bcast( fd_sha256_K[i+10UL] ) );
+      wb = wu_add( wu_add( wb, sigma0(wc) ), wu_add( sigma1(w9), w4 ) ); SHA_CORE( wb, wu_bcast( fd_sha256_K[i+11UL] ) );
+      wc = wu_add( wu_add( wc, sigma0(wd) ), wu_add( sigma1(wa), w5 ) ); SHA_CORE( wc, wu_bcast( fd_sha256_K[i+12UL] ) );
+      wd = wu_add( wu_add( wd, sigma0(we) ), wu_add( sigma1(wb), w6 ) ); SHA_CORE( wd, wu_bcast( fd_sha256_K[i+13UL] ) );
+      we = wu_add( wu_add( we, sigma0(wf) ), wu_add( sigma1(wc), w7 ) ); SHA_CORE( we, wu_bcast( fd_sha256_K[i+14UL] ) );
+      wf = wu_add( wu_add( wf, sigma0(w0) ), wu_add( sigma1(wd), w8 ) ); SHA_CORE( wf, wu_bcast( fd_sha256_K[i+15UL] ) );
+    }
+
+    x0 = wu_add( s0, a );
+    x1 = wu_add( s1, b );
+    x2 = wu_add( s2, c );
+    x3 = wu_add( s3, d );
+    x4 = wu_add( s4, e );
+    x5 = wu_add( s5, f );
+    x6 = wu_add( s6, g );
+    x7 = wu_add( s7, h );
+  }
+
+# undef SHA_CORE
+# undef Sigma0
+# undef Sigma1
+# undef sigma0
+# undef sigma1
+# undef Ch
+# undef Maj
+
+  /* Store the results */
+
+  wu_transpose_8x8( x0,x1,x2,x3,x4,x5,x6,x7, x0,x1,x2,x3,x4,x5,x6,x7 );
+
+  wu_stu( batch_hash[0], wu_bswap( x0 ) );
+  wu_stu( batch_hash[1], wu_bswap( x1 ) );
+  wu_stu( batch_hash[2], wu_bswap( x2 ) );
+  wu_stu( batch_hash[3], wu_bswap( x3 ) );
+  wu_stu( batch_hash[4], wu_bswap( x4 ) );
+  wu_stu( batch_hash[5], wu_bswap( x5 ) );
+  wu_stu( batch_hash[6], wu_bswap( x6 ) );
+  wu_stu( batch_hash[7], wu_bswap( x7 ) );
+}
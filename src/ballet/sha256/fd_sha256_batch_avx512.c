@@ -308,3 +308,135 @@ fd_sha256_private_batch_avx512( ulong          batch_cnt,
   default: break;
   }
 }
+
+void
+fd_sha256_private_batch_32_repeated_avx512( void * const * _batch_hash,
+                                            ulong          cnt ) {
+
+  /* Load the 16 lanes' 32 byte states, lanes i and i+8 sharing a row,
+     and transpose them such that xj holds word j of every lane's state.
+     The state stays in this form for all cnt iterations. */
+
+  uchar * const * batch_hash = (uchar * const *)_batch_hash;
+
+# define LD2(i) _mm512_inserti64x4( _mm512_castsi256_si512( wu_ldu( batch_hash[(i)] ) ), wu_ldu( batch_hash[(i)+8] ), 1 )
+
+  wwu_t x0; wwu_t x1; wwu_t x2; wwu_t x3; wwu_t x4; wwu_t x5; wwu_t x6; wwu_t x7;
+  wwu_transpose_2x8x8( wwu_bswap( LD2(0) ), wwu_bswap( LD2(1) ), wwu_bswap( LD2(2) ), wwu_bswap( LD2(3) ),
+                       wwu_bswap( LD2(4) ), wwu_bswap( LD2(5) ), wwu_bswap( LD2(6) ), wwu_bswap( LD2(7) ),
+                       x0, x1, x2, x3, x4, x5, x6, x7 );
+
+# undef LD2
+
+  /* Each iteration hashes exactly one block: the 32 byte state, the
+     message terminator and the message size in bits (256). */
+
+  wwu_t const zero = wwu_zero();
+  wwu_t const x8_0 = wwu_bcast( 0x80000000U );
+  wwu_t const xf_0 = wwu_bcast( 256U );
+
+  wwu_t const s0 = wwu_bcast( FD_SHA256_INITIAL_A );
+  wwu_t const s1 = wwu_bcast( FD_SHA256_INITIAL_B );
+  wwu_t const s2 = wwu_bcast( FD_SHA256_INITIAL_C );
+  wwu_t const s3 = wwu_bcast( FD_SHA256_INITIAL_D );
+  wwu_t const s4 = wwu_bcast( FD_SHA256_INITIAL_E );
+  wwu_t const s5 = wwu_bcast( FD_SHA256_INITIAL_F );
+  wwu_t const s6 = wwu_bcast( FD_SHA256_INITIAL_G );
+  wwu_t const s7 = wwu_bcast( FD_SHA256_INITIAL_H );
+
+# define Sigma0(x)  wwu_xor( wwu_rol(x,30), wwu_xor( wwu_rol(x,19), wwu_rol(x,10) ) )
+# define Sigma1(x)  wwu_xor( wwu_rol(x,26), wwu_xor( wwu_rol(x,21), wwu_rol(x, 7) ) )
+# define sigma0(x)  wwu_xor( wwu_rol(x,25), wwu_xor( wwu_rol(x,14), wwu_shr(x, 3) ) )
+# define sigma1(x)  wwu_xor( wwu_rol(x,15), wwu_xor( wwu_rol(x,13), wwu_shr(x,10) ) )
+# define Ch(x,y,z)  wwu_xor( wwu_and(x,y), wwu_andnot(x,z) )
+# define Maj(x,y,z) wwu_xor( wwu_and(x,y), wwu_xor( wwu_and(x,z), wwu_and(y,z) ) )
+# define SHA_CORE(xi,ki)                                                           \
+  T1 = wwu_add( wwu_add(xi,ki), wwu_add( wwu_add( h, Sigma1(e) ), Ch(e, f, g) ) ); \
+  T2 = wwu_add( Sigma0(a), Maj(a, b, c) );                                         \
+  h = g;                                                                           \
+  g = f;                                                                           \
+  f = e;                                                                           \
+  e = wwu_add( d, T1 );                                                            \
+  d = c;                                                                           \
+  c = b;                                                                           \
+  b = a;                                                                           \
+  a = wwu_add( T1, T2 )
+
+  for( ulong iter=0UL; iter<cnt; iter++ ) {
+    wwu_t w0 = x0;   wwu_t w1 = x1;   wwu_t w2 = x2;   wwu_t w3 = x3;
+    wwu_t w4 = x4;   wwu_t w5 = x5;   wwu_t w6 = x6;   wwu_t w7 = x7;
+    wwu_t w8 = x8_0; wwu_t w9 = zero; wwu_t wa = zero; wwu_t wb = zero;
+    wwu_t wc = zero; wwu_t wd = zero; wwu_t we = zero; wwu_t wf = xf_0;
+
+    wwu_t a = s0; wwu_t b = s1; wwu_t c = s2; wwu_t d = s3; wwu_t e = s4; wwu_t f = s5; wwu_t g = s6; wwu_t h = s7;
+
+    wwu_t T1;
+    wwu_t T2;
+
+    SHA_CORE( w0, wwu_bcast( fd_sha256_K[ 0] ) );
+    SHA_CORE( w1, wwu_bcast( fd_sha256_K[ 1] ) );
+    SHA_CORE( w2, wwu_bcast( fd_sha256_K[ 2] ) );
+    SHA_CORE( w3, wwu_bcast( fd_sha256_K[ 3] ) );
+    SHA_CORE( w4, wwu_bcast( fd_sha256_K[ 4] ) );
+    SHA_CORE( w5, wwu_bcast( fd_sha256_K[ 5] ) );
+    SHA_CORE( w6, wwu_bcast( fd_sha256_K[ 6] ) );
+    SHA_CORE( w7, wwu_bcast( fd_sha256_K[ 7] ) );
+    SHA_CORE( w8, wwu_bcast( fd_sha256_K[ 8] ) );
+    SHA_CORE( w9, wwu_bcast( fd_sha256_K[ 9] ) );
+    SHA_CORE( wa, wwu_bcast( fd_sha256_K[10] ) );
+    SHA_CORE( wb, wwu_bcast( fd_sha256_K[11] ) );
+    SHA_CORE( wc, wwu_bcast( fd_sha256_K[12] ) );
+    SHA_CORE( wd, wwu_bcast( fd_sha256_K[13] ) );
+    SHA_CORE( we, wwu_bcast( fd_sha256_K[14] ) );
+    SHA_CORE( wf, wwu_bcast( fd_sha256_K[15] ) );
+    for( ulong i=16UL; i<64UL; i+=16UL ) {
+      w0 = wwu_add( wwu_add( w0, sigma0(w1) ), wwu_add( sigma1(we), w9 ) ); SHA_CORE( w0, wwu_bcast( fd_sha256_K[i     ] ) );
+      w1 = wwu_add( wwu_add( w1, sigma0(w2) ), wwu_add( sigma1(wf), wa ) ); SHA_CORE( w1, wwu_bcast( fd_sha256_K[i+ 1UL] ) );
+      w2 = wwu_add( wwu_add( w2, sigma0(w3) ), wwu_add( sigma1(w0), wb ) ); SHA_CORE( w2, wwu_bcast( fd_sha256_K[i+ 2UL] ) );
+      w3 = wwu_add( wwu_add( w3, sigma0(w4) ), wwu_add( sigma1(w1), wc ) ); SHA_CORE( w3, wwu_bcast( fd_sha256_K[i+ 3UL] ) );
+      w4 = wwu_add( wwu_add( w4, sigma0(w5) ), wwu_add( sigma1(w2), wd ) ); SHA_CORE( w4, wwu_bcast( fd_sha256_K[i+ 4UL] ) );
+      w5 = wwu_add( wwu_add( w5, sigma0(w6) ), wwu_add( sigma1(w3), we ) ); SHA_CORE( w5, wwu_bcast( fd_sha256_K[i+ 5UL] ) );
+      w6 = wwu_add( wwu_add( w6, sigma0(w7) ), wwu_add( sigma1(w4), wf ) ); SHA_CORE( w6, wwu_bcast( fd_sha256_K[i+ 6UL] ) );
+      w7 = wwu_add( wwu_add( w7, sigma0(w8) ), wwu_add( sigma1(w5), w0 ) ); SHA_CORE( w7, wwu_bcast( fd_sha256_K[i+ 7UL] ) );
+      w8 = wwu_add( wwu_add( w8, sigma0(w9) ), wwu_add( sigma1(w6), w1 ) ); SHA_CORE( w8, wwu_bcast( fd_sha256_K[i+ 8UL] ) );
+      w9 = wwu_add( wwu_add( w9, sigma0(wa) ), wwu_add( sigma1(w7), w2 ) ); SHA_CORE( w9, wwu_bcast( fd_sha256_K[i+ 9UL] ) );
+      wa = wwu_add( wwu_add( wa, sigma0(wb) ), wwu_add( sigma1(w8), w3 ) ); SHA_CORE( wa, wwu_bcast( fd_sha256_K[i+10UL] ) );
+      wb = wwu_add( wwu_add( wb, sigma0(wc) ), wwu_add( sigma1(w9), w4 ) ); SHA_CORE( wb, wwu_bcast( fd_sha256_K[i+11UL] ) );
+      wc = wwu_add( wwu_add( wc, sigma0(wd) ), wwu_add( sigma1(wa), w5 ) ); SHA_CORE( wc, wwu_bcast( fd_sha256_K[i+12UL] ) );
+      wd = wwu_add( wwu_add( wd, sigma0(we) ), wwu_add( sigma1(wb), w6 ) ); SHA_CORE( wd, wwu_bcast( fd_sha256_K[i+13UL] ) );
+      we = wwu_add( wwu_add( we, sigma0(wf) ), wwu_add( sigma1(wc), w7 ) ); SHA_CORE( we, wwu_bcast( fd_sha256_K[i+14UL] ) );
+      wf = wwu_add( wwu_add( wf, sigma0(w0) ), wwu_add( sigma1(wd), w8 ) ); SHA_CORE( wf, wwu_bcast( fd_sha256_K[i+15UL] ) );
+    }
+
+    x0 = wwu_add( s0, a );
+    x1 = wwu_add( s1, b );
+    x2 = wwu_add( s2, c );
+    x3 = wwu_add( s3, d );
+    x4 = wwu_add( s4, e );
+    x5 = wwu_add( s5, f );
+    x6 = wwu_add( s6, g );
+    x7 = wwu_add( s7, h );
+  }
+
+# undef SHA_CORE
+# undef Sigma0
+# undef Sigma1
+# undef sigma0
+# undef sigma1
+# undef Ch
+# undef Maj
+
+  /* Store the results */
+
+  wwu_transpose_2x8x8( wwu_bswap(x0), wwu_bswap(x1), wwu_bswap(x2), wwu_bswap(x3),
+                       wwu_bswap(x4), wwu_bswap(x5), wwu_bswap(x6), wwu_bswap(x7), x0,x1,x2,x3,x4,x5,x6,x7 );
+
+  wu_stu( batch_hash[ 0], _mm512_extracti32x8_epi32( x0, 0 ) ); wu_stu( batch_hash[ 8], _mm512_extracti32x8_epi32( x0, 1 ) );
+  wu_stu( batch_hash[ 1], _mm512_extracti32x8_epi32( x1, 0 ) ); wu_stu( batch_hash[ 9], _mm512_extracti32x8_epi32( x1, 1 ) );
+  wu_stu( batch_hash[ 2], _mm512_extracti32x8_epi32( x2, 0 ) ); wu_stu( batch_hash[10], _mm512_extracti32x8_epi32( x2, 1 ) );
+  wu_stu( batch_hash[ 3], _mm512_extracti32x8_epi32( x3, 0 ) ); wu_stu( batch_hash[11], _mm512_extracti32x8_epi32( x3, 1 ) );
+  wu_stu( batch_hash[ 4], _mm512_extracti32x8_epi32( x4, 0 ) ); wu_stu( batch_hash[12], _mm512_extracti32x8_epi32( x4, 1 ) );
+  wu_stu( batch_hash[ 5], _mm512_extracti32x8_epi32( x5, 0 ) ); wu_stu( batch_hash[13], _mm512_extracti32x8_epi32( x5, 1 ) );
+  wu_stu( batch_hash[ 6], _mm512_extracti32x8_epi32( x6, 0 ) ); wu_stu( batch_hash[14], _mm512_extracti32x8_epi32( x6, 1 ) );
+  wu_stu( batch_hash[ 7], _mm512_extracti32x8_epi32( x7, 0 ) ); wu_stu( batch_hash[15], _mm512_extracti32x8_epi32( x7, 1 ) );
+}
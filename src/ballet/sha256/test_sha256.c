@@ -146,6 +146,62 @@ main( int     argc,
     for( ulong b=0UL; b<32UL; b++ ) FD_TEST( in_hash[b]==hash[b] );
   }
 
+  /* test fd_sha256_hash_32_repeated_batch */
+# define CHAIN_MAX (64UL)
+  do {
+    uchar data_mem[ CHAIN_MAX ][ 32 ];
+    uchar hash_mem[ CHAIN_MAX ][ 32 ];
+    uchar ref_mem [ CHAIN_MAX ][ 32 ];
+    void const * data[ CHAIN_MAX ];
+    void *       hash[ CHAIN_MAX ];
+    ulong        cnt [ CHAIN_MAX ];
+    for( ulong trial=0UL; trial<256UL; trial++ ) {
+      ulong chain_cnt = fd_rng_ulong_roll( rng, CHAIN_MAX+1UL );
+      int   in_place  = fd_rng_int_roll( rng, 2 );
+      for( ulong chain_idx=0UL; chain_idx<chain_cnt; chain_idx++ ) {
+        for( ulong b=0UL; b<32UL; b++ ) data_mem[ chain_idx ][ b ] = fd_rng_uchar( rng );
+        data[ chain_idx ] = data_mem[ chain_idx ];
+        hash[ chain_idx ] = in_place ? data_mem[ chain_idx ] : hash_mem[ chain_idx ];
+        cnt [ chain_idx ] = fd_rng_uint_roll( rng, 4U )==0U ? 0UL : fd_rng_ulong_roll( rng, 1UL<<fd_rng_uint_roll( rng, 11U ) );
+        fd_sha256_hash_32_repeated( data[ chain_idx ], ref_mem[ chain_idx ], cnt[ chain_idx ] );
+      }
+      fd_sha256_hash_32_repeated_batch( chain_cnt, data, hash, cnt );
+      for( ulong chain_idx=0UL; chain_idx<chain_cnt; chain_idx++ ) FD_TEST( !memcmp( hash[ chain_idx ], ref_mem[ chain_idx ], 32UL ) );
+    }
+
+#   if FD_HAS_AVX
+    /* The AVX kernel is built (but not declared) when AVX-512 is
+       available, so test it directly too */
+    void fd_sha256_private_batch_32_repeated_avx( void * const * batch_hash, ulong cnt );
+    uchar lane_mem[ 8 ][ 32 ];
+    void * lane[ 8 ];
+    for( ulong l=0UL; l<8UL; l++ ) {
+      for( ulong b=0UL; b<32UL; b++ ) lane_mem[ l ][ b ] = fd_rng_uchar( rng );
+      lane[ l ] = lane_mem[ l ];
+      fd_sha256_hash_32_repeated( lane_mem[ l ], ref_mem[ l ], 1000UL );
+    }
+    fd_sha256_private_batch_32_repeated_avx( lane, 1000UL );
+    for( ulong l=0UL; l<8UL; l++ ) FD_TEST( !memcmp( lane_mem[ l ], ref_mem[ l ], 32UL ) );
+#   endif
+
+    /* Benchmark a FEC set worth of PoH entries */
+    for( ulong chain_idx=0UL; chain_idx<CHAIN_MAX; chain_idx++ ) {
+      data[ chain_idx ] = data_mem[ chain_idx ];
+      hash[ chain_idx ] = hash_mem[ chain_idx ];
+      cnt [ chain_idx ] = 12500UL;
+    }
+    fd_sha256_hash_32_repeated_batch( CHAIN_MAX, data, hash, cnt ); /* warmup */
+    long dt = -fd_log_wallclock();
+    for( ulong chain_idx=0UL; chain_idx<CHAIN_MAX; chain_idx++ ) fd_sha256_hash_32_repeated( data[ chain_idx ], hash[ chain_idx ], cnt[ chain_idx ] );
+    dt += fd_log_wallclock();
+    FD_LOG_NOTICE(( "~%6.3f M poh hashes / sec / core (%lu chains, sequential)", (double)((float)(CHAIN_MAX*12500UL)*1e3f/(float)dt), CHAIN_MAX ));
+    dt = -fd_log_wallclock();
+    fd_sha256_hash_32_repeated_batch( CHAIN_MAX, data, hash, cnt );
+    dt += fd_log_wallclock();
+    FD_LOG_NOTICE(( "~%6.3f M poh hashes / sec / core (%lu chains, batched)", (double)((float)(CHAIN_MAX*12500UL)*1e3f/(float)dt), CHAIN_MAX ));
+  } while(0);
+# undef CHAIN_MAX
+
   /* do a benchmark on PoH-style hashing */
   FD_LOG_NOTICE(( "Benchmarking poh" ));
   for( ulong b=0UL; b<32UL; b++ ) in_hash[b] = fd_rng_uchar( rng );
@@ -88,6 +88,16 @@ fd_disco_netmux_sig( uint   hash_ip_addr,
 }
 
 FD_FN_CONST static inline ulong fd_disco_netmux_sig_hash ( ulong sig ) { return (sig>>44UL); }
+
+/* fd_disco_netmux_sig_set_hash returns sig with the 20 bit flow hash
+   replaced by the low 20 bits of hash.  Used by net tiles to override
+   the default source address hash with an application-level steering
+   hint (see fd_net_rx_steer_sig). */
+FD_FN_CONST static inline ulong
+fd_disco_netmux_sig_set_hash( ulong sig,
+                              ulong hash ) {
+  return ( sig & ((1UL<<44UL)-1UL) ) | ( (hash&0xfffffUL)<<44UL );
+}
 FD_FN_CONST static inline ulong fd_disco_netmux_sig_proto( ulong sig ) { return (sig>>32UL) & 0xFFUL; }
 FD_FN_CONST static inline uint  fd_disco_netmux_sig_ip   ( ulong sig ) { return (uint)(sig & 0xFFFFFFFFUL); }
 
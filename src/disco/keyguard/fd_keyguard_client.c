@@ -32,12 +32,12 @@ fd_keyguard_client_new( void *           shmem,
 }
 
 void
-fd_keyguard_client_sign( fd_keyguard_client_t * client,
-                         uchar *                signature,
-                         uchar const *          sign_data,
-                         ulong                  sign_data_len,
-                         int                    sign_type ) {
+fd_keyguard_client_sign_request( fd_keyguard_client_t * client,
+                                 uchar const *          sign_data,
+                                 ulong                  sign_data_len,
+                                 int                    sign_type ) {
   FD_TEST( sign_data_len<=client->request_mtu );
+  FD_TEST( fd_keyguard_client_pending_cnt( client )<fd_keyguard_client_pending_max( client ) );
 
   uchar * dst = fd_chunk_to_laddr( client->request_mem, client->request_chunk );
   fd_memcpy( dst, sign_data, sign_data_len );
@@ -46,6 +46,12 @@ fd_keyguard_client_sign( fd_keyguard_client_t * client,
   fd_mcache_publish( client->request, client->request_depth, client->request_seq, sig, client->request_chunk, sign_data_len, 0UL, 0UL, 0UL );
   client->request_seq   = fd_seq_inc( client->request_seq, 1UL );
   client->request_chunk = fd_dcache_compact_next( client->request_chunk, sign_data_len, client->request_chunk0, client->request_wmark );
+}
+
+void
+fd_keyguard_client_sign_response( fd_keyguard_client_t * client,
+                                  uchar *                signature ) {
+  FD_TEST( fd_keyguard_client_pending_cnt( client ) );
 
   fd_frag_meta_t meta;
   fd_frag_meta_t const * mline;
@@ -68,3 +74,13 @@ fd_keyguard_client_sign( fd_keyguard_client_t * client,
   if( FD_UNLIKELY( fd_seq_ne( seq_found, client->response_seq ) ) ) FD_LOG_ERR(( "sign request was overrun while reading" ));
   client->response_seq = fd_seq_inc( client->response_seq, 1UL );
 }
+
+void
+fd_keyguard_client_sign( fd_keyguard_client_t * client,
+                         uchar *                signature,
+                         uchar const *          sign_data,
+                         ulong                  sign_data_len,
+                         int                    sign_type ) {
+  fd_keyguard_client_sign_request ( client, sign_data, sign_data_len, sign_type );
+  fd_keyguard_client_sign_response( client, signature );
+}
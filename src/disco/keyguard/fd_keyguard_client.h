@@ -94,6 +94,45 @@ fd_keyguard_client_sign( fd_keyguard_client_t * client,
                          ulong                  sign_data_len,
                          int                    sign_type );
 
+/* fd_keyguard_client_sign_request and fd_keyguard_client_sign_response
+   split fd_keyguard_client_sign in two, so that a caller can have
+   multiple signing requests in flight.  This lets the signing server
+   batch them, and hides the round trip latency to the server.
+
+   fd_keyguard_client_sign_request sends a signing request (same
+   arguments as fd_keyguard_client_sign) without waiting for the
+   response.  The caller must not have more than
+   fd_keyguard_client_pending_max requests in flight.
+
+   fd_keyguard_client_sign_response blocks (spins) until the response
+   to the oldest in flight request is received, and writes it into
+   signature.  Responses are received in request order. */
+
+void
+fd_keyguard_client_sign_request( fd_keyguard_client_t * client,
+                                 uchar const *          sign_data,
+                                 ulong                  sign_data_len,
+                                 int                    sign_type );
+
+void
+fd_keyguard_client_sign_response( fd_keyguard_client_t * client,
+                                  uchar *                signature );
+
+/* fd_keyguard_client_pending_cnt returns the number of requests in
+   flight.  fd_keyguard_client_pending_max returns the max number of
+   requests that can be in flight without the response link being
+   overrun. */
+
+FD_FN_PURE static inline ulong
+fd_keyguard_client_pending_cnt( fd_keyguard_client_t const * client ) {
+  return client->request_seq - client->response_seq;
+}
+
+FD_FN_PURE static inline ulong
+fd_keyguard_client_pending_max( fd_keyguard_client_t const * client ) {
+  return fd_ulong_min( client->request_depth, client->response_depth );
+}
+
 FD_PROTOTYPES_END
 
 #endif /* HEADER_fd_src_disco_keyguard_fd_keyguard_client_h */
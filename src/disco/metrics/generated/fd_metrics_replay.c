@@ -17,4 +17,5 @@ const fd_metrics_meta_t FD_METRICS_REPLAY[FD_METRICS_REPLAY_TOTAL] = {
     DECLARE_METRIC( REPLAY_LIVE_BANKS, GAUGE ),
     DECLARE_METRIC( REPLAY_SLOTS_TOTAL, COUNTER ),
     DECLARE_METRIC( REPLAY_TRANSACTIONS_TOTAL, COUNTER ),
+    DECLARE_METRIC( REPLAY_DUPLICATE_FEC_SETS, COUNTER ),
 };
@@ -108,7 +108,13 @@
 #define FD_METRICS_COUNTER_REPLAY_TRANSACTIONS_TOTAL_DESC "Count of transactions processed overall on the current fork"
 #define FD_METRICS_COUNTER_REPLAY_TRANSACTIONS_TOTAL_CVT  (FD_METRICS_CONVERTER_NONE)
 
-#define FD_METRICS_REPLAY_TOTAL (15UL)
+#define FD_METRICS_COUNTER_REPLAY_DUPLICATE_FEC_SETS_OFF  (127UL)
+#define FD_METRICS_COUNTER_REPLAY_DUPLICATE_FEC_SETS_NAME "replay_duplicate_fec_sets"
+#define FD_METRICS_COUNTER_REPLAY_DUPLICATE_FEC_SETS_TYPE (FD_METRICS_TYPE_COUNTER)
+#define FD_METRICS_COUNTER_REPLAY_DUPLICATE_FEC_SETS_DESC "Count of FEC sets ignored because they were already received (e.g. read back from the ledger on restart and also received from the network)"
+#define FD_METRICS_COUNTER_REPLAY_DUPLICATE_FEC_SETS_CVT  (FD_METRICS_CONVERTER_NONE)
+
+#define FD_METRICS_REPLAY_TOTAL (16UL)
 extern const fd_metrics_meta_t FD_METRICS_REPLAY[FD_METRICS_REPLAY_TOTAL];
 
 #endif /* HEADER_fd_src_disco_metrics_generated_fd_metrics_replay_h */
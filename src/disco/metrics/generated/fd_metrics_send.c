@@ -98,6 +98,13 @@ const fd_metrics_meta_t FD_METRICS_SEND[FD_METRICS_SEND_TOTAL] = {
     DECLARE_METRIC_ENUM( SEND_PKT_RETRANSMISSIONS, COUNTER, QUIC_ENC_LEVEL, EARLY ),
     DECLARE_METRIC_ENUM( SEND_PKT_RETRANSMISSIONS, COUNTER, QUIC_ENC_LEVEL, HANDSHAKE ),
     DECLARE_METRIC_ENUM( SEND_PKT_RETRANSMISSIONS, COUNTER, QUIC_ENC_LEVEL, APP ),
+    DECLARE_METRIC( SEND_CONGESTION_WINDOW_BYTES, GAUGE ),
+    DECLARE_METRIC( SEND_BYTES_IN_FLIGHT, GAUGE ),
+    DECLARE_METRIC( SEND_PKT_LOST, COUNTER ),
+    DECLARE_METRIC( SEND_BYTES_LOST, COUNTER ),
+    DECLARE_METRIC( SEND_CONGESTION_EVENTS, COUNTER ),
+    DECLARE_METRIC( SEND_CWND_LIMITED, COUNTER ),
+    DECLARE_METRIC( SEND_PACING_LIMITED, COUNTER ),
     DECLARE_METRIC( SEND_HANDSHAKES_CREATED, COUNTER ),
     DECLARE_METRIC( SEND_HANDSHAKE_ERROR_ALLOC_FAIL, COUNTER ),
     DECLARE_METRIC( SEND_HANDSHAKE_EVICTED, COUNTER ),
@@ -358,97 +358,139 @@
 #define FD_METRICS_COUNTER_SEND_PKT_RETRANSMISSIONS_HANDSHAKE_OFF (110UL)
 #define FD_METRICS_COUNTER_SEND_PKT_RETRANSMISSIONS_APP_OFF (111UL)
 
-#define FD_METRICS_COUNTER_SEND_HANDSHAKES_CREATED_OFF  (112UL)
+#define FD_METRICS_GAUGE_SEND_CONGESTION_WINDOW_BYTES_OFF  (112UL)
+#define FD_METRICS_GAUGE_SEND_CONGESTION_WINDOW_BYTES_NAME "send_congestion_window_bytes"
+#define FD_METRICS_GAUGE_SEND_CONGESTION_WINDOW_BYTES_TYPE (FD_METRICS_TYPE_GAUGE)
+#define FD_METRICS_GAUGE_SEND_CONGESTION_WINDOW_BYTES_DESC "Sum of QUIC congestion windows across connections, in bytes"
+#define FD_METRICS_GAUGE_SEND_CONGESTION_WINDOW_BYTES_CVT  (FD_METRICS_CONVERTER_NONE)
+
+#define FD_METRICS_GAUGE_SEND_BYTES_IN_FLIGHT_OFF  (113UL)
+#define FD_METRICS_GAUGE_SEND_BYTES_IN_FLIGHT_NAME "send_bytes_in_flight"
+#define FD_METRICS_GAUGE_SEND_BYTES_IN_FLIGHT_TYPE (FD_METRICS_TYPE_GAUGE)
+#define FD_METRICS_GAUGE_SEND_BYTES_IN_FLIGHT_DESC "Sum of unacknowledged QUIC bytes in flight across connections"
+#define FD_METRICS_GAUGE_SEND_BYTES_IN_FLIGHT_CVT  (FD_METRICS_CONVERTER_NONE)
+
+#define FD_METRICS_COUNTER_SEND_PKT_LOST_OFF  (114UL)
+#define FD_METRICS_COUNTER_SEND_PKT_LOST_NAME "send_pkt_lost"
+#define FD_METRICS_COUNTER_SEND_PKT_LOST_TYPE (FD_METRICS_TYPE_COUNTER)
+#define FD_METRICS_COUNTER_SEND_PKT_LOST_DESC "Total count of congestion controlled QUIC packets declared lost"
+#define FD_METRICS_COUNTER_SEND_PKT_LOST_CVT  (FD_METRICS_CONVERTER_NONE)
+
+#define FD_METRICS_COUNTER_SEND_BYTES_LOST_OFF  (115UL)
+#define FD_METRICS_COUNTER_SEND_BYTES_LOST_NAME "send_bytes_lost"
+#define FD_METRICS_COUNTER_SEND_BYTES_LOST_TYPE (FD_METRICS_TYPE_COUNTER)
+#define FD_METRICS_COUNTER_SEND_BYTES_LOST_DESC "Total bytes in congestion controlled QUIC packets declared lost"
+#define FD_METRICS_COUNTER_SEND_BYTES_LOST_CVT  (FD_METRICS_CONVERTER_NONE)
+
+#define FD_METRICS_COUNTER_SEND_CONGESTION_EVENTS_OFF  (116UL)
+#define FD_METRICS_COUNTER_SEND_CONGESTION_EVENTS_NAME "send_congestion_events"
+#define FD_METRICS_COUNTER_SEND_CONGESTION_EVENTS_TYPE (FD_METRICS_TYPE_COUNTER)
+#define FD_METRICS_COUNTER_SEND_CONGESTION_EVENTS_DESC "Total count of QUIC congestion window reductions"
+#define FD_METRICS_COUNTER_SEND_CONGESTION_EVENTS_CVT  (FD_METRICS_CONVERTER_NONE)
+
+#define FD_METRICS_COUNTER_SEND_CWND_LIMITED_OFF  (117UL)
+#define FD_METRICS_COUNTER_SEND_CWND_LIMITED_NAME "send_cwnd_limited"
+#define FD_METRICS_COUNTER_SEND_CWND_LIMITED_TYPE (FD_METRICS_TYPE_COUNTER)
+#define FD_METRICS_COUNTER_SEND_CWND_LIMITED_DESC "Total count of times QUIC stream data was held back by the congestion window"
+#define FD_METRICS_COUNTER_SEND_CWND_LIMITED_CVT  (FD_METRICS_CONVERTER_NONE)
+
+#define FD_METRICS_COUNTER_SEND_PACING_LIMITED_OFF  (118UL)
+#define FD_METRICS_COUNTER_SEND_PACING_LIMITED_NAME "send_pacing_limited"
+#define FD_METRICS_COUNTER_SEND_PACING_LIMITED_TYPE (FD_METRICS_TYPE_COUNTER)
+#define FD_METRICS_COUNTER_SEND_PACING_LIMITED_DESC "Total count of times QUIC stream data was held back by the pacer"
+#define FD_METRICS_COUNTER_SEND_PACING_LIMITED_CVT  (FD_METRICS_CONVERTER_NONE)
+
+#define FD_METRICS_COUNTER_SEND_HANDSHAKES_CREATED_OFF  (119UL)
 #define FD_METRICS_COUNTER_SEND_HANDSHAKES_CREATED_NAME "send_handshakes_created"
 #define FD_METRICS_COUNTER_SEND_HANDSHAKES_CREATED_TYPE (FD_METRICS_TYPE_COUNTER)
 #define FD_METRICS_COUNTER_SEND_HANDSHAKES_CREATED_DESC "Total count of QUIC handshakes created"
 #define FD_METRICS_COUNTER_SEND_HANDSHAKES_CREATED_CVT  (FD_METRICS_CONVERTER_NONE)
 
-#define FD_METRICS_COUNTER_SEND_HANDSHAKE_ERROR_ALLOC_FAIL_OFF  (113UL)
+#define FD_METRICS_COUNTER_SEND_HANDSHAKE_ERROR_ALLOC_FAIL_OFF  (120UL)
 #define FD_METRICS_COUNTER_SEND_HANDSHAKE_ERROR_ALLOC_FAIL_NAME "send_handshake_error_alloc_fail"
 #define FD_METRICS_COUNTER_SEND_HANDSHAKE_ERROR_ALLOC_FAIL_TYPE (FD_METRICS_TYPE_COUNTER)
 #define FD_METRICS_COUNTER_SEND_HANDSHAKE_ERROR_ALLOC_FAIL_DESC "Total count of handshake allocation failures"
 #define FD_METRICS_COUNTER_SEND_HANDSHAKE_ERROR_ALLOC_FAIL_CVT  (FD_METRICS_CONVERTER_NONE)
 
-#define FD_METRICS_COUNTER_SEND_HANDSHAKE_EVICTED_OFF  (114UL)
+#define FD_METRICS_COUNTER_SEND_HANDSHAKE_EVICTED_OFF  (121UL)
 #define FD_METRICS_COUNTER_SEND_HANDSHAKE_EVICTED_NAME "send_handshake_evicted"
 #define FD_METRICS_COUNTER_SEND_HANDSHAKE_EVICTED_TYPE (FD_METRICS_TYPE_COUNTER)
 #define FD_METRICS_COUNTER_SEND_HANDSHAKE_EVICTED_DESC "Total count of handshakes evicted"
 #define FD_METRICS_COUNTER_SEND_HANDSHAKE_EVICTED_CVT  (FD_METRICS_CONVERTER_NONE)
 
-#define FD_METRICS_COUNTER_SEND_STREAM_RECEIVED_EVENTS_OFF  (115UL)
+#define FD_METRICS_COUNTER_SEND_STREAM_RECEIVED_EVENTS_OFF  (122UL)
 #define FD_METRICS_COUNTER_SEND_STREAM_RECEIVED_EVENTS_NAME "send_stream_received_events"
 #define FD_METRICS_COUNTER_SEND_STREAM_RECEIVED_EVENTS_TYPE (FD_METRICS_TYPE_COUNTER)
 #define FD_METRICS_COUNTER_SEND_STREAM_RECEIVED_EVENTS_DESC "Total count of stream events received"
 #define FD_METRICS_COUNTER_SEND_STREAM_RECEIVED_EVENTS_CVT  (FD_METRICS_CONVERTER_NONE)
 
-#define FD_METRICS_COUNTER_SEND_STREAM_RECEIVED_BYTES_OFF  (116UL)
+#define FD_METRICS_COUNTER_SEND_STREAM_RECEIVED_BYTES_OFF  (123UL)
 #define FD_METRICS_COUNTER_SEND_STREAM_RECEIVED_BYTES_NAME "send_stream_received_bytes"
 #define FD_METRICS_COUNTER_SEND_STREAM_RECEIVED_BYTES_TYPE (FD_METRICS_TYPE_COUNTER)
 #define FD_METRICS_COUNTER_SEND_STREAM_RECEIVED_BYTES_DESC "Total bytes received via streams"
 #define FD_METRICS_COUNTER_SEND_STREAM_RECEIVED_BYTES_CVT  (FD_METRICS_CONVERTER_NONE)
 
-#define FD_METRICS_COUNTER_SEND_RECEIVED_FRAMES_OFF  (117UL)
+#define FD_METRICS_COUNTER_SEND_RECEIVED_FRAMES_OFF  (124UL)
 #define FD_METRICS_COUNTER_SEND_RECEIVED_FRAMES_NAME "send_received_frames"
 #define FD_METRICS_COUNTER_SEND_RECEIVED_FRAMES_TYPE (FD_METRICS_TYPE_COUNTER)
 #define FD_METRICS_COUNTER_SEND_RECEIVED_FRAMES_DESC "Total count of QUIC frames received"
 #define FD_METRICS_COUNTER_SEND_RECEIVED_FRAMES_CVT  (FD_METRICS_CONVERTER_NONE)
 #define FD_METRICS_COUNTER_SEND_RECEIVED_FRAMES_CNT  (22UL)
 
-#define FD_METRICS_COUNTER_SEND_RECEIVED_FRAMES_UNKNOWN_OFF (117UL)
-#define FD_METRICS_COUNTER_SEND_RECEIVED_FRAMES_ACK_OFF (118UL)
-#define FD_METRICS_COUNTER_SEND_RECEIVED_FRAMES_RESET_STREAM_OFF (119UL)
-#define FD_METRICS_COUNTER_SEND_RECEIVED_FRAMES_STOP_SENDING_OFF (120UL)
-#define FD_METRICS_COUNTER_SEND_RECEIVED_FRAMES_CRYPTO_OFF (121UL)
-#define FD_METRICS_COUNTER_SEND_RECEIVED_FRAMES_NEW_TOKEN_OFF (122UL)
-#define FD_METRICS_COUNTER_SEND_RECEIVED_FRAMES_STREAM_OFF (123UL)
-#define FD_METRICS_COUNTER_SEND_RECEIVED_FRAMES_MAX_DATA_OFF (124UL)
-#define FD_METRICS_COUNTER_SEND_RECEIVED_FRAMES_MAX_STREAM_DATA_OFF (125UL)
-#define FD_METRICS_COUNTER_SEND_RECEIVED_FRAMES_MAX_STREAMS_OFF (126UL)
-#define FD_METRICS_COUNTER_SEND_RECEIVED_FRAMES_DATA_BLOCKED_OFF (127UL)
-#define FD_METRICS_COUNTER_SEND_RECEIVED_FRAMES_STREAM_DATA_BLOCKED_OFF (128UL)
-#define FD_METRICS_COUNTER_SEND_RECEIVED_FRAMES_STREAMS_BLOCKED_OFF (129UL)
-#define FD_METRICS_COUNTER_SEND_RECEIVED_FRAMES_NEW_CONN_ID_OFF (130UL)
-#define FD_METRICS_COUNTER_SEND_RECEIVED_FRAMES_RETIRE_CONN_ID_OFF (131UL)
-#define FD_METRICS_COUNTER_SEND_RECEIVED_FRAMES_PATH_CHALLENGE_OFF (132UL)
-#define FD_METRICS_COUNTER_SEND_RECEIVED_FRAMES_PATH_RESPONSE_OFF (133UL)
-#define FD_METRICS_COUNTER_SEND_RECEIVED_FRAMES_CONN_CLOSE_QUIC_OFF (134UL)
-#define FD_METRICS_COUNTER_SEND_RECEIVED_FRAMES_CONN_CLOSE_APP_OFF (135UL)
-#define FD_METRICS_COUNTER_SEND_RECEIVED_FRAMES_HANDSHAKE_DONE_OFF (136UL)
-#define FD_METRICS_COUNTER_SEND_RECEIVED_FRAMES_PING_OFF (137UL)
-#define FD_METRICS_COUNTER_SEND_RECEIVED_FRAMES_PADDING_OFF (138UL)
-
-#define FD_METRICS_COUNTER_SEND_FRAME_FAIL_PARSE_OFF  (139UL)
+#define FD_METRICS_COUNTER_SEND_RECEIVED_FRAMES_UNKNOWN_OFF (124UL)
+#define FD_METRICS_COUNTER_SEND_RECEIVED_FRAMES_ACK_OFF (125UL)
+#define FD_METRICS_COUNTER_SEND_RECEIVED_FRAMES_RESET_STREAM_OFF (126UL)
+#define FD_METRICS_COUNTER_SEND_RECEIVED_FRAMES_STOP_SENDING_OFF (127UL)
+#define FD_METRICS_COUNTER_SEND_RECEIVED_FRAMES_CRYPTO_OFF (128UL)
+#define FD_METRICS_COUNTER_SEND_RECEIVED_FRAMES_NEW_TOKEN_OFF (129UL)
+#define FD_METRICS_COUNTER_SEND_RECEIVED_FRAMES_STREAM_OFF (130UL)
+#define FD_METRICS_COUNTER_SEND_RECEIVED_FRAMES_MAX_DATA_OFF (131UL)
+#define FD_METRICS_COUNTER_SEND_RECEIVED_FRAMES_MAX_STREAM_DATA_OFF (132UL)
+#define FD_METRICS_COUNTER_SEND_RECEIVED_FRAMES_MAX_STREAMS_OFF (133UL)
+#define FD_METRICS_COUNTER_SEND_RECEIVED_FRAMES_DATA_BLOCKED_OFF (134UL)
+#define FD_METRICS_COUNTER_SEND_RECEIVED_FRAMES_STREAM_DATA_BLOCKED_OFF (135UL)
+#define FD_METRICS_COUNTER_SEND_RECEIVED_FRAMES_STREAMS_BLOCKED_OFF (136UL)
+#define FD_METRICS_COUNTER_SEND_RECEIVED_FRAMES_NEW_CONN_ID_OFF (137UL)
+#define FD_METRICS_COUNTER_SEND_RECEIVED_FRAMES_RETIRE_CONN_ID_OFF (138UL)
+#define FD_METRICS_COUNTER_SEND_RECEIVED_FRAMES_PATH_CHALLENGE_OFF (139UL)
+#define FD_METRICS_COUNTER_SEND_RECEIVED_FRAMES_PATH_RESPONSE_OFF (140UL)
+#define FD_METRICS_COUNTER_SEND_RECEIVED_FRAMES_CONN_CLOSE_QUIC_OFF (141UL)
+#define FD_METRICS_COUNTER_SEND_RECEIVED_FRAMES_CONN_CLOSE_APP_OFF (142UL)
+#define FD_METRICS_COUNTER_SEND_RECEIVED_FRAMES_HANDSHAKE_DONE_OFF (143UL)
+#define FD_METRICS_COUNTER_SEND_RECEIVED_FRAMES_PING_OFF (144UL)
+#define FD_METRICS_COUNTER_SEND_RECEIVED_FRAMES_PADDING_OFF (145UL)
+
+#define FD_METRICS_COUNTER_SEND_FRAME_FAIL_PARSE_OFF  (146UL)
 #define FD_METRICS_COUNTER_SEND_FRAME_FAIL_PARSE_NAME "send_frame_fail_parse"
 #define FD_METRICS_COUNTER_SEND_FRAME_FAIL_PARSE_TYPE (FD_METRICS_TYPE_COUNTER)
 #define FD_METRICS_COUNTER_SEND_FRAME_FAIL_PARSE_DESC "Total count of frame parse failures"
 #define FD_METRICS_COUNTER_SEND_FRAME_FAIL_PARSE_CVT  (FD_METRICS_CONVERTER_NONE)
 
-#define FD_METRICS_COUNTER_SEND_FRAME_TX_ALLOC_OFF  (140UL)
+#define FD_METRICS_COUNTER_SEND_FRAME_TX_ALLOC_OFF  (147UL)
 #define FD_METRICS_COUNTER_SEND_FRAME_TX_ALLOC_NAME "send_frame_tx_alloc"
 #define FD_METRICS_COUNTER_SEND_FRAME_TX_ALLOC_TYPE (FD_METRICS_TYPE_COUNTER)
 #define FD_METRICS_COUNTER_SEND_FRAME_TX_ALLOC_DESC "Results of attempts to acquire QUIC frame metadata."
 #define FD_METRICS_COUNTER_SEND_FRAME_TX_ALLOC_CVT  (FD_METRICS_CONVERTER_NONE)
 #define FD_METRICS_COUNTER_SEND_FRAME_TX_ALLOC_CNT  (3UL)
 
-#define FD_METRICS_COUNTER_SEND_FRAME_TX_ALLOC_SUCCESS_OFF (140UL)
-#define FD_METRICS_COUNTER_SEND_FRAME_TX_ALLOC_FAIL_EMPTY_POOL_OFF (141UL)
-#define FD_METRICS_COUNTER_SEND_FRAME_TX_ALLOC_FAIL_CONN_MAX_OFF (142UL)
+#define FD_METRICS_COUNTER_SEND_FRAME_TX_ALLOC_SUCCESS_OFF (147UL)
+#define FD_METRICS_COUNTER_SEND_FRAME_TX_ALLOC_FAIL_EMPTY_POOL_OFF (148UL)
+#define FD_METRICS_COUNTER_SEND_FRAME_TX_ALLOC_FAIL_CONN_MAX_OFF (149UL)
 
-#define FD_METRICS_COUNTER_SEND_ACK_TX_OFF  (143UL)
+#define FD_METRICS_COUNTER_SEND_ACK_TX_OFF  (150UL)
 #define FD_METRICS_COUNTER_SEND_ACK_TX_NAME "send_ack_tx"
 #define FD_METRICS_COUNTER_SEND_ACK_TX_TYPE (FD_METRICS_TYPE_COUNTER)
 #define FD_METRICS_COUNTER_SEND_ACK_TX_DESC "Total count of ACK frames transmitted"
 #define FD_METRICS_COUNTER_SEND_ACK_TX_CVT  (FD_METRICS_CONVERTER_NONE)
 #define FD_METRICS_COUNTER_SEND_ACK_TX_CNT  (5UL)
 
-#define FD_METRICS_COUNTER_SEND_ACK_TX_NOOP_OFF (143UL)
-#define FD_METRICS_COUNTER_SEND_ACK_TX_NEW_OFF (144UL)
-#define FD_METRICS_COUNTER_SEND_ACK_TX_MERGED_OFF (145UL)
-#define FD_METRICS_COUNTER_SEND_ACK_TX_DROP_OFF (146UL)
-#define FD_METRICS_COUNTER_SEND_ACK_TX_CANCEL_OFF (147UL)
+#define FD_METRICS_COUNTER_SEND_ACK_TX_NOOP_OFF (150UL)
+#define FD_METRICS_COUNTER_SEND_ACK_TX_NEW_OFF (151UL)
+#define FD_METRICS_COUNTER_SEND_ACK_TX_MERGED_OFF (152UL)
+#define FD_METRICS_COUNTER_SEND_ACK_TX_DROP_OFF (153UL)
+#define FD_METRICS_COUNTER_SEND_ACK_TX_CANCEL_OFF (154UL)
 
-#define FD_METRICS_HISTOGRAM_SEND_SERVICE_DURATION_SECONDS_OFF  (148UL)
+#define FD_METRICS_HISTOGRAM_SEND_SERVICE_DURATION_SECONDS_OFF  (155UL)
 #define FD_METRICS_HISTOGRAM_SEND_SERVICE_DURATION_SECONDS_NAME "send_service_duration_seconds"
 #define FD_METRICS_HISTOGRAM_SEND_SERVICE_DURATION_SECONDS_TYPE (FD_METRICS_TYPE_HISTOGRAM)
 #define FD_METRICS_HISTOGRAM_SEND_SERVICE_DURATION_SECONDS_DESC "Duration spent in service"
@@ -456,7 +498,7 @@
 #define FD_METRICS_HISTOGRAM_SEND_SERVICE_DURATION_SECONDS_MIN  (1e-08)
 #define FD_METRICS_HISTOGRAM_SEND_SERVICE_DURATION_SECONDS_MAX  (0.1)
 
-#define FD_METRICS_HISTOGRAM_SEND_RECEIVE_DURATION_SECONDS_OFF  (165UL)
+#define FD_METRICS_HISTOGRAM_SEND_RECEIVE_DURATION_SECONDS_OFF  (172UL)
 #define FD_METRICS_HISTOGRAM_SEND_RECEIVE_DURATION_SECONDS_NAME "send_receive_duration_seconds"
 #define FD_METRICS_HISTOGRAM_SEND_RECEIVE_DURATION_SECONDS_TYPE (FD_METRICS_TYPE_HISTOGRAM)
 #define FD_METRICS_HISTOGRAM_SEND_RECEIVE_DURATION_SECONDS_DESC "Duration spent processing packets"
@@ -464,7 +506,7 @@
 #define FD_METRICS_HISTOGRAM_SEND_RECEIVE_DURATION_SECONDS_MIN  (1e-08)
 #define FD_METRICS_HISTOGRAM_SEND_RECEIVE_DURATION_SECONDS_MAX  (0.1)
 
-#define FD_METRICS_HISTOGRAM_SEND_SIGN_DURATION_NANOS_OFF  (182UL)
+#define FD_METRICS_HISTOGRAM_SEND_SIGN_DURATION_NANOS_OFF  (189UL)
 #define FD_METRICS_HISTOGRAM_SEND_SIGN_DURATION_NANOS_NAME "send_sign_duration_nanos"
 #define FD_METRICS_HISTOGRAM_SEND_SIGN_DURATION_NANOS_TYPE (FD_METRICS_TYPE_HISTOGRAM)
 #define FD_METRICS_HISTOGRAM_SEND_SIGN_DURATION_NANOS_DESC "Duration spent waiting for tls_cv signatures"
@@ -472,7 +514,7 @@
 #define FD_METRICS_HISTOGRAM_SEND_SIGN_DURATION_NANOS_MIN  (1000UL)
 #define FD_METRICS_HISTOGRAM_SEND_SIGN_DURATION_NANOS_MAX  (5000000UL)
 
-#define FD_METRICS_SEND_TOTAL (135UL)
+#define FD_METRICS_SEND_TOTAL (142UL)
 extern const fd_metrics_meta_t FD_METRICS_SEND[FD_METRICS_SEND_TOTAL];
 
 #endif /* HEADER_fd_src_disco_metrics_generated_fd_metrics_send_h */
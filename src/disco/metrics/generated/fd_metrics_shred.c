@@ -24,6 +24,8 @@ const fd_metrics_meta_t FD_METRICS_SHRED[FD_METRICS_SHRED_TOTAL] = {
     DECLARE_METRIC( SHRED_FORCE_COMPLETE_SUCCESS, COUNTER ),
     DECLARE_METRIC( SHRED_SHRED_OUT_RCV, COUNTER ),
     DECLARE_METRIC( SHRED_SHRED_TURBINE_RCV, COUNTER ),
+    DECLARE_METRIC( SHRED_DEST_CACHE_HIT, COUNTER ),
+    DECLARE_METRIC( SHRED_DEST_CACHE_MISS, COUNTER ),
     DECLARE_METRIC_HISTOGRAM_SECONDS( SHRED_STORE_INSERT_WAIT ),
     DECLARE_METRIC_HISTOGRAM_SECONDS( SHRED_STORE_INSERT_WORK ),
 };
@@ -126,7 +126,19 @@
 #define FD_METRICS_COUNTER_SHRED_SHRED_TURBINE_RCV_DESC "The number of times we received a turbine shred"
 #define FD_METRICS_COUNTER_SHRED_SHRED_TURBINE_RCV_CVT  (FD_METRICS_CONVERTER_NONE)
 
-#define FD_METRICS_HISTOGRAM_SHRED_STORE_INSERT_WAIT_OFF  (118UL)
+#define FD_METRICS_COUNTER_SHRED_DEST_CACHE_HIT_OFF  (118UL)
+#define FD_METRICS_COUNTER_SHRED_DEST_CACHE_HIT_NAME "shred_dest_cache_hit"
+#define FD_METRICS_COUNTER_SHRED_DEST_CACHE_HIT_TYPE (FD_METRICS_TYPE_COUNTER)
+#define FD_METRICS_COUNTER_SHRED_DEST_CACHE_HIT_DESC "The number of shreds whose Turbine destinations were precomputed"
+#define FD_METRICS_COUNTER_SHRED_DEST_CACHE_HIT_CVT  (FD_METRICS_CONVERTER_NONE)
+
+#define FD_METRICS_COUNTER_SHRED_DEST_CACHE_MISS_OFF  (119UL)
+#define FD_METRICS_COUNTER_SHRED_DEST_CACHE_MISS_NAME "shred_dest_cache_miss"
+#define FD_METRICS_COUNTER_SHRED_DEST_CACHE_MISS_TYPE (FD_METRICS_TYPE_COUNTER)
+#define FD_METRICS_COUNTER_SHRED_DEST_CACHE_MISS_DESC "The number of shreds whose Turbine destinations had to be computed when they were sent"
+#define FD_METRICS_COUNTER_SHRED_DEST_CACHE_MISS_CVT  (FD_METRICS_CONVERTER_NONE)
+
+#define FD_METRICS_HISTOGRAM_SHRED_STORE_INSERT_WAIT_OFF  (120UL)
 #define FD_METRICS_HISTOGRAM_SHRED_STORE_INSERT_WAIT_NAME "shred_store_insert_wait"
 #define FD_METRICS_HISTOGRAM_SHRED_STORE_INSERT_WAIT_TYPE (FD_METRICS_TYPE_HISTOGRAM)
 #define FD_METRICS_HISTOGRAM_SHRED_STORE_INSERT_WAIT_DESC "Time in seconds spent waiting for the store to insert a new FEC set"
@@ -134,7 +146,7 @@
 #define FD_METRICS_HISTOGRAM_SHRED_STORE_INSERT_WAIT_MIN  (1e-08)
 #define FD_METRICS_HISTOGRAM_SHRED_STORE_INSERT_WAIT_MAX  (0.0005)
 
-#define FD_METRICS_HISTOGRAM_SHRED_STORE_INSERT_WORK_OFF  (135UL)
+#define FD_METRICS_HISTOGRAM_SHRED_STORE_INSERT_WORK_OFF  (137UL)
 #define FD_METRICS_HISTOGRAM_SHRED_STORE_INSERT_WORK_NAME "shred_store_insert_work"
 #define FD_METRICS_HISTOGRAM_SHRED_STORE_INSERT_WORK_TYPE (FD_METRICS_TYPE_HISTOGRAM)
 #define FD_METRICS_HISTOGRAM_SHRED_STORE_INSERT_WORK_DESC "Time in seconds spent on inserting a new FEC set"
@@ -142,7 +154,7 @@
 #define FD_METRICS_HISTOGRAM_SHRED_STORE_INSERT_WORK_MIN  (1e-08)
 #define FD_METRICS_HISTOGRAM_SHRED_STORE_INSERT_WORK_MAX  (0.0005)
 
-#define FD_METRICS_SHRED_TOTAL (24UL)
+#define FD_METRICS_SHRED_TOTAL (26UL)
 extern const fd_metrics_meta_t FD_METRICS_SHRED[FD_METRICS_SHRED_TOTAL];
 
 #endif /* HEADER_fd_src_disco_metrics_generated_fd_metrics_shred_h */
@@ -14,4 +14,6 @@ const fd_metrics_meta_t FD_METRICS_SOCK[FD_METRICS_SOCK_TOTAL] = {
     DECLARE_METRIC( SOCK_TX_DROP_CNT, COUNTER ),
     DECLARE_METRIC( SOCK_TX_BYTES_TOTAL, COUNTER ),
     DECLARE_METRIC( SOCK_RX_BYTES_TOTAL, COUNTER ),
+    DECLARE_METRIC( SOCK_TX_GSO_CNT, COUNTER ),
+    DECLARE_METRIC( SOCK_RX_GRO_CNT, COUNTER ),
 };
@@ -56,7 +56,19 @@
 #define FD_METRICS_COUNTER_SOCK_RX_BYTES_TOTAL_DESC "Total number of bytes received (including Ethernet header)."
 #define FD_METRICS_COUNTER_SOCK_RX_BYTES_TOTAL_CVT  (FD_METRICS_CONVERTER_NONE)
 
-#define FD_METRICS_SOCK_TOTAL (12UL)
+#define FD_METRICS_COUNTER_SOCK_TX_GSO_CNT_OFF  (28UL)
+#define FD_METRICS_COUNTER_SOCK_TX_GSO_CNT_NAME "sock_tx_gso_cnt"
+#define FD_METRICS_COUNTER_SOCK_TX_GSO_CNT_TYPE (FD_METRICS_TYPE_COUNTER)
+#define FD_METRICS_COUNTER_SOCK_TX_GSO_CNT_DESC "Number of UDP_SEGMENT (GSO) messages sent.  Each carries multiple packets to the same destination"
+#define FD_METRICS_COUNTER_SOCK_TX_GSO_CNT_CVT  (FD_METRICS_CONVERTER_NONE)
+
+#define FD_METRICS_COUNTER_SOCK_RX_GRO_CNT_OFF  (29UL)
+#define FD_METRICS_COUNTER_SOCK_RX_GRO_CNT_NAME "sock_rx_gro_cnt"
+#define FD_METRICS_COUNTER_SOCK_RX_GRO_CNT_TYPE (FD_METRICS_TYPE_COUNTER)
+#define FD_METRICS_COUNTER_SOCK_RX_GRO_CNT_DESC "Number of coalesced UDP_GRO datagrams received.  Each is split into multiple packets"
+#define FD_METRICS_COUNTER_SOCK_RX_GRO_CNT_CVT  (FD_METRICS_CONVERTER_NONE)
+
+#define FD_METRICS_SOCK_TOTAL (14UL)
 extern const fd_metrics_meta_t FD_METRICS_SOCK[FD_METRICS_SOCK_TOTAL];
 
 #endif /* HEADER_fd_src_disco_metrics_generated_fd_metrics_sock_h */
@@ -3,6 +3,9 @@
 
 /* fd_net_common.h contains common definitions across net tile implementations. */
 
+#include "../fd_disco_base.h"
+#include "../../waltz/quic/fd_quic_conn_id.h"
+
 /* REPAIR_PING_SZ is the sz of a ping packet for the repair protocol.
    Because pings are routed to the same port as shreds without any
    discriminant encoding, we have to use the packet sz to interpret the
@@ -11,4 +14,23 @@
 
 #define REPAIR_PING_SZ (174UL)
 
+/* fd_net_rx_steer_sig applies connection-aware flow steering to the
+   netmux signature of an incoming packet.  payload points to the UDP
+   payload of size payload_sz.  For QUIC packets carrying a conn ID
+   issued by a quic tile with steering enabled, the flow hash is
+   replaced by the steering index embedded in the conn ID, such that the
+   packet is picked up by the quic tile that owns the conn regardless of
+   the source address (which may change, e.g. due to NAT rebinding).
+   All other packets keep the default source address hash. */
+
+static inline ulong
+fd_net_rx_steer_sig( ulong         sig,
+                     uchar const * payload,
+                     ulong         payload_sz ) {
+  if( fd_disco_netmux_sig_proto( sig )!=DST_PROTO_TPU_QUIC ) return sig;
+  int steer_idx = fd_quic_steer_idx( payload, payload_sz );
+  if( steer_idx<0 ) return sig;
+  return fd_disco_netmux_sig_set_hash( sig, (ulong)steer_idx );
+}
+
 #endif /* HEADER_fd_src_disco_net_fd_net_common_h */
@@ -100,6 +100,39 @@ fd_topos_tile_in_net( fd_topo_t *  topo,
                       int          reliable,
                       int          polled );
 
+/* fd_topos_net_rx_affine returns 1 if app tile app_kind_id (out of
+   app_cnt) should consume the RX link of net tile net_kind_id (out of
+   net_cnt) under net->app tile affinity, 0 otherwise.  If there are at
+   least as many app tiles as net tiles, app tile i consumes net tile
+   i%net_cnt.  Otherwise, net tile j feeds app tile j%app_cnt.  Either
+   way, every net tile has at least one consumer, and every app tile
+   consumes at least one net tile. */
+
+FD_FN_CONST static inline int
+fd_topos_net_rx_affine( ulong net_kind_id,
+                        ulong net_cnt,
+                        ulong app_kind_id,
+                        ulong app_cnt ) {
+  if( app_cnt>=net_cnt ) return (app_kind_id%net_cnt)==net_kind_id;
+  else                   return (net_kind_id%app_cnt)==app_kind_id;
+}
+
+/* fd_topos_tile_in_net_rx subscribes app tile tile_name:tile_kind_id
+   to the net->app RX links named link_name (one per net tile, created
+   with fd_topos_net_rx_link).  If affine is zero, the app tile consumes
+   the RX links of all net tiles.  Otherwise, it only consumes the links
+   selected by fd_topos_net_rx_affine.  Net frags may be dropped or
+   overrun (unreliable, polled).  All app tiles named tile_name must be
+   created before calling this. */
+
+void
+fd_topos_tile_in_net_rx( fd_topo_t *  topo,
+                         char const * tile_name,
+                         ulong        tile_kind_id,
+                         char const * fseq_wksp,
+                         char const * link_name,
+                         int          affine );
+
 /* This should be called *after* all app<->net tile links have been
    created.  Should be called once per net tile. */
 
@@ -62,6 +62,8 @@ setup_sock_tile( fd_topo_t *             topo,
   if( FD_UNLIKELY( net_cfg->socket.send_buffer_size   >INT_MAX ) ) FD_LOG_ERR(( "invalid [net.socket.send_buffer_size]" ));
   tile->sock.so_rcvbuf = (int)net_cfg->socket.receive_buffer_size;
   tile->sock.so_sndbuf = (int)net_cfg->socket.send_buffer_size   ;
+  tile->sock.udp_gso   = net_cfg->socket.udp_gso;
+  tile->sock.udp_gro   = net_cfg->socket.udp_gro;
 }
 
 void
@@ -181,6 +183,26 @@ fd_topos_tile_in_net( fd_topo_t *  topo,
   }
 }
 
+void
+fd_topos_tile_in_net_rx( fd_topo_t *  topo,
+                         char const * tile_name,
+                         ulong        tile_kind_id,
+                         char const * fseq_wksp,
+                         char const * link_name,
+                         int          affine ) {
+  ulong net_cnt = 0UL;
+  for( ulong j=0UL; j<(topo->link_cnt); j++ ) {
+    if( 0==strcmp( topo->links[ j ].name, link_name ) ) net_cnt++;
+  }
+  ulong app_cnt = fd_topo_tile_name_cnt( topo, tile_name );
+  if( FD_UNLIKELY( tile_kind_id>=app_cnt ) ) FD_LOG_ERR(( "tile %s:%lu not found", tile_name, tile_kind_id ));
+
+  for( ulong j=0UL; j<net_cnt; j++ ) {
+    if( affine && !fd_topos_net_rx_affine( j, net_cnt, tile_kind_id, app_cnt ) ) continue;
+    fd_topob_tile_in( topo, tile_name, tile_kind_id, fseq_wksp, link_name, j, FD_TOPOB_UNRELIABLE, FD_TOPOB_POLLED );
+  }
+}
+
 void
 fd_topos_net_tile_finish( fd_topo_t * topo,
                           ulong       net_kind_id ) {
@@ -12,11 +12,23 @@
 #include <fcntl.h> /* fcntl */
 #include <unistd.h> /* dup3, close */
 #include <netinet/in.h> /* sockaddr_in */
+#include <netinet/udp.h> /* UDP_SEGMENT, UDP_GRO */
 #include <sys/socket.h> /* socket */
 #include "../../metrics/fd_metrics.h"
 
 #include "generated/fd_sock_tile_seccomp.h"
 
+/* Older libc headers lack the UDP offload socket options */
+#ifndef SOL_UDP
+#define SOL_UDP (17)
+#endif
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT (103)
+#endif
+#ifndef UDP_GRO
+#define UDP_GRO (104)
+#endif
+
 /* recv/sendmmsg packet count in batch and tango burst depth
    FIXME make configurable in the future?
    FIXME keep in sync with fd_net_tile_topo.c */
@@ -83,26 +95,42 @@ scratch_align( void ) {
   return 4096UL;
 }
 
+/* gro_buf_footprint returns the size of the UDP_GRO receive buffers.
+   Zero if GRO is disabled, in which case packets are received directly
+   into dcache chunks. */
+
+FD_FN_PURE static inline ulong
+gro_buf_footprint( fd_topo_tile_t const * tile ) {
+  return tile->sock.udp_gro ? STEM_BURST*FD_SOCK_GRO_BUF_SZ : 0UL;
+}
+
 FD_FN_PURE static inline ulong
-scratch_footprint( fd_topo_tile_t const * tile FD_PARAM_UNUSED ) {
+scratch_footprint( fd_topo_tile_t const * tile ) {
   ulong l = FD_LAYOUT_INIT;
   l = FD_LAYOUT_APPEND( l, alignof(fd_sock_tile_t),     sizeof(fd_sock_tile_t)                );
   l = FD_LAYOUT_APPEND( l, alignof(struct iovec),       STEM_BURST*sizeof(struct iovec)       );
   l = FD_LAYOUT_APPEND( l, alignof(struct cmsghdr),     STEM_BURST*FD_SOCK_CMSG_MAX           );
   l = FD_LAYOUT_APPEND( l, alignof(struct sockaddr_in), STEM_BURST*sizeof(struct sockaddr_in) );
   l = FD_LAYOUT_APPEND( l, alignof(struct mmsghdr),     STEM_BURST*sizeof(struct mmsghdr)     );
+  l = FD_LAYOUT_APPEND( l, alignof(struct mmsghdr),     STEM_BURST*sizeof(struct mmsghdr)     );
+  l = FD_LAYOUT_APPEND( l, 1UL,                         STEM_BURST                            );
+  l = FD_LAYOUT_APPEND( l, alignof(fd_sock_gro_msg_t),  STEM_BURST*sizeof(fd_sock_gro_msg_t)  );
   l = FD_LAYOUT_APPEND( l, FD_CHUNK_ALIGN,              tx_scratch_footprint()                );
+  l = FD_LAYOUT_APPEND( l, FD_CHUNK_ALIGN,              gro_buf_footprint( tile )             );
   return FD_LAYOUT_FINI( l, scratch_align() );
 }
 
 /* create_udp_socket creates and configures a new UDP socket for the
-   sock tile at the given file descriptor ID. */
+   sock tile at the given file descriptor ID.  If *udp_gro is non-zero,
+   attempts to enable UDP_GRO on the socket and clears *udp_gro if the
+   kernel does not support it. */
 
 static void
 create_udp_socket( int    sock_fd,
                    uint   bind_addr,
                    ushort udp_port,
-                   int    so_rcvbuf ) {
+                   int    so_rcvbuf,
+                   int *  udp_gro ) {
 
   if( fcntl( sock_fd, F_GETFD, 0 )!=-1 ) {
     FD_LOG_ERR(( "file descriptor %d already exists", sock_fd ));
@@ -129,6 +157,14 @@ create_udp_socket( int    sock_fd,
     FD_LOG_ERR(( "setsockopt(SOL_SOCKET,SO_RCVBUF,%i) failed (%i-%s)", so_rcvbuf, errno, fd_io_strerror( errno ) ));
   }
 
+  if( *udp_gro ) {
+    int gro = 1;
+    if( FD_UNLIKELY( 0!=setsockopt( orig_fd, SOL_UDP, UDP_GRO, &gro, sizeof(int) ) ) ) {
+      FD_LOG_WARNING(( "setsockopt(SOL_UDP,UDP_GRO,1) failed (%i-%s), disabling [net.socket.udp_gro]", errno, fd_io_strerror( errno ) ));
+      *udp_gro = 0;
+    }
+  }
+
   struct sockaddr_in saddr = {
     .sin_family      = AF_INET,
     .sin_addr.s_addr = bind_addr,
@@ -163,7 +199,11 @@ privileged_init( fd_topo_t *      topo,
   void *               batch_cmsg = FD_SCRATCH_ALLOC_APPEND( l, alignof(struct cmsghdr),     STEM_BURST*FD_SOCK_CMSG_MAX           );
   struct sockaddr_in * batch_sa   = FD_SCRATCH_ALLOC_APPEND( l, alignof(struct sockaddr_in), STEM_BURST*sizeof(struct sockaddr_in) );
   struct mmsghdr *     batch_msg  = FD_SCRATCH_ALLOC_APPEND( l, alignof(struct mmsghdr),     STEM_BURST*sizeof(struct mmsghdr)     );
+  struct mmsghdr *     batch_tmp  = FD_SCRATCH_ALLOC_APPEND( l, alignof(struct mmsghdr),     STEM_BURST*sizeof(struct mmsghdr)     );
+  uchar *              batch_sock = FD_SCRATCH_ALLOC_APPEND( l, 1UL,                         STEM_BURST                            );
+  fd_sock_gro_msg_t *  gro_msg    = FD_SCRATCH_ALLOC_APPEND( l, alignof(fd_sock_gro_msg_t),  STEM_BURST*sizeof(fd_sock_gro_msg_t)  );
   uchar *              tx_scratch = FD_SCRATCH_ALLOC_APPEND( l, FD_CHUNK_ALIGN,              tx_scratch_footprint()                );
+  uchar *              gro_buf    = FD_SCRATCH_ALLOC_APPEND( l, FD_CHUNK_ALIGN,              gro_buf_footprint( tile )             );
 
   assert( scratch==ctx );
 
@@ -172,14 +212,21 @@ privileged_init( fd_topo_t *      topo,
   fd_memset( batch_sa,  0, STEM_BURST*sizeof(struct sockaddr_in) );
   fd_memset( batch_msg, 0, STEM_BURST*sizeof(struct mmsghdr)     );
 
-  ctx->batch_cnt   = 0UL;
-  ctx->batch_iov   = batch_iov;
-  ctx->batch_cmsg  = batch_cmsg;
-  ctx->batch_sa    = batch_sa;
-  ctx->batch_msg   = batch_msg;
-  ctx->tx_scratch0 = tx_scratch;
-  ctx->tx_scratch1 = tx_scratch + tx_scratch_footprint();
-  ctx->tx_ptr      = tx_scratch;
+  ctx->batch_cnt     = 0UL;
+  ctx->batch_msg_cnt = 0UL;
+  ctx->batch_iov     = batch_iov;
+  ctx->batch_cmsg    = batch_cmsg;
+  ctx->batch_sa      = batch_sa;
+  ctx->batch_msg     = batch_msg;
+  ctx->batch_sock    = batch_sock;
+  ctx->batch_msg_tmp = batch_tmp;
+  ctx->gro_msg       = gro_msg;
+  ctx->gro_buf       = gro_buf;
+  ctx->tx_scratch0   = tx_scratch;
+  ctx->tx_scratch1   = tx_scratch + tx_scratch_footprint();
+  ctx->tx_ptr        = tx_scratch;
+
+  int udp_gro = tile->sock.udp_gro;
 
   /* Create receive sockets.  Incrementally assign them to file
      descriptors starting at sock_fd_min. */
@@ -241,7 +288,19 @@ privileged_init( fd_topo_t *      topo,
     }
 
     int sock_fd = sock_fd_min + (int)sock_idx;
-    create_udp_socket( sock_fd, tile->sock.net.bind_address, port, tile->sock.so_rcvbuf );
+    int sock_gro = udp_gro;
+    create_udp_socket( sock_fd, tile->sock.net.bind_address, port, tile->sock.so_rcvbuf, &sock_gro );
+    if( FD_UNLIKELY( udp_gro && !sock_gro ) ) {
+      /* Kernel support is global, so this only happens on the first
+         socket.  Otherwise, revert to plain receives everywhere. */
+      int gro = 0;
+      for( uint j=0U; j<ctx->sock_cnt; j++ ) {
+        if( FD_UNLIKELY( 0!=setsockopt( ctx->pollfd[ j ].fd, SOL_UDP, UDP_GRO, &gro, sizeof(int) ) ) ) {
+          FD_LOG_ERR(( "setsockopt(SOL_UDP,UDP_GRO,0) failed (%i-%s)", errno, fd_io_strerror( errno ) ));
+        }
+      }
+      udp_gro = 0;
+    }
     ctx->pollfd[ sock_idx ].fd     = sock_fd;
     ctx->pollfd[ sock_idx ].events = POLLIN;
     ctx->sock_cnt++;
@@ -261,6 +320,30 @@ privileged_init( fd_topo_t *      topo,
   ctx->tx_sock      = tx_sock;
   ctx->bind_address = tile->sock.net.bind_address;
 
+  /* UDP_SEGMENT is a per-message option, so probe for kernel support
+     by reading the socket default. */
+
+  int udp_gso = tile->sock.udp_gso && ctx->sock_cnt;
+  if( udp_gso ) {
+    int       gso_sz     = 0;
+    socklen_t gso_sz_len = sizeof(int);
+    if( FD_UNLIKELY( 0!=getsockopt( ctx->pollfd[ 0 ].fd, SOL_UDP, UDP_SEGMENT, &gso_sz, &gso_sz_len ) ) ) {
+      FD_LOG_WARNING(( "getsockopt(SOL_UDP,UDP_SEGMENT) failed (%i-%s), disabling [net.socket.udp_gso]", errno, fd_io_strerror( errno ) ));
+      udp_gso = 0;
+    }
+  }
+
+  /* GSO messages are sent via the RX sockets */
+
+  for( uint j=0U; udp_gso && j<ctx->sock_cnt; j++ ) {
+    if( FD_UNLIKELY( 0!=setsockopt( ctx->pollfd[ j ].fd, SOL_SOCKET, SO_SNDBUF, &tile->sock.so_sndbuf, sizeof(int) ) ) ) {
+      FD_LOG_ERR(( "setsockopt(SOL_SOCKET,SO_SNDBUF,%i) failed (%i-%s)", tile->sock.so_sndbuf, errno, fd_io_strerror( errno ) ));
+    }
+  }
+
+  ctx->udp_gso = udp_gso;
+  ctx->udp_gro = udp_gro;
+
 }
 
 static void
@@ -304,6 +387,70 @@ unprivileged_init( fd_topo_t *      topo,
 /* FIXME Pace RX polling and interleave it with TX jobs to reduce TX
          tail latency */
 
+/* rx_write_hdrs synthesizes the Ethernet, IPv4, and UDP headers of an
+   incoming packet in front of its payload.  frame points to the first
+   byte of the Ethernet header.  Addresses and sport are in network byte
+   order, dport is in host byte order. */
+
+static inline void
+rx_write_hdrs( uchar * frame,
+               uint    saddr,
+               ushort  sport,
+               uint    daddr,
+               ushort  dport,
+               ulong   payload_sz ) {
+  fd_eth_hdr_t * eth_hdr = (fd_eth_hdr_t *)( frame    );
+  fd_ip4_hdr_t * ip_hdr  = (fd_ip4_hdr_t *)( frame+14 );
+  fd_udp_hdr_t * udp_hdr = (fd_udp_hdr_t *)( frame+34 );
+  memset( eth_hdr->dst, 0, 6 );
+  memset( eth_hdr->src, 0, 6 );
+  eth_hdr->net_type = fd_ushort_bswap( FD_ETH_HDR_TYPE_IP );
+  *ip_hdr = (fd_ip4_hdr_t) {
+    .verihl      = FD_IP4_VERIHL( 4, 5 ),
+    .net_tot_len = fd_ushort_bswap( (ushort)( payload_sz+28UL ) ),
+    .ttl         = 1,
+    .protocol    = FD_IP4_HDR_PROTOCOL_UDP,
+  };
+  memcpy( ip_hdr->saddr_c, &saddr, 4 );
+  memcpy( ip_hdr->daddr_c, &daddr, 4 );
+  *udp_hdr = (fd_udp_hdr_t) {
+    .net_sport = sport,
+    .net_dport = (ushort)fd_ushort_bswap( (ushort)dport ),
+    .net_len   = (ushort)fd_ushort_bswap( (ushort)( payload_sz+8UL ) ),
+    .check     = 0
+  };
+}
+
+/* rx_parse_cmsg extracts the local address (IP_PKTINFO) and the GRO
+   segment size (UDP_GRO) of a received message.  *gso_sz is left
+   untouched if the message was not coalesced. */
+
+static inline void
+rx_parse_cmsg( struct msghdr * msg_hdr,
+               uint *          daddr,
+               ulong *         gso_sz ) {
+  int has_daddr = 0;
+  struct cmsghdr * cmsg = CMSG_FIRSTHDR( msg_hdr );
+  if( FD_LIKELY( cmsg ) ) {
+    do {
+      if( FD_LIKELY( (cmsg->cmsg_level==IPPROTO_IP) &
+                     (cmsg->cmsg_type ==IP_PKTINFO) ) ) {
+        struct in_pktinfo const * pi = (struct in_pktinfo const *)CMSG_DATA( cmsg );
+        *daddr    = pi->ipi_addr.s_addr;
+        has_daddr = 1;
+      } else if( (cmsg->cmsg_level==SOL_UDP) &
+                 (cmsg->cmsg_type ==UDP_GRO) ) {
+        *gso_sz = (ulong)FD_LOAD( int, CMSG_DATA( cmsg ) );
+      }
+      cmsg = CMSG_NXTHDR( msg_hdr, cmsg );
+    } while( FD_UNLIKELY( cmsg ) ); /* optimize for 1 cmsg */
+  }
+  if( FD_UNLIKELY( !has_daddr ) ) {
+    /* unreachable because IP_PKTINFO was set */
+    FD_LOG_ERR(( "Missing IP_PKTINFO on incoming packet" ));
+  }
+}
+
 /* poll_rx_socket does one recvmmsg batch receive on the given socket
    index.  Returns the number of packets returned by recvmmsg. */
 
@@ -370,48 +517,17 @@ poll_rx_socket( fd_sock_tile_t *    ctx,
       FD_LOG_ERR(( "Received packet with unexpected sin_family %i", sa->sin_family ));
     }
 
-    long daddr = -1;
-    struct cmsghdr * cmsg = CMSG_FIRSTHDR( &ctx->batch_msg[ j ].msg_hdr );
-    if( FD_LIKELY( cmsg ) ) {
-      do {
-        if( FD_LIKELY( (cmsg->cmsg_level==IPPROTO_IP) &
-                       (cmsg->cmsg_type ==IP_PKTINFO) ) ) {
-          struct in_pktinfo const * pi = (struct in_pktinfo const *)CMSG_DATA( cmsg );
-          daddr = pi->ipi_addr.s_addr;
-        }
-        cmsg = CMSG_NXTHDR( &ctx->batch_msg[ j ].msg_hdr, cmsg );
-      } while( FD_UNLIKELY( cmsg ) ); /* optimize for 1 cmsg */
-    }
-    if( FD_UNLIKELY( daddr<0L ) ) {
-      /* unreachable because IP_PKTINFO was set */
-      FD_LOG_ERR(( "Missing IP_PKTINFO on incoming packet" ));
-    }
+    uint  daddr  = 0U;
+    ulong gso_sz = 0UL;
+    rx_parse_cmsg( &ctx->batch_msg[ j ].msg_hdr, &daddr, &gso_sz );
 
-    fd_eth_hdr_t * eth_hdr    = (fd_eth_hdr_t *)( payload-42UL );
-    fd_ip4_hdr_t * ip_hdr     = (fd_ip4_hdr_t *)( payload-28UL );
-    fd_udp_hdr_t * udp_hdr    = (fd_udp_hdr_t *)( payload- 8UL );
-    memset( eth_hdr->dst, 0, 6 );
-    memset( eth_hdr->src, 0, 6 );
-    eth_hdr->net_type = fd_ushort_bswap( FD_ETH_HDR_TYPE_IP );
-    *ip_hdr = (fd_ip4_hdr_t) {
-      .verihl      = FD_IP4_VERIHL( 4, 5 ),
-      .net_tot_len = fd_ushort_bswap( (ushort)( payload_sz+28UL ) ),
-      .ttl         = 1,
-      .protocol    = FD_IP4_HDR_PROTOCOL_UDP,
-    };
-    uint daddr_ = (uint)(ulong)daddr;
-    memcpy( ip_hdr->saddr_c, &sa->sin_addr.s_addr, 4 );
-    memcpy( ip_hdr->daddr_c, &daddr_,              4 );
-    *udp_hdr = (fd_udp_hdr_t) {
-      .net_sport = sa->sin_port,
-      .net_dport = (ushort)fd_ushort_bswap( (ushort)dport ),
-      .net_len   = (ushort)fd_ushort_bswap( (ushort)( payload_sz+8UL ) ),
-      .check     = 0
-    };
+    uchar * eth_hdr = payload-hdr_sz;
+    rx_write_hdrs( eth_hdr, sa->sin_addr.s_addr, sa->sin_port, daddr, dport, payload_sz );
 
     ctx->metrics.rx_pkt_cnt++;
     ulong chunk = fd_laddr_to_chunk( base, eth_hdr );
     ulong sig   = fd_disco_netmux_sig( sa->sin_addr.s_addr, fd_ushort_bswap( sa->sin_port ), sa->sin_addr.s_addr, proto, hdr_sz );
+    sig         = fd_net_rx_steer_sig( sig, payload, payload_sz );
     ulong tspub = fd_frag_meta_ts_comp( ts );
 
     /* default for repair intake is to send to [shreds] to shred tile.
@@ -435,6 +551,133 @@ poll_rx_socket( fd_sock_tile_t *    ctx,
   return (ulong)msg_cnt;
 }
 
+/* drain_rx_gro splits the datagrams of the pending UDP_GRO batch into
+   individual packets and publishes them, copying each into a dcache
+   chunk.  Publishes at most STEM_BURST packets.  Returns the number of
+   packets published. */
+
+static ulong
+drain_rx_gro( fd_sock_tile_t *    ctx,
+              fd_stem_context_t * stem ) {
+  ulong  hdr_sz      = sizeof(fd_eth_hdr_t) + sizeof(fd_ip4_hdr_t) + sizeof(fd_udp_hdr_t);
+  ulong  payload_max = FD_NET_MTU-hdr_sz;
+  uint   sock_idx    = ctx->gro_sock_idx;
+  ushort proto       = ctx->proto_id    [ sock_idx ];
+  ushort dport       = ctx->rx_sock_port[ sock_idx ];
+  ulong  tspub       = fd_frag_meta_ts_comp( ctx->gro_ts );
+
+  ulong msg_idx = ctx->gro_msg_idx;
+  ulong seg_off = ctx->gro_seg_off;
+  ulong pub_cnt = 0UL;
+  while( msg_idx<ctx->gro_msg_cnt && pub_cnt<STEM_BURST ) {
+    fd_sock_gro_msg_t const * msg = ctx->gro_msg + msg_idx;
+    uchar const * payload    = ctx->gro_buf + msg_idx*FD_SOCK_GRO_BUF_SZ + seg_off;
+    ulong         payload_sz = fd_ulong_min( msg->seg_sz, msg->sz - seg_off );
+    /* Truncate oversize datagrams like a MTU-sized receive would */
+    ulong         copy_sz    = fd_ulong_min( payload_sz, payload_max );
+    ulong         frame_sz   = copy_sz + hdr_sz;
+
+    /* default for repair intake is to send to [shreds] to shred tile.
+       ping messages should be routed to the repair. */
+    uchar rx_link = ctx->link_rx_map[ sock_idx ];
+    if( FD_UNLIKELY( sock_idx==REPAIR_SHRED_SOCKET_ID && frame_sz==REPAIR_PING_SZ ) ) {
+      rx_link = ctx->link_rx_map[ REPAIR_SHRED_SOCKET_ID+1 ];
+    }
+    fd_sock_link_rx_t * link = ctx->link_rx + rx_link;
+
+    uchar * frame = fd_chunk_to_laddr( link->base, link->chunk );
+    rx_write_hdrs( frame, msg->saddr, msg->sport, msg->daddr, dport, copy_sz );
+    fd_memcpy( frame+hdr_sz, payload, copy_sz );
+
+    ulong sig = fd_disco_netmux_sig( msg->saddr, fd_ushort_bswap( msg->sport ), msg->saddr, proto, hdr_sz );
+    sig       = fd_net_rx_steer_sig( sig, payload, copy_sz );
+    fd_stem_publish( stem, rx_link, sig, link->chunk, frame_sz, 0UL, 0UL, tspub );
+    link->chunk = fd_dcache_compact_next( link->chunk, FD_NET_MTU, link->chunk0, link->wmark );
+
+    ctx->metrics.rx_pkt_cnt++;
+    ctx->metrics.rx_bytes_total += frame_sz;
+    pub_cnt++;
+
+    seg_off += payload_sz;
+    if( seg_off>=msg->sz ) {
+      msg_idx++;
+      seg_off = 0UL;
+    }
+  }
+
+  ctx->gro_msg_idx = msg_idx;
+  ctx->gro_seg_off = seg_off;
+  return pub_cnt;
+}
+
+/* poll_rx_socket_gro is the UDP_GRO variant of poll_rx_socket.  Each
+   message of the recvmmsg batch is a (possibly coalesced) datagram
+   received into gro_buf.  Datagram metadata is saved to gro_msg, since
+   the batch arrays are reused by the TX path while de-segmentation is
+   pending.  Returns the number of packets published. */
+
+static ulong
+poll_rx_socket_gro( fd_sock_tile_t *    ctx,
+                    fd_stem_context_t * stem,
+                    uint                sock_idx,
+                    int                 sock_fd ) {
+  uchar * cmsg_next = ctx->batch_cmsg;
+  for( ulong j=0UL; j<STEM_BURST; j++ ) {
+    ctx->batch_iov[ j ].iov_base = ctx->gro_buf + j*FD_SOCK_GRO_BUF_SZ;
+    ctx->batch_iov[ j ].iov_len  = FD_SOCK_GRO_BUF_SZ;
+    ctx->batch_msg[ j ].msg_hdr  = (struct msghdr) {
+      .msg_iov        = ctx->batch_iov+j,
+      .msg_iovlen     = 1,
+      .msg_name       = ctx->batch_sa+j,
+      .msg_namelen    = sizeof(struct sockaddr_in),
+      .msg_control    = cmsg_next,
+      .msg_controllen = FD_SOCK_CMSG_MAX,
+    };
+    cmsg_next += FD_SOCK_CMSG_MAX;
+  }
+
+  int msg_cnt = recvmmsg( sock_fd, ctx->batch_msg, STEM_BURST, MSG_DONTWAIT, NULL );
+  if( FD_UNLIKELY( msg_cnt<0 ) ) {
+    if( FD_LIKELY( errno==EAGAIN ) ) return 0UL;
+    /* unreachable if socket is in a valid state */
+    FD_LOG_ERR(( "recvmmsg failed (%i-%s)", errno, fd_io_strerror( errno ) ));
+  }
+  long ts = fd_tickcount();
+  ctx->metrics.sys_recvmmsg_cnt++;
+
+  if( FD_UNLIKELY( msg_cnt==0 ) ) return 0UL;
+
+  for( ulong j=0; j<(ulong)msg_cnt; j++ ) {
+    struct sockaddr_in * sa = ctx->batch_msg[ j ].msg_hdr.msg_name;
+    if( FD_UNLIKELY( sa->sin_family!=AF_INET ) ) {
+      /* unreachable */
+      FD_LOG_ERR(( "Received packet with unexpected sin_family %i", sa->sin_family ));
+    }
+
+    ulong sz     = ctx->batch_msg[ j ].msg_len;
+    uint  daddr  = 0U;
+    ulong gso_sz = sz;
+    rx_parse_cmsg( &ctx->batch_msg[ j ].msg_hdr, &daddr, &gso_sz );
+    if( FD_UNLIKELY( !gso_sz ) ) gso_sz = 1UL; /* empty datagram */
+    ctx->metrics.rx_gro_cnt += sz>gso_sz;
+
+    ctx->gro_msg[ j ] = (fd_sock_gro_msg_t) {
+      .saddr  = sa->sin_addr.s_addr,
+      .daddr  = daddr,
+      .sport  = sa->sin_port,
+      .seg_sz = (ushort)fd_ulong_min( gso_sz, USHORT_MAX ),
+      .sz     = (uint)sz
+    };
+  }
+
+  ctx->gro_sock_idx = sock_idx;
+  ctx->gro_msg_cnt  = (ulong)msg_cnt;
+  ctx->gro_msg_idx  = 0UL;
+  ctx->gro_seg_off  = 0UL;
+  ctx->gro_ts       = ts;
+  return drain_rx_gro( ctx, stem );
+}
+
 static ulong
 poll_rx( fd_sock_tile_t *    ctx,
          fd_stem_context_t * stem ) {
@@ -448,32 +691,50 @@ poll_rx( fd_sock_tile_t *    ctx,
   }
   for( uint j=0UL; j<ctx->sock_cnt; j++ ) {
     if( ctx->pollfd[ j ].revents & (POLLIN|POLLERR) ) {
-      pkt_cnt += poll_rx_socket(
-        ctx,
-        stem,
-        j,
-        ctx->pollfd[ j ].fd,
-        ctx->proto_id[ j ]
-      );
+      if( ctx->udp_gro ) {
+        pkt_cnt += poll_rx_socket_gro( ctx, stem, j, ctx->pollfd[ j ].fd );
+      } else {
+        pkt_cnt += poll_rx_socket(
+          ctx,
+          stem,
+          j,
+          ctx->pollfd[ j ].fd,
+          ctx->proto_id[ j ]
+        );
+      }
     }
     ctx->pollfd[ j ].revents = 0;
+    /* gro_buf is still in use, poll remaining sockets later */
+    if( FD_UNLIKELY( ctx->gro_msg_idx<ctx->gro_msg_cnt ) ) break;
   }
   return pkt_cnt;
 }
 
 /* TX PATH (tango->socket) ********************************************/
 
+/* flush_tx_msgs sends a list of messages via sendmmsg on the given
+   socket.  A message carries multiple packets if it is a GSO message. */
+
 static void
-flush_tx_batch( fd_sock_tile_t * ctx ) {
-  ulong batch_cnt = ctx->batch_cnt;
-  for( int j = 0; j < (int)batch_cnt; /* incremented in loop */ ) {
-    int remain   = (int)batch_cnt - j;
-    int send_cnt = sendmmsg( ctx->tx_sock, ctx->batch_msg + j, (uint)remain, MSG_DONTWAIT );
+flush_tx_msgs( fd_sock_tile_t * ctx,
+               int              sock_fd,
+               struct mmsghdr * msgs,
+               ulong            msg_cnt ) {
+  for( int j = 0; j < (int)msg_cnt; /* incremented in loop */ ) {
+    int remain   = (int)msg_cnt - j;
+    int send_cnt = sendmmsg( sock_fd, msgs + j, (uint)remain, MSG_DONTWAIT );
     if( send_cnt>=0 ) {
       ctx->metrics.sys_sendmmsg_cnt[ FD_METRICS_ENUM_SOCK_ERR_V_NO_ERROR_IDX ]++;
     }
+
+    /* add the successful count */
+    for( int k=j; k<j+send_cnt; k++ ) {
+      ulong pkt_cnt = msgs[ k ].msg_hdr.msg_iovlen;
+      ctx->metrics.tx_pkt_cnt += pkt_cnt;
+      ctx->metrics.tx_gso_cnt += pkt_cnt>1UL;
+    }
+
     if( FD_UNLIKELY( send_cnt < remain ) ) {
-      ctx->metrics.tx_drop_cnt++;
       if( FD_UNLIKELY( send_cnt < 0 ) ) {
         switch( errno ) {
         case EAGAIN:
@@ -497,27 +758,51 @@ flush_tx_batch( fd_sock_tile_t * ctx ) {
           /* log with NOTICE, since flushing has a significant negative performance impact */
           FD_LOG_NOTICE(( "sendmmsg failed (%i-%s)", errno, fd_io_strerror( errno ) ));
         }
-
-        /* first message failed, so skip failing message and continue */
-        j++;
-      } else {
-        /* send_cnt succeeded, so skip those and also the failing message */
-        j += send_cnt + 1;
-
-        /* add the successful count */
-        ctx->metrics.tx_pkt_cnt += (ulong)send_cnt;
+        send_cnt = 0;
       }
 
+      /* send_cnt succeeded, so skip those and also the failing message */
+      ctx->metrics.tx_drop_cnt += msgs[ j+send_cnt ].msg_hdr.msg_iovlen;
+      j += send_cnt + 1;
       continue;
     }
 
-    /* send_cnt == batch_cnt, so we sent everything */
-    ctx->metrics.tx_pkt_cnt += (ulong)send_cnt;
+    /* send_cnt == remain, so we sent everything */
     break;
   }
+}
 
-  ctx->tx_ptr = ctx->tx_scratch0;
-  ctx->batch_cnt = 0;
+/* flush_tx_batch sends all messages in the batch.  If UDP GSO is
+   enabled, messages are grouped by socket, such that each socket
+   in use costs one sendmmsg call. */
+
+static void
+flush_tx_batch( fd_sock_tile_t * ctx ) {
+  ulong msg_cnt  = ctx->batch_msg_cnt;
+  uint  sock_set = ctx->batch_sock_set;
+
+  if( FD_LIKELY( fd_uint_popcnt( sock_set )<=1 ) ) {
+    /* All messages go to the same socket */
+    uint sock_idx = (uint)fd_uint_find_lsb_w_default( sock_set, FD_SOCK_TILE_MAX_SOCKETS );
+    int  sock_fd  = sock_idx<FD_SOCK_TILE_MAX_SOCKETS ? ctx->pollfd[ sock_idx ].fd : ctx->tx_sock;
+    flush_tx_msgs( ctx, sock_fd, ctx->batch_msg, msg_cnt );
+  } else {
+    for( ; sock_set; sock_set = fd_uint_pop_lsb( sock_set ) ) {
+      uint  sock_idx = (uint)fd_uint_find_lsb( sock_set );
+      int   sock_fd  = sock_idx<FD_SOCK_TILE_MAX_SOCKETS ? ctx->pollfd[ sock_idx ].fd : ctx->tx_sock;
+      ulong grp_cnt  = 0UL;
+      for( ulong j=0UL; j<msg_cnt; j++ ) {
+        if( ctx->batch_sock[ j ]==sock_idx ) ctx->batch_msg_tmp[ grp_cnt++ ] = ctx->batch_msg[ j ];
+      }
+      flush_tx_msgs( ctx, sock_fd, ctx->batch_msg_tmp, grp_cnt );
+    }
+  }
+
+  ctx->tx_ptr         = ctx->tx_scratch0;
+  ctx->batch_cnt      = 0;
+  ctx->batch_msg_cnt  = 0;
+  ctx->batch_sock_set = 0U;
+  ctx->tx_gso_seg_sz  = 0UL;
 }
 
 /* before_frag is called when a new frag has been detected.  The sock
@@ -535,9 +820,28 @@ before_frag( fd_sock_tile_t * ctx    FD_PARAM_UNUSED,
   return 0; /* continue */
 }
 
+/* tx_gso_sock_idx returns the index of the RX socket bound to the
+   given UDP source port (host byte order), or FD_SOCK_TILE_MAX_SOCKETS
+   if the packet must be sent via the SOCK_RAW socket. */
+
+static inline uint
+tx_gso_sock_idx( fd_sock_tile_t const * ctx,
+                 ushort                 sport ) {
+  if( !ctx->udp_gso ) return FD_SOCK_TILE_MAX_SOCKETS;
+  for( uint j=0U; j<ctx->sock_cnt; j++ ) {
+    if( ctx->rx_sock_port[ j ]==sport ) return j;
+  }
+  return FD_SOCK_TILE_MAX_SOCKETS;
+}
+
 /* during_frag is called when a new frag passed early filtering.
    Speculatively copies data into a sendmmsg buffer.  (If all tiles
-   respect backpressure could eliminate this copy) */
+   respect backpressure could eliminate this copy)
+
+   If UDP GSO is enabled and the packet continues a run of packets to
+   the same destination, it is speculatively prepared as an additional
+   segment of the last message (committed in after_frag).  Otherwise,
+   it is prepared as a new message. */
 
 static inline void
 during_frag( fd_sock_tile_t * ctx,
@@ -575,21 +879,54 @@ during_frag( fd_sock_tile_t * ctx,
 
   ulong msg_sz = sizeof(fd_udp_hdr_t) + payload_sz;
 
+  uint daddr    = FD_LOAD( uint, ip_hdr->daddr_c );
+  uint spec_dst = fd_uint_if( !!ip_hdr->saddr, ip_hdr->saddr, ctx->bind_address );
+  uint sock_idx = tx_gso_sock_idx( ctx, fd_ushort_bswap( udp_hdr->net_sport ) );
+  int  is_dgram = sock_idx<FD_SOCK_TILE_MAX_SOCKETS;
+
   ulong batch_idx = ctx->batch_cnt;
+  ulong msg_idx   = ctx->batch_msg_cnt;
   assert( batch_idx<STEM_BURST );
-  struct mmsghdr *     msg  = ctx->batch_msg + batch_idx;
-  struct sockaddr_in * sa   = ctx->batch_sa  + batch_idx;
-  struct iovec   *     iov  = ctx->batch_iov + batch_idx;
-  struct cmsghdr *     cmsg = (void *)( (ulong)ctx->batch_cmsg + batch_idx*FD_SOCK_CMSG_MAX );
-  uchar *              buf  = ctx->tx_ptr;
+  struct iovec * iov = ctx->batch_iov + batch_idx;
+  uchar *        buf = ctx->tx_ptr;
 
+  /* The SOCK_RAW socket takes the UDP header as part of the payload,
+     SOCK_DGRAM sockets generate it. */
   *iov = (struct iovec) {
-    .iov_base = buf,
-    .iov_len  = msg_sz,
+    .iov_base = is_dgram ? buf+sizeof(fd_udp_hdr_t) : buf,
+    .iov_len  = is_dgram ? payload_sz               : msg_sz,
   };
+  memcpy( buf, udp_hdr, sizeof(fd_udp_hdr_t) );
+  fd_memcpy( buf+sizeof(fd_udp_hdr_t), payload, payload_sz );
+  ctx->metrics.tx_bytes_total += sz;
+
+  /* Try to append to the last message */
+
+  ctx->tx_gso_join = 0;
+  if( is_dgram && ctx->tx_gso_seg_sz ) {
+    struct msghdr const *      last_hdr = &ctx->batch_msg[ msg_idx-1UL ].msg_hdr;
+    struct sockaddr_in const * last_sa  = last_hdr->msg_name;
+    struct in_pktinfo const *  last_pi  = (struct in_pktinfo const *)CMSG_DATA( (struct cmsghdr const *)last_hdr->msg_control );
+    ctx->tx_gso_join =
+        ( ctx->batch_sock[ msg_idx-1UL ]==sock_idx            ) &
+        ( last_sa->sin_addr.s_addr==daddr                     ) &
+        ( last_sa->sin_port==udp_hdr->net_dport               ) &
+        ( last_pi->ipi_spec_dst.s_addr==spec_dst              ) &
+        ( payload_sz>0UL                                      ) &
+        ( payload_sz<=ctx->tx_gso_seg_sz                      ) &
+        ( ctx->tx_gso_tot_sz+payload_sz<=FD_SOCK_GSO_SZ_MAX   );
+    if( ctx->tx_gso_join ) return;
+  }
+
+  /* Prepare a new message */
+
+  struct mmsghdr *     msg  = ctx->batch_msg + msg_idx;
+  struct sockaddr_in * sa   = ctx->batch_sa  + msg_idx;
+  struct cmsghdr *     cmsg = (void *)( (ulong)ctx->batch_cmsg + msg_idx*FD_SOCK_CMSG_MAX );
+
   sa->sin_family      = AF_INET;
-  sa->sin_addr.s_addr = FD_LOAD( uint, ip_hdr->daddr_c );
-  sa->sin_port        = 0; /* ignored */
+  sa->sin_addr.s_addr = daddr;
+  sa->sin_port        = is_dgram ? udp_hdr->net_dport : 0; /* ignored by SOCK_RAW */
 
   cmsg->cmsg_level = IPPROTO_IP;
   cmsg->cmsg_type  = IP_PKTINFO;
@@ -597,7 +934,7 @@ during_frag( fd_sock_tile_t * ctx,
   struct in_pktinfo * pi = (struct in_pktinfo *)CMSG_DATA( cmsg );
   pi->ipi_ifindex         = 0;
   pi->ipi_addr.s_addr     = 0;
-  pi->ipi_spec_dst.s_addr = fd_uint_if( !!ip_hdr->saddr, ip_hdr->saddr, ctx->bind_address );
+  pi->ipi_spec_dst.s_addr = spec_dst;
 
   *msg = (struct mmsghdr) {
     .msg_hdr = {
@@ -609,10 +946,7 @@ during_frag( fd_sock_tile_t * ctx,
       .msg_controllen = CMSG_LEN( sizeof(struct in_pktinfo) )
     }
   };
-
-  memcpy( buf, udp_hdr, sizeof(fd_udp_hdr_t) );
-  fd_memcpy( buf+sizeof(fd_udp_hdr_t), payload, payload_sz );
-  ctx->metrics.tx_bytes_total += sz;
+  ctx->batch_sock[ msg_idx ] = (uchar)sock_idx;
 }
 
 /* after_frag is called when a frag was copied into a sendmmsg buffer. */
@@ -628,6 +962,34 @@ after_frag( fd_sock_tile_t *    ctx,
             fd_stem_context_t * stem   FD_PARAM_UNUSED ) {
   /* Commit the packet added in during_frag */
 
+  ulong payload_sz = ctx->batch_iov[ ctx->batch_cnt ].iov_len;
+
+  if( ctx->tx_gso_join ) {
+    /* Append a segment to the last message.  The kernel splits the
+       message payload into tx_gso_seg_sz sized packets, so the run
+       ends as soon as a shorter packet was appended. */
+    struct msghdr * msg_hdr = &ctx->batch_msg[ ctx->batch_msg_cnt-1UL ].msg_hdr;
+    if( msg_hdr->msg_iovlen==1UL ) {
+      struct cmsghdr * cmsg = (struct cmsghdr *)( (ulong)msg_hdr->msg_control + CMSG_SPACE( sizeof(struct in_pktinfo) ) );
+      cmsg->cmsg_level = SOL_UDP;
+      cmsg->cmsg_type  = UDP_SEGMENT;
+      cmsg->cmsg_len   = CMSG_LEN( sizeof(ushort) );
+      FD_STORE( ushort, CMSG_DATA( cmsg ), (ushort)ctx->tx_gso_seg_sz );
+      msg_hdr->msg_controllen = CMSG_SPACE( sizeof(struct in_pktinfo) ) + CMSG_SPACE( sizeof(ushort) );
+    }
+    msg_hdr->msg_iovlen++;
+    ctx->tx_gso_tot_sz += payload_sz;
+    if( payload_sz<ctx->tx_gso_seg_sz ) ctx->tx_gso_seg_sz = 0UL;
+  } else {
+    uint sock_idx = ctx->batch_sock[ ctx->batch_msg_cnt ];
+    ctx->batch_sock_set |= 1U<<sock_idx;
+    ctx->batch_msg_cnt++;
+    /* Start a new GSO run */
+    int gso_ok = (sock_idx<FD_SOCK_TILE_MAX_SOCKETS) & (payload_sz>0UL) & (payload_sz<=FD_SOCK_GSO_SEG_MAX);
+    ctx->tx_gso_seg_sz = gso_ok ? payload_sz : 0UL;
+    ctx->tx_gso_tot_sz = payload_sz;
+  }
+
   ctx->tx_idle_cnt = 0;
   ctx->batch_cnt++;
   /* Technically leaves a gap.  sz is always larger than the payload
@@ -649,6 +1011,12 @@ after_credit( fd_sock_tile_t *    ctx,
               fd_stem_context_t * stem,
               int *               poll_in FD_PARAM_UNUSED,
               int *               charge_busy ) {
+  if( FD_UNLIKELY( ctx->gro_msg_idx<ctx->gro_msg_cnt ) ) {
+    /* Finish de-segmenting the previous GRO batch before polling */
+    drain_rx_gro( ctx, stem );
+    *charge_busy = 1;
+    return;
+  }
   if( ctx->tx_idle_cnt > 512 ) {
     if( ctx->batch_cnt ) {
       flush_tx_batch( ctx );
@@ -668,6 +1036,8 @@ metrics_write( fd_sock_tile_t * ctx ) {
   FD_MCNT_SET( SOCK, TX_DROP_CNT,             ctx->metrics.tx_drop_cnt          );
   FD_MCNT_SET( SOCK, TX_BYTES_TOTAL,          ctx->metrics.tx_bytes_total       );
   FD_MCNT_SET( SOCK, RX_BYTES_TOTAL,          ctx->metrics.rx_bytes_total       );
+  FD_MCNT_SET( SOCK, TX_GSO_CNT,              ctx->metrics.tx_gso_cnt           );
+  FD_MCNT_SET( SOCK, RX_GRO_CNT,              ctx->metrics.rx_gro_cnt           );
 }
 
 static ulong
@@ -23,6 +23,20 @@
 
 #define MAX_NET_OUTS (5UL)
 
+/* FD_SOCK_GRO_BUF_SZ is the receive buffer size of each message in a
+   UDP_GRO batch.  A coalesced datagram is at most 64 KiB. */
+
+#define FD_SOCK_GRO_BUF_SZ (65536UL)
+
+/* FD_SOCK_GSO_SEG_MAX is the max segment size of a UDP_SEGMENT (GSO)
+   message.  Packets larger than this are sent individually.  This is
+   the Solana packet size limit (the IPv6 minimum MTU of 1280 bytes
+   minus IPv6 and UDP headers), so segments fit any sane path MTU.
+   FD_SOCK_GSO_SZ_MAX is the max total payload size of a GSO message. */
+
+#define FD_SOCK_GSO_SEG_MAX (1232UL)
+#define FD_SOCK_GSO_SZ_MAX  (65507UL)
+
 /* Local metrics.  Periodically copied to the metric_in shm region. */
 
 struct fd_sock_tile_metrics {
@@ -33,6 +47,8 @@ struct fd_sock_tile_metrics {
   ulong tx_drop_cnt;
   ulong rx_bytes_total;
   ulong tx_bytes_total;
+  ulong tx_gso_cnt;
+  ulong rx_gro_cnt;
 };
 
 typedef struct fd_sock_tile_metrics fd_sock_tile_metrics_t;
@@ -56,6 +72,20 @@ struct fd_sock_link_rx {
 
 typedef struct fd_sock_link_rx fd_sock_link_rx_t;
 
+/* fd_sock_gro_msg_t describes a datagram received with UDP_GRO enabled
+   that is pending de-segmentation.  The datagram consists of
+   ceil(sz/seg_sz) packets, all of size seg_sz except for the last. */
+
+struct fd_sock_gro_msg {
+  uint   saddr;  /* network byte order */
+  uint   daddr;  /* network byte order */
+  ushort sport;  /* network byte order */
+  ushort seg_sz;
+  uint   sz;
+};
+
+typedef struct fd_sock_gro_msg fd_sock_gro_msg_t;
+
 struct fd_sock_tile {
   /* RX SOCK_DGRAM sockets */
   struct pollfd pollfd[ FD_SOCK_TILE_MAX_SOCKETS ];
@@ -67,13 +97,42 @@ struct fd_sock_tile {
   uint tx_idle_cnt;
   uint bind_address;
 
+  /* UDP_SEGMENT and UDP_GRO support.  GSO messages cannot be sent via
+     the SOCK_RAW socket, so they are sent via the RX socket bound to
+     the packet's source port instead. */
+  int udp_gso;
+  int udp_gro;
+
   /* RX/TX batches
      FIXME transpose arrays for better cache locality? */
-  ulong                batch_cnt; /* <=STEM_BURST */
+  ulong                batch_cnt;      /* <=STEM_BURST, packet count (iov) */
+  ulong                batch_msg_cnt;  /* <=batch_cnt, message count */
+  uint                 batch_sock_set; /* bit set of batch_sock values in use */
   struct iovec *       batch_iov;
   void *               batch_cmsg;
   struct sockaddr_in * batch_sa;
   struct mmsghdr *     batch_msg;
+  uchar *              batch_sock;     /* per message, RX socket index or FD_SOCK_TILE_MAX_SOCKETS for tx_sock */
+  struct mmsghdr *     batch_msg_tmp;  /* gather buffer for flushing to multiple sockets */
+
+  /* TX GSO state.  The last message in the batch can absorb more
+     packets of size <=tx_gso_seg_sz while tx_gso_seg_sz!=0.
+     tx_gso_join is set by during_frag if the pending packet should be
+     appended to the last message. */
+  ulong tx_gso_seg_sz;
+  ulong tx_gso_tot_sz;
+  int   tx_gso_join;
+
+  /* RX GRO state.  A recvmmsg batch can expand into more packets than
+     fit in one tango burst, so de-segmentation resumes across
+     after_credit calls until gro_msg_idx==gro_msg_cnt. */
+  fd_sock_gro_msg_t * gro_msg;      /* STEM_BURST entries */
+  uchar *             gro_buf;      /* STEM_BURST*FD_SOCK_GRO_BUF_SZ bytes */
+  ulong               gro_msg_cnt;
+  ulong               gro_msg_idx;
+  ulong               gro_seg_off;  /* byte offset into gro_msg[ gro_msg_idx ] */
+  uint                gro_sock_idx;
+  long                gro_ts;
 
   /* RX links */
   ushort            rx_sock_port[ FD_SOCK_TILE_MAX_SOCKETS ];
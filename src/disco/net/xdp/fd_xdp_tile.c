@@ -996,6 +996,8 @@ net_rx_packet( fd_net_ctx_t * ctx,
 
   /* tile can decide how to partition based on src ip addr and src port */
   ulong sig              = fd_disco_netmux_sig( ip_srcaddr, udp_srcport, ip_srcaddr, proto, 14UL+8UL+iplen );
+  /* QUIC packets with a steered conn ID go to the owning quic tile */
+  sig                    = fd_net_rx_steer_sig( sig, udp+sizeof(fd_udp_hdr_t), (ulong)( packet_end-(udp+sizeof(fd_udp_hdr_t)) ) );
 
   /* Peek the mline for an old frame */
   fd_frag_meta_t * mline = out->mcache + fd_mcache_line_idx( out->seq, out->depth );
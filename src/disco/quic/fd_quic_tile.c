@@ -575,11 +575,34 @@ unprivileged_init( fd_topo_t *      topo,
     FD_LOG_ERR(( "Invalid `ack_delay_millis`: must be lower than `idle_timeout_millis`" ));
   }
 
+  /* Packets from a net tile are split among the quic tiles consuming
+     that net tile.  All net tiles this tile consumes from have the same
+     set of quic consumers (see fd_topos_tile_in_net_rx), so derive the
+     round robin position from the first input link. */
+  ctx->round_robin_cnt = 0UL;
+  ctx->round_robin_id  = ULONG_MAX;
+  for( ulong i=0UL; i<topo->tile_cnt; i++ ) {
+    fd_topo_tile_t const * peer = &topo->tiles[ i ];
+    if( strcmp( peer->name, tile->name ) ) continue;
+    int consumes = 0;
+    for( ulong j=0UL; j<peer->in_cnt; j++ ) consumes |= peer->in_link_id[ j ]==tile->in_link_id[ 0 ];
+    if( !consumes ) continue;
+    if( peer==tile ) ctx->round_robin_id = ctx->round_robin_cnt;
+    ctx->round_robin_cnt++;
+  }
+  if( FD_UNLIKELY( ctx->round_robin_id >= ctx->round_robin_cnt ) ) {
+    FD_LOG_ERR(( "invalid round robin configuration" ));
+  }
+
   quic->config.role                       = FD_QUIC_ROLE_SERVER;
   quic->config.idle_timeout               = tile->quic.idle_timeout_millis * (long)1e6;
   quic->config.ack_delay                  = tile->quic.ack_delay_millis    * (long)1e6;
   quic->config.initial_rx_max_stream_data = FD_TXN_MTU;
   quic->config.retry                      = tile->quic.retry;
+  /* Tag conn IDs with the round robin position, so that net tiles can
+     steer a conn's packets to this tile (see fd_net_rx_steer_sig) */
+  quic->config.steer                      = ctx->round_robin_cnt<=256UL;
+  quic->config.steer_idx                  = (uint)ctx->round_robin_id;
   fd_memcpy( quic->config.identity_public_key, ctx->tls_pub_key, ED25519_PUB_KEY_SZ );
 
   quic->config.sign         = quic_tls_cv_sign;
@@ -609,12 +632,6 @@ unprivileged_init( fd_topo_t *      topo,
 
   ctx->quic = quic;
 
-  ctx->round_robin_cnt = fd_topo_tile_name_cnt( topo, tile->name );
-  ctx->round_robin_id  = tile->kind_id;
-  if( FD_UNLIKELY( ctx->round_robin_id >= ctx->round_robin_cnt ) ) {
-    FD_LOG_ERR(( "invalid round robin configuration" ));
-  }
-
   ulong scratch_top = FD_SCRATCH_ALLOC_FINI( l, 1UL );
   if( FD_UNLIKELY( scratch_top > (ulong)scratch + scratch_footprint( tile ) ) )
     FD_LOG_ERR(( "scratch overflow %lu %lu %lu", scratch_top - (ulong)scratch - scratch_footprint( tile ), scratch_top, (ulong)scratch + scratch_footprint( tile ) ));
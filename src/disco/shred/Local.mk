@@ -1,5 +1,6 @@
 ifdef FD_HAS_INT128
 $(call add-objs,fd_shred_dest,fd_disco)
+$(call add-objs,fd_shred_dest_cache,fd_disco)
 $(call add-objs,fd_shredder,fd_disco)
 $(call add-objs,fd_fec_resolver,fd_disco)
 $(call add-objs,fd_stake_ci,fd_disco)
@@ -0,0 +1,160 @@
+#include "fd_shred_dest_cache.h"
+
+ulong
+fd_shred_dest_cache_footprint( ulong idx_max,
+                               ulong pool_max ) {
+  return FD_LAYOUT_FINI( FD_LAYOUT_APPEND( FD_LAYOUT_APPEND( FD_LAYOUT_APPEND(
+                FD_LAYOUT_INIT,
+                fd_shred_dest_cache_align(),          sizeof(fd_shred_dest_cache_t)                  ),
+                alignof(fd_shred_dest_cache_entry_t), sizeof(fd_shred_dest_cache_entry_t)*2UL*idx_max ),
+                alignof(fd_shred_dest_idx_t),         sizeof(fd_shred_dest_idx_t)*pool_max            ),
+      FD_SHRED_DEST_CACHE_ALIGN );
+}
+
+void *
+fd_shred_dest_cache_new( void * mem,
+                         ulong  idx_max,
+                         ulong  pool_max ) {
+
+  if( FD_UNLIKELY( !mem ) ) {
+    FD_LOG_WARNING(( "NULL mem" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !fd_ulong_is_aligned( (ulong)mem, fd_shred_dest_cache_align() ) ) ) {
+    FD_LOG_WARNING(( "misaligned mem" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( (idx_max==0UL) | (idx_max>FD_SHRED_BLK_MAX) ) ) {
+    FD_LOG_WARNING(( "idx_max %lu out of range [1,%lu]", idx_max, (ulong)FD_SHRED_BLK_MAX ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( (pool_max==0UL) | (pool_max>(ulong)UINT_MAX) ) ) {
+    FD_LOG_WARNING(( "pool_max %lu out of range [1,%lu]", pool_max, (ulong)UINT_MAX ));
+    return NULL;
+  }
+
+  FD_SCRATCH_ALLOC_INIT( footprint, mem );
+  fd_shred_dest_cache_t       * cache = FD_SCRATCH_ALLOC_APPEND( footprint, fd_shred_dest_cache_align(),          sizeof(fd_shred_dest_cache_t)                  );
+  fd_shred_dest_cache_entry_t * entry = FD_SCRATCH_ALLOC_APPEND( footprint, alignof(fd_shred_dest_cache_entry_t), sizeof(fd_shred_dest_cache_entry_t)*2UL*idx_max );
+  fd_shred_dest_idx_t         * pool  = FD_SCRATCH_ALLOC_APPEND( footprint, alignof(fd_shred_dest_idx_t),         sizeof(fd_shred_dest_idx_t)*pool_max            );
+  FD_SCRATCH_ALLOC_FINI( footprint, FD_SHRED_DEST_CACHE_ALIGN );
+
+  cache->sdest     = NULL;
+  cache->slot      = ULONG_MAX;
+  cache->fanout    = 0UL;
+  cache->done      = 1;
+  cache->full      = 1;
+  cache->idx_max   = idx_max;
+  cache->pool_max  = pool_max;
+  cache->pool_cnt  = 0UL;
+  cache->built_cnt = 0UL;
+  cache->want_cnt  = 0UL;
+  cache->entry     = entry;
+  cache->pool      = pool;
+
+  return mem;
+}
+
+fd_shred_dest_cache_t *
+fd_shred_dest_cache_join( void * mem ) {
+  if( FD_UNLIKELY( !mem ) ) {
+    FD_LOG_WARNING(( "NULL mem" ));
+    return NULL;
+  }
+  return (fd_shred_dest_cache_t *)mem;
+}
+
+void * fd_shred_dest_cache_leave ( fd_shred_dest_cache_t * cache ) { return (void *)cache; }
+void * fd_shred_dest_cache_delete( void                  * mem   ) { return mem;           }
+
+fd_shred_dest_cache_t *
+fd_shred_dest_cache_reset( fd_shred_dest_cache_t * cache,
+                           fd_shred_dest_t       * sdest,
+                           ulong                   slot,
+                           ulong                   fanout ) {
+  cache->sdest     = NULL;
+  cache->slot      = slot;
+  cache->fanout    = fanout;
+  cache->done      = 1;
+  cache->full      = 1;
+  cache->pool_cnt  = 0UL;
+  cache->built_cnt = 0UL;
+  cache->want_cnt  = 0UL;
+
+  if( FD_UNLIKELY( !sdest ) ) return cache;
+
+  fd_pubkey_t const * leader = fd_epoch_leaders_get( sdest->lsched, slot );
+  if( FD_UNLIKELY( !leader ) ) return cache;
+
+  int is_leader = fd_shred_dest_pubkey_to_idx( sdest, leader )==sdest->source_validator_orig_idx;
+  cache->sdest  = sdest;
+  cache->fanout = fd_ulong_if( is_leader, 0UL, fanout );
+  cache->full   = 0;
+  return cache;
+}
+
+ulong
+fd_shred_dest_cache_build( fd_shred_dest_cache_t * cache,
+                           ulong                   batch_cnt ) {
+  if( FD_UNLIKELY( cache->done ) ) return 0UL;
+
+  batch_cnt = fd_ulong_min( fd_ulong_min( batch_cnt, FD_SHRED_DEST_CACHE_BATCH_MAX ), cache->want_cnt-cache->built_cnt );
+  if( FD_UNLIKELY( !batch_cnt ) ) {
+    cache->done = 1;
+    return 0UL;
+  }
+
+  /* The destinations only depend on the slot, type, and index of each
+     shred, so that's all we fill in.  Shreds 2i and 2i+1 are the data
+     and parity shreds (respectively) with index built_cnt+i. */
+  fd_shred_t         shreds [ 2UL*FD_SHRED_DEST_CACHE_BATCH_MAX ];
+  fd_shred_t const * pshreds[ 2UL*FD_SHRED_DEST_CACHE_BATCH_MAX ];
+  ulong shred_cnt = 2UL*batch_cnt;
+  for( ulong i=0UL; i<shred_cnt; i++ ) {
+    shreds[ i ].slot    = cache->slot;
+    shreds[ i ].variant = fd_shred_variant( (i&1UL) ? FD_SHRED_TYPE_MERKLE_CODE : FD_SHRED_TYPE_MERKLE_DATA, 0 );
+    shreds[ i ].idx     = (uint)(cache->built_cnt + (i>>1));
+    pshreds[ i ] = shreds+i;
+  }
+
+  fd_shred_dest_idx_t * dests;
+  ulong max_dest_cnt;
+  if( !cache->fanout ) {
+    max_dest_cnt = 1UL;
+    dests = fd_shred_dest_compute_first   ( cache->sdest, pshreds, shred_cnt, cache->scratch );
+  } else {
+    dests = fd_shred_dest_compute_children( cache->sdest, pshreds, shred_cnt, cache->scratch, shred_cnt,
+                                            cache->fanout, cache->fanout, &max_dest_cnt );
+  }
+  if( FD_UNLIKELY( !dests ) ) {
+    cache->done = cache->full = 1;
+    return 0UL;
+  }
+
+  /* Stop if the batch might not fit, rather than adding part of it. */
+  if( FD_UNLIKELY( cache->pool_cnt + shred_cnt*max_dest_cnt > cache->pool_max ) ) {
+    cache->done = cache->full = 1;
+    return 0UL;
+  }
+
+  /* Transpose into the pool, dropping the NO_DEST padding. */
+  ulong pool_cnt = cache->pool_cnt;
+  for( ulong i=0UL; i<shred_cnt; i++ ) {
+    ulong off = pool_cnt;
+    for( ulong j=0UL; j<max_dest_cnt; j++ ) {
+      fd_shred_dest_idx_t d = dests[ j*shred_cnt + i ];
+      cache->pool[ pool_cnt ] = d;
+      pool_cnt += (ulong)(d!=FD_SHRED_DEST_NO_DEST);
+    }
+    cache->entry[ 2UL*cache->built_cnt + i ] = (fd_shred_dest_cache_entry_t){ .off = (uint)off, .cnt = (uint)(pool_cnt-off) };
+  }
+  cache->pool_cnt   = pool_cnt;
+  cache->built_cnt += batch_cnt;
+  cache->full       = cache->built_cnt==cache->idx_max;
+  cache->done       = cache->built_cnt==cache->want_cnt;
+
+  return batch_cnt;
+}
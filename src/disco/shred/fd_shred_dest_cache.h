@@ -0,0 +1,164 @@
+#ifndef HEADER_fd_src_disco_shred_fd_shred_dest_cache_h
+#define HEADER_fd_src_disco_shred_fd_shred_dest_cache_h
+
+/* fd_shred_dest_cache provides a per-slot table of precomputed Turbine
+   destinations.
+
+   The destinations of a shred only depend on (slot, shred type, shred
+   index, leader) and on the stake weights/contact info in the
+   fd_shred_dest_t object, so they can be computed before the shred
+   exists.  Computing them is expensive (a ChaCha20-seeded weighted
+   shuffle per shred, see fd_shred_dest.h), and it is on the critical
+   path of retransmitting a shred.
+
+   A cache is reset for an upcoming slot (typically the slot after the
+   one currently being received or produced), and then filled in
+   incrementally with fd_shred_dest_cache_build, a few shreds at a time,
+   while the tile has nothing better to do.  The table is only built up
+   to the number of shred indices the caller asked for with
+   fd_shred_dest_cache_want, which the caller raises as it sees shreds
+   with higher indices, so a small block costs about as many
+   computations as it has shreds.  Once the slot starts, the
+   destinations of the shreds with the lowest indices (which is most
+   of them for a typical block) are a table lookup.  Shreds that are not
+   in the table (large shred index, table still being built, or out of
+   pool space) fall back to computing destinations directly.
+
+   The cache does not know when the fd_shred_dest_t object it was built
+   from changes (e.g. new contact info re-creates the object in place),
+   so the caller must call fd_shred_dest_cache_reset whenever that
+   happens. */
+
+#include "fd_shred_dest.h"
+
+#define FD_SHRED_DEST_CACHE_ALIGN (128UL)
+
+/* FD_SHRED_DEST_CACHE_BATCH_MAX is the max number of shreds for which
+   fd_shred_dest_cache_build computes destinations per call. */
+
+#define FD_SHRED_DEST_CACHE_BATCH_MAX (8UL)
+
+struct fd_shred_dest_cache_entry {
+  uint off; /* index of the first destination in the pool */
+  uint cnt; /* number of destinations */
+};
+typedef struct fd_shred_dest_cache_entry fd_shred_dest_cache_entry_t;
+
+struct __attribute__((aligned(FD_SHRED_DEST_CACHE_ALIGN))) fd_shred_dest_cache_private {
+  fd_shred_dest_t * sdest;     /* object the table is built from, NULL if the cache is empty */
+  ulong             slot;
+  ulong             fanout;    /* 0 if the source is the leader of slot (compute_first) */
+  int               done;      /* 1 if there is nothing left to build (until want_cnt is raised) */
+  int               full;      /* 1 if the table cannot grow anymore */
+
+  ulong idx_max;               /* number of shred indices per shred type the table can hold */
+  ulong pool_max;              /* number of destinations the pool can hold */
+  ulong pool_cnt;              /* number of destinations used in the pool */
+  ulong built_cnt;             /* shred indices [0,built_cnt) of both types are in the table */
+  ulong want_cnt;              /* build up to shred index want_cnt, in [built_cnt,idx_max] unless full */
+
+  fd_shred_dest_cache_entry_t * entry; /* indexed [ 2*idx + is_code ] */
+  fd_shred_dest_idx_t         * pool;
+
+  fd_shred_dest_idx_t scratch[ FD_SHRED_DEST_MAX_FANOUT*2UL*FD_SHRED_DEST_CACHE_BATCH_MAX ];
+  /* Struct followed by:
+     * entry
+     * pool
+   */
+};
+typedef struct fd_shred_dest_cache_private fd_shred_dest_cache_t;
+
+FD_PROTOTYPES_BEGIN
+
+/* fd_shred_dest_cache_{align, footprint} return the alignment and
+   footprint (respectively) required of a region of memory to format it
+   as an fd_shred_dest_cache_t object.  idx_max is the number of shred
+   indices (of each of the data and parity types) the table can hold.
+   pool_max is the total number of destinations the table can hold
+   across all shreds.  A leader needs 1 destination per shred, other
+   validators need up to fanout destinations per shred for which they
+   are in the first layer of the Turbine tree. */
+FD_FN_CONST static inline ulong fd_shred_dest_cache_align( void ) { return FD_SHRED_DEST_CACHE_ALIGN; }
+FD_FN_CONST ulong fd_shred_dest_cache_footprint( ulong idx_max, ulong pool_max );
+
+/* fd_shred_dest_cache_new formats a region of memory for use as an
+   fd_shred_dest_cache_t object.  idx_max must be in [1,
+   FD_SHRED_BLK_MAX] and pool_max in [1,UINT_MAX].  The cache starts
+   empty.  Returns mem on success and NULL on failure (logs details).
+   fd_shred_dest_cache_{join, leave, delete} are the usual. */
+void *                  fd_shred_dest_cache_new   ( void * mem, ulong idx_max, ulong pool_max );
+fd_shred_dest_cache_t * fd_shred_dest_cache_join  ( void * mem );
+void *                  fd_shred_dest_cache_leave ( fd_shred_dest_cache_t * cache );
+void *                  fd_shred_dest_cache_delete( void * mem );
+
+/* fd_shred_dest_cache_reset discards the contents of the cache and
+   prepares it to be built for shreds of the given slot, using sdest
+   and a Turbine tree with the given fanout (as in
+   fd_shred_dest_compute_children, ignored and treated as 0 if the
+   source validator of sdest is the leader of slot).  sdest==NULL (e.g. the slot is in an
+   unknown epoch) leaves the cache empty.  Nothing is built until the
+   caller asks for some shred indices with fd_shred_dest_cache_want.
+   The cache retains a read interest in sdest until the next reset.
+   Returns cache. */
+fd_shred_dest_cache_t *
+fd_shred_dest_cache_reset( fd_shred_dest_cache_t * cache,
+                           fd_shred_dest_t       * sdest,
+                           ulong                   slot,
+                           ulong                   fanout );
+
+/* fd_shred_dest_cache_want asks for the table to hold (at least) shred
+   indices [0,idx_cnt), clamped to idx_max.  It never shrinks what was
+   asked for since the last reset.  This is cheap and meant to be
+   called for every shred received or produced, with an idx_cnt a bit
+   past the shred's index. */
+static inline void
+fd_shred_dest_cache_want( fd_shred_dest_cache_t * cache,
+                          ulong                   idx_cnt ) {
+  if( FD_LIKELY( idx_cnt<=cache->want_cnt ) ) return;
+  cache->want_cnt = fd_ulong_min( idx_cnt, cache->idx_max );
+  cache->done     = cache->full | (cache->built_cnt>=cache->want_cnt);
+}
+
+/* fd_shred_dest_cache_build computes the destinations of the next
+   batch of shreds (data and parity shreds with the same index are
+   computed together) and adds them to the table.  batch_cnt in [1,
+   FD_SHRED_DEST_CACHE_BATCH_MAX] is the max number of shred indices to
+   compute.  Returns the number of shred indices added, which is 0 once
+   the table holds everything that was asked for, or cannot grow (all
+   idx_max indices computed, pool full, or the destinations cannot be
+   computed). */
+ulong
+fd_shred_dest_cache_build( fd_shred_dest_cache_t * cache,
+                           ulong                   batch_cnt );
+
+/* fd_shred_dest_cache_done returns 1 if there is nothing left to build
+   in cache and 0 otherwise. */
+FD_FN_PURE static inline int fd_shred_dest_cache_done( fd_shred_dest_cache_t const * cache ) { return cache->done; }
+
+/* fd_shred_dest_cache_query returns the precomputed destinations of
+   shred, as fd_shred_dest_compute_children (with dest_cnt==fanout)
+   would compute them with sdest, with the FD_SHRED_DEST_NO_DEST
+   padding removed.  fanout==0 queries the destinations as
+   fd_shred_dest_compute_first would compute them instead, which is
+   only available if the source is the leader of shred's slot.  On
+   return, *dest_cnt holds the number of destinations.  Returns NULL (a
+   miss) if the table was not built with sdest for shred's slot and
+   fanout, or does not (yet) contain shred.  The returned pointer is
+   valid until the next reset. */
+static inline fd_shred_dest_idx_t const *
+fd_shred_dest_cache_query( fd_shred_dest_cache_t const * cache,
+                           fd_shred_dest_t const       * sdest,
+                           fd_shred_t const            * shred,
+                           ulong                         fanout,
+                           ulong                       * dest_cnt ) {
+  if( FD_UNLIKELY( (cache->sdest!=sdest) | (cache->slot!=shred->slot) |
+                   (cache->fanout!=fanout) | (shred->idx>=cache->built_cnt) ) ) return NULL;
+  ulong is_code = (ulong)fd_shred_is_code( fd_shred_type( shred->variant ) );
+  fd_shred_dest_cache_entry_t const * e = cache->entry + 2UL*shred->idx + is_code;
+  *dest_cnt = e->cnt;
+  return cache->pool + e->off;
+}
+
+FD_PROTOTYPES_END
+
+#endif /* HEADER_fd_src_disco_shred_fd_shred_dest_cache_h */
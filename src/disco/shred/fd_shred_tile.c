@@ -5,6 +5,7 @@
 #include "../shred/fd_shredder.h"
 #include "../shred/fd_shred_batch.h"
 #include "../shred/fd_shred_dest.h"
+#include "../shred/fd_shred_dest_cache.h"
 #include "../shred/fd_fec_resolver.h"
 #include "../shred/fd_stake_ci.h"
 #include "../store/fd_store.h"
@@ -94,6 +95,7 @@
 #define IN_KIND_REPAIR  (5UL)
 #define IN_KIND_IPECHO  (6UL)
 #define IN_KIND_GOSSIP  (7UL)
+#define IN_KIND_STAGE   (8UL)
 
 #define NET_OUT_IDX     1
 #define SIGN_OUT_IDX    2
@@ -117,6 +119,30 @@ FD_STATIC_ASSERT( sizeof(fd_entry_batch_meta_t)==56UL, poh_shred_mtu );
    See also comment on chained_merkle_root. */
 #define BLOCK_IDS_TABLE_CNT USHORT_MAX
 
+/* The Turbine destinations of the data and parity shreds of the
+   current and the next slot are precomputed (see
+   fd_shred_dest_cache.h).  The table for a slot starts out with the
+   first DEST_CACHE_IDX_INIT shred indices, and is then filled in
+   lazily up to DEST_CACHE_IDX_AHEAD indices past the highest index we
+   have seen for the slot, so small blocks cost about as much as they
+   have shreds.  DEST_CACHE_IDX_MAX is a few times the shred count of a
+   typical mainnet block, larger blocks fall back to computing the
+   destinations of their last shreds directly.  Each run loop iteration
+   computes at most DEST_CACHE_BUILD_BATCH shred indices so that
+   building the table does not meaningfully delay incoming frags.
+   DEST_CACHE_POOL_MAX bounds the memory used by the table when we
+   have many children at a large fanout. */
+#define DEST_CACHE_IDX_MAX     (2048UL)
+#define DEST_CACHE_IDX_INIT    (64UL)
+#define DEST_CACHE_IDX_AHEAD   (64UL)
+#define DEST_CACHE_POOL_MAX    (1UL<<20)
+#define DEST_CACHE_BUILD_BATCH (2UL)
+
+/* Turbine shreds for a slot more than DEST_CACHE_REWIND_MAX slots
+   behind dest_cache_slot move the cache back, which recovers from
+   having been sent a shred for a slot far in the future. */
+#define DEST_CACHE_REWIND_MAX  (512UL)
+
 /* See note on parallelization above. Currently we process all batches in tile 0. */
 #if 1
 #define SHOULD_PROCESS_THESE_SHREDS ( ctx->round_robin_id==0 )
@@ -165,6 +191,18 @@ typedef struct {
   fd_fec_set_t       * fec_sets;
 
   fd_stake_ci_t      * stake_ci;
+
+  /* dest_cache[ s&1 ] holds the precomputed Turbine destinations for
+     slot s, for s in {dest_cache_slot, dest_cache_slot+1}, where
+     dest_cache_slot is the most recent slot we've been sent shreds for
+     or have been leader for (ULONG_MAX if none yet).
+     dest_cache_{seq,fanout}[ i ] are the stake_ci sdest sequence
+     number and the Turbine fanout dest_cache[ i ] was reset with. */
+  fd_shred_dest_cache_t * dest_cache[ 2 ];
+  ulong                   dest_cache_seq[ 2 ];
+  ulong                   dest_cache_fanout[ 2 ];
+  ulong                   dest_cache_slot;
+
   /* These are used in between during_frag and after_frag */
   fd_shred_dest_weighted_t * new_dest_ptr;
   ulong                      new_dest_cnt;
@@ -234,6 +272,8 @@ typedef struct {
     ulong shred_rejected_unchained_cnt;
     ulong repair_rcv_cnt;
     ulong turbine_rcv_cnt;
+    ulong dest_cache_hit_cnt;
+    ulong dest_cache_miss_cnt;
     fd_histf_t store_insert_wait[ 1 ];
     fd_histf_t store_insert_work[ 1 ];
   } metrics[ 1 ];
@@ -278,11 +318,141 @@ scratch_footprint( fd_topo_tile_t const * tile ) {
   l = FD_LAYOUT_APPEND( l, fd_fec_resolver_align(),          fec_resolver_footprint                  );
   l = FD_LAYOUT_APPEND( l, fd_shredder_align(),              fd_shredder_footprint()                 );
   l = FD_LAYOUT_APPEND( l, alignof(fd_fec_set_t),            sizeof(fd_fec_set_t)*fec_set_cnt        );
+  for( ulong i=0UL; i<2UL; i++ ) {
+    l = FD_LAYOUT_APPEND( l, fd_shred_dest_cache_align(),    fd_shred_dest_cache_footprint( DEST_CACHE_IDX_MAX, DEST_CACHE_POOL_MAX ) );
+  }
   return FD_LAYOUT_FINI( l, scratch_align() );
 }
 
+/* turbine_fanout returns the Turbine fanout to use for shreds of the
+   given slot.  Fanout is subject to feature activation.  The code below
+   replicates Agave's get_data_plane_fanout() in
+   turbine/src/cluster_nodes.rs on 2025-03-25.  Default Agave's
+   DATA_PLANE_FANOUT = 200UL.
+   TODO once the experiments are disabled, consider removing these
+   fanout variations from the code. */
+
+static inline ulong
+turbine_fanout( fd_shred_ctx_t const * ctx,
+                ulong                  slot ) {
+  if( FD_LIKELY( slot >= ctx->features_activation->disable_turbine_fanout_experiments ) ) return 200UL;
+
+  if( FD_LIKELY( slot >= ctx->features_activation->enable_turbine_extended_fanout_experiments ) ) {
+    switch( slot % 359 ) {
+      case  11UL: return 1152UL;
+      case  61UL: return 1280UL;
+      case 111UL: return 1024UL;
+      case 161UL: return 1408UL;
+      case 211UL: return  896UL;
+      case 261UL: return 1536UL;
+      case 311UL: return  768UL;
+      default   : return  200UL;
+    }
+  } else {
+    switch( slot % 359 ) {
+      case  11UL: return   64UL;
+      case  61UL: return  768UL;
+      case 111UL: return  128UL;
+      case 161UL: return  640UL;
+      case 211UL: return  256UL;
+      case 261UL: return  512UL;
+      case 311UL: return  384UL;
+      default   : return  200UL;
+    }
+  }
+}
+
+static inline void
+dest_cache_reset( fd_shred_ctx_t * ctx,
+                  ulong            slot ) {
+  ulong i      = slot&1UL;
+  ulong fanout = turbine_fanout( ctx, slot );
+  ctx->dest_cache_seq   [ i ] = fd_stake_ci_get_sdest_seq_for_slot( ctx->stake_ci, slot );
+  ctx->dest_cache_fanout[ i ] = fanout;
+  fd_shred_dest_cache_reset( ctx->dest_cache[ i ], fd_stake_ci_get_sdest_for_slot( ctx->stake_ci, slot ), slot, fanout );
+  fd_shred_dest_cache_want( ctx->dest_cache[ i ], DEST_CACHE_IDX_INIT );
+}
+
+/* dest_cache_refresh discards the precomputed destinations of the
+   slots whose destination computations changed, and starts rebuilding
+   them.  Must be called whenever stake_ci changes (stake weights, the
+   set of known destinations, or our identity) or the Turbine fanout
+   might have changed.  Contact info updates that only change
+   addresses, or that only touch the other epoch, keep the caches. */
+
+static inline void
+dest_cache_refresh( fd_shred_ctx_t * ctx ) {
+  for( ulong i=0UL; i<2UL; i++ ) {
+    ulong slot = ctx->dest_cache[ i ]->slot;
+    if( FD_UNLIKELY( slot==ULONG_MAX ) ) continue;
+    if( FD_LIKELY( (ctx->dest_cache_seq   [ i ]==fd_stake_ci_get_sdest_seq_for_slot( ctx->stake_ci, slot )) &
+                   (ctx->dest_cache_fanout[ i ]==turbine_fanout( ctx, slot )) ) ) continue;
+    dest_cache_reset( ctx, slot );
+  }
+}
+
+/* dest_cache_advance notes that we've been sent a shred or have become
+   leader for the given slot, and starts precomputing the destinations
+   for the slot and the one after it, if we aren't already. */
+
+static inline void
+dest_cache_advance( fd_shred_ctx_t * ctx,
+                    ulong            slot ) {
+  ulong cur = ctx->dest_cache_slot;
+  if( FD_LIKELY( (cur!=ULONG_MAX) & (slot<=cur) & (cur-slot<=DEST_CACHE_REWIND_MAX) ) ) return;
+  ctx->dest_cache_slot = slot;
+  for( ulong s=slot; s<slot+2UL; s++ ) {
+    if( FD_UNLIKELY( ctx->dest_cache[ s&1UL ]->slot!=s ) ) dest_cache_reset( ctx, s );
+  }
+}
+
+/* dest_cache_query returns the destinations of shred, as in
+   fd_shred_dest_cache_query, or NULL if they haven't been precomputed.
+   It also asks for the table of shred's slot to be built a bit past
+   shred. */
+
+static inline fd_shred_dest_idx_t const *
+dest_cache_query( fd_shred_ctx_t *        ctx,
+                  fd_shred_dest_t const * sdest,
+                  fd_shred_t const *      shred,
+                  ulong                   fanout,
+                  ulong *                 dest_cnt ) {
+  fd_shred_dest_cache_t * cache = ctx->dest_cache[ shred->slot&1UL ];
+  if( FD_LIKELY( cache->slot==shred->slot ) ) fd_shred_dest_cache_want( cache, (ulong)shred->idx+1UL+DEST_CACHE_IDX_AHEAD );
+  fd_shred_dest_idx_t const * dests = fd_shred_dest_cache_query( cache, sdest, shred, fanout, dest_cnt );
+  ctx->metrics->dest_cache_hit_cnt  += (ulong)(!!dests);
+  ctx->metrics->dest_cache_miss_cnt += (ulong)( !dests);
+  return dests;
+}
+
+static inline void
+after_credit( fd_shred_ctx_t *    ctx,
+              fd_stem_context_t * stem,
+              int *               opt_poll_in,
+              int *               charge_busy ) {
+  (void)stem;
+  (void)opt_poll_in;
+
+  ulong slot = ctx->dest_cache_slot;
+  if( FD_UNLIKELY( slot==ULONG_MAX ) ) return;
+
+  /* Shreds of the current slot are arriving now, so keeping ahead of
+     them comes first.  The next slot only needs its first few indices
+     ready before it starts. */
+  fd_shred_dest_cache_t * cache = ctx->dest_cache[ slot&1UL ];
+  if( FD_LIKELY( fd_shred_dest_cache_done( cache ) ) ) cache = ctx->dest_cache[ (slot+1UL)&1UL ];
+  if( FD_LIKELY( fd_shred_dest_cache_done( cache ) ) ) return;
+
+  *charge_busy = 1;
+  fd_shred_dest_cache_build( cache, DEST_CACHE_BUILD_BATCH );
+}
+
 static inline void
 during_housekeeping( fd_shred_ctx_t * ctx ) {
+  /* Release FEC sets pruned by Replay's publish in case this tile has
+     not inserted anything lately (see fd_store_reclaim). */
+  if( FD_LIKELY( ctx->store ) ) fd_store_reclaim( ctx->store, ctx->round_robin_id );
+
   if( FD_UNLIKELY( fd_keyswitch_state_query( ctx->keyswitch )==FD_KEYSWITCH_STATE_SWITCH_PENDING ) ) {
     ulong seq_must_complete = ctx->keyswitch->param;
 
@@ -295,6 +465,7 @@ during_housekeeping( fd_shred_ctx_t * ctx ) {
 
     memcpy( ctx->identity_key->uc, ctx->keyswitch->bytes, 32UL );
     fd_stake_ci_set_identity( ctx->stake_ci, ctx->identity_key );
+    dest_cache_refresh( ctx );
     fd_keyswitch_state( ctx->keyswitch, FD_KEYSWITCH_STATE_COMPLETED );
   }
 }
@@ -308,6 +479,8 @@ metrics_write( fd_shred_ctx_t * ctx ) {
   FD_MHIST_COPY( SHRED, ADD_SHRED_DURATION_SECONDS, ctx->metrics->add_shred_timing             );
   FD_MCNT_SET  ( SHRED, SHRED_OUT_RCV,              ctx->metrics->repair_rcv_cnt               );
   FD_MCNT_SET  ( SHRED, SHRED_TURBINE_RCV,          ctx->metrics->turbine_rcv_cnt              );
+  FD_MCNT_SET  ( SHRED, DEST_CACHE_HIT,             ctx->metrics->dest_cache_hit_cnt           );
+  FD_MCNT_SET  ( SHRED, DEST_CACHE_MISS,            ctx->metrics->dest_cache_miss_cnt          );
 
   FD_MCNT_SET  ( SHRED, INVALID_BLOCK_ID,           ctx->metrics->invalid_block_id_cnt         );
   FD_MCNT_SET  ( SHRED, SHRED_REJECTED_UNCHAINED,   ctx->metrics->shred_rejected_unchained_cnt );
@@ -344,6 +517,20 @@ handle_new_cluster_contact_info( fd_shred_ctx_t * ctx,
 static inline void
 finalize_new_cluster_contact_info( fd_shred_ctx_t * ctx ) {
   fd_stake_ci_dest_add_fini( ctx->stake_ci, ctx->new_dest_cnt );
+  dest_cache_refresh( ctx );
+}
+
+/* fd_shred_sign_fec_set waits for the signature of the sign_idx-th FEC
+   set of the batch being shredded, and writes it into its shreds.
+   Signing requests are answered in order, so the caller must collect
+   signatures in increasing sign_idx. */
+
+static inline void
+fd_shred_sign_fec_set( fd_shred_ctx_t * ctx,
+                       ulong            sign_idx ) {
+  uchar signature[ FD_ED25519_SIG_SZ ];
+  fd_keyguard_client_sign_response( ctx->keyguard_client, signature );
+  fd_shredder_sign_fec_set( ctx->fec_sets + ctx->send_fec_set_idx[ sign_idx ], signature );
 }
 
 static inline int
@@ -426,6 +613,16 @@ during_frag( fd_shred_ctx_t * ctx,
     return;
   }
 
+  if( FD_UNLIKELY( ctx->in_kind[ in_idx ]==IN_KIND_STAGE ) ) {
+    if( FD_UNLIKELY( chunk<ctx->in[ in_idx ].chunk0 || chunk>ctx->in[ in_idx ].wmark ) )
+      FD_LOG_ERR(( "chunk %lu %lu corrupt, not in range [%lu,%lu]", chunk, sz,
+                   ctx->in[ in_idx ].chunk0, ctx->in[ in_idx ].wmark ));
+
+    uchar const * dcache_entry = fd_chunk_to_laddr_const( ctx->in[ in_idx ].mem, chunk );
+    fd_stake_ci_stake_msg_stage_init( ctx->stake_ci, fd_type_pun_const( dcache_entry ) );
+    return;
+  }
+
   if( FD_UNLIKELY( ctx->in_kind[ in_idx ]==IN_KIND_POH ) ) {
     ctx->send_fec_set_cnt = 0UL;
 
@@ -443,6 +640,7 @@ during_frag( fd_shred_ctx_t * ctx,
 
       fd_shred_features_activation_t const * act_data = (fd_shred_features_activation_t const *)dcache_entry;
       memcpy( ctx->features_activation, act_data, sizeof(fd_shred_features_activation_t) );
+      dest_cache_refresh( ctx ); /* fanout may have changed */
     }
     else { /* (fd_disco_poh_sig_pkt_type( sig )==POH_PKT_TYPE_MICROBLOCK) */
       /* This is a frag from the PoH tile.  We'll copy it to our pending
@@ -493,6 +691,7 @@ during_frag( fd_shred_ctx_t * ctx,
         /* Reset batch count if we are in a new slot */
         ctx->batch_cnt = 0UL;
         ctx->slot      = target_slot;
+        dest_cache_advance( ctx, target_slot );
 
         /* At the beginning of a new slot, prepare chained_merkle_root.
            chained_merkle_root is initialized at the block_id of the parent
@@ -599,6 +798,14 @@ during_frag( fd_shred_ctx_t * ctx,
 
           fd_shredder_init_batch( ctx->shredder, ctx->pending_batch.raw, batch_sz_padded, target_slot, entry_meta );
 
+          /* Merkle roots are signed asynchronously: a signing request
+             is sent as soon as an FEC set is produced, and responses
+             are collected while the next FEC sets are being computed.
+             The sign tile batches requests that arrive together. */
+          fd_keyguard_client_t * signer   = ctx->keyguard_client;
+          ulong                  sign_max = fd_keyguard_client_pending_max( signer );
+          ulong                  sign_idx = 0UL; /* next FEC set awaiting its signature */
+
           ulong pend_sz  = batch_sz_padded;
           ulong pend_idx = 0;
           while( pend_sz > 0UL ) {
@@ -607,6 +814,11 @@ during_frag( fd_shred_ctx_t * ctx,
 
             FD_TEST( fd_shredder_next_fec_set( ctx->shredder, out, chained_merkle_root, ctx->out_merkle_roots[pend_idx].hash ) );
 
+            if( FD_UNLIKELY( fd_keyguard_client_pending_cnt( signer )==sign_max ) ) {
+              fd_shred_sign_fec_set( ctx, sign_idx++ );
+            }
+            fd_keyguard_client_sign_request( signer, ctx->out_merkle_roots[pend_idx].hash, 32UL, FD_KEYGUARD_SIGN_TYPE_ED25519 );
+
             d_rcvd_join( d_rcvd_new( d_rcvd_delete( d_rcvd_leave( out->data_shred_rcvd   ) ) ) );
             p_rcvd_join( p_rcvd_new( p_rcvd_delete( p_rcvd_leave( out->parity_shred_rcvd ) ) ) );
 
@@ -618,6 +830,8 @@ during_frag( fd_shred_ctx_t * ctx,
             pend_idx++;
           }
 
+          while( sign_idx<ctx->send_fec_set_cnt ) fd_shred_sign_fec_set( ctx, sign_idx++ );
+
           fd_shredder_fini_batch( ctx->shredder );
           shredding_timing += fd_tickcount();
 
@@ -783,6 +997,14 @@ after_frag( fd_shred_ctx_t *    ctx,
 
   if( FD_UNLIKELY( ctx->in_kind[ in_idx ]==IN_KIND_STAKE ) ) {
     fd_stake_ci_stake_msg_fini( ctx->stake_ci );
+    dest_cache_refresh( ctx );
+    return;
+  }
+
+  if( FD_UNLIKELY( ctx->in_kind[ in_idx ]==IN_KIND_STAGE ) ) {
+    /* The staged destinations are not visible until the stake message
+       they were staged for arrives, so the cache stays valid. */
+    fd_stake_ci_stake_msg_stage_fini( ctx->stake_ci );
     return;
   }
 
@@ -807,6 +1029,7 @@ after_frag( fd_shred_ctx_t *    ctx,
         fd_stake_ci_dest_remove( ctx->stake_ci, (fd_pubkey_t *)ctx->gossip_upd_buf->origin_pubkey );
       }
     }
+    dest_cache_refresh( ctx );
     return;
   }
 
@@ -894,38 +1117,7 @@ after_frag( fd_shred_ctx_t *    ctx,
     fd_histf_sample( ctx->metrics->add_shred_timing, (ulong)add_shred_timing );
     ctx->metrics->shred_processing_result[ rv + FD_FEC_RESOLVER_ADD_SHRED_RETVAL_OFF+FD_SHRED_ADD_SHRED_EXTRA_RETVAL_CNT ]++;
 
-    /* Fanout is subject to feature activation. The code below replicates
-        Agave's get_data_plane_fanout() in turbine/src/cluster_nodes.rs
-        on 2025-03-25. Default Agave's DATA_PLANE_FANOUT = 200UL.
-        TODO once the experiments are disabled, consider removing these
-        fanout variations from the code. */
-    if( FD_LIKELY( shred->slot >= ctx->features_activation->disable_turbine_fanout_experiments ) ) {
-      fanout = 200UL;
-    } else {
-      if( FD_LIKELY( shred->slot >= ctx->features_activation->enable_turbine_extended_fanout_experiments ) ) {
-        switch( shred->slot % 359 ) {
-          case  11UL: fanout = 1152UL;  break;
-          case  61UL: fanout = 1280UL;  break;
-          case 111UL: fanout = 1024UL;  break;
-          case 161UL: fanout = 1408UL;  break;
-          case 211UL: fanout =  896UL;  break;
-          case 261UL: fanout = 1536UL;  break;
-          case 311UL: fanout =  768UL;  break;
-          default   : fanout =  200UL;
-        }
-      } else {
-        switch( shred->slot % 359 ) {
-          case  11UL: fanout =   64UL;  break;
-          case  61UL: fanout =  768UL;  break;
-          case 111UL: fanout =  128UL;  break;
-          case 161UL: fanout =  640UL;  break;
-          case 211UL: fanout =  256UL;  break;
-          case 261UL: fanout =  512UL;  break;
-          case 311UL: fanout =  384UL;  break;
-          default   : fanout =  200UL;
-        }
-      }
-    }
+    fanout = turbine_fanout( ctx, shred->slot );
 
     if( FD_UNLIKELY( ctx->shred_out_idx!=ULONG_MAX &&  /* Only send to repair in full Firedancer */
                      spilled_fec.slot!=0 && spilled_fec.max_dshred_idx!=FD_SHRED_BLK_MAX ) ) {
@@ -939,6 +1131,7 @@ after_frag( fd_shred_ctx_t *    ctx,
     if( (rv==FD_FEC_RESOLVER_SHRED_OKAY) | (rv==FD_FEC_RESOLVER_SHRED_COMPLETES) ) {
       if( FD_LIKELY( fd_disco_netmux_sig_proto( sig ) != DST_PROTO_REPAIR ) ) {
         /* Relay this shred */
+        dest_cache_advance( ctx, shred->slot );
         ulong max_dest_cnt[1];
         do {
           /* If we've validated the shred and it COMPLETES but we can't
@@ -946,7 +1139,8 @@ after_frag( fd_shred_ctx_t *    ctx,
             the shred, but still send it to the blockstore. */
           fd_shred_dest_t * sdest = fd_stake_ci_get_sdest_for_slot( ctx->stake_ci, shred->slot );
           if( FD_UNLIKELY( !sdest ) ) break;
-          fd_shred_dest_idx_t * dests = fd_shred_dest_compute_children( sdest, &shred, 1UL, ctx->scratchpad_dests, 1UL, fanout, fanout, max_dest_cnt );
+          fd_shred_dest_idx_t const * dests = dest_cache_query( ctx, sdest, shred, fanout, max_dest_cnt );
+          if( FD_UNLIKELY( !dests ) ) dests = fd_shred_dest_compute_children( sdest, &shred, 1UL, ctx->scratchpad_dests, 1UL, fanout, fanout, max_dest_cnt );
           if( FD_UNLIKELY( !dests ) ) break;
 
           for( ulong i=0UL; i<ctx->adtl_dests_retransmit_cnt; i++ ) send_shred( ctx, stem, *out_shred, ctx->adtl_dests_retransmit+i, ctx->tsorig );
@@ -1030,12 +1224,12 @@ after_frag( fd_shred_ctx_t *    ctx,
          we are leader. */
 
       /* See top-level documentation in fd_store.h under CONCURRENCY to
-         understand why it is safe to use a Store read vs. write lock in
-         Shred tile. */
+         understand why it is safe for Shred tiles to insert into the
+         store concurrently with each other and with Replay. */
 
       long shacq_start, shacq_end, shrel_end;
       fd_store_fec_t * fec = NULL;
-      FD_STORE_SHARED_LOCK( ctx->store, shacq_start, shacq_end, shrel_end ) {
+      FD_STORE_SHARED_LOCK( ctx->store, ctx->round_robin_id, shacq_start, shacq_end, shrel_end ) {
         fec = fd_store_insert( ctx->store, ctx->round_robin_id, (fd_hash_t *)fd_type_pun( &ctx->out_merkle_roots[fset_k] ) );
       } FD_STORE_SHARED_LOCK_END;
 
@@ -1067,16 +1261,14 @@ after_frag( fd_shred_ctx_t *    ctx,
         fec->data_sz += payload_sz;
       }
 
-      /* It's safe to memcpy the FEC payload outside of the shared-lock,
-         because the fec object ptr is guaranteed to be valid.  It is
-         not possible for a store_publish to free/invalidate the fec
-         object during the data memcpy, because the free can only happen
-         after the fec is linked to its parent, which happens in the
-         repair tile, and crucially, only after we call stem publish in
-         this tile.  Copying outside the shared lock scope also means
-         that we can lower the duration for which the shared lock is
-         held, and enables replay to acquire the exclusive lock and
-         avoid getting starved. */
+      /* It's safe to memcpy the FEC payload outside of the pinned
+         section, because the fec object ptr is guaranteed to be valid.
+         It is not possible for a store_publish to prune the fec object
+         during the data memcpy, because publish only prunes FEC sets
+         that are linked into the tree, which happens in the replay
+         tile, and crucially, only after we call stem publish in this
+         tile.  Even if it were pruned, only this tile can release it
+         back to the pool. */
 
       fd_histf_sample( ctx->metrics->store_insert_wait, (ulong)fd_long_max(shacq_end - shacq_start, 0) );
       fd_histf_sample( ctx->metrics->store_insert_work, (ulong)fd_long_max(shrel_end - shacq_end,   0) );
@@ -1146,22 +1338,44 @@ after_frag( fd_shred_ctx_t *    ctx,
     fd_shred_dest_t * sdest = fd_stake_ci_get_sdest_for_slot( ctx->stake_ci, new_shreds[ 0 ]->slot );
     if( FD_UNLIKELY( !sdest ) ) return;
 
-    ulong out_stride;
-    ulong max_dest_cnt[1];
-    fd_shred_dest_idx_t * dests;
-    if( FD_LIKELY( ctx->in_kind[ in_idx ]==IN_KIND_NET ) ) {
+    int is_net = ctx->in_kind[ in_idx ]==IN_KIND_NET;
+    if( FD_LIKELY( is_net ) ) {
       for( ulong i=0UL; i<k; i++ ) {
         for( ulong j=0UL; j<ctx->adtl_dests_retransmit_cnt; j++ ) send_shred( ctx, stem, new_shreds[ i ], ctx->adtl_dests_retransmit+j, ctx->tsorig );
       }
+    } else {
+      for( ulong i=0UL; i<k; i++ ) {
+        for( ulong j=0UL; j<ctx->adtl_dests_leader_cnt; j++ ) send_shred( ctx, stem, new_shreds[ i ], ctx->adtl_dests_leader+j, ctx->tsorig );
+      }
+    }
+
+    /* Shreds with precomputed destinations are sent right away.  The
+       rest are compacted to the front of new_shreds and have their
+       destinations computed below.  As the leader, we query the
+       destinations of compute_first (fanout 0). */
+    ulong miss_cnt = 0UL;
+    for( ulong i=0UL; i<k; i++ ) {
+      ulong dest_cnt;
+      fd_shred_dest_idx_t const * cached = dest_cache_query( ctx, sdest, new_shreds[ i ], fd_ulong_if( is_net, fanout, 0UL ), &dest_cnt );
+      if( FD_UNLIKELY( !cached ) ) {
+        new_shreds[ miss_cnt++ ] = new_shreds[ i ];
+        continue;
+      }
+      for( ulong j=0UL; j<dest_cnt; j++ ) send_shred( ctx, stem, new_shreds[ i ], fd_shred_dest_idx_to_dest( sdest, cached[ j ] ), ctx->tsorig );
+    }
+    k = miss_cnt;
+    if( FD_LIKELY( !k ) ) return;
+
+    ulong out_stride;
+    ulong max_dest_cnt[1];
+    fd_shred_dest_idx_t * dests;
+    if( FD_LIKELY( is_net ) ) {
       out_stride = k;
       /* In the case of feature activation, the fanout used below is
           the same as the one calculated/modified previously at the
           beginning of after_frag() for IN_KIND_NET in this slot. */
       dests = fd_shred_dest_compute_children( sdest, new_shreds, k, ctx->scratchpad_dests, k, fanout, fanout, max_dest_cnt );
     } else {
-      for( ulong i=0UL; i<k; i++ ) {
-        for( ulong j=0UL; j<ctx->adtl_dests_leader_cnt; j++ ) send_shred( ctx, stem, new_shreds[ i ], ctx->adtl_dests_leader+j, ctx->tsorig );
-      }
       out_stride = 1UL;
       *max_dest_cnt = 1UL;
       dests = fd_shred_dest_compute_first   ( sdest, new_shreds, k, ctx->scratchpad_dests );
@@ -1266,6 +1480,10 @@ unprivileged_init( fd_topo_t *      topo,
   void * _resolver = FD_SCRATCH_ALLOC_APPEND( l, fd_fec_resolver_align(),          fec_resolver_footprint             );
   void * _shredder = FD_SCRATCH_ALLOC_APPEND( l, fd_shredder_align(),              fd_shredder_footprint()            );
   void * _fec_sets = FD_SCRATCH_ALLOC_APPEND( l, alignof(fd_fec_set_t),            sizeof(fd_fec_set_t)*fec_set_cnt   );
+  void * _dest_cache[ 2 ];
+  for( ulong i=0UL; i<2UL; i++ ) {
+    _dest_cache[ i ] = FD_SCRATCH_ALLOC_APPEND( l, fd_shred_dest_cache_align(), fd_shred_dest_cache_footprint( DEST_CACHE_IDX_MAX, DEST_CACHE_POOL_MAX ) );
+  }
 
   fd_fec_set_t * fec_sets = (fd_fec_set_t *)_fec_sets;
   fd_shred34_t * shred34  = (fd_shred34_t *)fec_sets_shmem;
@@ -1325,7 +1543,8 @@ unprivileged_init( fd_topo_t *      topo,
 
   ulong shred_limit = fd_ulong_if( tile->shred.larger_shred_limits_per_block, 32UL*32UL*1024UL, 32UL*1024UL );
   fd_fec_set_t * resolver_sets = fec_sets + (shred_store_mcache_depth+1UL)/2UL + 1UL;
-  ctx->shredder = NONNULL( fd_shredder_join     ( fd_shredder_new     ( _shredder, fd_shred_signer, ctx->keyguard_client ) ) );
+  /* Shredder signing is deferred, see fd_shred_sign_fec_set */
+  ctx->shredder = NONNULL( fd_shredder_join     ( fd_shredder_new     ( _shredder, NULL, NULL ) ) );
   ctx->resolver = NONNULL( fd_fec_resolver_join ( fd_fec_resolver_new ( _resolver,
                                                                         fd_shred_signer, ctx->keyguard_client,
                                                                         tile->shred.fec_resolver_depth, 1UL,
@@ -1343,6 +1562,14 @@ unprivileged_init( fd_topo_t *      topo,
 
   ctx->stake_ci = fd_stake_ci_join( fd_stake_ci_new( _stake_ci, ctx->identity_key ) );
 
+  for( ulong i=0UL; i<2UL; i++ ) {
+    ctx->dest_cache[ i ] = fd_shred_dest_cache_join( fd_shred_dest_cache_new( _dest_cache[ i ], DEST_CACHE_IDX_MAX, DEST_CACHE_POOL_MAX ) );
+    FD_TEST( ctx->dest_cache[ i ] );
+    ctx->dest_cache_seq   [ i ] = 0UL;
+    ctx->dest_cache_fanout[ i ] = 0UL;
+  }
+  ctx->dest_cache_slot = ULONG_MAX;
+
   ctx->net_id   = (ushort)0;
 
   fd_ip4_udp_hdr_init( ctx->data_shred_net_hdr,   FD_SHRED_MIN_SZ, 0, tile->shred.shred_listen_port );
@@ -1372,6 +1599,7 @@ unprivileged_init( fd_topo_t *      topo,
     else if( FD_LIKELY( !strcmp( link->name, "poh_shred"    ) ) )   ctx->in_kind[ i ] = IN_KIND_POH;
     else if( FD_LIKELY( !strcmp( link->name, "stake_out"    ) ) )   ctx->in_kind[ i ] = IN_KIND_STAKE;
     else if( FD_LIKELY( !strcmp( link->name, "replay_stake" ) ) )   ctx->in_kind[ i ] = IN_KIND_STAKE;
+    else if( FD_LIKELY( !strcmp( link->name, "replay_stage" ) ) )   ctx->in_kind[ i ] = IN_KIND_STAGE;
     else if( FD_LIKELY( !strcmp( link->name, "sign_shred"   ) ) )   ctx->in_kind[ i ] = IN_KIND_SIGN;
     else if( FD_LIKELY( !strcmp( link->name, "repair_shred" ) ) )   ctx->in_kind[ i ] = IN_KIND_REPAIR;
     else if( FD_LIKELY( !strcmp( link->name, "ipecho_out"   ) ) )   ctx->in_kind[ i ] = IN_KIND_IPECHO;
@@ -1458,6 +1686,8 @@ unprivileged_init( fd_topo_t *      topo,
   ctx->metrics->shred_rejected_unchained_cnt = 0UL;
   ctx->metrics->repair_rcv_cnt               = 0UL;
   ctx->metrics->turbine_rcv_cnt              = 0UL;
+  ctx->metrics->dest_cache_hit_cnt           = 0UL;
+  ctx->metrics->dest_cache_miss_cnt          = 0UL;
 
   ctx->pending_batch.microblock_cnt = 0UL;
   ctx->pending_batch.txn_cnt        = 0UL;
@@ -1524,6 +1754,7 @@ populate_allowed_fds( fd_topo_t const *      topo,
 #define STEM_CALLBACK_CONTEXT_ALIGN alignof(fd_shred_ctx_t)
 
 #define STEM_CALLBACK_DURING_HOUSEKEEPING during_housekeeping
+#define STEM_CALLBACK_AFTER_CREDIT        after_credit
 #define STEM_CALLBACK_METRICS_WRITE       metrics_write
 #define STEM_CALLBACK_BEFORE_FRAG         before_frag
 #define STEM_CALLBACK_DURING_FRAG         during_frag
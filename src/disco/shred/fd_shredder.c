@@ -275,13 +275,15 @@ fd_shredder_next_fec_set( fd_shredder_t * shredder,
   uchar * root = fd_bmtree_commit_fini( bmtree );
   if( FD_LIKELY( out_merkle_root ) ) memcpy( out_merkle_root, root, FD_SHRED_MERKLE_ROOT_SZ );
 
-  /* Sign Merkle Root */
-  shredder->signer( shredder->signer_ctx, root_signature, root );
+  /* Sign Merkle Root.  Without a signer, signing is deferred to the
+     caller (see fd_shredder_sign_fec_set). */
+  fd_shredder_sign_fn * signer = shredder->signer;
+  if( FD_LIKELY( signer ) ) signer( shredder->signer_ctx, root_signature, root );
 
   /* Write signature and Merkle proof */
   for( ulong i=0UL; i<data_shred_cnt; i++ ) {
     fd_shred_t * shred = (fd_shred_t *)data_shreds[ i ];
-    fd_memcpy( shred->signature, root_signature, FD_ED25519_SIG_SZ );
+    if( FD_LIKELY( signer ) ) fd_memcpy( shred->signature, root_signature, FD_ED25519_SIG_SZ );
 
     uchar * merkle = data_shreds[ i ] + fd_shred_merkle_off( shred );
     fd_bmtree_get_proof( bmtree, merkle, i );
@@ -296,7 +298,7 @@ fd_shredder_next_fec_set( fd_shredder_t * shredder,
 
   for( ulong j=0UL; j<parity_shred_cnt; j++ ) {
     fd_shred_t * shred = (fd_shred_t *)parity_shreds[ j ];
-    fd_memcpy( shred->signature, root_signature, FD_ED25519_SIG_SZ );
+    if( FD_LIKELY( signer ) ) fd_memcpy( shred->signature, root_signature, FD_ED25519_SIG_SZ );
 
     uchar * merkle = parity_shreds[ j ] + fd_shred_merkle_off( shred );
     fd_bmtree_get_proof( bmtree, merkle, data_shred_cnt+j );
@@ -319,6 +321,14 @@ fd_shredder_next_fec_set( fd_shredder_t * shredder,
   return result;
 }
 
+fd_fec_set_t *
+fd_shredder_sign_fec_set( fd_fec_set_t * set,
+                          uchar const *  signature ) {
+  for( ulong i=0UL; i<set->data_shred_cnt;   i++ ) fd_memcpy( set->data_shreds  [ i ], signature, FD_ED25519_SIG_SZ );
+  for( ulong j=0UL; j<set->parity_shred_cnt; j++ ) fd_memcpy( set->parity_shreds[ j ], signature, FD_ED25519_SIG_SZ );
+  return set;
+}
+
 fd_shredder_t * fd_shredder_fini_batch( fd_shredder_t * shredder ) {
   shredder->entry_batch = NULL;
   shredder->sz          = 0UL;
@@ -81,7 +81,14 @@ FD_FN_CONST static inline ulong fd_shredder_footprint( void ) { return sizeof(fd
    pubkey must point to the first byte of 32 bytes containing the public
    key of the validator that will sign the shreds this shredder
    produces.  The value provided for shred_version will be stored in the
-   shred_version field of each shred that this shredder produces. */
+   shred_version field of each shred that this shredder produces.
+
+   signer is called by fd_shredder_next_fec_set to sign the Merkle root
+   of each FEC set.  If signer is NULL, signing is deferred:
+   fd_shredder_next_fec_set leaves the signature field of the shreds
+   unset, and the caller must sign the Merkle root itself and call
+   fd_shredder_sign_fec_set before the shreds are sent.  This lets the
+   caller pipeline and batch the signing of multiple FEC sets. */
 void          * fd_shredder_new(  void * mem, fd_shredder_sign_fn * signer, void * signer_ctx );
 fd_shredder_t * fd_shredder_join( void * mem );
 void *          fd_shredder_leave(  fd_shredder_t * shredder );
@@ -268,7 +275,8 @@ fd_shredder_t * fd_shredder_skip_batch( fd_shredder_t * shredder,
 /* fd_shredder_next_fec_set extracts the next FEC set from the in
    progress batch.  Computes the entirety of both data and parity
    shreds, including the parity information, Merkle proofs, and
-   signatures.  Additionally computes the destination index for each
+   signatures (unless signing is deferred, see fd_shredder_new).
+   Additionally computes the destination index for each
    shred.  Stores the generated FEC set in result, which is clobbered.
    Populates all fields of result except for {data,parity}_shred_present
    (which is only used for reconstruction).
@@ -298,6 +306,14 @@ fd_shredder_next_fec_set( fd_shredder_t * shredder,
                           uchar *         chained_merkle_root,
                           uchar *         out_merkle_root );
 
+/* fd_shredder_sign_fec_set writes signature (the 64 byte Ed25519
+   signature of the FEC set's Merkle root) into every data and parity
+   shred of set.  set must have been produced by a shredder with a
+   deferred signer (see fd_shredder_new).  Returns set. */
+fd_fec_set_t *
+fd_shredder_sign_fec_set( fd_fec_set_t * set,
+                          uchar const *  signature );
+
 /* fd_shredder_fini_batch finishes the in process batch.  shredder must
    be a valid local join that is currently in a batch.  Upon return,
    shredder will no longer be in a batch and will be ready to begin a
@@ -33,6 +33,7 @@ fd_stake_ci_new( void             * mem,
   /* Initialize first 2 to satisfy invariants */
   info->vote_stake_weight[ 0 ] = dummy_stakes[ 0 ];
   info->shred_dest  [ 0 ] = dummy_dests [ 0 ];
+  info->sdest_seq = 0UL;
   for( ulong i=0UL; i<2UL; i++ ) {
     fd_per_epoch_info_t * ei = info->epoch_info + i;
     ei->epoch          = i;
@@ -43,7 +44,19 @@ fd_stake_ci_new( void             * mem,
 
     ei->lsched = fd_epoch_leaders_join( fd_epoch_leaders_new( ei->_lsched, 0UL, 0UL, 1UL, 1UL,    info->vote_stake_weight,  0UL, ei->vote_keyed_lsched ) );
     ei->sdest  = fd_shred_dest_join   ( fd_shred_dest_new   ( ei->_sdest,  info->shred_dest, 1UL, ei->lsched, identity_key, 0UL ) );
+    ei->sdest_seq = ++info->sdest_seq;
   }
+  fd_per_epoch_info_t * si = info->staged_info;
+  si->epoch             = 0UL;
+  si->start_slot        = 0UL;
+  si->slot_cnt          = 0UL;
+  si->excluded_stake    = 0UL;
+  si->vote_keyed_lsched = 0UL;
+
+  si->lsched = fd_epoch_leaders_join( fd_epoch_leaders_new( si->_lsched, 0UL, 0UL, 1UL, 1UL, info->vote_stake_weight, 0UL, 0UL ) );
+  si->sdest  = fd_shred_dest_join   ( fd_shred_dest_new   ( si->_sdest,  info->shred_dest, 1UL, si->lsched, identity_key, 0UL ) );
+  si->sdest_seq = ++info->sdest_seq;
+  info->staged_done = 0;
   info->identity_key[ 0 ] = *identity_key;
 
   return (void *)info;
@@ -129,16 +142,25 @@ compute_id_weights_from_vote_weights( fd_stake_weight_t *            stake_weigh
 #define SET_MAX  MAX_SHRED_DESTS
 #include "../../util/tmpl/fd_set.c"
 
-void
-fd_stake_ci_stake_msg_fini( fd_stake_ci_t * info ) {
+/* build_epoch_info replaces the lsched and sdest of new_ei with the
+   ones for the stake message in scratch and vote_stake_weight (or in
+   staged and staged_vote_stake_weight if staged is set). */
+
+static void
+build_epoch_info( fd_stake_ci_t *       info,
+                  int                   staged,
+                  fd_per_epoch_info_t * new_ei ) {
+  __typeof__(info->scratch[0]) const * hdr = staged ? info->staged : info->scratch;
+  fd_vote_stake_weight_t * vote_stake_weight = staged ? info->staged_vote_stake_weight : info->vote_stake_weight;
+
   /* The grossness here is a sign our abstractions are wrong and need to
      be fixed instead of just patched.  We need to generate weighted
      shred destinations using a combination of the new stake information
      and whatever contact info we previously knew. */
-  ulong epoch                  = info->scratch->epoch;
-  ulong staked_cnt             = info->scratch->staked_cnt;
-  ulong unchanged_staked_cnt   = info->scratch->staked_cnt;
-  ulong vote_keyed_lsched      = info->scratch->vote_keyed_lsched;
+  ulong epoch                  = hdr->epoch;
+  ulong staked_cnt             = hdr->staked_cnt;
+  ulong unchanged_staked_cnt   = hdr->staked_cnt;
+  ulong vote_keyed_lsched      = hdr->vote_keyed_lsched;
 
   /* Just take the first one arbitrarily because they both have the same
      contact info, other than possibly some staked nodes with no contact
@@ -155,7 +177,7 @@ fd_stake_ci_stake_msg_fini( fd_stake_ci_t * info ) {
   unhit_set_t * unhit = unhit_set_join( unhit_set_new( _unhit ) );
   unhit_set_full( unhit );
 
-  staked_cnt = compute_id_weights_from_vote_weights( info->stake_weight, info->vote_stake_weight, staked_cnt );
+  staked_cnt = compute_id_weights_from_vote_weights( info->stake_weight, vote_stake_weight, staked_cnt );
 
   for( ulong i=0UL; i<staked_cnt; i++ ) {
     fd_shred_dest_idx_t old_idx = fd_shred_dest_pubkey_to_idx( existing_sdest, &(info->stake_weight[ i ].key) );
@@ -199,24 +221,86 @@ fd_stake_ci_stake_msg_fini( fd_stake_ci_t * info ) {
   /* Now we have a plausible shred_dest list. */
 
   /* Clear the existing info */
-  fd_per_epoch_info_t * new_ei = info->epoch_info + (epoch % 2UL);
-  fd_shred_dest_delete   ( fd_shred_dest_leave   ( new_ei->sdest  ) );
-  fd_epoch_leaders_delete( fd_epoch_leaders_leave( new_ei->lsched ) );
+  void * sdest_mem  = fd_shred_dest_delete   ( fd_shred_dest_leave   ( new_ei->sdest  ) );
+  void * lsched_mem = fd_epoch_leaders_delete( fd_epoch_leaders_leave( new_ei->lsched ) );
 
   /* And create the new one */
-  ulong excluded_stake = info->scratch->excluded_stake;
+  ulong excluded_stake = hdr->excluded_stake;
 
   new_ei->epoch          = epoch;
-  new_ei->start_slot     = info->scratch->start_slot;
-  new_ei->slot_cnt       = info->scratch->slot_cnt;
+  new_ei->start_slot     = hdr->start_slot;
+  new_ei->slot_cnt       = hdr->slot_cnt;
   new_ei->excluded_stake = excluded_stake;
   new_ei->vote_keyed_lsched = vote_keyed_lsched;
 
-  new_ei->lsched = fd_epoch_leaders_join( fd_epoch_leaders_new( new_ei->_lsched, epoch, new_ei->start_slot, new_ei->slot_cnt,
-                                                                unchanged_staked_cnt, info->vote_stake_weight, excluded_stake, vote_keyed_lsched ) );
-  new_ei->sdest  = fd_shred_dest_join   ( fd_shred_dest_new   ( new_ei->_sdest, info->shred_dest, j,
+  new_ei->lsched = fd_epoch_leaders_join( fd_epoch_leaders_new( lsched_mem, epoch, new_ei->start_slot, new_ei->slot_cnt,
+                                                                unchanged_staked_cnt, vote_stake_weight, excluded_stake, vote_keyed_lsched ) );
+  new_ei->sdest  = fd_shred_dest_join   ( fd_shred_dest_new   ( sdest_mem, info->shred_dest, j,
                                                                 new_ei->lsched, info->identity_key,  excluded_stake ) );
+  new_ei->sdest_seq = ++info->sdest_seq;
+}
+
+int
+fd_stake_ci_stake_msg_fini( fd_stake_ci_t * info ) {
+  ulong                 epoch  = info->scratch->epoch;
+  fd_per_epoch_info_t * new_ei = info->epoch_info + (epoch % 2UL);
+
+  if( FD_LIKELY( info->staged_done && info->staged->epoch==epoch ) ) {
+    info->staged_done = 0;
+    if( FD_LIKELY( !memcmp( info->staged, info->scratch, sizeof(info->scratch) ) &&
+                   !memcmp( info->staged_vote_stake_weight, info->vote_stake_weight,
+                            info->scratch->staked_cnt*sizeof(fd_vote_stake_weight_t) ) ) ) {
+      /* The staged info was computed from the same message and has
+         received the same contact info updates since, swap it in.  The
+         replaced objects become the ones to use for the next staging. */
+      fd_per_epoch_info_t * si = info->staged_info;
+      fd_epoch_leaders_t * old_lsched = new_ei->lsched;
+      fd_shred_dest_t    * old_sdest  = new_ei->sdest;
+
+      new_ei->epoch             = si->epoch;
+      new_ei->start_slot        = si->start_slot;
+      new_ei->slot_cnt          = si->slot_cnt;
+      new_ei->excluded_stake    = si->excluded_stake;
+      new_ei->vote_keyed_lsched = si->vote_keyed_lsched;
+      new_ei->lsched            = si->lsched;
+      new_ei->sdest             = si->sdest;
+      new_ei->sdest_seq         = si->sdest_seq;
+
+      si->lsched = old_lsched;
+      si->sdest  = old_sdest;
+      log_summary( "staged stake update", info );
+      return 1;
+    }
+  }
+
+  build_epoch_info( info, 0, new_ei );
   log_summary( "stake update", info );
+  return 0;
+}
+
+void
+fd_stake_ci_stake_msg_stage_init( fd_stake_ci_t               * info,
+                                  fd_stake_weight_msg_t const * msg ) {
+  if( FD_UNLIKELY( msg->staked_cnt > MAX_SHRED_DESTS ) )
+    FD_LOG_ERR(( "The stakes -> Firedancer splice sent a malformed staged update with %lu stakes in it,"
+                 " but the maximum allowed is %lu", msg->staked_cnt, MAX_SHRED_DESTS ));
+
+  info->staged_done = 0;
+
+  info->staged->epoch             = msg->epoch;
+  info->staged->start_slot        = msg->start_slot;
+  info->staged->slot_cnt          = msg->slot_cnt;
+  info->staged->staked_cnt        = msg->staked_cnt;
+  info->staged->excluded_stake    = msg->excluded_stake;
+  info->staged->vote_keyed_lsched = msg->vote_keyed_lsched;
+
+  fd_memcpy( info->staged_vote_stake_weight, msg->weights, msg->staked_cnt*sizeof(fd_vote_stake_weight_t) );
+}
+
+void
+fd_stake_ci_stake_msg_stage_fini( fd_stake_ci_t * info ) {
+  build_epoch_info( info, 1, info->staged_info );
+  info->staged_done = 1;
 }
 
 fd_shred_dest_weighted_t * fd_stake_ci_dest_add_init( fd_stake_ci_t * info ) { return info->shred_dest; }
@@ -284,10 +368,11 @@ fd_stake_ci_dest_add_fini_impl( fd_stake_ci_t       * info,
      sdest.  We need to sort the unstaked nodes by pubkey though. */
   sort_pubkey_inplace( info->shred_dest_temp + staked_cnt, j - staked_cnt );
 
-  fd_shred_dest_delete( fd_shred_dest_leave( ei->sdest ) );
+  void * sdest_mem = fd_shred_dest_delete( fd_shred_dest_leave( ei->sdest ) );
 
-  ei->sdest  = fd_shred_dest_join( fd_shred_dest_new( ei->_sdest, info->shred_dest_temp, j, ei->lsched, info->identity_key,
+  ei->sdest  = fd_shred_dest_join( fd_shred_dest_new( sdest_mem, info->shred_dest_temp, j, ei->lsched, info->identity_key,
                                                       ei->excluded_stake ) );
+  ei->sdest_seq = ++info->sdest_seq;
 
   if( FD_UNLIKELY( ei->sdest==NULL ) ) {
     /* Happens if the identity key is not present, which can only happen
@@ -319,9 +404,10 @@ fd_stake_ci_dest_add_fini( fd_stake_ci_t * info,
     info->shred_dest[ i ].ip4 = SELF_DUMMY_IP;
   }
 
-  /* Update both of them */
+  /* Update both of them, and the staged one */
   fd_stake_ci_dest_add_fini_impl( info, cnt, info->epoch_info + 0UL );
   fd_stake_ci_dest_add_fini_impl( info, cnt, info->epoch_info + 1UL );
+  if( info->staged_done ) fd_stake_ci_dest_add_fini_impl( info, cnt, info->staged_info );
 
   log_summary( "dest update", info );
 }
@@ -343,7 +429,10 @@ fd_stake_ci_set_identity( fd_stake_ci_t *     info,
                           fd_pubkey_t const * identity_key ) {
   /* None of the stakes are changing, so we just need to regenerate the
      sdests, sightly adjusting the destination IP addresses.  The only
-     corner case is if the new identity is not present. */
+     corner case is if the new identity is not present.  Identity
+     changes are rare, so we just discard the staged info rather than
+     updating it too. */
+  info->staged_done = 0;
   for( ulong i=0UL; i<2UL; i++ ) {
     fd_per_epoch_info_t * ei = info->epoch_info+i;
 
@@ -380,12 +469,13 @@ fd_stake_ci_set_identity( fd_stake_ci_t *     info,
 
       for(; j<staked_cnt+unstaked_cnt; j++ ) info->shred_dest_temp[ j+1UL ] = *fd_shred_dest_idx_to_dest( ei->sdest, (fd_shred_dest_idx_t)j );
 
-      fd_shred_dest_delete( fd_shred_dest_leave( ei->sdest ) );
+      void * sdest_mem = fd_shred_dest_delete( fd_shred_dest_leave( ei->sdest ) );
 
-      ei->sdest  = fd_shred_dest_join( fd_shred_dest_new( ei->_sdest, info->shred_dest_temp, j+1UL, ei->lsched, identity_key,
+      ei->sdest  = fd_shred_dest_join( fd_shred_dest_new( sdest_mem, info->shred_dest_temp, j+1UL, ei->lsched, identity_key,
                                                           ei->excluded_stake ) );
       FD_TEST( ei->sdest );
     }
+    ei->sdest_seq = ++info->sdest_seq;
 
   }
   *info->identity_key = *identity_key;
@@ -399,8 +489,9 @@ refresh_sdest( fd_stake_ci_t *            info,
                fd_per_epoch_info_t *      ei ) {
   sort_pubkey_inplace( shred_dest_temp + staked_cnt, cnt - staked_cnt );
 
-  fd_shred_dest_delete( fd_shred_dest_leave( ei->sdest ) );
-  ei->sdest = fd_shred_dest_join( fd_shred_dest_new( ei->_sdest, shred_dest_temp, cnt, ei->lsched, info->identity_key, ei->excluded_stake ) );
+  void * sdest_mem = fd_shred_dest_delete( fd_shred_dest_leave( ei->sdest ) );
+  ei->sdest = fd_shred_dest_join( fd_shred_dest_new( sdest_mem, shred_dest_temp, cnt, ei->lsched, info->identity_key, ei->excluded_stake ) );
+  ei->sdest_seq = ++info->sdest_seq;
   if( FD_UNLIKELY( ei->sdest==NULL ) ) {
     FD_LOG_ERR(( "Too many validators have higher stake than this validator.  Cannot continue." ));
   }
@@ -474,6 +565,7 @@ fd_stake_ci_dest_update( fd_stake_ci_t *       info,
                          ushort                port ) {
   ci_dest_update_impl( info, pubkey, ip4, port, info->epoch_info+0UL );
   ci_dest_update_impl( info, pubkey, ip4, port, info->epoch_info+1UL );
+  if( info->staged_done ) ci_dest_update_impl( info, pubkey, ip4, port, info->staged_info );
 }
 
 void
@@ -481,6 +573,7 @@ fd_stake_ci_dest_remove( fd_stake_ci_t * info,
                          fd_pubkey_t const * pubkey ) {
   ci_dest_remove_impl( info, pubkey, info->epoch_info+0UL );
   ci_dest_remove_impl( info, pubkey, info->epoch_info+1UL );
+  if( info->staged_done ) ci_dest_remove_impl( info, pubkey, info->staged_info );
 
 }
 
@@ -498,3 +591,10 @@ fd_stake_ci_get_lsched_for_slot( fd_stake_ci_t const * info,
   ulong idx = fd_stake_ci_get_idx_for_slot( info, slot );
   return idx!=ULONG_MAX ? info->epoch_info[ idx ].lsched : NULL;
 }
+
+ulong
+fd_stake_ci_get_sdest_seq_for_slot( fd_stake_ci_t const * info,
+                                    ulong                 slot ) {
+  ulong idx = fd_stake_ci_get_idx_for_slot( info, slot );
+  return idx!=ULONG_MAX ? info->epoch_info[ idx ].sdest_seq : 0UL;
+}
@@ -36,10 +36,18 @@ struct fd_per_epoch_info_private {
   ulong vote_keyed_lsched;
 
   /* Invariant: These are always joined and use the memory below for
-     their footprint. */
+     their footprint, or the memory of the fd_per_epoch_info_t they
+     were swapped with (see fd_stake_ci_stake_msg_stage_init).  In any
+     case, sdest and lsched come from the same struct. */
   fd_epoch_leaders_t * lsched;
   fd_shred_dest_t    * sdest;
 
+  /* sdest_seq changes whenever the destinations sdest computes might
+     have changed (sdest re-created, or its source changed).  Contact
+     info updates that only change an IP address or port do not change
+     it.  See fd_stake_ci_get_sdest_seq_for_slot. */
+  ulong sdest_seq;
+
   uchar __attribute__((aligned(FD_EPOCH_LEADERS_ALIGN))) _lsched[ FD_EPOCH_LEADERS_FOOTPRINT(MAX_SHRED_DESTS, MAX_SLOTS_PER_EPOCH) ];
   uchar __attribute__((aligned(FD_SHRED_DEST_ALIGN   ))) _sdest [ MAX_SHRED_DEST_FOOTPRINT ];
 };
@@ -48,9 +56,14 @@ typedef struct fd_per_epoch_info_private fd_per_epoch_info_t;
 struct fd_stake_ci {
   fd_pubkey_t identity_key[ 1 ];
 
+  /* sdest_seq is the last sdest_seq handed out to an
+     fd_per_epoch_info_t. */
+  ulong sdest_seq;
+
   /* scratch and stake_weight are only relevant between stake_msg_init
      and stake_msg_fini.  shred_dest is only relevant between
-     dest_add_init and dest_add_fini. */
+     dest_add_init and dest_add_fini.  staged is the header of the last
+     staged stake message. */
   struct {
     ulong epoch;
     ulong start_slot;
@@ -58,7 +71,7 @@ struct fd_stake_ci {
     ulong staked_cnt;
     ulong excluded_stake;
     ulong vote_keyed_lsched;
-  } scratch[1];
+  } scratch[1], staged[1];
 
   fd_vote_stake_weight_t   vote_stake_weight[ MAX_SHRED_DESTS ];
   fd_stake_weight_t        stake_weight   [ MAX_SHRED_DESTS ];
@@ -69,6 +82,15 @@ struct fd_stake_ci {
   /* The information to be used for epoch i can be found at
      epoch_info[ i%2 ] if it is known. */
   fd_per_epoch_info_t epoch_info[ 2 ];
+
+  /* staged_info holds the information computed ahead of time from the
+     staged stake message (with weights staged_vote_stake_weight).  It
+     is never returned by the query functions, but contact info updates
+     are applied to it like to epoch_info.  It is only valid if
+     staged_done is set. */
+  int                    staged_done;
+  fd_vote_stake_weight_t staged_vote_stake_weight[ MAX_SHRED_DESTS ];
+  fd_per_epoch_info_t    staged_info[ 1 ];
 };
 typedef struct fd_stake_ci fd_stake_ci_t;
 
@@ -156,10 +178,31 @@ void * fd_stake_ci_delete( void          * mem  );
    contact info for an unstaked node, on the other hand, that node will
    be deleted from the list. */
 void                       fd_stake_ci_stake_msg_init( fd_stake_ci_t * info, fd_stake_weight_msg_t const * msg );
-void                       fd_stake_ci_stake_msg_fini( fd_stake_ci_t * info                                    );
+int                        fd_stake_ci_stake_msg_fini( fd_stake_ci_t * info                                    );
 fd_shred_dest_weighted_t * fd_stake_ci_dest_add_init ( fd_stake_ci_t * info                                    );
 void                       fd_stake_ci_dest_add_fini ( fd_stake_ci_t * info, ulong                         cnt );
 
+/* fd_stake_ci_stake_msg_stage_{init,fini} compute the leader schedule
+   and shred destinations of a stake message that is expected to arrive
+   later (e.g. the next epoch's stake weights, as projected before the
+   epoch boundary) ahead of time, off the critical path.  msg has the
+   same requirements as for fd_stake_ci_stake_msg_init.  Staging does
+   not change the results of the query functions or affect a pending
+   stake_msg_init, but _stage_fini must not be called in
+   dest-add-pending mode.  At most one message is staged at a time,
+   staging another one discards the previous one.
+
+   If the message given to the next stake_msg_init for the same epoch
+   is identical to the staged one (same header and same weights), the
+   following stake_msg_fini just swaps in the staged information instead
+   of computing it, and returns 1.  Otherwise, it computes it as usual,
+   discards the staged information if it was for the same epoch, and
+   returns 0.  Contact info updates received between staging and the
+   swap are applied to the staged information, so the shred
+   destinations are up to date either way. */
+void fd_stake_ci_stake_msg_stage_init( fd_stake_ci_t * info, fd_stake_weight_msg_t const * msg );
+void fd_stake_ci_stake_msg_stage_fini( fd_stake_ci_t * info                                    );
+
 /* Firedancer only:
    The full client's Gossip update model publishes individual contact
    info updates (update/insert or remove), which requires a different
@@ -194,6 +237,15 @@ void fd_stake_ci_set_identity( fd_stake_ci_t *     info,
 fd_shred_dest_t *    fd_stake_ci_get_sdest_for_slot ( fd_stake_ci_t const * info, ulong slot );
 fd_epoch_leaders_t * fd_stake_ci_get_lsched_for_slot( fd_stake_ci_t const * info, ulong slot );
 
+/* fd_stake_ci_get_sdest_seq_for_slot returns a sequence number for the
+   fd_shred_dest_t that fd_stake_ci_get_sdest_for_slot returns for
+   slot, or 0 if we don't have information for that slot.  The sequence
+   number changes whenever the destinations computed for slot might
+   change, even if the returned pointer stays the same (sdest objects
+   are re-created in place), so callers that precompute destinations
+   can tell which updates they must discard their results on. */
+ulong fd_stake_ci_get_sdest_seq_for_slot( fd_stake_ci_t const * info, ulong slot );
+
 /* compute_id_weights_from_vote_weights() translates vote-based
    stake weigths into (older) identity-based stake weigths.
 
@@ -1,4 +1,5 @@
 #include "fd_shred_dest.h"
+#include "fd_shred_dest_cache.h"
 
 FD_IMPORT_BINARY( t1_pubkey,           "src/disco/shred/fixtures/cluster_info_pubkey.bin" );  /* fd_pubkey[] */
 FD_IMPORT_BINARY( t1_dest_info,        "src/disco/shred/fixtures/cluster_info.bin"        );  /* fd_shred_dest_weighted_t[] */
@@ -10,6 +11,10 @@ FD_IMPORT_BINARY( testnet_dest_info,   "src/disco/shred/fixtures/testnet.bin"
 uchar _sd_footprint[ TEST_MAX_FOOTPRINT ] __attribute__((aligned(FD_SHRED_DEST_ALIGN)));
 uchar _l_footprint[ TEST_MAX_FOOTPRINT ] __attribute__((aligned(FD_EPOCH_LEADERS_ALIGN)));
 
+#define TEST_CACHE_IDX_MAX  (256UL)
+#define TEST_CACHE_POOL_MAX (1UL<<20)
+uchar _c_footprint[ 8UL*1024UL*1024UL ] __attribute__((aligned(FD_SHRED_DEST_CACHE_ALIGN)));
+
 #define TEST_MAX_VALIDATORS 10240
 fd_vote_stake_weight_t stakes[ TEST_MAX_VALIDATORS ];
 FD_STATIC_ASSERT( FD_SHRED_DEST_ALIGN==alignof(fd_shred_dest_t), shred_dest_align );
@@ -442,6 +447,160 @@ test_indeterminate( void ) {
   fd_rng_delete( fd_rng_leave( r ) );
 }
 
+/* check_cache checks that every shred in cache has the same
+   destinations as computing them directly would give. */
+static void
+check_cache( fd_shred_dest_cache_t * cache,
+             fd_shred_dest_t       * sdest,
+             ulong                   slot,
+             ulong                   fanout ) {
+  static fd_shred_dest_idx_t result[ FD_SHRED_DEST_MAX_FANOUT ];
+  fd_shred_t shred[1];
+  fd_shred_t const * shred_ptr[ 1 ] = { shred };
+  shred->slot = slot;
+
+  FD_TEST( cache->built_cnt>0UL );
+  for( int type=0; type<2; type++ ) {
+    shred->variant = fd_shred_variant( type==0 ? FD_SHRED_TYPE_MERKLE_DATA_CHAINED : FD_SHRED_TYPE_MERKLE_CODE_CHAINED, 5 );
+    for( ulong idx=0UL; idx<cache->built_cnt; idx++ ) {
+      shred->idx = (uint)idx;
+      ulong expected_cnt;
+      if( !fanout ) {
+        expected_cnt = 1UL;
+        FD_TEST( fd_shred_dest_compute_first( sdest, shred_ptr, 1UL, result ) );
+      } else {
+        FD_TEST( fd_shred_dest_compute_children( sdest, shred_ptr, 1UL, result, 1UL, fanout, fanout, &expected_cnt ) );
+      }
+
+      ulong dest_cnt = ULONG_MAX;
+      fd_shred_dest_idx_t const * dests = fd_shred_dest_cache_query( cache, sdest, shred, fanout, &dest_cnt );
+      FD_TEST( dests );
+      ulong j=0UL;
+      for( ulong i=0UL; i<expected_cnt; i++ ) {
+        if( result[ i ]==FD_SHRED_DEST_NO_DEST ) continue;
+        FD_TEST( j<dest_cnt );
+        FD_TEST( dests[ j++ ]==result[ i ] );
+      }
+      FD_TEST( j==dest_cnt );
+    }
+  }
+
+  /* Misses */
+  ulong dest_cnt;
+  shred->idx  = (uint)cache->built_cnt;
+  FD_TEST( !fd_shred_dest_cache_query( cache, sdest, shred, fanout,     &dest_cnt ) );
+  shred->idx  = 0U;
+  FD_TEST(  fd_shred_dest_cache_query( cache, sdest, shred, fanout,     &dest_cnt ) );
+  FD_TEST( !fd_shred_dest_cache_query( cache, NULL,  shred, fanout,     &dest_cnt ) );
+  FD_TEST( !fd_shred_dest_cache_query( cache, sdest, shred, fanout+1UL, &dest_cnt ) );
+  shred->slot = slot+1UL;
+  FD_TEST( !fd_shred_dest_cache_query( cache, sdest, shred, fanout,     &dest_cnt ) );
+}
+
+static void
+test_cache( void ) {
+  ulong cnt = testnet_dest_info_sz / sizeof(fd_shred_dest_weighted_t);
+  fd_shred_dest_weighted_t const * info = (fd_shred_dest_weighted_t const *)testnet_dest_info;
+
+  ulong staked = 0UL;
+  for( ulong i=0UL; i<cnt; i++ ) {
+    stakes[i].id_key = info[i].pubkey;
+    stakes[i].vote_key = info[i].pubkey;
+    stakes[i].stake = info[i].stake_lamports;
+    staked += (info[i].stake_lamports>0UL);
+  }
+
+  fd_epoch_leaders_t * lsched = fd_epoch_leaders_join( fd_epoch_leaders_new( _l_footprint, 0UL, 0UL, 10000UL, staked, stakes, 0UL, vote_keyed_lsched ) );
+
+  /* Use the leader of slot 0 as the source, so we can test both roles */
+  fd_pubkey_t const * src_key = fd_epoch_leaders_get( lsched, 0UL );
+  fd_shred_dest_t   * sdest   = fd_shred_dest_join( fd_shred_dest_new( _sd_footprint, info, cnt, lsched, src_key, 0UL ) );
+
+  FD_TEST( fd_shred_dest_cache_align()==FD_SHRED_DEST_CACHE_ALIGN );
+  FD_TEST( fd_shred_dest_cache_footprint( TEST_CACHE_IDX_MAX, TEST_CACHE_POOL_MAX )<=sizeof(_c_footprint) );
+  FD_TEST( !fd_shred_dest_cache_new( NULL,              TEST_CACHE_IDX_MAX, TEST_CACHE_POOL_MAX ) );
+  FD_TEST( !fd_shred_dest_cache_new( _c_footprint+1UL,  TEST_CACHE_IDX_MAX, TEST_CACHE_POOL_MAX ) );
+  FD_TEST( !fd_shred_dest_cache_new( _c_footprint,      0UL,                TEST_CACHE_POOL_MAX ) );
+  FD_TEST( !fd_shred_dest_cache_new( _c_footprint,      TEST_CACHE_IDX_MAX, 0UL                 ) );
+  fd_shred_dest_cache_t * cache = fd_shred_dest_cache_join( fd_shred_dest_cache_new( _c_footprint, TEST_CACHE_IDX_MAX, TEST_CACHE_POOL_MAX ) );
+  FD_TEST( cache );
+
+  /* A new cache is empty */
+  FD_TEST( fd_shred_dest_cache_done( cache ) );
+  FD_TEST( !fd_shred_dest_cache_build( cache, 1UL ) );
+
+  /* Unknown sdest leaves the cache empty */
+  FD_TEST( fd_shred_dest_cache_reset( cache, NULL, 1UL, 200UL )==cache );
+  FD_TEST( fd_shred_dest_cache_done( cache ) );
+
+  ulong leader_slot = ULONG_MAX;
+  ulong other_slot  = ULONG_MAX;
+  for( ulong slot=0UL; slot<10000UL; slot++ ) {
+    int is_leader = !memcmp( fd_epoch_leaders_get( lsched, slot ), src_key, 32UL );
+    if( is_leader ) leader_slot = fd_ulong_min( leader_slot, slot );
+    else            other_slot  = fd_ulong_min( other_slot,  slot );
+  }
+  FD_TEST( leader_slot!=ULONG_MAX && other_slot!=ULONG_MAX );
+
+  ulong const fanouts[] = { 64UL, 200UL, 1536UL };
+  ulong pool_cnt = 0UL;
+  for( ulong i=0UL; i<3UL; i++ ) {
+    fd_shred_dest_cache_reset( cache, sdest, other_slot, fanouts[ i ] );
+    FD_TEST( fd_shred_dest_cache_done( cache ) ); /* nothing wanted yet */
+    fd_shred_dest_cache_want( cache, ULONG_MAX );
+    ulong built = 0UL;
+    for( ulong batch_cnt=1UL; !fd_shred_dest_cache_done( cache ); batch_cnt = batch_cnt%FD_SHRED_DEST_CACHE_BATCH_MAX+1UL ) {
+      built += fd_shred_dest_cache_build( cache, batch_cnt );
+    }
+    FD_TEST( built==cache->built_cnt );
+    FD_TEST( built==TEST_CACHE_IDX_MAX || cache->pool_cnt+2UL*fanouts[ i ]>TEST_CACHE_POOL_MAX );
+    check_cache( cache, sdest, other_slot, fanouts[ i ] );
+    pool_cnt = cache->pool_cnt;
+  }
+
+  /* As the leader, the fanout is ignored and the cache holds the root
+     of the Turbine tree */
+  fd_shred_dest_cache_reset( cache, sdest, leader_slot, 200UL );
+  fd_shred_dest_cache_want( cache, ULONG_MAX );
+  while( fd_shred_dest_cache_build( cache, FD_SHRED_DEST_CACHE_BATCH_MAX ) );
+  FD_TEST( cache->built_cnt==TEST_CACHE_IDX_MAX );
+  FD_TEST( cache->pool_cnt<=2UL*TEST_CACHE_IDX_MAX );
+  check_cache( cache, sdest, leader_slot, 0UL );
+
+  /* The table is only built as far as it is wanted, and resumes when
+     more is wanted */
+  fd_shred_dest_cache_reset( cache, sdest, other_slot, 200UL );
+  fd_shred_dest_cache_want( cache, 5UL );
+  while( fd_shred_dest_cache_build( cache, FD_SHRED_DEST_CACHE_BATCH_MAX ) );
+  FD_TEST( fd_shred_dest_cache_done( cache ) );
+  FD_TEST( cache->built_cnt==5UL );
+  fd_shred_dest_cache_want( cache, 3UL );
+  FD_TEST( fd_shred_dest_cache_done( cache ) );
+  FD_TEST( !fd_shred_dest_cache_build( cache, 1UL ) );
+  fd_shred_dest_cache_want( cache, 12UL );
+  FD_TEST( !fd_shred_dest_cache_done( cache ) );
+  while( fd_shred_dest_cache_build( cache, FD_SHRED_DEST_CACHE_BATCH_MAX ) );
+  FD_TEST( cache->built_cnt==12UL );
+  check_cache( cache, sdest, other_slot, 200UL );
+
+  /* A small pool stops the build early, but what was built is
+     complete */
+  FD_TEST( pool_cnt>=2UL );
+  ulong small_pool_max = pool_cnt/2UL;
+  fd_shred_dest_cache_t * small = fd_shred_dest_cache_join( fd_shred_dest_cache_new( _c_footprint, TEST_CACHE_IDX_MAX, small_pool_max ) );
+  fd_shred_dest_cache_reset( small, sdest, other_slot, 1536UL );
+  fd_shred_dest_cache_want( small, ULONG_MAX );
+  while( fd_shred_dest_cache_build( small, 4UL ) );
+  FD_TEST( fd_shred_dest_cache_done( small ) );
+  FD_TEST( small->built_cnt<TEST_CACHE_IDX_MAX );
+  FD_TEST( small->pool_cnt<=small_pool_max );
+  if( small->built_cnt ) check_cache( small, sdest, other_slot, 1536UL );
+
+  FD_TEST( fd_shred_dest_cache_delete( fd_shred_dest_cache_leave( small ) )==_c_footprint );
+  fd_shred_dest_delete( fd_shred_dest_leave( sdest ) );
+  fd_epoch_leaders_delete( fd_epoch_leaders_leave( lsched ) );
+}
+
 static void
 test_performance( void ) {
   ulong cnt = testnet_dest_info_sz / sizeof(fd_shred_dest_weighted_t);
@@ -496,6 +655,59 @@ test_performance( void ) {
   dt += fd_log_wallclock();
   FD_LOG_NOTICE(( "Compute children (16 shred/batch): %.2f ns/shred", (double)dt / (double)(16UL*TEST_CNT) ));
 #undef TEST_CNT
+
+  /* Retransmitting at the largest Turbine fanout: computing the
+     destinations of each shred as it arrives vs looking them up in a
+     table built ahead of time. */
+  ulong const fanout = FD_SHRED_DEST_MAX_FANOUT;
+  static fd_shred_dest_idx_t result_wide[ FD_SHRED_DEST_MAX_FANOUT ];
+  ulong slot = 1UL;
+  while( !memcmp( fd_epoch_leaders_get( lsched, slot ), src_key, 32UL ) ) slot++;
+  shred[0].slot = slot;
+
+  ulong sum = 0UL;
+  dt = -fd_log_wallclock();
+#define TEST_CNT 20000
+  for( ulong j=0UL; j<TEST_CNT; j++ ) {
+    shred[0].idx     = (uint)(j%TEST_CACHE_IDX_MAX);
+    shred[0].variant = (j/TEST_CACHE_IDX_MAX)&1UL ? FD_SHRED_TYPE_MERKLE_CODE : FD_SHRED_TYPE_MERKLE_DATA;
+    FD_TEST( fd_shred_dest_compute_children( sdest, shred_ptr, 1UL, result_wide, 1UL, fanout, fanout, max_dest_cnt ) );
+    sum += max_dest_cnt[0];
+  }
+  dt += fd_log_wallclock();
+  FD_LOG_NOTICE(( "Compute children (fanout %lu): %.2f ns/shred, %.3e shreds/sec", fanout, (double)dt / (double)TEST_CNT,
+                  1e9*(double)TEST_CNT / (double)dt ));
+
+  fd_shred_dest_cache_t * cache = fd_shred_dest_cache_join( fd_shred_dest_cache_new( _c_footprint, TEST_CACHE_IDX_MAX, TEST_CACHE_POOL_MAX ) );
+  fd_shred_dest_cache_reset( cache, sdest, slot, fanout );
+  fd_shred_dest_cache_want( cache, ULONG_MAX );
+  dt = -fd_log_wallclock();
+  while( fd_shred_dest_cache_build( cache, FD_SHRED_DEST_CACHE_BATCH_MAX ) );
+  dt += fd_log_wallclock();
+  ulong built = cache->built_cnt;
+  FD_TEST( built );
+  FD_LOG_NOTICE(( "Cache build (fanout %lu, off the critical path): %.2f ns/shred, %lu shreds, %lu dests",
+                  fanout, (double)dt / (double)(2UL*built), 2UL*built, cache->pool_cnt ));
+
+  ulong sum_cached = 0UL;
+  dt = -fd_log_wallclock();
+#undef TEST_CNT
+#define TEST_CNT 10000000
+  for( ulong j=0UL; j<TEST_CNT; j++ ) {
+    shred[0].idx     = (uint)(j%built);
+    shred[0].variant = (j/built)&1UL ? FD_SHRED_TYPE_MERKLE_CODE : FD_SHRED_TYPE_MERKLE_DATA;
+    ulong dest_cnt;
+    fd_shred_dest_idx_t const * dests = fd_shred_dest_cache_query( cache, sdest, shred, fanout, &dest_cnt );
+    FD_TEST( dests );
+    FD_COMPILER_FORGET( dests );
+    sum_cached += dest_cnt;
+  }
+  dt += fd_log_wallclock();
+  FD_LOG_NOTICE(( "Cache lookup (fanout %lu): %.2f ns/shred, %.3e shreds/sec (%lu dests)", fanout, (double)dt / (double)TEST_CNT,
+                  1e9*(double)TEST_CNT / (double)dt, sum+sum_cached ));
+#undef TEST_CNT
+
+  fd_shred_dest_cache_delete( fd_shred_dest_cache_leave( cache ) );
 }
 
 int
@@ -519,6 +731,8 @@ main( int     argc,
   test_change_contact();
   FD_LOG_NOTICE(( "Testing indeterminate" ));
   test_indeterminate();
+  FD_LOG_NOTICE(( "Testing cache" ));
+  test_cache();
   FD_LOG_NOTICE(( "Testing performance" ));
   test_performance();
 
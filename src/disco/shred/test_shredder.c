@@ -458,6 +458,62 @@ test_chained_merkle_shreds( void ) {
   FD_TEST( fd_memeq( chained_merkle_root, expected_final_chained_merkle_root, 32 ) );
 }
 
+/* test_deferred_signing checks that a shredder without a signer,
+   followed by fd_shredder_sign_fec_set, produces exactly the same
+   shreds as a shredder that signs inline. */
+
+static void
+test_deferred_signing( void ) {
+  static uchar deferred_memory_1[ 2048UL * FD_REEDSOL_DATA_SHREDS_MAX   ];
+  static uchar deferred_memory_2[ 2048UL * FD_REEDSOL_PARITY_SHREDS_MAX ];
+
+  ulong data_sz = 3UL*FD_SHREDDER_RESIGNED_FEC_SET_PAYLOAD_SZ;
+  for( ulong i=0UL; i<data_sz; i++ ) perf_test_entry_batch[ i ] = (uchar)(i*7UL);
+
+  fd_entry_batch_meta_t meta[1];
+  fd_memset( meta, 0, sizeof(fd_entry_batch_meta_t) );
+  meta->block_complete = 1;
+
+  signer_ctx_t signer_ctx[ 1 ];
+  signer_ctx_init( signer_ctx, test_private_key );
+
+  fd_shredder_t _deferred[ 1 ];
+  fd_shredder_t * shredder = fd_shredder_join( fd_shredder_new( _shredder, test_signer, signer_ctx ) ); FD_TEST( shredder );
+  fd_shredder_t * deferred = fd_shredder_join( fd_shredder_new( _deferred, NULL,        NULL       ) ); FD_TEST( deferred );
+
+  fd_fec_set_t _set[ 1 ];
+  fd_fec_set_t _dset[ 1 ];
+  for( ulong j=0UL; j<FD_REEDSOL_DATA_SHREDS_MAX;   j++ ) _set ->data_shreds  [ j ] = fec_set_memory_1  + 2048UL*j;
+  for( ulong j=0UL; j<FD_REEDSOL_PARITY_SHREDS_MAX; j++ ) _set ->parity_shreds[ j ] = fec_set_memory_2  + 2048UL*j;
+  for( ulong j=0UL; j<FD_REEDSOL_DATA_SHREDS_MAX;   j++ ) _dset->data_shreds  [ j ] = deferred_memory_1 + 2048UL*j;
+  for( ulong j=0UL; j<FD_REEDSOL_PARITY_SHREDS_MAX; j++ ) _dset->parity_shreds[ j ] = deferred_memory_2 + 2048UL*j;
+
+  uchar chained_root [ 32 ] = { 0 };
+  uchar dchained_root[ 32 ] = { 0 };
+
+  fd_shredder_init_batch( shredder, perf_test_entry_batch, data_sz, 10UL, meta );
+  fd_shredder_init_batch( deferred, perf_test_entry_batch, data_sz, 10UL, meta );
+  for( ulong i=0UL; i<3UL; i++ ) {
+    fd_bmtree_node_t root[1];
+    fd_fec_set_t * set  = fd_shredder_next_fec_set( shredder, _set,  chained_root,  NULL       );
+    fd_fec_set_t * dset = fd_shredder_next_fec_set( deferred, _dset, dchained_root, root->hash );
+    FD_TEST( set && dset );
+    FD_TEST( set->data_shred_cnt  ==dset->data_shred_cnt   );
+    FD_TEST( set->parity_shred_cnt==dset->parity_shred_cnt );
+
+    uchar signature[ 64 ];
+    test_signer( signer_ctx, signature, root->hash );
+    FD_TEST( fd_shredder_sign_fec_set( dset, signature )==dset );
+
+    for( ulong j=0UL; j<set->data_shred_cnt;   j++ ) FD_TEST( fd_memeq( set->data_shreds  [ j ], dset->data_shreds  [ j ], FD_SHRED_MIN_SZ ) );
+    for( ulong j=0UL; j<set->parity_shred_cnt; j++ ) FD_TEST( fd_memeq( set->parity_shreds[ j ], dset->parity_shreds[ j ], FD_SHRED_MAX_SZ ) );
+  }
+  FD_TEST( !fd_shredder_next_fec_set( deferred, _dset, dchained_root, NULL ) );
+  fd_shredder_fini_batch( shredder );
+  fd_shredder_fini_batch( deferred );
+  FD_TEST( fd_memeq( chained_root, dchained_root, 32UL ) );
+}
+
 static void
 perf_test( void ) {
   for( ulong i=0UL; i<PERF_TEST_SZ; i++ )  perf_test_entry_batch[ i ] = (uchar)i;
@@ -552,6 +608,7 @@ main( int     argc,
   test_shredder_count_chained();
   test_shredder_count_resigned();
   test_chained_merkle_shreds();
+  test_deferred_signing();
   perf_test();
   perf_test2();
 
@@ -457,7 +457,10 @@ test_dest_update( void ) {
   /* Test updating existing staked node */
   fd_pubkey_t pubkey_a;
   memset( pubkey_a.uc, 'A', sizeof(fd_pubkey_t) );
+  ulong seq = fd_stake_ci_get_sdest_seq_for_slot( info, 0UL );
+  FD_TEST( seq );
   fd_stake_ci_dest_update( info, &pubkey_a, 0x12345678U, 8080 );
+  FD_TEST( fd_stake_ci_get_sdest_seq_for_slot( info, 0UL )==seq ); /* address only */
 
   fd_shred_dest_t * sdest = fd_stake_ci_get_sdest_for_slot( info, 0UL );
   fd_shred_dest_idx_t idx_a = fd_shred_dest_pubkey_to_idx( sdest, &pubkey_a );
@@ -474,6 +477,7 @@ test_dest_update( void ) {
 
   /* D should now be in the unstaked list */
   check_destinations( info, 0UL, "ABC", "DI" );
+  FD_TEST( fd_stake_ci_get_sdest_seq_for_slot( info, 0UL )!=seq );
 
   fd_shred_dest_idx_t idx_d = fd_shred_dest_pubkey_to_idx( sdest, &pubkey_d );
   FD_TEST( idx_d != FD_SHRED_DEST_NO_DEST );
@@ -645,6 +649,63 @@ test_dest_remove( void ) {
   fd_stake_ci_delete( fd_stake_ci_leave( info ) );
 }
 
+static void
+test_staged( void ) {
+  static fd_pubkey_t expected[ SLOTS_PER_EPOCH ];
+  fd_stake_ci_t * info = fd_stake_ci_join( fd_stake_ci_new( _info, identity_key ) );
+
+  fd_stake_ci_stake_msg_init( info, generate_stake_msg( stake_msg, 0UL, "ABCDEF" ) );  FD_TEST( !fd_stake_ci_stake_msg_fini( info ) );
+  fd_stake_ci_dest_add_fini( info, generate_dest_add( fd_stake_ci_dest_add_init( info ), "ABCH" ) );
+  check_destinations( info, 0UL, "ABCDEF", "HI" );
+
+  /* Staging does not affect queries */
+  fd_stake_ci_stake_msg_stage_init( info, generate_stake_msg( stake_msg, 1UL, "DCAF" ) );  fd_stake_ci_stake_msg_stage_fini( info );
+  check_destinations( info, 0UL, "ABCDEF", "HI" );
+  check_destinations( info, 1UL, NULL,     NULL );
+
+  /* Contact info updates after staging are applied to it */
+  fd_stake_ci_dest_add_fini( info, generate_dest_add( fd_stake_ci_dest_add_init( info ), "ABCHJ" ) );
+  fd_pubkey_t pubkey_k; memset( pubkey_k.uc, 'K', sizeof(fd_pubkey_t) );
+  fd_stake_ci_dest_update( info, &pubkey_k, 0x01010101U, 1234 );
+  check_destinations( info, 0UL, "ABCDEF", "HIJK" );
+
+  fd_stake_ci_stake_msg_init( info, generate_stake_msg( stake_msg, 1UL, "DCAF" ) );  FD_TEST( fd_stake_ci_stake_msg_fini( info ) );
+  check_destinations( info, 0UL, "ABCDEF", "HIJK" );
+  check_destinations( info, 1UL, "DCAF",   "BHIJK" );
+
+  fd_epoch_leaders_t * lsched = fd_stake_ci_get_lsched_for_slot( info, SLOTS_PER_EPOCH );
+  for( ulong s=0UL; s<SLOTS_PER_EPOCH; s++ ) expected[ s ] = *fd_epoch_leaders_get( lsched, SLOTS_PER_EPOCH+s );
+
+  /* The staged info is consumed, and computing it the usual way gives
+     the same result. */
+  fd_stake_ci_stake_msg_init( info, generate_stake_msg( stake_msg, 1UL, "DCAF" ) );  FD_TEST( !fd_stake_ci_stake_msg_fini( info ) );
+  check_destinations( info, 1UL, "DCAF",   "BHIJK" );
+  lsched = fd_stake_ci_get_lsched_for_slot( info, SLOTS_PER_EPOCH );
+  for( ulong s=0UL; s<SLOTS_PER_EPOCH; s++ ) FD_TEST( fd_memeq( fd_epoch_leaders_get( lsched, SLOTS_PER_EPOCH+s ), expected+s, sizeof(fd_pubkey_t) ) );
+
+  /* A different message for the staged epoch discards it */
+  fd_stake_ci_stake_msg_stage_init( info, generate_stake_msg( stake_msg, 2UL, "H" ) );  fd_stake_ci_stake_msg_stage_fini( info );
+  fd_stake_ci_stake_msg_init( info, generate_stake_msg( stake_msg, 2UL, "HA" ) );  FD_TEST( !fd_stake_ci_stake_msg_fini( info ) );
+  check_destinations( info, 2UL, "HA", "BCIJK" );
+
+  /* A message for another epoch keeps it, a contact info removal is
+     applied to it */
+  fd_stake_ci_stake_msg_stage_init( info, generate_stake_msg( stake_msg, 4UL, "A" ) );  fd_stake_ci_stake_msg_stage_fini( info );
+  fd_stake_ci_stake_msg_init( info, generate_stake_msg( stake_msg, 3UL, "H" ) );  FD_TEST( !fd_stake_ci_stake_msg_fini( info ) );
+  fd_stake_ci_dest_remove( info, &pubkey_k );
+  fd_stake_ci_stake_msg_init( info, generate_stake_msg( stake_msg, 4UL, "A" ) );  FD_TEST( fd_stake_ci_stake_msg_fini( info ) );
+  check_destinations( info, 3UL, "H", "ABCIJ" );
+  check_destinations( info, 4UL, "A", "BCHIJ" );
+
+  /* Changing the identity discards it */
+  fd_stake_ci_stake_msg_stage_init( info, generate_stake_msg( stake_msg, 5UL, "AB" ) );  fd_stake_ci_stake_msg_stage_fini( info );
+  fd_stake_ci_set_identity( info, identity_key );
+  fd_stake_ci_stake_msg_init( info, generate_stake_msg( stake_msg, 5UL, "AB" ) );  FD_TEST( !fd_stake_ci_stake_msg_fini( info ) );
+  check_destinations( info, 5UL, "AB", "CHIJ" );
+
+  fd_stake_ci_delete( fd_stake_ci_leave( info ) );
+}
+
 int
 main( int     argc,
       char ** argv ) {
@@ -675,6 +736,7 @@ main( int     argc,
 
   test_dest_update();
   test_dest_remove();
+  test_staged();
 
   FD_LOG_NOTICE(( "pass" ));
   fd_halt();
@@ -33,6 +33,11 @@ struct fd_sign_in_ctx {
   ulong            chunk0;
   ulong            wmark;
   ulong            mtu;
+
+  /* Only used for links with batched requests (see after_frag) */
+  fd_frag_meta_t const * mcache;
+  ulong                  depth;
+  ulong                  seq;    /* seq of the next request */
 };
 typedef struct fd_sign_in_ctx fd_sign_in_ctx_t;
 
@@ -56,6 +61,19 @@ typedef struct {
   uchar *           private_key;
 
   fd_histf_t        sign_duration[1];
+
+  /* Shred tiles send one signing request per FEC set Merkle root, and
+     keep several of them in flight.  Merkle root requests that are
+     pending at the same time are signed together with
+     fd_ed25519_sign_batch. */
+  ulong batch_cnt;
+  struct {
+    ulong in_idx;
+    ulong sig;
+    ulong tsorig;
+    uchar root[ 32 ];
+  } batch[ FD_ED25519_SIGN_BATCH_MAX ];
+  uchar batch_scratch[ FD_ED25519_SIGN_BATCH_MAX ][ 64UL+32UL ];
 } fd_sign_ctx_t;
 
 FD_FN_CONST static inline ulong
@@ -85,8 +103,14 @@ derive_fields( fd_sign_ctx_t * ctx ) {
   memcpy( ctx->event_concat, "FD_METRICS_REPORT-", 18UL );
 }
 
+/* keyswitch_sensitive applies a pending key switch.  Merkle roots
+   queued in the batch were received under the current identity, so the
+   switch is left pending until the batch is flushed (batch_flush
+   applies it right after signing the batch). */
+
 static void FD_FN_SENSITIVE
-during_housekeeping_sensitive( fd_sign_ctx_t * ctx ) {
+keyswitch_sensitive( fd_sign_ctx_t * ctx ) {
+  if( FD_UNLIKELY( ctx->batch_cnt ) ) return;
   if( FD_UNLIKELY( fd_keyswitch_state_query( ctx->keyswitch )==FD_KEYSWITCH_STATE_SWITCH_PENDING ) ) {
     memcpy( ctx->private_key, ctx->keyswitch->bytes, 32UL );
     explicit_bzero( ctx->keyswitch->bytes, 32UL );
@@ -100,7 +124,7 @@ during_housekeeping_sensitive( fd_sign_ctx_t * ctx ) {
 
 static inline void
 during_housekeeping( fd_sign_ctx_t * ctx ) {
-  during_housekeeping_sensitive( ctx );
+  keyswitch_sensitive( ctx );
 }
 
 static inline void
@@ -108,6 +132,72 @@ metrics_write( fd_sign_ctx_t * ctx ) {
   FD_MHIST_COPY( SIGN, SIGN_DURATION_SECONDS, ctx->sign_duration );
 }
 
+/* batch_flush signs all the pending Merkle root requests and publishes
+   the signatures, in request order. */
+
+static void FD_FN_SENSITIVE
+batch_flush_sensitive( fd_sign_ctx_t *     ctx,
+                       fd_stem_context_t * stem ) {
+  ulong batch_cnt = ctx->batch_cnt;
+
+  uchar const * msgs   [ FD_ED25519_SIGN_BATCH_MAX ];
+  ulong         msg_szs[ FD_ED25519_SIGN_BATCH_MAX ];
+  uchar *       sigs   [ FD_ED25519_SIGN_BATCH_MAX ];
+  uchar *       scratch[ FD_ED25519_SIGN_BATCH_MAX ];
+  ulong         chunks [ FD_ED25519_SIGN_BATCH_MAX ];
+  for( ulong j=0UL; j<batch_cnt; j++ ) {
+    ulong in_idx = ctx->batch[ j ].in_idx;
+    msgs   [ j ] = ctx->batch[ j ].root;
+    msg_szs[ j ] = 32UL;
+    chunks [ j ] = ctx->out[ in_idx ].out_chunk;
+    sigs   [ j ] = fd_chunk_to_laddr( ctx->out[ in_idx ].out_mem, chunks[ j ] );
+    scratch[ j ] = ctx->batch_scratch[ j ];
+    ctx->out[ in_idx ].out_chunk = fd_dcache_compact_next( ctx->out[ in_idx ].out_chunk, 64UL, ctx->out[ in_idx ].out_chunk0, ctx->out[ in_idx ].out_wmark );
+  }
+
+  long sign_duration = -fd_tickcount();
+  FD_TEST( fd_ed25519_sign_batch( sigs, msgs, msg_szs, scratch, batch_cnt, ctx->public_key, ctx->private_key, ctx->sha512 )==FD_ED25519_SUCCESS );
+  sign_duration += fd_tickcount();
+
+  for( ulong j=0UL; j<batch_cnt; j++ ) {
+    fd_histf_sample( ctx->sign_duration, (ulong)sign_duration/batch_cnt );
+    fd_stem_publish( stem, ctx->batch[ j ].in_idx, ctx->batch[ j ].sig, chunks[ j ], 64UL, 0UL, ctx->batch[ j ].tsorig, 0UL );
+  }
+  ctx->batch_cnt = 0UL;
+
+  keyswitch_sensitive( ctx );
+}
+
+static void
+batch_flush( fd_sign_ctx_t *     ctx,
+             fd_stem_context_t * stem ) {
+  batch_flush_sensitive( ctx, stem );
+}
+
+/* after_credit flushes the pending Merkle root requests once no more
+   requests are ready on the links they came from, i.e. the batch
+   contains every request that was pending. */
+
+static inline void
+after_credit( fd_sign_ctx_t *     ctx,
+              fd_stem_context_t * stem,
+              int *               opt_poll_in,
+              int *               charge_busy ) {
+  (void)opt_poll_in;
+
+  ulong batch_cnt = ctx->batch_cnt;
+  if( FD_LIKELY( !batch_cnt ) ) return;
+
+  for( ulong j=0UL; j<batch_cnt; j++ ) {
+    fd_sign_in_ctx_t const * in = &ctx->in[ ctx->batch[ j ].in_idx ];
+    fd_frag_meta_t const * mline = in->mcache + fd_mcache_line_idx( in->seq, in->depth );
+    if( fd_seq_eq( fd_frag_meta_seq_query( mline ), in->seq ) ) return; /* more requests ready */
+  }
+
+  *charge_busy = 1;
+  batch_flush( ctx, stem );
+}
+
 /* during_frag is called between pairs for sequence number checks, as
    we are reading incoming frags.  We don't actually need to copy the
    fragment here, see fd_dedup.c for why we do this.*/
@@ -157,7 +247,6 @@ after_frag_sensitive( void *              _ctx,
                       ulong               tsorig,
                       ulong               tspub,
                       fd_stem_context_t * stem ) {
-  (void)seq;
   (void)tspub;
 
   fd_sign_ctx_t * ctx = (fd_sign_ctx_t *)_ctx;
@@ -177,6 +266,18 @@ after_frag_sensitive( void *              _ctx,
     FD_LOG_EMERG(( "fd_keyguard_payload_authorize failed (role=%d sign_type=%d)", role, sign_type ));
   }
 
+  if( FD_LIKELY( role==FD_KEYGUARD_ROLE_LEADER && sign_type==FD_KEYGUARD_SIGN_TYPE_ED25519 ) ) {
+    /* Merkle root, queue it (see after_credit) */
+    ulong j = ctx->batch_cnt++;
+    ctx->batch[ j ].in_idx = in_idx;
+    ctx->batch[ j ].sig    = sig;
+    ctx->batch[ j ].tsorig = tsorig;
+    memcpy( ctx->batch[ j ].root, ctx->_data, 32UL );
+    ctx->in[ in_idx ].seq  = fd_seq_inc( seq, 1UL );
+    if( FD_UNLIKELY( ctx->batch_cnt==FD_ED25519_SIGN_BATCH_MAX ) ) batch_flush( ctx, stem );
+    return;
+  }
+
   long sign_duration = -fd_tickcount();
 
   uchar * dst = fd_chunk_to_laddr( ctx->out[ in_idx ].out_mem, ctx->out[ in_idx ].out_chunk );
@@ -279,6 +380,7 @@ unprivileged_init_sensitive( fd_topo_t *      topo,
   ctx->keyswitch = fd_keyswitch_join( fd_topo_obj_laddr( topo, tile->keyswitch_obj_id ) );
   derive_fields( ctx );
 
+  ctx->batch_cnt = 0UL;
   for( ulong i=0UL; i<MAX_IN; i++ ) ctx->in[ i ].role = -1;
 
   for( ulong i=0UL; i<tile->in_cnt; i++ ) {
@@ -298,6 +400,9 @@ unprivileged_init_sensitive( fd_topo_t *      topo,
 
     if( !strcmp( in_link->name, "shred_sign" ) ) {
       ctx->in[ i ].role = FD_KEYGUARD_ROLE_LEADER;
+      ctx->in[ i ].mcache = in_link->mcache;
+      ctx->in[ i ].depth  = fd_mcache_depth( in_link->mcache );
+      ctx->in[ i ].seq    = fd_mcache_seq0( in_link->mcache );
       FD_TEST( !strcmp( out_link->name, "sign_shred" ) );
       FD_TEST( in_link->mtu==32UL );
       FD_TEST( out_link->mtu==64UL );
@@ -381,7 +486,8 @@ populate_allowed_fds( fd_topo_t const *      topo,
   return out_cnt;
 }
 
-#define STEM_BURST (1UL)
+/* Flushing a batch publishes up to one signature per request */
+#define STEM_BURST FD_ED25519_SIGN_BATCH_MAX
 
 /* See explanation in fd_pack */
 #define STEM_LAZY  (128L*3000L)
@@ -391,6 +497,7 @@ populate_allowed_fds( fd_topo_t const *      topo,
 
 #define STEM_CALLBACK_DURING_HOUSEKEEPING during_housekeeping
 #define STEM_CALLBACK_METRICS_WRITE       metrics_write
+#define STEM_CALLBACK_AFTER_CREDIT        after_credit
 #define STEM_CALLBACK_DURING_FRAG         during_frag
 #define STEM_CALLBACK_AFTER_FRAG          after_frag
 
@@ -1,8 +1,11 @@
 ifdef FD_HAS_INT128
-$(call add-hdrs,fd_store.h)
-$(call add-objs,fd_store,fd_disco)
+$(call add-hdrs,fd_store.h fd_store_ledger.h)
+$(call add-objs,fd_store fd_store_ledger,fd_disco)
 ifdef FD_HAS_HOSTED
 $(call make-unit-test,test_store,test_store,fd_disco fd_flamenco fd_tango fd_ballet fd_util)
 $(call run-unit-test,test_store)
+$(call make-unit-test,test_store_ledger,test_store_ledger,fd_disco fd_flamenco fd_tango fd_ballet fd_util)
+$(call run-unit-test,test_store_ledger)
+$(call make-unit-test,bench_store,bench_store,fd_disco fd_flamenco fd_tango fd_ballet fd_util)
 endif
 endif
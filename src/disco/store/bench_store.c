@@ -0,0 +1,222 @@
+/* bench_store measures the latency of Shred tile inserts into the
+   store while Replay concurrently links the inserted FEC sets and
+   publishes new roots.
+
+   Tiles 1..shred_cnt play the Shred tiles: each inserts FEC sets into
+   its own partition (timing the pinned section of the insert, like
+   fd_shred_tile), copies in the payload and hands the merkle root off
+   to the publisher over a small SPSC ring (playing the role of Repair's
+   notification).  Tile 0 plays the Replay tile: it links every FEC set
+   it receives onto a single fork and publishes a new root lagging the
+   tip every --publish-every FEC sets, pruning the FEC sets below it.
+
+   With --rwlock 1, inserts take a shared rwlock and publishes take it
+   exclusively (the locking scheme the store used before publish was
+   made concurrent with inserts) for comparison. */
+
+#include "fd_store.h"
+#include "../../flamenco/fd_rwlock.h"
+#include "../../tango/tempo/fd_tempo.h"
+
+#define SORT_NAME        sort_lat
+#define SORT_KEY_T       ulong
+#define SORT_BEFORE(a,b) ((a)<(b))
+#include "../../util/tmpl/fd_sort.c"
+
+#define RING_DEPTH (64UL)
+
+struct __attribute__((aligned(128))) ring {
+  ulong     wseq;                /* written by the shred tile */
+  ulong     rseq __attribute__((aligned(128))); /* written by the publisher */
+  fd_hash_t mr[ RING_DEPTH ];
+};
+typedef struct ring ring_t;
+
+static fd_store_t *  store;
+static fd_rwlock_t   lock[1];
+static ring_t *      ring;
+static ulong **      lat;
+static ulong         tile_go;
+static ulong         insert_cnt;
+static ulong         data_sz;
+static int           use_rwlock;
+static uchar         data[ FD_STORE_DATA_MAX ];
+
+static int
+shred_tile_main( int     argc,
+                 char ** argv ) {
+  (void)argc; (void)argv;
+
+  ulong    tile_idx = fd_tile_idx();
+  ulong    part_idx = tile_idx - 1UL;
+  ring_t * r        = ring + part_idx;
+  ulong *  l        = lat[ part_idx ];
+
+  while( !FD_VOLATILE_CONST( tile_go ) ) FD_SPIN_PAUSE();
+
+  for( ulong i=0UL; i<insert_cnt; i++ ) {
+    fd_hash_t mr = { .ul = { fd_ulong_hash( (tile_idx<<48) | i ), tile_idx, i } };
+
+    while( r->wseq - FD_VOLATILE_CONST( r->rseq ) >= RING_DEPTH ) FD_SPIN_PAUSE();
+
+    fd_store_fec_t * fec = NULL;
+    long t0 = fd_tickcount();
+    if( use_rwlock ) fd_rwlock_read( lock );
+    fd_store_shacq( store, part_idx );
+    fec = fd_store_insert( store, part_idx, &mr );
+    fd_store_shrel( store, part_idx );
+    if( use_rwlock ) fd_rwlock_unread( lock );
+    long t1 = fd_tickcount();
+    if( FD_UNLIKELY( !fec ) ) FD_LOG_ERR(( "insert failed on tile %lu (increase --fec-max)", tile_idx ));
+    l[ i ] = (ulong)fd_long_max( t1-t0, 0L );
+
+    fd_memcpy( fec->data, data, data_sz );
+    fec->data_sz = data_sz;
+
+    r->mr[ r->wseq % RING_DEPTH ] = mr;
+    FD_COMPILER_MFENCE();
+    FD_VOLATILE( r->wseq ) = r->wseq + 1UL;
+  }
+
+  return 0;
+}
+
+static void
+report( char const * name,
+        ulong *      l,
+        ulong        cnt,
+        double       ns_per_tick ) {
+  if( FD_UNLIKELY( !cnt ) ) return;
+  sort_lat_inplace( l, cnt );
+  ulong sum = 0UL;
+  for( ulong i=0UL; i<cnt; i++ ) sum += l[ i ];
+# define PCTL(p) ((double)l[ fd_ulong_min( (ulong)((double)cnt*(p)), cnt-1UL ) ]*ns_per_tick)
+  FD_LOG_NOTICE(( "%-10s cnt %9lu  mean %8.1f ns  p50 %8.1f ns  p99 %8.1f ns  p99.9 %9.1f ns  p99.99 %10.1f ns  max %11.1f ns",
+                  name, cnt, ((double)sum/(double)cnt)*ns_per_tick,
+                  PCTL(0.5), PCTL(0.99), PCTL(0.999), PCTL(0.9999), (double)l[ cnt-1UL ]*ns_per_tick ));
+# undef PCTL
+}
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  char const * _page_sz      = fd_env_strip_cmdline_cstr ( &argc, &argv, "--page-sz",       NULL, "gigantic" );
+  ulong        page_cnt      = fd_env_strip_cmdline_ulong( &argc, &argv, "--page-cnt",      NULL,        1UL );
+  ulong        near_cpu      = fd_env_strip_cmdline_ulong( &argc, &argv, "--near-cpu",      NULL, fd_log_cpu_id() );
+  ulong        fec_max       = fd_env_strip_cmdline_ulong( &argc, &argv, "--fec-max",       NULL,     4096UL );
+  ulong        shred_cnt     = fd_env_strip_cmdline_ulong( &argc, &argv, "--shred-cnt",     NULL,        4UL );
+  ulong        lag           = fd_env_strip_cmdline_ulong( &argc, &argv, "--lag",           NULL,      512UL );
+  ulong        publish_every = fd_env_strip_cmdline_ulong( &argc, &argv, "--publish-every", NULL,       64UL );
+  /**/         insert_cnt    = fd_env_strip_cmdline_ulong( &argc, &argv, "--insert-cnt",    NULL,   100000UL );
+  /**/         data_sz       = fd_env_strip_cmdline_ulong( &argc, &argv, "--data-sz",       NULL,    31840UL );
+  /**/         use_rwlock    = fd_env_strip_cmdline_int  ( &argc, &argv, "--rwlock",        NULL,          0 );
+
+  if( FD_UNLIKELY( shred_cnt+1UL>fd_tile_cnt() ) ) FD_LOG_ERR(( "--shred-cnt %lu needs at least %lu tiles (use --tile-cpus)", shred_cnt, shred_cnt+1UL ));
+  if( FD_UNLIKELY( !shred_cnt || shred_cnt>=FD_STORE_PART_MAX ) ) FD_LOG_ERR(( "--shred-cnt must be in [1,%lu)", FD_STORE_PART_MAX ));
+  if( FD_UNLIKELY( data_sz>FD_STORE_DATA_MAX ) ) FD_LOG_ERR(( "--data-sz must be at most %lu", FD_STORE_DATA_MAX ));
+  if( FD_UNLIKELY( !publish_every ) ) FD_LOG_ERR(( "--publish-every must be positive" ));
+  if( FD_UNLIKELY( lag + 2UL*(publish_every+RING_DEPTH) + shred_cnt*RING_DEPTH > fec_max ) ) FD_LOG_ERR(( "--fec-max too small for --lag, --publish-every and --shred-cnt" ));
+
+  FD_LOG_NOTICE(( "--shred-cnt %lu --fec-max %lu --lag %lu --publish-every %lu --insert-cnt %lu --data-sz %lu --rwlock %d",
+                  shred_cnt, fec_max, lag, publish_every, insert_cnt, data_sz, use_rwlock ));
+
+  fd_wksp_t * wksp = fd_wksp_new_anonymous( fd_cstr_to_shmem_page_sz( _page_sz ), page_cnt, near_cpu, "wksp", 0UL );
+  FD_TEST( wksp );
+
+  void * mem = fd_wksp_alloc_laddr( wksp, FD_STORE_ALIGN, fd_store_footprint( fec_max ), 1UL );
+  if( FD_UNLIKELY( !mem ) ) FD_LOG_ERR(( "unable to allocate store (increase --page-cnt)" ));
+  store = fd_store_join( fd_store_new( mem, fec_max, shred_cnt ) );
+  FD_TEST( store );
+  fd_rwlock_new( lock );
+
+  ring = fd_wksp_alloc_laddr( wksp, alignof(ring_t), shred_cnt*sizeof(ring_t), 1UL );
+  lat  = fd_wksp_alloc_laddr( wksp, alignof(ulong *), shred_cnt*sizeof(ulong *), 1UL );
+  FD_TEST( ring && lat );
+  fd_memset( ring, 0, shred_cnt*sizeof(ring_t) );
+  for( ulong i=0UL; i<shred_cnt; i++ ) {
+    lat[ i ] = fd_wksp_alloc_laddr( wksp, alignof(ulong), insert_cnt*sizeof(ulong), 1UL );
+    if( FD_UNLIKELY( !lat[ i ] ) ) FD_LOG_ERR(( "unable to allocate samples (increase --page-cnt)" ));
+  }
+
+  /* The publisher keeps the merkle roots of the fork from the root to
+     the tip in a circular buffer. */
+
+  ulong       chain_max = fd_ulong_pow2_up( lag + publish_every + RING_DEPTH + 1UL );
+  fd_hash_t * chain     = fd_wksp_alloc_laddr( wksp, alignof(fd_hash_t), chain_max*sizeof(fd_hash_t), 1UL );
+  ulong       pub_max   = insert_cnt*shred_cnt/publish_every + 1UL;
+  ulong *     pub_lat   = fd_wksp_alloc_laddr( wksp, alignof(ulong), pub_max*sizeof(ulong), 1UL );
+  FD_TEST( chain && pub_lat );
+
+  ulong pub = fd_store_pub_part( store );
+  chain[ 0 ] = (fd_hash_t){ .ul = { ULONG_MAX } };
+  fd_store_shacq( store, pub );
+  FD_TEST( fd_store_insert( store, pub, &chain[ 0 ] ) );
+  fd_store_shrel( store, pub );
+  ulong root_seq = 0UL; /* chain seq of the root */
+  ulong tip_seq  = 0UL; /* chain seq of the tip */
+
+  for( ulong i=1UL; i<=shred_cnt; i++ ) fd_tile_exec_new( i, shred_tile_main, 0, NULL );
+
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( tile_go ) = 1UL;
+  FD_COMPILER_MFENCE();
+
+  long  dt        = -fd_log_wallclock();
+  ulong total     = insert_cnt*shred_cnt;
+  ulong linked    = 0UL;
+  ulong pub_cnt   = 0UL;
+  while( linked<total ) {
+    for( ulong i=0UL; i<shred_cnt; i++ ) {
+      ring_t * r    = ring + i;
+      ulong    wseq = FD_VOLATILE_CONST( r->wseq );
+      if( FD_LIKELY( r->rseq==wseq ) ) continue;
+      if( use_rwlock ) fd_rwlock_read( lock );
+      fd_store_shacq( store, pub );
+      for( ulong seq=r->rseq; seq<wseq; seq++ ) {
+        fd_hash_t mr = r->mr[ seq % RING_DEPTH ];
+        FD_TEST( fd_store_link( store, &mr, &chain[ tip_seq % chain_max ] ) );
+        chain[ ++tip_seq % chain_max ] = mr;
+      }
+      fd_store_shrel( store, pub );
+      if( use_rwlock ) fd_rwlock_unread( lock );
+      linked += wseq - r->rseq;
+      FD_COMPILER_MFENCE();
+      FD_VOLATILE( r->rseq ) = wseq;
+
+      if( FD_UNLIKELY( tip_seq>=root_seq+lag+publish_every ) ) {
+        root_seq = tip_seq - lag;
+        long t0 = fd_tickcount();
+        if( use_rwlock ) fd_rwlock_write( lock );
+        fd_store_shacq( store, pub );
+        FD_TEST( fd_store_publish( store, &chain[ root_seq % chain_max ] ) );
+        fd_store_shrel( store, pub );
+        if( use_rwlock ) fd_rwlock_unwrite( lock );
+        pub_lat[ pub_cnt++ ] = (ulong)fd_long_max( fd_tickcount()-t0, 0L );
+      }
+    }
+  }
+  dt += fd_log_wallclock();
+
+  for( ulong i=1UL; i<=shred_cnt; i++ ) fd_tile_exec_delete( fd_tile_exec( i ), NULL );
+
+  FD_LOG_NOTICE(( "inserted %lu FEC sets in %.3f s (%.3g per sec), published %lu roots", total, (double)dt/1e9, (double)total/((double)dt/1e9), pub_cnt ));
+
+  double ns_per_tick = 1.0/fd_tempo_tick_per_ns( NULL );
+  ulong * all = fd_wksp_alloc_laddr( wksp, alignof(ulong), total*sizeof(ulong), 1UL );
+  for( ulong i=0UL; i<shred_cnt; i++ ) {
+    char name[ 16 ];
+    if( all ) fd_memcpy( all + i*insert_cnt, lat[ i ], insert_cnt*sizeof(ulong) );
+    report( fd_cstr_printf( name, sizeof(name), NULL, "insert %lu", i ), lat[ i ], insert_cnt, ns_per_tick );
+  }
+  if( all ) report( "insert all", all, total, ns_per_tick );
+  report( "publish", pub_lat, pub_cnt, ns_per_tick );
+
+  FD_TEST( fd_store_verify( store ) == 0 );
+
+  fd_wksp_delete_anonymous( wksp );
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
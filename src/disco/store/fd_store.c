@@ -10,8 +10,8 @@ static const fd_hash_t hash_null = { 0 };
 void *
 fd_store_new( void * shmem, ulong fec_max, ulong part_cnt ) {
 
-  if( FD_UNLIKELY( part_cnt==0UL ) ) {
-    FD_LOG_WARNING(( "partition count must be greater than 0, should match the number of writers/shred tiles" ));
+  if( FD_UNLIKELY( part_cnt==0UL || part_cnt>=FD_STORE_PART_MAX ) ) {
+    FD_LOG_WARNING(( "partition count must be in [1,%lu), should match the number of writers/shred tiles", FD_STORE_PART_MAX ));
     return NULL;
   }
 
@@ -42,8 +42,9 @@ fd_store_new( void * shmem, ulong fec_max, ulong part_cnt ) {
      fec_max / part_cnt. When inserting into the map, we use the
      partition_slot_cnt as the seed, so that the modified hash function
      can use the seed/partition_slot_cnt to hash the key into the
-     correct partition. */
+     correct partition.  The last partition is the publisher's. */
 
+  part_cnt++;
   ulong part_slot_cnt = fec_max / part_cnt;
   ulong seed          = part_slot_cnt;
 
@@ -63,6 +64,13 @@ fd_store_new( void * shmem, ulong fec_max, ulong part_cnt ) {
   store->part_cnt = part_cnt;
   store->fec_max  = fec_max;
   store->root     = null;
+  store->epoch    = 1UL; /* 0 is reserved for pruned elements */
+  for( ulong i = 0UL; i < FD_STORE_PART_MAX; i++ ) {
+    store->part[ i ].epoch      = ULONG_MAX;
+    store->part[ i ].retire     = null;
+    store->part[ i ].limbo_head = null;
+    store->part[ i ].limbo_tail = null;
+  }
 
   fd_store_pool_t pool = fd_store_pool( store );
   if( FD_UNLIKELY( !fd_store_pool_new( shpool ) ) ) {
@@ -147,7 +155,14 @@ fd_store_fec_t *
 fd_store_insert( fd_store_t * store,
                  ulong        part_idx,
                  fd_hash_t  * merkle_root ) {
-  if( FD_UNLIKELY( fd_store_query_const( store, merkle_root ) ) ) {
+
+# if FD_STORE_USE_HANDHOLDING
+  if( FD_UNLIKELY( part_idx >= store->part_cnt ) ) { FD_LOG_WARNING(( "bad part_idx %lu", part_idx )); return NULL; }
+# endif
+
+  fd_store_reclaim( store, part_idx );
+
+  if( FD_UNLIKELY( fd_store_private_query_idx( store, merkle_root ) != ULONG_MAX ) ) {
     FD_LOG_WARNING(( "Merkle root %s already in store.  Ignoring insert.", FD_BASE58_ENC_32_ALLOCA( merkle_root ) ));
     return NULL;
   }
@@ -167,6 +182,14 @@ fd_store_insert( fd_store_t * store,
   fec->parent           = null;
   fec->child            = null;
   fec->sibling          = null;
+  fec->retire           = null;
+  fec->epoch            = ULONG_MAX;
+  fec->slot             = ULONG_MAX;
+  fec->fec_set_idx      = UINT_MAX;
+  fec->parent_off       = 0;
+  fec->data_cnt         = 0;
+  fec->data_complete    = 0;
+  fec->slot_complete    = 0;
   fec->data_sz          = 0UL;
   if( FD_UNLIKELY( store->root == null ) ) store->root = fd_store_pool_idx( &pool, fec );
   fd_store_map_ele_insert( fd_store_map( store ), fec, fd_store_fec0( store ) );
@@ -187,6 +210,7 @@ fd_store_link( fd_store_t * store, fd_hash_t * merkle_root, fd_hash_t * chained_
   fd_store_fec_t  * child  = fd_store_query( store, merkle_root );
 
   if( FD_UNLIKELY( child->parent != null ) ) return child; /* already linked */
+  child->cmr    = *chained_merkle_root;
   child->parent = fd_store_pool_idx( &pool, parent );
   if( FD_LIKELY( parent->child == null ) ) {
     parent->child = fd_store_pool_idx( &pool, child ); /* set as left-child. */
@@ -206,45 +230,127 @@ fd_store_publish( fd_store_t *      store,
   if( FD_UNLIKELY( !fd_store_query( store, merkle_root ) ) ) { FD_LOG_WARNING(( "merkle root %s not found", FD_BASE58_ENC_32_ALLOCA( merkle_root ) )); return NULL; }
 # endif
 
-  fd_store_map_t  * map  = fd_store_map ( store );
+  fd_store_reclaim( store, fd_store_pub_part( store ) );
+
   fd_store_pool_t   pool = fd_store_pool( store );
-  fd_store_fec_t  * fec0 = fd_store_fec0( store );
   fd_store_fec_t  * oldr = fd_store_root( store );
   fd_store_fec_t  * newr = fd_store_query( store, merkle_root );
 
-  /* First, remove the previous root, and push it as the first element
-     of the BFS queue. */
+  /* Pruned elements are collected into a retire list per partition,
+     which are then pushed onto the partitions' retire lists all at once
+     (see PUBLISHING). */
 
-  fd_store_fec_t * head = fd_store_map_ele_remove( map, &oldr->key, NULL, fec0 );
-  head->next            = null; /* clear map next */
+  ulong retire_head[ FD_STORE_PART_MAX ];
+  ulong retire_tail[ FD_STORE_PART_MAX ];
+  for( ulong i = 0UL; i < store->part_cnt; i++ ) retire_head[ i ] = retire_tail[ i ] = null;
+
+  /* First, push the previous root as the first element of the BFS
+     queue.  The queue is linked with `.retire` because the pruned
+     elements are still in the map so `.next` is still in use. */
+
+  fd_store_fec_t * head = oldr;
+  head->retire          = null;
   fd_store_fec_t * tail = head; /* tail of BFS queue */
 
   /* Second, BFS down the tree, pruning all of root's ancestors and also
      any descendants of those ancestors. */
 
   while( FD_LIKELY( head ) ) {
-    fd_store_fec_t * child = fd_store_pool_ele( &pool, head->child );         /* left-child */
-    while( FD_LIKELY( child ) ) {                                             /* iterate over children */
-      if( FD_LIKELY( child != newr ) ) {                                      /* stop at new root */
-        tail->next = fd_store_map_idx_remove( map, &child->key, null, fec0 ); /* remove node from map to reuse `.next` */
-        tail       = fd_store_pool_ele( &pool, tail->next );                  /* push onto BFS queue (so descendants can be pruned) */
-        tail->next = null;                                                    /* clear map next */
+    fd_store_fec_t * child = fd_store_pool_ele( &pool, head->child ); /* left-child */
+    while( FD_LIKELY( child ) ) {                                     /* iterate over children */
+      if( FD_LIKELY( child != newr ) ) {                              /* stop at new root */
+        tail->retire = fd_store_pool_idx( &pool, child );             /* push onto BFS queue (so descendants can be pruned) */
+        tail         = child;
+        tail->retire = null;
       }
-      child = fd_store_pool_ele( &pool, child->sibling );                     /* right-sibling */
-    }
-    fd_store_fec_t * next = fd_store_pool_ele( &pool, head->next ); /* pophead */
-    int err = fd_store_pool_release( &pool, head, BLOCKING );       /* release */
-    if( FD_UNLIKELY( err != FD_POOL_SUCCESS ) ) {
-      FD_LOG_WARNING(( "failed to release fec %s", fd_store_pool_strerror( err ) ));
-      return NULL;
+      child = fd_store_pool_ele( &pool, child->sibling );             /* right-sibling */
     }
-    head = next;                                                    /* advance */
+    fd_store_fec_t * next = fd_store_pool_ele( &pool, head->retire ); /* pophead */
+
+    ulong part_idx = head->key.part;                                  /* prune */
+    ulong head_idx = fd_store_pool_idx( &pool, head );
+    FD_VOLATILE( head->epoch ) = 0UL;
+    head->retire = retire_head[ part_idx ];
+    retire_head[ part_idx ] = head_idx;
+    if( FD_UNLIKELY( retire_tail[ part_idx ] == null ) ) retire_tail[ part_idx ] = head_idx;
+
+    head = next;                                                      /* advance */
   }
   newr->parent = null;                             /* unlink old root */
   store->root  = fd_store_pool_idx( &pool, newr ); /* replace with new root */
+
+  /* Third, hand the pruned elements off to their owners.  This is a
+     lock-free push (the owners concurrently pop their lists with an
+     atomic exchange).  The CAS also fences the pruned marks above. */
+
+  for( ulong i = 0UL; i < store->part_cnt; i++ ) {
+    if( FD_LIKELY( retire_head[ i ] == null ) ) continue;
+    fd_store_part_t * part = &store->part[ i ];
+    fd_store_fec_t  * last = fd_store_pool_ele( &pool, retire_tail[ i ] );
+    for(;;) {
+      ulong top    = FD_VOLATILE_CONST( part->retire );
+      last->retire = top;
+      if( FD_LIKELY( FD_ATOMIC_CAS( &part->retire, top, retire_head[ i ] ) == top ) ) break;
+      FD_SPIN_PAUSE();
+    }
+  }
+
   return newr;
 }
 
+ulong
+fd_store_reclaim( fd_store_t * store,
+                  ulong        part_idx ) {
+
+  fd_store_map_t  * map  = fd_store_map ( store );
+  fd_store_pool_t   pool = fd_store_pool( store );
+  fd_store_fec_t  * fec0 = fd_store_fec0( store );
+  fd_store_part_t * part = &store->part[ part_idx ];
+
+  /* Pop the partition's retire list and remove the elements from the
+     map.  The epoch is advanced after the removals (with a full fence),
+     so an accessor that still references a removed element is pinned
+     at or before the epoch the element is tagged with. */
+
+  if( FD_UNLIKELY( FD_VOLATILE_CONST( part->retire ) != null ) ) {
+    ulong head = FD_ATOMIC_XCHG( &part->retire, null );
+    ulong tail = null;
+    for( ulong idx = head; idx != null; idx = fd_store_pool_ele( &pool, idx )->retire ) {
+      fd_store_fec_t * fec = fd_store_pool_ele( &pool, idx );
+      if( FD_UNLIKELY( fd_store_map_idx_remove( map, &fec->key, null, fec0 ) != idx ) ) {
+        FD_LOG_CRIT(( "store corrupt: pruned fec %s missing from partition %lu", FD_BASE58_ENC_32_ALLOCA( &fec->key.mr ), part_idx ));
+      }
+      tail = idx;
+    }
+    ulong epoch = FD_ATOMIC_FETCH_AND_ADD( &store->epoch, 1UL );
+    for( ulong idx = head; idx != null; idx = fd_store_pool_ele( &pool, idx )->retire ) fd_store_pool_ele( &pool, idx )->epoch = epoch;
+
+    if( FD_LIKELY( part->limbo_tail == null ) ) part->limbo_head = head;
+    else fd_store_pool_ele( &pool, part->limbo_tail )->retire = head;
+    part->limbo_tail = tail;
+  }
+
+  if( FD_LIKELY( part->limbo_head == null ) ) return 0UL;
+
+  /* Release the removed elements that are older than every pinned
+     epoch.  The limbo list is in epoch order. */
+
+  ulong epoch_min = ULONG_MAX;
+  for( ulong i = 0UL; i < store->part_cnt; i++ ) epoch_min = fd_ulong_min( epoch_min, FD_VOLATILE_CONST( store->part[ i ].epoch ) );
+
+  ulong release_cnt = 0UL;
+  while( part->limbo_head != null ) {
+    fd_store_fec_t * fec = fd_store_pool_ele( &pool, part->limbo_head );
+    if( FD_LIKELY( fec->epoch >= epoch_min ) ) break;
+    part->limbo_head = fec->retire;
+    int err = fd_store_pool_release( &pool, fec, BLOCKING );
+    if( FD_UNLIKELY( err != FD_POOL_SUCCESS ) ) FD_LOG_CRIT(( "failed to release fec %s", fd_store_pool_strerror( err ) ));
+    release_cnt++;
+  }
+  if( FD_UNLIKELY( part->limbo_head == null ) ) part->limbo_tail = null;
+  return release_cnt;
+}
+
 fd_store_t *
 fd_store_clear( fd_store_t * store ) {
 
@@ -256,6 +362,23 @@ fd_store_clear( fd_store_t * store ) {
   fd_store_pool_t  pool = fd_store_pool( store );
   fd_store_fec_t * fec0 = fd_store_fec0( store );
 
+  /* Removed elements that were not yet released are no longer in the
+     map, so release them first.  Pruned elements on the retire lists
+     are still in the map so they are released with the rest below. */
+
+  for( ulong i = 0UL; i < store->part_cnt; i++ ) {
+    fd_store_part_t * part = &store->part[ i ];
+    ulong idx = part->limbo_head;
+    while( idx != null ) {
+      fd_store_fec_t * fec = fd_store_pool_ele( &pool, idx );
+      idx = fec->retire;
+      fd_store_pool_release( &pool, fec, 1 );
+    }
+    part->retire     = null;
+    part->limbo_head = null;
+    part->limbo_tail = null;
+  }
+
   fd_store_fec_t * head = fd_store_root( store );
   fd_store_fec_t * tail = head;
 
@@ -30,7 +30,7 @@
    that it is also persistent and remotely inspectable.  Store is
    designed to be used inter-process (allowing concurrent joins from
    multiple tiles), relocated in memory (via wksp operations), and
-   accessed concurrently (managing conflicts with a lock).
+   accessed concurrently (without locks, see CONCURRENCY).
 
    EQUIVOCATION
 
@@ -67,18 +67,14 @@
 
    CONCURRENCY
 
-   It is possible to design Store access in a way that enables parallel
-   writes and minimizes lock contention between readers and writers.
-   Store contains a fd_rwlock (read-write lock), but the name is a bit
-   of a misnomer because writes can actually be concurrent and the only
-   operation that will actually need the write lock is publish, which
-   will be done by Replay.  It is more appropriate to describe as an
-   exclusive-shared access lock.
-
-   In this design, writers (Shred tiles) hold the shared lock during
-   their access.  The reader (Replay tile) also holds the shared lock
-   during its access, and given both Shred and Replay will be taking out
-   shared locks, they will not contend.
+   Store is accessed concurrently without locks.  Every accessor owns a
+   partition of the store (see below): each Shred tile owns the
+   partition matching its tile index, and Replay (the publisher) owns an
+   additional partition reserved for it.  Accessors pin their partition
+   for the duration of their access (fd_store_shacq / fd_store_shrel),
+   which does not wait on any other accessor.  Publishing does not block
+   Shred tiles from inserting, and inserting does not block Replay from
+   publishing.
 
    For parallel writes, the Store's hash function is carefully designed
    to partition the keyspace so that the same Shred tile always writes
@@ -86,8 +82,8 @@
    the same Shred tile and cannot happen across tiles.  Specifically, if
    two different FEC sets hash to the same slot, it is guaranteed that
    to be the same Shred tile processing both those FEC sets.  This
-   prevents a data race in which multiple Shred tiles (each with a
-   handle to the shared lock) write to the same map slot.
+   prevents a data race in which multiple Shred tiles write to the same
+   map slot.
 
    The hash function is defined as follows:
    ```
@@ -98,27 +94,28 @@
    tile index doing the insertion.  seed, on initialization, is the
    number of chains/buckets in the map_chain divided by the number of
    partitions.  In effect, seed is the size of each partition.  For
-   example, if the map_chain is sized to 1024, and there are 4 shred
-   tiles, then the seed is 1024/4 = 256.  Then the map key hash can
-   bound the chain index of each partition as such: shred tile 0 will
-   write to chains 0-255, shred tile 1 will write to chains 256-511,
-   shred tile 2 will write to chains 512-767, and shred tile 3 will
-   write to chains 768-1023, without overlap.  The merkle root is a 32
-   byte SHA-256 hash, so we can expect a fairly uniform distribution of
-   hash values even after truncating to the first 8 bytes, without
-   needing to introduce more randomness.  Thus we can repurpose the
-   `seed` argument to be the number of partitions.
+   example, if the map_chain is sized to 1024, and there are 3 shred
+   tiles (4 partitions with the publisher's), then the seed is 1024/4 =
+   256.  Then the map key hash can bound the chain index of each
+   partition as such: shred tile 0 will write to chains 0-255, shred
+   tile 1 will write to chains 256-511, shred tile 2 will write to
+   chains 512-767, and the publisher will write to chains 768-1023,
+   without overlap.  The merkle root is a 32 byte SHA-256 hash, so we
+   can expect a fairly uniform distribution of hash values even after
+   truncating to the first 8 bytes, without needing to introduce more
+   randomness.  Thus we can repurpose the `seed` argument to be the
+   number of partitions.
 
    Essentially, this allows for limited single-producer single-consumer
    (SPSC) concurrency, where the producer is a given Shred tile and the
    consumer is Replay tile.  The SPSC concurrency is limited in that the
    Store should 1. only be read by Replay after Repair has notified
    Replay it is time to read (ie. Shred has finished writing), and 2. be
-   written to by Shred(s) in append-only fashion, so Shred never
-   modifies or removes from the map.  Store is backed by fd_map_chain,
-   which is not thread-safe generally, but does support this particular
-   SPSC concurrency model in cases where the consumer is guaranteed to
-   be lagging the producer.
+   modified only by the owner of the partition, so only a Shred tile
+   ever inserts into or removes from the map chains of its partition.
+   Store is backed by fd_map_chain, which is not thread-safe generally,
+   but does support this particular SPSC concurrency model in cases
+   where the consumer is guaranteed to be lagging the producer.
 
    Analyzing fd_map_chain in gory detail, in the case of a map collision
    where Replay tile is reading an element and Shred tile writes a new
@@ -131,18 +128,36 @@
    is safe, it would just check the key (if no match, iterate down the
    chain etc.)  If it reads after, it is also safe because the new
    element is guaranteed to be before the old element in the chain, so
-   it would just do one more iteration.  Note the consumer should always
-   use fd_store_query_const to ensure the underlying fd_map_chain is not
-   modified during querying.
-
-   The exception to the above is publishing.  Publishing requires
-   exclusive access because it involves removing from fd_map_chain,
-   which is not safe for shared access.  So the Replay tile should take
-   out the exclusive lock.  Publishing happens at most once per slot, so
-   it is a relatively infrequent Store access compared to FEC queries
-   and inserts (which is good because it is also the most expensive). */
-
-#include "../../flamenco/fd_rwlock.h"
+   it would just do one more iteration.  Removing an element is a
+   single store to the previous link in the chain that leaves the
+   removed element's `.next` intact, so a consumer concurrently on the
+   removed element still reaches the rest of the chain.  Note the
+   consumer should always use fd_store_query_const to ensure the
+   underlying fd_map_chain is not modified during querying.
+
+   PUBLISHING
+
+   Publishing prunes elements from every partition, but the publisher
+   cannot remove from another owner's map chains.  Instead, publish
+   marks each pruned element (so queries no longer return it) and
+   pushes it onto the retire list of the partition it belongs to.  The
+   owner of the partition pops its retire list on its next insert (or
+   fd_store_reclaim) and removes the elements from its map chains.
+
+   A removed element cannot be released to the pool right away because
+   another accessor might be in the middle of traversing a chain through
+   it, and an element that is reacquired and inserted into a different
+   chain would send that accessor off into the wrong chain.  This is
+   solved with epoch-based reclamation.  The store has a global epoch
+   and each partition records the epoch at which its owner last pinned
+   it (ULONG_MAX while unpinned).  Removed elements are tagged with the
+   epoch at the time of their removal (which is then advanced) and are
+   kept on the owner's limbo list until every partition is either
+   unpinned or pinned at a later epoch, at which point no accessor can
+   still hold a reference to them and they are released to the pool.
+   The limbo list is ordered by epoch, so reclaiming only needs to scan
+   the pinned epochs of the partitions once per call. */
+
 #include "../../flamenco/types/fd_types_custom.h"
 #include "../../util/hist/fd_histf.h"
 
@@ -171,6 +186,12 @@
 
 #define FD_STORE_DATA_MAX (63985UL) /* TODO fixed-32 */
 
+/* FD_STORE_PART_MAX is the max number of partitions, including the
+   partition reserved for the publisher (ie. the max number of writers
+   is FD_STORE_PART_MAX-1). */
+
+#define FD_STORE_PART_MAX (64UL)
+
 /* fd_store_fec describes a store element (FEC set).  The pointer fields
    implement a left-child, right-sibling n-ary tree. */
 
@@ -194,6 +215,18 @@ struct __attribute__((aligned(FD_STORE_ALIGN))) fd_store_fec {
   ulong parent;  /* pool idx of the parent */
   ulong child;   /* pool idx of the left-child */
   ulong sibling; /* pool idx of the right-sibling */
+  ulong retire;  /* pool idx of the next element on the retire or limbo list of the partition */
+  ulong epoch;   /* ULONG_MAX if live, 0 if pruned by publish but not yet removed from the map, otherwise the epoch of removal */
+
+  /* Metadata.  Set by Replay when linking the FEC set and only read
+                once the FEC set is rooted (see fd_store_ledger). */
+
+  ulong  slot;          /* slot of the FEC set, ULONG_MAX if unknown */
+  uint   fec_set_idx;   /* fec_set_idx of the FEC set, UINT_MAX if unknown */
+  ushort parent_off;    /* slot - parent slot */
+  ushort data_cnt;      /* number of data shreds in the FEC set */
+  uchar  data_complete; /* 1 if the last data shred has DATA_COMPLETE set, 0 otherwise */
+  uchar  slot_complete; /* 1 if the last data shred has SLOT_COMPLETE set, 0 otherwise */
 
   /* Data */
 
@@ -215,17 +248,29 @@ typedef struct fd_store_fec fd_store_fec_t;
 #define MAP_INSERT_FENCE       1
 #include "../../util/tmpl/fd_map_chain.c"
 
-struct fd_store {
+/* fd_store_part describes the reclamation state of a partition (see
+   PUBLISHING). */
+
+struct __attribute__((aligned(FD_STORE_ALIGN))) fd_store_part {
+  ulong epoch;      /* epoch at which the owner pinned the partition, ULONG_MAX if unpinned */
+  ulong retire;     /* pool idx of the head of the retire list, pushed by the publisher and popped by the owner */
+  ulong limbo_head; /* pool idx of the oldest element removed from the map but not yet released, owner only */
+  ulong limbo_tail; /* pool idx of the newest element removed from the map but not yet released, owner only */
+};
+typedef struct fd_store_part fd_store_part_t;
+
+struct __attribute__((aligned(FD_STORE_ALIGN))) fd_store {
   ulong magic;       /* ==FD_STORE_MAGIC */
   ulong fec_max;     /* max number of FEC sets that can be stored */
-  ulong part_cnt;    /* number of partitions, also the number of writers */
+  ulong part_cnt;    /* number of partitions, the number of writers plus one for the publisher */
   ulong root;        /* pool idx of the root */
   ulong slot0;       /* FIXME this hack is needed until the block_id is in the bank (manifest) */
   ulong store_gaddr; /* wksp gaddr of store in the backing wksp, non-zero gaddr */
   ulong map_gaddr;   /* wksp gaddr of map of fd_store_key->fd_store_fec */
   ulong pool_mem_gaddr; /* wksp gaddr of shmem_t object in pool_para */
   ulong pool_ele_gaddr; /* wksp gaddr of first ele_t object in pool_para */
-  fd_rwlock_t lock; /* rwlock for concurrent access */
+  ulong epoch;          /* global epoch for reclamation, advanced on every removal from the map */
+  fd_store_part_t part[ FD_STORE_PART_MAX ]; /* indexed by partition idx in [0,part_cnt) */
 };
 typedef struct fd_store fd_store_t;
 
@@ -261,7 +306,9 @@ fd_store_footprint( ulong fec_max ) {
 /* fd_store_new formats an unused memory region for use as a store.
    mem is a non-NULL pointer to this region in the local address space
    with the required footprint and alignment.  fec_max is an integer
-   power-of-two. */
+   power-of-two.  part_cnt is the number of writers (Shred tiles), in
+   [1,FD_STORE_PART_MAX).  The store has an additional partition for
+   the publisher (see fd_store_pub_part). */
 
 void *
 fd_store_new( void * shmem, ulong fec_max, ulong part_cnt );
@@ -335,48 +382,56 @@ FD_FN_PURE static inline fd_store_fec_t const * fd_store_child_const  ( fd_store
 FD_FN_PURE static inline fd_store_fec_t       * fd_store_sibling      ( fd_store_t       * store, fd_store_fec_t const * fec ) { fd_store_pool_t pool = fd_store_pool( store ); return fd_store_pool_ele      ( &pool, fec->sibling ); }
 FD_FN_PURE static inline fd_store_fec_t const * fd_store_sibling_const( fd_store_t const * store, fd_store_fec_t const * fec ) { fd_store_pool_t pool = fd_store_pool( store ); return fd_store_pool_ele_const( &pool, fec->sibling ); }
 
-/* fd_store_{shacq, shrel, exacq, exrel} acquires / releases the shared
-   / exclusive lock.  Callers should typically use the
-   FD_STORE_SHARED_LOCK and FD_STORE_EXCLUSIVE_LOCK macros to acquire
-   and release the lock instead of calling these functions directly. */
+/* fd_store_pub_part returns the partition index reserved for the
+   publisher (Replay tile).  Writers (Shred tiles) use the partition
+   indices [0,fd_store_pub_part(store)). */
+
+FD_FN_PURE static inline ulong fd_store_pub_part( fd_store_t const * store ) { return store->part_cnt - 1UL; }
 
-static inline void fd_store_shacq( fd_store_t * store ) { fd_rwlock_read   ( &store->lock ); }
-static inline void fd_store_shrel( fd_store_t * store ) { fd_rwlock_unread ( &store->lock ); }
-static inline void fd_store_exacq( fd_store_t * store ) { fd_rwlock_write  ( &store->lock ); }
-static inline void fd_store_exrel( fd_store_t * store ) { fd_rwlock_unwrite( &store->lock ); }
+/* fd_store_{shacq, shrel} pins / unpins partition part_idx for access
+   by its owner (see CONCURRENCY).  Neither waits on other accessors.
+   Elements pruned by a concurrent publish stay valid (though no longer
+   returned by queries) until the owner unpins.  Callers should
+   typically use the FD_STORE_SHARED_LOCK macro to pin and unpin the
+   partition instead of calling these functions directly.
+
+   shacq uses an atomic exchange for its full fence, such that the
+   pinned epoch is visible to reclaimers before any subsequent load of
+   store elements. */
+
+static inline void
+fd_store_shacq( fd_store_t * store, ulong part_idx ) {
+  (void)FD_ATOMIC_XCHG( &store->part[ part_idx ].epoch, FD_VOLATILE_CONST( store->epoch ) );
+}
+
+static inline void
+fd_store_shrel( fd_store_t * store, ulong part_idx ) {
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( store->part[ part_idx ].epoch ) = ULONG_MAX;
+}
 
 struct fd_store_lock_ctx {
   fd_store_t * store_;
+  ulong        part_idx;
   long       * acq_start;
   long       * acq_end;
   long       * work_end;
 };
 
 static inline void
-fd_store_shared_lock_cleanup( struct fd_store_lock_ctx * ctx ) { *(ctx->work_end) = fd_tickcount(); fd_store_shrel( ctx->store_ ); }
+fd_store_shared_lock_cleanup( struct fd_store_lock_ctx * ctx ) { *(ctx->work_end) = fd_tickcount(); fd_store_shrel( ctx->store_, ctx->part_idx ); }
 
-#define FD_STORE_SHARED_LOCK(store, shacq_start, shacq_end, shrel_end) do {                                  \
+#define FD_STORE_SHARED_LOCK(store, part, shacq_start, shacq_end, shrel_end) do {                           \
   struct fd_store_lock_ctx lock_ctx __attribute__((cleanup(fd_store_shared_lock_cleanup))) =                 \
-      { .store_ = (store), .work_end = &(shrel_end), .acq_start = &(shacq_start), .acq_end = &(shacq_end) }; \
+      { .store_ = (store), .part_idx = (part), .work_end = &(shrel_end),                                     \
+        .acq_start = &(shacq_start), .acq_end = &(shacq_end) };                                              \
   shacq_start = fd_tickcount();                                                                              \
-  fd_store_shacq( lock_ctx.store_ );                                                                         \
+  fd_store_shacq( lock_ctx.store_, lock_ctx.part_idx );                                                      \
   shacq_end = fd_tickcount();                                                                                \
   do
 
 #define FD_STORE_SHARED_LOCK_END while(0); } while(0)
 
-static inline void
-fd_store_exclusive_lock_cleanup( struct fd_store_lock_ctx * ctx ) { *(ctx->work_end) = fd_tickcount(); fd_store_exrel( ctx->store_ ); }
-
-#define FD_STORE_EXCLUSIVE_LOCK(store, exacq_start, exacq_end, exrel_end) do {                             \
-  struct fd_store_lock_ctx lock_ctx __attribute__((cleanup(fd_store_exclusive_lock_cleanup))) =            \
-    { .store_ = (store), .work_end = &(exrel_end), .acq_start = &(exacq_start), .acq_end = &(exacq_end) }; \
-  exacq_start = fd_tickcount();                                                                            \
-  fd_store_exacq( lock_ctx.store_ );                                                                       \
-  exacq_end = fd_tickcount();                                                                              \
-  do
-#define FD_STORE_EXCLUSIVE_LOCK_END while(0); } while(0)
-
 struct fd_store_histf {
   fd_histf_t * histf;
   long         ts;
@@ -394,8 +449,25 @@ fd_store_histf( fd_store_histf_t * ctx ) {
 
 #define FD_STORE_HISTF_END while(0); } while(0)
 
+/* fd_store_private_query_idx returns the pool idx of the element keyed
+   by merkle_root in the map, or null if there is none.  Includes
+   elements pruned by publish that have not yet been removed from the
+   map. */
+
+FD_FN_PURE static inline ulong
+fd_store_private_query_idx( fd_store_t const * store, fd_hash_t const * merkle_root ) {
+   fd_store_key_t key = { .mr = *merkle_root, .part = UINT_MAX };
+   for( uint i = 0; i < store->part_cnt; i++ ) {
+      key.part = i;
+      ulong idx = fd_store_map_idx_query_const( fd_store_map_const( store ), &key, ULONG_MAX, fd_store_fec0_const( store ) );
+      if( idx != ULONG_MAX ) return idx;
+   }
+   return ULONG_MAX;
+}
+
 /* fd_store_{query,query_const} queries the FEC set keyed by merkle.
-   Returns a pointer to the fd_store_fec_t if found, NULL otherwise.
+   Returns a pointer to the fd_store_fec_t if found, NULL otherwise
+   (including if the FEC set was pruned by publish).
 
    Both the const and non-const versions are concurrency safe; as in
    they avoid using the non-const map_ele_query that reorders the chain.
@@ -403,32 +475,27 @@ fd_store_histf( fd_store_histf_t * ctx ) {
    does not reorder the chain, and then indexes directly into the pool
    and returns a non-const pointer to the element of interest.
 
-   Assumes caller has acquired the shared lock via fd_store_shacq.
+   Assumes caller has pinned its partition via fd_store_shacq.
 
    IMPORTANT SAFETY TIP!  Caller should only call fd_store_shrel when
    they no longer retain interest in the returned pointer. */
 
 FD_FN_PURE static inline fd_store_fec_t *
 fd_store_query( fd_store_t * store, fd_hash_t const * merkle_root ) {
-   fd_store_key_t  key  = { .mr = *merkle_root, .part = UINT_MAX };
-   fd_store_pool_t pool = fd_store_pool( store );
-   for( uint i = 0; i < store->part_cnt; i++ ) {
-      key.part = i;
-      ulong idx = fd_store_map_idx_query_const( fd_store_map( store ), &key, ULONG_MAX, fd_store_fec0( store ) );
-      if( idx != ULONG_MAX ) return fd_store_pool_ele( &pool, idx );
-   }
-   return NULL;
+   ulong idx = fd_store_private_query_idx( store, merkle_root );
+   if( idx == ULONG_MAX ) return NULL;
+   fd_store_fec_t * fec = fd_store_fec0( store ) + idx;
+   if( FD_UNLIKELY( FD_VOLATILE_CONST( fec->epoch ) != ULONG_MAX ) ) return NULL; /* pruned */
+   return fec;
 }
 
 FD_FN_PURE static inline fd_store_fec_t const *
 fd_store_query_const( fd_store_t const * store, fd_hash_t * merkle_root ) {
-   fd_store_key_t key = { .mr = *merkle_root, .part = UINT_MAX };
-   for( uint i = 0; i < store->part_cnt; i++ ) {
-      key.part = i;
-      fd_store_fec_t const * fec = fd_store_map_ele_query_const( fd_store_map_const( store ), &key, NULL, fd_store_fec0_const( store ) );
-      if( fec ) return fec;
-   }
-   return NULL;
+   ulong idx = fd_store_private_query_idx( store, merkle_root );
+   if( idx == ULONG_MAX ) return NULL;
+   fd_store_fec_t const * fec = fd_store_fec0_const( store ) + idx;
+   if( FD_UNLIKELY( FD_VOLATILE_CONST( fec->epoch ) != ULONG_MAX ) ) return NULL; /* pruned */
+   return fec;
 }
 
 /* Operations */
@@ -440,17 +507,17 @@ fd_store_query_const( fd_store_t const * store, fd_hash_t * merkle_root ) {
 
    Assumes store is a current local join and has space for another
    element.  Does additional checks when handholding is enabled and
-   fails insertion (returning NULL) if checks fail.  If this is the
-   first element being inserted into store, the store root will be set
-   to this newly inserted element.
+   fails insertion (returning NULL) if checks fail.  Also fails if
+   merkle_root is already in the store, including if it was pruned but
+   not yet reclaimed.  If this is the first element being inserted into
+   store, the store root will be set to this newly inserted element.
 
-   Assumes caller has acquired either the shared or exclusive lock via
-   fd_store_shacq or fd_store_exacq.  See top-level documentation for
-   why this operation may only require a shared lock vs. exclusive.
+   Assumes caller is the owner of partition part_idx and has pinned it
+   via fd_store_shacq.  Reclaims the partition before inserting (see
+   fd_store_reclaim).
 
-   IMPORTANT SAFETY TIP!  Caller should only call fd_store_shrel or
-   fd_store_exrel when they no longer retain interest in the returned
-   pointer. */
+   IMPORTANT SAFETY TIP!  Caller should only call fd_store_shrel when
+   they no longer retain interest in the returned pointer. */
 
 fd_store_fec_t *
 fd_store_insert( fd_store_t * store,
@@ -458,11 +525,14 @@ fd_store_insert( fd_store_t * store,
                  fd_hash_t  * merkle_root );
 
 /* fd_store_link queries for and links the child keyed by merkle_root to
-   parent keyed by chained_merkle_root.  Returns a pointer to the child.
-   Assumes merkle_root and chained_merkle_root are both non-NULL and key
-   elements currently in the store.
+   parent keyed by chained_merkle_root and sets the child's cmr.
+   Returns a pointer to the child.  Assumes merkle_root and
+   chained_merkle_root are both non-NULL and key elements currently in
+   the store.
 
-   Assumes caller has acquired the shared lock via fd_store_shacq.
+   Assumes caller is the publisher and has pinned its partition via
+   fd_store_shacq (the tree pointers are only modified by the
+   publisher).
 
    IMPORTANT SAFETY TIP!  Caller should only call fd_store_shrel when
    they no longer retain interest in the returned pointer. */
@@ -486,17 +556,38 @@ fd_store_link( fd_store_t * store,
    result in [0 1] being removed given they are ancestors of 2, and
    removing 1 will leave [3 5 6] orphaned and also removed.
 
-   Assumes caller has acquired the exclusive lock via fd_store_exacq.
+   Pruned elements are no longer returned by queries, but are only
+   released to the pool once the owners of their partitions have
+   reclaimed them (see PUBLISHING), so publish does not wait on any
+   writer.
+
+   Assumes caller is the publisher and has pinned its partition via
+   fd_store_shacq.
 
-   IMPORTANT SAFETY TIP!  Caller should only call fd_store_exrel when
+   IMPORTANT SAFETY TIP!  Caller should only call fd_store_shrel when
    they no longer retain interest in the returned pointer. */
 
 fd_store_fec_t *
 fd_store_publish( fd_store_t *      store,
                   fd_hash_t const * merkle_root );
 
+/* fd_store_reclaim removes the elements of partition part_idx that were
+   pruned by publish from the map and releases the removed elements that
+   no accessor can still reference to the pool (see PUBLISHING).
+   Returns the number of elements released.  Assumes caller is the owner
+   of partition part_idx.  Called by fd_store_insert and fd_store_publish,
+   but owners that can go a long time without inserting should also call
+   it periodically (eg. during housekeeping) so pruned elements do not
+   linger in the pool. */
+
+ulong
+fd_store_reclaim( fd_store_t * store,
+                  ulong        part_idx );
+
 /* fd_store_clear clears the store.  All elements are removed from the
-   map and released back into the pool.  Does not zero-out fields.
+   map and released back into the pool, including pruned elements that
+   were not yet reclaimed.  Does not zero-out fields.  Assumes there
+   are no concurrent accessors.
 
    IMPORTANT SAFETY TIP!  the store must be non-empty. */
 
@@ -0,0 +1,408 @@
+#include "fd_store_ledger.h"
+#include "../../flamenco/fd_flamenco_base.h"
+
+#include <errno.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define null fd_store_pool_idx_null()
+
+/* fd_store_ledger_hdr_t is the file header, stored in the first block
+   of the file. */
+
+struct fd_store_ledger_hdr {
+  ulong magic;   /* ==FD_STORE_LEDGER_MAGIC */
+  ulong file_sz; /* sz of the file when formatted */
+};
+typedef struct fd_store_ledger_hdr fd_store_ledger_hdr_t;
+
+#define DATA0 FD_STORE_LEDGER_BLOCK_SZ /* file offset of the first record */
+
+static inline ulong
+rec_sz( ulong data_sz ) {
+  return fd_ulong_align_up( sizeof(fd_store_ledger_rec_t)+data_sz, FD_STORE_LEDGER_BLOCK_SZ );
+}
+
+static ulong
+rec_hash( fd_store_ledger_rec_t const * rec ) {
+  fd_store_ledger_rec_t hdr = *rec;
+  hdr.hash = 0UL;
+  return fd_hash( fd_hash( FD_STORE_LEDGER_REC_MAGIC, &hdr, sizeof(fd_store_ledger_rec_t) ), fd_store_ledger_rec_data( rec ), rec->data_sz );
+}
+
+/* rec_query returns the record at file offset off if it is a valid
+   record, NULL otherwise. */
+
+static fd_store_ledger_rec_t const *
+rec_query( fd_store_ledger_t const * ledger,
+           ulong                     off ) {
+  if( FD_UNLIKELY( off+sizeof(fd_store_ledger_rec_t)>ledger->file_sz ) ) return NULL;
+  fd_store_ledger_rec_t const * rec = (fd_store_ledger_rec_t const *)( ledger->map + off );
+  if( FD_UNLIKELY( rec->magic!=FD_STORE_LEDGER_REC_MAGIC               ) ) return NULL;
+  if( FD_UNLIKELY( rec->data_sz>FD_STORE_DATA_MAX                      ) ) return NULL;
+  if( FD_UNLIKELY( off+rec_sz( rec->data_sz )>ledger->file_sz          ) ) return NULL;
+  if( FD_UNLIKELY( rec->hash!=rec_hash( rec )                          ) ) return NULL;
+  return rec;
+}
+
+/* slot_insert indexes the record rec at file offset off.  Records of
+   newer slots replace older slots in the index.  A record extends the
+   index entry of its slot if it immediately follows the records already
+   in the entry, otherwise a newer record restarts the entry. */
+
+static void
+slot_insert( fd_store_ledger_t *           ledger,
+             fd_store_ledger_rec_t const * rec,
+             ulong                         off ) {
+  fd_store_ledger_slot_t * e = ledger->slot_idx + ( rec->slot & (ledger->slot_max-1UL) );
+  if( FD_LIKELY( e->slot==rec->slot && rec->seq==e->seq0+e->rec_cnt ) ) {
+    e->rec_cnt++;
+  } else if( FD_LIKELY( e->slot==ULONG_MAX || rec->slot>e->slot || ( rec->slot==e->slot && rec->seq>e->seq0 ) ) ) {
+    e->slot    = rec->slot;
+    e->seq0    = rec->seq;
+    e->off0    = off;
+    e->rec_cnt = 1UL;
+  }
+}
+
+/* recover rebuilds the index and finds the next record to write from
+   the records in the file.
+
+   Because the log is circular, walking the file in offset order visits
+   the records appended since the last wrap (increasing seq from DATA0)
+   followed by the older records that have not been overwritten yet
+   (increasing seq again, but lower than the first group).  The end of
+   the last record of the first group is the head of the log.  The only
+   slot that can have records in both groups is the slot of the first
+   record in the file, in which case the records in the second group are
+   older and are merged into the entry at the end of the walk. */
+
+static void
+recover( fd_store_ledger_t * ledger ) {
+
+  for( ulong i=0UL; i<ledger->slot_max; i++ ) ledger->slot_idx[ i ].slot = ULONG_MAX;
+  ledger->head             = DATA0;
+  ledger->seq              = 0UL;
+  ledger->last_slot        = ULONG_MAX;
+  ledger->last_fec_set_idx = UINT_MAX;
+
+  int   wrapped  = 0;
+  ulong prev_seq = 0UL;
+  ulong slot0    = ULONG_MAX; /* slot of the first record */
+  ulong seq0     = ULONG_MAX; /* seq  of the first record */
+
+  fd_store_ledger_slot_t tail = { .slot = ULONG_MAX }; /* records of slot0 in the second group */
+
+  ulong rec_cnt = 0UL;
+  ulong off     = DATA0;
+  while( off<ledger->file_sz ) {
+    fd_store_ledger_rec_t const * rec = rec_query( ledger, off );
+    if( FD_UNLIKELY( !rec ) ) { off += FD_STORE_LEDGER_BLOCK_SZ; continue; }
+
+    if( FD_UNLIKELY( slot0==ULONG_MAX ) ) { slot0 = rec->slot; seq0 = rec->seq; }
+    else if( FD_UNLIKELY( rec->seq<prev_seq ) ) wrapped = 1;
+
+    if( FD_LIKELY( !wrapped ) ) {
+      ledger->head             = off + rec_sz( rec->data_sz );
+      ledger->seq              = rec->seq + 1UL;
+      ledger->last_slot        = rec->slot;
+      ledger->last_fec_set_idx = rec->fec_set_idx;
+    }
+
+    if( FD_UNLIKELY( wrapped && rec->slot==slot0 ) ) {
+      if( FD_LIKELY( tail.slot==slot0 && rec->seq==tail.seq0+tail.rec_cnt ) ) tail.rec_cnt++;
+      else tail = (fd_store_ledger_slot_t){ .slot = slot0, .seq0 = rec->seq, .off0 = off, .rec_cnt = 1UL };
+    } else {
+      slot_insert( ledger, rec, off );
+    }
+
+    rec_cnt++;
+    prev_seq = rec->seq;
+    off     += rec_sz( rec->data_sz );
+  }
+
+  if( FD_UNLIKELY( tail.slot!=ULONG_MAX ) ) {
+    fd_store_ledger_slot_t * e = ledger->slot_idx + ( slot0 & (ledger->slot_max-1UL) );
+    if( FD_LIKELY( e->slot==slot0 && e->seq0==seq0 && tail.seq0+tail.rec_cnt==seq0 ) ) {
+      e->seq0     = tail.seq0;
+      e->off0     = tail.off0;
+      e->rec_cnt += tail.rec_cnt;
+    }
+  }
+
+  FD_LOG_INFO(( "recovered %lu ledger records (head %lu, seq %lu)", rec_cnt, ledger->head, ledger->seq ));
+}
+
+fd_store_ledger_t *
+fd_store_ledger_init( void * mem,
+                      ulong  slot_max,
+                      int    fd,
+                      int    writable ) {
+
+  if( FD_UNLIKELY( !mem ) ) {
+    FD_LOG_WARNING(( "NULL mem" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !fd_ulong_is_aligned( (ulong)mem, fd_store_ledger_align() ) ) ) {
+    FD_LOG_WARNING(( "misaligned mem" ));
+    return NULL;
+  }
+
+  ulong footprint = fd_store_ledger_footprint( slot_max );
+  if( FD_UNLIKELY( !footprint ) ) {
+    FD_LOG_WARNING(( "bad slot_max (%lu)", slot_max ));
+    return NULL;
+  }
+
+  struct stat st;
+  if( FD_UNLIKELY( fstat( fd, &st ) ) ) {
+    FD_LOG_WARNING(( "fstat(fd %i) failed (%i-%s)", fd, errno, fd_io_strerror( errno ) ));
+    return NULL;
+  }
+
+  ulong file_sz = (ulong)st.st_size;
+  if( FD_UNLIKELY( file_sz<FD_STORE_LEDGER_FILE_MIN || !fd_ulong_is_aligned( file_sz, FD_STORE_LEDGER_BLOCK_SZ ) ) ) {
+    FD_LOG_WARNING(( "bad ledger file sz (%lu), should be a %lu multiple and at least %lu", file_sz, FD_STORE_LEDGER_BLOCK_SZ, FD_STORE_LEDGER_FILE_MIN ));
+    return NULL;
+  }
+
+  void * map = mmap( NULL, file_sz, PROT_READ, MAP_SHARED, fd, 0 );
+  if( FD_UNLIKELY( map==MAP_FAILED ) ) {
+    FD_LOG_WARNING(( "mmap(fd %i,sz %lu) failed (%i-%s)", fd, file_sz, errno, fd_io_strerror( errno ) ));
+    return NULL;
+  }
+
+  FD_SCRATCH_ALLOC_INIT( l, mem );
+  fd_store_ledger_t *      ledger   = FD_SCRATCH_ALLOC_APPEND( l, alignof(fd_store_ledger_t),      sizeof(fd_store_ledger_t)              );
+  uchar *                  buf      = FD_SCRATCH_ALLOC_APPEND( l, FD_STORE_LEDGER_BLOCK_SZ,        FD_STORE_LEDGER_REC_MAX                );
+  fd_store_ledger_slot_t * slot_idx = FD_SCRATCH_ALLOC_APPEND( l, alignof(fd_store_ledger_slot_t), sizeof(fd_store_ledger_slot_t)*slot_max );
+  FD_TEST( FD_SCRATCH_ALLOC_FINI( l, fd_store_ledger_align() ) == (ulong)mem + footprint );
+
+  fd_memset( ledger, 0, sizeof(fd_store_ledger_t) );
+  ledger->fd       = fd;
+  ledger->writable = !!writable;
+  ledger->file_sz  = file_sz;
+  ledger->map      = (uchar *)map;
+  ledger->slot_max = slot_max;
+  ledger->slot_idx = slot_idx;
+  ledger->buf      = buf;
+
+  fd_store_ledger_hdr_t const * hdr = (fd_store_ledger_hdr_t const *)map;
+  if( FD_UNLIKELY( hdr->magic!=FD_STORE_LEDGER_MAGIC ) ) {
+    if( FD_UNLIKELY( !writable ) ) {
+      FD_LOG_WARNING(( "fd %i is not a ledger file (bad magic)", fd ));
+      munmap( map, file_sz );
+      return NULL;
+    }
+
+    /* Format the file.  The records of a previous ledger (or any other
+       data) past the header are harmless as they would have to pass
+       validation to be recovered. */
+
+    fd_memset( buf, 0, FD_STORE_LEDGER_BLOCK_SZ );
+    *(fd_store_ledger_hdr_t *)buf = (fd_store_ledger_hdr_t){ .magic = FD_STORE_LEDGER_MAGIC, .file_sz = file_sz };
+    if( FD_UNLIKELY( pwrite( fd, buf, FD_STORE_LEDGER_BLOCK_SZ, 0 )!=(ssize_t)FD_STORE_LEDGER_BLOCK_SZ ) ) {
+      FD_LOG_WARNING(( "failed to write ledger header to fd %i (%i-%s)", fd, errno, fd_io_strerror( errno ) ));
+      munmap( map, file_sz );
+      return NULL;
+    }
+  } else if( FD_UNLIKELY( hdr->file_sz!=file_sz ) ) {
+    FD_LOG_WARNING(( "ledger file was formatted with sz %lu but is now %lu", hdr->file_sz, file_sz ));
+    munmap( map, file_sz );
+    return NULL;
+  }
+
+  recover( ledger );
+
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( ledger->magic ) = FD_STORE_LEDGER_MAGIC;
+  FD_COMPILER_MFENCE();
+
+  return ledger;
+}
+
+void *
+fd_store_ledger_fini( fd_store_ledger_t * ledger ) {
+
+  if( FD_UNLIKELY( !ledger ) ) {
+    FD_LOG_WARNING(( "NULL ledger" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( ledger->magic!=FD_STORE_LEDGER_MAGIC ) ) {
+    FD_LOG_WARNING(( "bad magic" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( munmap( ledger->map, ledger->file_sz ) ) ) {
+    FD_LOG_WARNING(( "munmap failed (%i-%s)", errno, fd_io_strerror( errno ) ));
+  }
+
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( ledger->magic ) = 0UL;
+  FD_COMPILER_MFENCE();
+
+  return (void *)ledger;
+}
+
+int
+fd_store_ledger_append( fd_store_ledger_t *    ledger,
+                        fd_store_fec_t const * fec ) {
+
+  if( FD_UNLIKELY( !ledger->writable ) ) {
+    FD_LOG_WARNING(( "ledger is read-only" ));
+    return FD_STORE_LEDGER_ERR_PERM;
+  }
+
+  if( FD_UNLIKELY( fec->data_sz>FD_STORE_DATA_MAX || fec->slot==ULONG_MAX ) ) {
+    FD_LOG_WARNING(( "bad FEC set (slot %lu, fec_set_idx %u, data_sz %lu)", fec->slot, fec->fec_set_idx, fec->data_sz ));
+    return FD_STORE_LEDGER_ERR_INVAL;
+  }
+
+  ulong sz = rec_sz( fec->data_sz );
+
+  /* If the record does not fit before the end of the file, zero the
+     remainder of the file (such that stale records there cannot be
+     recovered out of order) and wrap around. */
+
+  if( FD_UNLIKELY( ledger->head+sz>ledger->file_sz ) ) {
+    ulong gap = ledger->file_sz - ledger->head;
+    if( FD_LIKELY( gap ) ) {
+      fd_memset( ledger->buf, 0, gap );
+      if( FD_UNLIKELY( pwrite( ledger->fd, ledger->buf, gap, (off_t)ledger->head )!=(ssize_t)gap ) ) {
+        FD_LOG_WARNING(( "pwrite(fd %i,off %lu,sz %lu) failed (%i-%s)", ledger->fd, ledger->head, gap, errno, fd_io_strerror( errno ) ));
+        return FD_STORE_LEDGER_ERR_IO;
+      }
+    }
+    ledger->head = DATA0;
+  }
+
+  fd_store_ledger_rec_t * rec = (fd_store_ledger_rec_t *)ledger->buf;
+  *rec = (fd_store_ledger_rec_t){
+    .magic       = FD_STORE_LEDGER_REC_MAGIC,
+    .seq         = ledger->seq,
+    .slot        = fec->slot,
+    .fec_set_idx = fec->fec_set_idx,
+    .parent_off  = fec->parent_off,
+    .data_cnt    = fec->data_cnt,
+    .data_sz     = fec->data_sz,
+    .hash        = 0UL,
+    .mr          = fec->key.mr,
+    .cmr         = fec->cmr,
+    .flags       = fd_uint_if( fec->data_complete, FD_STORE_LEDGER_REC_FLAG_DATA_COMPLETE, 0U ) |
+                   fd_uint_if( fec->slot_complete, FD_STORE_LEDGER_REC_FLAG_SLOT_COMPLETE, 0U )
+  };
+  ulong  hash = fd_hash( FD_STORE_LEDGER_REC_MAGIC, rec, sizeof(fd_store_ledger_rec_t) );
+  uchar * dst = ledger->buf + sizeof(fd_store_ledger_rec_t);
+  rec->hash   = fd_hash_memcpy( hash, dst, fec->data, fec->data_sz );
+  fd_memset( dst+fec->data_sz, 0, sz-sizeof(fd_store_ledger_rec_t)-fec->data_sz );
+
+  if( FD_UNLIKELY( pwrite( ledger->fd, ledger->buf, sz, (off_t)ledger->head )!=(ssize_t)sz ) ) {
+    FD_LOG_WARNING(( "pwrite(fd %i,off %lu,sz %lu) failed (%i-%s)", ledger->fd, ledger->head, sz, errno, fd_io_strerror( errno ) ));
+    return FD_STORE_LEDGER_ERR_IO;
+  }
+
+  slot_insert( ledger, rec, ledger->head );
+  ledger->head            += sz;
+  ledger->seq             += 1UL;
+  ledger->last_slot        = fec->slot;
+  ledger->last_fec_set_idx = fec->fec_set_idx;
+  return FD_STORE_LEDGER_SUCCESS;
+}
+
+ulong
+fd_store_ledger_spill( fd_store_ledger_t * ledger,
+                       fd_store_t        * store,
+                       fd_hash_t const   * merkle_root,
+                       ulong             * path ) {
+
+  fd_store_fec_t const * newr = fd_store_query( store, merkle_root );
+  if( FD_UNLIKELY( !newr ) ) {
+    FD_LOG_WARNING(( "merkle root %s not found", FD_BASE58_ENC_32_ALLOCA( merkle_root ) ));
+    return 0UL;
+  }
+
+  fd_store_pool_t pool = fd_store_pool( store );
+
+  /* The FEC sets to spill are the ancestors of the new root, which are
+     only linked from child to parent.  Collect the path from the new
+     root up to the store root, then append it from the root down. */
+
+  ulong path_cnt = 0UL;
+  for( ulong curr=newr->parent; curr!=null; curr=fd_store_pool_ele_const( &pool, curr )->parent ) {
+    if( FD_UNLIKELY( path_cnt==store->fec_max ) ) {
+      FD_LOG_WARNING(( "path to merkle root %s has a cycle", FD_BASE58_ENC_32_ALLOCA( merkle_root ) ));
+      return 0UL;
+    }
+    path[ path_cnt++ ] = curr;
+  }
+
+  ulong cnt = 0UL;
+  while( path_cnt ) {
+    fd_store_fec_t const * fec = fd_store_pool_ele_const( &pool, path[ --path_cnt ] );
+    if( FD_UNLIKELY( fec->slot==ULONG_MAX ) ) continue;
+    if( FD_UNLIKELY( ledger->last_slot!=ULONG_MAX &&
+                     ( fec->slot<ledger->last_slot || ( fec->slot==ledger->last_slot && fec->fec_set_idx<=ledger->last_fec_set_idx ) ) ) ) continue;
+    if( FD_UNLIKELY( fd_store_ledger_append( ledger, fec ) ) ) break;
+    cnt++;
+  }
+
+  return cnt;
+}
+
+ulong
+fd_store_ledger_refresh( fd_store_ledger_t * ledger ) {
+  if( FD_UNLIKELY( ledger->writable ) ) return 0UL;
+
+  ulong cnt = 0UL;
+  for(;;) {
+    ulong                         off = ledger->head;
+    fd_store_ledger_rec_t const * rec = rec_query( ledger, off );
+    if( FD_UNLIKELY( !rec || rec->seq!=ledger->seq ) ) { /* writer may have wrapped around */
+      off = DATA0;
+      rec = rec_query( ledger, off );
+      if( FD_UNLIKELY( !rec || rec->seq!=ledger->seq ) ) break;
+    }
+    slot_insert( ledger, rec, off );
+    ledger->head             = off + rec_sz( rec->data_sz );
+    ledger->seq              = rec->seq + 1UL;
+    ledger->last_slot        = rec->slot;
+    ledger->last_fec_set_idx = rec->fec_set_idx;
+    cnt++;
+  }
+  return cnt;
+}
+
+fd_store_ledger_rec_t const *
+fd_store_ledger_query( fd_store_ledger_t const * ledger,
+                       ulong                     slot ) {
+  fd_store_ledger_slot_t const * e = ledger->slot_idx + ( slot & (ledger->slot_max-1UL) );
+  if( FD_UNLIKELY( e->slot!=slot ) ) return NULL;
+
+  /* The records of a slot are overwritten oldest first, so the slot is
+     intact iff its first record is. */
+
+  fd_store_ledger_rec_t const * rec = (fd_store_ledger_rec_t const *)( ledger->map + e->off0 );
+  if( FD_UNLIKELY( rec->magic!=FD_STORE_LEDGER_REC_MAGIC || rec->seq!=e->seq0 || rec->slot!=slot ) ) return NULL;
+  return rec;
+}
+
+fd_store_ledger_rec_t const *
+fd_store_ledger_next( fd_store_ledger_t const *     ledger,
+                      fd_store_ledger_rec_t const * rec ) {
+  fd_store_ledger_slot_t const * e = ledger->slot_idx + ( rec->slot & (ledger->slot_max-1UL) );
+  if( FD_UNLIKELY( e->slot!=rec->slot || rec->seq+1UL>=e->seq0+e->rec_cnt ) ) return NULL;
+
+  ulong seq = rec->seq + 1UL;
+  ulong off = (ulong)( (uchar const *)rec - ledger->map ) + rec_sz( rec->data_sz );
+  for( ulong i=0UL; i<2UL; i++ ) {
+    if( FD_LIKELY( off+sizeof(fd_store_ledger_rec_t)<=ledger->file_sz ) ) {
+      fd_store_ledger_rec_t const * next = (fd_store_ledger_rec_t const *)( ledger->map + off );
+      if( FD_LIKELY( next->magic==FD_STORE_LEDGER_REC_MAGIC && next->seq==seq ) ) return next;
+    }
+    off = DATA0; /* wrapped around */
+  }
+  return NULL;
+}
@@ -0,0 +1,290 @@
+#ifndef HEADER_fd_src_disco_store_fd_store_ledger_h
+#define HEADER_fd_src_disco_store_fd_store_ledger_h
+
+/* fd_store_ledger is a persistent on-disk tier behind fd_store.
+
+   fd_store only holds FEC sets that have not been pruned by publish, in
+   a wksp, so everything it holds is lost on restart and nothing older
+   than the store root can be read back.  The ledger keeps rooted FEC
+   sets on disk: before Replay publishes a new store root, the FEC sets
+   that become rooted by the publish (ie. the old root and every FEC set
+   on the path to the new root, excluding the new root itself) are
+   appended to the ledger in chain order.  The new root is appended on
+   the following publish, when it becomes the old root.
+
+   The appends are done by the ledger tile (see fd_ledger_tile.c), off
+   the Replay tile, which defers the store publish until the ledger
+   tile acknowledges the spill.  The ledger tile also reads the ledger
+   back on restart, feeding the rooted FEC sets that follow the
+   snapshot slot to Replay.
+
+   FILE FORMAT
+
+   The ledger is a single large file (or block device) of a fixed size
+   that is a multiple of FD_STORE_LEDGER_BLOCK_SZ.  The first block
+   holds the file header.  The remainder of the file is a circular log
+   of records.  Each record is a fd_store_ledger_rec_t header followed
+   by the FEC set payload, zero padded to a block multiple, such that
+   every record starts on a block boundary and can be written with
+   direct I/O.  Records never wrap around the end of the file.  If a
+   record does not fit before the end of the file, the remainder of the
+   file is zeroed and the record is written at the start of the log
+   instead (overwriting the oldest records).
+
+   Every record has a sequence number that increments by one for each
+   record appended.  A record header is protected by a hash over the
+   header and the payload, such that torn or stale records (eg. a write
+   that was in progress during a crash) are detected and ignored.
+
+   INDEX
+
+   The ledger maintains an in-memory index from slot to the range of
+   records for that slot, covering the slot_max most recently appended
+   slots (slot_max is a power of two and the index is direct mapped by
+   slot, so an older slot is forgotten when a newer slot maps to the
+   same index entry).  Because rooted FEC sets are appended in chain
+   order, the records of a slot are contiguous in sequence number.
+
+   The index is not persisted.  On init, the ledger recovers by scanning
+   and validating the records in the file and rebuilding the index, so
+   init reads the whole file.
+
+   READS
+
+   The file is mapped read-only in the caller's address space and
+   queries return pointers directly into the mapping (zero-copy).  A
+   record of a slot is valid until it is overwritten by an append that
+   wraps around.  Writes use direct I/O and readers in other processes
+   (eg. an offline tool) read through the page cache, so a
+   reader that races with the writer should check that rec->seq is
+   unchanged after it is done consuming the record.
+
+   A ledger join is local to the caller: the writer (ledger tile) has a
+   writable join and any number of readers can have read-only joins of
+   the same file.  Read-only joins do not see records appended after
+   their init until they call fd_store_ledger_refresh.
+
+   LIMITATIONS
+
+   The ledger tile's restart feed is currently the only reader.  Repair
+   does not serve requests for rooted slots from the ledger: repair
+   responses are the original signed shreds, and the ledger (like the
+   store) only holds coalesced FEC set payloads.  Backtest does not read
+   from the ledger either: it checks replayed bank hashes against the
+   ones recorded in rocksdb, and the ledger does not record bank hashes.
+   Both need the ledger to keep more than the payload and are left as
+   follow-ups. */
+
+#include "fd_store.h"
+
+/* FD_STORE_LEDGER_BLOCK_SZ is the direct I/O block size.  All records
+   start on and are sized to a multiple of this. */
+
+#define FD_STORE_LEDGER_BLOCK_SZ (4096UL)
+
+/* FD_STORE_LEDGER_{MAGIC,REC_MAGIC} are magic numbers for detecting
+   ledger file headers and record headers. */
+
+#define FD_STORE_LEDGER_MAGIC     (0xf17eda2ce71ed600UL) /* firedancer ledger version 0 */
+#define FD_STORE_LEDGER_REC_MAGIC (0xf17eda2ce71edec0UL)
+
+/* FD_STORE_LEDGER_REC_MAX is the max size of a record (header and a
+   FD_STORE_DATA_MAX payload rounded up to a block multiple). */
+
+#define FD_STORE_LEDGER_REC_MAX (65536UL)
+
+/* FD_STORE_LEDGER_FILE_MIN is the min size of a ledger file (the file
+   header block and room for at least two max size records). */
+
+#define FD_STORE_LEDGER_FILE_MIN (FD_STORE_LEDGER_BLOCK_SZ + 2UL*FD_STORE_LEDGER_REC_MAX)
+
+/* Error codes */
+
+#define FD_STORE_LEDGER_SUCCESS   ( 0)
+#define FD_STORE_LEDGER_ERR_INVAL (-1) /* invalid args */
+#define FD_STORE_LEDGER_ERR_IO    (-2) /* failed to write to the file */
+#define FD_STORE_LEDGER_ERR_PERM  (-3) /* ledger is read-only */
+
+/* FD_STORE_LEDGER_REC_FLAG_* are the record flags, mirroring the flags
+   of the last data shred of the FEC set. */
+
+#define FD_STORE_LEDGER_REC_FLAG_DATA_COMPLETE (1U)
+#define FD_STORE_LEDGER_REC_FLAG_SLOT_COMPLETE (2U)
+
+/* fd_store_ledger_rec_t is the header of a record in the ledger file.
+   The FEC set payload immediately follows the header. */
+
+struct __attribute__((aligned(64))) fd_store_ledger_rec {
+  ulong     magic;       /* ==FD_STORE_LEDGER_REC_MAGIC */
+  ulong     seq;         /* sequence number of the record */
+  ulong     slot;        /* slot of the FEC set */
+  uint      fec_set_idx; /* fec_set_idx of the FEC set */
+  ushort    parent_off;  /* slot - parent slot */
+  ushort    data_cnt;    /* number of data shreds in the FEC set */
+  ulong     data_sz;     /* sz of the FEC set payload, in [0,FD_STORE_DATA_MAX] */
+  ulong     hash;        /* hash of the header (with hash==0) and payload */
+  fd_hash_t mr;          /* merkle root of the FEC set */
+  fd_hash_t cmr;         /* chained merkle root of the FEC set */
+  uint      flags;       /* FD_STORE_LEDGER_REC_FLAG_* */
+};
+typedef struct fd_store_ledger_rec fd_store_ledger_rec_t;
+
+FD_STATIC_ASSERT( sizeof(fd_store_ledger_rec_t)==128UL, fd_store_ledger_rec );
+FD_STATIC_ASSERT( sizeof(fd_store_ledger_rec_t)+FD_STORE_DATA_MAX<=FD_STORE_LEDGER_REC_MAX, fd_store_ledger_rec );
+
+/* fd_store_ledger_slot_t is an entry of the slot index.  The records of
+   slot have sequence numbers [seq0,seq0+rec_cnt) and the first record
+   is at file offset off0. */
+
+struct fd_store_ledger_slot {
+  ulong slot;    /* ULONG_MAX if the entry is unused */
+  ulong seq0;
+  ulong off0;
+  ulong rec_cnt;
+};
+typedef struct fd_store_ledger_slot fd_store_ledger_slot_t;
+
+struct __attribute__((aligned(FD_STORE_LEDGER_BLOCK_SZ))) fd_store_ledger {
+  ulong   magic;    /* ==FD_STORE_LEDGER_MAGIC */
+  int     fd;       /* file descriptor of the ledger file */
+  int     writable; /* non-zero if this is the writer's join */
+  ulong   file_sz;  /* sz of the ledger file */
+  uchar * map;      /* read-only mapping of the ledger file */
+  ulong   head;     /* file offset of the next record */
+  ulong   seq;      /* sequence number of the next record */
+  ulong   slot_max; /* number of index entries, power of 2 */
+
+  ulong   last_slot;        /* slot of the newest record, ULONG_MAX if empty */
+  uint    last_fec_set_idx; /* fec_set_idx of the newest record */
+
+  fd_store_ledger_slot_t * slot_idx; /* index, indexed by slot & (slot_max-1) */
+  uchar *                  buf;      /* FD_STORE_LEDGER_REC_MAX staging buffer for direct I/O appends */
+};
+typedef struct fd_store_ledger fd_store_ledger_t;
+
+FD_PROTOTYPES_BEGIN
+
+/* fd_store_ledger_{align,footprint} return the required alignment and
+   footprint of a memory region suitable for use as a ledger join with
+   an index of slot_max slots.  slot_max is an integer power-of-two.
+   footprint returns 0 if slot_max is invalid. */
+
+FD_FN_CONST static inline ulong
+fd_store_ledger_align( void ) {
+  return alignof(fd_store_ledger_t);
+}
+
+FD_FN_CONST static inline ulong
+fd_store_ledger_footprint( ulong slot_max ) {
+  if( FD_UNLIKELY( !fd_ulong_is_pow2( slot_max ) ) ) return 0UL;
+  return FD_LAYOUT_FINI(
+    FD_LAYOUT_APPEND(
+    FD_LAYOUT_APPEND(
+    FD_LAYOUT_APPEND(
+    FD_LAYOUT_INIT,
+      alignof(fd_store_ledger_t),      sizeof(fd_store_ledger_t)                 ),
+      FD_STORE_LEDGER_BLOCK_SZ,        FD_STORE_LEDGER_REC_MAX                   ),
+      alignof(fd_store_ledger_slot_t), sizeof(fd_store_ledger_slot_t)*slot_max   ),
+    fd_store_ledger_align() );
+}
+
+/* fd_store_ledger_init starts using the file open at fd as a ledger.
+   mem points to a memory region with the required footprint and
+   alignment to hold the ledger join.  The file should already exist
+   and be sized to its capacity (a FD_STORE_LEDGER_BLOCK_SZ multiple and
+   at least FD_STORE_LEDGER_FILE_MIN).
+
+   If writable is non-zero, fd should be open read-write (typically with
+   O_DIRECT) and the caller will be the only writer of the file.  If the
+   file does not have a ledger header, the file is formatted as an empty
+   ledger.  Otherwise, fd can be open read-only and the file must
+   already have a ledger header.  In both cases, the index is recovered
+   from the records in the file.
+
+   Returns a handle to the ledger on success (has ownership of mem, fd
+   ownership stays with the caller) and NULL on failure (logs details).
+   Maps the file so should be called before sandboxing. */
+
+fd_store_ledger_t *
+fd_store_ledger_init( void * mem,
+                      ulong  slot_max,
+                      int    fd,
+                      int    writable );
+
+/* fd_store_ledger_fini stops using the ledger.  Unmaps the file.
+   Returns mem on success (ownership returned to the caller) and NULL
+   on failure (logs details).  Does not close the file descriptor. */
+
+void *
+fd_store_ledger_fini( fd_store_ledger_t * ledger );
+
+/* fd_store_ledger_append appends the FEC set fec (its key, metadata and
+   payload) to the ledger.  fec->slot should be known.  FEC sets of a
+   slot should be appended in fec_set_idx order with no interleaving of
+   other slots.  Returns FD_STORE_LEDGER_SUCCESS on success and a
+   FD_STORE_LEDGER_ERR code on failure (logs details).  Retains no
+   interest in fec. */
+
+int
+fd_store_ledger_append( fd_store_ledger_t *    ledger,
+                        fd_store_fec_t const * fec );
+
+/* fd_store_ledger_spill appends to the ledger the FEC sets in store
+   that become rooted when publishing merkle_root as the new store root
+   (see above).  FEC sets that do not have a slot (e.g. the synthetic
+   genesis or snapshot root) and FEC sets that are not newer than the
+   newest record in the ledger (ie. already spilled, eg. before a
+   restart) are skipped.  Should be called before fd_store_publish.
+   Returns the number of FEC sets appended.  Stops at the first append
+   failure (logs details).
+
+   path is scratch space for store->fec_max pool indices, used to walk
+   the path from the store root to merkle_root in chain order.  Does not
+   modify the store, so the caller can be any tile that has pinned its
+   partition via fd_store_shacq, provided the publisher does not publish
+   a new root until the spill returns.  Assumes merkle_root is in the
+   store and descends from the store root. */
+
+ulong
+fd_store_ledger_spill( fd_store_ledger_t * ledger,
+                       fd_store_t        * store,
+                       fd_hash_t const   * merkle_root,
+                       ulong             * path );
+
+/* fd_store_ledger_refresh indexes records appended by the writer since
+   the last init or refresh.  Intended for read-only joins (it is a
+   no-op for the writer's join).  Returns the number of records
+   indexed. */
+
+ulong
+fd_store_ledger_refresh( fd_store_ledger_t * ledger );
+
+/* fd_store_ledger_query returns a pointer in the caller's address space
+   to the record of the first FEC set of slot in the ledger, or NULL if
+   slot is not in the index or its records have since been overwritten.
+   The lifetime of the returned pointer is the lifetime of the join, but
+   see above for records that are overwritten. */
+
+fd_store_ledger_rec_t const *
+fd_store_ledger_query( fd_store_ledger_t const * ledger,
+                       ulong                     slot );
+
+/* fd_store_ledger_next returns the record of the FEC set following rec
+   in the same slot, or NULL if rec is the last FEC set of its slot in
+   the ledger.  rec is a record returned by query or next. */
+
+fd_store_ledger_rec_t const *
+fd_store_ledger_next( fd_store_ledger_t const *     ledger,
+                      fd_store_ledger_rec_t const * rec );
+
+/* fd_store_ledger_rec_data returns a pointer to the FEC set payload of
+   rec (rec->data_sz bytes). */
+
+FD_FN_CONST static inline uchar const *
+fd_store_ledger_rec_data( fd_store_ledger_rec_t const * rec ) {
+  return (uchar const *)( rec+1 );
+}
+
+FD_PROTOTYPES_END
+
+#endif /* HEADER_fd_src_disco_store_fd_store_ledger_h */
@@ -248,6 +248,99 @@ test_map_function( fd_wksp_t * wksp ) {
   FD_TEST( fec1->next == ULONG_MAX );
 }
 
+/* test_reclaim checks that publish defers releasing pruned elements to
+   the owners of their partitions, and that an owner does not release
+   a removed element while another partition is pinned.
+
+         mr0 (publisher)
+        /   \
+      mr1   mr3 (part 0)
+       |
+      mr2 (part 1)
+*/
+
+void
+test_reclaim( fd_wksp_t * wksp ) {
+  ulong  fec_max     = 16;
+  void * mem         = fd_wksp_alloc_laddr( wksp, fd_store_align(), fd_store_footprint( fec_max ), 1UL );
+  fd_store_t * store = fd_store_join( fd_store_new( mem, fec_max, 2UL ) );
+  FD_TEST( store );
+  FD_TEST( store->part_cnt == 3UL );
+  ulong pub = fd_store_pub_part( store );
+  FD_TEST( pub == 2UL );
+
+  fd_hash_t mr0 = { .ul = { 0 } };
+  fd_hash_t mr1 = { .ul = { 1 } };
+  fd_hash_t mr2 = { .ul = { 2 } };
+  fd_hash_t mr3 = { .ul = { 3 } };
+
+  fd_store_shacq( store, pub );
+  FD_TEST( fd_store_insert( store, pub, &mr0 ) );
+  FD_TEST( fd_store_insert( store, 0,   &mr1 ) );
+  FD_TEST( fd_store_insert( store, 1,   &mr2 ) );
+  FD_TEST( fd_store_insert( store, 0,   &mr3 ) );
+  FD_TEST( fd_store_link( store, &mr1, &mr0 ) );
+  FD_TEST( fd_store_link( store, &mr2, &mr1 ) );
+  FD_TEST( fd_store_link( store, &mr3, &mr0 ) );
+
+  /* Publishing mr1 prunes mr0 and mr3.  They are no longer returned by
+     queries but stay in the map until their owners reclaim them. */
+
+  fd_store_fec_t * fec0 = fd_store_query( store, &mr0 );
+  fd_store_fec_t * fec3 = fd_store_query( store, &mr3 );
+  FD_TEST( fd_store_publish( store, &mr1 ) == fd_store_query( store, &mr1 ) );
+  fd_store_shrel( store, pub );
+
+  FD_TEST( !fd_store_query( store, &mr0 ) );
+  FD_TEST( !fd_store_query( store, &mr3 ) );
+  FD_TEST( fd_store_private_query_idx( store, &mr3 ) == (ulong)(fec3 - fd_store_fec0( store )) );
+  FD_TEST( fd_store_query( store, &mr1 ) );
+  FD_TEST( fd_store_query( store, &mr2 ) );
+  FD_TEST( fec3->epoch == 0UL );
+  FD_TEST( store->part[ 0   ].retire == (ulong)(fec3 - fd_store_fec0( store )) );
+  FD_TEST( store->part[ pub ].retire == (ulong)(fec0 - fd_store_fec0( store )) );
+  FD_TEST( store->part[ 1   ].retire == fd_store_pool_idx_null() );
+
+  /* A pruned merkle root cannot be reinserted until it is reclaimed. */
+
+  fd_store_shacq( store, 1 );
+  FD_TEST( !fd_store_insert( store, 1, &mr3 ) );
+
+  /* Partition 1 is pinned, so partition 0 can remove mr3 from the map
+     but not release it. */
+
+  FD_TEST( fd_store_reclaim( store, 0 ) == 0UL );
+  FD_TEST( fd_store_private_query_idx( store, &mr3 ) == ULONG_MAX );
+  FD_TEST( store->part[ 0 ].retire     == fd_store_pool_idx_null() );
+  FD_TEST( store->part[ 0 ].limbo_head == (ulong)(fec3 - fd_store_fec0( store )) );
+  FD_TEST( fec3->epoch != 0UL && fec3->epoch != ULONG_MAX );
+  FD_TEST( fd_store_reclaim( store, 0 ) == 0UL );
+  fd_store_shrel( store, 1 );
+
+  FD_TEST( fd_store_reclaim( store, 0 ) == 1UL );
+  FD_TEST( store->part[ 0 ].limbo_head == fd_store_pool_idx_null() );
+  FD_TEST( store->part[ 0 ].limbo_tail == fd_store_pool_idx_null() );
+
+  /* A pin taken before the removal holds back the release, a pin taken
+     after the removal does not. */
+
+  fd_store_shacq( store, 0 );
+  FD_TEST( fd_store_reclaim( store, pub ) == 0UL );
+  fd_store_shrel( store, 0 );
+  fd_store_shacq( store, 0 );
+  FD_TEST( fd_store_reclaim( store, pub ) == 1UL );
+  FD_TEST( fd_store_insert( store, 0, &mr3 ) );
+  FD_TEST( fd_store_insert( store, 0, &mr0 ) );
+  fd_store_shrel( store, 0 );
+
+  FD_TEST( fd_store_verify( store ) == 0 );
+
+  fd_store_clear( store );
+  FD_TEST( fd_store_root( store ) == NULL );
+
+  fd_wksp_free_laddr( fd_store_delete( fd_store_leave( store ) ) );
+}
+
 static ulong      tile_go;
 static ulong      num_insert = 10;
 static fd_store_t * store;
@@ -262,10 +355,10 @@ shred_tile_insert( int argc, char ** argv ) {
   ulong tile_idx = fd_tile_idx();
   for( ulong i = 1; i < num_insert; i++ ) {
     fd_hash_t mr = { .ul = { (i << 16) | tile_idx } };
-    fd_rwlock_read( &store->lock );
+    fd_store_shacq( store, tile_idx );
     FD_LOG_NOTICE(( "inserting %lu at tile %lu", i, tile_idx ));
     fd_store_insert( store, (uint)tile_idx, &mr );
-    fd_rwlock_unread( &store->lock );
+    fd_store_shrel( store, tile_idx );
   }
   return 0;
 }
@@ -304,9 +397,9 @@ test_para( fd_wksp_t * wksp ) {
   for( ulong tile_idx=1UL; tile_idx<available_tiles; tile_idx++ ) {
     for( ulong i = 1; i < num_insert; i++ ) {
       fd_hash_t mr = { .ul = { (i << 16) | tile_idx } };
-      fd_rwlock_read( &store->lock );
+      fd_store_shacq( store, fd_store_pub_part( store ) );
       FD_TEST( fd_store_query( store, &mr ) );
-      fd_rwlock_unread( &store->lock );
+      fd_store_shrel( store, fd_store_pub_part( store ) );
     }
   }
 
@@ -326,6 +419,7 @@ main( int argc, char ** argv ) {
   //test_simple( wksp );
   test_mr( wksp );
   test_map_function( wksp );
+  test_reclaim( wksp );
   test_para( wksp );
 
   fd_halt();
@@ -0,0 +1,294 @@
+#include "fd_store_ledger.h"
+
+#include <stdlib.h> /* For mkstemp */
+#include <errno.h>  /* For errno */
+#include <unistd.h> /* For ftruncate */
+
+#define SLOT_MAX (64UL)
+
+static uchar ledger_mem[ 2UL ][ 131072UL ] __attribute__((aligned(FD_STORE_LEDGER_BLOCK_SZ)));
+static uchar data_buf  [ FD_STORE_DATA_MAX ];
+static ulong path      [ 8UL ];
+
+static fd_store_fec_t fec_buf;
+
+/* fec_data fills data_buf with the payload of FEC set (slot,
+   fec_set_idx) and returns its sz. */
+
+static ulong
+fec_data( ulong slot,
+          uint  fec_set_idx ) {
+  fd_rng_t rng[1]; fd_rng_join( fd_rng_new( rng, (uint)slot, (ulong)fec_set_idx ) );
+  ulong sz = fd_rng_ulong_roll( rng, FD_STORE_DATA_MAX+1UL );
+  for( ulong i=0UL; i<sz; i++ ) data_buf[ i ] = fd_rng_uchar( rng );
+  fd_rng_delete( fd_rng_leave( rng ) );
+  return sz;
+}
+
+/* fec_fill fills fec with FEC set (slot, fec_set_idx). */
+
+static void
+fec_fill( fd_store_fec_t * fec,
+          ulong            slot,
+          uint             fec_set_idx ) {
+  fec->key.mr        = (fd_hash_t){ .ul = { slot, fec_set_idx } };
+  fec->cmr           = (fd_hash_t){ .ul = { slot, fec_set_idx-1U } };
+  fec->slot          = slot;
+  fec->fec_set_idx   = fec_set_idx;
+  fec->parent_off    = (ushort)( 1UL + slot%3UL );
+  fec->data_cnt      = (ushort)( 1U + fec_set_idx );
+  fec->data_complete = 1;
+  fec->slot_complete = !(fec_set_idx%2U);
+  fec->data_sz       = fec_data( slot, fec_set_idx );
+  fd_memcpy( fec->data, data_buf, fec->data_sz );
+}
+
+static void
+append( fd_store_ledger_t * ledger,
+        ulong               slot,
+        uint                fec_set_idx ) {
+  fec_fill( &fec_buf, slot, fec_set_idx );
+  FD_TEST( fd_store_ledger_append( ledger, &fec_buf )==FD_STORE_LEDGER_SUCCESS );
+  FD_TEST( ledger->last_slot==slot && ledger->last_fec_set_idx==fec_set_idx );
+}
+
+/* check_slot checks that slot is in the ledger with fec_cnt FEC sets. */
+
+static void
+check_slot( fd_store_ledger_t const * ledger,
+            ulong                     slot,
+            ulong                     fec_cnt ) {
+  fd_store_ledger_rec_t const * rec = fd_store_ledger_query( ledger, slot );
+  for( uint i=0U; i<fec_cnt; i++ ) {
+    FD_TEST( rec );
+    FD_TEST( rec->slot==slot && rec->fec_set_idx==i );
+    FD_TEST( rec->mr.ul[0]==slot && rec->mr.ul[1]==i );
+    FD_TEST( rec->parent_off==1UL + slot%3UL && rec->data_cnt==1U + i );
+    FD_TEST( rec->flags==( FD_STORE_LEDGER_REC_FLAG_DATA_COMPLETE | fd_uint_if( !(i%2U), FD_STORE_LEDGER_REC_FLAG_SLOT_COMPLETE, 0U ) ) );
+    ulong sz = fec_data( slot, i );
+    FD_TEST( rec->data_sz==sz );
+    FD_TEST( !memcmp( fd_store_ledger_rec_data( rec ), data_buf, sz ) );
+    rec = fd_store_ledger_next( ledger, rec );
+  }
+  FD_TEST( !rec );
+}
+
+static void
+test_ledger( int fd ) {
+  FD_TEST( fd_store_ledger_align()==FD_STORE_LEDGER_BLOCK_SZ );
+  FD_TEST( fd_store_ledger_footprint( SLOT_MAX )<=sizeof(ledger_mem[0]) );
+  FD_TEST( !fd_store_ledger_footprint( 3UL ) );
+
+  FD_TEST( !ftruncate( fd, 0L ) );
+  FD_TEST( !ftruncate( fd, (off_t)( FD_STORE_LEDGER_BLOCK_SZ + 64UL*FD_STORE_LEDGER_REC_MAX ) ) );
+
+  FD_TEST( !fd_store_ledger_init( ledger_mem[0], SLOT_MAX, fd, 0 ) ); /* not a ledger */
+  fd_store_ledger_t * writer = fd_store_ledger_init( ledger_mem[0], SLOT_MAX, fd, 1 );
+  FD_TEST( writer );
+  FD_TEST( writer->last_slot==ULONG_MAX );
+  FD_TEST( !fd_store_ledger_query( writer, 10UL ) );
+
+  for( uint i=0U; i<3U; i++ ) append( writer, 10UL, i );
+  for( uint i=0U; i<2U; i++ ) append( writer, 11UL, i );
+  check_slot( writer, 10UL, 3UL );
+  check_slot( writer, 11UL, 2UL );
+  FD_TEST( !fd_store_ledger_query( writer, 12UL ) );
+
+  fd_store_ledger_t * reader = fd_store_ledger_init( ledger_mem[1], SLOT_MAX, fd, 0 );
+  FD_TEST( reader );
+  check_slot( reader, 10UL, 3UL );
+  check_slot( reader, 11UL, 2UL );
+
+  FD_TEST( reader->last_slot==11UL && reader->last_fec_set_idx==1U );
+  fec_fill( &fec_buf, 12UL, 0U );
+  FD_TEST( fd_store_ledger_append( reader, &fec_buf )==FD_STORE_LEDGER_ERR_PERM );
+  fec_buf.slot = ULONG_MAX;
+  FD_TEST( fd_store_ledger_append( writer, &fec_buf )==FD_STORE_LEDGER_ERR_INVAL );
+
+  for( uint i=0U; i<4U; i++ ) append( writer, 12UL, i );
+  FD_TEST( !fd_store_ledger_query( reader, 12UL ) );
+  FD_TEST( fd_store_ledger_refresh( reader )==4UL );
+  FD_TEST( fd_store_ledger_refresh( reader )==0UL );
+  FD_TEST( reader->last_slot==12UL && reader->last_fec_set_idx==3U );
+  check_slot( reader, 12UL, 4UL );
+
+  /* Recover the writer */
+
+  ulong head = writer->head;
+  ulong seq  = writer->seq;
+  FD_TEST( fd_store_ledger_fini( writer )==ledger_mem[0] );
+  writer = fd_store_ledger_init( ledger_mem[0], SLOT_MAX, fd, 1 );
+  FD_TEST( writer );
+  FD_TEST( writer->head==head && writer->seq==seq );
+  FD_TEST( writer->last_slot==12UL && writer->last_fec_set_idx==3U );
+  check_slot( writer, 10UL, 3UL );
+  check_slot( writer, 11UL, 2UL );
+  check_slot( writer, 12UL, 4UL );
+
+  /* Append enough slots to wrap around the file several times.  Check
+     the newest slots can be read back by the writer, a refreshed reader
+     and after recovery (which exercises recovering at every possible
+     head position). */
+
+  for( ulong slot=13UL; slot<200UL; slot++ ) {
+    ulong fec_cnt = 1UL + slot%5UL;
+    for( uint i=0U; i<fec_cnt; i++ ) append( writer, slot, i );
+
+    check_slot( writer, slot, fec_cnt );
+    FD_TEST( fd_store_ledger_refresh( reader )==fec_cnt );
+    check_slot( reader, slot, fec_cnt );
+    if( slot>13UL ) check_slot( reader, slot-1UL, 1UL + (slot-1UL)%5UL );
+
+    if( !(slot%7UL) ) {
+      head = writer->head;
+      seq  = writer->seq;
+      FD_TEST( fd_store_ledger_fini( writer )==ledger_mem[0] );
+      writer = fd_store_ledger_init( ledger_mem[0], SLOT_MAX, fd, 1 );
+      FD_TEST( writer );
+      FD_TEST( writer->head==head && writer->seq==seq );
+      FD_TEST( writer->last_slot==slot && writer->last_fec_set_idx==fec_cnt-1UL );
+      check_slot( writer, slot,     fec_cnt );
+      check_slot( writer, slot-1UL, 1UL + (slot-1UL)%5UL );
+    }
+  }
+  FD_TEST( !fd_store_ledger_query( writer, 13UL ) ); /* overwritten */
+  FD_TEST( !fd_store_ledger_query( reader, 13UL ) );
+
+  /* Corrupt the last record (as in a torn write) and recover.  The
+     corrupt record should be dropped and the slot truncated. */
+
+  fd_store_ledger_rec_t const * last = fd_store_ledger_query( writer, 199UL );
+  for( ulong i=1UL; i<1UL+199UL%5UL; i++ ) last = fd_store_ledger_next( writer, last );
+  FD_TEST( last && !fd_store_ledger_next( writer, last ) );
+  ulong last_off = (ulong)( (uchar const *)last - writer->map );
+  ulong last_seq = last->seq;
+  uchar garbage[ FD_STORE_LEDGER_BLOCK_SZ ]; memset( garbage, 0xa5, sizeof(garbage) );
+  FD_TEST( pwrite( fd, garbage, sizeof(garbage), (off_t)last_off )==(ssize_t)sizeof(garbage) );
+
+  FD_TEST( fd_store_ledger_fini( writer )==ledger_mem[0] );
+  writer = fd_store_ledger_init( ledger_mem[0], SLOT_MAX, fd, 1 );
+  FD_TEST( writer );
+  FD_TEST( writer->head==last_off && writer->seq==last_seq );
+  FD_TEST( writer->last_slot==199UL && writer->last_fec_set_idx==199UL%5UL-1UL );
+  check_slot( writer, 199UL, 199UL%5UL );
+  append( writer, 199UL, (uint)(199UL%5UL) );
+  check_slot( writer, 199UL, 1UL + 199UL%5UL );
+
+  FD_TEST( fd_store_ledger_fini( reader )==ledger_mem[1] );
+  FD_TEST( fd_store_ledger_fini( writer )==ledger_mem[0] );
+  FD_TEST( !fd_store_ledger_fini( NULL ) );
+
+  /* Bad files */
+
+  FD_TEST( !ftruncate( fd, (off_t)FD_STORE_LEDGER_BLOCK_SZ ) );
+  FD_TEST( !fd_store_ledger_init( ledger_mem[0], SLOT_MAX, fd, 1 ) ); /* too small */
+  FD_TEST( !ftruncate( fd, (off_t)( FD_STORE_LEDGER_FILE_MIN + 1UL ) ) );
+  FD_TEST( !fd_store_ledger_init( ledger_mem[0], SLOT_MAX, fd, 1 ) ); /* misaligned */
+  FD_TEST( !ftruncate( fd, (off_t)( 2UL*FD_STORE_LEDGER_FILE_MIN ) ) );
+  FD_TEST( !fd_store_ledger_init( ledger_mem[0], SLOT_MAX, fd, 1 ) ); /* resized */
+  FD_TEST( !fd_store_ledger_init( ledger_mem[0], 3UL,      fd, 1 ) ); /* bad slot_max */
+}
+
+/* test_spill spills the store (single FEC set per slot, as in
+   test_store.c):
+
+         slot 0
+           |
+         slot 1
+         /    \
+    slot 2    |
+       |    slot 3
+    slot 4    |
+            slot 5
+              |
+            slot 6 */
+
+static void
+test_spill( fd_wksp_t * wksp,
+            int         fd ) {
+  FD_TEST( !ftruncate( fd, 0L ) );
+  FD_TEST( !ftruncate( fd, (off_t)( FD_STORE_LEDGER_BLOCK_SZ + 64UL*FD_STORE_LEDGER_REC_MAX ) ) );
+  fd_store_ledger_t * ledger = fd_store_ledger_init( ledger_mem[0], SLOT_MAX, fd, 1 );
+  FD_TEST( ledger );
+
+  ulong  fec_max     = 8;
+  void * mem         = fd_wksp_alloc_laddr( wksp, FD_STORE_ALIGN, fd_store_footprint( fec_max ), 1UL );
+  fd_store_t * store = fd_store_join( fd_store_new( mem, fec_max, 1UL ) );
+  FD_TEST( store );
+
+  fd_hash_t mr[7];
+  for( ulong i=0UL; i<7UL; i++ ) {
+    mr[i] = (fd_hash_t){ .ul = { i, 0UL } };
+    fd_store_fec_t * fec = fd_store_insert( store, 0, &mr[i] );
+    FD_TEST( fec );
+    if( i ) { /* slot 0 is the synthetic snapshot root */
+      fec_fill( fec, i, 0U ); /* same key */
+    }
+  }
+  ulong parent[7] = { ULONG_MAX, 0, 1, 1, 2, 3, 5 };
+  for( ulong i=1UL; i<7UL; i++ ) {
+    fd_store_fec_t * fec = fd_store_link( store, &mr[i], &mr[parent[i]] );
+    FD_TEST( fec );
+    FD_TEST( !memcmp( &fec->cmr, &mr[parent[i]], sizeof(fd_hash_t) ) );
+  }
+
+  FD_TEST( fd_store_ledger_spill( ledger, store, &mr[0], path )==0UL ); /* root */
+  FD_TEST( fd_store_ledger_spill( ledger, store, &mr[5], path )==2UL ); /* 0 (skipped), 1, 3 */
+  FD_TEST( fd_store_ledger_spill( ledger, store, &mr[5], path )==0UL ); /* already spilled */
+  for( ulong i=1UL; i<7UL; i++ ) {
+    FD_TEST( fd_store_parent( store, fd_store_query( store, &mr[i] ) )==fd_store_query( store, &mr[parent[i]] ) );
+  }
+  FD_TEST( !fd_store_ledger_query( ledger, 0UL ) );
+  check_slot( ledger, 1UL, 1UL );
+  check_slot( ledger, 3UL, 1UL );
+  FD_TEST( fd_store_ledger_query( ledger, 3UL )->cmr.ul[0]==1UL );
+  FD_TEST( !fd_store_ledger_query( ledger, 2UL ) );
+  FD_TEST( !fd_store_ledger_query( ledger, 5UL ) );
+
+  /* A spill that was interrupted before the publish (eg. by a restart)
+     is not appended twice after recovery. */
+
+  FD_TEST( fd_store_ledger_fini( ledger )==ledger_mem[0] );
+  ledger = fd_store_ledger_init( ledger_mem[0], SLOT_MAX, fd, 1 );
+  FD_TEST( ledger );
+  FD_TEST( fd_store_ledger_spill( ledger, store, &mr[5], path )==0UL );
+  check_slot( ledger, 3UL, 1UL );
+
+  FD_TEST( fd_store_publish( store, &mr[5] ) );
+  FD_TEST( fd_store_ledger_spill( ledger, store, &mr[6], path )==1UL ); /* 5 */
+  FD_TEST( fd_store_publish( store, &mr[6] ) );
+  check_slot( ledger, 5UL, 1UL );
+  FD_TEST( !fd_store_ledger_query( ledger, 6UL ) );
+
+  FD_TEST( fd_store_ledger_fini( ledger )==ledger_mem[0] );
+  fd_wksp_free_laddr( fd_store_delete( fd_store_leave( store ) ) );
+}
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  char const * _page_sz = fd_env_strip_cmdline_cstr ( &argc, &argv, "--page-sz",  NULL, "normal"                   );
+  ulong        page_cnt = fd_env_strip_cmdline_ulong( &argc, &argv, "--page-cnt", NULL, 2048UL                     );
+  ulong        numa_idx = fd_env_strip_cmdline_ulong( &argc, &argv, "--numa-idx", NULL, fd_shmem_numa_idx( 0 )     );
+
+  fd_wksp_t * wksp = fd_wksp_new_anonymous( fd_cstr_to_shmem_page_sz( _page_sz ), page_cnt, fd_shmem_cpu_idx( numa_idx ), "wksp", 0UL );
+  FD_TEST( wksp );
+
+  char path[] = "/tmp/test_store_ledger.XXXXXX";
+  int  fd     = mkstemp( path );
+  if( FD_UNLIKELY( fd==-1 ) ) FD_LOG_ERR(( "mkstemp failed (%i-%s)", errno, fd_io_strerror( errno ) ));
+
+  test_ledger( fd );
+  test_spill( wksp, fd );
+
+  if( FD_UNLIKELY( close( fd ) ) ) FD_LOG_WARNING(( "close failed (%i-%s)", errno, fd_io_strerror( errno ) ));
+  if( FD_UNLIKELY( unlink( path ) ) ) FD_LOG_WARNING(( "unlink failed (%i-%s)", errno, fd_io_strerror( errno ) ));
+
+  fd_wksp_delete_anonymous( wksp );
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
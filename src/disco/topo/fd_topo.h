@@ -182,6 +182,8 @@ struct fd_topo_tile {
       /* sock specific options */
       int so_sndbuf;
       int so_rcvbuf;
+      int udp_gso;   /* batch same-destination TX packets with UDP_SEGMENT */
+      int udp_gro;   /* receive coalesced datagrams with UDP_GRO */
     } sock;
 
     struct {
@@ -361,6 +363,15 @@ struct fd_topo_tile {
       ulong txncache_obj_id;
       ulong progcache_obj_id;
 
+      /* Rooted tier run by the vinyl tile, only used if there is a
+         replay_vinyl link */
+      char  vinyl_path[ PATH_MAX ];
+      ulong vinyl_meta_map_obj_id;
+      ulong vinyl_meta_pool_obj_id;
+      ulong vinyl_data_obj_id;
+      ulong vinyl_line_cnt;
+      ulong vinyl_val_max;
+
       char  shred_cap[ PATH_MAX ];
       char  cluster_version[ 32 ];
 
@@ -373,6 +384,8 @@ struct fd_topo_tile {
       ulong heap_size_gib;
       ulong max_live_slots;
 
+      int   sched_priority; /* FD_RDISP_PRIORITY_* */
+
       /* not specified in TOML */
 
       ulong enable_features_cnt;
@@ -400,6 +413,7 @@ struct fd_topo_tile {
       ulong progcache_obj_id;
 
       ulong max_live_slots;
+      ulong jit_code_max; /* size of the compiled program arena in bytes, 0 to disable */
 
       ulong capture_start_slot;
       char  solcap_capture[ PATH_MAX ];
@@ -460,6 +474,7 @@ struct fd_topo_tile {
 
     struct {
       ushort  send_src_port;
+      uint    cc_algo;
 
       /* non-config */
 
@@ -552,6 +567,31 @@ struct fd_topo_tile {
       char vinyl_path[ PATH_MAX ];
     } snapwr;
 
+    struct {
+      char  vinyl_path[ PATH_MAX ];
+      int   reset;
+      ulong meta_map_obj_id;
+      ulong meta_pool_obj_id;
+      ulong data_obj_id;
+      ulong line_cnt;
+      ulong val_max;
+
+      int   io_type;        /* FD_VINYL_IO_TYPE_{BD,UR} */
+      uint  io_uring_depth; /* only used if io_type is UR */
+
+      ulong gc_thresh;      /* compaction parameters, see fd_vinyl_compact.h */
+      int   gc_lg_eps;
+      float bw_rate;
+      long  bw_burst;
+      int   cold_style;     /* FD_VINYL_BSTREAM_CTL_STYLE_{RAW,LZ4}, RAW if compaction does not compress cold pairs */
+    } vinyl;
+
+    struct {
+      char  path[ PATH_MAX ];
+      ulong file_sz;
+      ulong fec_max;
+    } ledger;
+
     struct {
 
       uint   bind_address;
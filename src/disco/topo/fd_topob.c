@@ -348,6 +348,8 @@ fd_topob_auto_layout( fd_topo_t * topo,
     "genesi", /* FIREDANCER ONLY */
     "ipecho", /* FIREDANCER ONLY */
     "snapwr", /* FIREDANCER ONLY */
+    "ledger", /* FIREDANCER ONLY */
+    "vinyl",  /* FIREDANCER ONLY */
   };
 
   char const * ORDERED[] = {
@@ -34,6 +34,46 @@ metrics_write( fd_verify_ctx_t * ctx ) {
   FD_MCNT_SET( VERIFY, TRANSACTION_VERIFY_FAILURE,      ctx->metrics.verify_fail_cnt );
 }
 
+/* FLUSH_NS bounds the latency added by batching (see
+   fd_verify_ctx_t::batch_deadline) */
+
+#define FLUSH_NS (20000L)
+
+/* flush verifies the txns of the batch and publishes the ones that
+   passed, in the order they arrived. */
+
+static void
+flush( fd_verify_ctx_t *   ctx,
+       fd_stem_context_t * stem ) {
+  int   res[ FD_VERIFY_BATCH_TXN_MAX ];
+  ulong tag[ FD_VERIFY_BATCH_TXN_MAX ];
+  ulong txn_cnt = fd_txn_verify_batch_fini( ctx, res, tag );
+
+  for( ulong i=0UL; i<txn_cnt; i++ ) {
+    if( FD_UNLIKELY( res[ i ]!=FD_TXN_VERIFY_SUCCESS ) ) {
+      if( FD_LIKELY( res[ i ]==FD_TXN_VERIFY_DEDUP ) ) ctx->metrics.dedup_fail_cnt++;
+      else                                             ctx->metrics.verify_fail_cnt++;
+      continue;
+    }
+
+    if( FD_UNLIKELY( ctx->batch_frag[ i ].is_gossip ) ) ctx->metrics.gossiped_votes_cnt++;
+
+    ulong tspub = (ulong)fd_frag_meta_ts_comp( fd_tickcount() );
+    fd_stem_publish( stem, 0UL, 0UL, ctx->batch_frag[ i ].chunk, ctx->batch_frag[ i ].sz, 0UL, ctx->batch_frag[ i ].tsorig, tspub );
+  }
+}
+
+static inline void
+after_credit( fd_verify_ctx_t *   ctx,
+              fd_stem_context_t * stem,
+              int *               opt_poll_in FD_PARAM_UNUSED,
+              int *               charge_busy ) {
+  if( FD_LIKELY( !ctx->batch->txn_cnt ) ) return;
+  if( FD_LIKELY( fd_tickcount()<ctx->batch_deadline ) ) return;
+  *charge_busy = 1;
+  flush( ctx, stem );
+}
+
 static int
 before_frag( fd_verify_ctx_t * ctx,
              ulong             in_idx,
@@ -135,29 +175,55 @@ after_frag( fd_verify_ctx_t *   ctx,
     return;
   }
 
-  /* Users sometimes send transactions as part of a bundle (with a tip)
-     and via the normal path (without a tip).  Regardless of which
-     arrives first, we want to pack the one with the tip.  Thus, we
-     exempt bundles from the normal HA dedup checks.  The dedup tile
-     will still do a full-bundle dedup check to make sure to drop any
-     identical bundles. */
-  ulong _txn_sig;
-  int res = fd_txn_verify( ctx, fd_txn_m_payload( txnm ), txnm->payload_sz, txnt, !is_bundle, &_txn_sig );
-  if( FD_UNLIKELY( res!=FD_TXN_VERIFY_SUCCESS ) ) {
-    if( FD_UNLIKELY( is_bundle ) ) ctx->bundle_failed = 1;
+  ulong realized_sz = fd_txn_m_realized_footprint( txnm, 1, 0 );
 
-    if( FD_LIKELY( res==FD_TXN_VERIFY_DEDUP ) ) ctx->metrics.dedup_fail_cnt++;
-    else                                        ctx->metrics.verify_fail_cnt++;
+  /* Bundles are verified immediately, as the outcome of a bundle txn
+     determines whether the remaining txns of the bundle are verified.
+     Txns of the batch arrived before, so are published first. */
+
+  if( FD_UNLIKELY( is_bundle ) ) {
+    if( FD_UNLIKELY( ctx->batch->txn_cnt ) ) flush( ctx, stem );
+
+    /* Users sometimes send transactions as part of a bundle (with a tip)
+       and via the normal path (without a tip).  Regardless of which
+       arrives first, we want to pack the one with the tip.  Thus, we
+       exempt bundles from the normal HA dedup checks.  The dedup tile
+       will still do a full-bundle dedup check to make sure to drop any
+       identical bundles. */
+    ulong _txn_sig;
+    int res = fd_txn_verify( ctx, fd_txn_m_payload( txnm ), txnm->payload_sz, txnt, 0, &_txn_sig );
+    if( FD_UNLIKELY( res!=FD_TXN_VERIFY_SUCCESS ) ) {
+      ctx->bundle_failed = 1;
+      ctx->metrics.verify_fail_cnt++;
+      return;
+    }
 
+    ulong tspub = (ulong)fd_frag_meta_ts_comp( fd_tickcount() );
+    fd_stem_publish( stem, 0UL, 0UL, ctx->out_chunk, realized_sz, 0UL, tsorig, tspub );
+    ctx->out_chunk = fd_dcache_compact_next( ctx->out_chunk, realized_sz, ctx->out_chunk0, ctx->out_wmark );
     return;
   }
 
-  if( FD_UNLIKELY( ctx->in_kind[ in_idx ]==IN_KIND_GOSSIP ) ) ctx->metrics.gossiped_votes_cnt++;
+  if( FD_UNLIKELY( !fd_txn_verify_batch_avail( ctx, txnt->signature_cnt ) ) ) flush( ctx, stem );
 
-  ulong realized_sz = fd_txn_m_realized_footprint( txnm, 1, 0 );
-  ulong tspub = (ulong)fd_frag_meta_ts_comp( fd_tickcount() );
-  fd_stem_publish( stem, 0UL, 0UL, ctx->out_chunk, realized_sz, 0UL, tsorig, tspub );
+  int res = fd_txn_verify_batch_add( ctx, fd_txn_m_payload( txnm ), txnm->payload_sz, txnt, 1 );
+  if( FD_UNLIKELY( res==FD_TXN_VERIFY_DEDUP ) ) {
+    ctx->metrics.dedup_fail_cnt++;
+    return;
+  }
+
+  /* The txn stays in the out dcache until the batch is verified.  The
+     out link burst accounts for the unpublished frags. */
+
+  ulong batch_idx = ctx->batch->txn_cnt-1UL;
+  ctx->batch_frag[ batch_idx ].chunk     = ctx->out_chunk;
+  ctx->batch_frag[ batch_idx ].sz        = realized_sz;
+  ctx->batch_frag[ batch_idx ].tsorig    = tsorig;
+  ctx->batch_frag[ batch_idx ].is_gossip = ctx->in_kind[ in_idx ]==IN_KIND_GOSSIP;
   ctx->out_chunk = fd_dcache_compact_next( ctx->out_chunk, realized_sz, ctx->out_chunk0, ctx->out_wmark );
+
+  if( FD_UNLIKELY( !batch_idx ) ) ctx->batch_deadline = fd_tickcount() + ctx->batch_flush_ticks;
+  if( FD_UNLIKELY( batch_idx+1UL==FD_VERIFY_BATCH_TXN_MAX ) ) flush( ctx, stem );
 }
 
 static void
@@ -192,6 +258,10 @@ unprivileged_init( fd_topo_t *      topo,
   ctx->bundle_failed = 0;
   ctx->bundle_id     = 0UL;
 
+  fd_txn_verify_batch_init( ctx );
+  ctx->batch_deadline    = LONG_MAX;
+  ctx->batch_flush_ticks = (long)( fd_tempo_tick_per_ns( NULL ) * (double)FLUSH_NS );
+
   memset( &ctx->metrics, 0, sizeof( ctx->metrics ) );
 
   ctx->tcache_depth   = fd_tcache_depth       ( tcache );
@@ -254,12 +324,16 @@ populate_allowed_fds( fd_topo_t const *      topo,
   return out_cnt;
 }
 
-#define STEM_BURST (1UL)
+/* Publishing the txns of a batch is done in the same callback as
+   adding the txn that filled the batch or a bundle txn */
+
+#define STEM_BURST (FD_VERIFY_BATCH_TXN_MAX)
 
 #define STEM_CALLBACK_CONTEXT_TYPE  fd_verify_ctx_t
 #define STEM_CALLBACK_CONTEXT_ALIGN alignof(fd_verify_ctx_t)
 
 #define STEM_CALLBACK_METRICS_WRITE metrics_write
+#define STEM_CALLBACK_AFTER_CREDIT  after_credit
 #define STEM_CALLBACK_BEFORE_FRAG   before_frag
 #define STEM_CALLBACK_DURING_FRAG   during_frag
 #define STEM_CALLBACK_AFTER_FRAG    after_frag
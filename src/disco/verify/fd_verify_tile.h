@@ -11,6 +11,17 @@
 #define FD_TXN_VERIFY_FAILED  -1
 #define FD_TXN_VERIFY_DEDUP   -2
 
+/* Transactions are verified in batches that span multiple incoming
+   frags (see fd_txn_verify_batch_add).  FD_VERIFY_BATCH_TXN_MAX and
+   FD_VERIFY_BATCH_SIG_MAX bound the number of transactions and
+   signatures in a batch. */
+
+#define FD_VERIFY_BATCH_TXN_MAX (16UL)
+#define FD_VERIFY_BATCH_SIG_MAX (16UL)
+
+FD_STATIC_ASSERT( FD_TXN_ACTUAL_SIG_MAX  <=FD_VERIFY_BATCH_SIG_MAX,     verify_batch );
+FD_STATIC_ASSERT( FD_VERIFY_BATCH_SIG_MAX<=FD_ED25519_VERIFY_BATCH_MAX, verify_batch );
+
 extern fd_topo_run_tile_t fd_tile_verify;
 
 /* fd_verify_in_ctx_t is a context object for each in (producer) mcache
@@ -22,10 +33,50 @@ typedef struct {
   ulong       wmark;
 } fd_verify_in_ctx_t;
 
+/* fd_verify_batch_t holds the transactions accumulated for batched
+   verification. */
+
+typedef struct {
+  ulong txn_cnt;
+  ulong sig_cnt;
+
+  struct {
+    ulong tag;     /* HA dedup tag */
+    int   dedup;   /* Insert into the HA dedup tcache on success? */
+    uint  sig_idx; /* Signatures of the txn are [sig_idx,sig_idx+sig_cnt) */
+    uint  sig_cnt;
+  } txn[ FD_VERIFY_BATCH_TXN_MAX ];
+
+  uchar const * msg   [ FD_VERIFY_BATCH_SIG_MAX ];
+  ulong         msg_sz[ FD_VERIFY_BATCH_SIG_MAX ];
+  uchar const * sig   [ FD_VERIFY_BATCH_SIG_MAX ];
+  uchar const * pubkey[ FD_VERIFY_BATCH_SIG_MAX ];
+  uchar *       hram  [ FD_VERIFY_BATCH_SIG_MAX ];
+  int           err   [ FD_VERIFY_BATCH_SIG_MAX ];
+
+  uchar hram_mem[ FD_VERIFY_BATCH_SIG_MAX ][ 64UL+FD_TPU_MTU ];
+} fd_verify_batch_t;
+
 typedef struct {
-  /* TODO switch to fd_sha512_batch_t? */
+  /* Only used by the single txn bundle path, the batched path hashes
+     with fd_sha512_batch. */
   fd_sha512_t * sha[ FD_TXN_ACTUAL_SIG_MAX ];
 
+  fd_verify_batch_t batch[1];
+
+  /* Frags of the txns in the batch.  They are written to the out dcache
+     as they arrive and published once the batch is verified, at the
+     latest batch_flush_ticks after the first txn of the batch arrived
+     (batch_deadline). */
+  struct {
+    ulong chunk;
+    ulong sz;
+    ulong tsorig;
+    int   is_gossip;
+  } batch_frag[ FD_VERIFY_BATCH_TXN_MAX ];
+  long batch_deadline;
+  long batch_flush_ticks;
+
   int   bundle_failed;
   ulong bundle_id;
 
@@ -108,4 +159,143 @@ fd_txn_verify( fd_verify_ctx_t * ctx,
   return FD_TXN_VERIFY_SUCCESS;
 }
 
+/* fd_txn_verify_batch_{init,avail,add,fini} verify transactions in
+   batches.  Verifying a batch of transactions gives the same results as
+   calling fd_txn_verify on each transaction in the order they were
+   added, but the SHA-512 computations of all the signatures of the
+   batch are done in parallel (see fd_ed25519_verify_batch_multi_msg).
+   Transactions parsed from payloads of at most FD_TPU_MTU bytes have at
+   most FD_TXN_ACTUAL_SIG_MAX signatures, so always fit in an empty
+   batch.
+
+   fd_txn_verify_batch_init empties the batch.
+
+   fd_txn_verify_batch_avail returns 1 if a transaction with sig_cnt
+   signatures can be added to the batch and 0 otherwise.
+
+   fd_txn_verify_batch_add adds a transaction to the batch (see
+   fd_txn_verify for arguments).  Returns FD_TXN_VERIFY_DEDUP if dedup
+   is set and the transaction was already verified (the transaction is
+   not added to the batch) and FD_TXN_VERIFY_SUCCESS otherwise.  The
+   caller promises there is room in the batch for the transaction.  The
+   batch retains a read interest in udp_payload until it is finished.
+
+   fd_txn_verify_batch_fini verifies the transactions of the batch and
+   empties it.  On return, res[i] and opt_sig[i] hold what fd_txn_verify
+   would have returned for the i-th transaction of the batch.  Returns
+   the number of transactions in the batch. */
+
+static inline void
+fd_txn_verify_batch_init( fd_verify_ctx_t * ctx ) {
+  fd_verify_batch_t * batch = ctx->batch;
+  batch->txn_cnt = 0UL;
+  batch->sig_cnt = 0UL;
+  for( ulong i=0UL; i<FD_VERIFY_BATCH_SIG_MAX; i++ ) batch->hram[ i ] = batch->hram_mem[ i ];
+}
+
+FD_FN_PURE static inline int
+fd_txn_verify_batch_avail( fd_verify_ctx_t const * ctx,
+                           ulong                   sig_cnt ) {
+  fd_verify_batch_t const * batch = ctx->batch;
+  return (batch->txn_cnt<FD_VERIFY_BATCH_TXN_MAX) & (batch->sig_cnt+sig_cnt<=FD_VERIFY_BATCH_SIG_MAX);
+}
+
+static inline int
+fd_txn_verify_batch_add( fd_verify_ctx_t * ctx,
+                         uchar const *     udp_payload,
+                         ushort const      payload_sz,
+                         fd_txn_t const *  txn,
+                         int               dedup ) {
+  fd_verify_batch_t * batch = ctx->batch;
+
+  uchar  signature_cnt = txn->signature_cnt;
+  ushort signature_off = txn->signature_off;
+  ushort acct_addr_off = txn->acct_addr_off;
+  ushort message_off   = txn->message_off;
+
+  uchar const * signatures = udp_payload + signature_off;
+  uchar const * pubkeys = udp_payload + acct_addr_off;
+  uchar const * msg = udp_payload + message_off;
+  ulong msg_sz = (ulong)payload_sz - message_off;
+
+  /* See fd_txn_verify */
+
+  ulong ha_dedup_tag = fd_hash( ctx->hashmap_seed, signatures, 64UL );
+  if( FD_LIKELY( dedup ) ) {
+    int ha_dup;
+    FD_FN_UNUSED ulong tcache_map_idx = 0; /* ignored */
+    FD_TCACHE_QUERY( ha_dup, tcache_map_idx, ctx->tcache_map, ctx->tcache_map_cnt, ha_dedup_tag );
+    if( FD_UNLIKELY( ha_dup ) ) {
+      return FD_TXN_VERIFY_DEDUP;
+    }
+  }
+
+  ulong txn_idx = batch->txn_cnt;
+  ulong sig_idx = batch->sig_cnt;
+  batch->txn[ txn_idx ].tag     = ha_dedup_tag;
+  batch->txn[ txn_idx ].dedup   = dedup;
+  batch->txn[ txn_idx ].sig_idx = (uint)sig_idx;
+  batch->txn[ txn_idx ].sig_cnt = signature_cnt;
+  for( ulong j=0UL; j<signature_cnt; j++ ) {
+    batch->msg   [ sig_idx+j ] = msg;
+    batch->msg_sz[ sig_idx+j ] = msg_sz;
+    batch->sig   [ sig_idx+j ] = signatures + 64UL*j;
+    batch->pubkey[ sig_idx+j ] = pubkeys    + 32UL*j;
+  }
+  batch->txn_cnt = txn_idx+1UL;
+  batch->sig_cnt = sig_idx+signature_cnt;
+  return FD_TXN_VERIFY_SUCCESS;
+}
+
+static inline ulong
+fd_txn_verify_batch_fini( fd_verify_ctx_t * ctx,
+                          int *             res,
+                          ulong *           opt_sig ) {
+  fd_verify_batch_t * batch = ctx->batch;
+
+  fd_ed25519_verify_batch_multi_msg( batch->msg, batch->msg_sz, batch->sig, batch->pubkey, batch->hram, batch->err, batch->sig_cnt );
+
+  ulong txn_cnt = batch->txn_cnt;
+  for( ulong i=0UL; i<txn_cnt; i++ ) {
+    ulong ha_dedup_tag = batch->txn[ i ].tag;
+    int   dedup        = batch->txn[ i ].dedup;
+
+    /* Repeat the dedup check, as txns verified earlier in the batch
+       were not in the tcache when the txn was added */
+    if( FD_LIKELY( dedup ) ) {
+      int ha_dup;
+      FD_FN_UNUSED ulong tcache_map_idx = 0; /* ignored */
+      FD_TCACHE_QUERY( ha_dup, tcache_map_idx, ctx->tcache_map, ctx->tcache_map_cnt, ha_dedup_tag );
+      if( FD_UNLIKELY( ha_dup ) ) {
+        res[ i ] = FD_TXN_VERIFY_DEDUP;
+        continue;
+      }
+    }
+
+    int err = 0;
+    for( ulong j=0UL; j<batch->txn[ i ].sig_cnt; j++ ) err |= batch->err[ batch->txn[ i ].sig_idx+j ];
+    if( FD_UNLIKELY( err ) ) {
+      res[ i ] = FD_TXN_VERIFY_FAILED;
+      continue;
+    }
+
+    /* Insert into the tcache to dedup ha traffic */
+    if( FD_LIKELY( dedup ) ) {
+      int ha_dup;
+      FD_TCACHE_INSERT( ha_dup, *ctx->tcache_sync, ctx->tcache_ring, ctx->tcache_depth, ctx->tcache_map, ctx->tcache_map_cnt, ha_dedup_tag );
+      if( FD_UNLIKELY( ha_dup ) ) {
+        res[ i ] = FD_TXN_VERIFY_DEDUP;
+        continue;
+      }
+    }
+
+    res    [ i ] = FD_TXN_VERIFY_SUCCESS;
+    opt_sig[ i ] = ha_dedup_tag;
+  }
+
+  batch->txn_cnt = 0UL;
+  batch->sig_cnt = 0UL;
+  return txn_cnt;
+}
+
 #endif /* HEADER_fd_src_disco_verify_fd_verify_tile_h */
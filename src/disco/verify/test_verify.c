@@ -143,6 +143,8 @@ setup_verify_ctx( fd_verify_ctx_t * ctx, void ** mem ) {
   ctx->tcache_map     = fd_tcache_map_laddr   ( tcache );
   fd_tcache_reset( ctx->tcache_ring, ctx->tcache_depth, ctx->tcache_map, ctx->tcache_map_cnt );
 
+  fd_txn_verify_batch_init( ctx );
+
   /* ctx->sha */
   uchar * _sha = aligned_alloc( FD_SHA512_ALIGN, sizeof(fd_sha512_t)*FD_TXN_ACTUAL_SIG_MAX );
   for ( ulong i=0; i<FD_TXN_ACTUAL_SIG_MAX; i++ ) {
@@ -346,6 +348,81 @@ test_verify_invalid_dedup_with_collision_success( void ) {
   free_verify_ctx( ctx, mem );
 }
 
+static void
+test_verify_batch_success( void ) {
+  fd_verify_ctx_t ctx[1];
+  void *          mem = NULL;
+  uchar           out_buf[4][FD_TXN_MAX_SZ];
+  uchar *         payload[4];
+  ulong           payload_sz[4];
+  int             res[FD_VERIFY_BATCH_TXN_MAX];
+  ulong           opt_sig[FD_VERIFY_BATCH_TXN_MAX];
+  ulong           exp_sig = 0;
+
+  FD_LOG_NOTICE(( "test_verify_batch_success" ));
+  setup_verify_ctx( ctx, &mem );
+
+  payload[0] = load_test_txn( valid_txn_2sigs,       sizeof(valid_txn_2sigs),       &payload_sz[0] );
+  payload[1] = load_test_txn( invalid_txn_same_1sig, sizeof(invalid_txn_same_1sig), &payload_sz[1] );
+  payload[2] = load_test_txn( valid_txn_1sig,        sizeof(valid_txn_1sig),        &payload_sz[2] );
+  payload[3] = load_test_txn( invalid_txn_2sigs,     sizeof(invalid_txn_2sigs),     &payload_sz[3] );
+  fd_txn_t * txn[4];
+  for( ulong i=0UL; i<4UL; i++ ) {
+    FD_TEST( fd_txn_parse( payload[i], payload_sz[i], out_buf[i], NULL ) );
+    txn[i] = (fd_txn_t *)out_buf[i];
+  }
+
+  /* Results match fd_txn_verify on the same sequence of txns,
+     including dups within the batch (invalid txns 1 and 3 have the same
+     first signature as valid txns 2 and 0) */
+  static ulong const seq[6] = { 0UL, 1UL, 2UL, 0UL, 3UL, 1UL };
+  static int   const exp[6] = { FD_TXN_VERIFY_SUCCESS, FD_TXN_VERIFY_FAILED, FD_TXN_VERIFY_SUCCESS,
+                                FD_TXN_VERIFY_DEDUP,   FD_TXN_VERIFY_DEDUP,  FD_TXN_VERIFY_DEDUP };
+  for( ulong i=0UL; i<6UL; i++ ) {
+    FD_TEST( fd_txn_verify_batch_avail( ctx, txn[ seq[i] ]->signature_cnt ) );
+    FD_TEST( fd_txn_verify_batch_add( ctx, payload[ seq[i] ], (ushort)payload_sz[ seq[i] ], txn[ seq[i] ], 1 )==FD_TXN_VERIFY_SUCCESS );
+  }
+  FD_TEST( fd_txn_verify_batch_fini( ctx, res, opt_sig )==6UL );
+  for( ulong i=0UL; i<6UL; i++ ) FD_TEST( res[i]==exp[i] );
+
+  fd_tcache_reset( ctx->tcache_ring, ctx->tcache_depth, ctx->tcache_map, ctx->tcache_map_cnt );
+  for( ulong i=0UL; i<6UL; i++ ) {
+    ulong sig = 0UL;
+    FD_TEST( fd_txn_verify( ctx, payload[ seq[i] ], (ushort)payload_sz[ seq[i] ], txn[ seq[i] ], 1, &sig )==exp[i] );
+    if( exp[i]==FD_TXN_VERIFY_SUCCESS ) FD_TEST( sig==opt_sig[i] );
+    if( i==2UL ) exp_sig = sig;
+  }
+
+  /* Verified txns are deduped when added */
+  FD_TEST( fd_txn_verify_batch_add( ctx, payload[2], (ushort)payload_sz[2], txn[2], 1 )==FD_TXN_VERIFY_DEDUP );
+  FD_TEST( fd_txn_verify_batch_fini( ctx, res, opt_sig )==0UL );
+
+  /* ... unless dedup is disabled */
+  FD_TEST( fd_txn_verify_batch_add( ctx, payload[2], (ushort)payload_sz[2], txn[2], 0 )==FD_TXN_VERIFY_SUCCESS );
+  FD_TEST( fd_txn_verify_batch_fini( ctx, res, opt_sig )==1UL );
+  FD_TEST( res[0]==FD_TXN_VERIFY_SUCCESS && opt_sig[0]==exp_sig );
+
+  /* Batch limits */
+  for( ulong i=0UL; i<FD_VERIFY_BATCH_TXN_MAX; i++ ) {
+    FD_TEST( fd_txn_verify_batch_avail( ctx, 1UL ) );
+    FD_TEST( fd_txn_verify_batch_add( ctx, payload[2], (ushort)payload_sz[2], txn[2], 0 )==FD_TXN_VERIFY_SUCCESS );
+  }
+  FD_TEST( !fd_txn_verify_batch_avail( ctx, 1UL ) );
+  FD_TEST( fd_txn_verify_batch_fini( ctx, res, opt_sig )==FD_VERIFY_BATCH_TXN_MAX );
+  for( ulong i=0UL; i<FD_VERIFY_BATCH_TXN_MAX; i++ ) FD_TEST( res[i]==FD_TXN_VERIFY_SUCCESS );
+
+  for( ulong i=0UL; i<FD_VERIFY_BATCH_SIG_MAX/2UL; i++ ) {
+    FD_TEST( fd_txn_verify_batch_avail( ctx, 2UL ) );
+    FD_TEST( fd_txn_verify_batch_add( ctx, payload[0], (ushort)payload_sz[0], txn[0], 0 )==FD_TXN_VERIFY_SUCCESS );
+  }
+  FD_TEST( !fd_txn_verify_batch_avail( ctx, 1UL ) );
+  FD_TEST( fd_txn_verify_batch_fini( ctx, res, opt_sig )==FD_VERIFY_BATCH_SIG_MAX/2UL );
+  FD_TEST( fd_txn_verify_batch_avail( ctx, FD_TXN_ACTUAL_SIG_MAX ) );
+
+  for( ulong i=0UL; i<4UL; i++ ) free( payload[i] );
+  free_verify_ctx( ctx, mem );
+}
+
 int
 main( int     argc,
       char ** argv ) {
@@ -355,6 +432,7 @@ main( int     argc,
   test_verify_invalid_sigs_success();
   test_verify_invalid_dedup_success();
   test_verify_invalid_dedup_with_collision_success();
+  test_verify_batch_success();
 
   FD_LOG_NOTICE(( "pass" ));
   fd_halt();
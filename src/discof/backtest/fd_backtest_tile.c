@@ -167,18 +167,16 @@ after_credit( fd_backt_tile_t *   ctx,
      set index. This is done in order to preserve behavior for older
      ledgers which may not have merkle roots or chained merkle roots. */
   fd_hash_t mr = { .ul[0] = shred->slot, .ul[1] = shred->fec_set_idx };
+  fd_store_shacq( ctx->store, 0UL );
   if( FD_UNLIKELY( ctx->prev_slot==ULONG_MAX || shred->slot!=ctx->prev_slot || shred->fec_set_idx!=ctx->prev_fec_set_idx ) ) {
-    fd_store_shacq ( ctx->store );
-    fd_store_insert( ctx->store, 0, &mr );
-    fd_store_shrel ( ctx->store );
+    fd_store_insert( ctx->store, 0UL, &mr );
   }
 
   fd_store_fec_t * fec = fd_store_query( ctx->store, &mr );
   FD_TEST( fec );
-  fd_store_exacq( ctx->store ); /* FIXME shacq after store changes */
   fd_memcpy( fec->data+fec->data_sz, fd_shred_data_payload( shred ), fd_shred_payload_sz( shred ) );
   fec->data_sz += fd_shred_payload_sz( shred );
-  fd_store_exrel( ctx->store ); /* FIXME */
+  fd_store_shrel( ctx->store, 0UL );
 
   ctx->shreds_idx = (ctx->shreds_idx+1UL)%SHRED_BUFFER_LEN;
   ctx->shreds_cnt--;
@@ -530,6 +530,7 @@ unprivileged_init( fd_topo_t *      topo,
   *(ctx->txn_ctx->_progcache)    = *progcache;
   ctx->txn_ctx->progcache        = ctx->txn_ctx->_progcache;
   ctx->txn_ctx->bundle.is_bundle = 0;
+  ctx->txn_ctx->lthash_part_idx  = ctx->kind_id;
 
   void * _txncache_shmem = fd_topo_obj_laddr( topo, tile->bank.txncache_obj_id );
   fd_txncache_shmem_t * txncache_shmem = fd_txncache_shmem_join( _txncache_shmem );
@@ -548,6 +549,7 @@ unprivileged_init( fd_topo_t *      topo,
     ctx->txn_ctx_bundle[ i ].bank_hash_cmp    = NULL; /* TODO - do we need this? */
     ctx->txn_ctx_bundle[ i ].progcache        = ctx->txn_ctx_bundle[ i ]._progcache;
     ctx->txn_ctx_bundle[ i ].status_cache     = txncache;
+    ctx->txn_ctx_bundle[ i ].lthash_part_idx  = ctx->kind_id;
     *(ctx->txn_ctx_bundle[ i ].funk)          = *funk;
     *(ctx->txn_ctx_bundle[ i ]._progcache)    = *progcache;
   }
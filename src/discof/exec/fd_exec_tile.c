@@ -7,6 +7,7 @@
 #include "../../flamenco/runtime/fd_bank.h"
 #include "../../flamenco/runtime/fd_exec_stack.h"
 #include "../../flamenco/runtime/fd_runtime.h"
+#include "../../flamenco/vm/jit/fd_vm_jit_cache.h"
 #include "../../disco/metrics/fd_metrics.h"
 
 #include "../../funk/fd_funk.h"
@@ -70,6 +71,14 @@ typedef struct fd_exec_tile_ctx {
 
   fd_exec_stack_t       exec_stack;
 
+# if FD_HAS_X86
+  /* Cache of programs compiled to native code (NULL if disabled).  The
+     code arena is mapped during privileged init. */
+  fd_vm_jit_cache_t *   jit_cache;
+  uchar *               jit_code_rw;
+  uchar *               jit_code_rx;
+# endif
+
   /* This buffer is used for staging memory to dump instructions and
      transactions into protobuf files.
      TODO: This should not be compiled in prod. */
@@ -81,6 +90,21 @@ scratch_align( void ) {
   return 128UL;
 }
 
+/* JIT_CACHE_ENT_MAX is the number of compiled program lookup table
+   entries of an exec tile. */
+
+#define JIT_CACHE_ENT_MAX (4096UL)
+
+FD_FN_PURE static inline ulong
+jit_cache_footprint( fd_topo_tile_t const * tile ) {
+# if FD_HAS_X86
+  if( tile->exec.jit_code_max ) return fd_vm_jit_cache_footprint( JIT_CACHE_ENT_MAX );
+# else
+  (void)tile;
+# endif
+  return 0UL;
+}
+
 FD_FN_PURE static inline ulong
 scratch_footprint( fd_topo_tile_t const * tile ) {
   ulong l = FD_LAYOUT_INIT;
@@ -88,6 +112,7 @@ scratch_footprint( fd_topo_tile_t const * tile ) {
   l = FD_LAYOUT_APPEND( l, fd_capture_ctx_align(),      fd_capture_ctx_footprint()                         );
   l = FD_LAYOUT_APPEND( l, fd_txncache_align(),         fd_txncache_footprint( tile->exec.max_live_slots ) );
   l = FD_LAYOUT_APPEND( l, FD_PROGCACHE_SCRATCH_ALIGN,  FD_PROGCACHE_SCRATCH_FOOTPRINT                     );
+  l = FD_LAYOUT_APPEND( l, 128UL,                       jit_cache_footprint( tile )                        );
   return FD_LAYOUT_FINI( l, scratch_align() );
 }
 
@@ -166,6 +191,18 @@ returnable_frag( fd_exec_tile_ctx_t * ctx,
         ctx->exec_replay_out->chunk = fd_dcache_compact_next( ctx->exec_replay_out->chunk, sizeof(*out_msg), ctx->exec_replay_out->chunk0, ctx->exec_replay_out->wmark );
         break;
       }
+      case FD_EXEC_TT_POH_VERIFY: {
+        fd_exec_poh_verify_msg_t * msg = fd_chunk_to_laddr( ctx->replay_in->mem, chunk );
+        if( FD_UNLIKELY( !msg->entry_cnt || msg->entry_cnt>FD_EXEC_POH_VERIFY_ENTRY_MAX ) ) FD_LOG_CRIT(( "invalid entry_cnt %lu", msg->entry_cnt ));
+        ulong bad_idx = fd_poh_verify_entries( msg->start, msg->entry, msg->entry_cnt );
+        fd_exec_task_done_msg_t * out_msg = fd_chunk_to_laddr( ctx->exec_replay_out->mem, ctx->exec_replay_out->chunk );
+        out_msg->bank_idx              = msg->bank_idx;
+        out_msg->poh_verify->entry_idx = msg->entry_idx;
+        out_msg->poh_verify->bad_idx   = fd_ulong_if( bad_idx<msg->entry_cnt, msg->entry_idx+bad_idx, ULONG_MAX );
+        fd_stem_publish( stem, ctx->exec_replay_out->idx, (FD_EXEC_TT_POH_VERIFY<<32)|ctx->tile_idx, ctx->exec_replay_out->chunk, sizeof(*out_msg), 0UL, 0UL, 0UL );
+        ctx->exec_replay_out->chunk = fd_dcache_compact_next( ctx->exec_replay_out->chunk, sizeof(*out_msg), ctx->exec_replay_out->chunk0, ctx->exec_replay_out->wmark );
+        break;
+      }
       default: FD_LOG_CRIT(( "unexpected signature %lu", sig ));
     }
   } else FD_LOG_CRIT(( "invalid in_idx %lu", in_idx ));
@@ -173,6 +210,33 @@ returnable_frag( fd_exec_tile_ctx_t * ctx,
   return 0;
 }
 
+static void
+privileged_init( fd_topo_t *      topo,
+                 fd_topo_tile_t * tile ) {
+  void * scratch = fd_topo_obj_laddr( topo, tile->tile_obj_id );
+
+  FD_SCRATCH_ALLOC_INIT( l, scratch );
+  fd_exec_tile_ctx_t * ctx = FD_SCRATCH_ALLOC_APPEND( l, alignof(fd_exec_tile_ctx_t), sizeof(fd_exec_tile_ctx_t) );
+
+# if FD_HAS_X86
+  ctx->jit_code_rw = NULL;
+  ctx->jit_code_rx = NULL;
+  if( tile->exec.jit_code_max ) {
+    /* The arena is mapped twice (writable and executable), which
+       requires syscalls unavailable in the sandbox. */
+    if( FD_UNLIKELY( fd_vm_jit_cache_code_map( tile->exec.jit_code_max, &ctx->jit_code_rw, &ctx->jit_code_rx ) ) ) {
+      FD_LOG_ERR(( "failed to map %lu MiB JIT code arena (consider setting [runtime.program_cache.jit_code_size_mib] to 0)",
+                   tile->exec.jit_code_max>>20 ));
+    }
+  }
+# else
+  (void)ctx;
+  if( FD_UNLIKELY( tile->exec.jit_code_max ) ) {
+    FD_LOG_WARNING(( "[runtime.program_cache.jit_code_size_mib] is only supported on x86-64, using the interpreter" ));
+  }
+# endif
+}
+
 static void
 unprivileged_init( fd_topo_t *      topo,
                    fd_topo_tile_t * tile ) {
@@ -188,6 +252,7 @@ unprivileged_init( fd_topo_t *      topo,
   void * capture_ctx_mem   = FD_SCRATCH_ALLOC_APPEND( l, fd_capture_ctx_align(),      fd_capture_ctx_footprint() );
   void * _txncache         = FD_SCRATCH_ALLOC_APPEND( l, fd_txncache_align(),         fd_txncache_footprint( tile->exec.max_live_slots ) );
   uchar * pc_scratch       = FD_SCRATCH_ALLOC_APPEND( l, FD_PROGCACHE_SCRATCH_ALIGN,  FD_PROGCACHE_SCRATCH_FOOTPRINT );
+  void * _jit_cache        = FD_SCRATCH_ALLOC_APPEND( l, 128UL,                       jit_cache_footprint( tile ) );
   ulong  scratch_alloc_mem = FD_SCRATCH_ALLOC_FINI( l, scratch_align() );
 
   if( FD_UNLIKELY( scratch_alloc_mem - (ulong)scratch  - scratch_footprint( tile ) ) ) {
@@ -293,9 +358,21 @@ unprivileged_init( fd_topo_t *      topo,
   if( FD_UNLIKELY( !ctx->txn_ctx->progcache ) ) {
     FD_LOG_CRIT(( "fd_progcache_join() failed" ));
   }
+
+# if FD_HAS_X86
+  ctx->jit_cache = NULL;
+  if( tile->exec.jit_code_max ) {
+    ctx->jit_cache = fd_vm_jit_cache_join( fd_vm_jit_cache_new( _jit_cache, JIT_CACHE_ENT_MAX, ctx->jit_code_rw, ctx->jit_code_rx, tile->exec.jit_code_max ) );
+    FD_TEST( ctx->jit_cache );
+  }
+  ctx->txn_ctx->progcache->jit = ctx->jit_cache;
+# else
+  (void)_jit_cache;
+# endif
   ctx->txn_ctx->status_cache     = ctx->txncache;
   ctx->txn_ctx->bank_hash_cmp    = ctx->bank_hash_cmp;
   ctx->txn_ctx->bundle.is_bundle = 0;
+  ctx->txn_ctx->lthash_part_idx  = ctx->tile_idx;
 
   /********************************************************************/
   /* Capture context                                                 */
@@ -380,6 +457,7 @@ publish_txn_finalized_msg( fd_exec_tile_ctx_t * ctx,
   msg->bank_idx          = ctx->txn_ctx->bank_idx;
   msg->txn_exec->txn_idx = ctx->txn_idx;
   msg->txn_exec->err     = !(ctx->txn_ctx->flags&FD_TXN_P_FLAGS_EXECUTE_SUCCESS);
+  msg->txn_exec->cus     = ctx->txn_ctx->compute_budget_details.compute_unit_limit - ctx->txn_ctx->compute_budget_details.compute_meter;
   if( FD_UNLIKELY( msg->txn_exec->err ) ) {
     FD_LOG_WARNING(( "txn failed to execute, bad block detected err=%d", ctx->txn_ctx->exec_err ));
   }
@@ -456,6 +534,7 @@ fd_topo_run_tile_t fd_tile_execor = {
   .populate_allowed_fds     = populate_allowed_fds,
   .scratch_align            = scratch_align,
   .scratch_footprint        = scratch_footprint,
+  .privileged_init          = privileged_init,
   .unprivileged_init        = unprivileged_init,
   .run                      = stem_run,
 };
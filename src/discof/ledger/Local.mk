@@ -0,0 +1,4 @@
+ifdef FD_HAS_INT128
+$(call add-hdrs,fd_ledger_tile.h)
+$(call add-objs,fd_ledger_tile,fd_discof)
+endif
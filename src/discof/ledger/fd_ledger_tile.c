@@ -0,0 +1,454 @@
+/* The ledger tile persists rooted FEC sets from the store to the store
+   ledger (see fd_store_ledger.h) and reads them back on restart.
+
+   SPILLING
+
+   When Replay advances its published root, it sends the new store root
+   (a block id) on replay_ledgr instead of publishing the store right
+   away.  The ledger tile appends the FEC sets that become rooted with
+   blocking O_DIRECT writes and then echoes the store root back on
+   ledger_out with FD_LEDGER_SIG_SPILLED, at which point Replay
+   publishes the store.  Replay keeps at most one spill in flight and
+   coalesces roots that advance meanwhile, so disk latency only delays
+   pruning the store, never replay itself.  The ledger tile does not
+   modify the store tree while spilling, and nothing on the path it
+   walks can be pruned before Replay receives the acknowledgement.
+
+   RESTART
+
+   After Replay boots from a snapshot (or genesis) at slot S, the ledger
+   can already hold rooted slots after S from a previous run.  The
+   ledger tile feeds them to Replay as if they had been received from
+   the network: each FEC set is inserted into the store in the tile's
+   own writer partition and a FEC complete message (same format as
+   shred_out) is published on ledger_out with
+   FD_LEDGER_SIG_FEC_COMPLETE.  Only the chain of slots descending from
+   S is fed (a slot is fed iff its parent is the previously fed slot),
+   at most LOOKAHEAD_MAX slots ahead of the slots Replay has completed.
+   Feeding stops at the first gap in the chain, at the end of the
+   ledger, or once the network catches up.  The Shred tiles can insert
+   the same FEC sets concurrently, the store drops whichever insert
+   comes second.
+
+   Like snapwr, the tile mostly waits on disk I/O, so it runs floating
+   and sleeps when idle. */
+
+#define _GNU_SOURCE /* O_DIRECT */
+#include "fd_ledger_tile.h"
+#include "../replay/fd_replay_tile.h"
+#include "../../disco/topo/fd_topo.h"
+#include "../../disco/store/fd_store_ledger.h"
+#include "../../flamenco/fd_flamenco_base.h"
+#include "../../util/pod/fd_pod.h"
+#include "generated/fd_ledger_tile_seccomp.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#define NAME "ledger"
+
+#define IN_KIND_SPILL  (0)
+#define IN_KIND_REPLAY (1)
+
+/* SLOT_MAX is the number of slots in the ledger index.  LOOKAHEAD_MAX
+   bounds how many slots the restart feed runs ahead of Replay. */
+
+#define SLOT_MAX      (65536UL)
+#define LOOKAHEAD_MAX (32UL)
+
+struct fd_ledger_in {
+  fd_wksp_t * mem;
+  ulong       chunk0;
+  ulong       wmark;
+  ulong       mtu;
+};
+
+typedef struct fd_ledger_in fd_ledger_in_t;
+
+struct fd_ledger_out {
+  fd_wksp_t * mem;
+  ulong       chunk0;
+  ulong       wmark;
+  ulong       chunk;
+};
+
+typedef struct fd_ledger_out fd_ledger_out_t;
+
+struct fd_ledger_tile {
+  int                 fd;
+  fd_store_ledger_t * ledger;
+  fd_store_t *        store;
+  ulong               part_idx; /* store writer partition of this tile */
+  ulong *             path;     /* fec_max pool idxs, scratch for fd_store_ledger_spill */
+
+  /* Frag contents copied in during_frag */
+
+  fd_hash_t spill_root;
+  ulong     completed_slot;
+
+  /* Restart feed */
+
+  ulong                         boot_slot;   /* ULONG_MAX until Replay booted */
+  ulong                         replay_slot; /* highest slot completed by Replay */
+  ulong                         feed_prev;   /* last slot fed, or boot_slot */
+  ulong                         feed_slot;   /* next slot to feed */
+  fd_store_ledger_rec_t const * feed_rec;    /* next record of feed_slot to feed, NULL if feed_slot was not started */
+  ulong                         feed_seq;    /* sequence number of feed_rec */
+  ulong                         feed_cnt;    /* number of FEC sets fed */
+  int                           feed_done;
+
+  uint idle_cnt;
+
+  int             in_kind[ 2 ];
+  fd_ledger_in_t  in     [ 2 ];
+  fd_ledger_out_t out    [ 1 ];
+};
+
+typedef struct fd_ledger_tile fd_ledger_tile_t;
+
+FD_FN_CONST static inline ulong
+scratch_align( void ) {
+  return fd_ulong_max( alignof(fd_ledger_tile_t), fd_store_ledger_align() );
+}
+
+FD_FN_PURE static inline ulong
+scratch_footprint( fd_topo_tile_t const * tile ) {
+  ulong l = FD_LAYOUT_INIT;
+  l = FD_LAYOUT_APPEND( l, alignof(fd_ledger_tile_t), sizeof(fd_ledger_tile_t)               );
+  l = FD_LAYOUT_APPEND( l, fd_store_ledger_align(),   fd_store_ledger_footprint( SLOT_MAX )  );
+  l = FD_LAYOUT_APPEND( l, alignof(ulong),            sizeof(ulong)*tile->ledger.fec_max     );
+  return FD_LAYOUT_FINI( l, scratch_align() );
+}
+
+static void
+before_credit( fd_ledger_tile_t *  ctx,
+               fd_stem_context_t * stem,
+               int *               charge_busy ) {
+  (void)stem;
+  if( ++ctx->idle_cnt >= 1024U ) {
+    fd_log_sleep( (long)1e6 ); /* 1 millisecond */
+    *charge_busy = 0;
+    ctx->idle_cnt = 0U;
+  }
+}
+
+static void
+during_housekeeping( fd_ledger_tile_t * ctx ) {
+  /* The tile only inserts while feeding on restart, so reclaim the FEC
+     sets it inserted that were since pruned. */
+  fd_store_reclaim( ctx->store, ctx->part_idx );
+}
+
+static void
+feed_stop( fd_ledger_tile_t * ctx,
+           char const *       reason ) {
+  FD_LOG_NOTICE(( "fed %lu FEC sets of slots (%lu,%lu] from the store ledger, stopping at slot %lu (%s)",
+                  ctx->feed_cnt, ctx->boot_slot, ctx->feed_prev, ctx->feed_slot, reason ));
+  ctx->feed_done = 1;
+}
+
+/* feed feeds the next FEC set from the ledger to Replay, or advances
+   the search for the next slot of the chain.  Returns 1 if there was
+   work to do, 0 otherwise. */
+
+static int
+feed( fd_ledger_tile_t *  ctx,
+      fd_stem_context_t * stem ) {
+  fd_store_ledger_t * ledger = ctx->ledger;
+
+  if( FD_LIKELY( !ctx->feed_rec ) ) {
+    if( FD_UNLIKELY( ctx->feed_slot>ledger->last_slot            ) ) { feed_stop( ctx, "end of ledger" );       return 1; }
+    if( FD_UNLIKELY( ctx->replay_slot>=ctx->feed_slot            ) ) { feed_stop( ctx, "caught up by network" ); return 1; }
+    if( FD_UNLIKELY( ctx->feed_slot>ctx->replay_slot+LOOKAHEAD_MAX ) ) return 0;
+
+    fd_store_ledger_rec_t const * rec = fd_store_ledger_query( ledger, ctx->feed_slot );
+    if( FD_LIKELY( !rec ) ) { ctx->feed_slot++; return 1; } /* skipped slot */
+    if( FD_UNLIKELY( rec->fec_set_idx || ctx->feed_slot-rec->parent_off!=ctx->feed_prev ) ) { feed_stop( ctx, "not a child of the previous slot" ); return 1; }
+    ctx->feed_rec = rec;
+    ctx->feed_seq = rec->seq;
+  }
+
+  /* The writer is this tile, so a record can only have been overwritten
+     by a spill that wrapped around since the last call. */
+
+  fd_store_ledger_rec_t const * rec = ctx->feed_rec;
+  if( FD_UNLIKELY( rec->magic!=FD_STORE_LEDGER_REC_MAGIC || rec->seq!=ctx->feed_seq || !rec->data_cnt ) ) { feed_stop( ctx, "record overwritten" ); return 1; }
+
+  fd_hash_t mr = rec->mr;
+  fd_store_shacq( ctx->store, ctx->part_idx );
+  fd_store_fec_t * fec = fd_store_insert( ctx->store, ctx->part_idx, &mr );
+  if( FD_LIKELY( fec ) ) {
+    fd_memcpy( fec->data, fd_store_ledger_rec_data( rec ), rec->data_sz );
+    fec->data_sz = rec->data_sz;
+  }
+  fd_store_shrel( ctx->store, ctx->part_idx );
+
+  /* If the insert failed, the FEC set was already received from the
+     network (or the store is full, in which case repair will fetch it
+     later), either way there is nothing to publish. */
+
+  if( FD_LIKELY( fec ) ) {
+    uchar *      buf   = fd_chunk_to_laddr( ctx->out->mem, ctx->out->chunk );
+    fd_shred_t * shred = (fd_shred_t *)fd_type_pun( buf );
+    fd_memset( buf, 0, FD_SHRED_DATA_HEADER_SZ );
+    shred->variant         = fd_shred_variant( FD_SHRED_TYPE_MERKLE_DATA_CHAINED, 0 );
+    shred->slot            = rec->slot;
+    shred->idx             = rec->fec_set_idx + rec->data_cnt - 1U;
+    shred->fec_set_idx     = rec->fec_set_idx;
+    shred->data.parent_off = rec->parent_off;
+    shred->data.flags      = (uchar)( fd_uint_if( rec->flags & FD_STORE_LEDGER_REC_FLAG_DATA_COMPLETE, FD_SHRED_DATA_FLAG_DATA_COMPLETE, 0U ) |
+                                      fd_uint_if( rec->flags & FD_STORE_LEDGER_REC_FLAG_SLOT_COMPLETE, FD_SHRED_DATA_FLAG_SLOT_COMPLETE, 0U ) );
+    int is_leader = 0;
+    memcpy( buf + FD_SHRED_DATA_HEADER_SZ,                     &rec->mr,   sizeof(fd_hash_t) );
+    memcpy( buf + FD_SHRED_DATA_HEADER_SZ + sizeof(fd_hash_t), &rec->cmr,  sizeof(fd_hash_t) );
+    memcpy( buf + FD_SHRED_DATA_HEADER_SZ + 2*sizeof(fd_hash_t), &is_leader, sizeof(int)     );
+    ulong sz = FD_SHRED_OUT_MTU;
+
+    fd_stem_publish( stem, 0UL, FD_LEDGER_SIG_FEC_COMPLETE, ctx->out->chunk, sz, 0UL, 0UL, fd_frag_meta_ts_comp( fd_tickcount() ) );
+    ctx->out->chunk = fd_dcache_compact_next( ctx->out->chunk, sz, ctx->out->chunk0, ctx->out->wmark );
+    ctx->feed_cnt++;
+  }
+
+  if( FD_LIKELY( rec->flags & FD_STORE_LEDGER_REC_FLAG_SLOT_COMPLETE ) ) {
+    ctx->feed_prev = ctx->feed_slot;
+    ctx->feed_slot++;
+    ctx->feed_rec  = NULL;
+    return 1;
+  }
+
+  ctx->feed_rec = fd_store_ledger_next( ledger, rec );
+  if( FD_UNLIKELY( !ctx->feed_rec ) ) { feed_stop( ctx, "slot is incomplete" ); return 1; }
+  ctx->feed_seq = ctx->feed_rec->seq;
+  return 1;
+}
+
+static void
+after_credit( fd_ledger_tile_t *  ctx,
+              fd_stem_context_t * stem,
+              int *               opt_poll_in,
+              int *               charge_busy ) {
+  (void)opt_poll_in;
+  if( FD_LIKELY( ctx->feed_done || ctx->boot_slot==ULONG_MAX ) ) return;
+  if( FD_LIKELY( feed( ctx, stem ) ) ) {
+    *charge_busy  = 1;
+    ctx->idle_cnt = 0U;
+  }
+}
+
+static inline int
+before_frag( fd_ledger_tile_t * ctx,
+             ulong              in_idx,
+             ulong              seq,
+             ulong              sig ) {
+  (void)seq;
+  return ctx->in_kind[ in_idx ]==IN_KIND_REPLAY && sig!=REPLAY_SIG_SLOT_COMPLETED;
+}
+
+static inline void
+during_frag( fd_ledger_tile_t * ctx,
+             ulong              in_idx,
+             ulong              seq,
+             ulong              sig,
+             ulong              chunk,
+             ulong              sz,
+             ulong              ctl ) {
+  (void)seq; (void)sig; (void)ctl;
+
+  if( FD_UNLIKELY( chunk<ctx->in[ in_idx ].chunk0 || chunk>ctx->in[ in_idx ].wmark || sz>ctx->in[ in_idx ].mtu ) )
+    FD_LOG_ERR(( "chunk %lu %lu corrupt, not in range [%lu,%lu]", chunk, sz, ctx->in[ in_idx ].chunk0, ctx->in[ in_idx ].wmark ));
+
+  void const * src = fd_chunk_to_laddr_const( ctx->in[ in_idx ].mem, chunk );
+  switch( ctx->in_kind[ in_idx ] ) {
+    case IN_KIND_SPILL:
+      if( FD_UNLIKELY( sz!=sizeof(fd_hash_t) ) ) FD_LOG_ERR(( "unexpected spill request sz %lu", sz ));
+      ctx->spill_root = *(fd_hash_t const *)src;
+      break;
+    case IN_KIND_REPLAY:
+      ctx->completed_slot = ((fd_replay_slot_completed_t const *)src)->slot;
+      break;
+    default:
+      FD_LOG_ERR(( "unhandled kind %d", ctx->in_kind[ in_idx ] ));
+  }
+}
+
+static inline void
+after_frag( fd_ledger_tile_t *  ctx,
+            ulong               in_idx,
+            ulong               seq,
+            ulong               sig,
+            ulong               sz,
+            ulong               tsorig,
+            ulong               tspub,
+            fd_stem_context_t * stem ) {
+  (void)seq; (void)sig; (void)sz; (void)tsorig;
+  ctx->idle_cnt = 0U;
+
+  switch( ctx->in_kind[ in_idx ] ) {
+    case IN_KIND_SPILL: {
+      /* A failed append leaves a gap in the ledger (logged), but should
+         not hold back the store, so the spill is acknowledged either
+         way. */
+      fd_store_shacq( ctx->store, ctx->part_idx );
+      fd_store_ledger_spill( ctx->ledger, ctx->store, &ctx->spill_root, ctx->path );
+      fd_store_shrel( ctx->store, ctx->part_idx );
+
+      fd_hash_t * dst = fd_chunk_to_laddr( ctx->out->mem, ctx->out->chunk );
+      *dst = ctx->spill_root;
+      fd_stem_publish( stem, 0UL, FD_LEDGER_SIG_SPILLED, ctx->out->chunk, sizeof(fd_hash_t), 0UL, tspub, fd_frag_meta_ts_comp( fd_tickcount() ) );
+      ctx->out->chunk = fd_dcache_compact_next( ctx->out->chunk, sizeof(fd_hash_t), ctx->out->chunk0, ctx->out->wmark );
+      break;
+    }
+    case IN_KIND_REPLAY: {
+      /* The first completed slot is the slot Replay booted from. */
+      if( FD_UNLIKELY( ctx->boot_slot==ULONG_MAX ) ) {
+        ctx->boot_slot   = ctx->completed_slot;
+        ctx->replay_slot = ctx->completed_slot;
+        ctx->feed_prev   = ctx->completed_slot;
+        ctx->feed_slot   = ctx->completed_slot+1UL;
+        ctx->feed_done   = ctx->ledger->last_slot==ULONG_MAX || ctx->ledger->last_slot<=ctx->completed_slot;
+        if( FD_LIKELY( !ctx->feed_done ) ) FD_LOG_NOTICE(( "feeding slots (%lu,%lu] from the store ledger", ctx->boot_slot, ctx->ledger->last_slot ));
+      }
+      ctx->replay_slot = fd_ulong_max( ctx->replay_slot, ctx->completed_slot );
+      break;
+    }
+    default:
+      FD_LOG_ERR(( "unhandled kind %d", ctx->in_kind[ in_idx ] ));
+  }
+}
+
+static void
+privileged_init( fd_topo_t *      topo,
+                 fd_topo_tile_t * tile ) {
+  void * scratch = fd_topo_obj_laddr( topo, tile->tile_obj_id );
+
+  FD_SCRATCH_ALLOC_INIT( l, scratch );
+  fd_ledger_tile_t * ctx        = FD_SCRATCH_ALLOC_APPEND( l, alignof(fd_ledger_tile_t), sizeof(fd_ledger_tile_t)              );
+  void *             ledger_mem = FD_SCRATCH_ALLOC_APPEND( l, fd_store_ledger_align(),   fd_store_ledger_footprint( SLOT_MAX ) );
+  memset( ctx, 0, sizeof(fd_ledger_tile_t) );
+
+  char const * path = tile->ledger.path;
+  ctx->fd = open( path, O_RDWR|O_CREAT|O_DIRECT|O_CLOEXEC, 0644 );
+  if( FD_UNLIKELY( -1==ctx->fd ) ) FD_LOG_ERR(( "open(%s,O_RDWR|O_CREAT|O_DIRECT|O_CLOEXEC,0644) failed (%i-%s)", path, errno, fd_io_strerror( errno ) ));
+
+  struct stat st;
+  if( FD_UNLIKELY( fstat( ctx->fd, &st ) ) ) FD_LOG_ERR(( "fstat(%s) failed (%i-%s)", path, errno, fd_io_strerror( errno ) ));
+  if( FD_LIKELY( !st.st_size ) ) {
+    if( FD_UNLIKELY( ftruncate( ctx->fd, (off_t)tile->ledger.file_sz ) ) ) {
+      FD_LOG_ERR(( "ftruncate(%s,%lu) failed (%i-%s)", path, tile->ledger.file_sz, errno, fd_io_strerror( errno ) ));
+    }
+  }
+
+  ctx->ledger = fd_store_ledger_init( ledger_mem, SLOT_MAX, ctx->fd, 1 );
+  if( FD_UNLIKELY( !ctx->ledger ) ) FD_LOG_ERR(( "failed to init store ledger at %s (see [store.ledger_path])", path ));
+}
+
+static void
+unprivileged_init( fd_topo_t *      topo,
+                   fd_topo_tile_t * tile ) {
+  void * scratch = fd_topo_obj_laddr( topo, tile->tile_obj_id );
+
+  FD_SCRATCH_ALLOC_INIT( l, scratch );
+  fd_ledger_tile_t * ctx = FD_SCRATCH_ALLOC_APPEND( l, alignof(fd_ledger_tile_t), sizeof(fd_ledger_tile_t)              );
+  /**/                     FD_SCRATCH_ALLOC_APPEND( l, fd_store_ledger_align(),   fd_store_ledger_footprint( SLOT_MAX ) ); /* joined in privileged_init */
+  ctx->path              = FD_SCRATCH_ALLOC_APPEND( l, alignof(ulong),            sizeof(ulong)*tile->ledger.fec_max    );
+  FD_TEST( FD_SCRATCH_ALLOC_FINI( l, scratch_align() )==(ulong)scratch+scratch_footprint( tile ) );
+
+  if( FD_UNLIKELY( tile->kind_id ) ) FD_LOG_ERR(( "There can only be one `" NAME "` tile" ));
+
+  ulong store_obj_id = fd_pod_query_ulong( topo->props, "store", ULONG_MAX );
+  FD_TEST( store_obj_id!=ULONG_MAX );
+  ctx->store = fd_store_join( fd_topo_obj_laddr( topo, store_obj_id ) );
+  FD_TEST( ctx->store );
+  FD_TEST( ctx->store->fec_max==tile->ledger.fec_max );
+
+  /* The topology allocates the writer partition after the Shred
+     tiles' (ie. the last one before the publisher's). */
+
+  ctx->part_idx = fd_store_pub_part( ctx->store )-1UL;
+  FD_TEST( ctx->part_idx==fd_topo_tile_name_cnt( topo, "shred" ) );
+
+  ctx->boot_slot   = ULONG_MAX;
+  ctx->replay_slot = ULONG_MAX;
+  ctx->feed_rec    = NULL;
+  ctx->feed_cnt    = 0UL;
+  ctx->feed_done   = 0;
+  ctx->idle_cnt    = 0U;
+
+  if( FD_UNLIKELY( tile->in_cnt>sizeof(ctx->in)/sizeof(ctx->in[0]) ) ) FD_LOG_ERR(( "tile `" NAME "` has %lu ins, expected at most 2", tile->in_cnt ));
+  for( ulong i=0UL; i<tile->in_cnt; i++ ) {
+    fd_topo_link_t const * link = &topo->links[ tile->in_link_id[ i ] ];
+    ctx->in[ i ].mem    = topo->workspaces[ topo->objs[ link->dcache_obj_id ].wksp_id ].wksp;
+    ctx->in[ i ].chunk0 = fd_dcache_compact_chunk0( ctx->in[ i ].mem, link->dcache );
+    ctx->in[ i ].wmark  = fd_dcache_compact_wmark ( ctx->in[ i ].mem, link->dcache, link->mtu );
+    ctx->in[ i ].mtu    = link->mtu;
+
+    if(      !strcmp( link->name, "replay_ledgr" ) ) ctx->in_kind[ i ] = IN_KIND_SPILL;
+    else if( !strcmp( link->name, "replay_out"   ) ) ctx->in_kind[ i ] = IN_KIND_REPLAY;
+    else FD_LOG_ERR(( "tile `" NAME "` has unexpected input link %s", link->name ));
+  }
+
+  if( FD_UNLIKELY( tile->out_cnt!=1UL || strcmp( topo->links[ tile->out_link_id[ 0 ] ].name, "ledger_out" ) ) ) {
+    FD_LOG_ERR(( "tile `" NAME "` must have exactly one output link ledger_out" ));
+  }
+  fd_topo_link_t const * out_link = &topo->links[ tile->out_link_id[ 0 ] ];
+  ctx->out->mem    = topo->workspaces[ topo->objs[ out_link->dcache_obj_id ].wksp_id ].wksp;
+  ctx->out->chunk0 = fd_dcache_compact_chunk0( ctx->out->mem, out_link->dcache );
+  ctx->out->wmark  = fd_dcache_compact_wmark ( ctx->out->mem, out_link->dcache, out_link->mtu );
+  ctx->out->chunk  = ctx->out->chunk0;
+}
+
+static ulong
+populate_allowed_fds( fd_topo_t      const * topo,
+                      fd_topo_tile_t const * tile,
+                      ulong                  out_fds_cnt,
+                      int *                  out_fds ) {
+  if( FD_UNLIKELY( out_fds_cnt<3UL ) ) FD_LOG_ERR(( "out_fds_cnt %lu", out_fds_cnt ));
+  fd_ledger_tile_t const * ctx = fd_topo_obj_laddr( topo, tile->tile_obj_id );
+
+  ulong out_cnt = 0UL;
+  out_fds[ out_cnt++ ] = 2; /* stderr */
+  if( FD_LIKELY( -1!=fd_log_private_logfile_fd() ) )
+    out_fds[ out_cnt++ ] = fd_log_private_logfile_fd(); /* logfile */
+  out_fds[ out_cnt++ ] = ctx->fd; /* store ledger */
+  return out_cnt;
+}
+
+static ulong
+populate_allowed_seccomp( fd_topo_t const *      topo,
+                          fd_topo_tile_t const * tile,
+                          ulong                  out_cnt,
+                          struct sock_filter *   out ) {
+  fd_ledger_tile_t const * ctx = fd_topo_obj_laddr( topo, tile->tile_obj_id );
+  populate_sock_filter_policy_fd_ledger_tile( out_cnt, out, (uint)fd_log_private_logfile_fd(), (uint)ctx->fd );
+  return sock_filter_policy_fd_ledger_tile_instr_cnt;
+}
+
+#define STEM_BURST (2UL) /* 1 after_credit + 1 after_frag */
+#define STEM_LAZY  ((long)2e6)
+
+#define STEM_CALLBACK_CONTEXT_TYPE  fd_ledger_tile_t
+#define STEM_CALLBACK_CONTEXT_ALIGN alignof(fd_ledger_tile_t)
+
+#define STEM_CALLBACK_DURING_HOUSEKEEPING during_housekeeping
+#define STEM_CALLBACK_BEFORE_CREDIT       before_credit
+#define STEM_CALLBACK_AFTER_CREDIT        after_credit
+#define STEM_CALLBACK_BEFORE_FRAG         before_frag
+#define STEM_CALLBACK_DURING_FRAG         during_frag
+#define STEM_CALLBACK_AFTER_FRAG          after_frag
+
+#include "../../disco/stem/fd_stem.c"
+
+fd_topo_run_tile_t fd_tile_ledger = {
+  .name                     = NAME,
+  .populate_allowed_fds     = populate_allowed_fds,
+  .populate_allowed_seccomp = populate_allowed_seccomp,
+  .scratch_align            = scratch_align,
+  .scratch_footprint        = scratch_footprint,
+  .privileged_init          = privileged_init,
+  .unprivileged_init        = unprivileged_init,
+  .run                      = stem_run,
+};
+
+#undef NAME
@@ -0,0 +1,10 @@
+#ifndef HEADER_fd_src_discof_ledger_fd_ledger_tile_h
+#define HEADER_fd_src_discof_ledger_fd_ledger_tile_h
+
+/* Message sigs published by the ledger tile on ledger_out (see
+   fd_ledger_tile.c). */
+
+#define FD_LEDGER_SIG_FEC_COMPLETE (0UL) /* FEC complete message read back from the ledger, same format as shred_out */
+#define FD_LEDGER_SIG_SPILLED      (1UL) /* fd_hash_t store root of a spill request from replay_ledgr that was spilled */
+
+#endif /* HEADER_fd_src_discof_ledger_fd_ledger_tile_h */
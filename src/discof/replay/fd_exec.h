@@ -5,6 +5,8 @@
 #define FD_SIMD0180_ACTIVE_EPOCH_TESTNET (829)
 #define FD_SIMD0180_ACTIVE_EPOCH_MAINNET (841)
 
+#include "../../ballet/poh/fd_poh.h"
+
 
 /* Exec tile task types. */
 #define FD_EXEC_TT_TXN_EXEC      (1UL) /* Transaction execution. */
@@ -31,9 +33,21 @@ struct fd_exec_txn_sigverify_msg {
 };
 typedef struct fd_exec_txn_sigverify_msg fd_exec_txn_sigverify_msg_t;
 
+#define FD_EXEC_POH_VERIFY_ENTRY_MAX (16UL)
+
+struct fd_exec_poh_verify_msg {
+  ulong          bank_idx;
+  ulong          entry_idx; /* Index in the block of entry[0]. */
+  ulong          entry_cnt; /* In [1,FD_EXEC_POH_VERIFY_ENTRY_MAX]. */
+  uchar          start[ 32 ];
+  fd_poh_entry_t entry[ FD_EXEC_POH_VERIFY_ENTRY_MAX ];
+};
+typedef struct fd_exec_poh_verify_msg fd_exec_poh_verify_msg_t;
+
 union fd_exec_task_msg {
   fd_exec_txn_exec_msg_t      txn_exec;
   fd_exec_txn_sigverify_msg_t txn_sigverify;
+  fd_exec_poh_verify_msg_t    poh_verify;
 };
 typedef union fd_exec_task_msg fd_exec_task_msg_t;
 
@@ -45,6 +59,7 @@ typedef union fd_exec_task_msg fd_exec_task_msg_t;
 struct fd_exec_txn_exec_done_msg {
   ulong txn_idx;
   int   err;
+  ulong cus;     /* Compute units consumed by the transaction. */
 };
 typedef struct fd_exec_txn_exec_done_msg fd_exec_txn_exec_done_msg_t;
 
@@ -54,11 +69,18 @@ struct fd_exec_txn_sigverify_done_msg {
 };
 typedef struct fd_exec_txn_sigverify_done_msg fd_exec_txn_sigverify_done_msg_t;
 
+struct fd_exec_poh_verify_done_msg {
+  ulong entry_idx;
+  ulong bad_idx;   /* Index in the block of the first bad entry, or ULONG_MAX if all entries are valid. */
+};
+typedef struct fd_exec_poh_verify_done_msg fd_exec_poh_verify_done_msg_t;
+
 struct fd_exec_task_done_msg {
   ulong bank_idx;
   union {
     fd_exec_txn_exec_done_msg_t      txn_exec[ 1 ];
     fd_exec_txn_sigverify_done_msg_t txn_sigverify[ 1 ];
+    fd_exec_poh_verify_done_msg_t    poh_verify[ 1 ];
   };
 };
 typedef struct fd_exec_task_done_msg fd_exec_task_done_msg_t;
@@ -1,4 +1,6 @@
 #include "fd_rdisp.h"
+#include "../../disco/pack/fd_pack.h"
+#include "../../disco/pack/fd_pack_cost.h"
 #include <math.h> /* for the EMA */
 
 /* The conflict graph that this file builds is not a general DAG, but
@@ -142,6 +144,21 @@ struct fd_rdisp_txn {
      execution is not very important. */
   float   score;
 
+  /* cost, prog_bin, hot_acct, and hot_prefix are used by
+     FD_RDISP_PRIORITY_CRITICAL_PATH.  cost is the estimated cost of
+     executing the transaction in compute units, or 0 if the transaction
+     was not added in that mode.  prog_bin is the index in prog_hist of
+     the program the transaction invokes.  hot_acct is the index in the
+     acct_pool of the most contended account the transaction writes (0
+     if none), and hot_prefix is the value of
+     acct_chain( hot_acct )->cus[ lane ] right after the transaction was
+     added to the DAG, so the estimated cost of the transactions that
+     must wait for this one is the amount that value has grown since. */
+  uint    cost;
+  uint    prog_bin;
+  uint    hot_acct;
+  uint    hot_prefix;
+
   /* edge_cnt_etc:
      0xFFFF0000 (16 bits) for linear block number,
      0x0000C000 (2 bits) for concurrency lane,
@@ -323,6 +340,45 @@ typedef struct acct_info acct_info_t;
 
 FD_STATIC_ASSERT( sizeof(acct_info_t)==64UL, acct_info_t );
 
+/* acct_chain_t is a bin in a hash table indexed by acct_pool index
+   (there's no room left in acct_info_t, and a table parallel to
+   acct_pool would be huge).  cus[lane] is the running sum of the
+   estimated cost of all transactions in staging lane lane that have
+   written to an account that maps to this bin.  Only differences of
+   these values are meaningful, so it's fine that they wrap around and
+   that they are never reset.  As with fd_est_tbl, accounts can alias,
+   which only makes the estimate a bit pessimistic. */
+struct acct_chain {
+  uint cus[4];
+};
+typedef struct acct_chain acct_chain_t;
+
+/* prog_hist_t is a bin of a small table, modeled after fd_est_tbl, that
+   maintains an EMA of the compute units consumed by transactions that
+   invoke programs that hash to this bin.  x/d is the mean, and d is 0
+   if the bin has no data.  As with the account EMA, this value doesn't
+   matter for correctness, so float is okay. */
+struct prog_hist {
+  float x;
+  float d;
+};
+typedef struct prog_hist prog_hist_t;
+
+#define PROG_HIST_CNT   1024UL
+#define PROG_HIST_DECAY (1.0f-1.0f/256.0f)
+
+/* TXN_BASE_CUS is a rough estimate of the per transaction overhead
+   that doesn't show up in compute units (loading accounts, etc),
+   expressed in compute units. */
+#define TXN_BASE_CUS 1000U
+
+/* CP_SCALE_CUS controls how the estimated remaining critical path
+   length is mapped into the fractional part of the score.  A
+   transaction with a remaining path of CP_SCALE_CUS gets half the
+   fractional score of one with a remaining path of 0 (which doesn't
+   exist, but you get the idea). */
+#define CP_SCALE_CUS 10000.0f
+
 /* For the acct_map and the free_acct_map */
 #define MAP_NAME          acct_map
 #define MAP_ELE_T         acct_info_t
@@ -433,6 +489,10 @@ typedef struct {
   ulong               inserted_cnt;
   ulong               dispatched_cnt;
   ulong               completed_cnt;
+  /* stale_cnt: the number of transactions added in
+     FD_RDISP_PRIORITY_CRITICAL_PATH mode since the scores in pending
+     were last recomputed. */
+  ulong               stale_cnt;
 } per_lane_info_t;
 
 /* We maintain two maps from pubkeys to acct_info_t.  The first one is
@@ -477,10 +537,81 @@ struct fd_rdisp {
      don't need to acquire and release from it because of the dlist. */
   acct_info_t  * acct_pool;
   free_dlist_t   free_acct_dlist[1];
+
+  /* acct_chain: hash table of chain_mask+1 bins, see acct_chain_t.
+     Only used by FD_RDISP_PRIORITY_CRITICAL_PATH. */
+  acct_chain_t * acct_chain;
+  ulong          chain_mask;
+
+  int            priority; /* one of FD_RDISP_PRIORITY_* */
+  prog_hist_t    prog_hist[ PROG_HIST_CNT ];
 };
 
 typedef struct fd_rdisp fd_rdisp_t;
 
+/* chain_cnt_est returns the number of bins in the acct_chain table.
+   Each transaction has at most one account that we care about, so
+   twice the depth keeps aliasing low. */
+static inline ulong chain_cnt_est( ulong depth ) { return fd_ulong_pow2_up( 2UL*depth ); }
+
+static inline acct_chain_t *
+acct_chain( fd_rdisp_t const * disp,
+            ulong              acct_idx ) {
+  return disp->acct_chain + (fd_ulong_hash( acct_idx ) & disp->chain_mask);
+}
+
+/* pending_score returns the score with which a transaction that just
+   became READY in staging lane lane should be inserted into the lane's
+   pending queue.  For transactions added in
+   FD_RDISP_PRIORITY_CRITICAL_PATH mode, the integer part (which has a
+   special meaning) is preserved, and the fractional part is mostly
+   determined by the estimated length of the remaining critical path,
+   i.e. the cost of the transaction plus the cost of the chain of
+   transactions that must wait for it on its most contended account.
+   The fractional part of rtxn->score, which fd_rdisp_add_txn sets to
+   a function of the transaction's position in the block in this mode,
+   is only used to break ties.  Since the chain can grow after the
+   transaction becomes READY, the scores in the pending queue are
+   recomputed periodically (see rescore_pending). */
+static inline float
+pending_score( fd_rdisp_t     const * disp,
+               fd_rdisp_txn_t const * rtxn,
+               ulong                  lane ) {
+  float score = rtxn->score;
+  if( FD_LIKELY( !rtxn->cost ) ) return score;
+
+  uint  downstream = 0U;
+  if( FD_LIKELY( rtxn->hot_acct ) ) downstream = acct_chain( disp, rtxn->hot_acct )->cus[ lane ] - rtxn->hot_prefix; /* wraparound okay */
+  float remaining  = (float)rtxn->cost + (float)downstream;
+  float base       = floorf( score );
+  float urgency    = 1.0f - (1.0f-(score-base))*(1.0f/16.0f); /* in [15/16, 1) */
+  return base + urgency*(CP_SCALE_CUS/(CP_SCALE_CUS+remaining));
+}
+
+/* rescore_pending recomputes the scores of all the transactions in the
+   specified lane's pending queue and rebuilds the queue.  This takes
+   O(cnt log cnt) time, but the caller only does it once the number of
+   transactions added since the last rescore is a constant fraction of
+   cnt, so the amortized cost per added transaction is O(log depth). */
+static void
+rescore_pending( fd_rdisp_t * disp,
+                 ulong        lane ) {
+  per_lane_info_t   * l       = disp->lanes + lane;
+  pending_prq_ele_t * pending = l->pending;
+  ulong               cnt     = pending_prq_cnt( pending );
+
+  /* remove_all only resets the count, and inserting the i-th element
+     only touches heap positions [0, i], so we can rebuild the heap in
+     place. */
+  pending_prq_remove_all( pending );
+  for( ulong i=0UL; i<cnt; i++ ) {
+    pending_prq_ele_t e[1] = { pending[ i ] };
+    e->score = pending_score( disp, disp->pool+e->txn_idx, lane );
+    pending_prq_insert( pending, e );
+  }
+  l->stale_cnt = 0UL;
+}
+
 
  #define ACCT_ITER_TO_PTR( iter ) (__extension__( {                                             \
        ulong __idx = fd_txn_acct_iter_idx( iter );                                              \
@@ -510,6 +641,7 @@ fd_rdisp_footprint( ulong depth,
   l = FD_LAYOUT_APPEND( l, acct_map_align(),             acct_map_footprint          ( acct_chain_cnt  ) ); /* acct_map   */
   l = FD_LAYOUT_APPEND( l, acct_map_align(),             acct_map_footprint          ( acct_chain_cnt  ) ); /* free_acct_map */
   l = FD_LAYOUT_APPEND( l, alignof(acct_info_t),         (acct_depth+1UL)*sizeof(acct_info_t)            ); /* acct_pool  */
+  l = FD_LAYOUT_APPEND( l, alignof(acct_chain_t),        chain_cnt_est( depth )*sizeof(acct_chain_t)     ); /* acct_chain */
   return FD_LAYOUT_FINI( l, fd_rdisp_align() );
 }
 
@@ -535,12 +667,16 @@ fd_rdisp_new( void * mem,
   void  * _acct_map   = FD_SCRATCH_ALLOC_APPEND( l, acct_map_align(),             acct_map_footprint          ( acct_chain_cnt  ) );
   void  * _freea_map  = FD_SCRATCH_ALLOC_APPEND( l, acct_map_align(),             acct_map_footprint          ( acct_chain_cnt  ) );
   acct_info_t * apool = FD_SCRATCH_ALLOC_APPEND( l, alignof(acct_info_t),         (acct_depth+1UL)*sizeof(acct_info_t)            );
+  void  * _chain      = FD_SCRATCH_ALLOC_APPEND( l, alignof(acct_chain_t),        chain_cnt_est( depth )*sizeof(acct_chain_t)     );
   FD_SCRATCH_ALLOC_FINI( l, fd_rdisp_align() );
 
   disp->depth             = depth;
   disp->block_depth       = block_depth;
   disp->global_insert_cnt = 0UL;
   disp->unstaged_lblk_num = 0UL;
+  disp->priority          = FD_RDISP_PRIORITY_CONFLICT;
+  memset( disp->prog_hist, '\0', sizeof(disp->prog_hist) );
+  memset( _chain,          '\0', chain_cnt_est( depth )*sizeof(acct_chain_t) );
 
   fd_rdisp_txn_t * temp_pool_join = pool_join( pool_new( _pool, depth+1UL ) );
   for( ulong i=0UL; i<depth+1UL; i++ ) temp_pool_join[ i ].in_degree = IN_DEGREE_FREE;
@@ -564,6 +700,7 @@ fd_rdisp_new( void * mem,
     disp->lanes[i].inserted_cnt        = 0U;
     disp->lanes[i].dispatched_cnt      = 0U;
     disp->lanes[i].completed_cnt       = 0U;
+    disp->lanes[i].stale_cnt           = 0UL;
   }
 
   acct_map_new( _acct_map,  acct_chain_cnt, fd_ulong_hash( seed+1UL ) );
@@ -599,6 +736,7 @@ fd_rdisp_join( void * mem ) {
   void  * _acct_map   = FD_SCRATCH_ALLOC_APPEND( l, acct_map_align(),             acct_map_footprint          ( acct_chain_cnt  ) );
   void  * _freea_map  = FD_SCRATCH_ALLOC_APPEND( l, acct_map_align(),             acct_map_footprint          ( acct_chain_cnt  ) );
   acct_info_t * apool = FD_SCRATCH_ALLOC_APPEND( l, alignof(acct_info_t),         (acct_depth+1UL)*sizeof(acct_info_t)            );
+  void  * _chain      = FD_SCRATCH_ALLOC_APPEND( l, alignof(acct_chain_t),        chain_cnt_est( depth )*sizeof(acct_chain_t)     );
   FD_SCRATCH_ALLOC_FINI( l, fd_rdisp_align() );
 
   disp->pool       = pool_join( _pool );
@@ -616,6 +754,8 @@ fd_rdisp_join( void * mem ) {
   disp->acct_map      = acct_map_join( _acct_map );
   disp->free_acct_map = acct_map_join( _freea_map );
   disp->acct_pool     = apool;
+  disp->acct_chain    = (acct_chain_t *)_chain;
+  disp->chain_mask    = chain_cnt_est( depth )-1UL;
   free_dlist_join( disp->free_acct_dlist );
 
   return disp;
@@ -631,6 +771,7 @@ free_lane( fd_rdisp_t * disp,
   l->inserted_cnt   = 0UL;
   l->dispatched_cnt = 0UL;
   l->completed_cnt  = 0UL;
+  l->stale_cnt      = 0UL;
   block_slist_delete( block_slist_leave( l->block_ll ) );
 }
 
@@ -815,6 +956,8 @@ fd_rdisp_promote_block( fd_rdisp_t *          disp,
 
     ele->in_degree    = 0U;
     ele->edge_cnt_etc = 0U;
+    ele->hot_acct     = 0U;
+    ele->hot_prefix   = 0U;
 
     add_edges( disp, ele, uns->keys,                   uns->writable_cnt, (uint)staging_lane, 1, 0 );
     add_edges( disp, ele, uns->keys+uns->writable_cnt, uns->readonly_cnt, (uint)staging_lane, 0, 0 );
@@ -823,9 +966,10 @@ fd_rdisp_promote_block( fd_rdisp_t *          disp,
     ele->edge_cnt_etc |= linear_block_number<<16;
 
     if( FD_UNLIKELY( ele->in_degree==0U ) ) {
-      pending_prq_ele_t temp[1] = {{ .score = ele->score, .linear_block_number = linear_block_number, .txn_idx = (uint)(ele-disp->pool)}};
+      pending_prq_ele_t temp[1] = {{ .score = pending_score( disp, ele, staging_lane ), .linear_block_number = linear_block_number, .txn_idx = (uint)(ele-disp->pool)}};
       pending_prq_insert( lane->pending, temp );
     }
+    lane->stale_cnt += (ulong)(ele->cost!=0U);
   }
   unstaged_txn_ll_delete( unstaged_txn_ll_leave( block->ll ) );
 
@@ -1077,6 +1221,22 @@ add_edges( fd_rdisp_t           * disp,
     ele->in_degree += (uint)((ai->last_reference[ lane ]!=0U) & !!(flags & ACCT_INFO_FLAG_ANY_WRITERS( lane )));
     ai->last_reference[ lane ] = ref_to_me;
     ai->flags                  = (uchar)flags;
+
+    /* Step 4: For FD_RDISP_PRIORITY_CRITICAL_PATH, extend the chain of
+       writers and remember where in the chain this transaction is on
+       the most contended account it writes (as measured by the EMA).
+       Readers don't extend the chain, since they can execute in
+       parallel, and frequently read accounts (e.g. programs) would
+       otherwise shadow the account the transaction actually serializes
+       on. */
+    if( (ele->cost!=0U) & writable ) {
+      uint * chain = acct_chain( disp, idx )->cus + lane;
+      *chain += ele->cost;
+      if( (ele->hot_acct==0U) || (ai->ema_refs>disp->acct_pool[ ele->hot_acct ].ema_refs) ) {
+        ele->hot_acct   = (uint)idx;
+        ele->hot_prefix = *chain;
+      }
+    }
     edge_idx += fd_uint_if( writable, 1U, 3U );
     acct_idx++;
   }
@@ -1110,6 +1270,34 @@ add_unstaged_edges( fd_rdisp_t * disp,
   *(fd_ptr_if( writable, &(unstaged->writable_cnt), &(unstaged->readonly_cnt) ) ) += (uint)addr_cnt;
 }
 
+/* estimate_cost returns the estimated cost in compute units of
+   executing txn, and stores the index in prog_hist of the program it
+   invokes in prog_bin.  The estimate is the compute unit limit the
+   transaction requests, unless the history of the program says it
+   usually uses less.  We use the program of the last instruction, since
+   compute budget instructions typically come first. */
+static inline uint
+estimate_cost( fd_rdisp_t const * disp,
+               fd_txn_t   const * txn,
+               uchar      const * payload,
+               uint             * prog_bin ) {
+  uint  flags;
+  ulong requested = 0UL;
+  if( FD_UNLIKELY( !fd_pack_compute_cost( txn, payload, &flags, &requested, NULL, NULL, NULL ) ) ) requested = 0UL;
+
+  ulong bin = 0UL;
+  if( FD_LIKELY( txn->instr_cnt ) ) {
+    fd_acct_addr_t const * prog = fd_txn_get_acct_addrs( txn, payload ) + txn->instr[ txn->instr_cnt-1UL ].program_id;
+    bin = fd_ulong_hash( FD_LOAD( ulong, prog->b ) ) & (PROG_HIST_CNT-1UL);
+  }
+  *prog_bin = (uint)bin;
+
+  float est = (float)requested;
+  prog_hist_t const * h = disp->prog_hist + bin;
+  if( FD_LIKELY( h->d>0.0f ) ) est = fminf( est, h->x/h->d );
+  return (uint)est + TXN_BASE_CUS;
+}
+
 ulong
 fd_rdisp_add_txn( fd_rdisp_t          *  disp,
                   FD_RDISP_BLOCK_TAG_T   insert_block,
@@ -1128,6 +1316,12 @@ fd_rdisp_add_txn( fd_rdisp_t          *  disp,
 
   fd_acct_addr_t const * imm_addrs = fd_txn_get_acct_addrs( txn, payload );
 
+  rtxn->cost       = 0U;
+  rtxn->prog_bin   = 0U;
+  rtxn->hot_acct   = 0U;
+  rtxn->hot_prefix = 0U;
+  if( FD_UNLIKELY( disp->priority==FD_RDISP_PRIORITY_CRITICAL_PATH ) ) rtxn->cost = estimate_cost( disp, txn, payload, &rtxn->prog_bin );
+
   if( FD_UNLIKELY( !block->staged ) ) {
     rtxn->in_degree = IN_DEGREE_UNSTAGED;
     rtxn->score     = 0.999f;
@@ -1180,15 +1374,26 @@ fd_rdisp_add_txn( fd_rdisp_t          *  disp,
     block->last_serializing = block->inserted_cnt;
   }
   block->last_insert_was_serializing = (uint)!!serializing;
+  if( FD_UNLIKELY( rtxn->cost ) ) {
+    /* In FD_RDISP_PRIORITY_CRITICAL_PATH mode, conflicts are already
+       accounted for by the chain estimate, so ties are broken in block
+       order instead of by the EMA.  This matters when the first writer
+       of what becomes a hot account is added: at that point, the
+       account doesn't look any more contended than the others the
+       transaction writes, so it gets no chain credit. */
+    float pos = (float)(block->inserted_cnt - block->last_serializing);
+    rtxn->score = pos/(pos+1024.0f);
+  }
   rtxn->score += (float)block->last_serializing;
 
   block->inserted_cnt++;
   disp->global_insert_cnt++;
 
   if( FD_LIKELY( (block->staged) & (rtxn->in_degree==0U) ) ) {
-    pending_prq_ele_t temp[1] = {{ .score = rtxn->score, .linear_block_number = block->linear_block_number, .txn_idx = (uint)idx }};
+    pending_prq_ele_t temp[1] = {{ .score = pending_score( disp, rtxn, block->staging_lane ), .linear_block_number = block->linear_block_number, .txn_idx = (uint)idx }};
     pending_prq_insert( disp->lanes[ block->staging_lane ].pending, temp );
   }
+  if( FD_LIKELY( block->staged ) ) disp->lanes[ block->staging_lane ].stale_cnt += (ulong)(rtxn->cost!=0U);
 
   return idx;
 }
@@ -1205,6 +1410,7 @@ fd_rdisp_get_next_ready( fd_rdisp_t           * disp,
     per_lane_info_t * l = disp->lanes + staging_lane;
 
     if( FD_UNLIKELY( !pending_prq_cnt( l->pending )                                ) ) return 0UL;
+    if( FD_UNLIKELY( l->stale_cnt && 8UL*l->stale_cnt>=pending_prq_cnt( l->pending ) ) ) rescore_pending( disp, staging_lane );
     if( FD_UNLIKELY( l->pending->linear_block_number != block->linear_block_number ) ) return 0UL;
     /* e.g. when completed_cnt==0, we can accept any score below 1.0 */
     if( FD_UNLIKELY( l->pending->score>=(float)(block->completed_cnt+1U)           ) ) return 0UL;
@@ -1312,7 +1518,7 @@ fd_rdisp_complete_txn( fd_rdisp_t * disp,
                which case, we subtract 2^16. */
             uint low_16_bits = child_txn->edge_cnt_etc>>16;
             uint linear_block_num = ((tail_linear_block_num & ~0xFFFFU) | low_16_bits) - (uint)((low_16_bits>(tail_linear_block_num&0xFFFFU))<<16);
-            pending_prq_ele_t temp[1] = {{ .score               = child_txn->score,
+            pending_prq_ele_t temp[1] = {{ .score               = pending_score( disp, child_txn, lane ),
                                            .linear_block_number = linear_block_num,
                                            .txn_idx             = (uint)(child_txn-disp->pool) }};
             pending_prq_insert( disp->lanes[ lane ].pending, temp );
@@ -1403,6 +1609,25 @@ fd_rdisp_complete_txn( fd_rdisp_t * disp,
   }
 }
 
+int
+fd_rdisp_set_priority( fd_rdisp_t * disp,
+                       int          mode ) {
+  if( FD_UNLIKELY( (mode!=FD_RDISP_PRIORITY_CONFLICT) & (mode!=FD_RDISP_PRIORITY_CRITICAL_PATH) ) ) return -1;
+  disp->priority = mode;
+  return 0;
+}
+
+void
+fd_rdisp_record_cus( fd_rdisp_t * disp,
+                     ulong        txn_idx,
+                     ulong        cus ) {
+  fd_rdisp_txn_t const * rtxn = disp->pool + txn_idx;
+  if( FD_LIKELY( !rtxn->cost ) ) return;
+
+  prog_hist_t * h = disp->prog_hist + rtxn->prog_bin;
+  h->x = (float)fd_ulong_min( cus, FD_COMPUTE_BUDGET_MAX_CU_LIMIT ) + PROG_HIST_DECAY*h->x;
+  h->d = 1.0f                                                       + PROG_HIST_DECAY*h->d;
+}
 
 ulong
 fd_rdisp_staging_lane_info( fd_rdisp_t           const * disp,
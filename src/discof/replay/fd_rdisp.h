@@ -360,7 +360,8 @@ fd_rdisp_add_txn( fd_rdisp_t          *  disp,
 
    If there are multiple READY transactions, which exact one is returned
    is arbitrary.  That said, this function does make some effort to pick
-   one that (upon completion) will unlock more parallelism.  disp must
+   one that (upon completion) will unlock more parallelism (see
+   fd_rdisp_set_priority for how to tune that).  disp must
    be a valid local join.  At the time this function returns, the
    returned transaction index (if nonzero) will transition to the
    DISPATCHED state. */
@@ -389,6 +390,52 @@ fd_rdisp_complete_txn( fd_rdisp_t * disp,
                        ulong        txn_idx,
                        int          reclaim );
 
+/* Priority modes for fd_rdisp_set_priority.
+
+   FD_RDISP_PRIORITY_CONFLICT (the default) orders READY transactions by
+   an estimate of how likely they are to conflict with transactions that
+   have not been inserted yet, which works well when the dispatcher only
+   sees a little bit of the block ahead of execution.
+
+   FD_RDISP_PRIORITY_CRITICAL_PATH additionally estimates, for each
+   transaction, the length (in compute units) of the chain of
+   transactions that can't start until it completes, and prefers READY
+   transactions with the longest remaining chain.  The cost of each
+   transaction is estimated from its compute unit request, refined by a
+   per-program history of compute units consumed (see
+   fd_rdisp_record_cus).  The chain is tracked along the most contended
+   account that the transaction writes, which is where the long serial
+   chains in real blocks come from (e.g. many writes to one hot
+   account).  Ties are broken in block order.  This helps the most when many exec tiles are available
+   and the dispatcher sees a large part of the block ahead of
+   execution.  It costs a little bit of extra work in add_txn and an
+   amortized O(log depth) rescoring of READY transactions in
+   get_next_ready. */
+#define FD_RDISP_PRIORITY_CONFLICT      0
+#define FD_RDISP_PRIORITY_CRITICAL_PATH 1
+
+/* fd_rdisp_set_priority sets the priority mode (one of the
+   FD_RDISP_PRIORITY_* values above) used for transactions added from
+   now on.  The mode only affects the order in which READY transactions
+   are returned by get_next_ready, never correctness, so it can be
+   changed at any time.  Returns 0 on success and -1 if mode is not a
+   known mode. */
+int
+fd_rdisp_set_priority( fd_rdisp_t * disp,
+                       int          mode );
+
+/* fd_rdisp_record_cus informs the dispatcher that the transaction with
+   index txn_idx (which must be in the DISPATCHED or ZOMBIE state)
+   consumed cus compute units.  This refines the cost estimates used by
+   FD_RDISP_PRIORITY_CRITICAL_PATH for future transactions that invoke
+   the same program.  Calling it is optional, and it's a cheap no-op
+   unless the transaction was added in FD_RDISP_PRIORITY_CRITICAL_PATH
+   mode. */
+void
+fd_rdisp_record_cus( fd_rdisp_t * disp,
+                     ulong        txn_idx,
+                     ulong        cus );
+
 
 typedef struct {
   FD_RDISP_BLOCK_TAG_T  schedule_ready_block;
@@ -395,6 +395,22 @@ fd_rdisp_complete_txn( fd_rdisp_t * disp,
   txn_ll_ele_pop_head( block->ll, disp->pool );
 }
 
+/* Everything is dispatched in serial order, so there's nothing to
+   prioritize. */
+int
+fd_rdisp_set_priority( fd_rdisp_t * disp,
+                       int          mode ) {
+  (void)disp;
+  return fd_int_if( (mode==FD_RDISP_PRIORITY_CONFLICT) | (mode==FD_RDISP_PRIORITY_CRITICAL_PATH), 0, -1 );
+}
+
+void
+fd_rdisp_record_cus( fd_rdisp_t * disp,
+                     ulong        txn_idx,
+                     ulong        cus ) {
+  (void)disp; (void)txn_idx; (void)cus;
+}
+
 
 ulong
 fd_rdisp_staging_lane_info( fd_rdisp_t           const * disp,
@@ -1,15 +1,16 @@
+#define _DEFAULT_SOURCE /* madvise */
 #include "fd_replay_tile.h"
 #include "fd_sched.h"
 #include "fd_exec.h"
 #include "fd_vote_tracker.h"
 #include "../../flamenco/accdb/fd_accdb_sync.h"
-#include "generated/fd_replay_tile_seccomp.h"
 
 #include "../genesis/fd_genesi_tile.h"
 #include "../poh/fd_poh.h"
 #include "../poh/fd_poh_tile.h"
 #include "../tower/fd_tower_tile.h"
 #include "../resolv/fd_resolv_tile.h"
+#include "../ledger/fd_ledger_tile.h"
 #include "../restore/utils/fd_ssload.h"
 
 #include "../../disco/tiles.h"
@@ -21,6 +22,7 @@
 #include "../../util/pod/fd_pod.h"
 #include "../../flamenco/accdb/fd_accdb_admin.h"
 #include "../../flamenco/accdb/fd_accdb_user.h"
+#include "../../flamenco/accdb/fd_accdb_vinyl.h"
 #include "../../flamenco/rewards/fd_rewards.h"
 #include "../../flamenco/leaders/fd_multi_epoch_leaders.h"
 #include "../../flamenco/progcache/fd_progcache_admin.h"
@@ -30,10 +32,21 @@
 #include "../../flamenco/runtime/fd_runtime_stack.h"
 #include "../../flamenco/fd_flamenco_base.h"
 #include "../../flamenco/runtime/sysvar/fd_sysvar_epoch_schedule.h"
+#include "../../flamenco/runtime/sysvar/fd_sysvar_stake_history.h"
+#include "../../flamenco/runtime/program/fd_stake_program.h"
+#include "../../flamenco/stakes/fd_stakes.h"
 
 #include "../../flamenco/runtime/tests/fd_dump_pb.h"
 
 #include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "generated/fd_replay_tile_seccomp.h"
+
+FD_STATIC_ASSERT( FD_EXEC_POH_VERIFY_ENTRY_MAX>=FD_SCHED_POH_VERIFY_ENTRY_MAX, poh verify msg too small );
 
 /* Replay concepts:
 
@@ -83,6 +96,8 @@
 #define IN_KIND_SHRED   (7)
 #define IN_KIND_VTXN    (8)
 #define IN_KIND_GUI     (9)
+#define IN_KIND_LEDGER  (10)
+#define IN_KIND_VINYL   (11) /* unpolled, read by vinyl_client */
 
 #define DEBUG_LOGGING 0
 
@@ -90,6 +105,18 @@
    or the snapshot boot will always be at bank index 0. */
 #define FD_REPLAY_BOOT_BANK_IDX (0UL)
 
+/* FD_REPLAY_STAKE_STAGE_SLOTS is how many slots before the end of an
+   epoch the published root has to be for the next epoch's stake weights
+   to be staged.  Later is more likely to match the stake weights at the
+   boundary, but the consumers need time to stage before it. */
+#define FD_REPLAY_STAKE_STAGE_SLOTS (512UL)
+
+/* FD_REPLAY_STAKE_STAGE_CHAIN_CNT is how many stake delegation map
+   chains (a few hundred stake delegations on mainnet) the projection
+   of the staged stake weights walks per run loop iteration, so that it
+   does not hold up replay (see fd_stakes_projection_step). */
+#define FD_REPLAY_STAKE_STAGE_CHAIN_CNT (1024UL)
+
 struct fd_replay_in_link {
   fd_wksp_t * mem;
   ulong       chunk0;
@@ -141,6 +168,14 @@ struct fd_replay_tile {
   fd_accdb_user_t      accdb[1];
   fd_progcache_admin_t progcache_admin[1];
 
+  /* If the vinyl tile is enabled (vinyl_map!=NULL), rooted accounts are
+     flushed to it through vinyl_client and read back from vinyl_map, a
+     read-only mapping of the accounts file. */
+  void *            vinyl_map;
+  ulong             vinyl_map_sz;
+  fd_vinyl_meta_t   vinyl_meta[1];
+  fd_vinyl_client_t vinyl_client[1];
+
   fd_txncache_t * txncache;
   fd_store_t *    store;
   fd_banks_t *    banks;
@@ -372,6 +407,31 @@ struct fd_replay_tile {
 
   fd_replay_out_link_t stake_out[1];
 
+  /* If replay_stage is connected (stage_out->idx!=ULONG_MAX), the stake
+     weights message of the next epoch boundary is projected and staged
+     once the published root gets within FD_REPLAY_STAKE_STAGE_SLOTS of
+     the end of its epoch (see begin_stake_stage).  stake_stage_epoch
+     is the epoch of the last message staged (attempted once per
+     epoch).  While stake_stage_walking, stake_stage_proj is walking the
+     rooted stake delegations a few chains per after_credit. */
+  fd_replay_out_link_t   stage_out[1];
+  int                    stake_stage_pending;
+  int                    stake_stage_walking;
+  ulong                  stake_stage_epoch;
+  ulong                  stake_stage_slot;
+  long                   stake_stage_start;
+  fd_stakes_projection_t stake_stage_proj[1];
+
+  /* If the ledger tile is enabled (ledger_out->idx!=ULONG_MAX), new
+     store roots are sent to it to be spilled first and only published
+     once it acknowledges.  store_spill_root is the latest root not yet
+     sent (valid if store_spill_pending) and store_spill_inflight is 1
+     while waiting for an acknowledgement. */
+  fd_replay_out_link_t ledger_out[1];
+  int                  store_spill_pending;
+  int                  store_spill_inflight;
+  fd_hash_t            store_spill_root;
+
   /* The gui tile needs to reliably own a reference to the most recent
      completed active bank.  Replay needs to know if the gui as a
      consumer is enabled so it can increment the bank's refcnt before
@@ -399,6 +459,7 @@ struct fd_replay_tile {
 
     ulong slots_total;
     ulong transactions_total;
+    ulong duplicate_fec_sets;
   } metrics;
 
   uchar __attribute__((aligned(FD_MULTI_EPOCH_LEADERS_ALIGN))) mleaders_mem[ FD_MULTI_EPOCH_LEADERS_FOOTPRINT ];
@@ -408,6 +469,14 @@ struct fd_replay_tile {
 
 typedef struct fd_replay_tile fd_replay_tile_t;
 
+/* VINYL_SCRATCH_SZ is the size of the buffer rooted accounts are
+   copied or decoded into.  The vinyl tile only compresses cold pairs
+   of at most half of this (see COLD_MAX in fd_vinyl_tile.c), such that
+   a compressed account wrapping around the end of the bstream store
+   fits with its encoded val. */
+
+#define VINYL_SCRATCH_SZ (sizeof(fd_account_meta_t)+FD_RUNTIME_ACC_SZ_MAX)
+
 FD_FN_CONST static inline ulong
 scratch_align( void ) {
   return 128UL;
@@ -429,6 +498,9 @@ scratch_footprint( fd_topo_tile_t const * tile ) {
   if( FD_UNLIKELY( tile->replay.dump_block_to_pb ) ) {
     l = FD_LAYOUT_APPEND( l, fd_block_dump_context_align(), fd_block_dump_context_footprint() );
   }
+  if( FD_UNLIKELY( tile->replay.vinyl_path[0] ) ) {
+    l = FD_LAYOUT_APPEND( l, alignof(fd_account_meta_t), VINYL_SCRATCH_SZ );
+  }
 
   l = FD_LAYOUT_FINI( l, scratch_align() );
 
@@ -463,16 +535,13 @@ metrics_write( fd_replay_tile_t * ctx ) {
 
   FD_MCNT_SET( REPLAY, SLOTS_TOTAL, ctx->metrics.slots_total );
   FD_MCNT_SET( REPLAY, TRANSACTIONS_TOTAL, ctx->metrics.transactions_total );
+  FD_MCNT_SET( REPLAY, DUPLICATE_FEC_SETS, ctx->metrics.duplicate_fec_sets );
 }
 
-static inline ulong
-generate_stake_weight_msg( ulong                       epoch,
-                           fd_epoch_schedule_t const * epoch_schedule,
-                           fd_vote_states_t const *    epoch_stakes,
-                           ulong *                     stake_weight_msg_out ) {
-  fd_stake_weight_msg_t *  stake_weight_msg = (fd_stake_weight_msg_t *)fd_type_pun( stake_weight_msg_out );
-  fd_vote_stake_weight_t * stake_weights    = stake_weight_msg->weights;
-
+static inline void
+generate_stake_weight_msg_hdr( ulong                       epoch,
+                               fd_epoch_schedule_t const * epoch_schedule,
+                               fd_stake_weight_msg_t *     stake_weight_msg ) {
   stake_weight_msg->epoch             = epoch;
   stake_weight_msg->start_slot        = fd_epoch_slot0( epoch_schedule, epoch );
   stake_weight_msg->slot_cnt          = epoch_schedule->slots_per_epoch;
@@ -485,6 +554,17 @@ generate_stake_weight_msg( ulong                       epoch,
       (0==epoch_schedule->warmup && epoch<FD_SIMD0180_ACTIVE_EPOCH_MAINNET) ) {
     stake_weight_msg->vote_keyed_lsched = 0UL;
   }
+}
+
+static inline ulong
+generate_stake_weight_msg( ulong                       epoch,
+                           fd_epoch_schedule_t const * epoch_schedule,
+                           fd_vote_states_t const *    epoch_stakes,
+                           ulong *                     stake_weight_msg_out ) {
+  fd_stake_weight_msg_t *  stake_weight_msg = (fd_stake_weight_msg_t *)fd_type_pun( stake_weight_msg_out );
+  fd_vote_stake_weight_t * stake_weights    = stake_weight_msg->weights;
+
+  generate_stake_weight_msg_hdr( epoch, epoch_schedule, stake_weight_msg );
 
   /* epoch_stakes from manifest are already filtered (stake>0), but not sorted */
   fd_vote_states_iter_t iter_[1];
@@ -526,7 +606,94 @@ publish_stake_weights( fd_replay_tile_t *   ctx,
   else                             fd_bank_vote_states_prev_prev_end_locking_query( bank );
 
   fd_multi_epoch_leaders_stake_msg_init( ctx->mleaders, fd_type_pun_const( stake_weights_msg ) );
-  fd_multi_epoch_leaders_stake_msg_fini( ctx->mleaders );
+  if( fd_multi_epoch_leaders_stake_msg_fini( ctx->mleaders ) ) {
+    FD_LOG_NOTICE(( "epoch %lu leader schedule matched the staged one", epoch+fd_ulong_if( current_epoch, 1UL, 0UL ) ));
+  }
+}
+
+/* begin_stake_stage starts projecting the stake weights message that
+   the next epoch boundary will publish (see publish_stake_weights) from
+   the published root bank.  The stake delegations are walked by
+   step_stake_stage a few chains at a time, and publish_stake_stage
+   stages the leader schedule of the result and publishes it on
+   replay_stage so the Shred tiles can stage their shred destinations.
+   If nothing that affects stakes changes until the boundary, the
+   boundary only has to confirm that the messages are identical (see
+   fd_multi_epoch_leaders_stake_msg_stage_init).  The walk reads the
+   rooted stake delegations, so roots published while it is in progress
+   can leave it with a mix of root states; the boundary then simply
+   finds that the messages differ. */
+
+static void
+begin_stake_stage( fd_replay_tile_t * ctx ) {
+  ctx->stake_stage_pending = 0;
+
+  fd_bank_t * bank = fd_banks_bank_query( ctx->banks, ctx->published_root_bank_idx );
+  if( FD_UNLIKELY( !bank ) ) FD_LOG_CRIT(( "invariant violation: root bank not found for bank index %lu", ctx->published_root_bank_idx ));
+
+  fd_epoch_schedule_t const * schedule = fd_bank_epoch_schedule_query( bank );
+  ulong slot  = fd_bank_slot_get( bank );
+  ulong epoch = fd_slot_to_epoch( schedule, slot, NULL );
+  ctx->stake_stage_epoch = epoch+2UL;
+
+  fd_stake_history_t stake_history[1];
+  if( FD_UNLIKELY( !fd_sysvar_stake_history_read( ctx->accdb->funk, fd_funk_last_publish( ctx->accdb->funk ), stake_history ) ) ) {
+    FD_LOG_WARNING(( "StakeHistory sysvar is missing at root slot %lu, not staging epoch %lu stake weights", slot, epoch+2UL ));
+    return;
+  }
+
+  int   err;
+  ulong new_rate_activation_epoch = 0UL;
+  int   is_some = fd_new_warmup_cooldown_rate_epoch( schedule, fd_bank_features_query( bank ), slot, &new_rate_activation_epoch, &err );
+
+  fd_vote_states_t const * vote_states = fd_bank_vote_states_locking_query( bank );
+  int fits = fd_vote_states_cnt( vote_states )<=FD_RUNTIME_MAX_VOTE_ACCOUNTS;
+  if( FD_LIKELY( fits ) ) {
+    fd_stakes_projection_init( ctx->stake_stage_proj, vote_states, stake_history, epoch, is_some ? &new_rate_activation_epoch : NULL,
+                               ctx->runtime_stack.stakes.stake_weights );
+  }
+  fd_bank_vote_states_end_locking_query( bank );
+  if( FD_UNLIKELY( !fits ) ) return;
+
+  ctx->stake_stage_walking = 1;
+  ctx->stake_stage_slot    = slot;
+  ctx->stake_stage_start   = fd_log_wallclock();
+}
+
+/* step_stake_stage walks the next FD_REPLAY_STAKE_STAGE_CHAIN_CNT
+   chains of the rooted stake delegations.  Returns 1 once the walk is
+   done. */
+
+static int
+step_stake_stage( fd_replay_tile_t * ctx ) {
+  return fd_stakes_projection_step( ctx->stake_stage_proj, fd_banks_stake_delegations_root_query( ctx->banks ), FD_REPLAY_STAKE_STAGE_CHAIN_CNT );
+}
+
+static void
+publish_stake_stage( fd_replay_tile_t *  ctx,
+                     fd_stem_context_t * stem ) {
+  ctx->stake_stage_walking = 0;
+
+  ulong staked_cnt = fd_stakes_projection_fini( ctx->stake_stage_proj );
+  if( FD_UNLIKELY( !staked_cnt || staked_cnt>MAX_STAKED_LEADERS ) ) return;
+
+  fd_bank_t * bank = fd_banks_bank_query( ctx->banks, ctx->published_root_bank_idx );
+  if( FD_UNLIKELY( !bank ) ) FD_LOG_CRIT(( "invariant violation: root bank not found for bank index %lu", ctx->published_root_bank_idx ));
+
+  fd_stake_weight_msg_t * msg = fd_chunk_to_laddr( ctx->stage_out->mem, ctx->stage_out->chunk );
+  generate_stake_weight_msg_hdr( ctx->stake_stage_epoch, fd_bank_epoch_schedule_query( bank ), msg );
+  fd_memcpy( msg->weights, ctx->runtime_stack.stakes.stake_weights, staked_cnt*sizeof(fd_vote_stake_weight_t) );
+  msg->staked_cnt = staked_cnt;
+
+  ulong msg_sz = fd_stake_weight_msg_sz( staked_cnt );
+  fd_stem_publish( stem, ctx->stage_out->idx, 4UL, ctx->stage_out->chunk, msg_sz, 0UL, 0UL, fd_frag_meta_ts_comp( fd_tickcount() ) );
+  ctx->stage_out->chunk = fd_dcache_compact_next( ctx->stage_out->chunk, msg_sz, ctx->stage_out->chunk0, ctx->stage_out->wmark );
+
+  fd_multi_epoch_leaders_stake_msg_stage_init( ctx->mleaders, msg );
+  fd_multi_epoch_leaders_stake_msg_stage_fini( ctx->mleaders );
+
+  FD_LOG_NOTICE(( "staged epoch %lu stake weights (%lu staked vote accounts) from root slot %lu in %.2f ms",
+                  ctx->stake_stage_epoch, staked_cnt, ctx->stake_stage_slot, (double)(fd_log_wallclock()-ctx->stake_stage_start)/1e6 ));
 }
 
 /**********************************************************************/
@@ -730,6 +897,7 @@ replay_block_start( fd_replay_tile_t *  ctx,
       &xid,
       ctx->capture_ctx,
       &ctx->runtime_stack,
+      NULL, 0UL, 1UL,
       &is_epoch_boundary );
   if( FD_UNLIKELY( is_epoch_boundary ) ) publish_stake_weights( ctx, stem, bank, 1 );
 
@@ -969,6 +1137,7 @@ prepare_leader_bank( fd_replay_tile_t *  ctx,
       &xid,
       ctx->capture_ctx,
       &ctx->runtime_stack,
+      NULL, 0UL, 1UL,
       &is_epoch_boundary );
   if( FD_UNLIKELY( is_epoch_boundary ) ) publish_stake_weights( ctx, stem, ctx->leader_bank, 1 );
 
@@ -995,6 +1164,7 @@ fini_leader_bank( fd_replay_tile_t *  ctx,
   ulong curr_slot = fd_bank_slot_get( ctx->leader_bank );
 
   fd_sched_block_add_done( ctx->sched, ctx->leader_bank->idx, ctx->leader_bank->parent_idx, curr_slot );
+  *fd_sched_get_poh( ctx->sched, ctx->leader_bank->idx ) = *fd_bank_poh_query( ctx->leader_bank );
 
   /* Do hashing and other end-of-block processing */
   fd_funk_txn_map_t * txn_map = fd_funk_txn_map( ctx->accdb->funk );
@@ -1155,7 +1325,7 @@ init_after_snapshot( fd_replay_tile_t * ctx ) {
   /* After both snapshots have been loaded in, we can determine if we should
      start distributing rewards. */
 
-  fd_rewards_recalculate_partitioned_rewards( ctx->banks, bank, ctx->accdb->funk, &xid, &ctx->runtime_stack, ctx->capture_ctx );
+  fd_rewards_recalculate_partitioned_rewards( ctx->banks, bank, ctx->accdb->funk, &xid, &ctx->runtime_stack, ctx->capture_ctx, NULL, 0UL, 1UL );
 
   ulong snapshot_slot = fd_bank_slot_get( bank );
   if( FD_UNLIKELY( !snapshot_slot ) ) {
@@ -1434,16 +1604,17 @@ boot_genesis( fd_replay_tile_t *  ctx,
 
   /* Initialize store for genesis case, similar to snapshot case */
   fd_hash_t genesis_block_id = { .ul[0] = FD_RUNTIME_INITIAL_BLOCK_ID };
-  fd_store_exacq( ctx->store );
+  fd_store_shacq( ctx->store, fd_store_pub_part( ctx->store ) );
   if( FD_UNLIKELY( fd_store_root( ctx->store ) ) ) {
     FD_LOG_CRIT(( "invariant violation: store root is not 0 for genesis" ));
   }
-  fd_store_insert( ctx->store, 0, &genesis_block_id );
+  fd_store_insert( ctx->store, fd_store_pub_part( ctx->store ), &genesis_block_id );
   ctx->store->slot0 = 0UL; /* Genesis slot */
-  fd_store_exrel( ctx->store );
+  fd_store_shrel( ctx->store, fd_store_pub_part( ctx->store ) );
 
   ctx->published_root_slot = 0UL;
   fd_sched_block_add_done( ctx->sched, bank->idx, ULONG_MAX, 0UL );
+  *fd_sched_get_poh( ctx->sched, bank->idx ) = *fd_bank_poh_query( bank );
 
   fd_bank_block_height_set( bank, 1UL );
 
@@ -1528,11 +1699,11 @@ on_snapshot_message( fd_replay_tile_t *  ctx,
        the block id of the snapshot slot from repair. */
     fd_hash_t manifest_block_id = { .ul = { FD_RUNTIME_INITIAL_BLOCK_ID } };
 
-    fd_store_exacq( ctx->store );
+    fd_store_shacq( ctx->store, fd_store_pub_part( ctx->store ) );
     FD_TEST( !fd_store_root( ctx->store ) );
-    fd_store_insert( ctx->store, 0, &manifest_block_id );
+    fd_store_insert( ctx->store, fd_store_pub_part( ctx->store ), &manifest_block_id );
     ctx->store->slot0 = snapshot_slot; /* FIXME manifest_block_id */
-    fd_store_exrel( ctx->store );
+    fd_store_shrel( ctx->store, fd_store_pub_part( ctx->store ) );
 
     /* Typically, when we cross an epoch boundary during normal
        operation, we publish the stake weights for the new epoch.  But
@@ -1560,6 +1731,7 @@ on_snapshot_message( fd_replay_tile_t *  ctx,
     }
 
     fd_sched_block_add_done( ctx->sched, bank->idx, ULONG_MAX, snapshot_slot );
+    *fd_sched_get_poh( ctx->sched, bank->idx ) = *fd_bank_poh_query( bank );
     FD_TEST( bank->idx==0UL );
 
     fd_funk_txn_xid_t xid = { .ul = { snapshot_slot, FD_REPLAY_BOOT_BANK_IDX } };
@@ -1669,6 +1841,21 @@ dispatch_task( fd_replay_tile_t *  ctx,
       exec_out->chunk = fd_dcache_compact_next( exec_out->chunk, sizeof(*exec_msg), exec_out->chunk0, exec_out->wmark );
       break;
     };
+    case FD_SCHED_TT_POH_VERIFY: {
+      fd_bank_t * bank = fd_banks_bank_query( ctx->banks, task->poh_verify->bank_idx );
+      bank->refcnt++;
+
+      fd_replay_out_link_t *     exec_out = ctx->exec_out;
+      fd_exec_poh_verify_msg_t * exec_msg = fd_chunk_to_laddr( exec_out->mem, exec_out->chunk );
+      exec_msg->bank_idx  = task->poh_verify->bank_idx;
+      exec_msg->entry_idx = task->poh_verify->entry_idx;
+      exec_msg->entry_cnt = task->poh_verify->entry_cnt;
+      memcpy( exec_msg->start, task->poh_verify->start.hash, sizeof(exec_msg->start) );
+      memcpy( exec_msg->entry, task->poh_verify->entry, task->poh_verify->entry_cnt*sizeof(fd_poh_entry_t) );
+      fd_stem_publish( stem, exec_out->idx, (FD_EXEC_TT_POH_VERIFY<<32) | task->poh_verify->exec_idx, exec_out->chunk, sizeof(*exec_msg), 0UL, 0UL, 0UL );
+      exec_out->chunk = fd_dcache_compact_next( exec_out->chunk, sizeof(*exec_msg), exec_out->chunk0, exec_out->wmark );
+      break;
+    }
     default: {
       FD_LOG_CRIT(( "unexpected task type %lu", task->task_type ));
     }
@@ -1703,7 +1890,8 @@ replay( fd_replay_tile_t *  ctx,
       break;
     }
     case FD_SCHED_TT_TXN_EXEC:
-    case FD_SCHED_TT_TXN_SIGVERIFY: {
+    case FD_SCHED_TT_TXN_SIGVERIFY:
+    case FD_SCHED_TT_POH_VERIFY: {
       /* Likely/common case: we have a transaction we actually need to
          execute. */
       dispatch_task( ctx, stem, task );
@@ -1722,13 +1910,24 @@ process_fec_set( fd_replay_tile_t * ctx,
                  fd_reasm_fec_t *   reasm_fec ) {
   long now = fd_log_wallclock();
 
-  /* Linking only requires a shared lock because the fields that are
-     modified are only read on publish which uses exclusive lock. */
+  /* Linking is safe concurrently with Shred tiles because the fields
+     that are modified are only read on publish, which is done by this
+     tile. */
 
   long shacq_start, shacq_end, shrel_end;
 
-  FD_STORE_SHARED_LOCK( ctx->store, shacq_start, shacq_end, shrel_end ) {
-    if( FD_UNLIKELY( !fd_store_link( ctx->store, &reasm_fec->key, &reasm_fec->cmr ) ) ) FD_LOG_WARNING(( "failed to link %s %s. slot %lu fec_set_idx %u", FD_BASE58_ENC_32_ALLOCA( &reasm_fec->key ), FD_BASE58_ENC_32_ALLOCA( &reasm_fec->cmr ), reasm_fec->slot, reasm_fec->fec_set_idx ));
+  FD_STORE_SHARED_LOCK( ctx->store, fd_store_pub_part( ctx->store ), shacq_start, shacq_end, shrel_end ) {
+    fd_store_fec_t * store_fec = fd_store_link( ctx->store, &reasm_fec->key, &reasm_fec->cmr );
+    if( FD_UNLIKELY( !store_fec ) ) {
+      FD_LOG_WARNING(( "failed to link %s %s. slot %lu fec_set_idx %u", FD_BASE58_ENC_32_ALLOCA( &reasm_fec->key ), FD_BASE58_ENC_32_ALLOCA( &reasm_fec->cmr ), reasm_fec->slot, reasm_fec->fec_set_idx ));
+    } else {
+      store_fec->slot          = reasm_fec->slot;
+      store_fec->fec_set_idx   = reasm_fec->fec_set_idx;
+      store_fec->parent_off    = reasm_fec->parent_off;
+      store_fec->data_cnt      = reasm_fec->data_cnt;
+      store_fec->data_complete = (uchar)!!reasm_fec->data_complete;
+      store_fec->slot_complete = (uchar)!!reasm_fec->slot_complete;
+    }
   } FD_STORE_SHARED_LOCK_END;
   fd_histf_sample( ctx->metrics.store_link_wait, (ulong)fd_long_max( shacq_end - shacq_start, 0L ) );
   fd_histf_sample( ctx->metrics.store_link_work, (ulong)fd_long_max( shrel_end - shacq_end,   0L ) );
@@ -1800,7 +1999,7 @@ process_fec_set( fd_replay_tile_t * ctx,
      during publishing.  A query against store will rightfully tell us
      that the underlying data is not found, implying that this is for a
      minority fork that we can safely ignore. */
-  FD_STORE_SHARED_LOCK( ctx->store, shacq_start, shacq_end, shrel_end ) {
+  FD_STORE_SHARED_LOCK( ctx->store, fd_store_pub_part( ctx->store ), shacq_start, shacq_end, shrel_end ) {
     fd_store_fec_t * store_fec = fd_store_query( ctx->store, &reasm_fec->key );
     if( FD_UNLIKELY( !store_fec ) ) {
       /* The only case in which a FEC is not found in the store after
@@ -1848,6 +2047,37 @@ funk_publish( fd_replay_tile_t * ctx,
   fd_progcache_txn_advance_root( ctx->progcache_admin, &xid );
 }
 
+/* store_publish advances the store root to root.  This is safe
+   concurrently with Shred tiles because the tree pointers are only read
+   and modified on link and publish (both done by this tile) and spill
+   (done by the ledger tile while no publish is in flight), and publish
+   defers removing pruned FEC sets to the Shred tiles that inserted them
+   (see fd_store.h). */
+
+static void
+store_publish( fd_replay_tile_t * ctx,
+               fd_hash_t const *  root ) {
+  long shacq_start, shacq_end, shrel_end;
+  FD_STORE_SHARED_LOCK( ctx->store, fd_store_pub_part( ctx->store ), shacq_start, shacq_end, shrel_end ) {
+    fd_store_publish( ctx->store, root );
+  } FD_STORE_SHARED_LOCK_END;
+
+  fd_histf_sample( ctx->metrics.store_publish_wait, (ulong)fd_long_max( shacq_end-shacq_start, 0UL ) );
+  fd_histf_sample( ctx->metrics.store_publish_work, (ulong)fd_long_max( shrel_end-shacq_end,   0UL ) );
+}
+
+static void
+publish_store_spill( fd_replay_tile_t *  ctx,
+                     fd_stem_context_t * stem ) {
+  fd_hash_t * msg = fd_chunk_to_laddr( ctx->ledger_out->mem, ctx->ledger_out->chunk );
+  *msg = ctx->store_spill_root;
+  fd_stem_publish( stem, ctx->ledger_out->idx, 0UL, ctx->ledger_out->chunk, sizeof(fd_hash_t), 0UL, 0UL, fd_frag_meta_ts_comp( fd_tickcount() ) );
+  ctx->ledger_out->chunk = fd_dcache_compact_next( ctx->ledger_out->chunk, sizeof(fd_hash_t), ctx->ledger_out->chunk0, ctx->ledger_out->wmark );
+
+  ctx->store_spill_pending  = 0;
+  ctx->store_spill_inflight = 1;
+}
+
 static int
 advance_published_root( fd_replay_tile_t * ctx ) {
 
@@ -1878,13 +2108,17 @@ advance_published_root( fd_replay_tile_t * ctx ) {
     FD_LOG_CRIT(( "invariant violation: advanceable root ele not found for bank index %lu", advanceable_root_idx ));
   }
 
-  long exacq_start, exacq_end, exrel_end;
-  FD_STORE_EXCLUSIVE_LOCK( ctx->store, exacq_start, exacq_end, exrel_end ) {
-    fd_store_publish( ctx->store, &advanceable_root_ele->block_id );
-  } FD_STORE_EXCLUSIVE_LOCK_END;
+  /* If the ledger tile is enabled, the store root only advances once
+     the FEC sets that become rooted have been spilled to the ledger
+     (see fd_ledger_tile.c).  At most one spill is in flight, so the
+     latest requested root replaces any request not yet sent. */
 
-  fd_histf_sample( ctx->metrics.store_publish_wait, (ulong)fd_long_max( exacq_end-exacq_start, 0UL ) );
-  fd_histf_sample( ctx->metrics.store_publish_work, (ulong)fd_long_max( exrel_end-exacq_end,   0UL ) );
+  if( FD_UNLIKELY( ctx->ledger_out->idx!=ULONG_MAX ) ) {
+    ctx->store_spill_root    = advanceable_root_ele->block_id;
+    ctx->store_spill_pending = 1;
+  } else {
+    store_publish( ctx, &advanceable_root_ele->block_id );
+  }
 
   ulong advanceable_root_slot = fd_bank_slot_get( bank );
   funk_publish( ctx, advanceable_root_slot, bank->idx );
@@ -1897,6 +2131,15 @@ advance_published_root( fd_replay_tile_t * ctx ) {
   ctx->published_root_slot     = advanceable_root_slot;
   ctx->published_root_bank_idx = advanceable_root_idx;
 
+  if( FD_UNLIKELY( ctx->stage_out->idx!=ULONG_MAX ) ) {
+    fd_epoch_schedule_t const * schedule = fd_bank_epoch_schedule_query( bank );
+    ulong slot_idx;
+    ulong epoch = fd_slot_to_epoch( schedule, advanceable_root_slot, &slot_idx );
+    if( FD_UNLIKELY( ctx->stake_stage_epoch!=epoch+2UL && slot_idx+FD_REPLAY_STAKE_STAGE_SLOTS>=fd_epoch_slot_cnt( schedule, epoch ) ) ) {
+      ctx->stake_stage_pending = 1;
+    }
+  }
+
   return 1;
 }
 
@@ -1989,6 +2232,22 @@ after_credit( fd_replay_tile_t *  ctx,
     return;
   }
 
+  if( FD_UNLIKELY( ctx->stake_stage_pending ) ) {
+    begin_stake_stage( ctx );
+    *charge_busy = 1;
+    *opt_poll_in = 0;
+    return;
+  }
+
+  /* If a new store root is waiting to be spilled and the previous
+     spill has been acknowledged, ask the ledger tile to spill it. */
+  if( FD_UNLIKELY( ctx->store_spill_pending && !ctx->store_spill_inflight ) ) {
+    publish_store_spill( ctx, stem );
+    *charge_busy = 1;
+    *opt_poll_in = 0;
+    return;
+  }
+
   /* If the published_root is not caught up to the consensus root, then
      we should try to advance the published root. */
   if( FD_UNLIKELY( ctx->consensus_root_bank_idx!=ctx->published_root_bank_idx && advance_published_root( ctx ) ) ) {
@@ -1999,6 +2258,13 @@ after_credit( fd_replay_tile_t *  ctx,
 
   *charge_busy = replay( ctx, stem );
   *opt_poll_in = !*charge_busy;
+
+  /* Walk a few more chains of the staged stake weights projection
+     alongside replay, rather than ahead of it. */
+  if( FD_UNLIKELY( ctx->stake_stage_walking ) ) {
+    if( step_stake_stage( ctx ) ) publish_stake_stage( ctx, stem );
+    *charge_busy = 1;
+  }
 }
 
 static int
@@ -2007,10 +2273,10 @@ before_frag( fd_replay_tile_t * ctx,
              ulong              seq FD_PARAM_UNUSED,
              ulong              sig FD_PARAM_UNUSED ) {
 
-  if( FD_UNLIKELY( ctx->in_kind[ in_idx ]==IN_KIND_SHRED ) ) {
+  if( FD_UNLIKELY( ctx->in_kind[ in_idx ]==IN_KIND_SHRED || ctx->in_kind[ in_idx ]==IN_KIND_LEDGER ) ) {
     /* If reasm is full, we can not insert any more FEC sets.  We must
-       not consume any frags from shred_out until reasm can process more
-       FEC sets. */
+       not consume any frags from shred_out (or FEC sets read back from
+       the ledger) until reasm can process more FEC sets. */
 
     if( FD_UNLIKELY( !fd_reasm_free( ctx->reasm ) ) ) {
       return -1;
@@ -2074,6 +2340,7 @@ process_exec_task_done( fd_replay_tile_t *        ctx,
       if( FD_UNLIKELY( (bank->flags&FD_BANK_FLAGS_DEAD) && bank->refcnt==0UL ) ) {
         fd_banks_mark_bank_frozen( ctx->banks, bank );
       }
+      fd_sched_txn_exec_cus( ctx->sched, msg->txn_exec->txn_idx, msg->txn_exec->cus );
       fd_sched_task_done( ctx->sched, FD_SCHED_TT_TXN_EXEC, msg->txn_exec->txn_idx, exec_tile_idx );
       break;
     }
@@ -2091,6 +2358,21 @@ process_exec_task_done( fd_replay_tile_t *        ctx,
       fd_sched_task_done( ctx->sched, FD_SCHED_TT_TXN_SIGVERIFY, msg->txn_sigverify->txn_idx, exec_tile_idx );
       break;
     }
+    case FD_EXEC_TT_POH_VERIFY: {
+      if( FD_UNLIKELY( msg->poh_verify->bad_idx!=ULONG_MAX && !(bank->flags&FD_BANK_FLAGS_DEAD) ) ) {
+        /* Every entry in a valid block has to extend the PoH chain.
+           Otherwise, we should mark the block as dead.  Also freeze the
+           bank if possible. */
+        FD_LOG_WARNING(( "PoH verify failed at entry %lu, slot %lu", msg->poh_verify->bad_idx, fd_bank_slot_get( bank ) ));
+        fd_banks_mark_bank_dead( ctx->banks, bank );
+        fd_sched_block_abandon( ctx->sched, bank->idx );
+      }
+      if( FD_UNLIKELY( (bank->flags&FD_BANK_FLAGS_DEAD) && bank->refcnt==0UL ) ) {
+        fd_banks_mark_bank_frozen( ctx->banks, bank );
+      }
+      fd_sched_task_done( ctx->sched, FD_SCHED_TT_POH_VERIFY, ULONG_MAX, exec_tile_idx );
+      break;
+    }
     default: FD_LOG_CRIT(( "unexpected sig 0x%lx", sig ));
   }
 
@@ -2203,7 +2485,13 @@ process_fec_complete( fd_replay_tile_t * ctx,
   int data_complete = !!( shred->data.flags & FD_SHRED_DATA_FLAG_DATA_COMPLETE );
   int slot_complete = !!( shred->data.flags & FD_SHRED_DATA_FLAG_SLOT_COMPLETE );
 
-  FD_TEST( !fd_reasm_query( ctx->reasm, merkle_root ) );
+  /* FEC sets read back from the ledger on restart can race the same
+     FEC sets arriving from the network (see fd_ledger_tile.c). */
+
+  if( FD_UNLIKELY( fd_reasm_query( ctx->reasm, merkle_root ) ) ) {
+    ctx->metrics.duplicate_fec_sets++;
+    return;
+  }
   if( FD_UNLIKELY( shred->slot - shred->data.parent_off == fd_reasm_slot0( ctx->reasm ) && shred->fec_set_idx == 0) ) {
     chained_merkle_root = &fd_reasm_root( ctx->reasm )->key;
   }
@@ -2360,6 +2648,17 @@ returnable_frag( fd_replay_tile_t *  ctx,
       }
       break;
     }
+    case IN_KIND_LEDGER: {
+      if( FD_LIKELY( sig==FD_LEDGER_SIG_FEC_COMPLETE ) ) {
+        if( FD_UNLIKELY( sz!=FD_SHRED_OUT_MTU ) ) FD_LOG_ERR(( "unexpected FEC complete message sz %lu from ledger", sz ));
+        process_fec_complete( ctx, fd_chunk_to_laddr( ctx->in[ in_idx ].mem, chunk ) );
+      } else if( FD_LIKELY( sig==FD_LEDGER_SIG_SPILLED ) ) {
+        FD_TEST( ctx->store_spill_inflight );
+        store_publish( ctx, fd_chunk_to_laddr_const( ctx->in[ in_idx ].mem, chunk ) );
+        ctx->store_spill_inflight = 0;
+      }
+      break;
+    }
     case IN_KIND_VTXN: {
       process_vote_txn_sent( ctx, fd_chunk_to_laddr( ctx->in[ in_idx ].mem, chunk ) );
       break;
@@ -2421,6 +2720,26 @@ privileged_init( fd_topo_t *      topo,
       fd_memcpy( ctx->bundle.vote_account.uc, vote_key, 32UL );
     }
   }
+
+  /* Map the accounts file before sandboxing, the fd is not needed
+     afterwards. */
+
+  ctx->vinyl_map    = NULL;
+  ctx->vinyl_map_sz = 0UL;
+  if( FD_UNLIKELY( tile->replay.vinyl_path[0] ) ) {
+    char const * path = tile->replay.vinyl_path;
+    int fd = open( path, O_RDONLY|O_CLOEXEC );
+    if( FD_UNLIKELY( -1==fd ) ) FD_LOG_ERR(( "open(%s,O_RDONLY|O_CLOEXEC) failed (%i-%s)", path, errno, fd_io_strerror( errno ) ));
+    struct stat st;
+    if( FD_UNLIKELY( fstat( fd, &st ) ) ) FD_LOG_ERR(( "fstat(%s) failed (%i-%s)", path, errno, fd_io_strerror( errno ) ));
+    ulong map_sz = fd_ulong_align_dn( (ulong)st.st_size, FD_VINYL_BSTREAM_BLOCK_SZ );
+    if( FD_UNLIKELY( map_sz<=FD_VINYL_BSTREAM_BLOCK_SZ ) ) FD_LOG_ERR(( "accounts file %s is too small", path ));
+    void * map = mmap( NULL, map_sz, PROT_READ, MAP_SHARED, fd, 0 );
+    if( FD_UNLIKELY( map==MAP_FAILED ) ) FD_LOG_ERR(( "mmap(%s,%lu) failed (%i-%s)", path, map_sz, errno, fd_io_strerror( errno ) ));
+    if( FD_UNLIKELY( close( fd ) ) ) FD_LOG_ERR(( "close(%s) failed (%i-%s)", path, errno, fd_io_strerror( errno ) ));
+    ctx->vinyl_map    = map;
+    ctx->vinyl_map_sz = map_sz;
+  }
 }
 
 static void
@@ -2443,6 +2762,10 @@ unprivileged_init( fd_topo_t *      topo,
   if( FD_UNLIKELY( tile->replay.dump_block_to_pb ) ) {
     block_dump_ctx = FD_SCRATCH_ALLOC_APPEND( l, fd_block_dump_context_align(), fd_block_dump_context_footprint() );
   }
+  void * vinyl_scratch     = NULL;
+  if( FD_UNLIKELY( tile->replay.vinyl_path[0] ) ) {
+    vinyl_scratch = FD_SCRATCH_ALLOC_APPEND( l, alignof(fd_account_meta_t), VINYL_SCRATCH_SZ );
+  }
 
   ulong store_obj_id = fd_pod_query_ulong( topo->props, "store", ULONG_MAX );
   FD_TEST( store_obj_id!=ULONG_MAX );
@@ -2548,6 +2871,7 @@ unprivileged_init( fd_topo_t *      topo,
 
   ctx->sched = fd_sched_join( fd_sched_new( sched_mem, tile->replay.max_live_slots, ctx->exec_cnt ), tile->replay.max_live_slots );
   FD_TEST( ctx->sched );
+  if( FD_UNLIKELY( fd_sched_set_priority( ctx->sched, tile->replay.sched_priority ) ) ) FD_LOG_ERR(( "invalid sched_priority %d", tile->replay.sched_priority ));
 
   ctx->enable_bank_hash_cmp = !!tile->replay.enable_bank_hash_cmp;
 
@@ -2610,11 +2934,49 @@ unprivileged_init( fd_topo_t *      topo,
     else if( !strcmp( link->name, "shred_out"    ) ) ctx->in_kind[ i ] = IN_KIND_SHRED;
     else if( !strcmp( link->name, "send_out"     ) ) ctx->in_kind[ i ] = IN_KIND_VTXN;
     else if( !strcmp( link->name, "gui_replay"   ) ) ctx->in_kind[ i ] = IN_KIND_GUI;
+    else if( !strcmp( link->name, "ledger_out"   ) ) ctx->in_kind[ i ] = IN_KIND_LEDGER;
+    else if( !strcmp( link->name, "vinyl_replay" ) ) ctx->in_kind[ i ] = IN_KIND_VINYL;
     else FD_LOG_ERR(( "unexpected input link name %s", link->name ));
   }
 
   *ctx->stake_out  = out1( topo, tile, "replay_stake" ); FD_TEST( ctx->stake_out->idx!=ULONG_MAX );
   *ctx->replay_out = out1( topo, tile, "replay_out" ); FD_TEST( ctx->replay_out->idx!=ULONG_MAX );
+  *ctx->ledger_out = out1( topo, tile, "replay_ledgr" ); /* optional */
+  *ctx->stage_out  = out1( topo, tile, "replay_stage" ); /* optional */
+
+  ctx->stake_stage_pending = 0;
+  ctx->stake_stage_walking = 0;
+  ctx->stake_stage_epoch   = ULONG_MAX;
+
+  ctx->store_spill_pending  = 0;
+  ctx->store_spill_inflight = 0;
+
+  /* The bstream store follows the sync block in the accounts file (see
+     fd_vinyl_io_bd).  Replay publishes requests on replay_vinyl
+     directly (not through stem) and reads completions from the
+     unpolled vinyl_replay link, one request at a time. */
+
+  if( FD_UNLIKELY( ctx->vinyl_map ) ) {
+    ulong rq_idx = fd_topo_find_tile_out_link( topo, tile, "replay_vinyl", 0UL );
+    ulong cq_idx = fd_topo_find_tile_in_link ( topo, tile, "vinyl_replay", 0UL );
+    if( FD_UNLIKELY( rq_idx==ULONG_MAX || cq_idx==ULONG_MAX ) ) FD_LOG_ERR(( "vinyl_path is set but replay has no replay_vinyl / vinyl_replay links" ));
+    fd_topo_link_t const * rq_link = &topo->links[ tile->out_link_id[ rq_idx ] ];
+    fd_topo_link_t const * cq_link = &topo->links[ tile->in_link_id [ cq_idx ] ];
+    FD_TEST( fd_vinyl_client_init( ctx->vinyl_client,
+                                   rq_link->mcache, rq_link->dcache, topo->workspaces[ topo->objs[ rq_link->dcache_obj_id ].wksp_id ].wksp,
+                                   cq_link->mcache,                  topo->workspaces[ topo->objs[ cq_link->dcache_obj_id ].wksp_id ].wksp ) );
+
+    FD_TEST( fd_vinyl_meta_join( ctx->vinyl_meta,
+                                 fd_topo_obj_laddr( topo, tile->replay.vinyl_meta_map_obj_id  ),
+                                 fd_topo_obj_laddr( topo, tile->replay.vinyl_meta_pool_obj_id ) ) );
+    FD_TEST( fd_accdb_admin_vinyl_attach_client( ctx->accdb_admin, ctx->vinyl_client,
+                                                 fd_topo_obj_laddr( topo, tile->replay.vinyl_data_obj_id ),
+                                                 tile->replay.vinyl_line_cnt, tile->replay.vinyl_val_max ) );
+    FD_TEST( fd_accdb_user_vinyl_attach( ctx->accdb, ctx->vinyl_meta,
+                                         (uchar const *)ctx->vinyl_map + FD_VINYL_BSTREAM_BLOCK_SZ,
+                                         ctx->vinyl_map_sz - FD_VINYL_BSTREAM_BLOCK_SZ,
+                                         vinyl_scratch, VINYL_SCRATCH_SZ ) );
+  }
 
   ulong idx = fd_topo_find_tile_out_link( topo, tile, "replay_exec", 0UL );
   FD_TEST( idx!=ULONG_MAX );
@@ -1,8 +1,10 @@
 #include "fd_sched.h"
 #include "../../disco/fd_disco_base.h" /* for FD_MAX_TXN_PER_SLOT */
 #include "../../flamenco/runtime/fd_runtime.h" /* for fd_runtime_load_txn_address_lookup_tables */
+#include "../../flamenco/accdb/fd_accdb_sync.h" /* for fd_accdb_prefetch */
 
 #include "../../flamenco/runtime/sysvar/fd_sysvar_slot_hashes.h" /* for ALUTs */
+#include "../../ballet/bmtree/fd_bmtree.h" /* for PoH mixins */
 
 
 #define FD_SCHED_MAX_DEPTH                 (FD_RDISP_MAX_DEPTH>>2)
@@ -25,6 +27,27 @@ FD_STATIC_ASSERT( FD_MAX_TXN_PER_SLOT_SHRED==((FD_SHRED_DATA_PAYLOAD_MAX_PER_SLO
 FD_STATIC_ASSERT( FD_TXN_MTU>=sizeof(fd_microblock_hdr_t), resize buffer for residual data );
 FD_STATIC_ASSERT( FD_TXN_MTU>=sizeof(ulong),               resize buffer for residual data );
 
+/* Parsed PoH entries that have yet to be dispatched for verification
+   are buffered in a per-block ring.  This is sized to hold all entries
+   of a typical mainnet block (64 ticks and a few hundred transaction
+   entries).  If the ring fills up, e.g. because the block isn't being
+   actively replayed, the oldest entries are verified inline on the
+   replay tile. */
+#define FD_SCHED_POH_ENTRY_MAX             (1024UL)
+FD_STATIC_ASSERT( (FD_SCHED_POH_ENTRY_MAX&(FD_SCHED_POH_ENTRY_MAX-1UL))==0UL, poh entry ring must be a power of 2 );
+FD_STATIC_ASSERT( FD_SCHED_POH_ENTRY_MAX>=FD_SCHED_POH_VERIFY_ENTRY_MAX, poh entry ring too small );
+#define FD_SCHED_POH_INLINE_VERIFY_CNT     (64UL) /* Number of entries to verify inline when the ring is full. */
+
+/* When the account database has a rooted tier on disk, the accounts of
+   each newly parsed transaction are prefetched (see fd_accdb_prefetch),
+   so that by the time the transaction is dispatched, the exec tile is
+   less likely to wait on a read from disk.  Hot accounts
+   (programs, sysvars, popular writable accounts) show up in many
+   transactions of a block, so a direct mapped filter of recently
+   prefetched accounts keeps the cost of this on the replay tile down. */
+#define FD_SCHED_PREFETCH_FILTER_CNT       (4096UL)
+FD_STATIC_ASSERT( (FD_SCHED_PREFETCH_FILTER_CNT&(FD_SCHED_PREFETCH_FILTER_CNT-1UL))==0UL, prefetch filter must be a power of 2 );
+
 #define FD_SCHED_MAGIC (0xace8a79c181f89b6UL) /* echo -n "fd_sched_v0" | sha512sum | head -c 16 */
 
 #define FD_SCHED_PARSER_OK          (0)
@@ -55,6 +78,18 @@ struct fd_sched_block {
   uint                txn_done_cnt; /* A transaction is considered done when all types of tasks associated with it are done. */
   ulong               txn_idx[ FD_MAX_TXN_PER_SLOT ]; /* Indexed by parse order. */
   uint                shred_cnt;
+  ulong               poh_parsed_cnt;           /* Number of entries parsed. */
+  ulong               poh_dispatched_cnt;       /* Number of entries dispatched for verification, in-flight or done. */
+  ulong               poh_done_cnt;             /* Number of entries verified. */
+  uint                poh_verify_in_flight_cnt; /* Number of in-flight PoH verify tasks. */
+
+  /* PoH verify state. */
+  fd_hash_t           poh_dispatch_start;                  /* PoH hash preceding the first undispatched entry. */
+  fd_poh_entry_t      poh_entry[ FD_SCHED_POH_ENTRY_MAX ]; /* Ring of undispatched entries, indexed by entry index modulo
+                                                              FD_SCHED_POH_ENTRY_MAX.  The entry at poh_parsed_cnt is the
+                                                              one being parsed. */
+  uchar               poh_bmtree[ FD_BMTREE_COMMIT_FOOTPRINT(0) ] __attribute__((aligned(FD_BMTREE_COMMIT_ALIGN)));
+                                                           /* Mixin of the entry being parsed. */
 
   /* Parser state. */
   uchar               txn[ FD_TXN_MAX_SZ ] __attribute__((aligned(alignof(fd_txn_t))));
@@ -114,6 +149,7 @@ struct fd_sched_metrics {
   uint  lane_demoted_cnt;
   uint  alut_success_cnt;
   uint  alut_serializing_cnt;
+  uint  poh_inline_verify_cnt;
   uint  txn_abandoned_parsed_cnt;
   uint  txn_abandoned_exec_done_cnt;
   uint  txn_abandoned_done_cnt;
@@ -125,6 +161,12 @@ struct fd_sched_metrics {
   ulong txn_exec_done_cnt;
   ulong txn_sigverify_done_cnt;
   ulong txn_done_cnt;
+  ulong poh_entry_parsed_cnt;
+  ulong poh_entry_verified_cnt;
+  ulong acct_prefetch_cnt;
+  ulong acct_prefetch_root_cnt;
+  ulong acct_prefetch_miss_cnt;
+  ulong acct_prefetch_dup_cnt;
   ulong bytes_ingested_cnt;
   ulong bytes_ingested_unparsed_cnt;
   ulong bytes_dropped_cnt;
@@ -142,6 +184,8 @@ struct fd_sched {
   fd_rdisp_t *        rdisp;
   ulong               txn_exec_ready_bitset[ 1 ];
   ulong               sigverify_ready_bitset[ 1 ];
+  ulong               poh_verify_bank_idx[ 64 ];  /* Indexed by exec tile, bank of the in-flight PoH verify task. */
+  ulong               poh_verify_entry_cnt[ 64 ]; /* Indexed by exec tile, entry count of the in-flight PoH verify task. */
   ulong               active_bank_idx; /* Index of the actively replayed block, or ULONG_MAX if no block is
                                           actively replayed; has to have a transaction to dispatch; staged
                                           blocks that have no transactions to dispatch are not eligible for
@@ -154,6 +198,8 @@ struct fd_sched {
   ulong               txn_to_bank_idx[ FD_SCHED_MAX_DEPTH ]; /* Index of the bank that the txn belongs to. */
   txn_bitset_t        exec_done_set[ txn_bitset_word_cnt ];      /* Indexed by txn_idx. */
   txn_bitset_t        sigverify_done_set[ txn_bitset_word_cnt ]; /* Indexed by txn_idx. */
+  ulong               prefetch_filter[ FD_SCHED_PREFETCH_FILTER_CNT ]; /* Tags of recently prefetched accounts, direct mapped, 0 if
+                                                                          empty. */
   fd_sched_block_t *  block_pool; /* Just a flat array. */
 };
 typedef struct fd_sched fd_sched_t;
@@ -172,6 +218,15 @@ fd_sched_parse( fd_sched_t * sched, fd_sched_block_t * block, fd_sched_alut_ctx_
 FD_WARN_UNUSED static int
 fd_sched_parse_txn( fd_sched_t * sched, fd_sched_block_t * block, fd_sched_alut_ctx_t * alut_ctx );
 
+static void
+prefetch_accts( fd_sched_t * sched, fd_sched_alut_ctx_t * alut_ctx, fd_acct_addr_t const * addr, ulong addr_cnt );
+
+static void
+poh_entry_push( fd_sched_t * sched, fd_sched_block_t * block );
+
+FD_WARN_UNUSED static int
+poh_verify_inline( fd_sched_t * sched, fd_sched_block_t * block );
+
 static void
 try_activate_block( fd_sched_t * sched );
 
@@ -208,7 +263,7 @@ block_is_void( fd_sched_block_t * block ) {
 
 static inline int
 block_should_signal_end( fd_sched_block_t * block ) {
-  return block->fec_eos && block->txn_parsed_cnt==block->txn_done_cnt && block->block_start_done && !block->block_end_signaled;
+  return block->fec_eos && block->txn_parsed_cnt==block->txn_done_cnt && block->poh_parsed_cnt==block->poh_done_cnt && block->block_start_done && !block->block_end_signaled;
 }
 
 static inline int
@@ -223,20 +278,31 @@ static inline int
 block_is_dispatchable( fd_sched_block_t * block ) {
   ulong exec_queued_cnt      = block->txn_parsed_cnt-block->txn_exec_in_flight_cnt-block->txn_exec_done_cnt;
   ulong sigverify_queued_cnt = block->txn_parsed_cnt-block->txn_sigverify_in_flight_cnt-block->txn_sigverify_done_cnt;
+  ulong poh_queued_cnt       = block->poh_parsed_cnt-block->poh_dispatched_cnt;
   return exec_queued_cnt>0UL ||
          sigverify_queued_cnt>0UL ||
+         poh_queued_cnt>0UL ||
          !block->block_start_signaled ||
          block_will_signal_end( block );
 }
 
 static inline int
 block_is_in_flight( fd_sched_block_t * block ) {
-  return block->txn_exec_in_flight_cnt || block->txn_sigverify_in_flight_cnt || (block->block_end_signaled && !block->block_end_done);
+  return block->txn_exec_in_flight_cnt || block->txn_sigverify_in_flight_cnt || block->poh_verify_in_flight_cnt || (block->block_end_signaled && !block->block_end_done);
 }
 
 static inline int
 block_is_done( fd_sched_block_t * block ) {
-  return block->fec_eos && block->txn_parsed_cnt==block->txn_done_cnt && block->block_start_done && block->block_end_done;
+  return block->fec_eos && block->txn_parsed_cnt==block->txn_done_cnt && block->poh_parsed_cnt==block->poh_done_cnt && block->block_start_done && block->block_end_done;
+}
+
+/* Should we dispatch a PoH verify task for the block?  Entries are
+   batched up to fill the SIMD lanes of an exec tile, unless there's
+   not going to be anything else to wait on. */
+static inline int
+block_should_dispatch_poh_verify( fd_sched_block_t * block ) {
+  ulong poh_queued_cnt = block->poh_parsed_cnt-block->poh_dispatched_cnt;
+  return poh_queued_cnt>=FD_SCHED_POH_VERIFY_ENTRY_MAX || (poh_queued_cnt>0UL && (block->fec_eos || !block_is_in_flight( block )));
 }
 
 static inline int
@@ -276,8 +342,8 @@ block_should_deactivate( fd_sched_block_t * block ) {
 
 FD_FN_UNUSED static void
 print_block( fd_sched_block_t * block ) {
-  FD_LOG_INFO(( "block slot %lu, parent_slot %lu, staged %d (lane %lu), dying %d, in_rdisp %d, fec_eos %d, rooted %d, block_start_signaled %d, block_end_signaled %d, block_start_done %d, block_end_done %d, txn_parsed_cnt %u, txn_exec_in_flight_cnt %u, txn_exec_done_cnt %u, txn_sigverify_in_flight_cnt %u, txn_sigverify_done_cnt %u, txn_done_cnt %u, shred_cnt %u, mblks_rem %lu, txns_rem %lu, fec_buf_sz %u, fec_buf_soff %u, fec_eob %d, fec_sob %d",
-                block->slot, block->parent_slot, block->staged, block->staging_lane, block->dying, block->in_rdisp, block->fec_eos, block->rooted, block->block_start_signaled, block->block_end_signaled, block->block_start_done, block->block_end_done, block->txn_parsed_cnt, block->txn_exec_in_flight_cnt, block->txn_exec_done_cnt, block->txn_sigverify_in_flight_cnt, block->txn_sigverify_done_cnt, block->txn_done_cnt, block->shred_cnt, block->mblks_rem, block->txns_rem, block->fec_buf_sz, block->fec_buf_soff, block->fec_eob, block->fec_sob ));
+  FD_LOG_INFO(( "block slot %lu, parent_slot %lu, staged %d (lane %lu), dying %d, in_rdisp %d, fec_eos %d, rooted %d, block_start_signaled %d, block_end_signaled %d, block_start_done %d, block_end_done %d, txn_parsed_cnt %u, txn_exec_in_flight_cnt %u, txn_exec_done_cnt %u, txn_sigverify_in_flight_cnt %u, txn_sigverify_done_cnt %u, txn_done_cnt %u, poh_parsed_cnt %lu, poh_dispatched_cnt %lu, poh_done_cnt %lu, poh_verify_in_flight_cnt %u, shred_cnt %u, mblks_rem %lu, txns_rem %lu, fec_buf_sz %u, fec_buf_soff %u, fec_eob %d, fec_sob %d",
+                block->slot, block->parent_slot, block->staged, block->staging_lane, block->dying, block->in_rdisp, block->fec_eos, block->rooted, block->block_start_signaled, block->block_end_signaled, block->block_start_done, block->block_end_done, block->txn_parsed_cnt, block->txn_exec_in_flight_cnt, block->txn_exec_done_cnt, block->txn_sigverify_in_flight_cnt, block->txn_sigverify_done_cnt, block->txn_done_cnt, block->poh_parsed_cnt, block->poh_dispatched_cnt, block->poh_done_cnt, block->poh_verify_in_flight_cnt, block->shred_cnt, block->mblks_rem, block->txns_rem, block->fec_buf_sz, block->fec_buf_soff, block->fec_eob, block->fec_sob ));
 }
 
 FD_FN_UNUSED static void
@@ -289,8 +355,8 @@ print_block_and_parent( fd_sched_t * sched, fd_sched_block_t * block ) {
 
 FD_FN_UNUSED static void
 print_metrics( fd_sched_t * sched ) {
-  FD_LOG_NOTICE(( "metrics: block_added_cnt %u, block_added_staged_cnt %u, block_added_unstaged_cnt %u, block_added_dead_ood_cnt %u, block_removed_cnt %u, block_abandoned_cnt %u, block_bad_cnt %u, block_promoted_cnt %u, block_demoted_cnt %u, deactivate_no_child_cnt %u, deactivate_no_txn_cnt %u, deactivate_pruned_cnt %u, deactivate_abandoned_cnt %u, lane_switch_cnt %u, lane_promoted_cnt %u, lane_demoted_cnt %u, alut_success_cnt %u, alut_serializing_cnt %u, txn_abandoned_parsed_cnt %u, txn_abandoned_done_cnt %u, txn_max_in_flight_cnt %u, txn_weighted_in_flight_cnt %lu, txn_weighted_in_flight_tickcount %lu, txn_none_in_flight_tickcount %lu, txn_parsed_cnt %lu, txn_exec_done_cnt %lu, txn_sigverify_done_cnt %lu, txn_done_cnt %lu, bytes_ingested_cnt %lu, bytes_ingested_unparsed_cnt %lu, bytes_dropped_cnt %lu, fec_cnt %lu",
-                  sched->metrics->block_added_cnt, sched->metrics->block_added_staged_cnt, sched->metrics->block_added_unstaged_cnt, sched->metrics->block_added_dead_ood_cnt, sched->metrics->block_removed_cnt, sched->metrics->block_abandoned_cnt, sched->metrics->block_bad_cnt, sched->metrics->block_promoted_cnt, sched->metrics->block_demoted_cnt, sched->metrics->deactivate_no_child_cnt, sched->metrics->deactivate_no_txn_cnt, sched->metrics->deactivate_pruned_cnt, sched->metrics->deactivate_abandoned_cnt, sched->metrics->lane_switch_cnt, sched->metrics->lane_promoted_cnt, sched->metrics->lane_demoted_cnt, sched->metrics->alut_success_cnt, sched->metrics->alut_serializing_cnt, sched->metrics->txn_abandoned_parsed_cnt, sched->metrics->txn_abandoned_done_cnt, sched->metrics->txn_max_in_flight_cnt, sched->metrics->txn_weighted_in_flight_cnt, sched->metrics->txn_weighted_in_flight_tickcount, sched->metrics->txn_none_in_flight_tickcount, sched->metrics->txn_parsed_cnt, sched->metrics->txn_exec_done_cnt, sched->metrics->txn_sigverify_done_cnt, sched->metrics->txn_done_cnt, sched->metrics->bytes_ingested_cnt, sched->metrics->bytes_ingested_unparsed_cnt, sched->metrics->bytes_dropped_cnt, sched->metrics->fec_cnt ));
+  FD_LOG_NOTICE(( "metrics: block_added_cnt %u, block_added_staged_cnt %u, block_added_unstaged_cnt %u, block_added_dead_ood_cnt %u, block_removed_cnt %u, block_abandoned_cnt %u, block_bad_cnt %u, block_promoted_cnt %u, block_demoted_cnt %u, deactivate_no_child_cnt %u, deactivate_no_txn_cnt %u, deactivate_pruned_cnt %u, deactivate_abandoned_cnt %u, lane_switch_cnt %u, lane_promoted_cnt %u, lane_demoted_cnt %u, alut_success_cnt %u, alut_serializing_cnt %u, poh_inline_verify_cnt %u, txn_abandoned_parsed_cnt %u, txn_abandoned_done_cnt %u, txn_max_in_flight_cnt %u, txn_weighted_in_flight_cnt %lu, txn_weighted_in_flight_tickcount %lu, txn_none_in_flight_tickcount %lu, txn_parsed_cnt %lu, txn_exec_done_cnt %lu, txn_sigverify_done_cnt %lu, txn_done_cnt %lu, poh_entry_parsed_cnt %lu, poh_entry_verified_cnt %lu, acct_prefetch_cnt %lu, acct_prefetch_root_cnt %lu, acct_prefetch_miss_cnt %lu, acct_prefetch_dup_cnt %lu, bytes_ingested_cnt %lu, bytes_ingested_unparsed_cnt %lu, bytes_dropped_cnt %lu, fec_cnt %lu",
+                  sched->metrics->block_added_cnt, sched->metrics->block_added_staged_cnt, sched->metrics->block_added_unstaged_cnt, sched->metrics->block_added_dead_ood_cnt, sched->metrics->block_removed_cnt, sched->metrics->block_abandoned_cnt, sched->metrics->block_bad_cnt, sched->metrics->block_promoted_cnt, sched->metrics->block_demoted_cnt, sched->metrics->deactivate_no_child_cnt, sched->metrics->deactivate_no_txn_cnt, sched->metrics->deactivate_pruned_cnt, sched->metrics->deactivate_abandoned_cnt, sched->metrics->lane_switch_cnt, sched->metrics->lane_promoted_cnt, sched->metrics->lane_demoted_cnt, sched->metrics->alut_success_cnt, sched->metrics->alut_serializing_cnt, sched->metrics->poh_inline_verify_cnt, sched->metrics->txn_abandoned_parsed_cnt, sched->metrics->txn_abandoned_done_cnt, sched->metrics->txn_max_in_flight_cnt, sched->metrics->txn_weighted_in_flight_cnt, sched->metrics->txn_weighted_in_flight_tickcount, sched->metrics->txn_none_in_flight_tickcount, sched->metrics->txn_parsed_cnt, sched->metrics->txn_exec_done_cnt, sched->metrics->txn_sigverify_done_cnt, sched->metrics->txn_done_cnt, sched->metrics->poh_entry_parsed_cnt, sched->metrics->poh_entry_verified_cnt, sched->metrics->acct_prefetch_cnt, sched->metrics->acct_prefetch_root_cnt, sched->metrics->acct_prefetch_miss_cnt, sched->metrics->acct_prefetch_dup_cnt, sched->metrics->bytes_ingested_cnt, sched->metrics->bytes_ingested_unparsed_cnt, sched->metrics->bytes_dropped_cnt, sched->metrics->fec_cnt ));
 }
 
 FD_FN_UNUSED static void
@@ -366,6 +432,8 @@ fd_sched_new( void * mem, ulong block_cnt_max, ulong exec_cnt ) {
   txn_bitset_new( sched->exec_done_set );
   txn_bitset_new( sched->sigverify_done_set );
 
+  fd_memset( sched->prefetch_filter, 0, sizeof(sched->prefetch_filter) );
+
   return sched;
 }
 
@@ -624,6 +692,39 @@ fd_sched_fec_ingest( fd_sched_t * sched, fd_sched_fec_t * fec ) {
   return 1;
 }
 
+/* Dispatch the oldest undispatched entries of the block for PoH
+   verification on the given exec tile.  A task never wraps around the
+   entry ring. */
+static void
+dispatch_poh_verify( fd_sched_t *       sched,
+                     fd_sched_block_t * block,
+                     ulong              bank_idx,
+                     int                exec_tile_idx,
+                     fd_sched_task_t *  out ) {
+  ulong entry_idx = block->poh_dispatched_cnt;
+  ulong ring_idx  = entry_idx & (FD_SCHED_POH_ENTRY_MAX-1UL);
+  ulong entry_cnt = fd_ulong_min( fd_ulong_min( block->poh_parsed_cnt-entry_idx, FD_SCHED_POH_VERIFY_ENTRY_MAX ), FD_SCHED_POH_ENTRY_MAX-ring_idx );
+  FD_TEST( entry_cnt );
+
+  out->task_type = FD_SCHED_TT_POH_VERIFY;
+  out->poh_verify->bank_idx  = bank_idx;
+  out->poh_verify->exec_idx  = (ulong)exec_tile_idx;
+  out->poh_verify->entry_idx = entry_idx;
+  out->poh_verify->entry_cnt = entry_cnt;
+  out->poh_verify->start     = block->poh_dispatch_start;
+  out->poh_verify->entry     = block->poh_entry+ring_idx;
+
+  /* The next task picks up where this one leaves off. */
+  memcpy( block->poh_dispatch_start.hash, block->poh_entry[ ring_idx+entry_cnt-1UL ].hash, sizeof(fd_hash_t) );
+  block->poh_dispatched_cnt += entry_cnt;
+  block->poh_verify_in_flight_cnt++;
+
+  sched->poh_verify_bank_idx [ exec_tile_idx ] = bank_idx;
+  sched->poh_verify_entry_cnt[ exec_tile_idx ] = entry_cnt;
+  sched->sigverify_ready_bitset[ 0 ] = fd_ulong_clear_bit( sched->sigverify_ready_bitset[ 0 ], exec_tile_idx );
+  if( FD_UNLIKELY( (~sched->txn_exec_ready_bitset[ 0 ])&(~sched->sigverify_ready_bitset[ 0 ])&fd_ulong_mask_lsb( (int)sched->exec_cnt ) ) ) FD_LOG_CRIT(( "invariant violation: txn_exec_ready_bitset 0x%lx sigverify_ready_bitset 0x%lx", sched->txn_exec_ready_bitset[ 0 ], sched->sigverify_ready_bitset[ 0 ] ));
+}
+
 ulong
 fd_sched_task_next_ready( fd_sched_t * sched, fd_sched_task_t * out ) {
   FD_TEST( sched->canary==FD_SCHED_MAGIC );
@@ -709,6 +810,12 @@ fd_sched_task_next_ready( fd_sched_t * sched, fd_sched_task_t * out ) {
         if( FD_UNLIKELY( (~sched->txn_exec_ready_bitset[ 0 ])&(~sched->sigverify_ready_bitset[ 0 ])&fd_ulong_mask_lsb( (int)sched->exec_cnt ) ) ) FD_LOG_CRIT(( "invariant violation: txn_exec_ready_bitset 0x%lx sigverify_ready_bitset 0x%lx", sched->txn_exec_ready_bitset[ 0 ], sched->sigverify_ready_bitset[ 0 ] ));
         return 1UL;
       }
+
+      /* Same for PoH verify tasks. */
+      if( FD_LIKELY( block_should_dispatch_poh_verify( block ) && fd_ulong_popcnt( sigverify_ready_bitset )>fd_int_if( block->txn_exec_in_flight_cnt>0U, 0, 1 ) ) ) {
+        dispatch_poh_verify( sched, block, bank_idx, fd_ulong_find_lsb( sigverify_ready_bitset ), out );
+        return 1UL;
+      }
       return 0UL;
     }
     out->task_type = FD_SCHED_TT_TXN_EXEC;
@@ -732,7 +839,7 @@ fd_sched_task_next_ready( fd_sched_t * sched, fd_sched_task_t * out ) {
 
     ulong total_exec_busy_cnt = sched->exec_cnt-(ulong)fd_ulong_popcnt( sched->txn_exec_ready_bitset[ 0 ]&sched->sigverify_ready_bitset[ 0 ] );
     if( FD_UNLIKELY( (~sched->txn_exec_ready_bitset[ 0 ])&(~sched->sigverify_ready_bitset[ 0 ])&fd_ulong_mask_lsb( (int)sched->exec_cnt ) ) ) FD_LOG_CRIT(( "invariant violation: txn_exec_ready_bitset 0x%lx sigverify_ready_bitset 0x%lx", sched->txn_exec_ready_bitset[ 0 ], sched->sigverify_ready_bitset[ 0 ] ));
-    if( FD_UNLIKELY( block->txn_exec_in_flight_cnt+block->txn_sigverify_in_flight_cnt!=total_exec_busy_cnt ) ) {
+    if( FD_UNLIKELY( block->txn_exec_in_flight_cnt+block->txn_sigverify_in_flight_cnt+block->poh_verify_in_flight_cnt!=total_exec_busy_cnt ) ) {
       /* Ideally we'd simply assert that the two sides of the equation
          are equal.  But abandoned blocks throw a wrench into this.  We
          allow abandoned blocks to have in-flight transactions that are
@@ -752,6 +859,7 @@ fd_sched_task_next_ready( fd_sched_t * sched, fd_sched_task_t * out ) {
           }
           total_in_flight += staged_block->txn_exec_in_flight_cnt;
           total_in_flight += staged_block->txn_sigverify_in_flight_cnt;
+          total_in_flight += staged_block->poh_verify_in_flight_cnt;
         }
       }
       if( FD_UNLIKELY( total_in_flight!=total_exec_busy_cnt ) ) {
@@ -783,6 +891,12 @@ fd_sched_task_next_ready( fd_sched_t * sched, fd_sched_task_t * out ) {
     return 1UL;
   }
 
+  /* Same policy for PoH verify tasks. */
+  if( FD_LIKELY( block_should_dispatch_poh_verify( block ) && fd_ulong_popcnt( sigverify_ready_bitset )>fd_int_if( block->fec_eos||block->txn_exec_in_flight_cnt>0U||sched->exec_cnt==1UL, 0, 1 ) ) ) {
+    dispatch_poh_verify( sched, block, bank_idx, fd_ulong_find_lsb( sigverify_ready_bitset ), out );
+    return 1UL;
+  }
+
   if( FD_UNLIKELY( block_should_signal_end( block ) ) ) {
     FD_TEST( block->block_start_signaled );
     out->task_type = FD_SCHED_TT_BLOCK_END;
@@ -809,6 +923,16 @@ fd_sched_task_next_ready( fd_sched_t * sched, fd_sched_task_t * out ) {
   return 0UL;
 }
 
+int
+fd_sched_set_priority( fd_sched_t * sched, int mode ) {
+  return fd_rdisp_set_priority( sched->rdisp, mode );
+}
+
+void
+fd_sched_txn_exec_cus( fd_sched_t * sched, ulong txn_idx, ulong cus ) {
+  fd_rdisp_record_cus( sched->rdisp, txn_idx, cus );
+}
+
 void
 fd_sched_task_done( fd_sched_t * sched, ulong task_type, ulong txn_idx, ulong exec_idx ) {
   FD_TEST( sched->canary==FD_SCHED_MAGIC );
@@ -827,6 +951,12 @@ fd_sched_task_done( fd_sched_t * sched, ulong task_type, ulong txn_idx, ulong ex
       bank_idx = sched->txn_to_bank_idx[ txn_idx ];
       break;
     }
+    case FD_SCHED_TT_POH_VERIFY: {
+      (void)txn_idx;
+      FD_TEST( exec_idx<sched->exec_cnt );
+      bank_idx = sched->poh_verify_bank_idx[ exec_idx ];
+      break;
+    }
     default: FD_LOG_CRIT(( "unsupported task_type %lu", task_type ));
   }
   fd_sched_block_t * block = block_pool_ele( sched, bank_idx );
@@ -902,6 +1032,16 @@ fd_sched_task_done( fd_sched_t * sched, ulong task_type, ulong txn_idx, ulong ex
         sched->metrics->txn_done_cnt++;
       }
 
+      FD_TEST( !fd_ulong_extract_bit( sched->sigverify_ready_bitset[ 0 ], exec_tile_idx ) );
+      sched->sigverify_ready_bitset[ 0 ] = fd_ulong_set_bit( sched->sigverify_ready_bitset[ 0 ], exec_tile_idx );
+      break;
+    }
+    case FD_SCHED_TT_POH_VERIFY: {
+      ulong entry_cnt = sched->poh_verify_entry_cnt[ exec_idx ];
+      block->poh_done_cnt += entry_cnt;
+      block->poh_verify_in_flight_cnt--;
+      sched->metrics->poh_entry_verified_cnt += entry_cnt;
+
       FD_TEST( !fd_ulong_extract_bit( sched->sigverify_ready_bitset[ 0 ], exec_tile_idx ) );
       sched->sigverify_ready_bitset[ 0 ] = fd_ulong_set_bit( sched->sigverify_ready_bitset[ 0 ], exec_tile_idx );
       break;
@@ -1177,6 +1317,10 @@ add_block( fd_sched_t * sched,
   block->txn_sigverify_done_cnt      = 0U;
   block->txn_done_cnt                = 0U;
   block->shred_cnt                   = 0U;
+  block->poh_parsed_cnt              = 0UL;
+  block->poh_dispatched_cnt          = 0UL;
+  block->poh_done_cnt                = 0UL;
+  block->poh_verify_in_flight_cnt    = 0U;
 
   block->mblks_rem    = 0UL;
   block->txns_rem     = 0UL;
@@ -1211,6 +1355,11 @@ add_block( fd_sched_t * sched,
   fd_sched_block_t * parent_block = block_pool_ele( sched, parent_bank_idx );
   block->parent_idx = parent_bank_idx;
 
+  /* The PoH chain of the block starts at the last entry of the
+     parent. */
+  block->poh                = parent_block->poh;
+  block->poh_dispatch_start = parent_block->poh;
+
   /* parent->node and sibling->node links */
   ulong child_idx = bank_idx;
   if( FD_LIKELY( parent_block->child_idx==ULONG_MAX ) ) { /* Optimize for no forking. */
@@ -1258,9 +1407,25 @@ fd_sched_parse( fd_sched_t * sched, fd_sched_block_t * block, fd_sched_alut_ctx_
       fd_microblock_hdr_t * hdr = (fd_microblock_hdr_t *)fd_type_pun( block->fec_buf+block->fec_buf_soff );
       block->fec_buf_soff      += (uint)sizeof(fd_microblock_hdr_t);
 
+      if( FD_UNLIKELY( block->poh_parsed_cnt-block->poh_dispatched_cnt>=FD_SCHED_POH_ENTRY_MAX ) ) {
+        /* No room to buffer the entry. */
+        if( FD_UNLIKELY( !poh_verify_inline( sched, block ) ) ) return FD_SCHED_PARSER_BAD_BLOCK;
+      }
+      fd_poh_entry_t * entry = block->poh_entry+(block->poh_parsed_cnt&(FD_SCHED_POH_ENTRY_MAX-1UL));
+      entry->hashcnt   = hdr->hash_cnt;
+      entry->has_mixin = !!hdr->txn_cnt;
+      memcpy( entry->hash, hdr->hash, sizeof(entry->hash) );
+
       memcpy( block->poh.hash, hdr->hash, sizeof(block->poh.hash) );
       block->txns_rem = hdr->txn_cnt;
       block->mblks_rem--;
+      if( FD_LIKELY( block->txns_rem ) ) {
+        /* The mixin is the Merkle root of all signatures in the entry,
+           see hash_transactions in the bank tile. */
+        fd_bmtree_commit_init( block->poh_bmtree, 32UL, 1UL, 0UL );
+      } else {
+        poh_entry_push( sched, block );
+      }
       continue;
     }
     if( block->txns_rem==0UL && block->mblks_rem==0UL && block->fec_sob ) {
@@ -1339,16 +1504,84 @@ fd_sched_parse_txn( fd_sched_t * sched, fd_sched_block_t * block, fd_sched_alut_
   txn_bitset_remove( sched->exec_done_set, txn_idx );
   txn_bitset_remove( sched->sigverify_done_set, txn_idx );
   block->txn_idx[ block->txn_parsed_cnt ] = txn_idx;
+
+  /* Now that the ALUTs are resolved, warm up all the accounts that the
+     transaction references. */
+  prefetch_accts( sched, alut_ctx, fd_txn_get_acct_addrs( txn, txn_p->payload ), txn->acct_addr_cnt );
+  if( FD_UNLIKELY( has_aluts && !serializing ) ) prefetch_accts( sched, alut_ctx, block->aluts, txn->addr_table_adtl_cnt );
+
   block->fec_buf_soff += (uint)pay_sz;
   block->txn_parsed_cnt++;
 #if FD_SCHED_SKIP_SIGVERIFY
   txn_bitset_insert( sched->sigverify_done_set, txn_idx );
   block->txn_sigverify_done_cnt++;
 #endif
+
+  fd_bmtree_commit_t * bmtree = fd_type_pun( block->poh_bmtree );
+  for( ulong j=0UL; j<txn->signature_cnt; j++ ) {
+    fd_bmtree_node_t node[1];
+    fd_bmtree_hash_leaf( node, txn_p->payload+txn->signature_off+64UL*j, 64UL, 1UL );
+    fd_bmtree_commit_append( bmtree, node, 1UL );
+  }
   block->txns_rem--;
+  if( FD_UNLIKELY( !block->txns_rem ) ) {
+    fd_poh_entry_t * entry = block->poh_entry+(block->poh_parsed_cnt&(FD_SCHED_POH_ENTRY_MAX-1UL));
+    memcpy( entry->mixin, fd_bmtree_commit_fini( bmtree ), sizeof(entry->mixin) );
+    poh_entry_push( sched, block );
+  }
   return FD_SCHED_PARSER_OK;
 }
 
+static void
+prefetch_accts( fd_sched_t * sched, fd_sched_alut_ctx_t * alut_ctx, fd_acct_addr_t const * addr, ulong addr_cnt ) {
+  if( FD_LIKELY( !fd_accdb_prefetch_enabled( alut_ctx->accdb ) ) ) return;
+  for( ulong i=0UL; i<addr_cnt; i++ ) {
+    uchar const * b   = addr[ i ].b;
+    ulong         tag = fd_ulong_hash( FD_LOAD( ulong, b ) ^ FD_LOAD( ulong, b+8UL ) ^ FD_LOAD( ulong, b+16UL ) ^ FD_LOAD( ulong, b+24UL ) ) | 1UL;
+    ulong *       ele = sched->prefetch_filter + (tag & (FD_SCHED_PREFETCH_FILTER_CNT-1UL));
+    if( FD_LIKELY( *ele==tag ) ) {
+      sched->metrics->acct_prefetch_dup_cnt++;
+      continue;
+    }
+    *ele = tag;
+    int res = fd_accdb_prefetch( alut_ctx->accdb, alut_ctx->xid, b );
+    sched->metrics->acct_prefetch_cnt++;
+    sched->metrics->acct_prefetch_root_cnt += (ulong)(res==FD_ACCDB_PREFETCH_ROOT);
+    sched->metrics->acct_prefetch_miss_cnt += (ulong)(res==FD_ACCDB_PREFETCH_MISS);
+  }
+}
+
+static void
+poh_entry_push( fd_sched_t * sched, fd_sched_block_t * block ) {
+  block->poh_parsed_cnt++;
+  sched->metrics->poh_entry_parsed_cnt++;
+}
+
+/* Verify the oldest undispatched entries of the block on the spot.
+   This keeps the parser going when the entry ring is full.  Returns 1
+   if the entries are valid, 0 otherwise. */
+FD_WARN_UNUSED static int
+poh_verify_inline( fd_sched_t * sched, fd_sched_block_t * block ) {
+  ulong entry_idx = block->poh_dispatched_cnt;
+  ulong ring_idx  = entry_idx & (FD_SCHED_POH_ENTRY_MAX-1UL);
+  ulong entry_cnt = fd_ulong_min( fd_ulong_min( block->poh_parsed_cnt-entry_idx, FD_SCHED_POH_INLINE_VERIFY_CNT ), FD_SCHED_POH_ENTRY_MAX-ring_idx );
+  fd_poh_entry_t const * entry = block->poh_entry+ring_idx;
+
+  sched->metrics->poh_inline_verify_cnt++;
+  ulong bad_idx = fd_poh_verify_entries( block->poh_dispatch_start.hash, entry, entry_cnt );
+  if( FD_UNLIKELY( bad_idx<entry_cnt ) ) {
+    FD_LOG_INFO(( "bad block: PoH verify failed at entry %lu, slot %lu, parent slot %lu",
+                  entry_idx+bad_idx, block->slot, block->parent_slot ));
+    return 0;
+  }
+
+  memcpy( block->poh_dispatch_start.hash, entry[ entry_cnt-1UL ].hash, sizeof(fd_hash_t) );
+  block->poh_dispatched_cnt += entry_cnt;
+  block->poh_done_cnt       += entry_cnt;
+  sched->metrics->poh_entry_verified_cnt += entry_cnt;
+  return 1;
+}
+
 #undef CHECK
 #undef CHECK_LEFT
 
@@ -1490,8 +1723,9 @@ subtree_abandon( fd_sched_t * sched, fd_sched_block_t * block ) {
        completion of an in-flight transaction whose txn_id was just
        recycled, we would basically be aliasing the same txn_id and end
        up indexing into txn_to_bank_idx[] that is already overwritten
-       with new blocks. */
-    int abandon = in_order && block->txn_exec_in_flight_cnt==0 && block->txn_sigverify_in_flight_cnt==0;
+       with new blocks.  In-flight PoH verify tasks similarly need the
+       block to stay around until they retire. */
+    int abandon = in_order && block->txn_exec_in_flight_cnt==0 && block->txn_sigverify_in_flight_cnt==0 && block->poh_verify_in_flight_cnt==0;
 
     if( abandon ) {
       block->in_rdisp = 0;
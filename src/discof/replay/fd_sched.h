@@ -4,6 +4,7 @@
 #include "fd_rdisp.h"
 #include "../../disco/store/fd_store.h" /* for fd_store_fec_t */
 #include "../../disco/pack/fd_microblock.h" /* for fd_txn_p_t */
+#include "../../ballet/poh/fd_poh.h" /* for fd_poh_entry_t */
 
 #include "../../flamenco/accdb/fd_accdb_user.h"
 #include "../../util/spad/fd_spad.h" /* for ALUTs */
@@ -122,6 +123,21 @@ struct fd_sched_txn_sigverify {
 };
 typedef struct fd_sched_txn_sigverify fd_sched_txn_sigverify_t;
 
+/* Maximum number of entries in a PoH verify task.  Sized such that an
+   exec tile can keep one entry per SHA-256 batch lane busy. */
+#define FD_SCHED_POH_VERIFY_ENTRY_MAX (16UL)
+
+struct fd_sched_poh_verify {
+  ulong                  bank_idx;
+  ulong                  exec_idx;
+  ulong                  entry_idx; /* Index in the block of the first entry in the task. */
+  ulong                  entry_cnt; /* In [1, FD_SCHED_POH_VERIFY_ENTRY_MAX]. */
+  fd_hash_t              start;     /* PoH hash preceding the first entry in the task. */
+  fd_poh_entry_t const * entry;     /* Entries to verify, indexed [0,entry_cnt).  Only valid until the
+                                       next call into the scheduler. */
+};
+typedef struct fd_sched_poh_verify fd_sched_poh_verify_t;
+
 struct fd_sched_task {
   ulong task_type; /* Set to one of the task types defined above. */
   union {
@@ -129,6 +145,7 @@ struct fd_sched_task {
     fd_sched_block_end_t     block_end[ 1 ];
     fd_sched_txn_exec_t      txn_exec[ 1 ];
     fd_sched_txn_sigverify_t txn_sigverify[ 1 ];
+    fd_sched_poh_verify_t    poh_verify[ 1 ];
   };
 };
 typedef struct fd_sched_task fd_sched_task_t;
@@ -157,7 +174,11 @@ fd_sched_join( void * mem, ulong block_cnt_max );
    ordering across forks.  The fork tree is implied by the stream of
    parent-child relationships delivered in FEC sets.  Also assumes that
    there is enough space in the scheduler to ingest the FEC set.  The
-   caller should generally call fd_sched_fec_can_ingest() first.
+   caller should generally call fd_sched_fec_can_ingest() first.  As
+   transactions are parsed, their accounts (including the ones resolved
+   through ALUTs) are prefetched through the accdb in fec->alut_ctx
+   (see fd_accdb_prefetch) if it has a rooted tier, ahead of the
+   transactions being dispatched.
 
    Returns 1 on success, 0 if the block is bad and should be marked
    dead. */
@@ -209,16 +230,40 @@ fd_sched_can_ingest( fd_sched_t * sched, ulong fec_cnt );
    transactions over sigverify, and in general sigverify tasks are only
    returned when no real transaction can be dispatched.  In other words,
    the scheduler tries to exploit idle cycles in the exec tiles during
-   times of low parallelism critical path progression. */
+   times of low parallelism critical path progression.
+
+   PoH verify tasks are treated the same way as sigverify tasks.  Every
+   entry in a block has to have its hash chain verified before we commit
+   the block.  Entries are batched up such that an exec tile verifies a
+   number of entries at once, one hash chain per SIMD lane.  PoH verify
+   tasks of a block are returned in entry order, and the start hash of
+   a task is the hash of the last entry in the preceding task. */
 ulong
 fd_sched_task_next_ready( fd_sched_t * sched, fd_sched_task_t * out );
 
 /* Mark a task as complete.  For transaction execution, this means that
    the effects of the execution are now visible on any core that could
-   execute a subsequent transaction. */
+   execute a subsequent transaction.  txn_idx is ignored for PoH verify
+   tasks, which are identified by the exec tile they were dispatched
+   to. */
 void
 fd_sched_task_done( fd_sched_t * sched, ulong task_type, ulong txn_idx, ulong exec_idx );
 
+/* fd_sched_set_priority sets the order in which READY transactions are
+   dispatched for execution (one of the FD_RDISP_PRIORITY_* modes, see
+   fd_rdisp_set_priority).  Returns 0 on success and -1 if mode is not
+   a known mode. */
+int
+fd_sched_set_priority( fd_sched_t * sched, int mode );
+
+/* fd_sched_txn_exec_cus records that the transaction txn_idx, which
+   was dispatched for execution and has not been marked done yet,
+   consumed cus compute units.  This feeds the cost estimates of the
+   critical path priority mode (see fd_rdisp_record_cus), and should be
+   called right before fd_sched_task_done for the transaction. */
+void
+fd_sched_txn_exec_cus( fd_sched_t * sched, ulong txn_idx, ulong cus );
+
 /* Abandon a block.  This means that we are no longer interested in
    executing the block.  This also implies that any block which chains
    off of the provided block shall be abandoned.  This is mainly used
@@ -257,6 +302,11 @@ fd_sched_root_notify( fd_sched_t * sched, ulong root_idx );
 fd_txn_p_t *
 fd_sched_get_txn( fd_sched_t * sched, ulong txn_idx );
 
+/* Returns a pointer to the PoH hash of the last entry in the block.
+   This is where the PoH chain of a child block starts.  For a block
+   added with fd_sched_block_add_done(), the caller is responsible for
+   writing the block's PoH hash here before FEC sets for a child block
+   are ingested. */
 fd_hash_t *
 fd_sched_get_poh( fd_sched_t * sched, ulong bank_idx );
 
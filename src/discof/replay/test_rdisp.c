@@ -132,6 +132,7 @@ test_mainnet( char const * filename       FD_PARAM_UNUSED,
               ulong        exec_cnt       FD_PARAM_UNUSED,
               ulong        ticks_per_cu   FD_PARAM_UNUSED,
               ulong        staging_lane   FD_PARAM_UNUSED,
+              int          priority       FD_PARAM_UNUSED,
               int          check_results  FD_PARAM_UNUSED ) {
   if( (!FD_HAS_HOSTED) || FD_UNLIKELY( !filename ) ) {
     FD_LOG_NOTICE(( "skipping mainnet test.  No --block-file supplied" ));
@@ -165,11 +166,13 @@ test_mainnet( char const * filename       FD_PARAM_UNUSED,
   } const * acct_result_per_txn[ MAX_TXN_PER_BLOCK ] = { NULL };
   uchar acct_cnt[ MAX_TXN_PER_BLOCK ];
   uint  cus_consumed[ MAX_TXN_PER_BLOCK ];
+  ulong block_order[ MAX_TXN_PER_BLOCK ];
   ulong txn_cnt = 0UL;
 
-  FD_TEST( fd_rdisp_footprint( MAX_TXN_PER_BLOCK, 1UL )<TEST_FOOTPRINT );
-  fd_rdisp_t * disp = fd_rdisp_join( fd_rdisp_new( footprint, MAX_TXN_PER_BLOCK, 1UL, SEED ) );
+  FD_TEST( fd_rdisp_footprint( MAX_TXN_PER_BLOCK, 4UL )<TEST_FOOTPRINT );
+  fd_rdisp_t * disp = fd_rdisp_join( fd_rdisp_new( footprint, MAX_TXN_PER_BLOCK, 4UL, SEED ) );
   FD_TEST( disp );
+  FD_TEST( 0==fd_rdisp_set_priority( disp, priority ) );
 
   long insert_duration = -fd_tickcount();
   FD_TEST( 0==fd_rdisp_add_block( disp, tag( 0UL ), staging_lane ) );
@@ -189,6 +192,7 @@ test_mainnet( char const * filename       FD_PARAM_UNUSED,
 
     cus_consumed[ txn_idx ] = parse_ptr->cus_consumed;
     acct_cnt    [ txn_idx ] = (uchar)parse_ptr->acct_cnt;
+    block_order [ txn_cnt ] = txn_idx;
     acct_result_per_txn[ txn_idx ] = (void const *)(alt + parse_ptr->alt_addr_cnt);
 
     parse_ptr = (void const *)(acct_result_per_txn[ txn_idx ] + parse_ptr->acct_cnt);
@@ -196,12 +200,39 @@ test_mainnet( char const * filename       FD_PARAM_UNUSED,
   }
   insert_duration += fd_tickcount();
 
+  /* The makespan of any schedule is at least the length (in CUs) of the
+     longest chain of conflicting transactions and at least the total
+     CUs divided evenly among the exec tiles. */
+  static ulong w_fini[ MAX_ACCT_PER_BLOCK ];
+  static ulong r_fini[ MAX_ACCT_PER_BLOCK ];
+  memset( w_fini, '\0', sizeof(w_fini) );
+  memset( r_fini, '\0', sizeof(r_fini) );
+  ulong critical_path = 0UL;
+  ulong total_cus     = 0UL;
+  for( ulong k=0UL; k<txn_cnt; k++ ) {
+    ulong t     = block_order[ k ];
+    ulong start = 0UL;
+    for( ulong i=0UL; i<acct_cnt[ t ]; i++ ) {
+      ulong a = acct_result_per_txn[ t ][ i ].idx;
+      int   w = acct_result_per_txn[ t ][ i ].w_ver>>15;
+      start = fd_ulong_max( start, fd_ulong_max( w_fini[ a ], fd_ulong_if( w, r_fini[ a ], 0UL ) ) );
+    }
+    ulong fini = start + cus_consumed[ t ];
+    for( ulong i=0UL; i<acct_cnt[ t ]; i++ ) {
+      ulong a = acct_result_per_txn[ t ][ i ].idx;
+      if( acct_result_per_txn[ t ][ i ].w_ver>>15 ) { w_fini[ a ] = fini; r_fini[ a ] = 0UL; }
+      else                                            r_fini[ a ] = fd_ulong_max( r_fini[ a ], fini );
+    }
+    critical_path = fd_ulong_max( critical_path, fini );
+    total_cus    += cus_consumed[ t ];
+  }
+  ulong bound_ticks = ticks_per_cu*fd_ulong_max( critical_path, (total_cus+exec_cnt-1UL)/exec_cnt );
 
   ushort current_ver[ MAX_ACCT_PER_BLOCK ] = { 0 };
 
   FD_TEST( exec_cnt<=64UL );
-  FD_TEST( eq_footprint( exec_cnt )<256UL );
-  uchar prq_mem[ 256UL ] __attribute__((aligned(32UL)));
+  FD_TEST( eq_footprint( exec_cnt )<=1024UL );
+  uchar prq_mem[ 1024UL ] __attribute__((aligned(32UL)));
   event_t * eq = eq_join( eq_new( prq_mem, exec_cnt ) );
   ulong free = fd_ulong_mask_lsb( (int)exec_cnt );
 
@@ -211,6 +242,7 @@ test_mainnet( char const * filename       FD_PARAM_UNUSED,
   while( txn_remaining ) {
     ulong ready = 0UL;
     while( eq_cnt( eq ) && eq->timeout<fd_tickcount() + advanced_ticks ) {
+      fd_rdisp_record_cus( disp, eq->txn_idx, cus_consumed[ eq->txn_idx ] );
       fd_rdisp_complete_txn( disp, eq->txn_idx, 1 );
       free |= 1UL<<eq->exec_idx;
       if( FD_UNLIKELY( check_results ) ) {
@@ -242,18 +274,28 @@ test_mainnet( char const * filename       FD_PARAM_UNUSED,
     } /* else, we're done, and we'll break next iteration */
   }
   sched_duration += fd_tickcount();
+  FD_TEST( 0==fd_rdisp_remove_block( disp, tag( 0UL ) ) );
 
+  long makespan = sched_duration+advanced_ticks;
 # if FD_HAS_DOUBLE
   double ticks_per_ns = fd_tempo_tick_per_ns( NULL );
+  FD_LOG_NOTICE(( "priority mode %i", priority ));
   FD_LOG_NOTICE(( "inserting %lu transactions took %f ms", txn_cnt, (double)insert_duration/ticks_per_ns * 1e-6 ));
   FD_LOG_NOTICE(( "scheduling took %f ms of work at the replay tile, and an estimated %f ms total time with %lu exec tiles and %f ns/CU",
-        (double)sched_duration/ticks_per_ns * 1e-6, (double)(sched_duration+advanced_ticks)/ticks_per_ns * 1e-6, exec_cnt, (double)ticks_per_cu/ticks_per_ns ));
+        (double)sched_duration/ticks_per_ns * 1e-6, (double)makespan/ticks_per_ns * 1e-6, exec_cnt, (double)ticks_per_cu/ticks_per_ns ));
+  FD_LOG_NOTICE(( "makespan is %f x the lower bound of %f ms (critical path %lu CUs, %lu CUs total)",
+        (double)makespan/(double)bound_ticks, (double)bound_ticks/ticks_per_ns * 1e-6, critical_path, total_cus ));
 # else
+  FD_LOG_NOTICE(( "priority mode %i", priority ));
   FD_LOG_NOTICE(( "inserting %lu transactions took %li ms", txn_cnt, insert_duration ));
   FD_LOG_NOTICE(( "scheduling took %li ticks of work at the replay tile, and an estimated %li ticks total time with %lu exec tiles and %lu ticks/CU",
-        sched_duration, sched_duration+advanced_ticks, exec_cnt, ticks_per_cu ));
+        sched_duration, makespan, exec_cnt, ticks_per_cu ));
+  FD_LOG_NOTICE(( "makespan is %li ticks, lower bound is %lu ticks (critical path %lu CUs, %lu CUs total)",
+        makespan, bound_ticks, critical_path, total_cus ));
 # endif
 
+  fd_rdisp_delete( fd_rdisp_leave( disp ) );
+
   munmap( ptr, file_sz );
   close( fdesc );
 
@@ -300,6 +342,8 @@ random_test( fd_rng_t * rng,
 
 
       /* Construct the graphs we're going to insert */
+      /* Priority modes don't affect correctness, so mix them */
+      FD_TEST( 0==fd_rdisp_set_priority( disp, (int)(test&1UL) ) );
       for( ulong l=0UL; l<4UL; l++ ) {
         FD_TEST( 0UL==fd_rdisp_add_block( disp, tag( l ), l ) );
 
@@ -424,6 +468,68 @@ random_test( fd_rng_t * rng,
   fd_rdisp_delete( fd_rdisp_leave( disp ) );
 }
 
+/* test_critical_path builds a block with a lot of independent
+   transactions followed by a serial chain of transactions on a hot
+   account, and simulates executing it on 4 exec tiles, where each
+   transaction takes one time step.  The chain needs 16 steps and there
+   are 80 transactions total, so no schedule can take fewer than 20
+   steps.  Each independent transaction writes many accounts, which
+   makes it look more likely to conflict with future transactions than
+   the chain, so dispatching by conflict probability alone runs the
+   independent transactions first and takes 32 steps. */
+static void
+test_critical_path( fd_rng_t * rng ) {
+  ulong depth       = 100UL;
+  ulong block_depth = 10UL;
+  FD_TEST( fd_rdisp_footprint( depth, block_depth )<=TEST_FOOTPRINT ); /* if this fails, update the test */
+  fd_rdisp_t * disp = fd_rdisp_join( fd_rdisp_new( footprint, depth, block_depth, SEED ) );   FD_TEST( disp );
+
+  FD_TEST( -1==fd_rdisp_set_priority( disp, -1 ) );
+  FD_TEST( -1==fd_rdisp_set_priority( disp,  2 ) );
+
+  /* The conflict mode block runs first, which also makes the hot
+     account contended (as measured by the EMA) by the time the critical
+     path mode block is inserted, as it typically is in a real block. */
+  for( int mode=FD_RDISP_PRIORITY_CONFLICT; mode<=FD_RDISP_PRIORITY_CRITICAL_PATH; mode++ ) {
+    FD_TEST( 0==fd_rdisp_set_priority( disp, mode ) );
+    FD_TEST( 0==fd_rdisp_add_block( disp, tag( 0UL ), 0UL ) );
+
+    ushort accts[ 20 ];
+    for( ulong i=0UL; i<64UL; i++ ) {
+      for( ulong j=0UL; j<20UL; j++ ) accts[ j ] = (ushort)(0x8000UL | (1000UL+20UL*i+j));
+      FD_TEST( add_txn2( disp, rng, tag( 0UL ), accts, 20UL ) );
+    }
+    for( ulong i=0UL; i<16UL; i++ ) {
+      accts[ 0 ] = (ushort)(0x8000UL | 1UL);
+      accts[ 1 ] = (ushort)(0x8000UL | (5000UL+i));
+      FD_TEST( add_txn2( disp, rng, tag( 0UL ), accts, 2UL ) );
+    }
+    fd_rdisp_verify( disp, verify_scratch );
+
+    ulong remaining = 80UL;
+    ulong steps     = 0UL;
+    while( remaining ) {
+      ulong batch[ 4 ];
+      ulong cnt = 0UL;
+      while( cnt<4UL && 0UL!=(batch[ cnt ]=fd_rdisp_get_next_ready( disp, tag( 0UL ) )) ) cnt++;
+      FD_TEST( cnt );
+      for( ulong i=0UL; i<cnt; i++ ) {
+        fd_rdisp_record_cus( disp, batch[ i ], 1000UL );
+        fd_rdisp_complete_txn( disp, batch[ i ], 1 );
+      }
+      remaining -= cnt;
+      steps++;
+    }
+    fd_rdisp_verify( disp, verify_scratch );
+    FD_TEST( 0==fd_rdisp_remove_block( disp, tag( 0UL ) ) );
+
+    FD_LOG_NOTICE(( "priority mode %i: makespan %lu steps, lower bound 20 steps", mode, steps ));
+    FD_TEST( steps>=20UL );
+    if( mode==FD_RDISP_PRIORITY_CRITICAL_PATH ) FD_TEST( steps==20UL );
+  }
+
+  fd_rdisp_delete( fd_rdisp_leave( disp ) );
+}
 
 int
 main( int     argc,
@@ -437,7 +543,8 @@ main( int     argc,
   ulong        rand_iters = fd_env_strip_cmdline_ulong ( &argc, &argv, "--random-iterations", NULL, 1000UL );
   FD_LOG_NOTICE(( "Using --random-iterations %lu", rand_iters ));
 
-  test_mainnet( block_file, exec_tiles, 20UL, 0UL, 1 );
+  test_mainnet( block_file, exec_tiles, 20UL, 0UL, FD_RDISP_PRIORITY_CONFLICT,      1 );
+  test_mainnet( block_file, exec_tiles, 20UL, 0UL, FD_RDISP_PRIORITY_CRITICAL_PATH, 1 );
 
   ulong depth       = 100UL;
   ulong block_depth = 10UL;
@@ -695,6 +802,8 @@ main( int     argc,
 
   fd_rdisp_delete( fd_rdisp_leave( disp ) );
 
+  test_critical_path( rng );
+
   random_test( rng, rand_iters );
 
   fd_rng_delete( fd_rng_leave( rng ) );
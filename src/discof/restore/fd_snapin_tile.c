@@ -609,6 +609,7 @@ handle_control_frag( fd_snapin_tile_t *  ctx,
         if( ctx->vinyl.txn_active ) {
           fd_snapin_vinyl_txn_commit( ctx );
         }
+        fd_snapin_vinyl_sync( ctx );
       }
 
       if( FD_UNLIKELY( verify_slot_deltas_with_slot_history( ctx ) ) ) {
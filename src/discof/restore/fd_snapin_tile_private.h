@@ -205,9 +205,17 @@ fd_snapin_vinyl_wd_init( fd_snapin_tile_t * ctx );
 void
 fd_snapin_vinyl_wd_fini( fd_snapin_tile_t * ctx );
 
+/* fd_snapin_vinyl_sync makes the loaded bstream durable and writes its
+   sync block, such that the vinyl tile can resume it.  Called once the
+   snapshot is fully loaded (in io_mm mode), before Replay is told. */
+
+void
+fd_snapin_vinyl_sync( fd_snapin_tile_t * ctx );
+
 /* fd_snapin_vinyl_shutdown instructs vinyl-related tiles of the loader
    to shut down.  Blocks until all affected tiles have acknowledged the
-   shutdown signal. */
+   shutdown signal.  Does not touch the bstream, which may already be
+   owned by the vinyl tile. */
 
 void
 fd_snapin_vinyl_shutdown( fd_snapin_tile_t * ctx );
@@ -673,13 +673,20 @@ fd_snapin_process_account_batch_vinyl( fd_snapin_tile_t *            ctx,
 }
 
 void
-fd_snapin_vinyl_shutdown( fd_snapin_tile_t * ctx ) {
-  int commit_err = fd_vinyl_io_commit( ctx->vinyl.io, FD_VINYL_IO_FLAG_BLOCKING );
-  if( FD_UNLIKELY( commit_err ) ) FD_LOG_CRIT(( "fd_vinyl_io_commit(io) failed (%i-%s)", commit_err, fd_vinyl_strerror( commit_err ) ));
+fd_snapin_vinyl_sync( fd_snapin_tile_t * ctx ) {
+  FD_CRIT( ctx->vinyl.io==ctx->vinyl.io_mm, "vinyl not in io_mm mode" );
+
+  int commit_err = fd_vinyl_io_commit( ctx->vinyl.io_mm, FD_VINYL_IO_FLAG_BLOCKING );
+  if( FD_UNLIKELY( commit_err ) ) FD_LOG_CRIT(( "fd_vinyl_io_commit(io_mm) failed (%i-%s)", commit_err, fd_vinyl_strerror( commit_err ) ));
   int sync_err = fd_vinyl_io_sync( ctx->vinyl.io_mm, FD_VINYL_IO_FLAG_BLOCKING );
   if( FD_UNLIKELY( sync_err ) ) FD_LOG_CRIT(( "fd_vinyl_io_sync(io_mm) failed (%i-%s)", sync_err, fd_vinyl_strerror( sync_err ) ));
   vinyl_mm_sync( ctx );
+}
 
+void
+fd_snapin_vinyl_shutdown( fd_snapin_tile_t * ctx ) {
+  /* The bstream was synced at CTRL_DONE (the vinyl tile may have
+     appended to it since) */
   fd_vinyl_io_wd_ctrl( ctx->vinyl.io_wd, FD_SNAPSHOT_MSG_CTRL_SHUTDOWN, 0UL );
 }
 
@@ -692,6 +692,7 @@ unprivileged_init( fd_topo_t *      topo,
   quic->config.idle_timeout  =  FD_SEND_QUIC_IDLE_TIMEOUT_NS;
   quic->config.ack_delay     =  FD_SEND_QUIC_ACK_DELAY_NS;
   quic->config.keep_alive    =  1;
+  quic->config.cc_algo       =  tile->send.cc_algo;
   quic->config.sign          =  quic_tls_cv_sign;
   quic->config.sign_ctx      =  ctx;
   fd_memcpy( quic->config.identity_public_key, ctx->identity_key, sizeof(ctx->identity_key) );
@@ -861,6 +862,14 @@ metrics_write( fd_send_tile_ctx_t * ctx ) {
   FD_MCNT_SET(         SEND, PKT_VERNEG,                  ctx->quic->metrics.pkt_verneg_cnt          );
   FD_MCNT_ENUM_COPY(   SEND, PKT_RETRANSMISSIONS,         ctx->quic->metrics.pkt_retransmissions_cnt            );
 
+  FD_MGAUGE_SET(       SEND, CONGESTION_WINDOW_BYTES,     ctx->quic->metrics.cc_cwnd_sz              );
+  FD_MGAUGE_SET(       SEND, BYTES_IN_FLIGHT,             ctx->quic->metrics.cc_inflight_sz          );
+  FD_MCNT_SET(         SEND, PKT_LOST,                    ctx->quic->metrics.cc_pkt_lost_cnt         );
+  FD_MCNT_SET(         SEND, BYTES_LOST,                  ctx->quic->metrics.cc_byte_lost_cnt        );
+  FD_MCNT_SET(         SEND, CONGESTION_EVENTS,           ctx->quic->metrics.cc_congestion_event_cnt );
+  FD_MCNT_SET(         SEND, CWND_LIMITED,                ctx->quic->metrics.cc_cwnd_limited_cnt     );
+  FD_MCNT_SET(         SEND, PACING_LIMITED,              ctx->quic->metrics.cc_pacing_limited_cnt   );
+
   FD_MCNT_SET(         SEND, HANDSHAKES_CREATED,          ctx->quic->metrics.hs_created_cnt          );
   FD_MCNT_SET(         SEND, HANDSHAKE_ERROR_ALLOC_FAIL,  ctx->quic->metrics.hs_err_alloc_fail_cnt   );
   FD_MCNT_SET(         SEND, HANDSHAKE_EVICTED,           ctx->quic->metrics.hs_evicted_cnt          );
@@ -0,0 +1,3 @@
+ifdef FD_HAS_INT128
+$(call add-objs,fd_vinyl_tile,fd_discof)
+endif
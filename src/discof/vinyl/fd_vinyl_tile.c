@@ -0,0 +1,374 @@
+/* The vinyl tile runs the rooted tier of the account database (a vinyl
+   bstream in the accounts file, see fd_vinyl.h and fd_accdb_vinyl.h).
+
+   Replay roots accounts by sending vinyl requests (fd_vinyl_rq.h) on
+   replay_vinyl and blocking until the completion comes back on
+   vinyl_replay (see fd_vinyl_client.h).  Replay is the only client and
+   has at most one request in flight, so the links never fill up.  The
+   vinyl tile executes each request with fd_vinyl_exec and does
+   compaction, partition blocks and bstream syncs in housekeeping.  The
+   bstream meta (vinyl_meta) and the data region (vinyl_data) are shared
+   with Replay, which reads rooted accounts directly from its own
+   read-only mapping of the accounts file.
+
+   BOOT
+
+   If snapshots are enabled, the snapin tile writes the bstream and
+   populates the meta, and syncs the bstream before it tells Replay the
+   snapshot is loaded.  Replay cannot root anything before that, so the
+   vinyl tile resumes the bstream from its sync block when the first
+   request arrives.  Otherwise, the tile starts a new bstream (with an
+   empty meta) on the first request.  Compaction starts with no known
+   garbage and learns it as pairs are replaced.
+
+   I/O
+
+   The bstream is read and appended via an io_uring (fd_vinyl_io_ur)
+   by default, such that compaction reads and appends are in flight
+   concurrently, or with pread/pwrite (fd_vinyl_io_bd), see
+   [tiles.vinyl] io_backend.  The ring is created in privileged_init as
+   the sandbox does not allow io_uring_setup.  Either way, the file is
+   accessed through the page cache, such that Replay's mapping of the
+   file sees the appends.
+
+   Like snapwr, the tile mostly waits on disk I/O or for requests, so
+   it runs floating and sleeps when idle.  Requests issued back to back
+   are served without sleeping. */
+
+#include "../../disco/topo/fd_topo.h"
+#include "../../vinyl/fd_vinyl.h"
+#include "../../util/io_uring/fd_io_uring.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "generated/fd_vinyl_tile_seccomp.h" /* after fcntl.h for F_GETFL */
+
+#define NAME "vinyl"
+
+/* IO_SPAD_MAX is the append scratch pad size of the bstream io.  Pairs
+   are appended in place from the data region, so the scratch pad only
+   holds control blocks (dead, partition and compaction blocks). */
+
+#define IO_SPAD_MAX (8UL<<20)
+
+/* COLD_MAX bounds the size of the pairs compaction compresses as cold
+   (see [tiles.vinyl] cold_compression), it is the size of the scratch
+   the compactor stages them in.  Pairs are compressed into the io's
+   scratch pad (so the worst case compressed pair must fit in
+   IO_SPAD_MAX) and Replay decodes pairs that wrap around the end of
+   the store in a val_max byte scratch that also holds the compressed
+   val (so cold pairs must be at most half of val_max, see boot). */
+
+#define COLD_MAX (4UL<<20)
+
+struct fd_vinyl_in {
+  fd_wksp_t * mem;
+  ulong       chunk0;
+  ulong       wmark;
+  ulong       mtu;
+};
+
+typedef struct fd_vinyl_in fd_vinyl_in_t;
+
+struct fd_vinyl_out {
+  fd_wksp_t * mem;
+  ulong       chunk0;
+  ulong       wmark;
+  ulong       chunk;
+};
+
+typedef struct fd_vinyl_out fd_vinyl_out_t;
+
+struct fd_vinyl_tile {
+  int                dev_fd;
+  ulong              dev_sz;   /* bstream store size (the file minus the sync block) */
+  int                reset;    /* start a new bstream instead of resuming the one loaded by snapin */
+  ulong              io_seed;  /* only used if reset */
+  int                io_type;  /* FD_VINYL_IO_TYPE_{BD,UR} */
+  fd_io_uring_t      ring[1];  /* only used if io_type is UR, owned by the io once booted */
+  ulong              line_cnt;
+  ulong              val_max;
+  ulong              data_sz;
+  ulong              gc_thresh; /* compaction parameters, see fd_vinyl_compact.h */
+  int                gc_lg_eps;
+  float              bw_rate;
+  long               bw_burst;
+  int                cold_style; /* FD_VINYL_BSTREAM_CTL_STYLE_*, RAW if cold pairs are not compressed */
+  void *             cold_mem;   /* COLD_MAX bytes, compactor scratch if cold pairs are compressed */
+
+  void *             vinyl_mem;
+  void *             io_mem;
+  void *             data;
+  fd_vinyl_meta_t    meta[1];
+  fd_vinyl_compact_t compact[1];
+  fd_vinyl_t *       vinyl;    /* NULL until booted */
+
+  fd_vinyl_req_t *   req;      /* request copied in during_frag */
+  ulong              req_sz;
+
+  uint idle_cnt;
+
+  fd_vinyl_in_t  in [ 1 ];
+  fd_vinyl_out_t out[ 1 ];
+};
+
+typedef struct fd_vinyl_tile fd_vinyl_tile_t;
+
+FD_FN_CONST static inline ulong
+io_align( void ) {
+  return fd_ulong_max( fd_vinyl_io_bd_align(), fd_vinyl_io_ur_align() );
+}
+
+FD_FN_CONST static inline ulong
+io_footprint( void ) {
+  return fd_ulong_max( fd_vinyl_io_bd_footprint( IO_SPAD_MAX ), fd_vinyl_io_ur_footprint( IO_SPAD_MAX ) );
+}
+
+FD_FN_CONST static inline ulong
+scratch_align( void ) {
+  return fd_ulong_max( fd_ulong_max( fd_ulong_max( alignof(fd_vinyl_tile_t), fd_vinyl_align() ), io_align() ), FD_VINYL_BSTREAM_BLOCK_SZ );
+}
+
+FD_FN_PURE static inline ulong
+scratch_footprint( fd_topo_tile_t const * tile ) {
+  ulong l = FD_LAYOUT_INIT;
+  l = FD_LAYOUT_APPEND( l, alignof(fd_vinyl_tile_t), sizeof(fd_vinyl_tile_t)                                       );
+  l = FD_LAYOUT_APPEND( l, fd_vinyl_align(),         fd_vinyl_footprint( tile->vinyl.line_cnt, tile->vinyl.val_max ) );
+  l = FD_LAYOUT_APPEND( l, io_align(),               io_footprint()                                                 );
+  l = FD_LAYOUT_APPEND( l, alignof(fd_vinyl_req_t),  fd_vinyl_req_sz( FD_VINYL_REQ_BATCH_MAX )                     );
+  l = FD_LAYOUT_APPEND( l, FD_VINYL_BSTREAM_BLOCK_SZ, COLD_MAX                                                       );
+  return FD_LAYOUT_FINI( l, scratch_align() );
+}
+
+/* vinyl_boot starts running the rooted tier (see BOOT above). */
+
+static void
+vinyl_boot( fd_vinyl_tile_t * ctx ) {
+  fd_vinyl_io_t * io;
+  if( ctx->io_type==FD_VINYL_IO_TYPE_UR ) {
+    io = fd_vinyl_io_ur_init_ring( ctx->io_mem, IO_SPAD_MAX, ctx->dev_fd, ctx->ring, ctx->data, ctx->data_sz,
+                                   ctx->reset, NULL, 0UL, ctx->io_seed );
+  } else {
+    io = fd_vinyl_io_bd_init( ctx->io_mem, IO_SPAD_MAX, ctx->dev_fd, ctx->reset, NULL, 0UL, ctx->io_seed );
+  }
+  if( FD_UNLIKELY( !io ) ) FD_LOG_ERR(( "failed to %s the accounts bstream", ctx->reset ? "create" : "resume" ));
+
+  if( FD_UNLIKELY( !fd_vinyl_compact_init( ctx->compact, ctx->dev_sz, 0UL, ctx->gc_thresh, ctx->gc_lg_eps,
+                                           ctx->bw_rate, ctx->bw_burst, fd_log_wallclock() ) ) ) {
+    FD_LOG_ERR(( "invalid [tiles.vinyl] compaction parameters" ));
+  }
+
+  if( ctx->cold_style!=FD_VINYL_BSTREAM_CTL_STYLE_RAW ) {
+    ulong cold_sz = fd_ulong_align_dn( fd_ulong_min( COLD_MAX, ctx->val_max/2UL ), FD_VINYL_BSTREAM_BLOCK_SZ );
+    if( FD_UNLIKELY( !fd_vinyl_compact_cold( ctx->compact, ctx->cold_style, ctx->cold_mem, cold_sz ) ) ) {
+      FD_LOG_ERR(( "failed to enable [tiles.vinyl.cold_compression]" ));
+    }
+  }
+
+  ctx->vinyl = fd_vinyl_init( ctx->vinyl_mem, ctx->line_cnt, ctx->val_max, io, ctx->dev_sz, ctx->meta, ctx->data, ctx->compact );
+  if( FD_UNLIKELY( !ctx->vinyl ) ) FD_LOG_ERR(( "failed to start the rooted tier" ));
+
+  FD_LOG_NOTICE(( "%s accounts bstream (seq_present %lu, pair_cnt %lu)",
+                  ctx->reset ? "created" : "resumed", io->seq_present, ctx->vinyl->pair_cnt ));
+}
+
+static void
+before_credit( fd_vinyl_tile_t *   ctx,
+               fd_stem_context_t * stem,
+               int *               charge_busy ) {
+  (void)stem;
+  if( ++ctx->idle_cnt >= 1024U ) {
+    fd_log_sleep( (long)1e6 ); /* 1 millisecond */
+    *charge_busy = 0;
+    ctx->idle_cnt = 0U;
+  }
+}
+
+static void
+during_housekeeping( fd_vinyl_tile_t * ctx ) {
+  if( FD_LIKELY( ctx->vinyl ) ) fd_vinyl_housekeep( ctx->vinyl, fd_log_wallclock() );
+}
+
+static inline void
+during_frag( fd_vinyl_tile_t * ctx,
+             ulong             in_idx,
+             ulong             seq,
+             ulong             sig,
+             ulong             chunk,
+             ulong             sz,
+             ulong             ctl ) {
+  (void)seq; (void)sig; (void)ctl;
+
+  if( FD_UNLIKELY( chunk<ctx->in[ in_idx ].chunk0 || chunk>ctx->in[ in_idx ].wmark || sz>ctx->in[ in_idx ].mtu ) )
+    FD_LOG_ERR(( "chunk %lu %lu corrupt, not in range [%lu,%lu]", chunk, sz, ctx->in[ in_idx ].chunk0, ctx->in[ in_idx ].wmark ));
+
+  fd_memcpy( ctx->req, fd_chunk_to_laddr_const( ctx->in[ in_idx ].mem, chunk ), sz );
+  ctx->req_sz = sz;
+}
+
+static inline void
+after_frag( fd_vinyl_tile_t *   ctx,
+            ulong               in_idx,
+            ulong               seq,
+            ulong               sig,
+            ulong               sz,
+            ulong               tsorig,
+            ulong               tspub,
+            fd_stem_context_t * stem ) {
+  (void)in_idx; (void)seq; (void)sig; (void)sz; (void)tspub;
+  ctx->idle_cnt = 0U;
+
+  if( FD_UNLIKELY( !ctx->vinyl ) ) vinyl_boot( ctx );
+
+  /* Malformed requests are reported in the completion */
+
+  fd_vinyl_comp_t * comp    = fd_chunk_to_laddr( ctx->out->mem, ctx->out->chunk );
+  ulong             comp_sz = fd_vinyl_exec( ctx->vinyl, ctx->req, ctx->req_sz, comp );
+
+  fd_stem_publish( stem, 0UL, comp->req_id, ctx->out->chunk, comp_sz, 0UL, tsorig, fd_frag_meta_ts_comp( fd_tickcount() ) );
+  ctx->out->chunk = fd_dcache_compact_next( ctx->out->chunk, comp_sz, ctx->out->chunk0, ctx->out->wmark );
+}
+
+static void
+privileged_init( fd_topo_t *      topo,
+                 fd_topo_tile_t * tile ) {
+  void * scratch = fd_topo_obj_laddr( topo, tile->tile_obj_id );
+
+  FD_SCRATCH_ALLOC_INIT( l, scratch );
+  fd_vinyl_tile_t * ctx = FD_SCRATCH_ALLOC_APPEND( l, alignof(fd_vinyl_tile_t), sizeof(fd_vinyl_tile_t) );
+  memset( ctx, 0, sizeof(fd_vinyl_tile_t) );
+
+  /* Not O_DIRECT, such that Replay's mapping of the file sees the
+     appends. */
+
+  char const * path = tile->vinyl.vinyl_path;
+  ctx->dev_fd = open( path, O_RDWR|O_CLOEXEC );
+  if( FD_UNLIKELY( -1==ctx->dev_fd ) ) FD_LOG_ERR(( "open(%s,O_RDWR|O_CLOEXEC) failed (%i-%s)", path, errno, fd_io_strerror( errno ) ));
+
+  struct stat st;
+  if( FD_UNLIKELY( fstat( ctx->dev_fd, &st ) ) ) FD_LOG_ERR(( "fstat(%s) failed (%i-%s)", path, errno, fd_io_strerror( errno ) ));
+  if( FD_UNLIKELY( (ulong)st.st_size<=FD_VINYL_BSTREAM_BLOCK_SZ ) ) FD_LOG_ERR(( "accounts file %s is too small", path ));
+  ctx->dev_sz = fd_ulong_align_dn( (ulong)st.st_size, FD_VINYL_BSTREAM_BLOCK_SZ ) - FD_VINYL_BSTREAM_BLOCK_SZ;
+
+  ctx->reset = tile->vinyl.reset;
+  if( ctx->reset ) FD_TEST( fd_rng_secure( &ctx->io_seed, sizeof(ulong) ) );
+
+  ctx->io_type = tile->vinyl.io_type;
+  ctx->ring->ring_fd = -1;
+  if( ctx->io_type==FD_VINYL_IO_TYPE_UR ) {
+    if( FD_UNLIKELY( !fd_ulong_is_pow2( tile->vinyl.io_uring_depth ) || tile->vinyl.io_uring_depth>FD_VINYL_IO_UR_DEPTH_MAX ) ) {
+      FD_LOG_ERR(( "[tiles.vinyl.io_uring_depth] %u must be a power of 2 of at most %lu", tile->vinyl.io_uring_depth, FD_VINYL_IO_UR_DEPTH_MAX ));
+    }
+    if( FD_UNLIKELY( !fd_io_uring_init( ctx->ring, tile->vinyl.io_uring_depth, 0U ) ) ) {
+      FD_LOG_ERR(( "failed to create the io_uring, io_uring may be unavailable (use [tiles.vinyl.io_backend] \"pread\" instead)" ));
+    }
+  }
+}
+
+static void
+unprivileged_init( fd_topo_t *      topo,
+                   fd_topo_tile_t * tile ) {
+  void * scratch = fd_topo_obj_laddr( topo, tile->tile_obj_id );
+
+  FD_SCRATCH_ALLOC_INIT( l, scratch );
+  fd_vinyl_tile_t * ctx = FD_SCRATCH_ALLOC_APPEND( l, alignof(fd_vinyl_tile_t), sizeof(fd_vinyl_tile_t)                                       );
+  ctx->vinyl_mem        = FD_SCRATCH_ALLOC_APPEND( l, fd_vinyl_align(),         fd_vinyl_footprint( tile->vinyl.line_cnt, tile->vinyl.val_max ) );
+  ctx->io_mem           = FD_SCRATCH_ALLOC_APPEND( l, io_align(),               io_footprint()                                                 );
+  ctx->req              = FD_SCRATCH_ALLOC_APPEND( l, alignof(fd_vinyl_req_t),  fd_vinyl_req_sz( FD_VINYL_REQ_BATCH_MAX )                     );
+  ctx->cold_mem         = FD_SCRATCH_ALLOC_APPEND( l, FD_VINYL_BSTREAM_BLOCK_SZ, COLD_MAX                                                       );
+  FD_TEST( FD_SCRATCH_ALLOC_FINI( l, scratch_align() )==(ulong)scratch+scratch_footprint( tile ) );
+
+  if( FD_UNLIKELY( tile->kind_id ) ) FD_LOG_ERR(( "There can only be one `" NAME "` tile" ));
+
+  ctx->line_cnt   = tile->vinyl.line_cnt;
+  ctx->val_max    = tile->vinyl.val_max;
+  ctx->data       = fd_topo_obj_laddr( topo, tile->vinyl.data_obj_id );
+  ctx->data_sz    = topo->objs[ tile->vinyl.data_obj_id ].footprint;
+  ctx->gc_thresh  = tile->vinyl.gc_thresh;
+  ctx->gc_lg_eps  = tile->vinyl.gc_lg_eps;
+  ctx->bw_rate    = tile->vinyl.bw_rate;
+  ctx->bw_burst   = tile->vinyl.bw_burst;
+  ctx->cold_style = tile->vinyl.cold_style;
+  ctx->vinyl      = NULL;
+  ctx->idle_cnt   = 0U;
+
+  void * shmap = fd_topo_obj_laddr( topo, tile->vinyl.meta_map_obj_id  );
+  void * shele = fd_topo_obj_laddr( topo, tile->vinyl.meta_pool_obj_id );
+  FD_TEST( fd_vinyl_meta_join( ctx->meta, shmap, shele ) );
+
+  if( FD_UNLIKELY( tile->in_cnt!=1UL || strcmp( topo->links[ tile->in_link_id[ 0 ] ].name, "replay_vinyl" ) ) ) {
+    FD_LOG_ERR(( "tile `" NAME "` must have exactly one input link replay_vinyl" ));
+  }
+  fd_topo_link_t const * in_link = &topo->links[ tile->in_link_id[ 0 ] ];
+  if( FD_UNLIKELY( in_link->mtu<fd_vinyl_req_sz( FD_VINYL_REQ_BATCH_MAX ) ) ) FD_LOG_ERR(( "replay_vinyl mtu %lu too small", in_link->mtu ));
+  ctx->in->mem    = topo->workspaces[ topo->objs[ in_link->dcache_obj_id ].wksp_id ].wksp;
+  ctx->in->chunk0 = fd_dcache_compact_chunk0( ctx->in->mem, in_link->dcache );
+  ctx->in->wmark  = fd_dcache_compact_wmark ( ctx->in->mem, in_link->dcache, in_link->mtu );
+  ctx->in->mtu    = in_link->mtu;
+
+  if( FD_UNLIKELY( tile->out_cnt!=1UL || strcmp( topo->links[ tile->out_link_id[ 0 ] ].name, "vinyl_replay" ) ) ) {
+    FD_LOG_ERR(( "tile `" NAME "` must have exactly one output link vinyl_replay" ));
+  }
+  fd_topo_link_t const * out_link = &topo->links[ tile->out_link_id[ 0 ] ];
+  if( FD_UNLIKELY( out_link->mtu<fd_vinyl_comp_sz( FD_VINYL_REQ_BATCH_MAX ) ) ) FD_LOG_ERR(( "vinyl_replay mtu %lu too small", out_link->mtu ));
+  ctx->out->mem    = topo->workspaces[ topo->objs[ out_link->dcache_obj_id ].wksp_id ].wksp;
+  ctx->out->chunk0 = fd_dcache_compact_chunk0( ctx->out->mem, out_link->dcache );
+  ctx->out->wmark  = fd_dcache_compact_wmark ( ctx->out->mem, out_link->dcache, out_link->mtu );
+  ctx->out->chunk  = ctx->out->chunk0;
+}
+
+static ulong
+populate_allowed_fds( fd_topo_t      const * topo,
+                      fd_topo_tile_t const * tile,
+                      ulong                  out_fds_cnt,
+                      int *                  out_fds ) {
+  if( FD_UNLIKELY( out_fds_cnt<4UL ) ) FD_LOG_ERR(( "out_fds_cnt %lu", out_fds_cnt ));
+  fd_vinyl_tile_t const * ctx = fd_topo_obj_laddr( topo, tile->tile_obj_id );
+
+  ulong out_cnt = 0UL;
+  out_fds[ out_cnt++ ] = 2; /* stderr */
+  if( FD_LIKELY( -1!=fd_log_private_logfile_fd() ) )
+    out_fds[ out_cnt++ ] = fd_log_private_logfile_fd(); /* logfile */
+  out_fds[ out_cnt++ ] = ctx->dev_fd; /* accounts file */
+  if( ctx->io_type==FD_VINYL_IO_TYPE_UR ) out_fds[ out_cnt++ ] = ctx->ring->ring_fd; /* io_uring */
+  return out_cnt;
+}
+
+static ulong
+populate_allowed_seccomp( fd_topo_t const *      topo,
+                          fd_topo_tile_t const * tile,
+                          ulong                  out_cnt,
+                          struct sock_filter *   out ) {
+  fd_vinyl_tile_t const * ctx = fd_topo_obj_laddr( topo, tile->tile_obj_id );
+  populate_sock_filter_policy_fd_vinyl_tile( out_cnt, out, (uint)fd_log_private_logfile_fd(), (uint)ctx->dev_fd, (uint)ctx->ring->ring_fd );
+  return sock_filter_policy_fd_vinyl_tile_instr_cnt;
+}
+
+#define STEM_BURST (1UL)
+#define STEM_LAZY  ((long)2e6)
+
+#define STEM_CALLBACK_CONTEXT_TYPE  fd_vinyl_tile_t
+#define STEM_CALLBACK_CONTEXT_ALIGN alignof(fd_vinyl_tile_t)
+
+#define STEM_CALLBACK_DURING_HOUSEKEEPING during_housekeeping
+#define STEM_CALLBACK_BEFORE_CREDIT       before_credit
+#define STEM_CALLBACK_DURING_FRAG         during_frag
+#define STEM_CALLBACK_AFTER_FRAG          after_frag
+
+#include "../../disco/stem/fd_stem.c"
+
+fd_topo_run_tile_t fd_tile_vinyl = {
+  .name                     = NAME,
+  .populate_allowed_fds     = populate_allowed_fds,
+  .populate_allowed_seccomp = populate_allowed_seccomp,
+  .scratch_align            = scratch_align,
+  .scratch_footprint        = scratch_footprint,
+  .privileged_init          = privileged_init,
+  .unprivileged_init        = unprivileged_init,
+  .run                      = stem_run,
+};
+
+#undef NAME
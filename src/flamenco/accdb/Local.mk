@@ -6,6 +6,10 @@ $(call add-objs,fd_accdb_admin,fd_flamenco)
 $(call add-hdrs,fd_accdb_user.h fd_accdb_sync.h)
 $(call add-objs,fd_accdb_user,fd_flamenco)
 
+# Rooted tier
+$(call add-hdrs,fd_accdb_vinyl.h)
+$(call add-objs,fd_accdb_vinyl,fd_flamenco)
+
 # Debug APIs
 $(call add-hdrs,fd_accdb_fsck.h)
 $(call add-objs,fd_accdb_fsck_funk fd_accdb_fsck_vinyl,fd_flamenco)
@@ -13,4 +17,8 @@ $(call add-objs,fd_accdb_fsck_funk fd_accdb_fsck_vinyl,fd_flamenco)
 ifdef FD_HAS_ATOMIC
 $(call make-unit-test,test_accdb,test_accdb,fd_flamenco fd_funk fd_util)
 $(call run-unit-test,test_accdb)
+ifdef FD_HAS_LZ4
+$(call make-unit-test,test_accdb_vinyl,test_accdb_vinyl,fd_flamenco fd_vinyl fd_funk fd_tango fd_util)
+$(call run-unit-test,test_accdb_vinyl)
+endif
 endif
@@ -270,6 +270,78 @@ fd_accdb_publish_recs( fd_accdb_admin_t * accdb,
   }
 }
 
+/* fd_accdb_flush_recs moves all records in a transaction to the
+   rooted tier and evicts them from funk.  Records are evicted only
+   after the rooted tier has them, so concurrent readers on descendant
+   forks always find either the funk or the rooted tier copy.
+
+   It is assumed at this point that the txn has no more concurrent
+   users. */
+
+static void
+fd_accdb_flush_recs( fd_accdb_admin_t * accdb,
+                     fd_funk_txn_t *    txn ) {
+  fd_funk_t *     funk    = accdb->funk;
+  fd_funk_rec_t * rec_tbl = funk->rec_pool->ele;
+
+  fd_funk_rec_t * batch[ FD_ACCDB_FLUSH_BATCH_MAX ];
+  ulong           batch_cnt = 0UL;
+  ulong           rec_cnt   = 0UL;
+
+  uint head = txn->rec_head_idx;
+  for(;;) {
+    int done = fd_funk_rec_idx_is_null( head );
+
+    if( !done ) {
+      fd_funk_rec_t * rec = &rec_tbl[ head ];
+      head = rec->next_idx;
+
+      /* Evict previous value from hash chain */
+      fd_funk_xid_key_pair_t pair[1];
+      fd_funk_rec_key_copy( pair->key, rec->pair.key );
+      fd_funk_txn_xid_set_root( pair->xid );
+      fd_accdb_chain_gc_root( accdb, pair );
+
+      batch[ batch_cnt++ ] = rec;
+    }
+
+    if( batch_cnt==FD_ACCDB_FLUSH_BATCH_MAX || (done & !!batch_cnt) ) {
+      accdb->root_flush( accdb, batch, batch_cnt );
+
+      for( ulong i=0UL; i<batch_cnt; i++ ) {
+        fd_funk_rec_t * rec = batch[ i ];
+
+        fd_funk_rec_query_t query[1];
+        int rm_err = fd_funk_rec_map_remove( funk->rec_map, fd_funk_rec_pair( rec ), NULL, query, FD_MAP_FLAG_BLOCKING );
+        if( FD_UNLIKELY( rm_err!=FD_MAP_SUCCESS ) ) FD_LOG_CRIT(( "fd_funk_rec_map_remove failed: %i-%s", rm_err, fd_map_strerror( rm_err ) ));
+        if( FD_UNLIKELY( query->ele!=rec ) ) FD_LOG_CRIT(( "Found duplicate record in map idx[0]=%p idx[1]=%p", (void *)query->ele, (void *)rec ));
+
+        memset( &rec->pair, 0, sizeof(fd_funk_xid_key_pair_t) );
+        FD_COMPILER_MFENCE();
+
+        rec->map_next = FD_FUNK_REC_IDX_NULL;
+        rec->prev_idx = FD_FUNK_REC_IDX_NULL;
+        rec->next_idx = FD_FUNK_REC_IDX_NULL;
+        fd_funk_val_flush( rec, funk->alloc, funk->wksp );
+        fd_funk_rec_pool_release( funk->rec_pool, rec, 1 );
+      }
+
+      rec_cnt  += batch_cnt;
+      batch_cnt = 0UL;
+    }
+
+    if( done ) break;
+  }
+
+  txn->rec_head_idx = FD_FUNK_REC_IDX_NULL;
+  txn->rec_tail_idx = FD_FUNK_REC_IDX_NULL;
+
+  accdb->root_flush( accdb, NULL, 0UL );
+
+  FD_LOG_INFO(( "accdb flushed %lu records to rooted tier while publishing txn %lu:%lu",
+                rec_cnt, txn->xid.ul[0], txn->xid.ul[1] ));
+}
+
 /* fd_accdb_txn_publish_one merges an in-prep transaction whose
    parent is the last published, into the parent. */
 
@@ -294,7 +366,8 @@ fd_accdb_txn_publish_one( fd_accdb_admin_t * accdb,
 
   /* Phase 3: Migrate records */
 
-  fd_accdb_publish_recs( accdb, txn );
+  if( accdb->root_flush ) fd_accdb_flush_recs  ( accdb, txn );
+  else                    fd_accdb_publish_recs( accdb, txn );
 
   /* Phase 4: Remove transaction from fork graph
 
@@ -3,8 +3,33 @@
 
 #include "../../funk/fd_funk.h"
 
+/* FD_ACCDB_FLUSH_BATCH_MAX is the max number of rooted records handed
+   to a rooted tier flush in one call. */
+
+#define FD_ACCDB_FLUSH_BATCH_MAX (64UL)
+
+struct fd_vinyl_private;
+struct fd_vinyl_client;
+
 struct fd_accdb_admin {
   fd_funk_t funk[1];
+
+  /* Rooted tier (optional, see fd_accdb_vinyl.h).  If root_flush is
+     non-NULL, fd_accdb_advance_root hands rooted records to root_flush
+     in batches of at most FD_ACCDB_FLUSH_BATCH_MAX and then evicts them
+     from funk instead of migrating them to the funk root.  A final call
+     with rec_cnt==0 marks the end of a root advance.  The rooted tier
+     is either driven in-process (vinyl) or by a vinyl tile over a link
+     (vinyl_client). */
+
+  struct fd_vinyl_private * vinyl;
+  struct fd_vinyl_client *  vinyl_client;
+  uchar *                   vinyl_data;
+  ulong                     vinyl_line_cnt;
+  ulong                     vinyl_val_max;
+  void (* root_flush)( struct fd_accdb_admin * admin,
+                       fd_funk_rec_t * const * rec,
+                       ulong                   rec_cnt );
 };
 
 typedef struct fd_accdb_admin fd_accdb_admin_t;
@@ -40,7 +65,8 @@ fd_accdb_attach_child( fd_accdb_admin_t *        admin,
 
 
 /* fd_accdb_advance_root merges the given fork node into the database
-   root. */
+   root.  If a rooted tier is attached, the fork node's records are
+   flushed to it and evicted from funk. */
 
 void
 fd_accdb_advance_root( fd_accdb_admin_t *        admin,
@@ -53,7 +79,8 @@ void
 fd_accdb_cancel( fd_accdb_admin_t *        admin,
                  fd_funk_txn_xid_t const * xid );
 
-/* fd_accdb_clear removes all account database entries and txns. */
+/* fd_accdb_clear removes all account database entries and txns.  Does
+   not clear an attached rooted tier. */
 
 void
 fd_accdb_clear( fd_accdb_admin_t * admin );
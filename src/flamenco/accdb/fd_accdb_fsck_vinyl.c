@@ -2,6 +2,14 @@
 #include "../runtime/fd_runtime_const.h"
 #include "../../ballet/lthash/fd_lthash_adder.h"
 
+#if FD_HAS_LZ4
+#include <lz4.h>
+
+/* fsck_dec holds the decoded val of a compressed (cold) pair */
+
+static uchar fsck_dec[ sizeof(fd_account_meta_t)+FD_RUNTIME_ACC_SZ_MAX ] __attribute__((aligned(alignof(fd_account_meta_t))));
+#endif
+
 #define VINYL_KEY_FMT             "%016lx%016lx%016lx%016lx"
 #define VINYL_KEY_FMT_ARGS( key ) fd_ulong_bswap( (key).ul[0] ), fd_ulong_bswap( (key).ul[1] ), fd_ulong_bswap( (key).ul[2] ), fd_ulong_bswap( (key).ul[3] )
 
@@ -83,13 +91,17 @@ fd_accdb_fsck_vinyl( fd_vinyl_io_t *   io,
     if( FD_LIKELY( fd_vinyl_meta_private_ele_is_free( meta->ctx, ele ) ) ) continue;
 
     ulong memo    = fd_vinyl_key_memo( meta_seed, &ele->phdr.key );
+    int   style   = fd_vinyl_bstream_ctl_style( ele->phdr.ctl );
     ulong val_esz = fd_vinyl_bstream_ctl_sz( ele->phdr.ctl );
+    ulong val_sz  = (ulong)ele->phdr.info._val_sz;
 
     int bad_ctl   = fd_vinyl_bstream_ctl_type ( ele->phdr.ctl )!=FD_VINYL_BSTREAM_CTL_TYPE_PAIR;
-    int bad_style = fd_vinyl_bstream_ctl_style( ele->phdr.ctl )!=FD_VINYL_BSTREAM_CTL_STYLE_RAW;
+    int bad_style = (style!=FD_VINYL_BSTREAM_CTL_STYLE_RAW) & (!FD_HAS_LZ4 | (style!=FD_VINYL_BSTREAM_CTL_STYLE_LZ4));
     int bad_memo  = memo != ele->memo;
     int bad_query = meta_query_fast( meta, &ele->phdr.key, ele->memo )!=ele;
-    int bad_sz    = val_esz > sizeof(fd_account_meta_t)+FD_RUNTIME_ACC_SZ_MAX;
+    int bad_sz    = (val_esz > sizeof(fd_account_meta_t)+FD_RUNTIME_ACC_SZ_MAX) |
+                    (val_sz  > sizeof(fd_account_meta_t)+FD_RUNTIME_ACC_SZ_MAX) |
+                    ((style==FD_VINYL_BSTREAM_CTL_STYLE_RAW) & (val_esz!=val_sz));
     int bad_seq0  = fd_vinyl_seq_lt( ele->seq, seq_past ) | fd_vinyl_seq_ge( ele->seq, seq_present );
     int bad_seq1  = fd_vinyl_seq_gt( ele->seq+fd_vinyl_bstream_pair_sz( val_esz ), seq_present );
 
@@ -218,8 +230,22 @@ fd_accdb_fsck_vinyl( fd_vinyl_io_t *   io,
       }
 
       /* At this point, found the latest revision of an account for the
-         first time */
+         first time (decode it if compaction compressed it) */
       fd_account_meta_t const * meta       = fd_type_pun_const( mmio+mm_off+sizeof(fd_vinyl_bstream_phdr_t) );
+#     if FD_HAS_LZ4
+      if( fd_vinyl_bstream_ctl_style( block.ctl )==FD_VINYL_BSTREAM_CTL_STYLE_LZ4 ) {
+        ulong val_sz = (ulong)block.phdr.info._val_sz;
+        int   dsz    = LZ4_decompress_safe( (char const *)meta, (char *)fsck_dec, (int)val_esz, (int)sizeof(fsck_dec) );
+        if( FD_UNLIKELY( (dsz<0) || ((ulong)dsz!=val_sz) || (val_sz<sizeof(fd_account_meta_t)) ) ) {
+          FD_LOG_WARNING(( "fd_accdb_fsck_vinyl: bstream pair failed to decode: key=" VINYL_KEY_FMT " seq=%lu dev_off=%lu",
+                           VINYL_KEY_FMT_ARGS( block.phdr.key ), seq, dev_off ));
+          err_cnt++;
+          err = fd_uint_max( err, FD_ACCDB_FSCK_CORRUPT );
+          goto next;
+        }
+        meta = (fd_account_meta_t const *)fsck_dec;
+      }
+#     endif
       void const *              data       = (void const *)( meta+1 );
       void const *              pubkey     = &ele->phdr.key.uc;
       ulong                     data_sz    = meta->dlen;
@@ -24,7 +24,9 @@ FD_PROTOTYPES_BEGIN
 /* fd_accdb_peek_try starts a speculative read of an account.  Queries
    the account database cache for the given address.  On success,
    returns peek, which holds a speculative reference to an account.  Use
-   fd_accdb_peek_test to confirm whether peek is still valid.
+   fd_accdb_peek_test to confirm whether peek is still valid.  If the
+   account was found in the rooted tier (see fd_accdb_vinyl.h),
+   peek->acc->rec is NULL.
 
    Typical usage like:
 
@@ -64,6 +66,48 @@ fd_accdb_peek_drop( fd_accdb_peek_t * peek ) {
 
 FD_PROTOTYPES_END
 
+/* Prefetch API *******************************************************/
+
+/* Results of fd_accdb_prefetch */
+
+#define FD_ACCDB_PREFETCH_MISS (0) /* account not found */
+#define FD_ACCDB_PREFETCH_FUNK (1) /* account found in funk */
+#define FD_ACCDB_PREFETCH_ROOT (2) /* account found in the rooted tier */
+
+FD_PROTOTYPES_BEGIN
+
+/* fd_accdb_prefetch hints that the account at address will soon be
+   read through xid (e.g. by an exec tile running a transaction that was
+   just parsed).  Locates the account like fd_accdb_peek does.  If the
+   account is only found in the rooted tier, this starts reading the
+   account in the background (see fd_accdb_vinyl.h), so a store that is
+   not resident in memory is read ahead of use.  Accounts in funk are
+   already in memory and are left alone.  Without a rooted tier
+   attached, this does nothing and returns FD_ACCDB_PREFETCH_MISS (see
+   fd_accdb_prefetch_enabled).
+
+   This never blocks on I/O, never takes a reference to the account,
+   and gives up instead of retrying if the lookup raced with a writer
+   (returning FD_ACCDB_PREFETCH_MISS), so it is safe to call
+   speculatively from a latency sensitive path.  Returns one of the
+   FD_ACCDB_PREFETCH_* values, which is only meant for metrics. */
+
+int
+fd_accdb_prefetch( fd_accdb_user_t *         accdb,
+                   fd_funk_txn_xid_t const * xid,
+                   void const *              address );
+
+/* fd_accdb_prefetch_enabled returns 1 if fd_accdb_prefetch can do
+   anything useful for accdb (i.e. a rooted tier is attached) and 0
+   otherwise. */
+
+static inline int
+fd_accdb_prefetch_enabled( fd_accdb_user_t const * accdb ) {
+  return !!accdb->root_prefetch;
+}
+
+FD_PROTOTYPES_END
+
 /* In-place transactional write APIs **********************************/
 
 FD_PROTOTYPES_BEGIN
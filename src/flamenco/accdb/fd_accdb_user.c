@@ -223,7 +223,11 @@ fd_accdb_peek1( fd_accdb_user_t *         accdb,
     FD_SPIN_PAUSE();
     /* FIXME backoff */
   }
-  if( !rec ) return NULL;
+  if( !rec ) {
+    /* Fall through to the rooted tier */
+    if( accdb->root_peek ) return accdb->root_peek( accdb, peek, address );
+    return NULL;
+  }
 
   *peek = (fd_accdb_peek_t) {
     .acc = {{
@@ -248,6 +252,36 @@ fd_accdb_peek( fd_accdb_user_t *         accdb,
   return fd_accdb_peek1( accdb, peek, xid, address );
 }
 
+int
+fd_accdb_prefetch( fd_accdb_user_t *         accdb,
+                   fd_funk_txn_xid_t const * xid,
+                   void const *              address ) {
+  if( FD_UNLIKELY( !accdb || !accdb->funk->shmem ) ) FD_LOG_CRIT(( "NULL accdb" ));
+
+  /* Without a rooted tier, every account is already resident in the
+     funk workspace, and cache lines pulled in here would land in this
+     core's caches rather than the executing core's. */
+  if( !accdb->root_prefetch ) return FD_ACCDB_PREFETCH_MISS;
+
+  fd_accdb_load_fork( accdb, xid );
+
+  fd_funk_t const * funk = accdb->funk;
+  fd_funk_rec_key_t key[1]; memcpy( key->uc, address, 32UL );
+
+  fd_funk_xid_key_pair_t pair[1];
+  fd_funk_txn_xid_copy( pair->xid, xid );
+  fd_funk_rec_key_copy( pair->key, key );
+  fd_funk_rec_map_t const * rec_map = funk->rec_map;
+  ulong hash      = fd_funk_rec_map_key_hash( pair, rec_map->map->seed );
+  ulong chain_idx = (hash & (rec_map->map->chain_cnt-1UL) );
+
+  /* Single attempt, this is only a hint */
+  fd_funk_rec_t * rec = NULL;
+  if( FD_UNLIKELY( fd_accdb_search_chain( accdb, chain_idx, key, &rec )!=FD_MAP_SUCCESS ) ) return FD_ACCDB_PREFETCH_MISS;
+  if( rec ) return FD_ACCDB_PREFETCH_FUNK;
+  return accdb->root_prefetch( accdb, address );
+}
+
 static void
 fd_accdb_copy_account( fd_account_meta_t *   out_meta,
                        void *                out_data,
@@ -366,7 +400,7 @@ fd_accdb_modify_prepare( fd_accdb_user_t *         accdb,
     fd_memset( val, 0, val_sz_min );
     return fd_accdb_prep_create( rw, accdb, xid, address, val, val_sz, val_max );
 
-  } else if( fd_funk_txn_xid_eq( peek->acc->rec->pair.xid, xid ) ) {
+  } else if( peek->acc->rec && fd_funk_txn_xid_eq( peek->acc->rec->pair.xid, xid ) ) {
 
     /* Mutable record found, modify in-place */
     fd_funk_rec_t * rec = (void *)( peek->acc->ref->rec_laddr );
@@ -380,10 +414,10 @@ fd_accdb_modify_prepare( fd_accdb_user_t *         accdb,
 
   } else {
 
-    /* Frozen record found, copy out to new object */
+    /* Frozen or rooted tier record found, copy out to new object */
     ulong  acc_orig_sz = fd_accdb_ref_data_sz( peek->acc );
     ulong  val_sz_min  = sizeof(fd_account_meta_t)+fd_ulong_max( data_min, acc_orig_sz );
-    ulong  val_sz      = peek->acc->rec->val_sz;
+    ulong  val_sz      = peek->acc->rec ? peek->acc->rec->val_sz : sizeof(fd_account_meta_t)+acc_orig_sz;
     ulong  val_max     = 0UL;
     void * val         = fd_alloc_malloc_at_least( accdb->funk->alloc, 16UL, val_sz_min, &val_max );
     if( FD_UNLIKELY( !val ) ) {
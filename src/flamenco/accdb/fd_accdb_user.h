@@ -5,6 +5,9 @@
 
 #define FD_ACCDB_DEPTH_MAX (128UL)
 
+struct fd_accdb_peek;
+struct fd_vinyl_meta_private;
+
 struct fd_accdb_user {
   fd_funk_t funk[1];
 
@@ -17,6 +20,20 @@ struct fd_accdb_user {
 
   /* Ref counting */
   ulong rw_active;
+
+  /* Rooted tier (optional, see fd_accdb_vinyl.h).  If root_peek is
+     non-NULL, queries that miss in funk fall through to root_peek (and
+     prefetches to root_prefetch). */
+  struct fd_vinyl_meta_private * vinyl_meta;
+  uchar const *                  vinyl_mmio;
+  ulong                          vinyl_mmio_sz;
+  uchar *                        vinyl_scratch;
+  ulong                          vinyl_scratch_sz;
+  struct fd_accdb_peek *      (* root_peek)( struct fd_accdb_user * accdb,
+                                             struct fd_accdb_peek * peek,
+                                             void const *           address );
+  int                         (* root_prefetch)( struct fd_accdb_user * accdb,
+                                                 void const *           address );
 };
 
 typedef struct fd_accdb_user fd_accdb_user_t;
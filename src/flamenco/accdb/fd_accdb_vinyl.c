@@ -0,0 +1,417 @@
+#define _DEFAULT_SOURCE /* madvise */
+#include "fd_accdb_vinyl.h"
+
+#include <sys/mman.h> /* madvise */
+
+#if FD_HAS_LZ4
+#include <lz4.h>
+#endif
+
+FD_STATIC_ASSERT( sizeof(fd_funk_rec_key_t)==sizeof(fd_vinyl_key_t), key_sz );
+
+/* fd_accdb_vinyl_exec runs a request against the rooted tier (in
+   process or on the vinyl tile) and returns the completion.  Per key
+   errors are returned to the caller (the admin is the only client so a
+   malformed request is a bug). */
+
+static fd_vinyl_comp_t *
+fd_accdb_vinyl_exec( fd_accdb_admin_t * admin,
+                     fd_vinyl_req_t *   req,
+                     fd_vinyl_comp_t *  comp ) {
+  if( admin->vinyl_client ) fd_vinyl_client_exec( admin->vinyl_client, req, comp );
+  else                      fd_vinyl_exec( admin->vinyl, req, fd_vinyl_req_sz( req->batch_cnt ), comp );
+  if( FD_UNLIKELY( comp->err ) ) FD_LOG_CRIT(( "fd_vinyl_exec failed (%i-%s)", comp->err, fd_vinyl_strerror( comp->err ) ));
+  return comp;
+}
+
+static void
+fd_accdb_vinyl_flush( fd_accdb_admin_t *      admin,
+                      fd_funk_rec_t * const * rec,
+                      ulong                   rec_cnt ) {
+  fd_wksp_t * wksp    = admin->funk->wksp;
+  ulong       val_max = admin->vinyl_val_max;
+
+  if( !rec_cnt ) { /* end of root advance (the vinyl tile does its own housekeeping) */
+    if( admin->vinyl ) fd_vinyl_housekeep( admin->vinyl, fd_log_wallclock() );
+    return;
+  }
+
+  /* Requests are small enough to live on the stack */
+
+  union {
+    fd_vinyl_req_t req[1];
+    uchar          mem[ sizeof(fd_vinyl_req_t) + FD_ACCDB_FLUSH_BATCH_MAX*sizeof(fd_vinyl_key_t) ];
+  } live, dead;
+
+  union {
+    fd_vinyl_comp_t comp[1];
+    uchar           mem[ sizeof(fd_vinyl_comp_t) + FD_ACCDB_FLUSH_BATCH_MAX*(sizeof(ulong)+sizeof(schar)) ];
+  } comp;
+
+  fd_account_meta_t const * acc[ FD_ACCDB_FLUSH_BATCH_MAX ];
+
+  ulong live_max = fd_ulong_min( admin->vinyl_line_cnt, FD_ACCDB_FLUSH_BATCH_MAX );
+  ulong live_cnt = 0UL;
+  ulong dead_cnt = 0UL;
+
+  fd_vinyl_key_t * live_key = fd_vinyl_req_key( live.req );
+  fd_vinyl_key_t * dead_key = fd_vinyl_req_key( dead.req );
+
+  for( ulong rec_idx=0UL; rec_idx<=rec_cnt; rec_idx++ ) {
+
+    if( rec_idx<rec_cnt ) {
+      fd_funk_rec_t const * r = rec[ rec_idx ];
+
+      if( FD_UNLIKELY( r->val_sz<sizeof(fd_account_meta_t) ) ) {
+        FD_LOG_CRIT(( "Failed to flush account: rec %p has invalid val_sz %u", (void *)r, (uint)r->val_sz ));
+      }
+      fd_account_meta_t const * meta = fd_funk_val_const( r, wksp );
+      /* Note: account size is given by meta->dlen (val_sz is not kept
+         exact by all writers) */
+      if( FD_UNLIKELY( sizeof(fd_account_meta_t)+(ulong)meta->dlen>(ulong)r->val_max ) ) {
+        FD_LOG_CRIT(( "Failed to flush account: rec %p has dlen %u but val_max %u", (void *)r, meta->dlen, (uint)r->val_max ));
+      }
+
+      if( !meta->lamports ) {
+        fd_vinyl_key_init( dead_key + dead_cnt++, r->pair.key->uc, 32UL );
+      } else {
+        if( FD_UNLIKELY( sizeof(fd_account_meta_t)+(ulong)meta->dlen>val_max ) ) {
+          FD_LOG_CRIT(( "Failed to flush account: dlen %u exceeds the rooted tier's val_max %lu", meta->dlen, val_max ));
+        }
+        acc[ live_cnt ] = meta;
+        fd_vinyl_key_init( live_key + live_cnt++, r->pair.key->uc, 32UL );
+      }
+    }
+
+    /* Write out the batch of live accounts if we have used all the
+       vinyl lines or we are done */
+
+    if( live_cnt && ( live_cnt==live_max || rec_idx==rec_cnt ) ) {
+
+      live.req->req_id    = 0UL;
+      live.req->flags     = FD_VINYL_REQ_FLAG_MODIFY | FD_VINYL_REQ_FLAG_CREATE | FD_VINYL_REQ_FLAG_IGNORE;
+      live.req->type      = FD_VINYL_REQ_TYPE_ACQUIRE;
+      live.req->batch_cnt = (uint)live_cnt;
+      fd_accdb_vinyl_exec( admin, live.req, comp.comp );
+      if( FD_UNLIKELY( comp.comp->fail_cnt ) ) {
+        FD_LOG_CRIT(( "Failed to flush account: rooted tier is full (%u of %lu acquires failed)", comp.comp->fail_cnt, live_cnt ));
+      }
+
+      ulong const * val_off = fd_vinyl_comp_val_off( comp.comp );
+      for( ulong i=0UL; i<live_cnt; i++ ) {
+        fd_vinyl_bstream_phdr_t * phdr   = (fd_vinyl_bstream_phdr_t *)( admin->vinyl_data + val_off[ i ] );
+        ulong                     val_sz = sizeof(fd_account_meta_t) + (ulong)acc[ i ]->dlen;
+        memset( &phdr->info, 0, sizeof(fd_vinyl_info_t) );
+        phdr->info._val_sz = (uint)val_sz;
+        fd_memcpy( phdr+1, acc[ i ], val_sz );
+      }
+
+      live.req->flags = FD_VINYL_REQ_FLAG_MODIFY;
+      live.req->type  = FD_VINYL_REQ_TYPE_RELEASE;
+      fd_accdb_vinyl_exec( admin, live.req, comp.comp );
+      if( FD_UNLIKELY( comp.comp->fail_cnt ) ) {
+        FD_LOG_CRIT(( "Failed to flush account: rooted tier bstream is full (%u of %lu releases failed)", comp.comp->fail_cnt, live_cnt ));
+      }
+
+      live_cnt = 0UL;
+    }
+  }
+
+  /* Erase deleted accounts (they might not be in the rooted tier) */
+
+  if( dead_cnt ) {
+    dead.req->req_id    = 0UL;
+    dead.req->flags     = 0UL;
+    dead.req->type      = FD_VINYL_REQ_TYPE_ERASE;
+    dead.req->batch_cnt = (uint)dead_cnt;
+    fd_accdb_vinyl_exec( admin, dead.req, comp.comp );
+    schar const * err = fd_vinyl_comp_err( comp.comp );
+    for( ulong i=0UL; i<dead_cnt; i++ ) {
+      if( FD_UNLIKELY( err[ i ]!=FD_VINYL_SUCCESS && err[ i ]!=FD_VINYL_ERR_KEY ) ) {
+        FD_LOG_CRIT(( "Failed to erase account: fd_vinyl_exec failed (%i-%s)", (int)err[ i ], fd_vinyl_strerror( err[ i ] ) ));
+      }
+    }
+  }
+}
+
+fd_accdb_admin_t *
+fd_accdb_admin_vinyl_attach( fd_accdb_admin_t * admin,
+                             fd_vinyl_t *       vinyl ) {
+  if( FD_UNLIKELY( !admin ) ) {
+    FD_LOG_WARNING(( "NULL admin" ));
+    return NULL;
+  }
+  if( FD_UNLIKELY( !vinyl ) ) {
+    FD_LOG_WARNING(( "NULL vinyl" ));
+    return NULL;
+  }
+  if( FD_UNLIKELY( vinyl->val_max<sizeof(fd_account_meta_t) ) ) {
+    FD_LOG_WARNING(( "vinyl val_max %lu too small", vinyl->val_max ));
+    return NULL;
+  }
+
+  admin->vinyl          = vinyl;
+  admin->vinyl_client   = NULL;
+  admin->vinyl_data     = vinyl->data;
+  admin->vinyl_line_cnt = vinyl->line_cnt;
+  admin->vinyl_val_max  = vinyl->val_max;
+  admin->root_flush     = fd_accdb_vinyl_flush;
+  return admin;
+}
+
+fd_accdb_admin_t *
+fd_accdb_admin_vinyl_attach_client( fd_accdb_admin_t *  admin,
+                                    fd_vinyl_client_t * client,
+                                    void *              data,
+                                    ulong               line_cnt,
+                                    ulong               val_max ) {
+  if( FD_UNLIKELY( !admin ) ) {
+    FD_LOG_WARNING(( "NULL admin" ));
+    return NULL;
+  }
+  if( FD_UNLIKELY( !client ) ) {
+    FD_LOG_WARNING(( "NULL client" ));
+    return NULL;
+  }
+  if( FD_UNLIKELY( !data ) ) {
+    FD_LOG_WARNING(( "NULL data" ));
+    return NULL;
+  }
+  if( FD_UNLIKELY( !fd_ulong_is_aligned( (ulong)data, fd_vinyl_data_align() ) ) ) {
+    FD_LOG_WARNING(( "misaligned data" ));
+    return NULL;
+  }
+  if( FD_UNLIKELY( !fd_vinyl_data_footprint( line_cnt, val_max ) ) ) {
+    FD_LOG_WARNING(( "bad line_cnt or val_max" ));
+    return NULL;
+  }
+  if( FD_UNLIKELY( val_max<sizeof(fd_account_meta_t) ) ) {
+    FD_LOG_WARNING(( "vinyl val_max %lu too small", val_max ));
+    return NULL;
+  }
+
+  admin->vinyl          = NULL;
+  admin->vinyl_client   = client;
+  admin->vinyl_data     = (uchar *)data;
+  admin->vinyl_line_cnt = line_cnt;
+  admin->vinyl_val_max  = val_max;
+  admin->root_flush     = fd_accdb_vinyl_flush;
+  return admin;
+}
+
+/* fd_accdb_vinyl_peek queries the rooted tier for an account.  The
+   pair is read speculatively out of the memory mapped store: the meta
+   element gives the location of the current version and the account is
+   copied (or, for pairs compaction re-encoded as cold, decoded) into
+   the user's scratch.  As the location can be reused while copying
+   (the pair moved by compaction and the bstream wrapped around), the
+   pair header at that location and the meta element are checked again
+   after the copy and the read is retried if either changed.  Thus the
+   returned account never points into the store. */
+
+static fd_accdb_peek_t *
+fd_accdb_vinyl_peek( fd_accdb_user_t * accdb,
+                     fd_accdb_peek_t * peek,
+                     void const *      address ) {
+  fd_vinyl_meta_t * meta    = accdb->vinyl_meta;
+  uchar const *     mmio    = accdb->vinyl_mmio;
+  ulong             mmio_sz = accdb->vinyl_mmio_sz;
+
+  fd_vinyl_key_t key[1]; fd_vinyl_key_init( key, address, 32UL );
+
+  for(;;) {
+
+    fd_vinyl_meta_query_t query[1];
+    int err = fd_vinyl_meta_query_try( meta, key, NULL, query, FD_MAP_FLAG_BLOCKING );
+    if( err==FD_MAP_ERR_KEY ) return NULL;
+    if( FD_UNLIKELY( err ) ) { FD_SPIN_PAUSE(); continue; }
+
+    fd_vinyl_meta_ele_t const * ele = fd_vinyl_meta_query_ele_const( query );
+    ulong ctl    = ele->phdr.ctl;
+    ulong seq    = ele->seq;
+    ulong val_sz = (ulong)ele->phdr.info._val_sz;
+
+    if( FD_UNLIKELY( fd_vinyl_meta_query_test( query ) ) ) { FD_SPIN_PAUSE(); continue; }
+    if( FD_UNLIKELY( ctl==ULONG_MAX ) ) return NULL; /* being created */
+
+    int   style   = fd_vinyl_bstream_ctl_style( ctl );
+    ulong val_esz = fd_vinyl_bstream_ctl_sz( ctl );
+
+    /* Pairs start on a block boundary so the pair header never wraps */
+
+    ulong                           off  = seq % mmio_sz;
+    fd_vinyl_bstream_phdr_t const * phdr = (fd_vinyl_bstream_phdr_t const *)( mmio+off );
+    FD_COMPILER_MFENCE();
+    int stale = (FD_VOLATILE_CONST( phdr->ctl )!=ctl) | !fd_vinyl_key_eq( &phdr->key, key );
+    FD_COMPILER_MFENCE();
+    if( FD_UNLIKELY( stale ) ) { FD_SPIN_PAUSE(); continue; }
+
+    if( FD_UNLIKELY( val_sz<sizeof(fd_account_meta_t) ) ) {
+      FD_LOG_CRIT(( "rooted tier corruption detected: invalid val_sz %lu", val_sz ));
+    }
+
+    fd_account_meta_t const * acc;
+    ulong val_off = off + sizeof(fd_vinyl_bstream_phdr_t);
+
+    switch( style ) {
+
+    case FD_VINYL_BSTREAM_CTL_STYLE_RAW: {
+      if( FD_UNLIKELY( val_esz!=val_sz ) ) {
+        FD_LOG_CRIT(( "rooted tier corruption detected: val_esz %lu does not match val_sz %lu", val_esz, val_sz ));
+      }
+      if( FD_UNLIKELY( val_sz>accdb->vinyl_scratch_sz ) ) {
+        FD_LOG_CRIT(( "Failed to read account: val_sz %lu exceeds scratch_sz %lu", val_sz, accdb->vinyl_scratch_sz ));
+      }
+      ulong sz0 = fd_ulong_min( val_sz, mmio_sz - val_off ); /* <val_sz if the pair wraps around the end of the store */
+      fd_memcpy( accdb->vinyl_scratch,     mmio+val_off, sz0        );
+      fd_memcpy( accdb->vinyl_scratch+sz0, mmio,         val_sz-sz0 );
+      acc = (fd_account_meta_t const *)accdb->vinyl_scratch;
+      break;
+    }
+
+#   if FD_HAS_LZ4
+    case FD_VINYL_BSTREAM_CTL_STYLE_LZ4: {
+      /* Pair was re-encoded by compaction (cold), decode it into
+         scratch.  If the encoded val wraps around the end of the store,
+         it is first copied out to just after the decoded val. */
+      if( FD_UNLIKELY( val_sz>accdb->vinyl_scratch_sz ) ) {
+        FD_LOG_CRIT(( "Failed to read account: val_sz %lu exceeds scratch_sz %lu", val_sz, accdb->vinyl_scratch_sz ));
+      }
+      char const * src = (char const *)( mmio+val_off );
+      if( FD_UNLIKELY( val_off+val_esz>mmio_sz ) ) {
+        if( FD_UNLIKELY( val_sz+val_esz>accdb->vinyl_scratch_sz ) ) {
+          FD_LOG_CRIT(( "Failed to read account: val_sz %lu plus val_esz %lu exceeds scratch_sz %lu",
+                        val_sz, val_esz, accdb->vinyl_scratch_sz ));
+        }
+        uchar * esrc = accdb->vinyl_scratch + val_sz;
+        ulong   sz0  = mmio_sz - val_off;
+        fd_memcpy( esrc,     mmio+val_off, sz0         );
+        fd_memcpy( esrc+sz0, mmio,         val_esz-sz0 );
+        src = (char const *)esrc;
+      }
+      int dsz = LZ4_decompress_safe( src, (char *)accdb->vinyl_scratch, (int)val_esz, (int)val_sz );
+      FD_COMPILER_MFENCE();
+      if( FD_UNLIKELY( FD_VOLATILE_CONST( phdr->ctl )!=ctl || !fd_vinyl_key_eq( &phdr->key, key ) ||
+                       fd_vinyl_meta_query_test( query ) ) ) { FD_SPIN_PAUSE(); continue; }
+      if( FD_UNLIKELY( dsz!=(int)val_sz ) ) {
+        FD_LOG_CRIT(( "rooted tier corruption detected: lz4 decode failed at seq %016lx", seq ));
+      }
+      acc = (fd_account_meta_t const *)accdb->vinyl_scratch;
+      break;
+    }
+#   endif
+
+    default:
+      FD_LOG_CRIT(( "rooted tier corruption detected: unsupported pair style %s", fd_vinyl_bstream_ctl_style_cstr( style ) ));
+    }
+
+    /* Confirm the location wasn't reused and the account wasn't
+       replaced while it was copied out */
+
+    FD_COMPILER_MFENCE();
+    stale = (FD_VOLATILE_CONST( phdr->ctl )!=ctl) | !fd_vinyl_key_eq( &phdr->key, key ) | fd_vinyl_meta_query_test( query );
+    FD_COMPILER_MFENCE();
+    if( FD_UNLIKELY( stale ) ) { FD_SPIN_PAUSE(); continue; }
+
+    /* The account was copied out, so the peek stays valid until the
+       next query (keyp refers to the peek's own copy of the key). */
+
+    peek->acc->rec  = NULL;
+    peek->acc->meta = acc;
+    memcpy( peek->spec->key.uc, address, 32UL );
+    peek->spec->keyp = fd_type_pun( peek->spec->key.uc );
+    return peek;
+  }
+}
+
+/* fd_accdb_vinyl_willneed asks the kernel to start reading the pages
+   of the store covering [off,off+sz) in the background.  This is a
+   no-op for pages that are already resident (e.g. if the store is in
+   memory).  Failures are ignored, this is only a hint. */
+
+static void
+fd_accdb_vinyl_willneed( uchar const * mmio,
+                         ulong         off,
+                         ulong         sz ) {
+  ulong lo = fd_ulong_align_dn( (ulong)mmio + off,    FD_SHMEM_NORMAL_PAGE_SZ );
+  ulong hi = fd_ulong_align_up( (ulong)mmio + off+sz, FD_SHMEM_NORMAL_PAGE_SZ );
+  (void)madvise( (void *)lo, hi-lo, MADV_WILLNEED );
+}
+
+/* fd_accdb_vinyl_prefetch locates an account in the rooted tier like
+   fd_accdb_vinyl_peek does, but it doesn't read the store (which could
+   block on a page fault).  Instead, it starts reading the pages that
+   hold the pair in the background, so that a subsequent peek is
+   served from memory.  Only the meta index is read, and the lookup is
+   not retried. */
+
+static int
+fd_accdb_vinyl_prefetch( fd_accdb_user_t * accdb,
+                         void const *      address ) {
+  fd_vinyl_meta_t * meta    = accdb->vinyl_meta;
+  uchar const *     mmio    = accdb->vinyl_mmio;
+  ulong             mmio_sz = accdb->vinyl_mmio_sz;
+
+  fd_vinyl_key_t key[1]; fd_vinyl_key_init( key, address, 32UL );
+
+  fd_vinyl_meta_query_t query[1];
+  if( FD_UNLIKELY( fd_vinyl_meta_query_try( meta, key, NULL, query, 0 ) ) ) return FD_ACCDB_PREFETCH_MISS;
+
+  fd_vinyl_meta_ele_t const * ele = fd_vinyl_meta_query_ele_const( query );
+  ulong ctl = ele->phdr.ctl;
+  ulong seq = ele->seq;
+
+  if( FD_UNLIKELY( fd_vinyl_meta_query_test( query ) ) ) return FD_ACCDB_PREFETCH_MISS;
+  if( FD_UNLIKELY( ctl==ULONG_MAX ) ) return FD_ACCDB_PREFETCH_MISS; /* being created */
+
+  /* The pair might wrap around the end of the store */
+
+  ulong off = seq % mmio_sz;
+  ulong sz  = fd_ulong_min( sizeof(fd_vinyl_bstream_phdr_t) + fd_vinyl_bstream_ctl_sz( ctl ), mmio_sz );
+  ulong sz0 = fd_ulong_min( sz, mmio_sz-off );
+  fd_accdb_vinyl_willneed( mmio, off, sz0 );
+  if( FD_UNLIKELY( sz0<sz ) ) fd_accdb_vinyl_willneed( mmio, 0UL, sz-sz0 );
+  return FD_ACCDB_PREFETCH_ROOT;
+}
+
+fd_accdb_user_t *
+fd_accdb_user_vinyl_attach( fd_accdb_user_t * accdb,
+                            fd_vinyl_meta_t * meta,
+                            void const *      mmio,
+                            ulong             mmio_sz,
+                            void *            scratch,
+                            ulong             scratch_sz ) {
+  if( FD_UNLIKELY( !accdb ) ) {
+    FD_LOG_WARNING(( "NULL accdb" ));
+    return NULL;
+  }
+  if( FD_UNLIKELY( !meta ) ) {
+    FD_LOG_WARNING(( "NULL meta" ));
+    return NULL;
+  }
+  if( FD_UNLIKELY( !mmio ) ) {
+    FD_LOG_WARNING(( "NULL mmio" ));
+    return NULL;
+  }
+  if( FD_UNLIKELY( !fd_ulong_is_aligned( (ulong)mmio, FD_VINYL_BSTREAM_BLOCK_SZ ) ) ) {
+    FD_LOG_WARNING(( "misaligned mmio" ));
+    return NULL;
+  }
+  if( FD_UNLIKELY( !mmio_sz || !fd_ulong_is_aligned( mmio_sz, FD_VINYL_BSTREAM_BLOCK_SZ ) ) ) {
+    FD_LOG_WARNING(( "bad mmio_sz" ));
+    return NULL;
+  }
+  if( FD_UNLIKELY( !scratch && scratch_sz ) ) {
+    FD_LOG_WARNING(( "NULL scratch" ));
+    return NULL;
+  }
+
+  accdb->vinyl_meta       = meta;
+  accdb->vinyl_mmio       = mmio;
+  accdb->vinyl_mmio_sz    = mmio_sz;
+  accdb->vinyl_scratch    = scratch;
+  accdb->vinyl_scratch_sz = scratch_sz;
+  accdb->root_peek        = fd_accdb_vinyl_peek;
+  accdb->root_prefetch    = fd_accdb_vinyl_prefetch;
+  return accdb;
+}
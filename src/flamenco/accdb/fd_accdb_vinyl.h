@@ -0,0 +1,85 @@
+#ifndef HEADER_fd_src_flamenco_accdb_fd_accdb_vinyl_h
+#define HEADER_fd_src_flamenco_accdb_fd_accdb_vinyl_h
+
+/* fd_accdb_vinyl.h provides APIs to back the rooted state of an account
+   database with a vinyl bstream ("two-tier" mode).
+
+   In two-tier mode, funk only holds the records of unrooted fork nodes
+   (and any records that were at the funk root before the vinyl tier was
+   attached).  When a fork node is rooted, its records are written to
+   the bstream and evicted from funk.  Queries that miss in funk fall
+   through to the bstream's meta index and read the account directly
+   from the memory mapped bstream.
+
+   Accounts are stored in the bstream as pairs keyed by account address
+   whose val is a fd_account_meta_t followed by the account data (style
+   RAW, see fd_accdb_fsck_vinyl).  Deleted accounts (zero lamports) are
+   erased from the bstream.
+
+   The admin is the only writer of the bstream.  It either drives a
+   fd_vinyl_t in-process or sends requests to the vinyl tile that owns
+   the bstream (fd_vinyl_client_t).  Any number of users can read the
+   bstream concurrently.
+   Users must be able to memory map the bstream store (e.g. io_mm).
+
+   fd_accdb_prefetch of an account in the rooted tier asks the kernel
+   to read the pages of the store holding the account ahead of use with
+   madvise(MADV_WILLNEED), so tiles that prefetch from a rooted tier
+   must allow that system call. */
+
+#include "fd_accdb_admin.h"
+#include "fd_accdb_sync.h"
+#include "../../vinyl/fd_vinyl.h"
+
+FD_PROTOTYPES_BEGIN
+
+/* fd_accdb_admin_vinyl_attach attaches the vinyl instance vinyl as the
+   rooted tier of the account database.  vinyl should have a val_max of
+   at least sizeof(fd_account_meta_t) (production instances should use
+   at least sizeof(fd_account_meta_t)+FD_RUNTIME_ACC_SZ_MAX; rooting an
+   account that does not fit is fatal).  The admin should be the only
+   user of vinyl while attached.  Returns admin on success and NULL on
+   failure (logs details). */
+
+fd_accdb_admin_t *
+fd_accdb_admin_vinyl_attach( fd_accdb_admin_t * admin,
+                             fd_vinyl_t *       vinyl );
+
+/* fd_accdb_admin_vinyl_attach_client is fd_accdb_admin_vinyl_attach
+   for a rooted tier run by a vinyl tile.  client is a client of the
+   vinyl tile's link (the admin should be its only client), data is
+   the caller's join to the vinyl tile's data region and line_cnt /
+   val_max are the vinyl tile's (same val_max requirements as above).
+   Background work (compaction, syncs) is left to the vinyl tile.
+   Returns admin on success and NULL on failure (logs details). */
+
+fd_accdb_admin_t *
+fd_accdb_admin_vinyl_attach_client( fd_accdb_admin_t *  admin,
+                                    fd_vinyl_client_t * client,
+                                    void *              data,
+                                    ulong               line_cnt,
+                                    ulong               val_max );
+
+/* fd_accdb_user_vinyl_attach attaches a rooted tier to an account
+   database user.  meta is a local join to the bstream's meta index,
+   mmio / mmio_sz give the caller's mapping of the bstream store (see
+   fd_vinyl_mmio).  scratch / scratch_sz give the region rooted
+   accounts are copied (or decoded, if compressed) into (should be at
+   least sizeof(fd_account_meta_t)+FD_RUNTIME_ACC_SZ_MAX and at least
+   twice the largest pair the rooted tier compresses as cold, reading an
+   account that does not fit is fatal).  Accounts read from the rooted tier are valid
+   until the next query by the user (they never point into the store,
+   which compaction can reuse at any time).  Returns accdb on success and
+   NULL on failure (logs details). */
+
+fd_accdb_user_t *
+fd_accdb_user_vinyl_attach( fd_accdb_user_t *  accdb,
+                            fd_vinyl_meta_t *  meta,
+                            void const *       mmio,
+                            ulong              mmio_sz,
+                            void *             scratch,
+                            ulong              scratch_sz );
+
+FD_PROTOTYPES_END
+
+#endif /* HEADER_fd_src_flamenco_accdb_fd_accdb_vinyl_h */
@@ -0,0 +1,303 @@
+#include "fd_accdb_vinyl.h"
+
+#define WKSP_TAG   1UL
+#define KEY_MAX    (256UL)
+#define DATA_MAX   (2048UL)
+#define VAL_MAX    (sizeof(fd_account_meta_t)+DATA_MAX)
+#define LINE_CNT   (8UL)
+#define ELE_MAX    (1024UL)
+#define DEV_SZ     (FD_VINYL_BSTREAM_BLOCK_SZ + (16UL<<20))
+#define SPAD_MAX   (65536UL)
+
+static uchar dev      [ DEV_SZ     ] __attribute__((aligned(FD_VINYL_BSTREAM_BLOCK_SZ)));
+static uchar io_mem   [ 1UL<<17    ] __attribute__((aligned(FD_VINYL_BSTREAM_BLOCK_SZ)));
+static uchar meta_mem [ 1UL<<16    ] __attribute__((aligned(128)));
+static uchar vinyl_mem[ 1UL<<17    ] __attribute__((aligned(FD_VINYL_ALIGN)));
+static uchar data_mem [ LINE_CNT*(VAL_MAX+1024UL) ] __attribute__((aligned(FD_VINYL_BSTREAM_BLOCK_SZ)));
+static uchar scratch  [ 2UL*VAL_MAX ];
+static uchar cold_mem [ 2UL*(VAL_MAX+2UL*FD_VINYL_BSTREAM_BLOCK_SZ) ] __attribute__((aligned(FD_VINYL_BSTREAM_BLOCK_SZ)));
+static fd_vinyl_meta_ele_t ele_mem[ ELE_MAX ];
+
+/* Reference model of an account */
+
+struct ref_acc {
+  ulong lamports; /* 0 if account does not exist */
+  ulong dlen;
+  ulong ver;
+};
+
+typedef struct ref_acc ref_acc_t;
+
+static ref_acc_t ref_root[ KEY_MAX ];
+static ref_acc_t ref_fork[ KEY_MAX ];
+static int       ref_fork_set[ KEY_MAX ];
+
+static uchar *
+addr_gen( uchar * addr,
+          ulong   k ) {
+  memset( addr, 0, 32UL );
+  FD_STORE( ulong, addr,      k                       );
+  FD_STORE( ulong, addr+24UL, fd_ulong_hash( k ) | 1UL );
+  return addr;
+}
+
+static void
+data_gen( uchar * data,
+          ulong   dlen,
+          ulong   k,
+          ulong   ver ) {
+  ulong x = fd_ulong_hash( (k<<32) ^ ver );
+  if( k & 1UL ) for( ulong b=0UL; b<dlen; b++ ) data[b] = (uchar)(x >> ((b & 7UL)<<3)); /* compressible */
+  else          for( ulong b=0UL; b<dlen; b++ ) { data[b] = (uchar)x; x = fd_ulong_hash( x ); }
+}
+
+static uchar data_buf[ DATA_MAX ];
+
+/* check_peek verifies that the account k as seen by accdb at xid
+   matches ref, and that a prefetch of the account finds it in the same
+   tier as the peek.  Returns 1 if the account was served from the
+   rooted tier. */
+
+static int
+check_peek( fd_accdb_user_t *         accdb,
+            fd_funk_txn_xid_t const * xid,
+            ulong                     k,
+            ref_acc_t const *         ref ) {
+  uchar addr[32]; addr_gen( addr, k );
+  int prefetch = fd_accdb_prefetch( accdb, xid, addr );
+  fd_accdb_peek_t peek[1];
+  if( !fd_accdb_peek( accdb, peek, xid, addr ) ) {
+    FD_TEST( !ref->lamports );
+    FD_TEST( prefetch==FD_ACCDB_PREFETCH_MISS );
+    return 0;
+  }
+  FD_TEST( fd_accdb_ref_lamports( peek->acc )==ref->lamports );
+  if( ref->lamports ) {
+    FD_TEST( fd_accdb_ref_data_sz( peek->acc )==ref->dlen );
+    data_gen( data_buf, ref->dlen, k, ref->ver );
+    FD_TEST( !memcmp( fd_accdb_ref_data_const( peek->acc ), data_buf, ref->dlen ) );
+  }
+  FD_TEST( fd_accdb_peek_test( peek ) );
+  int rooted = !peek->acc->rec;
+  if( rooted ) FD_TEST( (ulong)peek->acc->meta==(ulong)scratch ); /* copied out of the store */
+  FD_TEST( prefetch==( rooted ? FD_ACCDB_PREFETCH_ROOT : FD_ACCDB_PREFETCH_FUNK ) );
+  fd_accdb_peek_drop( peek );
+  return rooted;
+}
+
+/* funk_rec_cnt returns the number of records in the funk index */
+
+static ulong
+funk_rec_cnt( fd_funk_t * funk ) {
+  ulong cnt       = 0UL;
+  ulong chain_cnt = fd_funk_rec_map_chain_cnt( funk->rec_map );
+  for( ulong chain_idx=0UL; chain_idx<chain_cnt; chain_idx++ ) {
+    for( fd_funk_rec_map_iter_t iter = fd_funk_rec_map_iter( funk->rec_map, chain_idx );
+         !fd_funk_rec_map_iter_done( iter );
+         iter = fd_funk_rec_map_iter_next( iter ) ) cnt++;
+  }
+  return cnt;
+}
+
+static ulong ver_next = 1UL;
+
+static void
+write_acc( fd_accdb_user_t *         accdb,
+           fd_funk_txn_xid_t const * xid,
+           ulong                     k,
+           fd_rng_t *                rng ) {
+  uchar addr[32]; addr_gen( addr, k );
+
+  ulong lamports = (fd_rng_uint_roll( rng, 8U ) ? 1UL + fd_rng_ulong_roll( rng, 1000000UL ) : 0UL );
+  ulong dlen     = fd_rng_ulong_roll( rng, DATA_MAX+1UL );
+  ulong ver      = ver_next++;
+
+  fd_accdb_rw_t rw[1];
+  FD_TEST( fd_accdb_modify_prepare( accdb, rw, xid, addr, dlen, 1 ) );
+  fd_accdb_ref_lamports_set( rw, lamports );
+  data_gen( data_buf, dlen, k, ver );
+  fd_accdb_ref_data_set( rw, data_buf, dlen );
+  fd_accdb_write_publish( accdb, rw );
+
+  ref_fork    [ k ] = (ref_acc_t){ .lamports = lamports, .dlen = dlen, .ver = ver };
+  ref_fork_set[ k ] = 1;
+}
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  char const * _page_sz = fd_env_strip_cmdline_cstr ( &argc, &argv, "--page-sz",   NULL,      "gigantic" );
+  ulong        page_cnt = fd_env_strip_cmdline_ulong( &argc, &argv, "--page-cnt",  NULL,             1UL );
+  ulong        near_cpu = fd_env_strip_cmdline_ulong( &argc, &argv, "--near-cpu",  NULL, fd_log_cpu_id() );
+  ulong        seed     = fd_env_strip_cmdline_ulong( &argc, &argv, "--seed",      NULL,          5678UL );
+  ulong        slot_cnt = fd_env_strip_cmdline_ulong( &argc, &argv, "--slot-cnt",  NULL,          4096UL );
+
+  fd_rng_t _rng[1]; fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, (uint)seed, 0UL ) );
+
+  FD_LOG_NOTICE(( "using an anonymous local workspace, --page-sz %s, --page-cnt %lu, --near-cpu %lu",
+                  _page_sz, page_cnt, near_cpu ));
+  fd_wksp_t * wksp = fd_wksp_new_anonymous( fd_cstr_to_shmem_page_sz( _page_sz ), page_cnt, near_cpu, "wksp", 0UL );
+  if( FD_UNLIKELY( !wksp ) ) FD_LOG_ERR(( "Unable to attach to wksp" ));
+
+  /* Create funk (unrooted tier) */
+
+  ulong txn_max = 16UL;
+  ulong rec_max = 1024UL;
+  void * shfunk = fd_wksp_alloc_laddr( wksp, fd_funk_align(), fd_funk_footprint( txn_max, rec_max ), WKSP_TAG );
+  FD_TEST( shfunk );
+  FD_TEST( fd_funk_new( shfunk, WKSP_TAG, seed, txn_max, rec_max ) );
+
+  /* Create vinyl (rooted tier) */
+
+  fd_vinyl_io_t * io = fd_vinyl_io_mm_init( io_mem, SPAD_MAX, dev, DEV_SZ, 1, NULL, 0UL, seed );
+  FD_TEST( io );
+
+  ulong lock_cnt  = fd_vinyl_meta_lock_cnt_est ( ELE_MAX );
+  ulong probe_max = fd_vinyl_meta_probe_max_est( ELE_MAX );
+  FD_TEST( fd_vinyl_meta_footprint( ELE_MAX, lock_cnt, probe_max )<=sizeof(meta_mem) );
+  FD_TEST( fd_vinyl_meta_new( meta_mem, ELE_MAX, lock_cnt, probe_max, seed )==meta_mem );
+  fd_vinyl_meta_t meta[1]; FD_TEST( fd_vinyl_meta_join( meta, meta_mem, ele_mem )==meta );
+
+  void * mmio    = fd_vinyl_mmio   ( io );
+  ulong  mmio_sz = fd_vinyl_mmio_sz( io );
+
+  fd_vinyl_compact_t compact[1];
+  FD_TEST( fd_vinyl_compact_init( compact, mmio_sz, 0UL, 1UL<<20, 1, 1.f, 1L<<24, fd_log_wallclock() )==compact );
+  FD_TEST( fd_vinyl_compact_cold( compact, FD_VINYL_BSTREAM_CTL_STYLE_LZ4, cold_mem, sizeof(cold_mem) )==compact );
+
+  FD_TEST( fd_vinyl_footprint     ( LINE_CNT, VAL_MAX )<=sizeof(vinyl_mem) );
+  FD_TEST( fd_vinyl_data_footprint( LINE_CNT, VAL_MAX )<=sizeof(data_mem ) );
+  fd_vinyl_t * vinyl = fd_vinyl_init( vinyl_mem, LINE_CNT, VAL_MAX, io, mmio_sz, meta, data_mem, compact );
+  FD_TEST( vinyl );
+
+  /* Join accdb */
+
+  fd_accdb_admin_t admin[1]; FD_TEST( fd_accdb_admin_join( admin, shfunk ) );
+  fd_accdb_user_t  accdb[1]; FD_TEST( fd_accdb_user_join ( accdb, shfunk ) );
+
+  fd_vinyl_client_t client[1]; /* only validated here, see test_vinyl for the link itself */
+  FD_TEST( !fd_accdb_admin_vinyl_attach_client( NULL,  client, data_mem,      LINE_CNT, VAL_MAX ) );
+  FD_TEST( !fd_accdb_admin_vinyl_attach_client( admin, NULL,   data_mem,      LINE_CNT, VAL_MAX ) );
+  FD_TEST( !fd_accdb_admin_vinyl_attach_client( admin, client, NULL,          LINE_CNT, VAL_MAX ) );
+  FD_TEST( !fd_accdb_admin_vinyl_attach_client( admin, client, data_mem+1UL,  LINE_CNT, VAL_MAX ) );
+  FD_TEST( !fd_accdb_admin_vinyl_attach_client( admin, client, data_mem,      0UL,      VAL_MAX ) );
+  FD_TEST( !fd_accdb_admin_vinyl_attach_client( admin, client, data_mem,      LINE_CNT, 8UL     ) );
+  FD_TEST( fd_accdb_admin_vinyl_attach_client( admin, client, data_mem, LINE_CNT, VAL_MAX )==admin );
+  FD_TEST( admin->vinyl_client==client && !admin->vinyl );
+
+  FD_TEST( !fd_accdb_admin_vinyl_attach( NULL,  vinyl ) );
+  FD_TEST( !fd_accdb_admin_vinyl_attach( admin, NULL  ) );
+  FD_TEST( fd_accdb_admin_vinyl_attach( admin, vinyl )==admin );
+
+  FD_TEST( !fd_accdb_prefetch_enabled( accdb ) );
+  FD_TEST( !fd_accdb_user_vinyl_attach( NULL,  meta, mmio,                mmio_sz,       scratch, sizeof(scratch) ) );
+  FD_TEST( !fd_accdb_user_vinyl_attach( accdb, NULL, mmio,                mmio_sz,       scratch, sizeof(scratch) ) );
+  FD_TEST( !fd_accdb_user_vinyl_attach( accdb, meta, NULL,                mmio_sz,       scratch, sizeof(scratch) ) );
+  FD_TEST( !fd_accdb_user_vinyl_attach( accdb, meta, (uchar *)mmio+1UL,   mmio_sz,       scratch, sizeof(scratch) ) );
+  FD_TEST( !fd_accdb_user_vinyl_attach( accdb, meta, mmio,                0UL,           scratch, sizeof(scratch) ) );
+  FD_TEST( !fd_accdb_user_vinyl_attach( accdb, meta, mmio,                mmio_sz-1UL,   scratch, sizeof(scratch) ) );
+  FD_TEST( !fd_accdb_user_vinyl_attach( accdb, meta, mmio,                mmio_sz,       NULL,    sizeof(scratch) ) );
+  FD_TEST( fd_accdb_user_vinyl_attach( accdb, meta, mmio, mmio_sz, scratch, sizeof(scratch) )==accdb );
+  FD_TEST( fd_accdb_prefetch_enabled( accdb ) );
+
+  /* Root a chain of slots.  Each slot also gets a sibling fork that is
+     pruned when the slot is rooted. */
+
+  fd_funk_txn_xid_t root[1]; fd_funk_txn_xid_copy( root, fd_funk_last_publish( admin->funk ) );
+  ulong rooted_hit = 0UL;
+
+  for( ulong slot=1UL; slot<=slot_cnt; slot++ ) {
+    fd_funk_txn_xid_t xid    [1] = {{ .ul = { slot, 0UL } }};
+    fd_funk_txn_xid_t sibling[1] = {{ .ul = { slot, 1UL } }};
+    fd_accdb_attach_child( admin, root, xid     );
+    fd_accdb_attach_child( admin, root, sibling );
+
+    memset( ref_fork_set, 0, sizeof(ref_fork_set) );
+
+    ulong write_cnt = 1UL + fd_rng_ulong_roll( rng, 32UL );
+    for( ulong i=0UL; i<write_cnt; i++ ) write_acc( accdb, xid, fd_rng_ulong_roll( rng, KEY_MAX ), rng );
+
+    /* Writes to the sibling should not be visible and should be
+       discarded */
+
+    for( ulong i=0UL; i<4UL; i++ ) {
+      ulong k = fd_rng_ulong_roll( rng, KEY_MAX );
+      ref_acc_t save = ref_fork[ k ]; int save_set = ref_fork_set[ k ];
+      write_acc( accdb, sibling, k, rng );
+      ref_fork[ k ] = save; ref_fork_set[ k ] = save_set;
+    }
+
+    /* Reads through the fork fall through to the rooted tier for
+       accounts not modified on the fork */
+
+    for( ulong k=0UL; k<KEY_MAX; k++ ) {
+      int rooted = check_peek( accdb, xid, k, ref_fork_set[ k ] ? ref_fork+k : ref_root+k );
+      if( ref_fork_set[ k ] ) FD_TEST( !rooted );
+      rooted_hit += (ulong)rooted;
+    }
+
+    fd_accdb_advance_root( admin, xid );
+    *root = *xid;
+
+    for( ulong k=0UL; k<KEY_MAX; k++ ) if( ref_fork_set[ k ] ) ref_root[ k ] = ref_fork[ k ];
+
+    /* All records were evicted from funk */
+
+    FD_TEST( !funk_rec_cnt( admin->funk ) );
+
+    if( !(slot & 255UL) ) {
+      FD_LOG_NOTICE(( "slot %lu: rooted_hit %lu seq_present %lu pair_cnt %lu compact free_sz %lu",
+                      slot, rooted_hit, io->seq_present, vinyl->pair_cnt, compact->free_sz ));
+      fd_accdb_verify( admin );
+    }
+  }
+
+  /* Verify the rooted state (from the root itself) */
+
+  ulong live_cnt = 0UL;
+  for( ulong k=0UL; k<KEY_MAX; k++ ) {
+    if( ref_root[ k ].lamports ) FD_TEST( check_peek( accdb, root, k, ref_root+k ) );
+    else                         check_peek( accdb, root, k, ref_root+k );
+    live_cnt += (ulong)!!ref_root[ k ].lamports;
+  }
+  FD_TEST( vinyl->pair_cnt==live_cnt );
+  FD_TEST( io->seq_present>mmio_sz ); /* store wrapped around */
+  FD_TEST( compact->free_sz );
+  FD_TEST( compact->cold_cnt ); /* cold accounts were compressed (and peeks above decoded them) */
+
+  /* Modifying a rooted tier account copies it into funk */
+
+  do {
+    ulong k = 0UL; while( !ref_root[ k ].lamports ) k++;
+    fd_funk_txn_xid_t xid[1] = {{ .ul = { slot_cnt+1UL, 0UL } }};
+    fd_accdb_attach_child( admin, root, xid );
+    uchar addr[32]; addr_gen( addr, k );
+    fd_accdb_rw_t rw[1];
+    FD_TEST( fd_accdb_modify_prepare( accdb, rw, xid, addr, 0UL, 0 ) );
+    FD_TEST( rw->rec && !rw->published );
+    FD_TEST( fd_accdb_ref_lamports( rw->ro )==ref_root[ k ].lamports );
+    FD_TEST( fd_accdb_ref_data_sz ( rw->ro )==ref_root[ k ].dlen     );
+    fd_accdb_write_publish( accdb, rw );
+    FD_TEST( !check_peek( accdb, xid, k, ref_root+k ) );
+    fd_accdb_cancel( admin, xid );
+    FD_TEST( check_peek( accdb, root, k, ref_root+k ) );
+  } while(0);
+
+  /* Clean up */
+
+  fd_accdb_user_leave ( accdb, NULL );
+  fd_accdb_admin_leave( admin, NULL );
+  FD_TEST( fd_vinyl_fini( vinyl )==vinyl_mem );
+  fd_vinyl_meta_leave( meta );
+  fd_vinyl_meta_delete( meta_mem );
+  FD_TEST( fd_vinyl_io_fini( io )==io_mem );
+  fd_wksp_free_laddr( fd_funk_delete( shfunk ) );
+  fd_wksp_delete_anonymous( wksp );
+  fd_rng_delete( fd_rng_leave( rng ) );
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
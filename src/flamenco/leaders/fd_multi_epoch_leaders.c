@@ -22,6 +22,9 @@ fd_multi_epoch_leaders_new( void * shmem ) {
     FD_TEST( leaders->lsched[i] );
     leaders->init_done[i] = 0;
   }
+  leaders->staged_lsched = fd_epoch_leaders_join( fd_epoch_leaders_new( leaders->_lsched[MULTI_EPOCH_LEADERS_EPOCH_CNT], 0UL, 0UL, 1UL, 1UL, dummy_stakes, 0UL, leaders->scratch->vote_keyed_lsched ) );
+  FD_TEST( leaders->staged_lsched );
+  leaders->staged_done = 0;
 
   return shmem;
 }
@@ -110,7 +113,7 @@ fd_multi_epoch_leaders_stake_msg_init( fd_multi_epoch_leaders_t    * mleaders,
   fd_memcpy( mleaders->vote_stake_weight, msg->weights, msg->staked_cnt*sizeof(fd_vote_stake_weight_t) );
 }
 
-void
+int
 fd_multi_epoch_leaders_stake_msg_fini( fd_multi_epoch_leaders_t * mleaders ) {
   const ulong epoch          = mleaders->scratch->epoch;
   const ulong slot0          = mleaders->scratch->start_slot;
@@ -122,15 +125,59 @@ fd_multi_epoch_leaders_stake_msg_fini( fd_multi_epoch_leaders_t * mleaders ) {
 
   fd_vote_stake_weight_t * stakes = mleaders->vote_stake_weight;
 
+  if( FD_LIKELY( mleaders->staged_done && mleaders->staged->epoch==epoch ) ) {
+    mleaders->staged_done = 0;
+    if( FD_LIKELY( !memcmp( mleaders->staged, mleaders->scratch, sizeof(mleaders->scratch) ) &&
+                   !memcmp( mleaders->staged_weight, stakes, pub_cnt*sizeof(fd_vote_stake_weight_t) ) ) ) {
+      /* The staged schedule was computed from the same message, swap it
+         in.  The old one becomes the memory for the next staging. */
+      fd_epoch_leaders_t * old_lsched = mleaders->lsched[epoch_idx];
+      mleaders->lsched[epoch_idx]    = mleaders->staged_lsched;
+      mleaders->staged_lsched        = old_lsched;
+      mleaders->init_done[epoch_idx] = 1;
+      return 1;
+    }
+  }
+
   /* Clear old data */
-  fd_epoch_leaders_delete( fd_epoch_leaders_leave( mleaders->lsched[epoch_idx] ) );
+  uchar * lsched_mem = fd_epoch_leaders_delete( fd_epoch_leaders_leave( mleaders->lsched[epoch_idx] ) );
 
   /* Populate new lsched */
-  uchar *  lsched_mem        = mleaders->_lsched[epoch_idx];
   mleaders->lsched[epoch_idx] = fd_epoch_leaders_join( fd_epoch_leaders_new(
                                     lsched_mem, epoch, slot0, slot_cnt,
                                     pub_cnt, stakes, excluded_stake, vote_keyed_lsched ) );
   mleaders->init_done[epoch_idx] = 1;
+  return 0;
+}
+
+void
+fd_multi_epoch_leaders_stake_msg_stage_init( fd_multi_epoch_leaders_t    * mleaders,
+                                             fd_stake_weight_msg_t const * msg ) {
+  if( FD_UNLIKELY( msg->staked_cnt > MAX_STAKED_LEADERS ) )
+    FD_LOG_ERR(( "Multi-epoch leaders received a malformed staged update with %lu stakes in it,"
+                 " but the maximum allowed is %lu", msg->staked_cnt, MAX_STAKED_LEADERS ));
+
+  mleaders->staged_done = 0;
+
+  mleaders->staged->epoch             = msg->epoch;
+  mleaders->staged->start_slot        = msg->start_slot;
+  mleaders->staged->slot_cnt          = msg->slot_cnt;
+  mleaders->staged->staked_cnt        = msg->staked_cnt;
+  mleaders->staged->excluded_stake    = msg->excluded_stake;
+  mleaders->staged->vote_keyed_lsched = msg->vote_keyed_lsched;
+
+  fd_memcpy( mleaders->staged_weight, msg->weights, msg->staked_cnt*sizeof(fd_vote_stake_weight_t) );
+}
+
+void
+fd_multi_epoch_leaders_stake_msg_stage_fini( fd_multi_epoch_leaders_t * mleaders ) {
+  uchar * lsched_mem = fd_epoch_leaders_delete( fd_epoch_leaders_leave( mleaders->staged_lsched ) );
+
+  mleaders->staged_lsched = fd_epoch_leaders_join( fd_epoch_leaders_new(
+                                lsched_mem, mleaders->staged->epoch, mleaders->staged->start_slot, mleaders->staged->slot_cnt,
+                                mleaders->staged->staked_cnt, mleaders->staged_weight, mleaders->staged->excluded_stake,
+                                mleaders->staged->vote_keyed_lsched ) );
+  mleaders->staged_done = 1;
 }
 
 fd_pubkey_t const *
@@ -22,6 +22,9 @@ struct fd_multi_epoch_leaders_priv {
 
   /* has that epoch's mem experienced a stake_msg_fini? */
   int                  init_done    [ MULTI_EPOCH_LEADERS_EPOCH_CNT ];
+
+  /* scratch describes the message of the last stake_msg_init and
+     staged the message of the last stake_msg_stage_init. */
   struct {
     ulong epoch;
     ulong start_slot;
@@ -29,9 +32,18 @@ struct fd_multi_epoch_leaders_priv {
     ulong staked_cnt;
     ulong excluded_stake;
     ulong vote_keyed_lsched;
-  } scratch[1];
-
-  _lsched_t _lsched[MULTI_EPOCH_LEADERS_EPOCH_CNT];
+  } scratch[1], staged[1];
+
+  /* staged_lsched is a leader schedule computed ahead of time from
+     staged_weight (see fd_multi_epoch_leaders_stake_msg_stage_init).
+     It is always joined, but only valid if staged_done is set.  The
+     lsched objects use the memory of _lsched in no particular order:
+     confirming a staged schedule swaps it with the one it replaces. */
+  fd_epoch_leaders_t *   staged_lsched;
+  int                    staged_done;
+  fd_vote_stake_weight_t staged_weight[ MAX_STAKED_LEADERS ];
+
+  _lsched_t _lsched[MULTI_EPOCH_LEADERS_EPOCH_CNT+1UL];
 };
 typedef struct fd_multi_epoch_leaders_priv fd_multi_epoch_leaders_priv_t;
 
@@ -175,9 +187,32 @@ void
 fd_multi_epoch_leaders_stake_msg_init( fd_multi_epoch_leaders_t    * mleaders,
                                        fd_stake_weight_msg_t const * msg );
 
-void
+int
 fd_multi_epoch_leaders_stake_msg_fini( fd_multi_epoch_leaders_t * mleaders );
 
+/* fd_multi_epoch_leaders_stake_msg_stage_{init,fini} compute the leader
+   schedule of a stake weights message that is expected to arrive later
+   (e.g. the next epoch's stake weights, as projected before the epoch
+   boundary) ahead of time, off the critical path.  They follow the same
+   init/fini model and msg requirements as stake_msg_{init,fini} and do
+   not affect the schedules being queried or a pending stake_msg_init.
+   At most one message is staged at a time, staging another one
+   discards the previous one.
+
+   If the message given to the next stake_msg_init for the same epoch
+   is identical to the staged one (same header and same weights), the
+   following stake_msg_fini just swaps in the staged schedule instead of
+   computing it, and returns 1.  Otherwise, it computes the schedule as
+   usual, discards the staged schedule if it was for the same epoch, and
+   returns 0.  Either way, the resulting schedule is the same. */
+
+void
+fd_multi_epoch_leaders_stake_msg_stage_init( fd_multi_epoch_leaders_t    * mleaders,
+                                             fd_stake_weight_msg_t const * msg );
+
+void
+fd_multi_epoch_leaders_stake_msg_stage_fini( fd_multi_epoch_leaders_t * mleaders );
+
 
 FD_PROTOTYPES_END
 
@@ -313,6 +313,72 @@ test_get_sorted_lscheds( void ) {
   fd_multi_epoch_leaders_delete( fd_multi_epoch_leaders_leave( mleaders ) );
 }
 
+static void
+test_staged( void ) {
+  static fd_pubkey_t expected[ SLOTS_PER_EPOCH ];
+
+  /* Reference schedule for epoch 1 computed the usual way */
+  fd_multi_epoch_leaders_t * mleaders = fd_multi_epoch_leaders_join( fd_multi_epoch_leaders_new( mleaders_mem ) );
+  fd_multi_epoch_leaders_stake_msg_init( mleaders, generate_stake_msg( stake_msg, 1UL, "ABCDE" ) );
+  FD_TEST( !fd_multi_epoch_leaders_stake_msg_fini( mleaders ) );
+  for( ulong s=0UL; s<SLOTS_PER_EPOCH; s++ ) expected[ s ] = *fd_multi_epoch_leaders_get_leader_for_slot( mleaders, SLOTS_PER_EPOCH+s );
+  fd_multi_epoch_leaders_delete( fd_multi_epoch_leaders_leave( mleaders ) );
+
+  mleaders = fd_multi_epoch_leaders_join( fd_multi_epoch_leaders_new( mleaders_mem ) );
+  fd_multi_epoch_leaders_stake_msg_init( mleaders, generate_stake_msg( stake_msg, 0UL, "ABC" ) );
+  FD_TEST( !fd_multi_epoch_leaders_stake_msg_fini( mleaders ) );
+
+  /* Staging does not affect queries */
+  fd_multi_epoch_leaders_stake_msg_stage_init( mleaders, generate_stake_msg( stake_msg, 1UL, "ABCDE" ) );
+  fd_multi_epoch_leaders_stake_msg_stage_fini( mleaders );
+  check_leaders( mleaders, 0UL, "ABC" );
+  check_leaders( mleaders, 1UL, NULL );
+
+  /* A matching message swaps in the staged schedule, which is the same
+     as the one computed the usual way. */
+  fd_multi_epoch_leaders_stake_msg_init( mleaders, generate_stake_msg( stake_msg, 1UL, "ABCDE" ) );
+  FD_TEST( fd_multi_epoch_leaders_stake_msg_fini( mleaders ) );
+  check_leaders( mleaders, 0UL, "ABC" );
+  check_leaders( mleaders, 1UL, "ABCDE" );
+  for( ulong s=0UL; s<SLOTS_PER_EPOCH; s++ ) {
+    FD_TEST( !memcmp( fd_multi_epoch_leaders_get_leader_for_slot( mleaders, SLOTS_PER_EPOCH+s ), expected+s, sizeof(fd_pubkey_t) ) );
+  }
+
+  /* The staged schedule is consumed */
+  fd_multi_epoch_leaders_stake_msg_init( mleaders, generate_stake_msg( stake_msg, 1UL, "ABCDE" ) );
+  FD_TEST( !fd_multi_epoch_leaders_stake_msg_fini( mleaders ) );
+  check_leaders( mleaders, 1UL, "ABCDE" );
+
+  /* A different message for the staged epoch discards it */
+  fd_multi_epoch_leaders_stake_msg_stage_init( mleaders, generate_stake_msg( stake_msg, 2UL, "ABCF" ) );
+  fd_multi_epoch_leaders_stake_msg_stage_fini( mleaders );
+  fd_multi_epoch_leaders_stake_msg_init( mleaders, generate_stake_msg( stake_msg, 2UL, "ABCG" ) );
+  FD_TEST( !fd_multi_epoch_leaders_stake_msg_fini( mleaders ) );
+  check_leaders( mleaders, 2UL, "ABCG" );
+  fd_multi_epoch_leaders_stake_msg_init( mleaders, generate_stake_msg( stake_msg, 2UL, "ABCF" ) );
+  FD_TEST( !fd_multi_epoch_leaders_stake_msg_fini( mleaders ) );
+  check_leaders( mleaders, 2UL, "ABCF" );
+
+  /* A message for another epoch keeps it */
+  fd_multi_epoch_leaders_stake_msg_stage_init( mleaders, generate_stake_msg( stake_msg, 4UL, "HI" ) );
+  fd_multi_epoch_leaders_stake_msg_stage_fini( mleaders );
+  fd_multi_epoch_leaders_stake_msg_init( mleaders, generate_stake_msg( stake_msg, 3UL, "DE" ) );
+  FD_TEST( !fd_multi_epoch_leaders_stake_msg_fini( mleaders ) );
+  fd_multi_epoch_leaders_stake_msg_init( mleaders, generate_stake_msg( stake_msg, 4UL, "HI" ) );
+  FD_TEST( fd_multi_epoch_leaders_stake_msg_fini( mleaders ) );
+  check_leaders( mleaders, 3UL, "DE" );
+  check_leaders( mleaders, 4UL, "HI" );
+
+  /* An unfinished staging is never used */
+  fd_multi_epoch_leaders_stake_msg_stage_init( mleaders, generate_stake_msg( stake_msg, 5UL, "J" ) );
+  fd_multi_epoch_leaders_stake_msg_init( mleaders, generate_stake_msg( stake_msg, 5UL, "J" ) );
+  FD_TEST( !fd_multi_epoch_leaders_stake_msg_fini( mleaders ) );
+  check_leaders( mleaders, 4UL, "HI" );
+  check_leaders( mleaders, 5UL, "J" );
+
+  fd_multi_epoch_leaders_delete( fd_multi_epoch_leaders_leave( mleaders ) );
+}
+
 int
 main( int     argc,
       char ** argv ) {
@@ -326,6 +392,7 @@ main( int     argc,
   test_next_slot();
   test_limits();
   test_get_sorted_lscheds();
+  test_staged();
 
   FD_LOG_NOTICE(( "pass" ));
   fd_halt();
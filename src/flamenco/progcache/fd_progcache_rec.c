@@ -10,7 +10,8 @@ fd_progcache_rec_new( void *                          mem,
                       void const *                    progdata,
                       ulong                           progdata_sz,
                       void *                          scratch,
-                      ulong                           scratch_sz ) {
+                      ulong                           scratch_sz,
+                      ulong                           jit_tag ) {
 
   /* Format object */
 
@@ -23,10 +24,12 @@ fd_progcache_rec_new( void *                          mem,
     /*               */calldests_mem = FD_SCRATCH_ALLOC_APPEND( l, fd_sbpf_calldests_align(), fd_sbpf_calldests_footprint( elf_info->text_cnt ) );
   }
   void *               rodata_mem    = FD_SCRATCH_ALLOC_APPEND( l, 8UL,                       elf_info->bin_sz );
+  void *               tcode_mem     = FD_SCRATCH_ALLOC_APPEND( l, fd_vm_tcode_align(),       fd_vm_tcode_footprint( elf_info->text_cnt ) );
   FD_SCRATCH_ALLOC_FINI( l, fd_progcache_rec_align() );
   memset( rec, 0, sizeof(fd_progcache_rec_t) );
   rec->calldests_off = has_calldests ? (uint)( (ulong)calldests_mem - (ulong)mem ) : 0U;
   rec->rodata_off    = (uint)( (ulong)rodata_mem - (ulong)mem );
+  rec->tcode_off     = (uint)( (ulong)tcode_mem  - (ulong)mem );
 
   rec->text_cnt      = elf_info->text_cnt;
   rec->text_off      = elf_info->text_off;
@@ -94,8 +97,13 @@ fd_progcache_rec_new( void *                          mem,
 
   if( FD_UNLIKELY( fd_vm_validate( vm )!=FD_VM_SUCCESS ) ) return NULL;
 
+  /* Pre-decode bytecode for the interpreter */
+
+  fd_vm_tcode_build( tcode_mem, vm );
+
   rec->slot       = load_slot;
   rec->executable = 1;
+  rec->jit_tag    = jit_tag;
   return rec;
 }
 
@@ -3,6 +3,7 @@
 
 #include "../fd_flamenco_base.h"
 #include "../../ballet/sbpf/fd_sbpf_loader.h"
+#include "../vm/fd_vm_tcode.h"
 
 /* fd_progcache_rec_t is the fixed size header of a program cache entry
    object.  Entries are either non-executable (e.g. programs that failed
@@ -25,10 +26,16 @@ struct fd_progcache_rec {
 
   uint calldests_off;  /* offset to sbpf_calldests map */
   uint rodata_off;     /* offset to rodata segment */
+  uint tcode_off;      /* offset to pre-decoded text (fd_vm_tcode_t[ text_cnt ]) */
 
   /* SBPF version, SIMD-0161 */
   uchar sbpf_version;
 
+  /* Non-zero tag identifying this entry's program in tile-local JIT
+     caches (see fd_vm_jit_cache.h and fd_progcache_user.c).  0 for
+     non-executable entries. */
+  ulong jit_tag;
+
   uint executable : 1;  /* is this an executable entry? */
   uint invalidate : 1;  /* if ==1, limits visibility of this entry to this slot */
 };
@@ -49,6 +56,11 @@ fd_progcache_rec_calldests( fd_progcache_rec_t const * rec ) {
   return fd_sbpf_calldests_join( (void *)( (ulong)rec + rec->calldests_off ) );
 }
 
+static inline fd_vm_tcode_t const *
+fd_progcache_rec_tcode( fd_progcache_rec_t const * rec ) {
+  return (fd_vm_tcode_t const *)( (ulong)rec + rec->tcode_off );
+}
+
 /* Private APIs */
 
 /* fd_progcache_rec_{align,footprint} give the params of backing memory
@@ -73,14 +85,17 @@ fd_progcache_rec_footprint( fd_sbpf_elf_info_t const * elf_info ) {
     l = FD_LAYOUT_APPEND( l, fd_sbpf_calldests_align(), fd_sbpf_calldests_footprint( pc_max ) );
   }
   l = FD_LAYOUT_APPEND( l, 8UL, elf_info->bin_sz );
+  l = FD_LAYOUT_APPEND( l, fd_vm_tcode_align(), fd_vm_tcode_footprint( elf_info->text_cnt ) );
   return FD_LAYOUT_FINI( l, fd_progcache_rec_align() );
 }
 
 /* fd_progcache_rec_new creates a new excutable progcache_rec object.
    mem points to a memory region matching fd_progcache_rec_{align,
    footprint}.   Loads and verifies the given program data and returns
-   the newly created executable object on success.  On failure, returns
-   NULL (the caller may call fd_progcache_rec_new_nx instead). */
+   the newly created executable object on success.  jit_tag is the
+   entry's non-zero JIT tag (unique among the entries the program cache
+   has ever held).  On failure, returns NULL (the caller may call
+   fd_progcache_rec_new_nx instead). */
 
 fd_progcache_rec_t *
 fd_progcache_rec_new( void *                          mem,
@@ -91,7 +106,8 @@ fd_progcache_rec_new( void *                          mem,
                       void const *                    progdata,
                       ulong                           progdata_sz,
                       void *                          scratch,
-                      ulong                           scratch_sz );
+                      ulong                           scratch_sz,
+                      ulong                           jit_tag );
 
 /* fd_progcache_rec_new_nx creates a non-executable program_cache
    object.  fd_progcache_rec_t[1] is suitable for mem. */
@@ -557,7 +557,19 @@ fd_progcache_insert( fd_progcache_t *           cache,
                   rec_align, rec_footprint ));
     }
 
-    rec = fd_progcache_rec_new( rec_mem, elf_info, &config, load_slot, features, progdata, progdata_sz, cache->scratch, cache->scratch_sz );
+    /* The JIT tag combines the program key with a generation number
+       drawn from a counter shared by all users of the cache (funk's
+       cycle_tag, which only increases).  As fd_ulong_hash is a
+       bijection, entries of the same program do not share a tag, even
+       if an entry reuses the memory of an evicted one (JIT caches also
+       check the text on a hit).  0 is reserved for non-executable
+       entries. */
+
+    ulong gen     = FD_ATOMIC_FETCH_AND_ADD( &funk->shmem->cycle_tag, 1UL );
+    ulong jit_tag = fd_ulong_hash( fd_hash( funk->shmem->seed, prog_addr, 32UL ) ^ gen );
+    jit_tag = fd_ulong_if( !!jit_tag, jit_tag, 1UL );
+
+    rec = fd_progcache_rec_new( rec_mem, elf_info, &config, load_slot, features, progdata, progdata_sz, cache->scratch, cache->scratch_sz, jit_tag );
     if( !rec ) {
       fd_funk_val_flush( funk_rec, funk->alloc, funk->wksp );
     }
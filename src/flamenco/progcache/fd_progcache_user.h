@@ -86,6 +86,10 @@ struct fd_progcache {
 
   uchar * scratch;
   ulong   scratch_sz;
+
+  /* Optional thread-local cache of compiled programs (NULL to always
+     use the interpreter).  Set by the caller after joining. */
+  struct fd_vm_jit_cache * jit;
 };
 
 typedef struct fd_progcache fd_progcache_t;
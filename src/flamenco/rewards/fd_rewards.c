@@ -409,152 +409,192 @@ get_minimum_stake_delegation( fd_bank_t * bank ) {
   return 1;
 }
 
-/* Calculates epoch reward points from stake/vote accounts.
-   https://github.com/anza-xyz/agave/blob/v2.3.1/runtime/src/bank/partitioned_epoch_rewards/calculation.rs#L445 */
-static uint128
-calculate_reward_points_partitioned( fd_bank_t *                    bank,
-                                     fd_funk_t *                    funk,
-                                     fd_funk_txn_xid_t const *      xid,
-                                     fd_stake_delegations_t const * stake_delegations,
-                                     fd_stake_history_t const *     stake_history ) {
-  ulong minimum_stake_delegation = get_minimum_stake_delegation( bank );
+/* fd_rewards_private_calc_t holds the state shared by the threads
+   running the reward calculation kernels below.  Each kernel walks the
+   stake delegations on a range of map chains (see
+   fd_stake_delegations_iter_init_chains). */
+
+struct fd_rewards_private_calc {
+  fd_funk_t *                    funk;
+  fd_funk_txn_xid_t const *      xid;
+  fd_stake_delegations_t const * stake_delegations;
+  fd_stake_history_t const *     stake_history;
+  fd_vote_states_t const *       vote_states;
+  ulong *                        new_warmup_cooldown_rate_epoch;
+  ulong                          minimum_stake_delegation;
+
+  /* Only used by calculate_stake_vote_rewards_op */
+  ulong                          rewarded_epoch;
+  ulong                          total_rewards;
+  uint128                        total_points;
+  fd_vote_state_credits_t *      vote_credits; /* NULL if not recalculating */
+  ulong *                        vote_rewards;
+  fd_epoch_rewards_t *           epoch_rewards;
+  fd_capture_ctx_t *             capture_ctx;
+  volatile int                   lock;         /* protects epoch_rewards */
+};
+typedef struct fd_rewards_private_calc fd_rewards_private_calc_t;
+
+static inline void
+fd_rewards_private_calc_lock( fd_rewards_private_calc_t * calc ) {
+  volatile int * lock = &calc->lock;
+# if FD_HAS_THREADS
+  for( ;; ) {
+    if( FD_LIKELY( !FD_ATOMIC_CAS( lock, 0, 1 ) ) ) break;
+    FD_SPIN_PAUSE();
+  }
+# else
+  *lock = 1;
+# endif
+  FD_COMPILER_MFENCE();
+}
+
+static inline void
+fd_rewards_private_calc_unlock( fd_rewards_private_calc_t * calc ) {
+  volatile int * lock = &calc->lock;
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( *lock ) = 0;
+}
+
+static void
+fd_rewards_private_calc_init( fd_rewards_private_calc_t *    calc,
+                              fd_bank_t *                    bank,
+                              fd_funk_t *                    funk,
+                              fd_funk_txn_xid_t const *      xid,
+                              fd_stake_delegations_t const * stake_delegations,
+                              fd_stake_history_t const *     stake_history,
+                              ulong *                        new_warmup_cooldown_rate_epoch_val ) {
+  memset( calc, 0, sizeof(fd_rewards_private_calc_t) );
 
-  /* Calculate the points for each stake delegation */
   int _err[1];
-  ulong   new_warmup_cooldown_rate_epoch_val = 0UL;
-  ulong * new_warmup_cooldown_rate_epoch     = &new_warmup_cooldown_rate_epoch_val;
   int is_some = fd_new_warmup_cooldown_rate_epoch(
       fd_bank_epoch_schedule_query( bank ),
       fd_bank_features_query( bank ),
       fd_bank_slot_get( bank ),
-      new_warmup_cooldown_rate_epoch,
+      new_warmup_cooldown_rate_epoch_val,
       _err );
-  if( FD_UNLIKELY( !is_some ) ) {
-    new_warmup_cooldown_rate_epoch = NULL;
-  }
 
-  uint128 total_points = 0;
+  calc->funk                           = funk;
+  calc->xid                            = xid;
+  calc->stake_delegations              = stake_delegations;
+  calc->stake_history                  = stake_history;
+  calc->new_warmup_cooldown_rate_epoch = is_some ? new_warmup_cooldown_rate_epoch_val : NULL;
+  calc->minimum_stake_delegation       = get_minimum_stake_delegation( bank );
+}
+
+/* calculate_points_op reduces the points of the stake delegations on
+   map chains [block_i0,block_i1). */
 
-  fd_vote_states_t const * vote_states = fd_bank_vote_states_locking_query( bank );
+static FD_MAP_REDUCE_BEGIN( calculate_points_op, FD_STAKE_DELEGATIONS_CHAIN_BLOCK_THRESH, 0UL, sizeof(uint128), 1L ) {
+  uint128 *                         points = (uint128 *)                        arg[0];
+  fd_rewards_private_calc_t const * calc   = (fd_rewards_private_calc_t const *)arg[1];
+
+  uint128 points_sum = 0;
 
   fd_stake_delegations_iter_t iter_[1];
-  for( fd_stake_delegations_iter_t * iter = fd_stake_delegations_iter_init( iter_, stake_delegations );
+  for( fd_stake_delegations_iter_t * iter = fd_stake_delegations_iter_init_chains( iter_, calc->stake_delegations, (ulong)block_i0, (ulong)block_i1 );
        !fd_stake_delegations_iter_done( iter );
        fd_stake_delegations_iter_next( iter ) ) {
     fd_stake_delegation_t const * stake_delegation = fd_stake_delegations_iter_ele( iter );
 
-    if( FD_UNLIKELY( stake_delegation->stake<minimum_stake_delegation ) ) {
+    if( FD_UNLIKELY( stake_delegation->stake<calc->minimum_stake_delegation ) ) {
       continue;
     }
 
-    fd_vote_state_ele_t * vote_state_ele = fd_vote_states_query( vote_states, &stake_delegation->vote_account );
+    fd_vote_state_ele_t * vote_state_ele = fd_vote_states_query( calc->vote_states, &stake_delegation->vote_account );
     if( FD_UNLIKELY( !vote_state_ele ) ) {
       continue;
     }
 
     fd_calculated_stake_points_t stake_point_result;
-    calculate_stake_points_and_credits( funk,
-                                        xid,
-                                        stake_history,
+    calculate_stake_points_and_credits( calc->funk,
+                                        calc->xid,
+                                        calc->stake_history,
                                         stake_delegation,
                                         vote_state_ele,
-                                        new_warmup_cooldown_rate_epoch,
+                                        calc->new_warmup_cooldown_rate_epoch,
                                         &stake_point_result );
-    total_points += stake_point_result.points;
+    points_sum += stake_point_result.points;
   }
 
-  fd_bank_vote_states_end_locking_query( bank );
+  *points = points_sum;
 
-  return total_points;
-}
+} FD_MAP_END {
 
-/* Calculates epoch rewards for stake/vote accounts.
-   Returns vote rewards, stake rewards, and the sum of all stake rewards
-   in lamports.
+  *(uint128 *)arg[0] += *(uint128 const *)_r1;
 
-   In the future, the calculation will be cached in the snapshot, but
-   for now we just re-calculate it (as Agave does).
-   calculate_stake_vote_rewards is responsible for calculating
-   stake account rewards based off of a combination of the
-   stake delegation state as well as the vote account. If this
-   calculation is done at the end of an epoch, we can just use the
-   vote states at the end of the current epoch. However, because we
-   are presumably booting up a node in the middle of rewards
-   distribution, we need to make sure that we are using the vote
-   states from the end of the previous epoch.
+} FD_REDUCE_END
 
-   https://github.com/anza-xyz/agave/blob/v2.3.1/runtime/src/bank/partitioned_epoch_rewards/calculation.rs#L323 */
-static void
-calculate_stake_vote_rewards( fd_bank_t *                    bank,
-                              fd_funk_t *                    funk,
-                              fd_funk_txn_xid_t const *      xid,
-                              fd_stake_delegations_t const * stake_delegations,
-                              fd_capture_ctx_t *             capture_ctx,
-                              fd_stake_history_t const *     stake_history,
-                              ulong                          rewarded_epoch,
-                              ulong                          total_rewards,
-                              uint128                        total_points,
-                              fd_runtime_stack_t *           runtime_stack ) {
+/* Calculates epoch reward points from stake/vote accounts.
+   https://github.com/anza-xyz/agave/blob/v2.3.1/runtime/src/bank/partitioned_epoch_rewards/calculation.rs#L445 */
+static uint128
+calculate_reward_points_partitioned( fd_bank_t *                    bank,
+                                     fd_funk_t *                    funk,
+                                     fd_funk_txn_xid_t const *      xid,
+                                     fd_stake_delegations_t const * stake_delegations,
+                                     fd_stake_history_t const *     stake_history,
+                                     fd_tpool_t *                   tpool,
+                                     ulong                          tpool_t0,
+                                     ulong                          tpool_t1 ) {
+  ulong new_warmup_cooldown_rate_epoch_val = 0UL;
+  fd_rewards_private_calc_t calc[1];
+  fd_rewards_private_calc_init( calc, bank, funk, xid, stake_delegations, stake_history, &new_warmup_cooldown_rate_epoch_val );
 
-  int _err[1];
-  ulong   new_warmup_cooldown_rate_epoch_val = 0UL;
-  ulong * new_warmup_cooldown_rate_epoch     = &new_warmup_cooldown_rate_epoch_val;
-  int is_some = fd_new_warmup_cooldown_rate_epoch(
-      fd_bank_epoch_schedule_query( bank ),
-      fd_bank_features_query( bank ),
-      fd_bank_slot_get( bank ),
-      new_warmup_cooldown_rate_epoch,
-      _err );
-  if( FD_UNLIKELY( !is_some ) ) {
-    new_warmup_cooldown_rate_epoch = NULL;
-  }
+  calc->vote_states = fd_bank_vote_states_locking_query( bank );
 
+  /* Calculate the points for each stake delegation */
+  uint128 total_points[1] __attribute__((aligned(128)));
+  FD_MAP_REDUCE( calculate_points_op, tpool, tpool_t0, tpool_t1,
+                 0L, (long)fd_stake_delegations_chain_cnt( stake_delegations ),
+                 total_points, calc );
 
-  ulong minimum_stake_delegation = get_minimum_stake_delegation( bank );
-  ulong stake_delegation_cnt     = fd_stake_delegations_cnt( stake_delegations );
+  fd_bank_vote_states_end_locking_query( bank );
 
-  fd_vote_states_t * vote_states = !!runtime_stack->stakes.prev_vote_credits_used ? fd_bank_vote_states_prev_locking_modify( bank ) : fd_bank_vote_states_locking_modify( bank );
+  return total_points[0];
+}
 
-  fd_epoch_rewards_t * epoch_rewards = fd_epoch_rewards_join( fd_epoch_rewards_new( fd_bank_epoch_rewards_locking_modify( bank ), stake_delegation_cnt ) );
+/* calculate_stake_vote_rewards_op calculates the rewards of the stake
+   delegations on map chains [block_i0,block_i1).  Stake rewards are
+   inserted into calc->epoch_rewards and vote rewards are accumulated
+   into calc->vote_rewards.  The per delegation calculation (which reads
+   the vote account) is done concurrently, only the epoch rewards
+   insertion is serialized. */
 
-  /* Reset the vote rewards for each vote account. */
-  fd_memset( runtime_stack->stakes.vote_rewards, 0UL, sizeof(runtime_stack->stakes.vote_rewards) );
+static FD_FOR_ALL_BEGIN( calculate_stake_vote_rewards_op, FD_STAKE_DELEGATIONS_CHAIN_BLOCK_THRESH ) {
+  fd_rewards_private_calc_t * calc = (fd_rewards_private_calc_t *)arg[0];
 
   fd_stake_delegations_iter_t iter_[1];
-  for( fd_stake_delegations_iter_t * iter = fd_stake_delegations_iter_init( iter_, stake_delegations );
+  for( fd_stake_delegations_iter_t * iter = fd_stake_delegations_iter_init_chains( iter_, calc->stake_delegations, (ulong)block_i0, (ulong)block_i1 );
        !fd_stake_delegations_iter_done( iter );
        fd_stake_delegations_iter_next( iter ) ) {
     fd_stake_delegation_t const * stake_delegation = fd_stake_delegations_iter_ele( iter );
 
-    if( FD_FEATURE_ACTIVE_BANK( bank, stake_minimum_delegation_for_rewards ) ) {
-      if( stake_delegation->stake<minimum_stake_delegation ) {
-        continue;
-      }
+    if( stake_delegation->stake<calc->minimum_stake_delegation ) {
+      continue;
     }
 
     fd_pubkey_t const *   voter_acc      = &stake_delegation->vote_account;
-    fd_vote_state_ele_t * vote_state_ele = fd_vote_states_query( vote_states, voter_acc );
+    fd_vote_state_ele_t * vote_state_ele = fd_vote_states_query( calc->vote_states, voter_acc );
     if( FD_UNLIKELY( !vote_state_ele ) ) {
       continue;
     }
 
-    fd_vote_state_credits_t * realc_credit = !!runtime_stack->stakes.prev_vote_credits_used ?
-                                             &runtime_stack->stakes.vote_credits[ vote_state_ele->idx ] : NULL;
+    fd_vote_state_credits_t * realc_credit = calc->vote_credits ? &calc->vote_credits[ vote_state_ele->idx ] : NULL;
 
     /* redeem_rewards is actually just responisble for calculating the
        vote and stake rewards for each stake account.  It does not do
        rewards redemption: it is a misnomer. */
     fd_calculated_stake_rewards_t calculated_stake_rewards[1] = {0};
     int err = redeem_rewards(
-        funk,
-        xid,
-        stake_history,
+        calc->funk,
+        calc->xid,
+        calc->stake_history,
         stake_delegation,
         vote_state_ele,
-        rewarded_epoch,
-        total_rewards,
-        total_points,
-        new_warmup_cooldown_rate_epoch,
+        calc->rewarded_epoch,
+        calc->total_rewards,
+        calc->total_points,
+        calc->new_warmup_cooldown_rate_epoch,
         realc_credit,
         calculated_stake_rewards );
 
@@ -563,8 +603,8 @@ calculate_stake_vote_rewards( fd_bank_t *                    bank,
       continue;
     }
 
-    if( capture_ctx ) {
-      fd_solcap_write_stake_reward_event( capture_ctx->capture,
+    if( calc->capture_ctx ) {
+      fd_solcap_write_stake_reward_event( calc->capture_ctx->capture,
           &stake_delegation->stake_account,
           voter_acc,
           vote_state_ele->commission,
@@ -573,11 +613,85 @@ calculate_stake_vote_rewards( fd_bank_t *                    bank,
           (long)calculated_stake_rewards->new_credits_observed );
     }
 
-    runtime_stack->stakes.vote_rewards[ vote_state_ele->idx ] += calculated_stake_rewards->voter_rewards;
+#   if FD_HAS_ATOMIC
+    FD_ATOMIC_FETCH_AND_ADD( &calc->vote_rewards[ vote_state_ele->idx ], calculated_stake_rewards->voter_rewards );
+#   else
+    calc->vote_rewards[ vote_state_ele->idx ] += calculated_stake_rewards->voter_rewards;
+#   endif
 
-    fd_epoch_rewards_insert( epoch_rewards, &stake_delegation->stake_account, calculated_stake_rewards->new_credits_observed, calculated_stake_rewards->staker_rewards );
+    fd_rewards_private_calc_lock( calc );
+    fd_epoch_rewards_insert( calc->epoch_rewards, &stake_delegation->stake_account, calculated_stake_rewards->new_credits_observed, calculated_stake_rewards->staker_rewards );
+    fd_rewards_private_calc_unlock( calc );
   }
 
+} FD_FOR_ALL_END
+
+/* Calculates epoch rewards for stake/vote accounts.
+   Returns vote rewards, stake rewards, and the sum of all stake rewards
+   in lamports.
+
+   In the future, the calculation will be cached in the snapshot, but
+   for now we just re-calculate it (as Agave does).
+   calculate_stake_vote_rewards is responsible for calculating
+   stake account rewards based off of a combination of the
+   stake delegation state as well as the vote account. If this
+   calculation is done at the end of an epoch, we can just use the
+   vote states at the end of the current epoch. However, because we
+   are presumably booting up a node in the middle of rewards
+   distribution, we need to make sure that we are using the vote
+   states from the end of the previous epoch.
+
+   The order in which stake rewards are inserted into the epoch rewards
+   (and thus the order of the stake accounts within a partition)
+   depends on thread scheduling when running on more than one thread.
+   Each stake account's reward does not.  Solcap captures are written
+   as rewards are calculated, so the calculation is done on the caller
+   only when capturing to keep captures reproducible.
+
+   https://github.com/anza-xyz/agave/blob/v2.3.1/runtime/src/bank/partitioned_epoch_rewards/calculation.rs#L323 */
+static void
+calculate_stake_vote_rewards( fd_bank_t *                    bank,
+                              fd_funk_t *                    funk,
+                              fd_funk_txn_xid_t const *      xid,
+                              fd_stake_delegations_t const * stake_delegations,
+                              fd_capture_ctx_t *             capture_ctx,
+                              fd_stake_history_t const *     stake_history,
+                              ulong                          rewarded_epoch,
+                              ulong                          total_rewards,
+                              uint128                        total_points,
+                              fd_runtime_stack_t *           runtime_stack,
+                              fd_tpool_t *                   tpool,
+                              ulong                          tpool_t0,
+                              ulong                          tpool_t1 ) {
+
+  ulong new_warmup_cooldown_rate_epoch_val = 0UL;
+  fd_rewards_private_calc_t calc[1];
+  fd_rewards_private_calc_init( calc, bank, funk, xid, stake_delegations, stake_history, &new_warmup_cooldown_rate_epoch_val );
+
+  ulong stake_delegation_cnt = fd_stake_delegations_cnt( stake_delegations );
+
+  fd_vote_states_t * vote_states = !!runtime_stack->stakes.prev_vote_credits_used ? fd_bank_vote_states_prev_locking_modify( bank ) : fd_bank_vote_states_locking_modify( bank );
+
+  fd_epoch_rewards_t * epoch_rewards = fd_epoch_rewards_join( fd_epoch_rewards_new( fd_bank_epoch_rewards_locking_modify( bank ), stake_delegation_cnt ) );
+
+  /* Reset the vote rewards for each vote account. */
+  fd_memset( runtime_stack->stakes.vote_rewards, 0UL, sizeof(runtime_stack->stakes.vote_rewards) );
+
+  calc->vote_states    = vote_states;
+  calc->rewarded_epoch = rewarded_epoch;
+  calc->total_rewards  = total_rewards;
+  calc->total_points   = total_points;
+  calc->vote_credits   = !!runtime_stack->stakes.prev_vote_credits_used ? runtime_stack->stakes.vote_credits : NULL;
+  calc->vote_rewards   = runtime_stack->stakes.vote_rewards;
+  calc->epoch_rewards  = epoch_rewards;
+  calc->capture_ctx    = capture_ctx;
+
+  if( capture_ctx ) tpool_t1 = fd_ulong_min( tpool_t1, tpool_t0+1UL );
+
+  FD_FOR_ALL( calculate_stake_vote_rewards_op, tpool, tpool_t0, tpool_t1,
+              0L, (long)fd_stake_delegations_chain_cnt( stake_delegations ),
+              calc );
+
   fd_bank_epoch_rewards_end_locking_modify( bank );
 
   !!runtime_stack->stakes.prev_vote_credits_used ? fd_bank_vote_states_prev_end_locking_modify( bank ) : fd_bank_vote_states_end_locking_modify( bank );
@@ -594,7 +708,10 @@ calculate_validator_rewards( fd_bank_t *                    bank,
                              fd_stake_delegations_t const * stake_delegations,
                              fd_capture_ctx_t *             capture_ctx,
                              ulong                          rewarded_epoch,
-                             ulong *                        rewards_out ) {
+                             ulong *                        rewards_out,
+                             fd_tpool_t *                   tpool,
+                             ulong                          tpool_t0,
+                             ulong                          tpool_t1 ) {
 
   fd_stake_history_t stake_history[1];
   if( FD_UNLIKELY( !fd_sysvar_stake_history_read( funk, xid, stake_history ) ) ) {
@@ -607,7 +724,10 @@ calculate_validator_rewards( fd_bank_t *                    bank,
       funk,
       xid,
       stake_delegations,
-      stake_history );
+      stake_history,
+      tpool,
+      tpool_t0,
+      tpool_t1 );
 
   /* If there are no points, then we set the rewards to 0. */
   *rewards_out = points>0UL ? *rewards_out: 0UL;
@@ -633,7 +753,10 @@ calculate_validator_rewards( fd_bank_t *                    bank,
       rewarded_epoch,
       *rewards_out,
       points,
-      runtime_stack );
+      runtime_stack,
+      tpool,
+      tpool_t0,
+      tpool_t1 );
 
   return points;
 }
@@ -670,7 +793,10 @@ calculate_rewards_for_partitioning( fd_bank_t *                            bank,
                                     fd_stake_delegations_t const *         stake_delegations,
                                     fd_capture_ctx_t *                     capture_ctx,
                                     ulong                                  prev_epoch,
-                                    fd_partitioned_rewards_calculation_t * result ) {
+                                    fd_partitioned_rewards_calculation_t * result,
+                                    fd_tpool_t *                           tpool,
+                                    ulong                                  tpool_t0,
+                                    ulong                                  tpool_t1 ) {
   fd_prev_epoch_inflation_rewards_t rewards;
 
   calculate_previous_epoch_inflation_rewards( bank,
@@ -687,7 +813,10 @@ calculate_rewards_for_partitioning( fd_bank_t *                            bank,
                                                 stake_delegations,
                                                 capture_ctx,
                                                 prev_epoch,
-                                                &total_rewards );
+                                                &total_rewards,
+                                                tpool,
+                                                tpool_t0,
+                                                tpool_t1 );
 
   /* The agave client does not partition the stake rewards until the
      first distribution block.  We calculate the partitions during the
@@ -709,7 +838,10 @@ calculate_rewards_and_distribute_vote_rewards( fd_bank_t *                    ba
                                                fd_runtime_stack_t *           runtime_stack,
                                                fd_stake_delegations_t const * stake_delegations,
                                                fd_capture_ctx_t *             capture_ctx,
-                                               ulong                          prev_epoch ) {
+                                               ulong                          prev_epoch,
+                                               fd_tpool_t *                   tpool,
+                                               ulong                          tpool_t0,
+                                               ulong                          tpool_t1 ) {
 
   /* First we must compute the stake and vote rewards for the just
      completed epoch.  We store the stake account rewards and vote
@@ -723,7 +855,10 @@ calculate_rewards_and_distribute_vote_rewards( fd_bank_t *                    ba
                                       stake_delegations,
                                       capture_ctx,
                                       prev_epoch,
-                                      rewards_calc_result );
+                                      rewards_calc_result,
+                                      tpool,
+                                      tpool_t0,
+                                      tpool_t1 );
 
   fd_vote_states_t const * vote_states = fd_bank_vote_states_locking_query( bank );
 
@@ -984,7 +1119,10 @@ fd_begin_partitioned_rewards( fd_bank_t *                    bank,
                               fd_capture_ctx_t *             capture_ctx,
                               fd_stake_delegations_t const * stake_delegations,
                               fd_hash_t const *              parent_blockhash,
-                              ulong                          parent_epoch ) {
+                              ulong                          parent_epoch,
+                              fd_tpool_t *                   tpool,
+                              ulong                          tpool_t0,
+                              ulong                          tpool_t1 ) {
 
   calculate_rewards_and_distribute_vote_rewards(
       bank,
@@ -993,7 +1131,10 @@ fd_begin_partitioned_rewards( fd_bank_t *                    bank,
       runtime_stack,
       stake_delegations,
       capture_ctx,
-      parent_epoch );
+      parent_epoch,
+      tpool,
+      tpool_t0,
+      tpool_t1 );
 
   /* Once the rewards for vote accounts have been distributed and stake
      account rewards have been calculated, we can now set our epoch
@@ -1045,7 +1186,10 @@ fd_rewards_recalculate_partitioned_rewards( fd_banks_t *              banks,
                                             fd_funk_t *               funk,
                                             fd_funk_txn_xid_t const * xid,
                                             fd_runtime_stack_t *      runtime_stack,
-                                            fd_capture_ctx_t *        capture_ctx ) {
+                                            fd_capture_ctx_t *        capture_ctx,
+                                            fd_tpool_t *              tpool,
+                                            ulong                     tpool_t0,
+                                            ulong                     tpool_t1 ) {
 
   fd_sysvar_epoch_rewards_t epoch_rewards_sysvar[1];
   if( FD_UNLIKELY( !fd_sysvar_epoch_rewards_read( funk, xid, epoch_rewards_sysvar ) ) ) {
@@ -1067,23 +1211,9 @@ fd_rewards_recalculate_partitioned_rewards( fd_banks_t *              banks,
   FD_LOG_DEBUG(( "epoch rewards is active" ));
   runtime_stack->stakes.prev_vote_credits_used = 1;
 
-  ulong const slot           = fd_bank_slot_get( bank );
   ulong const epoch          = fd_bank_epoch_get( bank );
   ulong const rewarded_epoch = fd_ulong_sat_sub( epoch, 1UL );
 
-  int _err[1] = {0};
-  ulong new_warmup_cooldown_rate_epoch_;
-  ulong * new_warmup_cooldown_rate_epoch = &new_warmup_cooldown_rate_epoch_;
-  int is_some = fd_new_warmup_cooldown_rate_epoch(
-      fd_bank_epoch_schedule_query( bank ),
-      fd_bank_features_query( bank ),
-      slot,
-      new_warmup_cooldown_rate_epoch,
-      _err );
-  if( FD_UNLIKELY( !is_some ) ) {
-    new_warmup_cooldown_rate_epoch = NULL;
-  }
-
   fd_stake_history_t stake_history[1];
   if( FD_UNLIKELY( !fd_sysvar_stake_history_read( funk, xid, stake_history ) ) ) {
     FD_LOG_ERR(( "Unable to read and decode stake history sysvar" ));
@@ -1108,7 +1238,10 @@ fd_rewards_recalculate_partitioned_rewards( fd_banks_t *              banks,
       rewarded_epoch,
       epoch_rewards_sysvar->total_rewards,
       epoch_rewards_sysvar->total_points,
-      runtime_stack );
+      runtime_stack,
+      tpool,
+      tpool_t0,
+      tpool_t1 );
 
   fd_epoch_rewards_t * epoch_rewards = fd_epoch_rewards_join( fd_bank_epoch_rewards_locking_modify( bank ) );
   fd_epoch_rewards_hash_into_partitions( epoch_rewards, &epoch_rewards_sysvar->parent_blockhash, epoch_rewards_sysvar->num_partitions );
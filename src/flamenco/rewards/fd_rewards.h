@@ -4,6 +4,7 @@
 /* fd_rewards.h provides APIs for distributing Solana staking rewards. */
 
 #include "../types/fd_types.h"
+#include "../../util/tpool/fd_tpool.h"
 #include "../stakes/fd_stake_delegations.h"
 #include "../stakes/fd_vote_states.h"
 
@@ -26,7 +27,13 @@ FD_PROTOTYPES_BEGIN
                - calculate_stake_rewards
                  - calculate_stake_points_and_credits
        - ... update all vote accounts ...
-     - ... update epoch rewards bank field ... */
+     - ... update epoch rewards bank field ...
+
+   The points and the per stake delegation rewards are calculated with
+   the caller and tpool threads (tpool_t0,tpool_t1), which are assumed
+   to be idle (see FD_MAP_REDUCE).  If tpool_t1-tpool_t0<=1, all the
+   work is done by the caller and tpool can be NULL.  The rewards do not
+   depend on the number of threads. */
 
 void
 fd_begin_partitioned_rewards( fd_bank_t *                    bank,
@@ -36,7 +43,10 @@ fd_begin_partitioned_rewards( fd_bank_t *                    bank,
                               fd_capture_ctx_t *             capture_ctx,
                               fd_stake_delegations_t const * stake_delegations,
                               fd_hash_t const *              parent_blockhash,
-                              ulong                          parent_epoch );
+                              ulong                          parent_epoch,
+                              fd_tpool_t *                   tpool,
+                              ulong                          tpool_t0,
+                              ulong                          tpool_t1 );
 
 /* fd_rewards_recalculate_partitioned_rewards restores epoch bank stake
    and account reward calculations.  Does not update accounts.  Called
@@ -47,7 +57,9 @@ fd_begin_partitioned_rewards( fd_bank_t *                    bank,
      - calculate_stake_vote_rewards_account
        - for each delegation: redeem_rewards
          - calculate_stake_rewards
-           - calculate_stake_points_and_credits */
+           - calculate_stake_points_and_credits
+
+   tpool, tpool_t0 and tpool_t1 are as in fd_begin_partitioned_rewards. */
 
 void
 fd_rewards_recalculate_partitioned_rewards( fd_banks_t *              banks,
@@ -55,7 +67,10 @@ fd_rewards_recalculate_partitioned_rewards( fd_banks_t *              banks,
                                             fd_funk_t *               funk,
                                             fd_funk_txn_xid_t const * xid,
                                             fd_runtime_stack_t *      runtime_stack,
-                                            fd_capture_ctx_t *        capture_ctx );
+                                            fd_capture_ctx_t *        capture_ctx,
+                                            fd_tpool_t *              tpool,
+                                            ulong                     tpool_t0,
+                                            ulong                     tpool_t1 );
 
 /* fd_distribute_partitioned_epoch_rewards pays out rewards to stake
    accounts.  Called at the beginning of a few slots per epoch.
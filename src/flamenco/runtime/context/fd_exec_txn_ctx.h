@@ -63,6 +63,7 @@ struct fd_exec_txn_ctx {
   fd_funk_txn_xid_t                    xid[1];
   ulong                                slot;
   ulong                                bank_idx;
+  ulong                                lthash_part_idx;                             /* Bank lthash partial account updates are mixed into, typically the executing tile's index */
   fd_txn_p_t                           txn;
 
   fd_compute_budget_details_t          compute_budget_details;                      /* Compute budget details */
@@ -518,6 +518,11 @@ fd_banks_init_bank( fd_banks_t * banks ) {
   bank->cost_tracker_pool_idx = fd_bank_cost_tracker_pool_idx_null( fd_bank_get_cost_tracker_pool( bank ) );
   fd_rwlock_unwrite( &bank->cost_tracker_lock );
 
+  for( ulong i=0UL; i<FD_BANK_LTHASH_PARTIAL_CNT; i++ ) {
+    bank->lthash_partial_dirty[ i ] = 0;
+    fd_rwlock_unwrite( &bank->lthash_partial_lock[ i ] );
+  }
+
   bank->flags |= FD_BANK_FLAGS_INIT | FD_BANK_FLAGS_REPLAYABLE | FD_BANK_FLAGS_FROZEN;
   bank->refcnt = 0UL;
 
@@ -603,6 +608,11 @@ fd_banks_clone_from_parent( fd_banks_t * banks,
   child_bank->stake_delegations_delta_dirty = 0;
   fd_rwlock_unwrite( &child_bank->stake_delegations_delta_lock );
 
+  for( ulong i=0UL; i<FD_BANK_LTHASH_PARTIAL_CNT; i++ ) {
+    child_bank->lthash_partial_dirty[ i ] = 0;
+    fd_rwlock_unwrite( &child_bank->lthash_partial_lock[ i ] );
+  }
+
   /* Setup locks for new bank as free. */
   #define HAS_LOCK_1(name) \
     fd_rwlock_unwrite(&child_bank->name##_lock);
@@ -874,6 +884,11 @@ fd_banks_clear_bank( fd_banks_t * banks, fd_bank_t * bank ) {
   bank->stake_delegations_delta_dirty = 0;
   fd_rwlock_unwrite( &bank->stake_delegations_delta_lock );
 
+  for( ulong i=0UL; i<FD_BANK_LTHASH_PARTIAL_CNT; i++ ) {
+    bank->lthash_partial_dirty[ i ] = 0;
+    fd_rwlock_unwrite( &bank->lthash_partial_lock[ i ] );
+  }
+
   fd_rwlock_unread( &banks->rwlock );
 }
 
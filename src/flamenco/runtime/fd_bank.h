@@ -335,6 +335,12 @@ typedef struct fd_bank_cost_tracker fd_bank_cost_tracker_t;
 #define FD_BANK_FLAGS_ROOTED            (0x00000010UL) /* Rooted.  Part of the consnensus root fork.  */
 #define FD_BANK_FLAGS_EXEC_RECORDING    (0x00000100UL) /* Enable execution recording. */
 
+/* FD_BANK_LTHASH_PARTIAL_CNT is the number of partial lthash sums a
+   bank has (see fd_bank_lthash_partial_locking_modify).  Executors
+   with part_idx that collide modulo this share a partial. */
+
+#define FD_BANK_LTHASH_PARTIAL_CNT (8UL)
+
 /* As mentioned above, the overall layout of the bank struct:
    - Fields used for internal pool/bank management
    - Non-Cow fields
@@ -373,6 +379,14 @@ struct fd_bank {
   int         stake_delegations_delta_dirty;
   fd_rwlock_t stake_delegations_delta_lock;
 
+  /* Partial lthash sums of account updates, striped by the index of
+     the tile executing the transaction.  Merged into lthash when the
+     bank hash is computed. */
+
+  fd_lthash_value_t lthash_partial[FD_BANK_LTHASH_PARTIAL_CNT];
+  int               lthash_partial_dirty[FD_BANK_LTHASH_PARTIAL_CNT];
+  fd_rwlock_t       lthash_partial_lock[FD_BANK_LTHASH_PARTIAL_CNT];
+
   ulong refcnt; /* (r) reference count on the bank, see replay for more details */
 
   fd_txncache_fork_id_t txncache_fork_id; /* fork id used by the txn cache */
@@ -668,6 +682,33 @@ fd_bank_stake_delegations_delta_end_locking_query( fd_bank_t * bank ) {
   fd_rwlock_unread( &bank->stake_delegations_delta_lock );
 }
 
+/* Each bank also has FD_BANK_LTHASH_PARTIAL_CNT partial lthash sums
+   that concurrent executors accumulate account updates into, so that
+   they don't all contend on the bank's lthash lock.  part_idx is
+   typically the index of the executing tile and is reduced modulo
+   FD_BANK_LTHASH_PARTIAL_CNT.  Like the stake delegations delta, a
+   partial is lazily zeroed on the first modify after the bank was
+   created.  The partials are folded into the lthash field by
+   fd_hashes_lthash_merge_partials. */
+
+static inline fd_lthash_value_t *
+fd_bank_lthash_partial_locking_modify( fd_bank_t * bank,
+                                       ulong       part_idx ) {
+  part_idx %= FD_BANK_LTHASH_PARTIAL_CNT;
+  fd_rwlock_write( &bank->lthash_partial_lock[ part_idx ] );
+  if( !bank->lthash_partial_dirty[ part_idx ] ) {
+    bank->lthash_partial_dirty[ part_idx ] = 1;
+    fd_lthash_zero( &bank->lthash_partial[ part_idx ] );
+  }
+  return &bank->lthash_partial[ part_idx ];
+}
+
+static inline void
+fd_bank_lthash_partial_end_locking_modify( fd_bank_t * bank,
+                                           ulong       part_idx ) {
+  fd_rwlock_unwrite( &bank->lthash_partial_lock[ part_idx % FD_BANK_LTHASH_PARTIAL_CNT ] );
+}
+
 /* fd_bank_stake_delegations_frontier_query() will return a pointer to
    the full stake delegations for the current frontier. The caller is
    responsible that there are no concurrent readers or writers to
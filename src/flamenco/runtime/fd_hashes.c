@@ -32,6 +32,45 @@ fd_hashes_account_lthash( fd_pubkey_t const       * pubkey,
   fd_blake3_fini_2048( b3, lthash_out->bytes );
 }
 
+fd_hashes_lthash_batch_t *
+fd_hashes_lthash_batch_init( fd_hashes_lthash_batch_t * batch ) {
+  fd_lthash_adder_new( batch->adder_add );
+  fd_lthash_adder_new( batch->adder_sub );
+  fd_lthash_zero( batch->sum_add );
+  fd_lthash_zero( batch->sum_sub );
+  return batch;
+}
+
+void
+fd_hashes_lthash_batch_fini( fd_hashes_lthash_batch_t * batch,
+                             fd_bank_t                * bank,
+                             ulong                      part_idx ) {
+  fd_lthash_adder_flush( batch->adder_add, batch->sum_add );
+  fd_lthash_adder_flush( batch->adder_sub, batch->sum_sub );
+
+  fd_lthash_value_t * partial = fd_bank_lthash_partial_locking_modify( bank, part_idx );
+  fd_lthash_sub( partial, batch->sum_sub );
+  fd_lthash_add( partial, batch->sum_add );
+  fd_bank_lthash_partial_end_locking_modify( bank, part_idx );
+
+  fd_lthash_adder_delete( batch->adder_add );
+  fd_lthash_adder_delete( batch->adder_sub );
+}
+
+void
+fd_hashes_lthash_merge_partials( fd_bank_t * bank ) {
+  fd_lthash_value_t * bank_lthash = fd_type_pun( fd_bank_lthash_locking_modify( bank ) );
+  for( ulong i=0UL; i<FD_BANK_LTHASH_PARTIAL_CNT; i++ ) {
+    fd_rwlock_write( &bank->lthash_partial_lock[ i ] );
+    if( bank->lthash_partial_dirty[ i ] ) {
+      fd_lthash_add( bank_lthash, &bank->lthash_partial[ i ] );
+      bank->lthash_partial_dirty[ i ] = 0;
+    }
+    fd_rwlock_unwrite( &bank->lthash_partial_lock[ i ] );
+  }
+  fd_bank_lthash_end_locking_modify( bank );
+}
+
 void
 fd_hashes_hash_bank( fd_lthash_value_t const * lthash,
                      fd_hash_t const *         prev_bank_hash,
@@ -4,6 +4,7 @@
 #include "../fd_flamenco_base.h"
 #include "../types/fd_types.h"
 #include "../../ballet/lthash/fd_lthash.h"
+#include "../../ballet/lthash/fd_lthash_adder.h"
 
 /* fd_hashes.h provides functions for computing and updating the bank hash
    for a completed slot.  The bank hash is a cryptographic hash of the
@@ -88,6 +89,83 @@ fd_hashes_update_lthash( fd_txn_account_t const  * account,
                          fd_bank_t               * bank,
                          fd_capture_ctx_t        * capture_ctx );
 
+/* fd_hashes_lthash_batch_t accumulates the lthash updates of a group
+   of account modifications (e.g. all writable accounts of a
+   transaction) so that the account hashes are computed with the
+   multi-message BLAKE3 path of fd_lthash_adder, and the result is
+   mixed into the bank with a single lock acquisition.
+
+   Usage:
+
+     fd_hashes_lthash_batch_t batch[1];
+     fd_hashes_lthash_batch_init( batch );
+     for( ... each modified account ... ) {
+       fd_hashes_lthash_batch_sub( batch, pubkey, prev_meta, prev_data );
+       fd_hashes_lthash_batch_add( batch, pubkey, new_meta,  new_data  );
+     }
+     fd_hashes_lthash_batch_fini( batch, bank, part_idx );
+
+   Account data is copied or hashed by the time sub/add return, so the
+   caller may release or overwrite the account afterwards.  The bank is
+   updated through its lthash partial part_idx (see
+   fd_bank_lthash_partial_locking_modify), so batches finished
+   concurrently by different executors don't contend.  The partials
+   must be merged with fd_hashes_lthash_merge_partials before the bank
+   lthash is read. */
+
+struct fd_hashes_lthash_batch {
+  fd_lthash_adder_t adder_add[1];
+  fd_lthash_adder_t adder_sub[1];
+  fd_lthash_value_t sum_add[1];
+  fd_lthash_value_t sum_sub[1];
+};
+typedef struct fd_hashes_lthash_batch fd_hashes_lthash_batch_t;
+
+fd_hashes_lthash_batch_t *
+fd_hashes_lthash_batch_init( fd_hashes_lthash_batch_t * batch );
+
+/* fd_hashes_lthash_batch_{add,sub} queue the lthash of the given
+   account (as computed by fd_hashes_account_lthash) for addition to or
+   subtraction from the bank lthash.  Zero-lamport accounts are
+   skipped. */
+
+static inline void
+fd_hashes_lthash_batch_add( fd_hashes_lthash_batch_t * batch,
+                            fd_pubkey_t const        * pubkey,
+                            fd_account_meta_t const  * account,
+                            uchar const              * data ) {
+  if( FD_UNLIKELY( !account->lamports ) ) return;
+  fd_lthash_adder_push_solana_account( batch->adder_add, batch->sum_add, pubkey, data, account->dlen,
+                                       account->lamports, (uchar)( account->executable & 0x1 ), account->owner );
+}
+
+static inline void
+fd_hashes_lthash_batch_sub( fd_hashes_lthash_batch_t * batch,
+                            fd_pubkey_t const        * pubkey,
+                            fd_account_meta_t const  * account,
+                            uchar const              * data ) {
+  if( FD_UNLIKELY( !account->lamports ) ) return;
+  fd_lthash_adder_push_solana_account( batch->adder_sub, batch->sum_sub, pubkey, data, account->dlen,
+                                       account->lamports, (uchar)( account->executable & 0x1 ), account->owner );
+}
+
+/* fd_hashes_lthash_batch_fini hashes the remaining queued accounts,
+   mixes the batch into the lthash partial part_idx of bank and
+   destroys the batch. */
+
+void
+fd_hashes_lthash_batch_fini( fd_hashes_lthash_batch_t * batch,
+                             fd_bank_t                * bank,
+                             ulong                      part_idx );
+
+/* fd_hashes_lthash_merge_partials folds the lthash partials of bank
+   into the bank lthash and resets them.  Must be called once all
+   batches for the bank are finished and before the bank lthash is
+   used (i.e. when the bank is frozen). */
+
+void
+fd_hashes_lthash_merge_partials( fd_bank_t * bank );
+
 /* fd_hashes_hash_bank computes the bank hash for a completed slot.  The
    bank hash is a deterministic hash of the slot's state including all
    account modifications and transaction signatures.
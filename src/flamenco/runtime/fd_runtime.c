@@ -520,6 +520,9 @@ fd_runtime_update_bank_hash( fd_bank_t *        bank,
 
   fd_bank_parent_signature_cnt_set( bank, fd_bank_signature_count_get( bank ) );
 
+  /* Fold in the account updates accumulated by the executors */
+  fd_hashes_lthash_merge_partials( bank );
+
   /* Compute the new bank hash */
   fd_lthash_value_t const * lthash = fd_bank_lthash_locking_query( bank );
   fd_hash_t new_bank_hash[1] = { 0 };
@@ -820,12 +823,13 @@ fd_runtime_buffer_solcap_account_update( fd_txn_account_t *        account,
 
    funk is the funk database handle.  funk_txn is the transaction
    context to query (NULL for root context).  account is the modified
-   account.  bank and capture_ctx are passed to fd_hashes_update_lthash.
+   account.  The lthash update is queued in batch, which the caller
+   mixes into bank with fd_hashes_lthash_batch_fini.
 
    This function:
    - Queries funk for the previous account version
-   - Computes the hash of the previous version (or uses zero for new)
-   - Calls fd_hashes_update_lthash with the computed previous hash
+   - Queues the previous version (if any) for removal from the lthash
+   - Queues the new version for addition to the lthash
    - Saves the new version of the account to Funk
    - Notifies the replay tile that an account update has occurred, so it
      can write the account to the solcap file.
@@ -835,11 +839,12 @@ fd_runtime_buffer_solcap_account_update( fd_txn_account_t *        account,
    All non-optional pointers must be valid. */
 
 static void
-fd_runtime_save_account( fd_funk_t *               funk,
-                         fd_funk_txn_xid_t const * xid,
-                         fd_txn_account_t *        account,
-                         fd_bank_t *               bank,
-                         fd_capture_ctx_t *        capture_ctx ) {
+fd_runtime_save_account( fd_funk_t *                funk,
+                         fd_funk_txn_xid_t const *  xid,
+                         fd_txn_account_t *         account,
+                         fd_hashes_lthash_batch_t * batch,
+                         fd_bank_t *                bank,
+                         fd_capture_ctx_t *         capture_ctx ) {
   /* Join the transaction account */
   if( FD_UNLIKELY( !fd_txn_account_join( account ) ) ) {
     FD_LOG_CRIT(( "fd_runtime_save_account: failed to join account" ));
@@ -857,19 +862,13 @@ fd_runtime_save_account( fd_funk_t *               funk,
       NULL );
   uchar const * prev_data = (void const *)( prev_meta+1 );
 
-  /* Hash the old version of the account */
-  fd_lthash_value_t prev_hash[1];
-  fd_lthash_zero( prev_hash );
+  /* Queue the old version of the account for removal from the bank
+     hash, and the new version for addition.  The data of both versions
+     is consumed before the new version is saved below. */
   if( err != FD_ACC_MGR_ERR_UNKNOWN_ACCOUNT ) {
-    fd_hashes_account_lthash(
-      account->pubkey,
-      prev_meta,
-      prev_data,
-      prev_hash );
+    fd_hashes_lthash_batch_sub( batch, account->pubkey, prev_meta, prev_data );
   }
-
-  /* Mix in the account hash into the bank hash */
-  fd_hashes_update_lthash( account, prev_hash, bank, NULL );
+  fd_hashes_lthash_batch_add( batch, account->pubkey, fd_txn_account_get_meta( account ), fd_txn_account_get_data( account ) );
 
   /* Publish account update to replay tile for solcap writing
      TODO: write in the exec tile with solcap v2 */
@@ -901,6 +900,11 @@ fd_runtime_finalize_txn( fd_funk_t *               funk,
 
   FD_ATOMIC_FETCH_AND_ADD( fd_bank_signature_count_modify( bank ), TXN( &txn_ctx->txn )->signature_cnt );
 
+  /* The lthash updates of all accounts saved below are hashed together
+     and mixed into this executor's lthash partial of the bank. */
+  fd_hashes_lthash_batch_t batch[1];
+  fd_hashes_lthash_batch_init( batch );
+
   if( FD_UNLIKELY( txn_ctx->exec_err ) ) {
 
     /* Save the fee_payer. Everything but the fee balance should be reset.
@@ -917,12 +921,12 @@ fd_runtime_finalize_txn( fd_funk_t *               funk,
 
        We should always rollback the nonce account first. Note that the nonce account may be the fee payer (case 2). */
     if( txn_ctx->nonce_account_idx_in_txn!=ULONG_MAX ) {
-      fd_runtime_save_account( funk, xid, txn_ctx->rollback_nonce_account, bank, capture_ctx );
+      fd_runtime_save_account( funk, xid, txn_ctx->rollback_nonce_account, batch, bank, capture_ctx );
     }
 
     /* Now, we must only save the fee payer if the nonce account was not the fee payer (because that was already saved above) */
     if( FD_LIKELY( txn_ctx->nonce_account_idx_in_txn!=FD_FEE_PAYER_TXN_IDX ) ) {
-      fd_runtime_save_account( funk, xid, txn_ctx->rollback_fee_payer_account, bank, capture_ctx );
+      fd_runtime_save_account( funk, xid, txn_ctx->rollback_fee_payer_account, batch, bank, capture_ctx );
     }
   } else {
 
@@ -971,7 +975,7 @@ fd_runtime_finalize_txn( fd_funk_t *               funk,
          cache updates have been applied. */
       fd_executor_reclaim_account( txn_ctx, &txn_ctx->accounts[i] );
 
-      fd_runtime_save_account( funk, xid, &txn_ctx->accounts[i], bank, capture_ctx );
+      fd_runtime_save_account( funk, xid, &txn_ctx->accounts[i], batch, bank, capture_ctx );
     }
 
     /* We need to queue any existing program accounts that may have
@@ -985,6 +989,8 @@ fd_runtime_finalize_txn( fd_funk_t *               funk,
       }
   }
 
+  fd_hashes_lthash_batch_fini( batch, bank, txn_ctx->lthash_part_idx );
+
   int is_vote = fd_txn_is_simple_vote_transaction( TXN( &txn_ctx->txn ), txn_ctx->txn.payload );
   if( !is_vote ){
     ulong * nonvote_txn_count = fd_bank_nonvote_txn_count_modify( bank );
@@ -1280,7 +1286,10 @@ fd_runtime_process_new_epoch( fd_banks_t *              banks,
                               fd_funk_txn_xid_t const * xid,
                               fd_capture_ctx_t *        capture_ctx,
                               ulong                     parent_epoch,
-                              fd_runtime_stack_t *      runtime_stack ) {
+                              fd_runtime_stack_t *      runtime_stack,
+                              fd_tpool_t *              tpool,
+                              ulong                     tpool_t0,
+                              ulong                     tpool_t1 ) {
 
   FD_LOG_NOTICE(( "fd_process_new_epoch start, epoch: %lu, slot: %lu", fd_bank_epoch_get( bank ), fd_bank_slot_get( bank ) ));
 
@@ -1323,7 +1332,7 @@ fd_runtime_process_new_epoch( fd_banks_t *              banks,
   /* Updates stake history sysvar accumulated values and recomputes
      stake delegations for vote accounts. */
 
-  fd_stakes_activate_epoch( bank, accdb, xid, capture_ctx, stake_delegations, new_rate_activation_epoch );
+  fd_stakes_activate_epoch( bank, accdb, xid, capture_ctx, stake_delegations, new_rate_activation_epoch, tpool, tpool_t0, tpool_t1 );
 
   /* Distribute rewards.  This involves calculating the rewards for
      every vote and stake account. */
@@ -1336,7 +1345,10 @@ fd_runtime_process_new_epoch( fd_banks_t *              banks,
                                 capture_ctx,
                                 stake_delegations,
                                 parent_blockhash,
-                                parent_epoch );
+                                parent_epoch,
+                                tpool,
+                                tpool_t0,
+                                tpool_t1 );
 
   /* The Agave client handles updating their stakes cache with a call to
      update_epoch_stakes() which keys stakes by the leader schedule
@@ -1542,7 +1554,8 @@ fd_runtime_init_bank_from_genesis( fd_banks_t *                       banks,
       bank,
       stake_delegations,
       stake_history,
-      &new_rate_activation_epoch );
+      &new_rate_activation_epoch,
+      NULL, 0UL, 1UL );
 
   /* Now that the stake and vote delegations are updated correctly, we
      will propagate the vote states to the vote states for the previous
@@ -1693,6 +1706,9 @@ fd_runtime_block_pre_execute_process_new_epoch( fd_banks_t *              banks,
                                                 fd_funk_txn_xid_t const * xid,
                                                 fd_capture_ctx_t *        capture_ctx,
                                                 fd_runtime_stack_t *      runtime_stack,
+                                                fd_tpool_t *              tpool,
+                                                ulong                     tpool_t0,
+                                                ulong                     tpool_t1,
                                                 int *                     is_epoch_boundary ) {
 
   ulong const slot = fd_bank_slot_get( bank );
@@ -1709,7 +1725,7 @@ fd_runtime_block_pre_execute_process_new_epoch( fd_banks_t *              banks,
 
     if( FD_UNLIKELY( prev_epoch<new_epoch || !slot_idx ) ) {
       FD_LOG_DEBUG(( "Epoch boundary starting" ));
-      fd_runtime_process_new_epoch( banks, bank, accdb, xid, capture_ctx, prev_epoch, runtime_stack );
+      fd_runtime_process_new_epoch( banks, bank, accdb, xid, capture_ctx, prev_epoch, runtime_stack, tpool, tpool_t0, tpool_t1 );
       *is_epoch_boundary = 1;
     }
   } else {
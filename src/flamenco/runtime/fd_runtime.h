@@ -14,6 +14,7 @@
 #include "info/fd_instr_info.h"
 #include "../../disco/pack/fd_microblock.h"
 #include "../../ballet/sbpf/fd_sbpf_loader.h"
+#include "../../util/tpool/fd_tpool.h"
 #include "../vm/fd_vm_base.h"
 
 #include "program/fd_bpf_loader_program.h"
@@ -315,7 +316,11 @@ fd_runtime_finalize_txn( fd_funk_t *               funk,
    new_from_parent() for every slot.
    https://github.com/anza-xyz/agave/blob/v1.18.26/runtime/src/bank.rs#L1483
    Account changes done by this function are counted towards the first
-   slot of the new epoch (NOT the last slot of the old epoch). */
+   slot of the new epoch (NOT the last slot of the old epoch).  The
+   stake and reward calculations over all stake delegations use the
+   caller and tpool threads (tpool_t0,tpool_t1) (see
+   fd_begin_partitioned_rewards).  tpool can be NULL if
+   tpool_t1-tpool_t0<=1. */
 void
 fd_runtime_block_pre_execute_process_new_epoch( fd_banks_t *              banks,
                                                 fd_bank_t *               bank,
@@ -323,6 +328,9 @@ fd_runtime_block_pre_execute_process_new_epoch( fd_banks_t *              banks,
                                                 fd_funk_txn_xid_t const * xid,
                                                 fd_capture_ctx_t *        capture_ctx,
                                                 fd_runtime_stack_t *      runtime_stack,
+                                                fd_tpool_t *              tpool,
+                                                ulong                     tpool_t0,
+                                                ulong                     tpool_t1,
                                                 int *                     is_epoch_boundary );
 
 /* Offline Replay *************************************************************/
@@ -4,6 +4,7 @@
 
 #include "../../../ballet/sbpf/fd_sbpf_loader.h"
 #include "../../progcache/fd_prog_load.h"
+#include "../../vm/jit/fd_vm_jit_cache.h"
 #include "../sysvar/fd_sysvar.h"
 #include "../fd_pubkey_utils.h"
 #include "../fd_exec_stack.h"
@@ -465,6 +466,7 @@ fd_bpf_execute( fd_exec_instr_ctx_t *      instr_ctx,
     FD_LOG_WARNING(( "null vm" ));
     return FD_EXECUTOR_INSTR_ERR_PROGRAM_ENVIRONMENT_SETUP_FAILURE;
   }
+  vm->tcode = fd_progcache_rec_tcode( cache_entry );
 
   if( FD_UNLIKELY( instr_ctx->txn_ctx->fuzz_config.enable_vm_tracing ) ) {
     /* TODO:FIXME: figure out what to do with 5 ~100mb buffers. */
@@ -475,7 +477,12 @@ fd_bpf_execute( fd_exec_instr_ctx_t *      instr_ctx,
     // if( FD_UNLIKELY( !vm->trace ) ) FD_LOG_ERR(( "unable to create trace; make sure you've compiled with sufficient spad size " ));
   }
 
+# if FD_HAS_X86
+  fd_progcache_t * progcache = instr_ctx->txn_ctx->progcache;
+  int exec_err = fd_vm_jit_cache_exec( progcache ? progcache->jit : NULL, cache_entry->jit_tag, vm );
+# else
   int exec_err = fd_vm_exec( vm );
+# endif
   instr_ctx->txn_ctx->compute_budget_details.compute_meter = vm->cu;
 
   if( FD_UNLIKELY( vm->trace ) ) {
@@ -1,5 +1,6 @@
 #include "../../util/fd_util_base.h"
 #include "fd_hashes.h"
+#include "fd_bank.h"
 #include "../../ballet/lthash/fd_lthash.h"
 #include "../types/fd_types.h"
 #include <string.h>
@@ -636,6 +637,97 @@ test_fd_hashes_update_lthash( void ) {
   FD_LOG_NOTICE(( "test_fd_hashes_update_lthash passed" ));
 }
 
+/* test_fd_hashes_lthash_batch checks that mixing account updates into
+   bank lthash partials with fd_hashes_lthash_batch and merging them
+   gives the same lthash as updating the bank lthash account by
+   account. */
+
+#define TEST_BATCH_ACC_CNT (40UL)
+
+static fd_bank_t         test_bank[1];
+static fd_account_meta_t test_batch_meta[ 2*TEST_BATCH_ACC_CNT ];
+static uchar             test_batch_data[ 2*TEST_BATCH_ACC_CNT ][ 1024 ];
+
+static int
+test_bank_lthash_equal( fd_lthash_value_t const * expected ) {
+  int eq = fd_lthash_equal( fd_bank_lthash_locking_query( test_bank ), expected );
+  fd_bank_lthash_end_locking_query( test_bank );
+  return eq;
+}
+
+static void
+test_fd_hashes_lthash_batch( void ) {
+  FD_LOG_NOTICE(( "Testing fd_hashes_lthash_batch" ));
+
+  fd_rng_t _rng[1]; fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, 1234U, 0UL ) );
+
+  memset( test_bank, 0, sizeof(fd_bank_t) );
+  for( ulong i=0UL; i<FD_BANK_LTHASH_PARTIAL_CNT; i++ ) fd_rwlock_unwrite( &test_bank->lthash_partial_lock[ i ] );
+
+  fd_lthash_value_t initial_lthash[1];
+  for( ulong i=0UL; i<FD_LTHASH_LEN_BYTES; i++ ) initial_lthash->bytes[ i ] = fd_rng_uchar( rng );
+  fd_bank_lthash_set( test_bank, *initial_lthash );
+
+  /* Accounts [0,cnt) are the previous versions, [cnt,2*cnt) the new
+     versions.  Mix in account sizes on both sides of the adder's
+     batching threshold and some zero-lamport accounts. */
+
+  fd_pubkey_t pubkey[ TEST_BATCH_ACC_CNT ];
+  for( ulong i=0UL; i<2*TEST_BATCH_ACC_CNT; i++ ) {
+    fd_account_meta_t * meta = &test_batch_meta[ i ];
+    memset( meta, 0, sizeof(fd_account_meta_t) );
+    meta->lamports   = (fd_rng_uint_roll( rng, 8U )==0U) ? 0UL : fd_rng_ulong( rng );
+    meta->executable = fd_rng_uchar( rng );
+    meta->dlen       = (uint)fd_rng_ulong_roll( rng, 1024UL );
+    for( ulong j=0UL; j<FD_PUBKEY_FOOTPRINT; j++ ) meta->owner[ j ] = fd_rng_uchar( rng );
+    for( ulong j=0UL; j<meta->dlen;          j++ ) test_batch_data[ i ][ j ] = fd_rng_uchar( rng );
+    if( i<TEST_BATCH_ACC_CNT ) for( ulong j=0UL; j<FD_PUBKEY_FOOTPRINT; j++ ) pubkey[ i ].uc[ j ] = fd_rng_uchar( rng );
+  }
+
+  /* Reference: update account by account */
+
+  fd_lthash_value_t expected[1];
+  *expected = *initial_lthash;
+  for( ulong i=0UL; i<TEST_BATCH_ACC_CNT; i++ ) {
+    fd_lthash_value_t h[1];
+    fd_hashes_account_lthash( &pubkey[ i ], &test_batch_meta[ i ], test_batch_data[ i ], h );
+    fd_lthash_sub( expected, h );
+    fd_hashes_account_lthash( &pubkey[ i ], &test_batch_meta[ TEST_BATCH_ACC_CNT+i ], test_batch_data[ TEST_BATCH_ACC_CNT+i ], h );
+    fd_lthash_add( expected, h );
+  }
+
+  /* Split the accounts into batches of a few accounts each, finished
+     into different partials (including colliding ones). */
+
+  for( ulong i=0UL; i<TEST_BATCH_ACC_CNT; ) {
+    ulong batch_cnt = fd_ulong_min( 1UL+fd_rng_ulong_roll( rng, 12UL ), TEST_BATCH_ACC_CNT-i );
+    fd_hashes_lthash_batch_t batch[1];
+    fd_hashes_lthash_batch_init( batch );
+    for( ulong j=i; j<i+batch_cnt; j++ ) {
+      fd_hashes_lthash_batch_sub( batch, &pubkey[ j ], &test_batch_meta[ j ], test_batch_data[ j ] );
+      fd_hashes_lthash_batch_add( batch, &pubkey[ j ], &test_batch_meta[ TEST_BATCH_ACC_CNT+j ], test_batch_data[ TEST_BATCH_ACC_CNT+j ] );
+    }
+    fd_hashes_lthash_batch_fini( batch, test_bank, fd_rng_ulong_roll( rng, 2UL*FD_BANK_LTHASH_PARTIAL_CNT ) );
+    i += batch_cnt;
+  }
+
+  /* Partials are not visible until merged */
+
+  FD_TEST( test_bank_lthash_equal( initial_lthash ) );
+
+  fd_hashes_lthash_merge_partials( test_bank );
+  FD_TEST( test_bank_lthash_equal( expected ) );
+  for( ulong i=0UL; i<FD_BANK_LTHASH_PARTIAL_CNT; i++ ) FD_TEST( !test_bank->lthash_partial_dirty[ i ] );
+
+  /* Merging again is a no-op */
+
+  fd_hashes_lthash_merge_partials( test_bank );
+  FD_TEST( test_bank_lthash_equal( expected ) );
+
+  fd_rng_delete( fd_rng_leave( rng ) );
+  FD_LOG_NOTICE(( "test_fd_hashes_lthash_batch passed" ));
+}
+
 int
 main( int     argc,
       char ** argv ) {
@@ -644,6 +736,7 @@ main( int     argc,
   test_fd_hashes_account_lthash();
   test_fd_hashes_hash_bank();
   test_fd_hashes_update_lthash();
+  test_fd_hashes_lthash_batch();
 
   FD_LOG_NOTICE(( "pass" ));
   fd_halt();
@@ -442,30 +442,80 @@ fd_stake_delegations_cnt( fd_stake_delegations_t const * stake_delegations ) {
 
 fd_stake_delegation_t *
 fd_stake_delegations_iter_ele( fd_stake_delegations_iter_t * iter ) {
-  ulong idx = fd_stake_delegation_map_iter_idx( iter->iter, iter->map, iter->pool );
-  return fd_stake_delegation_pool_ele( iter->pool, idx );
+  return fd_stake_delegation_pool_ele( iter->pool, iter->iter.ele_idx );
+}
+
+ulong
+fd_stake_delegations_chain_cnt( fd_stake_delegations_t const * stake_delegations ) {
+  if( FD_UNLIKELY( !stake_delegations ) ) {
+    FD_LOG_CRIT(( "NULL stake_delegations" ));
+  }
+
+  return fd_stake_delegation_map_chain_cnt( fd_stake_delegations_get_map( stake_delegations ) );
 }
 
 fd_stake_delegations_iter_t *
-fd_stake_delegations_iter_init( fd_stake_delegations_iter_t *  iter,
-                                fd_stake_delegations_t const * stake_delegations ) {
+fd_stake_delegations_iter_init_chains( fd_stake_delegations_iter_t *  iter,
+                                       fd_stake_delegations_t const * stake_delegations,
+                                       ulong                          chain0,
+                                       ulong                          chain1 ) {
   if( FD_UNLIKELY( !stake_delegations ) ) {
     FD_LOG_CRIT(( "NULL stake_delegations" ));
   }
 
   iter->map  = fd_stake_delegations_get_map( stake_delegations );
   iter->pool = fd_stake_delegations_get_pool( stake_delegations );
-  iter->iter = fd_stake_delegation_map_iter_init( iter->map, iter->pool );
+
+  chain1 = fd_ulong_min( chain1, fd_stake_delegation_map_chain_cnt( iter->map ) );
+  chain0 = fd_ulong_min( chain0, chain1 );
+
+  /* Like fd_map_chain's iterator, chains are walked from the highest
+     to the lowest index.  Find the first element.  If the range is
+     empty, chain_rem will be chain0. */
+
+  ulong const * chain     = fd_stake_delegation_map_private_chain_const( fd_stake_delegation_map_private_const( iter->map ) );
+  ulong         chain_rem = chain1;
+  ulong         ele_idx   = fd_stake_delegation_map_private_idx_null();
+  while( chain_rem>chain0 ) {
+    ele_idx = fd_stake_delegation_map_private_unbox( chain[ chain_rem-1UL ] );
+    if( !fd_stake_delegation_map_private_idx_is_null( ele_idx ) ) break;
+    chain_rem--;
+  }
+
+  iter->iter.chain_rem = chain_rem;
+  iter->iter.ele_idx   = ele_idx;
+  iter->chain_lo       = chain0;
 
   return iter;
 }
 
+fd_stake_delegations_iter_t *
+fd_stake_delegations_iter_init( fd_stake_delegations_iter_t *  iter,
+                                fd_stake_delegations_t const * stake_delegations ) {
+  return fd_stake_delegations_iter_init_chains( iter, stake_delegations, 0UL, ULONG_MAX );
+}
+
 void
 fd_stake_delegations_iter_next( fd_stake_delegations_iter_t * iter ) {
-  iter->iter = fd_stake_delegation_map_iter_next( iter->iter, iter->map, iter->pool );
+  ulong chain_rem = iter->iter.chain_rem;
+  ulong ele_idx   = fd_stake_delegation_map_private_unbox( iter->pool[ iter->iter.ele_idx ].next_ );
+  if( fd_stake_delegation_map_private_idx_is_null( ele_idx ) ) {
+
+    /* No more elements on chain chain_rem-1.  Move on to the next
+       non-empty chain in the range, if any. */
+
+    ulong const * chain = fd_stake_delegation_map_private_chain_const( fd_stake_delegation_map_private_const( iter->map ) );
+    while( --chain_rem>iter->chain_lo ) {
+      ele_idx = fd_stake_delegation_map_private_unbox( chain[ chain_rem-1UL ] );
+      if( !fd_stake_delegation_map_private_idx_is_null( ele_idx ) ) break;
+    }
+  }
+
+  iter->iter.chain_rem = chain_rem;
+  iter->iter.ele_idx   = ele_idx;
 }
 
 int
 fd_stake_delegations_iter_done( fd_stake_delegations_iter_t * iter ) {
-  return fd_stake_delegation_map_iter_done( iter->iter, iter->map, iter->pool );
+  return iter->iter.chain_rem<=iter->chain_lo;
 }
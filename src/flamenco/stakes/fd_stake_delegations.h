@@ -175,6 +175,7 @@ struct fd_stake_delegations_iter {
   fd_stake_delegation_map_t *    map;
   fd_stake_delegation_t *        pool;
   fd_stake_delegation_map_iter_t iter;
+  ulong                          chain_lo; /* iteration stops at chain chain_lo */
 };
 typedef struct fd_stake_delegations_iter fd_stake_delegations_iter_t;
 
@@ -321,8 +322,8 @@ fd_stake_delegations_max( fd_stake_delegations_t const * stake_delegations ) {
    or remove fd_stake_delegation_t from the stake delegations struct
    while iterating.
 
-   Under the hood, the iterator is just a wrapper over the iterator in
-   fd_map_chain.c.
+   Under the hood, the iterator walks the chains of the map in
+   fd_map_chain.c in the same order as the map's own iterator.
 
    Example use:
 
@@ -346,6 +347,36 @@ fd_stake_delegations_iter_next( fd_stake_delegations_iter_t * iter );
 int
 fd_stake_delegations_iter_done( fd_stake_delegations_iter_t * iter );
 
+/* fd_stake_delegations_chain_cnt returns the number of chains in the
+   map of stake delegations.  Every stake delegation is on exactly one
+   chain, so disjoint ranges of chains partition the stake delegations
+   into disjoint sets that can be walked concurrently (e.g. by the
+   blocks of an FD_MAP_REDUCE over [0,chain_cnt)).  The number of chains
+   is fixed when stake_delegations is created.
+
+   fd_stake_delegations_iter_init_chains is fd_stake_delegations_iter_init
+   restricted to the stake delegations on chains [chain0,chain1).  The
+   range is clamped to [0,chain_cnt).  Iterating over all the ranges of
+   a partition of [0,chain_cnt) visits each stake delegation exactly
+   once.  Walking ranges concurrently is safe as long as nothing is
+   inserted or removed while iterating.
+
+   FD_STAKE_DELEGATIONS_CHAIN_BLOCK_THRESH is the block threshold (in
+   chains) used by the epoch boundary kernels that walk the stake
+   delegations.  Using the same threshold everywhere makes the kernels
+   partition the chains the same way. */
+
+#define FD_STAKE_DELEGATIONS_CHAIN_BLOCK_THRESH (1024L)
+
+ulong
+fd_stake_delegations_chain_cnt( fd_stake_delegations_t const * stake_delegations );
+
+fd_stake_delegations_iter_t *
+fd_stake_delegations_iter_init_chains( fd_stake_delegations_iter_t *  iter,
+                                       fd_stake_delegations_t const * stake_delegations,
+                                       ulong                          chain0,
+                                       ulong                          chain1 );
+
 FD_PROTOTYPES_END
 
 #endif /* HEADER_fd_src_flamenco_stakes_fd_stake_delegations_h */
@@ -25,33 +25,77 @@ fd_stake_weights_by_node( fd_vote_states_t const * vote_states,
   return weights_cnt;
 }
 
-/* We need to update the amount of stake that each vote account has for
-   the given epoch.  This can only be done after the stake history
-   sysvar has been updated.  We also cache the stakes for each of the
-   vote accounts for the previous epoch.
+/* fd_stakes_private_refresh_op adds the effective stake of the stake
+   delegations on map chains [block_i0,block_i1) to the stake of the
+   vote account each is delegated to and reduces the total effective
+   stake of these delegations.  Vote accounts are shared between
+   blocks, so their stake is updated atomically (the result does not
+   depend on the order of the adds). */
+
+static FD_MAP_REDUCE_BEGIN( fd_stakes_private_refresh_op, FD_STAKE_DELEGATIONS_CHAIN_BLOCK_THRESH, 0UL, sizeof(ulong), 1L ) {
+  ulong *                        total_stake               = (ulong *)                       arg[0];
+  fd_stake_delegations_t const * stake_delegations         = (fd_stake_delegations_t const *)arg[1];
+  fd_stake_history_t const *     history                   = (fd_stake_history_t const *)    arg[2];
+  fd_vote_states_t *             vote_states               = (fd_vote_states_t *)            arg[3];
+  ulong                          epoch                     =                                 arg[4];
+  ulong *                        new_rate_activation_epoch = (ulong *)                       arg[5];
+
+  ulong stake_sum = 0UL;
 
-   https://github.com/anza-xyz/agave/blob/v3.0.4/runtime/src/stakes.rs#L471 */
-void
-fd_refresh_vote_accounts( fd_bank_t *                    bank,
-                          fd_stake_delegations_t const * stake_delegations,
-                          fd_stake_history_t const *     history,
-                          ulong *                        new_rate_activation_epoch ) {
+  fd_stake_delegations_iter_t iter_[1];
+  for( fd_stake_delegations_iter_t * iter = fd_stake_delegations_iter_init_chains( iter_, stake_delegations, (ulong)block_i0, (ulong)block_i1 );
+       !fd_stake_delegations_iter_done( iter );
+       fd_stake_delegations_iter_next( iter ) ) {
+    fd_stake_delegation_t const * stake_delegation = fd_stake_delegations_iter_ele( iter );
 
-  ulong epoch = fd_bank_epoch_get( bank );
+    fd_delegation_t delegation = {
+      .voter_pubkey         = stake_delegation->vote_account,
+      .stake                = stake_delegation->stake,
+      .deactivation_epoch   = stake_delegation->deactivation_epoch,
+      .activation_epoch     = stake_delegation->activation_epoch,
+      .warmup_cooldown_rate = stake_delegation->warmup_cooldown_rate,
+    };
 
-  ulong total_stake = 0UL;
+    fd_stake_history_entry_t new_entry = fd_stake_activating_and_deactivating(
+        &delegation,
+        epoch,
+        history,
+        new_rate_activation_epoch );
 
-  fd_vote_states_t * vote_states = fd_bank_vote_states_locking_modify( bank );
-  if( FD_UNLIKELY( !vote_states ) ) {
-    FD_LOG_CRIT(( "vote_states is NULL" ));
+    fd_vote_state_ele_t * vote_state = fd_vote_states_query( vote_states, &stake_delegation->vote_account );
+    if( FD_LIKELY( vote_state ) ) {
+      stake_sum += new_entry.effective;
+#     if FD_HAS_ATOMIC
+      FD_ATOMIC_FETCH_AND_ADD( &vote_state->stake, new_entry.effective );
+#     else
+      vote_state->stake += new_entry.effective;
+#     endif
+    }
   }
 
-  /* Reset the vote stakes so we can re-compute them based on the most
-     current stake delegation values. */
-  fd_vote_states_reset_stakes( vote_states );
+  *total_stake = stake_sum;
+
+} FD_MAP_END {
+
+  *(ulong *)arg[0] += *(ulong const *)_r1;
+
+} FD_REDUCE_END
+
+/* fd_stakes_private_history_op reduces the effective, activating and
+   deactivating stake at epoch of the stake delegations on map chains
+   [block_i0,block_i1). */
+
+static FD_MAP_REDUCE_BEGIN( fd_stakes_private_history_op, FD_STAKE_DELEGATIONS_CHAIN_BLOCK_THRESH, 0UL, sizeof(fd_stake_history_entry_t), 1L ) {
+  fd_stake_history_entry_t *     entry                     = (fd_stake_history_entry_t *)    arg[0];
+  fd_stake_delegations_t const * stake_delegations         = (fd_stake_delegations_t const *)arg[1];
+  fd_stake_history_t const *     history                   = (fd_stake_history_t const *)    arg[2];
+  ulong                          epoch                     =                                 arg[3];
+  ulong *                        new_rate_activation_epoch = (ulong *)                       arg[4];
+
+  fd_stake_history_entry_t sum = { .effective = 0UL, .activating = 0UL, .deactivating = 0UL };
 
   fd_stake_delegations_iter_t iter_[1];
-  for( fd_stake_delegations_iter_t * iter = fd_stake_delegations_iter_init( iter_, stake_delegations );
+  for( fd_stake_delegations_iter_t * iter = fd_stake_delegations_iter_init_chains( iter_, stake_delegations, (ulong)block_i0, (ulong)block_i1 );
        !fd_stake_delegations_iter_done( iter );
        fd_stake_delegations_iter_next( iter ) ) {
     fd_stake_delegation_t const * stake_delegation = fd_stake_delegations_iter_ele( iter );
@@ -59,8 +103,8 @@ fd_refresh_vote_accounts( fd_bank_t *                    bank,
     fd_delegation_t delegation = {
       .voter_pubkey         = stake_delegation->vote_account,
       .stake                = stake_delegation->stake,
-      .deactivation_epoch   = stake_delegation->deactivation_epoch,
       .activation_epoch     = stake_delegation->activation_epoch,
+      .deactivation_epoch   = stake_delegation->deactivation_epoch,
       .warmup_cooldown_rate = stake_delegation->warmup_cooldown_rate,
     };
 
@@ -69,15 +113,70 @@ fd_refresh_vote_accounts( fd_bank_t *                    bank,
         epoch,
         history,
         new_rate_activation_epoch );
+    sum.effective    += new_entry.effective;
+    sum.activating   += new_entry.activating;
+    sum.deactivating += new_entry.deactivating;
+  }
 
-    fd_vote_state_ele_t * vote_state = fd_vote_states_query( vote_states, &stake_delegation->vote_account );
-    if( FD_LIKELY( vote_state ) ) {
-      total_stake       += new_entry.effective;
-      vote_state->stake += new_entry.effective;
-    }
+  *entry = sum;
+
+} FD_MAP_END {
+
+  fd_stake_history_entry_t *       e0 = (fd_stake_history_entry_t *)      arg[0];
+  fd_stake_history_entry_t const * e1 = (fd_stake_history_entry_t const *)_r1;
+  e0->effective    += e1->effective;
+  e0->activating   += e1->activating;
+  e0->deactivating += e1->deactivating;
+
+} FD_REDUCE_END
+
+fd_stake_history_entry_t
+fd_stakes_accumulate_history_entry( fd_stake_delegations_t const * stake_delegations,
+                                    ulong                          epoch,
+                                    fd_stake_history_t const *     history,
+                                    ulong *                        new_rate_activation_epoch,
+                                    fd_tpool_t *                   tpool,
+                                    ulong                          tpool_t0,
+                                    ulong                          tpool_t1 ) {
+  fd_stake_history_entry_t entry[1] __attribute__((aligned(128)));
+  FD_MAP_REDUCE( fd_stakes_private_history_op, tpool, tpool_t0, tpool_t1,
+                 0L, (long)fd_stake_delegations_chain_cnt( stake_delegations ),
+                 entry, stake_delegations, history, epoch, new_rate_activation_epoch );
+  return entry[0];
+}
+
+/* We need to update the amount of stake that each vote account has for
+   the given epoch.  This can only be done after the stake history
+   sysvar has been updated.  We also cache the stakes for each of the
+   vote accounts for the previous epoch.
+
+   https://github.com/anza-xyz/agave/blob/v3.0.4/runtime/src/stakes.rs#L471 */
+void
+fd_refresh_vote_accounts( fd_bank_t *                    bank,
+                          fd_stake_delegations_t const * stake_delegations,
+                          fd_stake_history_t const *     history,
+                          ulong *                        new_rate_activation_epoch,
+                          fd_tpool_t *                   tpool,
+                          ulong                          tpool_t0,
+                          ulong                          tpool_t1 ) {
+
+  ulong epoch = fd_bank_epoch_get( bank );
+
+  fd_vote_states_t * vote_states = fd_bank_vote_states_locking_modify( bank );
+  if( FD_UNLIKELY( !vote_states ) ) {
+    FD_LOG_CRIT(( "vote_states is NULL" ));
   }
 
-  fd_bank_total_epoch_stake_set( bank, total_stake );
+  /* Reset the vote stakes so we can re-compute them based on the most
+     current stake delegation values. */
+  fd_vote_states_reset_stakes( vote_states );
+
+  ulong total_stake[1] __attribute__((aligned(128)));
+  FD_MAP_REDUCE( fd_stakes_private_refresh_op, tpool, tpool_t0, tpool_t1,
+                 0L, (long)fd_stake_delegations_chain_cnt( stake_delegations ),
+                 total_stake, stake_delegations, history, vote_states, epoch, new_rate_activation_epoch );
+
+  fd_bank_total_epoch_stake_set( bank, total_stake[0] );
 
   /* This corresponding logic does not exist in the Agave client.  The
      stakes from epoch T-2 are cached in the vote states struct in order
@@ -100,6 +199,149 @@ fd_refresh_vote_accounts( fd_bank_t *                    bank,
   fd_bank_vote_states_end_locking_modify( bank );
 }
 
+#define SORT_NAME        sort_vote_weights_by_vote
+#define SORT_KEY_T       fd_vote_stake_weight_t
+#define SORT_BEFORE(a,b) (memcmp( (a).vote_key.uc, (b).vote_key.uc, 32UL )<0)
+#include "../../util/tmpl/fd_sort.c"
+
+fd_stakes_projection_t *
+fd_stakes_projection_init( fd_stakes_projection_t *   proj,
+                           fd_vote_states_t const *   vote_states,
+                           fd_stake_history_t const * stake_history,
+                           ulong                      epoch,
+                           ulong const *              new_rate_activation_epoch,
+                           fd_vote_stake_weight_t *   weights ) {
+  proj->epoch                         = epoch;
+  proj->new_rate_activation_epoch     = new_rate_activation_epoch ? *new_rate_activation_epoch : 0UL;
+  proj->has_new_rate_activation_epoch = !!new_rate_activation_epoch;
+  proj->pass                          = 0;
+  proj->chain_next                    = 0UL;
+  proj->entry                         = (fd_stake_history_entry_t){ .effective = 0UL, .activating = 0UL, .deactivating = 0UL };
+  *proj->history                      = *stake_history;
+  proj->weights                       = weights;
+
+  /* weights is sorted by vote account for the lookups of the second
+     pass. */
+
+  ulong weights_cnt = 0UL;
+  fd_vote_states_iter_t vs_iter_[1];
+  for( fd_vote_states_iter_t * vs_iter = fd_vote_states_iter_init( vs_iter_, vote_states );
+       !fd_vote_states_iter_done( vs_iter );
+       fd_vote_states_iter_next( vs_iter ) ) {
+    fd_vote_state_ele_t const * vote_state = fd_vote_states_iter_ele( vs_iter );
+    fd_memcpy( weights[ weights_cnt ].vote_key.uc, &vote_state->vote_account, sizeof(fd_pubkey_t) );
+    fd_memcpy( weights[ weights_cnt ].id_key.uc,   &vote_state->node_account, sizeof(fd_pubkey_t) );
+    weights[ weights_cnt ].stake = 0UL;
+    weights_cnt++;
+  }
+  sort_vote_weights_by_vote_inplace( weights, weights_cnt );
+  proj->weights_cnt = weights_cnt;
+
+  return proj;
+}
+
+/* fd_stakes_private_projection_history adds the stake history entry
+   for epoch accumulated by the first pass to the copy of the stake
+   history, like fd_sysvar_stake_history_update. */
+
+static void
+fd_stakes_private_projection_history( fd_stakes_projection_t * proj ) {
+  fd_stake_history_t * history = proj->history;
+  if( history->fd_stake_history_offset == 0 ) {
+    history->fd_stake_history_offset = history->fd_stake_history_size - 1;
+  } else {
+    history->fd_stake_history_offset--;
+  }
+  if( history->fd_stake_history_len < history->fd_stake_history_size ) {
+    history->fd_stake_history_len++;
+  }
+  history->fd_stake_history[ history->fd_stake_history_offset ].epoch = proj->epoch;
+  history->fd_stake_history[ history->fd_stake_history_offset ].entry = proj->entry;
+}
+
+int
+fd_stakes_projection_step( fd_stakes_projection_t *       proj,
+                           fd_stake_delegations_t const * stake_delegations,
+                           ulong                          chain_cnt ) {
+  if( FD_UNLIKELY( proj->pass==2 ) ) return 1;
+
+  ulong   chain0 = proj->chain_next;
+  ulong   chain1 = fd_ulong_min( chain0+chain_cnt, fd_stake_delegations_chain_cnt( stake_delegations ) );
+  ulong * new_rate_activation_epoch = proj->has_new_rate_activation_epoch ? &proj->new_rate_activation_epoch : NULL;
+
+  fd_stake_delegations_iter_t iter_[1];
+  for( fd_stake_delegations_iter_t * iter = fd_stake_delegations_iter_init_chains( iter_, stake_delegations, chain0, chain1 );
+       !fd_stake_delegations_iter_done( iter );
+       fd_stake_delegations_iter_next( iter ) ) {
+    fd_stake_delegation_t const * stake_delegation = fd_stake_delegations_iter_ele( iter );
+
+    fd_delegation_t delegation = {
+      .voter_pubkey         = stake_delegation->vote_account,
+      .stake                = stake_delegation->stake,
+      .activation_epoch     = stake_delegation->activation_epoch,
+      .deactivation_epoch   = stake_delegation->deactivation_epoch,
+      .warmup_cooldown_rate = stake_delegation->warmup_cooldown_rate,
+    };
+
+    if( !proj->pass ) {
+
+      /* Accumulate the stake history entry for epoch, like
+         fd_stakes_activate_epoch. */
+
+      fd_stake_history_entry_t new_entry = fd_stake_activating_and_deactivating(
+          &delegation,
+          proj->epoch,
+          proj->history,
+          new_rate_activation_epoch );
+      proj->entry.effective    += new_entry.effective;
+      proj->entry.activating   += new_entry.activating;
+      proj->entry.deactivating += new_entry.deactivating;
+
+    } else {
+
+      /* Accumulate the effective stake at epoch+1 of each vote account,
+         like fd_refresh_vote_accounts. */
+
+      fd_vote_stake_weight_t query;
+      fd_memcpy( query.vote_key.uc, &stake_delegation->vote_account, sizeof(fd_pubkey_t) );
+      ulong idx = sort_vote_weights_by_vote_search_geq( proj->weights, proj->weights_cnt, query );
+      if( FD_UNLIKELY( idx>=proj->weights_cnt || memcmp( proj->weights[ idx ].vote_key.uc, query.vote_key.uc, 32UL ) ) ) continue;
+
+      fd_stake_history_entry_t new_entry = fd_stake_activating_and_deactivating(
+          &delegation,
+          proj->epoch+1UL,
+          proj->history,
+          new_rate_activation_epoch );
+      proj->weights[ idx ].stake += new_entry.effective;
+
+    }
+  }
+
+  proj->chain_next = chain1;
+  if( FD_LIKELY( chain1<fd_stake_delegations_chain_cnt( stake_delegations ) ) ) return 0;
+
+  /* The pass is over */
+  if( !proj->pass ) fd_stakes_private_projection_history( proj );
+  proj->pass++;
+  proj->chain_next = 0UL;
+  return proj->pass==2;
+}
+
+ulong
+fd_stakes_projection_fini( fd_stakes_projection_t * proj ) {
+
+  /* Drop the unstaked vote accounts and sort like
+     fd_stake_weights_by_node. */
+
+  fd_vote_stake_weight_t * weights = proj->weights;
+  ulong staked_cnt = 0UL;
+  for( ulong i=0UL; i<proj->weights_cnt; i++ ) {
+    if( FD_LIKELY( weights[ i ].stake ) ) weights[ staked_cnt++ ] = weights[ i ];
+  }
+  sort_vote_weights_by_stake_vote_inplace( weights, staked_cnt );
+  return staked_cnt;
+}
+
 /* https://github.com/anza-xyz/agave/blob/v3.0.4/runtime/src/stakes.rs#L280 */
 void
 fd_stakes_activate_epoch( fd_bank_t *                    bank,
@@ -107,7 +349,10 @@ fd_stakes_activate_epoch( fd_bank_t *                    bank,
                           fd_funk_txn_xid_t const *      xid,
                           fd_capture_ctx_t *             capture_ctx,
                           fd_stake_delegations_t const * stake_delegations,
-                          ulong *                        new_rate_activation_epoch ) {
+                          ulong *                        new_rate_activation_epoch,
+                          fd_tpool_t *                   tpool,
+                          ulong                          tpool_t0,
+                          ulong                          tpool_t1 ) {
 
   /* First, we need to accumulate the stats for the current amount of
      effective, activating, and deactivating stake for the current
@@ -120,39 +365,18 @@ fd_stakes_activate_epoch( fd_bank_t *                    bank,
     FD_LOG_ERR(( "StakeHistory sysvar is missing from sysvar cache" ));
   }
 
+  ulong epoch = fd_bank_epoch_get( bank );
   fd_epoch_stake_history_entry_pair_t new_elem = {
-    .epoch = fd_bank_epoch_get( bank ),
-    .entry = {
-      .effective    = 0UL,
-      .activating   = 0UL,
-      .deactivating = 0UL
-    }
+    .epoch = epoch,
+    .entry = fd_stakes_accumulate_history_entry( stake_delegations,
+                                                 epoch,
+                                                 stake_history,
+                                                 new_rate_activation_epoch,
+                                                 tpool,
+                                                 tpool_t0,
+                                                 tpool_t1 )
   };
 
-  fd_stake_delegations_iter_t iter_[1];
-  for( fd_stake_delegations_iter_t * iter = fd_stake_delegations_iter_init( iter_, stake_delegations );
-       !fd_stake_delegations_iter_done( iter );
-       fd_stake_delegations_iter_next( iter ) ) {
-    fd_stake_delegation_t const * stake_delegation = fd_stake_delegations_iter_ele( iter );
-
-    fd_delegation_t delegation = {
-      .voter_pubkey         = stake_delegation->vote_account,
-      .stake                = stake_delegation->stake,
-      .activation_epoch     = stake_delegation->activation_epoch,
-      .deactivation_epoch   = stake_delegation->deactivation_epoch,
-      .warmup_cooldown_rate = stake_delegation->warmup_cooldown_rate,
-    };
-
-    fd_stake_history_entry_t new_entry = fd_stake_activating_and_deactivating(
-        &delegation,
-        fd_bank_epoch_get( bank ),
-        stake_history,
-        new_rate_activation_epoch );
-    new_elem.entry.effective    += new_entry.effective;
-    new_elem.entry.activating   += new_entry.activating;
-    new_elem.entry.deactivating += new_entry.deactivating;
-  }
-
   fd_sysvar_stake_history_update( bank, accdb, xid, capture_ctx, &new_elem );
 
   if( FD_UNLIKELY( !fd_sysvar_stake_history_read( accdb->funk, xid, stake_history ) ) ) {
@@ -167,7 +391,10 @@ fd_stakes_activate_epoch( fd_bank_t *                    bank,
   fd_refresh_vote_accounts( bank,
                             stake_delegations,
                             stake_history,
-                            new_rate_activation_epoch );
+                            new_rate_activation_epoch,
+                            tpool,
+                            tpool_t0,
+                            tpool_t1 );
 
 }
 
@@ -3,6 +3,7 @@
 
 #include "../fd_flamenco_base.h"
 #include "../types/fd_types.h"
+#include "../../util/tpool/fd_tpool.h"
 #include "fd_stake_delegations.h"
 #include "fd_vote_states.h"
 
@@ -26,13 +27,40 @@ ulong
 fd_stake_weights_by_node( fd_vote_states_t const * vote_states,
                           fd_vote_stake_weight_t * weights );
 
+/* The epoch boundary functions below walk all the stake delegations.
+   They use the caller and tpool threads (tpool_t0,tpool_t1) to do so
+   (see FD_MAP_REDUCE), splitting the work by stake delegation map
+   chain.  Threads (tpool_t0,tpool_t1) are assumed to be idle.  If
+   tpool_t1-tpool_t0<=1, all the work is done by the caller and tpool
+   can be NULL.  The results do not depend on the number of threads. */
+
+/* fd_stakes_activate_epoch appends the entry for the current epoch of
+   the bank to the stake history sysvar, increments the bank's epoch
+   and refreshes the stake of the vote accounts for the new epoch. */
+
 void
 fd_stakes_activate_epoch( fd_bank_t *                    bank,
                           fd_accdb_user_t *              accdb,
                           fd_funk_txn_xid_t const *      xid,
                           fd_capture_ctx_t *             capture_ctx,
                           fd_stake_delegations_t const * stake_delegations,
-                          ulong *                        new_rate_activation_epoch );
+                          ulong *                        new_rate_activation_epoch,
+                          fd_tpool_t *                   tpool,
+                          ulong                          tpool_t0,
+                          ulong                          tpool_t1 );
+
+/* fd_stakes_accumulate_history_entry returns the sum of the effective,
+   activating and deactivating stake at epoch of all the stake
+   delegations given the stake history. */
+
+fd_stake_history_entry_t
+fd_stakes_accumulate_history_entry( fd_stake_delegations_t const * stake_delegations,
+                                    ulong                          epoch,
+                                    fd_stake_history_t const *     history,
+                                    ulong *                        new_rate_activation_epoch,
+                                    fd_tpool_t *                   tpool,
+                                    ulong                          tpool_t0,
+                                    ulong                          tpool_t1 );
 
 fd_stake_history_entry_t
 stake_and_activating( fd_delegation_t const * delegation,
@@ -50,11 +78,87 @@ int
 write_stake_state( fd_txn_account_t *    stake_acc_rec,
                    fd_stake_state_v2_t * stake_state );
 
+/* fd_refresh_vote_accounts recomputes the stake of every vote account
+   of the bank (and the bank's total epoch stake) from the stake
+   delegations. */
+
 void
 fd_refresh_vote_accounts( fd_bank_t *                    bank,
                           fd_stake_delegations_t const * stake_delegations,
                           fd_stake_history_t const *     history,
-                          ulong *                        new_rate_activation_epoch );
+                          ulong *                        new_rate_activation_epoch,
+                          fd_tpool_t *                   tpool,
+                          ulong                          tpool_t0,
+                          ulong                          tpool_t1 );
+
+/* fd_stakes_projection_t computes ahead of time the stake weights that
+   the next epoch boundary will assign to the vote accounts in
+   vote_states (ie. the vote_states_prev of the first bank of epoch+1,
+   see fd_runtime.c), assuming the stake delegations and vote_states do
+   not change until the boundary.  The stake history entry for epoch
+   that the boundary will add is derived from the stake delegations the
+   same way.
+
+   Projecting walks all the stake delegations twice, which is too long
+   to do in one go on a tile's critical path, so the walk is split into
+   steps of a bounded number of stake delegation map chains (see
+   fd_stake_delegations_iter_init_chains):
+
+     fd_stakes_projection_init( proj, vote_states, ... );
+     while( !fd_stakes_projection_step( proj, stake_delegations, chain_cnt ) ) { ... do other work ... }
+     ulong staked_cnt = fd_stakes_projection_fini( proj );
+
+   stake_delegations must be the same object for every step.  Stake
+   delegations inserted, removed or modified in between steps are seen
+   as of the step that walks their chain, so the result is then a mix
+   of the states the steps saw (a caller that can check the projection
+   against the real boundary can tolerate that). */
+
+struct fd_stakes_projection {
+  ulong                    epoch;
+  ulong                    new_rate_activation_epoch;
+  int                      has_new_rate_activation_epoch;
+  int                      pass;        /* 0: stake history entry, 1: vote account stakes, 2: done */
+  ulong                    chain_next;  /* next chain to walk in the current pass */
+  fd_stake_history_entry_t entry;
+  fd_stake_history_t       history[1];
+  fd_vote_stake_weight_t * weights;
+  ulong                    weights_cnt;
+};
+typedef struct fd_stakes_projection fd_stakes_projection_t;
+
+/* fd_stakes_projection_init starts a projection.  epoch is the current
+   epoch, stake_history is the current StakeHistory sysvar and
+   new_rate_activation_epoch is as for fd_stakes_activate_epoch (both
+   are copied).  weights must have room for fd_vote_states_cnt(
+   vote_states ) items and is used by proj until fini.  vote_states is
+   only read during the call.  Returns proj. */
+
+fd_stakes_projection_t *
+fd_stakes_projection_init( fd_stakes_projection_t *   proj,
+                           fd_vote_states_t const *   vote_states,
+                           fd_stake_history_t const * stake_history,
+                           ulong                      epoch,
+                           ulong const *              new_rate_activation_epoch,
+                           fd_vote_stake_weight_t *   weights );
+
+/* fd_stakes_projection_step walks the stake delegations on the next
+   chain_cnt (positive) chains of stake_delegations.  Returns 1 once
+   all the stake delegations have been walked (both passes) and 0
+   otherwise. */
+
+int
+fd_stakes_projection_step( fd_stakes_projection_t *       proj,
+                           fd_stake_delegations_t const * stake_delegations,
+                           ulong                          chain_cnt );
+
+/* fd_stakes_projection_fini finishes a projection for which step
+   returned 1.  On return, the weights passed to init hold the vote
+   accounts with non-zero projected stake in the order of
+   fd_stake_weights_by_node.  Returns the number of items in weights. */
+
+ulong
+fd_stakes_projection_fini( fd_stakes_projection_t * proj );
 
 /* fd_stakes_update_delegation is used to maintain the in-memory cache
    of the stake delegations that is used at the epoch boundary.  Entries
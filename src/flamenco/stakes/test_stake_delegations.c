@@ -1,4 +1,5 @@
 #include "fd_stake_delegations.h"
+#include "fd_stakes.h"
 #include "../runtime/fd_runtime_const.h"
 
 int main( int argc, char ** argv ) {
@@ -164,6 +165,88 @@ int main( int argc, char ** argv ) {
   FD_TEST( stake_delegation->is_tombstone == 0 );
   FD_TEST( fd_stake_delegations_cnt( stake_delegations ) == 3UL );
 
+  /* Test iterating over ranges of chains */
+
+  ulong const many_stake_accounts = 65536UL;
+  void * many_mem = fd_wksp_alloc_laddr( wksp, fd_stake_delegations_align(), fd_stake_delegations_footprint( many_stake_accounts ), wksp_tag );
+  FD_TEST( many_mem );
+  fd_stake_delegations_t * many = fd_stake_delegations_join( fd_stake_delegations_new( many_mem, many_stake_accounts, 0 ) );
+  FD_TEST( many );
+
+  fd_rng_t _rng[1]; fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, 1234U, 0UL ) );
+  ulong stake_sum = 0UL;
+  for( ulong i=0UL; i<many_stake_accounts-7UL; i++ ) {
+    fd_pubkey_t stake_account = { .ul = { fd_rng_ulong( rng ), i } };
+    fd_pubkey_t vote_account  = { .ul = { fd_rng_ulong( rng ) & 63UL } };
+    ulong       stake         = fd_rng_ulong_roll( rng, 1000000UL );
+    ulong       activation    = fd_rng_uint_roll( rng, 4U ) ? fd_rng_ulong_roll( rng, 8UL ) : ULONG_MAX;
+    ulong       deactivation  = fd_rng_uint_roll( rng, 4U ) ? ULONG_MAX : fd_rng_ulong_roll( rng, 8UL );
+    fd_stake_delegations_update( many, &stake_account, &vote_account, stake, activation, deactivation, 0UL, 0.25 );
+    stake_sum += stake;
+  }
+  ulong many_cnt   = fd_stake_delegations_cnt( many );
+  ulong chain_cnt  = fd_stake_delegations_chain_cnt( many );
+  FD_TEST( many_cnt==many_stake_accounts-7UL );
+  FD_TEST( fd_ulong_is_pow2( chain_cnt ) );
+
+  for( ulong part_cnt=1UL; part_cnt<=chain_cnt; part_cnt*=7UL ) {
+    ulong visit_cnt = 0UL;
+    ulong visit_sum = 0UL;
+    fd_stake_delegations_iter_t full_[1];
+    fd_stake_delegations_iter_t * full = fd_stake_delegations_iter_init( full_, many );
+    for( ulong part_idx=part_cnt; part_idx; part_idx-- ) {
+      ulong chain0 = ((part_idx-1UL)*chain_cnt)/part_cnt;
+      ulong chain1 = ( part_idx     *chain_cnt)/part_cnt;
+      fd_stake_delegations_iter_t iter_[1];
+      for( fd_stake_delegations_iter_t * iter = fd_stake_delegations_iter_init_chains( iter_, many, chain0, chain1 );
+           !fd_stake_delegations_iter_done( iter );
+           fd_stake_delegations_iter_next( iter ) ) {
+        /* Ranges walked from the highest to the lowest visit the stake
+           delegations in the same order as the full iterator */
+        FD_TEST( !fd_stake_delegations_iter_done( full ) );
+        FD_TEST( fd_stake_delegations_iter_ele( iter )==fd_stake_delegations_iter_ele( full ) );
+        fd_stake_delegations_iter_next( full );
+        visit_cnt++;
+        visit_sum += fd_stake_delegations_iter_ele( iter )->stake;
+      }
+    }
+    FD_TEST( fd_stake_delegations_iter_done( full ) );
+    FD_TEST( visit_cnt==many_cnt );
+    FD_TEST( visit_sum==stake_sum );
+  }
+
+  fd_stake_delegations_iter_t empty_[1];
+  FD_TEST( fd_stake_delegations_iter_done( fd_stake_delegations_iter_init_chains( empty_, many, 3UL, 3UL ) ) );
+  FD_TEST( fd_stake_delegations_iter_done( fd_stake_delegations_iter_init_chains( empty_, many, 5UL, 2UL ) ) );
+  FD_TEST( fd_stake_delegations_iter_done( fd_stake_delegations_iter_init_chains( empty_, many, chain_cnt, ULONG_MAX ) ) );
+
+  /* Test that the stake history entry does not depend on the number of
+     threads used to compute it */
+
+  static uchar tpool_mem[ FD_TPOOL_FOOTPRINT(FD_TILE_MAX) ] __attribute__((aligned(FD_TPOOL_ALIGN)));
+  ulong        tile_cnt = fd_tile_cnt();
+  fd_tpool_t * tpool    = fd_tpool_init( tpool_mem, tile_cnt, 0UL );
+  FD_TEST( tpool );
+  for( ulong tile_idx=1UL; tile_idx<tile_cnt; tile_idx++ ) FD_TEST( fd_tpool_worker_push( tpool, tile_idx ) );
+
+  fd_stake_history_t history[1];
+  fd_stake_history_new( history );
+  for( ulong epoch=0UL; epoch<10UL; epoch++ ) {
+    ulong new_rate_activation_epoch = 4UL;
+    fd_stake_history_entry_t ref = fd_stakes_accumulate_history_entry( many, epoch, history, &new_rate_activation_epoch, NULL, 0UL, 1UL );
+    FD_TEST( ref.effective<=stake_sum );
+    for( ulong thread_cnt=2UL; thread_cnt<=tile_cnt; thread_cnt++ ) {
+      fd_stake_history_entry_t par = fd_stakes_accumulate_history_entry( many, epoch, history, &new_rate_activation_epoch, tpool, 0UL, thread_cnt );
+      FD_TEST( par.effective   ==ref.effective    );
+      FD_TEST( par.activating  ==ref.activating   );
+      FD_TEST( par.deactivating==ref.deactivating );
+    }
+  }
+
+  FD_TEST( fd_tpool_fini( tpool ) );
+  fd_rng_delete( fd_rng_leave( rng ) );
+  fd_wksp_free_laddr( fd_stake_delegations_delete( fd_stake_delegations_leave( many ) ) );
+
   /* Test stake delegations refresh */
 
   FD_LOG_NOTICE(( "pass" ));
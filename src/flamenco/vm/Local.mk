@@ -2,8 +2,8 @@ ifdef FD_HAS_HOSTED
 ifdef FD_HAS_INT128
 ifdef FD_HAS_SECP256K1
 
-$(call add-hdrs,fd_vm_base.h fd_vm.h fd_vm_private.h) # FIXME: PRIVATE TEMPORARILY HERE DUE TO SOME MESSINESS IN FD_VM_SYSCALL.H
-$(call add-objs,fd_vm fd_vm_interp fd_vm_disasm fd_vm_trace,fd_flamenco)
+$(call add-hdrs,fd_vm_base.h fd_vm.h fd_vm_private.h fd_vm_tcode.h) # FIXME: PRIVATE TEMPORARILY HERE DUE TO SOME MESSINESS IN FD_VM_SYSCALL.H
+$(call add-objs,fd_vm fd_vm_interp fd_vm_tcode fd_vm_disasm fd_vm_trace,fd_flamenco)
 
 $(call add-hdrs,test_vm_util.h)
 $(call add-objs,test_vm_util,fd_flamenco)
@@ -633,6 +633,7 @@ fd_vm_init(
   vm->text_sz                              = text_sz;
   vm->entry_pc                             = entry_pc;
   vm->calldests                            = calldests;
+  vm->tcode                                = NULL;
   vm->sbpf_version                         = sbpf_version;
   vm->syscalls                             = syscalls;
   vm->trace                                = trace;
@@ -2,6 +2,7 @@
 #define HEADER_fd_src_flamenco_vm_fd_vm_h
 
 #include "fd_vm_base.h"
+#include "fd_vm_tcode.h"
 #include "../../ballet/sha256/fd_sha256.h"
 
 /* A fd_vm_t is an opaque handle of a virtual machine that can execute
@@ -211,6 +212,9 @@ struct __attribute__((aligned(FD_VM_HOST_REGION_ALIGN))) fd_vm {
 
   fd_sha256_t * sha; /* Pre-joined SHA instance. This should be re-initialised before every use. */
 
+  fd_vm_tcode_t const * tcode; /* Pre-decoded text, indexed [0,text_cnt), NULL to decode text while executing.  Not set
+                                  by fd_vm_init (see fd_vm_tcode.h and fd_vm_exec_tcode) */
+
   ulong magic;    /* ==FD_VM_MAGIC */
 
   int   direct_mapping;                       /* If direct mapping feature flag is enabled */
@@ -241,7 +245,7 @@ FD_PROTOTYPES_BEGIN
    integer power of 2.  FOOTPRINT is a multiple of align.
    These are provided to facilitate compile time declarations. */
 #define FD_VM_ALIGN     FD_VM_HOST_REGION_ALIGN
-#define FD_VM_FOOTPRINT (527824UL)
+#define FD_VM_FOOTPRINT (527840UL)
 
 /* fd_vm_{align,footprint} give the needed alignment and footprint
    of a memory region suitable to hold an fd_vm_t.
@@ -456,7 +460,10 @@ fd_vm_setup_state_for_execution( fd_vm_t * vm ) ;
 
    fd_vm_exec_trace runs with tracing and requires vm to be attached to
    a trace.  fd_vm_exec_notrace runs without without tracing even if vm
-   is attached to a trace. */
+   is attached to a trace.  fd_vm_exec_tcode runs without tracing from
+   the program's pre-decoded text and requires vm->tcode to be set to
+   the tcode of the program attached to vm (it is otherwise equivalent
+   to fd_vm_exec_notrace). */
 
 int
 fd_vm_exec_trace( fd_vm_t * vm );
@@ -464,10 +471,14 @@ fd_vm_exec_trace( fd_vm_t * vm );
 int
 fd_vm_exec_notrace( fd_vm_t * vm );
 
+int
+fd_vm_exec_tcode( fd_vm_t * vm );
+
 static inline int
 fd_vm_exec( fd_vm_t * vm ) {
-  if( FD_UNLIKELY( vm->trace ) ) return fd_vm_exec_trace  ( vm );
-  else                           return fd_vm_exec_notrace( vm );
+  if(      FD_UNLIKELY( vm->trace ) ) return fd_vm_exec_trace  ( vm );
+  else if( FD_LIKELY  ( vm->tcode ) ) return fd_vm_exec_tcode  ( vm );
+  else                                return fd_vm_exec_notrace( vm );
 }
 
 FD_PROTOTYPES_END
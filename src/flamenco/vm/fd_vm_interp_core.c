@@ -44,7 +44,9 @@
      instruction.  After a normal halt, this will branch to interp_halt.
      Otherwise, it will branch to the appropriate normal termination. */
 
+# ifndef FD_VM_INTERP_TCODE_ENABLED
   ulong instr;
+# endif
   ulong opcode;
   ulong dst;
   ulong src;
@@ -80,6 +82,18 @@
 #define FD_RUST_UINT_WRAPPING_SHR( a, b ) (a >> ( b & ( 31 ) ))
 
 
+# ifdef FD_VM_INTERP_TCODE_ENABLED /* Operands pre-decoded at program load time (see fd_vm_tcode.h) */
+# define FD_VM_INTERP_INSTR_EXEC                                                                 \
+  if( FD_UNLIKELY( pc>=text_cnt ) ) goto sigtext; /* Note: untaken branches don't consume BTB */ \
+  opcode  = tcode[ pc ].op;              /* in [0,256) */                                        \
+  dst     = tcode[ pc ].dst;             /* in [0, 16) */                                        \
+  src     = tcode[ pc ].src;             /* in [0, 16) */                                        \
+  offset  = tcode[ pc ].offset;          /* sign extended or pre-resolved */                     \
+  imm     = tcode[ pc ].imm;             /* in [0,2^32) */                                       \
+  reg_dst = reg[ dst ];                  /* Guaranteed in-bounds */                              \
+  reg_src = reg[ src ];                  /* Guaranteed in-bounds */                              \
+  goto *version_interp_jump_table[ opcode ]      /* Guaranteed in-bounds */
+# else
 # define FD_VM_INTERP_INSTR_EXEC                                                                 \
   if( FD_UNLIKELY( pc>=text_cnt ) ) goto sigtext; /* Note: untaken branches don't consume BTB */ \
   instr   = text[ pc ];                  /* Guaranteed in-bounds */                              \
@@ -91,6 +105,7 @@
   reg_dst = reg[ dst ];                  /* Guaranteed in-bounds */                              \
   reg_src = reg[ src ];                  /* Guaranteed in-bounds */                              \
   goto *version_interp_jump_table[ opcode ]      /* Guaranteed in-bounds */
+# endif
 
 /* FD_VM_INTERP_SYSCALL_EXEC
    (macro to handle the logic of 0x85 pre- and post- SIMD-0178: static syscalls)
@@ -346,7 +361,11 @@ interp_exec:
     ic_correction++;
     /* No need to check pc because it's already checked during validation.
        if( FD_UNLIKELY( pc>=text_cnt ) ) goto sigsplit; // Note: untaken branches don't consume BTB */
+#   ifdef FD_VM_INTERP_TCODE_ENABLED
+    reg[ dst ] = offset; /* full immediate */
+#   else
     reg[ dst ] = (ulong)((ulong)imm | ((ulong)fd_vm_instr_imm( text[ pc ] ) << 32));
+#   endif
   FD_VM_INTERP_INSTR_END;
 
   FD_VM_INTERP_INSTR_BEGIN(0x1c) /* FD_SBPF_OP_SUB_REG */
@@ -703,6 +722,13 @@ interp_exec:
       /* Special case to handle entrypoint.
          ebpf::hash_symbol_name(b"entrypoint") = 0xb00c380, and
          fd_pchash_inverse( 0xb00c380U ) = 0x71e3cf81U */
+#     ifdef FD_VM_INTERP_TCODE_ENABLED
+      /* The target (entrypoint included) was resolved and checked as
+         below when pre-decoding */
+      if( FD_UNLIKELY( offset==ULONG_MAX ) ) goto sigillbr;
+      FD_VM_INTERP_STACK_PUSH;
+      pc = offset - 1;
+#     else
       if( FD_UNLIKELY( imm==0x71e3cf81U ) ) {
         FD_VM_INTERP_STACK_PUSH;
         pc = entry_pc - 1;
@@ -717,6 +743,7 @@ interp_exec:
         FD_VM_INTERP_STACK_PUSH;
         pc = target_pc - 1;
       }
+#     endif
 
     } else {
 
@@ -1072,6 +1099,51 @@ interp_exec:
     reg[ dst ] = (ulong)( (long)reg_dst % (long)reg_src );
   FD_VM_INTERP_INSTR_END;
 
+# ifdef FD_VM_INTERP_TCODE_ENABLED
+
+  /* Superinstructions (see fd_vm_tcode.h).  These execute a sequence
+     of single word instructions starting at pc.  Operands not packed
+     into the first entry are read from the entries of the following
+     instructions.  On a fault, pc is moved to the faulting instruction
+     such that billing is the same as for the unfused sequence. */
+
+  FD_VM_INTERP_INSTR_BEGIN(0x01tc) /* FD_VM_TCODE_OP_MOV64_ADD64_IMM */
+    reg[ dst ] = reg_src + (ulong)(long)(int)imm;
+    pc++;
+  FD_VM_INTERP_INSTR_END;
+
+  FD_VM_INTERP_INSTR_BEGIN(0x02tc) /* FD_VM_TCODE_OP_MOV64_MOV64 */
+    reg[ dst ] = reg_src;
+    reg[ imm & 15U ] = reg[ (imm>>4) & 15U ];
+    pc++;
+  FD_VM_INTERP_INSTR_END;
+
+  FD_VM_INTERP_INSTR_BEGIN(0x03tc) { /* FD_VM_TCODE_OP_LD64_ADD64_ST64 */
+    ulong vaddr   = reg_src + offset;
+    ulong haddr   = fd_vm_mem_haddr( vm, vaddr, sizeof(ulong), region_haddr, region_ld_sz, 0, 0UL );
+    if( FD_UNLIKELY( !haddr ) ) {
+      vm->segv_vaddr       = vaddr;
+      vm->segv_access_type = FD_VM_ACCESS_TYPE_LD;
+      vm->segv_access_len  = 8UL;
+      goto sigsegv;
+    } /* Note: untaken branches don't consume BTB */
+    ulong val = fd_vm_mem_ld_8( haddr ) + (ulong)(long)(int)imm;
+    reg[ dst ] = val;
+    pc += 2UL;
+    vaddr = reg[ tcode[ pc ].dst ] + tcode[ pc ].offset;
+    haddr = fd_vm_mem_haddr( vm, vaddr, sizeof(ulong), region_haddr, region_st_sz, 1, 0UL );
+    if( FD_UNLIKELY( !haddr ) ) {
+      vm->segv_vaddr       = vaddr;
+      vm->segv_access_type = FD_VM_ACCESS_TYPE_ST;
+      vm->segv_access_len  = 8UL;
+      goto sigsegv;
+    } /* Note: untaken branches don't consume BTB */
+    fd_vm_mem_st_8( haddr, val );
+  }
+  FD_VM_INTERP_INSTR_END;
+
+# endif
+
   /* FIXME: sigbus/sigrdonly are mapped to sigsegv for simplicity
      currently but could be enabled if desired. */
 
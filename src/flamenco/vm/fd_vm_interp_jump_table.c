@@ -5,6 +5,7 @@
 #   define OPCODE(opcode) interp_##opcode
 #   define ALL_ILLEGAL(op) [0][op] = &&sigill,     [1][op] = &&sigill,     [2][op] = &&sigill,     [3][op] = &&sigill
 #   define ALL_OPCODE( op) [0][op] = &&OPCODE(op), [1][op] = &&OPCODE(op), [2][op] = &&OPCODE(op), [3][op] = &&OPCODE(op)
+#   define ALL_TCODE(  op) [0][op] = &&OPCODE(op##tc), [1][op] = &&OPCODE(op##tc), [2][op] = &&OPCODE(op##tc), [3][op] = &&OPCODE(op##tc)
 #   define CONDITIONAL(op, C, ltrue, lfalse) \
                        [0][op] = C(0) ? (ltrue):(lfalse), \
                        [1][op] = C(1) ? (ltrue):(lfalse), \
@@ -19,7 +20,11 @@
        CONDITIONAL list below. If we get it wrong, the compiler will
        complain about initialized fields being overwritten. */
 
+#   ifdef FD_VM_INTERP_TCODE_ENABLED /* Superinstructions (see fd_vm_tcode.h) */
+    ALL_ILLEGAL(0x00), ALL_TCODE  (0x01), ALL_TCODE  (0x02), ALL_TCODE  (0x03),
+#   else
     ALL_ILLEGAL(0x00), ALL_ILLEGAL(0x01), ALL_ILLEGAL(0x02), ALL_ILLEGAL(0x03),
+#   endif
     /*   55 :   0  */  ALL_OPCODE (0x05), ALL_ILLEGAL(0x06), ALL_OPCODE (0x07),
     ALL_ILLEGAL(0x08), ALL_ILLEGAL(0x09), ALL_ILLEGAL(0x0a), ALL_ILLEGAL(0x0b),
     /*   56 :   1  */  ALL_ILLEGAL(0x0d), ALL_ILLEGAL(0x0e), ALL_OPCODE (0x0f),
@@ -177,6 +182,7 @@
 
 #   undef ALL_ILLEGAL
 #   undef ALL_OPCODE
+#   undef ALL_TCODE
 #   undef CONDITIONAL
 #   undef OPCODE
   };
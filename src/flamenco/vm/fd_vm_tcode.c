@@ -0,0 +1,76 @@
+#include "fd_vm_tcode.h"
+#include "fd_vm_private.h"
+
+fd_vm_tcode_t *
+fd_vm_tcode_build( fd_vm_tcode_t * tcode,
+                   fd_vm_t const * vm ) {
+
+  ulong const * text         = vm->text;
+  ulong         text_cnt     = vm->text_cnt;
+  ulong         sbpf_version = vm->sbpf_version;
+
+  int   enable_lddw = FD_VM_SBPF_ENABLE_LDDW( sbpf_version );
+  int   hashed_call = !FD_VM_SBPF_STATIC_SYSCALLS( sbpf_version ); /* CALL_IMM imm is a hash of the target pc */
+  ulong op_ld64     = FD_VM_SBPF_MOVE_MEMORY_IX_CLASSES( sbpf_version ) ? 0x9cUL : 0x79UL; /* LDXDW */
+  ulong op_st64     = FD_VM_SBPF_MOVE_MEMORY_IX_CLASSES( sbpf_version ) ? 0x9fUL : 0x7bUL; /* STXDW */
+
+  /* Unpack instructions and resolve immediates */
+
+  for( ulong pc=0UL; pc<text_cnt; pc++ ) {
+    ulong instr  = text[ pc ];
+    ulong opcode = fd_vm_instr_opcode( instr );
+    uint  imm    = fd_vm_instr_imm   ( instr );
+    ulong offset = fd_vm_instr_offset( instr );
+
+    if( opcode==0x18UL && enable_lddw && pc+1UL<text_cnt ) {
+      offset = (ulong)imm | ((ulong)fd_vm_instr_imm( text[ pc+1UL ] )<<32);
+    } else if( opcode==0x85UL && hashed_call ) {
+      /* Matches the resolution in the 0x85depr handler (see
+         fd_vm_interp_core.c) */
+      if( imm==0x71e3cf81U ) { /* entrypoint */
+        offset = vm->entry_pc;
+      } else {
+        ulong target_pc = (ulong)fd_pchash_inverse( imm );
+        offset = ( target_pc<text_cnt && fd_sbpf_calldests_test( vm->calldests, target_pc ) ) ? target_pc : ULONG_MAX;
+      }
+    }
+
+    tcode[ pc ] = (fd_vm_tcode_t){
+      .op     = (uchar)opcode,
+      .dst    = (uchar)fd_vm_instr_dst( instr ),
+      .src    = (uchar)fd_vm_instr_src( instr ),
+      .imm    = imm,
+      .offset = offset
+    };
+  }
+
+  /* Fuse superinstructions.  Operands of fused instructions are taken
+     from the unfused entries (the fields of the entries are interpreted
+     the same way by the interpreter regardless of the first
+     instruction). */
+
+  for( ulong pc=0UL; pc<text_cnt; pc++ ) {
+    fd_vm_tcode_t * t0 = tcode + pc;
+
+    if( t0->op==0x18UL && enable_lddw ) { pc++; continue; } /* skip LDDW second word */
+
+    if( FD_UNLIKELY( pc+1UL>=text_cnt ) ) break;
+    fd_vm_tcode_t const * t1 = tcode + pc + 1UL;
+
+    if( t0->op==0xbfUL && t1->op==0x07UL && t1->dst==t0->dst ) {
+      t0->op  = (uchar)FD_VM_TCODE_OP_MOV64_ADD64_IMM;
+      t0->imm = t1->imm;
+    } else if( t0->op==0xbfUL && t1->op==0xbfUL ) {
+      t0->op  = (uchar)FD_VM_TCODE_OP_MOV64_MOV64;
+      t0->imm = (uint)t1->dst | ((uint)t1->src<<4);
+    } else if( t0->op==op_ld64 && t1->op==0x07UL && t1->dst==t0->dst && pc+2UL<text_cnt ) {
+      fd_vm_tcode_t const * t2 = tcode + pc + 2UL;
+      if( t2->op==op_st64 && t2->src==t0->dst ) {
+        t0->op  = (uchar)FD_VM_TCODE_OP_LD64_ADD64_ST64;
+        t0->imm = t1->imm;
+      }
+    }
+  }
+
+  return tcode;
+}
@@ -0,0 +1,84 @@
+#ifndef HEADER_fd_src_flamenco_vm_fd_vm_tcode_h
+#define HEADER_fd_src_flamenco_vm_fd_vm_tcode_h
+
+/* fd_vm_tcode is the pre-decoded ("threaded code") form of sBPF text
+   executed by the interpreter.
+
+   A program's tcode is built once, at program load time, from its
+   validated text.  It holds one entry per text word.  Each entry holds
+   the instruction's fields unpacked into naturally aligned integers,
+   with immediates and branch targets resolved as far as possible ahead
+   of time:
+
+   - offset is sign extended to 64 bits.
+
+   - For LDDW (first word), offset holds the full 64-bit immediate.
+
+   - For a local CALL_IMM (sBPF v0-v2, where the immediate is a hash of
+     the target pc), offset holds the resolved target pc or ULONG_MAX
+     if the immediate does not resolve to a valid call destination.
+
+   Common sequences of single word instructions are fused into
+   superinstructions.  The entry of the first instruction in the
+   sequence is replaced with a superinstruction whose operands are
+   packed in the unused fields of the entry.  The entries of the
+   remaining instructions are left as is, such that branches into the
+   middle of a sequence execute normally.  Superinstructions use opcodes
+   that are illegal in all sBPF versions (except 0x00, the opcode of the
+   second word of LDDW, which must still fault when reached by callx).  A
+   superinstruction that faults midway reports the state of the
+   equivalent sequence of unfused instructions (e.g. pc is at the
+   instruction that faulted).
+
+   Entries are only meaningful for the sBPF version and program (text,
+   calldests and entry_pc) they were built from.  tcode only contains
+   integers such that it can be shared by multiple processes (e.g. in
+   the program cache). */
+
+#include "../fd_flamenco_base.h"
+
+#define FD_VM_TCODE_ALIGN (8UL)
+
+/* Superinstruction opcodes */
+
+#define FD_VM_TCODE_OP_MOV64_ADD64_IMM (0x01UL) /* mov64 dst, src; add64 dst, imm */
+#define FD_VM_TCODE_OP_MOV64_MOV64     (0x02UL) /* mov64 dst, src; mov64 imm&15, (imm>>4)&15 */
+#define FD_VM_TCODE_OP_LD64_ADD64_ST64 (0x03UL) /* ldxdw dst, [src+off]; add64 dst, imm; stxdw [...], dst */
+
+struct fd_vm_tcode {
+  uchar op;     /* sBPF opcode or FD_VM_TCODE_OP_* */
+  uchar dst;    /* in [0,16) */
+  uchar src;    /* in [0,16) */
+  uchar _pad;
+  uint  imm;
+  ulong offset; /* see above */
+};
+
+typedef struct fd_vm_tcode fd_vm_tcode_t;
+
+FD_PROTOTYPES_BEGIN
+
+FD_FN_CONST static inline ulong
+fd_vm_tcode_align( void ) {
+  return FD_VM_TCODE_ALIGN;
+}
+
+FD_FN_CONST static inline ulong
+fd_vm_tcode_footprint( ulong text_cnt ) {
+  return text_cnt*sizeof(fd_vm_tcode_t);
+}
+
+/* fd_vm_tcode_build builds the tcode of the program attached to vm into
+   tcode (fd_vm_tcode_{align,footprint}(vm->text_cnt) compatible).  Uses
+   vm->{text,text_cnt,entry_pc,calldests,sbpf_version}.  The program
+   must have passed fd_vm_validate.  Returns tcode. */
+
+struct fd_vm;
+
+fd_vm_tcode_t *
+fd_vm_tcode_build( fd_vm_tcode_t *      tcode,
+                   struct fd_vm const * vm );
+
+FD_PROTOTYPES_END
+
+#endif /* HEADER_fd_src_flamenco_vm_fd_vm_tcode_h */
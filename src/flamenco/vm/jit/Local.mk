@@ -0,0 +1,15 @@
+ifdef FD_HAS_HOSTED
+ifdef FD_HAS_INT128
+ifdef FD_HAS_SECP256K1
+ifdef FD_HAS_X86
+
+$(call add-hdrs,fd_vm_jit.h fd_vm_jit_cache.h)
+$(call add-objs,fd_vm_jit fd_vm_jit_cache,fd_flamenco)
+
+$(call make-unit-test,test_vm_jit,test_vm_jit,fd_flamenco fd_funk fd_ballet fd_util,$(SECP256K1_LIBS))
+$(call run-unit-test,test_vm_jit)
+
+endif
+endif
+endif
+endif
@@ -0,0 +1,1337 @@
+#include "fd_vm_jit.h"
+
+#if FD_HAS_X86
+
+#include "../fd_vm_private.h"
+#include "../../runtime/tests/fd_dump_pb.h"
+
+#define FD_VM_JIT_MAGIC (0xF17EDA2CE7A5C0DEUL) /* FIREDANCER JIT CODE */
+
+/* FD_VM_JIT_{WORD_CODE_MAX,STUB_CODE_MAX} bound the number of bytes of
+   machine code emitted per text word and for the common stubs.  These
+   are checked when compiling. */
+
+#define FD_VM_JIT_WORD_CODE_MAX (320UL)
+#define FD_VM_JIT_STUB_CODE_MAX (1024UL)
+
+/* FD_VM_JIT_SHADOW marks jtab entries of text words that are the second
+   word of an LDQ (these are never executed as instructions). */
+
+#define FD_VM_JIT_SHADOW (UINT_MAX)
+
+/* FD_VM_JIT_CONTINUE is returned by branch helpers to indicate that
+   execution should resume at vm->pc. */
+
+#define FD_VM_JIT_CONTINUE (1)
+
+struct fd_vm_jit {
+  ulong magic;        /* ==FD_VM_JIT_MAGIC */
+  ulong sbpf_version; /* version the program was compiled for */
+  ulong text_cnt;     /* text_cnt the program was compiled for */
+  ulong idx_off;      /* byte offset from jit of uint idx [ text_cnt+1 ] */
+  ulong jtab_off;     /* byte offset from jit of uint jtab[ text_cnt   ], byte offset from jit of the code for each text word */
+  ulong code_off;     /* byte offset from jit of the machine code */
+  ulong code_sz;      /* machine code size in bytes */
+  ulong entry_off;    /* byte offset from jit of the entry point */
+};
+
+/* Host registers.  Register usage in compiled code:
+
+     r12 - vm
+     r13 - M = cu + idx(pc0) (see fd_vm_jit.h)
+     r14 - K = ic - idx(pc0)
+     r15 - jit
+     rbx - saved vaddr across a memory translation slow path
+     rax, rcx, rdx, r8, r9 and others - scratch
+
+   The sBPF registers live in vm->reg. */
+
+#define RAX ( 0U)
+#define RCX ( 1U)
+#define RDX ( 2U)
+#define RBX ( 3U)
+#define RSP ( 4U)
+#define RBP ( 5U)
+#define RSI ( 6U)
+#define RDI ( 7U)
+#define R8  ( 8U)
+#define R9  ( 9U)
+#define R12 (12U)
+#define R13 (13U)
+#define R14 (14U)
+#define R15 (15U)
+
+/* Condition codes */
+
+#define CC_B  (0x2U)
+#define CC_AE (0x3U)
+#define CC_E  (0x4U)
+#define CC_NE (0x5U)
+#define CC_BE (0x6U)
+#define CC_A  (0x7U)
+#define CC_L  (0xcU)
+#define CC_GE (0xdU)
+#define CC_LE (0xeU)
+#define CC_G  (0xfU)
+
+#define VM_OFF(f)  ((int)offsetof( fd_vm_t, f ))
+#define REG_OFF(r) ((int)( offsetof( fd_vm_t, reg ) + 8UL*(r) ))
+
+/* Helpers called from compiled code *********************************/
+
+/* fd_vm_jit_fault halts the vm with a fault at pc (idx is idx(pc)) as
+   FD_VM_INTERP_FAULT does. */
+
+static int
+fd_vm_jit_fault( fd_vm_t * vm,
+                 ulong     m,
+                 ulong     k,
+                 ulong     pc,
+                 ulong     idx,
+                 int       err ) {
+  ulong n = idx + 1UL;
+  vm->pc = pc;
+  vm->ic = k + n;
+  if( FD_UNLIKELY( n>m ) ) {
+    err    = FD_VM_ERR_EBPF_EXCEEDED_MAX_INSTRUCTIONS;
+    vm->cu = 0UL;
+  } else {
+    vm->cu = m - n;
+  }
+  return err;
+}
+
+static int
+fd_vm_jit_sigsegv( fd_vm_t * vm,
+                   ulong     m,
+                   ulong     k,
+                   ulong     pc,
+                   ulong     idx ) {
+  return fd_vm_jit_fault( vm, m, k, pc, idx, fd_vm_generate_access_violation( vm->segv_vaddr, vm->sbpf_version ) );
+}
+
+/* fd_vm_jit_haddr is the memory translation slow path (input region
+   and out of range regions).  Returns 0 on failure. */
+
+static ulong
+fd_vm_jit_haddr( fd_vm_t * vm,
+                 ulong     vaddr,
+                 ulong     sz,
+                 ulong     write ) {
+  return fd_vm_mem_haddr( vm, vaddr, sz, vm->region_haddr, write ? vm->region_st_sz : vm->region_ld_sz, (uchar)write, 0UL );
+}
+
+/* The branch helpers below are called by compiled code for calls,
+   syscalls and exits.  On entry, vm->ic and vm->cu have been billed
+   through the branch instruction at pc (as FD_VM_INTERP_BRANCH_BEGIN
+   does) and vm->frame_cnt is current.  They return FD_VM_JIT_CONTINUE
+   with vm->pc at the next instruction to execute or halt the vm and
+   return the error code to return from fd_vm_jit_exec. */
+
+static inline int
+fd_vm_jit_stack_push( fd_vm_t * vm,
+                      ulong     pc ) {
+  ulong            frame_cnt = vm->frame_cnt;
+  fd_vm_shadow_t * shadow    = vm->shadow + frame_cnt;
+  shadow->r6  = vm->reg[ 6];
+  shadow->r7  = vm->reg[ 7];
+  shadow->r8  = vm->reg[ 8];
+  shadow->r9  = vm->reg[ 9];
+  shadow->r10 = vm->reg[10];
+  shadow->pc  = pc;
+  vm->frame_cnt = ++frame_cnt;
+  if( FD_UNLIKELY( frame_cnt>=FD_VM_STACK_FRAME_MAX ) ) return 0;
+  if( !fd_sbpf_dynamic_stack_frames_enabled( vm->sbpf_version ) ) vm->reg[10] += FD_VM_STACK_FRAME_SZ * 2UL;
+  return 1;
+}
+
+static int
+fd_vm_jit_syscall_exec( fd_vm_t *                  vm,
+                        ulong                      pc,
+                        fd_sbpf_syscalls_t const * syscall ) {
+  ulong ic        = vm->ic;
+  ulong cu        = vm->cu;
+  ulong frame_cnt = vm->frame_cnt;
+
+  vm->pc = pc;
+  if( FD_UNLIKELY( vm->dump_syscall_to_pb ) ) {
+    fd_dump_vm_syscall_to_protobuf( vm, syscall->name );
+  }
+
+  ulong * reg = vm->reg;
+  ulong   ret[1];
+  int     err = syscall->func( vm, reg[1], reg[2], reg[3], reg[4], reg[5], ret );
+  reg[0] = ret[0];
+
+  /* As in FD_VM_INTERP_SYSCALL_EXEC, the syscall cannot modify pc, ic
+     or frame_cnt and cannot increase cu. */
+
+  cu = fd_ulong_min( vm->cu, cu );
+  vm->pc        = pc;
+  vm->ic        = ic;
+  vm->frame_cnt = frame_cnt;
+  if( FD_UNLIKELY( err ) ) {
+    if( err==FD_VM_SYSCALL_ERR_COMPUTE_BUDGET_EXCEEDED ) cu = 0UL;
+    FD_VM_TEST_ERR_EXISTS( vm );
+    vm->cu = cu;
+    return FD_VM_ERR_EBPF_SYSCALL_ERROR;
+  }
+  vm->cu = cu;
+  vm->pc = pc + 1UL;
+  return FD_VM_JIT_CONTINUE;
+}
+
+static int
+fd_vm_jit_call_imm( fd_vm_t * vm,
+                    ulong     pc,
+                    ulong     instr ) { /* 0x85 */
+  if( FD_UNLIKELY( !fd_vm_jit_stack_push( vm, pc ) ) ) {
+    vm->pc = pc;
+    return FD_VM_ERR_EBPF_CALL_DEPTH_EXCEEDED;
+  }
+  vm->pc = (ulong)( (long)pc + (long)(int)fd_vm_instr_imm( instr ) ) + 1UL;
+  return FD_VM_JIT_CONTINUE;
+}
+
+static int
+fd_vm_jit_call_imm_depr( fd_vm_t * vm,
+                         ulong     pc,
+                         ulong     instr ) { /* 0x85depr */
+  uint imm = fd_vm_instr_imm( instr );
+  fd_sbpf_syscalls_t const * syscall = fd_sbpf_syscalls_query_const( vm->syscalls, (ulong)imm, NULL );
+  if( FD_LIKELY( syscall ) ) return fd_vm_jit_syscall_exec( vm, pc, syscall );
+
+  ulong target_pc;
+  if( FD_UNLIKELY( imm==0x71e3cf81U ) ) { /* entrypoint, see interp */
+    target_pc = vm->entry_pc;
+  } else {
+    target_pc = (ulong)fd_pchash_inverse( imm );
+    if( FD_UNLIKELY( (target_pc>=vm->text_cnt) || !fd_sbpf_calldests_test( vm->calldests, target_pc ) ) ) {
+      vm->pc = pc;
+      return FD_VM_ERR_EBPF_UNSUPPORTED_INSTRUCTION;
+    }
+  }
+  if( FD_UNLIKELY( !fd_vm_jit_stack_push( vm, pc ) ) ) {
+    vm->pc = pc;
+    return FD_VM_ERR_EBPF_CALL_DEPTH_EXCEEDED;
+  }
+  vm->pc = target_pc;
+  return FD_VM_JIT_CONTINUE;
+}
+
+static int
+fd_vm_jit_call_reg( fd_vm_t * vm,
+                    ulong     pc,
+                    ulong     instr ) { /* 0x8d */
+  ulong reg_src = vm->reg[ fd_vm_instr_src( instr ) ];
+  if( FD_UNLIKELY( !fd_vm_jit_stack_push( vm, pc ) ) ) {
+    vm->pc = pc;
+    return FD_VM_ERR_EBPF_CALL_DEPTH_EXCEEDED;
+  }
+  ulong target_pc = (reg_src - vm->text_off) / 8UL;
+  vm->pc = pc;
+  if( FD_UNLIKELY( target_pc>=vm->text_cnt                        ) ) return FD_VM_ERR_EBPF_CALL_OUTSIDE_TEXT_SEGMENT;
+  if( FD_UNLIKELY( !fd_sbpf_calldests_test( vm->calldests, target_pc ) ) ) return FD_VM_ERR_EBPF_UNSUPPORTED_INSTRUCTION;
+  vm->pc = target_pc;
+  return FD_VM_JIT_CONTINUE;
+}
+
+static int
+fd_vm_jit_call_reg_depr( fd_vm_t * vm,
+                         ulong     pc,
+                         ulong     instr ) { /* 0x8ddepr */
+  ulong reg_src = vm->reg[ fd_vm_instr_src( instr ) ];
+  if( FD_UNLIKELY( !fd_vm_jit_stack_push( vm, pc ) ) ) {
+    vm->pc = pc;
+    return FD_VM_ERR_EBPF_CALL_DEPTH_EXCEEDED;
+  }
+  ulong vaddr     = fd_sbpf_callx_uses_src_reg_enabled( vm->sbpf_version ) ? reg_src : vm->reg[ fd_vm_instr_imm( instr ) & 15U ];
+  ulong region    = vaddr >> 32;
+  ulong target_pc = ((vaddr & FD_VM_OFFSET_MASK) - vm->text_off) / 8UL;
+  if( FD_UNLIKELY( (region!=1UL) | (target_pc>=vm->text_cnt) ) ) {
+    vm->pc = pc;
+    return FD_VM_ERR_EBPF_CALL_OUTSIDE_TEXT_SEGMENT;
+  }
+  vm->pc = target_pc;
+  return FD_VM_JIT_CONTINUE;
+}
+
+static int
+fd_vm_jit_syscall( fd_vm_t * vm,
+                   ulong     pc,
+                   ulong     instr ) { /* 0x95 */
+  fd_sbpf_syscalls_t const * syscall = fd_sbpf_syscalls_query_const( vm->syscalls, (ulong)fd_vm_instr_imm( instr ), NULL );
+  if( FD_UNLIKELY( !syscall ) ) {
+    vm->pc = pc;
+    return FD_VM_ERR_EBPF_UNSUPPORTED_INSTRUCTION;
+  }
+  return fd_vm_jit_syscall_exec( vm, pc, syscall );
+}
+
+static int
+fd_vm_jit_exit( fd_vm_t *               vm,
+                ulong                   pc,
+                FD_PARAM_UNUSED ulong   instr ) { /* 0x9d */
+  ulong frame_cnt = vm->frame_cnt;
+  if( FD_UNLIKELY( !frame_cnt ) ) {
+    vm->pc = pc;
+    return FD_VM_SUCCESS;
+  }
+  frame_cnt--;
+  fd_vm_shadow_t const * shadow = vm->shadow + frame_cnt;
+  vm->reg[ 6] = shadow->r6;
+  vm->reg[ 7] = shadow->r7;
+  vm->reg[ 8] = shadow->r8;
+  vm->reg[ 9] = shadow->r9;
+  vm->reg[10] = shadow->r10;
+  vm->pc        = shadow->pc + 1UL;
+  vm->frame_cnt = frame_cnt;
+  return FD_VM_JIT_CONTINUE;
+}
+
+typedef int (*fd_vm_jit_branch_fn_t)( fd_vm_t * vm, ulong pc, ulong instr );
+typedef int (*fd_vm_jit_entry_fn_t )( fd_vm_t * vm, fd_vm_jit_t const * jit );
+
+/* Assembler **********************************************************/
+
+/* A fd_vm_jit_asm_t is a cursor into the code being emitted.  When
+   code is NULL, nothing is written (sizing pass).  Every emitted
+   instruction has a size that depends only on the sBPF instruction
+   being compiled (all jumps are rel32 and all memory operands are
+   disp32) such that the sizing pass and the emitting pass agree on
+   every offset. */
+
+struct fd_vm_jit_asm {
+  uchar * code;
+  ulong   off;   /* byte offset from code */
+};
+
+typedef struct fd_vm_jit_asm fd_vm_jit_asm_t;
+
+static inline void
+emit_u8( fd_vm_jit_asm_t * a,
+         uint              b ) {
+  if( a->code ) a->code[ a->off ] = (uchar)b;
+  a->off++;
+}
+
+static inline void
+emit_u32( fd_vm_jit_asm_t * a,
+          uint              v ) {
+  if( a->code ) FD_STORE( uint, a->code + a->off, v );
+  a->off += 4UL;
+}
+
+static inline void
+emit_u64( fd_vm_jit_asm_t * a,
+          ulong             v ) {
+  if( a->code ) FD_STORE( ulong, a->code + a->off, v );
+  a->off += 8UL;
+}
+
+static inline void
+emit_rex( fd_vm_jit_asm_t * a,
+          int               w,
+          uint              reg,
+          uint              index,
+          uint              base ) {
+  uint rex = 0x40U | (w ? 8U : 0U) | (((reg>>3)&1U)<<2) | (((index>>3)&1U)<<1) | ((base>>3)&1U);
+  if( rex!=0x40U ) emit_u8( a, rex );
+}
+
+static inline void
+emit_op( fd_vm_jit_asm_t * a,
+         uint              op ) {
+  if( op>0xffU ) emit_u8( a, op>>8 );
+  emit_u8( a, op & 0xffU );
+}
+
+/* emit_rr emits "op reg, rm" (register direct form) */
+
+static void
+emit_rr( fd_vm_jit_asm_t * a,
+         int               w,
+         uint              op,
+         uint              reg,
+         uint              rm ) {
+  emit_rex( a, w, reg, 0U, rm );
+  emit_op ( a, op );
+  emit_u8 ( a, 0xc0U | ((reg&7U)<<3) | (rm&7U) );
+}
+
+/* emit_mem emits "op reg, [base+disp32]" */
+
+static void
+emit_mem( fd_vm_jit_asm_t * a,
+          int               w,
+          uint              op,
+          uint              reg,
+          uint              base,
+          int               disp ) {
+  emit_rex( a, w, reg, 0U, base );
+  emit_op ( a, op );
+  emit_u8 ( a, 0x80U | ((reg&7U)<<3) | (base&7U) );
+  if( (base&7U)==RSP ) emit_u8( a, 0x24U );
+  emit_u32( a, (uint)disp );
+}
+
+/* emit_sib emits "op reg, [base+index*(1<<lg_scale)+disp32]" */
+
+static void
+emit_sib( fd_vm_jit_asm_t * a,
+          int               w,
+          uint              op,
+          uint              reg,
+          uint              base,
+          uint              index,
+          uint              lg_scale,
+          int               disp ) {
+  emit_rex( a, w, reg, index, base );
+  emit_op ( a, op );
+  emit_u8 ( a, 0x84U | ((reg&7U)<<3) );
+  emit_u8 ( a, (lg_scale<<6) | ((index&7U)<<3) | (base&7U) );
+  emit_u32( a, (uint)disp );
+}
+
+/* emit_ind emits "op reg, [base]" (base must not be rsp, rbp, r12 or
+   r13) */
+
+static void
+emit_ind( fd_vm_jit_asm_t * a,
+          int               w,
+          uint              op,
+          uint              reg,
+          uint              base ) {
+  emit_rex( a, w, reg, 0U, base );
+  emit_op ( a, op );
+  emit_u8 ( a, ((reg&7U)<<3) | (base&7U) );
+}
+
+/* emit_ri emits the group 1 ALU op "digit rm, imm32" (add 0, or 1,
+   and 4, sub 5, xor 6, cmp 7).  For 64-bit ops, imm is sign extended. */
+
+static void
+emit_ri( fd_vm_jit_asm_t * a,
+         int               w,
+         uint              digit,
+         uint              rm,
+         uint              imm ) {
+  emit_rr ( a, w, 0x81U, digit, rm );
+  emit_u32( a, imm );
+}
+
+/* emit_sh emits the group 2 shift "digit rm, imm8" (rol 0, shl 4,
+   shr 5, sar 7) */
+
+static void
+emit_sh( fd_vm_jit_asm_t * a,
+         int               w,
+         uint              digit,
+         uint              rm,
+         uint              imm ) {
+  emit_rr( a, w, 0xc1U, digit, rm );
+  emit_u8( a, imm );
+}
+
+/* emit_mov_ri emits the shortest of "mov r32, imm32" (zero extends),
+   "mov r64, simm32" and "mov r64, imm64" that loads imm into reg */
+
+static void
+emit_mov_ri( fd_vm_jit_asm_t * a,
+             uint              reg,
+             ulong             imm ) {
+  if( imm<=(ulong)UINT_MAX ) {
+    emit_rex( a, 0, 0U, 0U, reg );
+    emit_u8 ( a, 0xb8U | (reg&7U) );
+    emit_u32( a, (uint)imm );
+  } else if( (long)imm==(long)(int)(uint)imm ) {
+    emit_rr ( a, 1, 0xc7U, 0U, reg );
+    emit_u32( a, (uint)imm );
+  } else {
+    emit_rex( a, 1, 0U, 0U, reg );
+    emit_u8 ( a, 0xb8U | (reg&7U) );
+    emit_u64( a, imm );
+  }
+}
+
+/* emit_{ld,st}_reg load sBPF register r into host register reg / store
+   host register reg into sBPF register r */
+
+static inline void emit_ld_reg( fd_vm_jit_asm_t * a, uint reg, ulong r ) { emit_mem( a, 1, 0x8bU, reg, R12, REG_OFF( r ) ); }
+static inline void emit_st_reg( fd_vm_jit_asm_t * a, ulong r, uint reg ) { emit_mem( a, 1, 0x89U, reg, R12, REG_OFF( r ) ); }
+
+/* emit_jcc / emit_jmp emit a rel32 conditional / unconditional jump and
+   return the offset of the rel32 field for use with emit_patch. */
+
+static ulong
+emit_jcc( fd_vm_jit_asm_t * a,
+          uint              cc ) {
+  emit_u8( a, 0x0fU );
+  emit_u8( a, 0x80U | cc );
+  ulong at = a->off;
+  emit_u32( a, 0U );
+  return at;
+}
+
+static ulong
+emit_jmp( fd_vm_jit_asm_t * a ) {
+  emit_u8( a, 0xe9U );
+  ulong at = a->off;
+  emit_u32( a, 0U );
+  return at;
+}
+
+static inline void
+emit_patch( fd_vm_jit_asm_t * a,
+            ulong             at,
+            ulong             target ) {
+  if( a->code ) FD_STORE( uint, a->code + at, (uint)( target - (at+4UL) ) );
+}
+
+static inline void
+emit_jcc_to( fd_vm_jit_asm_t * a,
+             uint              cc,
+             ulong             target ) {
+  emit_patch( a, emit_jcc( a, cc ), target );
+}
+
+static inline void
+emit_jmp_to( fd_vm_jit_asm_t * a,
+             ulong             target ) {
+  emit_patch( a, emit_jmp( a ), target );
+}
+
+static void
+emit_call( fd_vm_jit_asm_t * a,
+           ulong             fn ) {
+  emit_mov_ri( a, RAX, fn );
+  emit_rr    ( a, 0, 0xffU, 2U, RAX ); /* call rax */
+}
+
+/* Compiler ***********************************************************/
+
+/* fd_vm_jit_op returns the interpreter label (as an opcode, with 0x100
+   set for the "depr" variants) that executes opcode for the given sBPF
+   version or -1 if opcode is illegal.  This mirrors
+   fd_vm_interp_jump_table.c. */
+
+#define DEPR(op) (0x100|(op))
+
+static int
+fd_vm_jit_op( ulong opcode,
+              ulong v ) {
+  int mmic = FD_VM_SBPF_MOVE_MEMORY_IX_CLASSES( v );
+  int pqr  = FD_VM_SBPF_ENABLE_PQR            ( v );
+  int op   = (int)opcode;
+  switch( opcode ) {
+  case 0x05: case 0x07: case 0x0f: case 0x15: case 0x1d: case 0x1f: case 0x25: case 0x2d:
+  case 0x35: case 0x3d: case 0x44: case 0x45: case 0x47: case 0x4c: case 0x4d: case 0x4f:
+  case 0x54: case 0x55: case 0x57: case 0x5c: case 0x5d: case 0x5f: case 0x64: case 0x65:
+  case 0x67: case 0x6c: case 0x6d: case 0x6f: case 0x74: case 0x75: case 0x77: case 0x7c:
+  case 0x7d: case 0x7f: case 0xa4: case 0xa5: case 0xa7: case 0xac: case 0xad: case 0xaf:
+  case 0xb4: case 0xb5: case 0xb7: case 0xbd: case 0xbf: case 0xc4: case 0xc5: case 0xc7:
+  case 0xcc: case 0xcd: case 0xcf: case 0xd5: case 0xdc: case 0xdd:
+    return op;
+
+  case 0x18: return FD_VM_SBPF_ENABLE_LDDW( v ) ? op : -1;
+  case 0xf7: return FD_VM_SBPF_ENABLE_LDDW( v ) ? -1 : op;
+  case 0xd4: return FD_VM_SBPF_ENABLE_LE  ( v ) ? op : -1;
+
+  case 0x61: return mmic ? -1 : 0x8c;
+  case 0x62: return mmic ? -1 : 0x87;
+  case 0x63: return mmic ? -1 : 0x8f;
+  case 0x69: return mmic ? -1 : 0x3c;
+  case 0x6a: return mmic ? -1 : 0x37;
+  case 0x6b: return mmic ? -1 : 0x3f;
+  case 0x71: return mmic ? -1 : 0x2c;
+  case 0x72: return mmic ? -1 : 0x27;
+  case 0x73: return mmic ? -1 : 0x2f;
+  case 0x79: return mmic ? -1 : 0x9c;
+  case 0x7a: return mmic ? -1 : 0x97;
+  case 0x7b: return mmic ? -1 : 0x9f;
+  case 0x8c: case 0x8f:
+    return mmic ? op : -1;
+  case 0x87: case 0x3c: case 0x37: case 0x3f: case 0x2c: case 0x27: case 0x2f: case 0x9c: case 0x97: case 0x9f:
+    return mmic ? op : DEPR( op );
+
+  case 0x36: case 0x3e: case 0x46: case 0x4e: case 0x56: case 0x5e: case 0x66: case 0x6e:
+  case 0x76: case 0x7e: case 0x86: case 0x8e: case 0x96: case 0x9e: case 0xb6: case 0xbe:
+  case 0xc6: case 0xce: case 0xd6: case 0xde: case 0xe6: case 0xee: case 0xf6: case 0xfe:
+    return pqr ? op : -1;
+  case 0x24: case 0x34: case 0x94:
+    return pqr ? -1 : op;
+
+  case 0x84: return FD_VM_SBPF_ENABLE_NEG( v ) ? op : -1;
+
+  case 0x04: case 0x0c: case 0x1c: case 0xbc:
+    return FD_VM_SBPF_EXPLICIT_SIGN_EXT( v ) ? op : DEPR( op );
+  case 0x14: case 0x17:
+    return FD_VM_SBPF_SWAP_SUB_REG_IMM_OPERANDS( v ) ? op : DEPR( op );
+
+  case 0x85: return FD_VM_SBPF_STATIC_SYSCALLS( v ) ? op   : DEPR( op );
+  case 0x95: return FD_VM_SBPF_STATIC_SYSCALLS( v ) ? op   : 0x9d;
+  case 0x9d: return FD_VM_SBPF_STATIC_SYSCALLS( v ) ? op   : -1;
+  case 0x8d: return FD_VM_SBPF_STATIC_SYSCALLS( v ) ? op   : DEPR( op );
+
+  default: return -1;
+  }
+}
+
+/* fd_vm_jit_ctx_t holds the state of a compilation pass */
+
+struct fd_vm_jit_ctx {
+  fd_vm_jit_asm_t hot[1];   /* straight line code, one block per text word in text order */
+  fd_vm_jit_asm_t cold[1];  /* out of line fault stubs and slow paths */
+
+  ulong const * text;
+  ulong         text_cnt;
+  ulong         sbpf_version;
+  uint const *  idx;        /* indexed [0,text_cnt] */
+  uint *        jtab;       /* indexed [0,text_cnt), offset of each text word's code from code start (or FD_VM_JIT_SHADOW) */
+
+  /* Offsets of the common stubs from code start */
+
+  ulong epilogue;
+  ulong fault;              /* rcx=pc, r8=idx, r9d=err */
+  ulong segv;               /* rcx=pc, r8=idx */
+  ulong dispatch;           /* rax=pc, vm->ic and vm->cu current */
+  ulong shadow;
+  ulong branch_ret;
+  ulong entry;
+};
+
+typedef struct fd_vm_jit_ctx fd_vm_jit_ctx_t;
+
+/* emit_fault emits code that halts the vm with a fault err at pc (idx
+   is the idx of the instruction faulting) */
+
+static void
+emit_fault( fd_vm_jit_ctx_t * ctx,
+            fd_vm_jit_asm_t * a,
+            ulong             pc,
+            ulong             idx,
+            int               err ) {
+  emit_mov_ri( a, RCX, pc  );
+  emit_mov_ri( a, R8,  idx );
+  emit_mov_ri( a, R9,  (ulong)(uint)err );
+  emit_jmp_to( a, ctx->fault );
+}
+
+/* emit_fault_if emits a conditional jump taken on cc to an out of line
+   fault err at pc */
+
+static void
+emit_fault_if( fd_vm_jit_ctx_t * ctx,
+               uint              cc,
+               ulong             pc,
+               ulong             idx,
+               int               err ) {
+  emit_jcc_to( ctx->hot, cc, ctx->cold->off );
+  emit_fault( ctx, ctx->cold, pc, idx, err );
+}
+
+static void
+emit_stubs( fd_vm_jit_ctx_t *   ctx,
+            fd_vm_jit_t const * jit ) {
+  fd_vm_jit_asm_t * a = ctx->hot;
+
+  /* Epilogue (eax holds the return value) */
+
+  ctx->epilogue = a->off;
+  emit_ri( a, 1, 0U, RSP, 8U ); /* add rsp, 8 */
+  emit_u8( a, 0x41U ); emit_u8( a, 0x5fU ); /* pop r15 */
+  emit_u8( a, 0x41U ); emit_u8( a, 0x5eU ); /* pop r14 */
+  emit_u8( a, 0x41U ); emit_u8( a, 0x5dU ); /* pop r13 */
+  emit_u8( a, 0x41U ); emit_u8( a, 0x5cU ); /* pop r12 */
+  emit_u8( a, 0x5bU );                      /* pop rbx */
+  emit_u8( a, 0x5dU );                      /* pop rbp */
+  emit_u8( a, 0xc3U );                      /* ret */
+
+  /* Faults */
+
+  ctx->fault = a->off;
+  emit_rr  ( a, 1, 0x89U, R12, RDI );
+  emit_rr  ( a, 1, 0x89U, R13, RSI );
+  emit_rr  ( a, 1, 0x89U, R14, RDX );
+  emit_call( a, (ulong)fd_vm_jit_fault );
+  emit_jmp_to( a, ctx->epilogue );
+
+  ctx->segv = a->off;
+  emit_rr  ( a, 1, 0x89U, R12, RDI );
+  emit_rr  ( a, 1, 0x89U, R13, RSI );
+  emit_rr  ( a, 1, 0x89U, R14, RDX );
+  emit_call( a, (ulong)fd_vm_jit_sigsegv );
+  emit_jmp_to( a, ctx->epilogue );
+
+  /* Dispatch (resume execution at pc rax) */
+
+  ctx->dispatch = a->off;
+  emit_ri ( a, 1, 7U, RAX, (uint)ctx->text_cnt );                           /* cmp rax, text_cnt */
+  ulong sigtext = emit_jcc( a, CC_AE );
+  emit_sib( a, 0, 0x8bU, RDX, R15, RAX, 2U, (int)jit->idx_off );            /* mov edx, idx[rax] */
+  emit_mem( a, 1, 0x8bU, R13, R12, VM_OFF( cu ) );                          /* M = cu + idx */
+  emit_rr ( a, 1, 0x01U, RDX, R13 );
+  emit_mem( a, 1, 0x8bU, R14, R12, VM_OFF( ic ) );                          /* K = ic - idx */
+  emit_rr ( a, 1, 0x29U, RDX, R14 );
+  emit_sib( a, 0, 0x8bU, RCX, R15, RAX, 2U, (int)jit->jtab_off );           /* mov ecx, jtab[rax] */
+  emit_rr ( a, 1, 0x01U, R15, RCX );                                        /* add rcx, r15 */
+  emit_rr ( a, 0, 0xffU, 4U, RCX );                                         /* jmp rcx */
+  emit_patch( a, sigtext, a->off );
+  emit_rr    ( a, 1, 0x89U, RAX, RCX );                                     /* pc */
+  emit_mem   ( a, 1, 0x8bU, R13, R12, VM_OFF( cu ) );
+  emit_mem   ( a, 1, 0x8bU, R14, R12, VM_OFF( ic ) );
+  emit_rr    ( a, 0, 0x31U, R8, R8 );                                       /* idx 0 */
+  emit_mov_ri( a, R9, (ulong)(uint)FD_VM_ERR_EBPF_EXECUTION_OVERRUN );
+  emit_jmp_to( a, ctx->fault );
+
+  /* Second word of an LDQ (reached only by dispatch, rax=pc, rdx=idx) */
+
+  ctx->shadow = a->off;
+  emit_rr    ( a, 1, 0x89U, RAX, RCX );
+  emit_rr    ( a, 1, 0x89U, RDX, R8  );
+  emit_mov_ri( a, R9, (ulong)(uint)FD_VM_ERR_EBPF_UNSUPPORTED_INSTRUCTION );
+  emit_jmp_to( a, ctx->fault );
+
+  /* Return from a branch helper */
+
+  ctx->branch_ret = a->off;
+  emit_ri    ( a, 0, 7U, RAX, (uint)FD_VM_JIT_CONTINUE );
+  emit_jcc_to( a, CC_NE, ctx->epilogue );
+  emit_mem   ( a, 1, 0x8bU, RAX, R12, VM_OFF( pc ) );
+  emit_jmp_to( a, ctx->dispatch );
+
+  /* Prologue (entry point, rdi=vm, rsi=jit) */
+
+  ctx->entry = a->off;
+  emit_u8( a, 0x55U );                      /* push rbp */
+  emit_u8( a, 0x53U );                      /* push rbx */
+  emit_u8( a, 0x41U ); emit_u8( a, 0x54U ); /* push r12 */
+  emit_u8( a, 0x41U ); emit_u8( a, 0x55U ); /* push r13 */
+  emit_u8( a, 0x41U ); emit_u8( a, 0x56U ); /* push r14 */
+  emit_u8( a, 0x41U ); emit_u8( a, 0x57U ); /* push r15 */
+  emit_ri( a, 1, 5U, RSP, 8U );             /* sub rsp, 8 (16 byte align calls) */
+  emit_rr( a, 1, 0x89U, RDI, R12 );
+  emit_rr( a, 1, 0x89U, RSI, R15 );
+  emit_mem( a, 1, 0x8bU, RAX, R12, VM_OFF( pc ) );
+  emit_jmp_to( a, ctx->dispatch );
+}
+
+/* emit_cost emits the block accounting check of a branch at pc (the
+   FD_VM_INTERP_BRANCH_BEGIN SIGCOST) */
+
+static void
+emit_cost( fd_vm_jit_ctx_t * ctx,
+           ulong             pc ) {
+  ulong i = ctx->idx[ pc ];
+  emit_ri( ctx->hot, 1, 7U, R13, (uint)(i+1UL) ); /* cmp M, idx+1 */
+  emit_fault_if( ctx, CC_B, pc, i, FD_VM_ERR_EBPF_EXCEEDED_MAX_INSTRUCTIONS );
+}
+
+/* emit_goto emits a jump from the branch at pc (already billed) to
+   target. */
+
+static void
+emit_goto( fd_vm_jit_ctx_t * ctx,
+           ulong             pc,
+           ulong             target ) {
+  fd_vm_jit_asm_t * a = ctx->hot;
+
+  int   ok = (target<ctx->text_cnt) && (ctx->jtab[ target ]!=FD_VM_JIT_SHADOW);
+  ulong it = target<ctx->text_cnt ? (ulong)ctx->idx[ target ] : 0UL;
+  long  d  = (long)it - (long)ctx->idx[ pc ] - 1L;
+  if( d ) {
+    emit_ri( a, 1, 0U, R13, (uint)(int)d ); /* add M, d */
+    emit_ri( a, 1, 5U, R14, (uint)(int)d ); /* sub K, d */
+  }
+  if( FD_LIKELY( ok ) ) emit_jmp_to( a, ctx->jtab[ target ] );
+  else                  emit_fault ( ctx, a, target, it, target<ctx->text_cnt ? FD_VM_ERR_EBPF_UNSUPPORTED_INSTRUCTION
+                                                                                : FD_VM_ERR_EBPF_EXECUTION_OVERRUN );
+}
+
+static void
+emit_jcond( fd_vm_jit_ctx_t * ctx,
+            ulong             pc,
+            ulong             instr,
+            uint              cc,
+            int               is_test ) {
+  fd_vm_jit_asm_t * a = ctx->hot;
+
+  emit_cost( ctx, pc );
+  emit_ld_reg( a, RAX, fd_vm_instr_dst( instr ) );
+  if( instr & 0x08UL ) { /* register source */
+    emit_ld_reg( a, RCX, fd_vm_instr_src( instr ) );
+    emit_rr( a, 1, is_test ? 0x85U : 0x39U, RCX, RAX );
+  } else if( is_test ) {
+    emit_rr ( a, 1, 0xf7U, 0U, RAX );
+    emit_u32( a, fd_vm_instr_imm( instr ) );
+  } else {
+    emit_ri( a, 1, 7U, RAX, fd_vm_instr_imm( instr ) );
+  }
+
+  ulong target = pc + 1UL + fd_vm_instr_offset( instr );
+  int   ok     = (target<ctx->text_cnt) && (ctx->jtab[ target ]!=FD_VM_JIT_SHADOW);
+  if( ok && ((ulong)ctx->idx[ target ]==(ulong)ctx->idx[ pc ]+1UL) ) {
+    emit_jcc_to( a, cc, ctx->jtab[ target ] );
+  } else {
+    ulong skip = emit_jcc( a, cc^1U );
+    emit_goto( ctx, pc, target );
+    emit_patch( a, skip, a->off );
+  }
+}
+
+static void
+emit_branch_helper( fd_vm_jit_ctx_t *     ctx,
+                    ulong                 pc,
+                    ulong                 instr,
+                    fd_vm_jit_branch_fn_t fn ) {
+  fd_vm_jit_asm_t * a = ctx->hot;
+  ulong             n = (ulong)ctx->idx[ pc ] + 1UL;
+
+  emit_cost( ctx, pc );
+  emit_mem ( a, 1, 0x8dU, RAX, R14, (int)n );                 /* vm->ic = K + idx + 1 */
+  emit_mem ( a, 1, 0x89U, RAX, R12, VM_OFF( ic ) );
+  emit_mem ( a, 1, 0x8dU, RAX, R13, -(int)n );                /* vm->cu = M - idx - 1 */
+  emit_mem ( a, 1, 0x89U, RAX, R12, VM_OFF( cu ) );
+  emit_rr  ( a, 1, 0x89U, R12, RDI );
+  emit_mov_ri( a, RSI, pc    );
+  emit_mov_ri( a, RDX, instr );
+  emit_call( a, (ulong)fn );
+  emit_jmp_to( a, ctx->branch_ret );
+}
+
+/* emit_haddr emits the translation of the sz byte access at
+   reg[r]+offset into a host address in rcx (the FD_VM_INTERP
+   fd_vm_mem_haddr + sigsegv sequence).  On return, the hot cursor is
+   at the point where the access should be done. */
+
+static void
+emit_haddr( fd_vm_jit_ctx_t * ctx,
+            ulong             pc,
+            ulong             r,
+            ulong             offset,
+            ulong             sz,
+            int               write ) {
+  fd_vm_jit_asm_t * a = ctx->hot;
+  fd_vm_jit_asm_t * c = ctx->cold;
+  ulong             i = ctx->idx[ pc ];
+
+  emit_ld_reg( a, RAX, r );
+  if( offset ) emit_ri( a, 1, 0U, RAX, (uint)offset ); /* rax = vaddr */
+  emit_rr( a, 1, 0x89U, RAX, RDX );
+  emit_sh( a, 1, 5U, RDX, 32U );                       /* rdx = region */
+  emit_ri( a, 1, 7U, RDX, 3U );
+  ulong slow = emit_jcc( a, CC_A );                    /* input and unmapped hi regions are out of line */
+  emit_rr( a, 0, 0x89U, RAX, RCX );                    /* ecx = offset */
+
+  ulong segv[2];
+  ulong segv_cnt = 0UL;
+
+  if( !fd_sbpf_dynamic_stack_frames_enabled( ctx->sbpf_version ) ) {
+    /* Stack frame gaps (see fd_vm_mem_haddr) */
+    emit_ri( a, 0, 7U, RDX, (uint)FD_VM_STACK_REGION );
+    ulong nonstack = emit_jcc( a, CC_NE );
+    emit_rr ( a, 0, 0xf7U, 0U, RAX ); emit_u32( a, 0x1000U );   /* test eax, 0x1000 */
+    segv[ segv_cnt++ ] = emit_jcc( a, CC_NE );
+    emit_rr( a, 0, 0x89U, RCX, R8 );
+    emit_sh( a, 0, 5U, R8, 1U );
+    emit_ri( a, 0, 4U, R8,  0x7ffff800U );
+    emit_ri( a, 0, 4U, RCX, 0x00000fffU );
+    emit_rr( a, 0, 0x09U, R8, RCX );
+    emit_patch( a, nonstack, a->off );
+  }
+
+  emit_sib( a, 0, 0x8bU, R8, R12, RDX, 2U, write ? VM_OFF( region_st_sz ) : VM_OFF( region_ld_sz ) );
+  emit_mem( a, 1, 0x8dU, R9, RCX, (int)sz );             /* lea r9, [rcx+sz] */
+  emit_rr ( a, 1, 0x39U, R8, R9 );                       /* cmp r9, r8 */
+  segv[ segv_cnt++ ] = emit_jcc( a, CC_A );
+  emit_sib( a, 1, 0x03U, RCX, R12, RDX, 3U, VM_OFF( region_haddr ) ); /* add rcx, region_haddr[ region ] */
+  ulong resume = a->off;
+
+  /* Slow path */
+
+  emit_patch( a, slow, c->off );
+  emit_rr    ( c, 1, 0x89U, RAX, RBX );
+  emit_rr    ( c, 1, 0x89U, R12, RDI );
+  emit_rr    ( c, 1, 0x89U, RAX, RSI );
+  emit_mov_ri( c, RDX, sz );
+  emit_mov_ri( c, RCX, (ulong)!!write );
+  emit_call  ( c, (ulong)fd_vm_jit_haddr );
+  emit_rr    ( c, 1, 0x89U, RAX, RCX );
+  emit_rr    ( c, 1, 0x89U, RBX, RAX );
+  emit_rr    ( c, 1, 0x85U, RCX, RCX );
+  ulong slow_segv = emit_jcc( c, CC_E );
+  emit_jmp_to( c, resume );
+
+  /* Fault (rax holds vaddr) */
+
+  for( ulong j=0UL; j<segv_cnt; j++ ) emit_patch( a, segv[ j ], c->off );
+  emit_patch( c, slow_segv, c->off );
+  emit_mem   ( c, 1, 0x89U, RAX, R12, VM_OFF( segv_vaddr ) );
+  emit_mem   ( c, 0, 0xc6U, 0U,  R12, VM_OFF( segv_access_type ) );
+  emit_u8    ( c, write ? FD_VM_ACCESS_TYPE_ST : FD_VM_ACCESS_TYPE_LD );
+  emit_mem   ( c, 1, 0xc7U, 0U,  R12, VM_OFF( segv_access_len ) );
+  emit_u32   ( c, (uint)sz );
+  emit_mov_ri( c, RCX, pc );
+  emit_mov_ri( c, R8,  i  );
+  emit_jmp_to( c, ctx->segv );
+}
+
+static void
+emit_load( fd_vm_jit_ctx_t * ctx,
+           ulong             pc,
+           ulong             instr,
+           ulong             sz ) {
+  fd_vm_jit_asm_t * a = ctx->hot;
+  emit_haddr( ctx, pc, fd_vm_instr_src( instr ), fd_vm_instr_offset( instr ), sz, 0 );
+  switch( sz ) {
+  case 1UL: emit_ind( a, 0, 0x0fb6U, RAX, RCX ); break; /* movzx eax, byte [rcx] */
+  case 2UL: emit_ind( a, 0, 0x0fb7U, RAX, RCX ); break; /* movzx eax, word [rcx] */
+  case 4UL: emit_ind( a, 0, 0x8bU,   RAX, RCX ); break; /* mov eax, [rcx] */
+  default:  emit_ind( a, 1, 0x8bU,   RAX, RCX ); break; /* mov rax, [rcx] */
+  }
+  emit_st_reg( a, fd_vm_instr_dst( instr ), RAX );
+}
+
+static void
+emit_store( fd_vm_jit_ctx_t * ctx,
+            ulong             pc,
+            ulong             instr,
+            ulong             sz,
+            int               is_reg ) {
+  fd_vm_jit_asm_t * a   = ctx->hot;
+  uint              imm = fd_vm_instr_imm( instr );
+  emit_haddr( ctx, pc, fd_vm_instr_dst( instr ), fd_vm_instr_offset( instr ), sz, 1 );
+  if( is_reg ) {
+    emit_ld_reg( a, RAX, fd_vm_instr_src( instr ) );
+    switch( sz ) {
+    case 1UL:                   emit_ind( a, 0, 0x88U, RAX, RCX ); break; /* mov [rcx], al */
+    case 2UL: emit_u8( a, 0x66U ); emit_ind( a, 0, 0x89U, RAX, RCX ); break; /* mov [rcx], ax */
+    case 4UL:                   emit_ind( a, 0, 0x89U, RAX, RCX ); break; /* mov [rcx], eax */
+    default:                    emit_ind( a, 1, 0x89U, RAX, RCX ); break; /* mov [rcx], rax */
+    }
+  } else {
+    switch( sz ) {
+    case 1UL:                   emit_ind( a, 0, 0xc6U, 0U, RCX ); emit_u8 ( a, imm & 0xffU ); break;
+    case 2UL: emit_u8( a, 0x66U ); emit_ind( a, 0, 0xc7U, 0U, RCX ); emit_u8( a, imm & 0xffU ); emit_u8( a, (imm>>8) & 0xffU ); break;
+    case 4UL:                   emit_ind( a, 0, 0xc7U, 0U, RCX ); emit_u32( a, imm ); break;
+    default:                    emit_ind( a, 1, 0xc7U, 0U, RCX ); emit_u32( a, imm ); break; /* sign extended */
+    }
+  }
+}
+
+/* emit_div emits an unsigned (is_signed==0) or signed division of rax
+   (eax if !w) by rcx (ecx if !w).  src_zero / src_neg1 indicate whether
+   the divisor could be zero / -1 (these fault as in the interpreter).
+   The quotient is left in rax and remainder in rdx. */
+
+static void
+emit_div( fd_vm_jit_ctx_t * ctx,
+          ulong             pc,
+          int               w,
+          int               is_signed,
+          int               src_zero,
+          int               src_neg1 ) {
+  fd_vm_jit_asm_t * a = ctx->hot;
+  ulong             i = ctx->idx[ pc ];
+  if( src_zero ) {
+    emit_rr( a, w, 0x85U, RCX, RCX );
+    emit_fault_if( ctx, CC_E, pc, i, FD_VM_ERR_EBPF_DIVIDE_BY_ZERO );
+  }
+  if( is_signed ) {
+    if( src_neg1 ) {
+      ulong skip = 0UL;
+      int   imm  = (src_neg1==2); /* divisor is known to be -1 */
+      if( !imm ) {
+        emit_ri( a, w, 7U, RCX, UINT_MAX );
+        skip = emit_jcc( a, CC_NE );
+      }
+      if( w ) {
+        emit_mov_ri( a, RDX, (ulong)LONG_MIN );
+        emit_rr    ( a, 1, 0x39U, RDX, RAX );
+      } else {
+        emit_ri( a, 0, 7U, RAX, 0x80000000U );
+      }
+      emit_fault_if( ctx, CC_E, pc, i, FD_VM_ERR_EBPF_DIVIDE_OVERFLOW );
+      if( !imm ) emit_patch( a, skip, a->off );
+    }
+    if( w ) emit_u8( a, 0x48U );
+    emit_u8( a, 0x99U );                 /* cdq / cqo */
+    emit_rr( a, w, 0xf7U, 7U, RCX );     /* idiv */
+  } else {
+    emit_rr( a, 0, 0x31U, RDX, RDX );
+    emit_rr( a, w, 0xf7U, 6U, RCX );     /* div */
+  }
+}
+
+/* emit_instr emits the code for the instruction at pc and returns the
+   number of text words it occupies (or 0 if the instruction cannot be
+   compiled). */
+
+static ulong
+emit_instr( fd_vm_jit_ctx_t * ctx,
+            ulong             pc ) {
+  fd_vm_jit_asm_t * a     = ctx->hot;
+  ulong             instr = ctx->text[ pc ];
+  ulong             dst   = fd_vm_instr_dst( instr );
+  ulong             src   = fd_vm_instr_src( instr );
+  uint              imm   = fd_vm_instr_imm( instr );
+  int               op    = fd_vm_jit_op( fd_vm_instr_opcode( instr ), ctx->sbpf_version );
+
+  /* Common operand loading */
+
+# define LD_DST    emit_ld_reg( a, RAX, dst )
+# define LD_SRC    emit_ld_reg( a, RCX, src )
+# define ST_DST    emit_st_reg( a, dst, RAX )
+# define ST_DST_RDX emit_st_reg( a, dst, RDX )
+# define MOVSXD    emit_rr( a, 1, 0x63U, RAX, RAX )      /* movsxd rax, eax */
+# define ZEXT32    emit_rr( a, 0, 0x89U, RAX, RAX )      /* mov eax, eax */
+# define ALU_RI(w,digit) do { LD_DST; emit_ri( a, (w), (digit), RAX, imm ); } while(0)
+# define ALU_RR(w,op)    do { LD_DST; LD_SRC; emit_rr( a, (w), (op), RCX, RAX ); } while(0)
+
+  switch( op ) {
+
+  /* Branches */
+
+  case 0x05:  emit_cost( ctx, pc ); emit_goto( ctx, pc, pc + 1UL + fd_vm_instr_offset( instr ) ); break;
+  case 0x15: case 0x1d: emit_jcond( ctx, pc, instr, CC_E,  0 ); break;
+  case 0x25: case 0x2d: emit_jcond( ctx, pc, instr, CC_A,  0 ); break;
+  case 0x35: case 0x3d: emit_jcond( ctx, pc, instr, CC_AE, 0 ); break;
+  case 0x45: case 0x4d: emit_jcond( ctx, pc, instr, CC_NE, 1 ); break;
+  case 0x55: case 0x5d: emit_jcond( ctx, pc, instr, CC_NE, 0 ); break;
+  case 0x65: case 0x6d: emit_jcond( ctx, pc, instr, CC_G,  0 ); break;
+  case 0x75: case 0x7d: emit_jcond( ctx, pc, instr, CC_GE, 0 ); break;
+  case 0xa5: case 0xad: emit_jcond( ctx, pc, instr, CC_B,  0 ); break;
+  case 0xb5: case 0xbd: emit_jcond( ctx, pc, instr, CC_BE, 0 ); break;
+  case 0xc5: case 0xcd: emit_jcond( ctx, pc, instr, CC_L,  0 ); break;
+  case 0xd5: case 0xdd: emit_jcond( ctx, pc, instr, CC_LE, 0 ); break;
+
+  case 0x85:       emit_branch_helper( ctx, pc, instr, fd_vm_jit_call_imm      ); break;
+  case DEPR(0x85): emit_branch_helper( ctx, pc, instr, fd_vm_jit_call_imm_depr ); break;
+  case 0x8d:       emit_branch_helper( ctx, pc, instr, fd_vm_jit_call_reg      ); break;
+  case DEPR(0x8d): emit_branch_helper( ctx, pc, instr, fd_vm_jit_call_reg_depr ); break;
+  case 0x95:       emit_branch_helper( ctx, pc, instr, fd_vm_jit_syscall       ); break;
+  case 0x9d:       emit_branch_helper( ctx, pc, instr, fd_vm_jit_exit          ); break;
+
+  /* Loads and stores */
+
+  case 0x2c: emit_load ( ctx, pc, instr, 1UL    ); break;
+  case 0x3c: emit_load ( ctx, pc, instr, 2UL    ); break;
+  case 0x8c: emit_load ( ctx, pc, instr, 4UL    ); break;
+  case 0x9c: emit_load ( ctx, pc, instr, 8UL    ); break;
+  case 0x27: emit_store( ctx, pc, instr, 1UL, 0 ); break;
+  case 0x37: emit_store( ctx, pc, instr, 2UL, 0 ); break;
+  case 0x87: emit_store( ctx, pc, instr, 4UL, 0 ); break;
+  case 0x97: emit_store( ctx, pc, instr, 8UL, 0 ); break;
+  case 0x2f: emit_store( ctx, pc, instr, 1UL, 1 ); break;
+  case 0x3f: emit_store( ctx, pc, instr, 2UL, 1 ); break;
+  case 0x8f: emit_store( ctx, pc, instr, 4UL, 1 ); break;
+  case 0x9f: emit_store( ctx, pc, instr, 8UL, 1 ); break;
+
+  case 0x18: /* LDQ */
+    if( FD_UNLIKELY( pc+1UL>=ctx->text_cnt ) ) return 0UL;
+    emit_mov_ri( a, RAX, (ulong)imm | ((ulong)fd_vm_instr_imm( ctx->text[ pc+1UL ] ) << 32) );
+    ST_DST;
+    return 2UL;
+
+  /* 32-bit ALU */
+
+  case 0x04:       ALU_RI( 0, 0U );                                          ST_DST; break;
+  case DEPR(0x04): ALU_RI( 0, 0U ); MOVSXD;                                  ST_DST; break;
+  case 0x0c:       ALU_RR( 0, 0x01U );                                       ST_DST; break;
+  case DEPR(0x0c): ALU_RR( 0, 0x01U ); MOVSXD;                               ST_DST; break;
+  case 0x14:       LD_DST; emit_rr( a, 0, 0xf7U, 3U, RAX ); emit_ri( a, 0, 0U, RAX, imm ); ST_DST; break;
+  case DEPR(0x14): ALU_RI( 0, 5U ); MOVSXD;                                  ST_DST; break;
+  case 0x1c:       ALU_RR( 0, 0x29U );                                       ST_DST; break;
+  case DEPR(0x1c): ALU_RR( 0, 0x29U ); MOVSXD;                               ST_DST; break;
+  case 0x24:       LD_DST; emit_rr( a, 0, 0x69U, RAX, RAX ); emit_u32( a, imm ); MOVSXD; ST_DST; break;
+  case DEPR(0x2c): LD_DST; LD_SRC; emit_rr( a, 0, 0x0fafU, RAX, RCX ); MOVSXD; ST_DST; break;
+  case 0x44:       ALU_RI( 0, 1U );                                          ST_DST; break;
+  case 0x4c:       ALU_RR( 0, 0x09U );                                       ST_DST; break;
+  case 0x54:       ALU_RI( 0, 4U );                                          ST_DST; break;
+  case 0x5c:       ALU_RR( 0, 0x21U );                                       ST_DST; break;
+  case 0x64:       LD_DST; emit_sh( a, 0, 4U, RAX, imm & 31U ); ZEXT32;      ST_DST; break;
+  case 0x6c:       LD_DST; LD_SRC; emit_rr( a, 0, 0xd3U, 4U, RAX ); ZEXT32;  ST_DST; break;
+  case 0x74:       LD_DST; emit_sh( a, 0, 5U, RAX, imm & 31U ); ZEXT32;      ST_DST; break;
+  case 0x7c:       LD_DST; LD_SRC; emit_rr( a, 0, 0xd3U, 5U, RAX ); ZEXT32;  ST_DST; break;
+  case 0x84:       LD_DST; emit_rr( a, 0, 0xf7U, 3U, RAX );                  ST_DST; break;
+  case 0x86:       LD_DST; emit_rr( a, 0, 0x69U, RAX, RAX ); emit_u32( a, imm ); ST_DST; break;
+  case 0x8e:       LD_DST; LD_SRC; emit_rr( a, 0, 0x0fafU, RAX, RCX );       ST_DST; break;
+  case 0xa4:       ALU_RI( 0, 6U );                                          ST_DST; break;
+  case 0xac:       ALU_RR( 0, 0x31U );                                       ST_DST; break;
+  case 0xb4:       emit_mov_ri( a, RAX, (ulong)imm );                        ST_DST; break;
+  case 0xbc:       LD_SRC; emit_rr( a, 1, 0x63U, RAX, RCX );                 ST_DST; break;
+  case DEPR(0xbc): LD_SRC; emit_rr( a, 0, 0x89U, RCX, RAX );                 ST_DST; break;
+  case 0xc4:       LD_DST; emit_sh( a, 0, 7U, RAX, imm & 31U ); ZEXT32;      ST_DST; break;
+  case 0xcc:       LD_DST; LD_SRC; emit_rr( a, 0, 0xd3U, 7U, RAX ); ZEXT32;  ST_DST; break;
+
+  /* 64-bit ALU */
+
+  case 0x07:       ALU_RI( 1, 0U );                                          ST_DST; break;
+  case 0x0f:       ALU_RR( 1, 0x01U );                                       ST_DST; break;
+  case 0x17:       LD_DST; emit_rr( a, 1, 0xf7U, 3U, RAX ); emit_ri( a, 1, 0U, RAX, imm ); ST_DST; break;
+  case DEPR(0x17): ALU_RI( 1, 5U );                                          ST_DST; break;
+  case 0x1f:       ALU_RR( 1, 0x29U );                                       ST_DST; break;
+  case DEPR(0x27): LD_DST; emit_rr( a, 1, 0x69U, RAX, RAX ); emit_u32( a, imm ); ST_DST; break;
+  case DEPR(0x2f): LD_DST; LD_SRC; emit_rr( a, 1, 0x0fafU, RAX, RCX );       ST_DST; break;
+  case 0x47:       ALU_RI( 1, 1U );                                          ST_DST; break;
+  case 0x4f:       ALU_RR( 1, 0x09U );                                       ST_DST; break;
+  case 0x57:       ALU_RI( 1, 4U );                                          ST_DST; break;
+  case 0x5f:       ALU_RR( 1, 0x21U );                                       ST_DST; break;
+  case 0x67:       LD_DST; emit_sh( a, 1, 4U, RAX, imm & 63U );              ST_DST; break;
+  case 0x6f:       LD_DST; LD_SRC; emit_rr( a, 1, 0xd3U, 4U, RAX );          ST_DST; break;
+  case 0x77:       LD_DST; emit_sh( a, 1, 5U, RAX, imm & 63U );              ST_DST; break;
+  case 0x7f:       LD_DST; LD_SRC; emit_rr( a, 1, 0xd3U, 5U, RAX );          ST_DST; break;
+  case DEPR(0x87): LD_DST; emit_rr( a, 1, 0xf7U, 3U, RAX );                  ST_DST; break;
+  case 0x96:       LD_DST; emit_rr( a, 1, 0x69U, RAX, RAX ); emit_u32( a, imm ); ST_DST; break;
+  case 0x9e:       LD_DST; LD_SRC; emit_rr( a, 1, 0x0fafU, RAX, RCX );       ST_DST; break;
+  case 0xa7:       ALU_RI( 1, 6U );                                          ST_DST; break;
+  case 0xaf:       ALU_RR( 1, 0x31U );                                       ST_DST; break;
+  case 0xb7:       emit_mov_ri( a, RAX, (ulong)(long)(int)imm );             ST_DST; break;
+  case 0xbf:       emit_ld_reg( a, RAX, src );                               ST_DST; break;
+  case 0xc7:       LD_DST; emit_sh( a, 1, 7U, RAX, imm & 63U );              ST_DST; break;
+  case 0xcf:       LD_DST; LD_SRC; emit_rr( a, 1, 0xd3U, 7U, RAX );          ST_DST; break;
+  case 0xf7:       LD_DST; emit_mov_ri( a, RCX, ((ulong)imm)<<32 ); emit_rr( a, 1, 0x09U, RCX, RAX ); ST_DST; break;
+
+  /* High multiplies */
+
+  case 0x36: LD_DST; emit_mov_ri( a, RCX, (ulong)imm );           emit_rr( a, 1, 0xf7U, 4U, RCX ); ST_DST_RDX; break;
+  case 0x3e: LD_DST; LD_SRC;                                       emit_rr( a, 1, 0xf7U, 4U, RCX ); ST_DST_RDX; break;
+  case 0xb6: LD_DST; emit_mov_ri( a, RCX, (ulong)(long)(int)imm ); emit_rr( a, 1, 0xf7U, 5U, RCX ); ST_DST_RDX; break;
+  case 0xbe: LD_DST; LD_SRC;                                       emit_rr( a, 1, 0xf7U, 5U, RCX ); ST_DST_RDX; break;
+
+  /* Divides.  Immediate divisors were validated to be non-zero. */
+
+  case 0x34: case 0x46: /* DIV_IMM, UDIV32_IMM */
+  case 0x66: case 0x94: /* UREM32_IMM, MOD_IMM */
+    if( FD_UNLIKELY( !imm ) ) return 0UL;
+    LD_DST; emit_mov_ri( a, RCX, (ulong)imm ); emit_div( ctx, pc, 0, 0, 0, 0 );
+    if( op==0x66 || op==0x94 ) emit_rr( a, 0, 0x89U, RDX, RAX );
+    ST_DST;
+    break;
+  case DEPR(0x3c): case 0x4e: /* DIV_REG, UDIV32_REG */
+  case DEPR(0x9c): case 0x6e: /* MOD_REG, UREM32_REG */
+    LD_DST; LD_SRC; emit_div( ctx, pc, 0, 0, 1, 0 );
+    if( op==DEPR(0x9c) || op==0x6e ) emit_rr( a, 0, 0x89U, RDX, RAX );
+    ST_DST;
+    break;
+  case 0x56: case 0x76: /* UDIV64_IMM, UREM64_IMM */
+    if( FD_UNLIKELY( !imm ) ) return 0UL;
+    LD_DST; emit_mov_ri( a, RCX, (ulong)imm ); emit_div( ctx, pc, 1, 0, 0, 0 );
+    if( op==0x56 ) ST_DST; else ST_DST_RDX;
+    break;
+  case DEPR(0x37): case DEPR(0x97): /* DIV64_IMM, MOD64_IMM (imm sign extended) */
+    if( FD_UNLIKELY( !imm ) ) return 0UL;
+    LD_DST; emit_mov_ri( a, RCX, (ulong)(long)(int)imm ); emit_div( ctx, pc, 1, 0, 0, 0 );
+    if( op==DEPR(0x37) ) ST_DST; else ST_DST_RDX;
+    break;
+  case DEPR(0x3f): case 0x5e: case DEPR(0x9f): case 0x7e: /* DIV64_REG, UDIV64_REG, MOD64_REG, UREM64_REG */
+    LD_DST; LD_SRC; emit_div( ctx, pc, 1, 0, 1, 0 );
+    if( op==DEPR(0x3f) || op==0x5e ) ST_DST; else ST_DST_RDX;
+    break;
+  case 0xc6: case 0xe6: /* SDIV32_IMM, SREM32_IMM */
+    if( FD_UNLIKELY( !imm ) ) return 0UL;
+    LD_DST; emit_mov_ri( a, RCX, (ulong)imm ); emit_div( ctx, pc, 0, 1, 0, imm==UINT_MAX ? 2 : 0 );
+    if( op==0xe6 ) emit_rr( a, 0, 0x89U, RDX, RAX ); else ZEXT32;
+    ST_DST;
+    break;
+  case 0xce: case 0xee: /* SDIV32_REG, SREM32_REG */
+    LD_DST; LD_SRC; emit_div( ctx, pc, 0, 1, 1, 1 );
+    if( op==0xee ) emit_rr( a, 0, 0x89U, RDX, RAX ); else ZEXT32;
+    ST_DST;
+    break;
+  case 0xd6: case 0xf6: /* SDIV64_IMM, SREM64_IMM */
+    if( FD_UNLIKELY( !imm ) ) return 0UL;
+    LD_DST; emit_mov_ri( a, RCX, (ulong)(long)(int)imm ); emit_div( ctx, pc, 1, 1, 0, imm==UINT_MAX ? 2 : 0 );
+    if( op==0xd6 ) ST_DST; else ST_DST_RDX;
+    break;
+  case 0xde: case 0xfe: /* SDIV64_REG, SREM64_REG */
+    LD_DST; LD_SRC; emit_div( ctx, pc, 1, 1, 1, 1 );
+    if( op==0xde ) ST_DST; else ST_DST_RDX;
+    break;
+
+  /* Byte swaps.  Invalid widths were rejected by validation (the
+     interpreter would halt with SIGINV without billing). */
+
+  case 0xd4: /* END_LE */
+    switch( imm ) {
+    case 16U: LD_DST; emit_rr( a, 0, 0x0fb7U, RAX, RAX ); ST_DST; break;
+    case 32U: LD_DST; ZEXT32;                             ST_DST; break;
+    case 64U:                                                     break;
+    default:  return 0UL;
+    }
+    break;
+  case 0xdc: /* END_BE */
+    switch( imm ) {
+    case 16U: LD_DST; emit_u8( a, 0x66U ); emit_sh( a, 0, 0U, RAX, 8U ); emit_rr( a, 0, 0x0fb7U, RAX, RAX ); ST_DST; break;
+    case 32U: LD_DST; emit_u8( a, 0x0fU ); emit_u8( a, 0xc8U );                    ST_DST; break;
+    case 64U: LD_DST; emit_u8( a, 0x48U ); emit_u8( a, 0x0fU ); emit_u8( a, 0xc8U ); ST_DST; break;
+    default:  return 0UL;
+    }
+    break;
+
+  /* Illegal instructions (e.g. the second word of an LDQ reached by
+     falling through, which validation prevents) */
+
+  default:
+    emit_fault( ctx, a, pc, ctx->idx[ pc ], FD_VM_ERR_EBPF_UNSUPPORTED_INSTRUCTION );
+    break;
+  }
+
+# undef ALU_RR
+# undef ALU_RI
+# undef ZEXT32
+# undef MOVSXD
+# undef ST_DST_RDX
+# undef ST_DST
+# undef LD_SRC
+# undef LD_DST
+
+  return 1UL;
+}
+
+/* fd_vm_jit_pass runs a compilation pass.  Returns 1 on success and 0
+   if the program cannot be compiled. */
+
+static int
+fd_vm_jit_pass( fd_vm_jit_ctx_t *   ctx,
+                fd_vm_jit_t const * jit ) {
+  emit_stubs( ctx, jit );
+
+  ulong text_cnt = ctx->text_cnt;
+  for( ulong pc=0UL; pc<text_cnt; ) {
+    ctx->jtab[ pc ] = (uint)ctx->hot->off;
+    ulong word_cnt = emit_instr( ctx, pc );
+    if( FD_UNLIKELY( !word_cnt ) ) return 0;
+    pc += word_cnt;
+  }
+
+  /* Falling through the end of text */
+
+  emit_fault( ctx, ctx->hot, text_cnt, ctx->idx[ text_cnt ], FD_VM_ERR_EBPF_EXECUTION_OVERRUN );
+  return 1;
+}
+
+FD_FN_CONST ulong
+fd_vm_jit_footprint( ulong text_cnt ) {
+  if( FD_UNLIKELY( (!text_cnt) | (text_cnt>FD_VM_JIT_TEXT_MAX) ) ) return 0UL;
+  ulong code_off = fd_ulong_align_up( sizeof(fd_vm_jit_t) + 4UL*(text_cnt+1UL) + 4UL*text_cnt, FD_VM_JIT_ALIGN );
+  return fd_ulong_align_up( code_off + FD_VM_JIT_STUB_CODE_MAX + FD_VM_JIT_WORD_CODE_MAX*(text_cnt+1UL), FD_VM_JIT_ALIGN );
+}
+
+fd_vm_jit_t *
+fd_vm_jit_compile( void *          mem,
+                   ulong           mem_sz,
+                   fd_vm_t const * vm,
+                   ulong *         _sz ) {
+  if( _sz ) *_sz = 0UL;
+
+  if( FD_UNLIKELY( (!mem) | (!vm) ) ) return NULL;
+  if( FD_UNLIKELY( !fd_ulong_is_aligned( (ulong)mem, FD_VM_JIT_ALIGN ) ) ) return NULL;
+
+  ulong text_cnt     = vm->text_cnt;
+  ulong sbpf_version = vm->sbpf_version;
+  ulong footprint    = fd_vm_jit_footprint( text_cnt );
+  if( FD_UNLIKELY( !footprint || !vm->text || sbpf_version>FD_SBPF_V3 ) ) return NULL;
+  if( FD_UNLIKELY( fd_vm_validate( vm )!=FD_VM_SUCCESS ) ) return NULL;
+
+  /* Layout the tables */
+
+  ulong idx_off  = fd_ulong_align_up( sizeof(fd_vm_jit_t), 4UL );
+  ulong jtab_off = idx_off + 4UL*(text_cnt+1UL);
+  ulong code_off = fd_ulong_align_up( jtab_off + 4UL*text_cnt, FD_VM_JIT_ALIGN );
+  if( FD_UNLIKELY( mem_sz<code_off ) ) {
+    if( _sz ) *_sz = footprint;
+    return NULL;
+  }
+
+  fd_vm_jit_t * jit  = (fd_vm_jit_t *)mem;
+  uint *        idx  = (uint *)( (ulong)mem + idx_off  );
+  uint *        jtab = (uint *)( (ulong)mem + jtab_off );
+
+  jit->magic        = 0UL; /* not valid until compiled */
+  jit->sbpf_version = sbpf_version;
+  jit->text_cnt     = text_cnt;
+  jit->idx_off      = idx_off;
+  jit->jtab_off     = jtab_off;
+  jit->code_off     = code_off;
+
+  /* Compute idx and mark the second words of LDQs */
+
+  ulong const * text   = vm->text;
+  int           lddw   = FD_VM_SBPF_ENABLE_LDDW( sbpf_version );
+  ulong         icnt   = 0UL;
+  for( ulong pc=0UL; pc<text_cnt; pc++ ) {
+    idx [ pc ] = (uint)icnt;
+    jtab[ pc ] = 0U;
+    if( lddw && fd_vm_instr_opcode( text[ pc ] )==0x18UL && pc+1UL<text_cnt ) {
+      pc++;
+      idx [ pc ] = (uint)(icnt+1UL);
+      jtab[ pc ] = FD_VM_JIT_SHADOW;
+    }
+    icnt++;
+  }
+  idx[ text_cnt ] = (uint)icnt;
+
+  /* Sizing pass (also computes the hot code offset of each word) */
+
+  fd_vm_jit_ctx_t ctx[1] = {{
+    .hot          = {{ .code = NULL, .off = 0UL }},
+    .cold         = {{ .code = NULL, .off = 0UL }},
+    .text         = text,
+    .text_cnt     = text_cnt,
+    .sbpf_version = sbpf_version,
+    .idx          = idx,
+    .jtab         = jtab
+  }};
+  if( FD_UNLIKELY( !fd_vm_jit_pass( ctx, jit ) ) ) return NULL;
+
+  ulong hot_sz  = ctx->hot ->off;
+  ulong cold_sz = ctx->cold->off;
+  ulong code_sz = hot_sz + cold_sz;
+  if( FD_UNLIKELY( code_off+code_sz > footprint ) ) FD_LOG_CRIT(( "jit code size bound exceeded" ));
+
+  ulong sz = fd_ulong_align_up( code_off + code_sz, FD_VM_JIT_ALIGN );
+  if( FD_UNLIKELY( sz>mem_sz ) ) {
+    if( _sz ) *_sz = sz;
+    return NULL;
+  }
+
+  /* Emitting pass */
+
+  uchar * code = (uchar *)( (ulong)mem + code_off );
+  ctx->hot [0] = (fd_vm_jit_asm_t){ .code = code, .off = 0UL    };
+  ctx->cold[0] = (fd_vm_jit_asm_t){ .code = code, .off = hot_sz };
+  fd_vm_jit_pass( ctx, jit );
+  if( FD_UNLIKELY( (ctx->hot->off!=hot_sz) | (ctx->cold->off!=code_sz) ) ) FD_LOG_CRIT(( "jit passes disagree" ));
+  fd_memset( code + code_sz, 0xcc, sz - code_off - code_sz ); /* int3 padding */
+
+  /* Convert the jump table to offsets from jit */
+
+  for( ulong pc=0UL; pc<text_cnt; pc++ ) {
+    jtab[ pc ] = (uint)( code_off + ( jtab[ pc ]==FD_VM_JIT_SHADOW ? ctx->shadow : (ulong)jtab[ pc ] ) );
+  }
+
+  jit->code_sz   = code_sz;
+  jit->entry_off = code_off + ctx->entry;
+  FD_COMPILER_MFENCE();
+  jit->magic     = FD_VM_JIT_MAGIC;
+
+  if( _sz ) *_sz = sz;
+  return jit;
+}
+
+int
+fd_vm_jit_exec( fd_vm_jit_t const * jit,
+                fd_vm_t *           vm ) {
+  if( FD_UNLIKELY( (!jit) | (!vm) ) ) return FD_VM_ERR_INVAL;
+  if( FD_UNLIKELY( (jit->magic       !=FD_VM_JIT_MAGIC ) |
+                   (jit->text_cnt    !=vm->text_cnt    ) |
+                   (jit->sbpf_version!=vm->sbpf_version) ) ) return FD_VM_ERR_INVAL;
+
+  fd_vm_jit_entry_fn_t entry;
+  ulong                entry_addr = (ulong)jit + jit->entry_off;
+  memcpy( &entry, &entry_addr, sizeof(fd_vm_jit_entry_fn_t) );
+  return entry( vm, jit );
+}
+
+#endif /* FD_HAS_X86 */
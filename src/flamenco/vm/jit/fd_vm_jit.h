@@ -0,0 +1,113 @@
+#ifndef HEADER_fd_src_flamenco_vm_jit_fd_vm_jit_h
+#define HEADER_fd_src_flamenco_vm_jit_fd_vm_jit_h
+
+/* fd_vm_jit compiles a validated sBPF program into x86-64 machine
+   code.  Compiled code is a drop-in replacement for
+   fd_vm_exec_notrace: given a vm set up for execution, it runs the
+   program from vm->pc until it halts or faults and leaves vm (pc, ic,
+   cu, frame_cnt, registers, shadow stack, memory and segv info) in
+   exactly the same state the interpreter would have.
+
+   Compute units are billed with the same block accounting model as the
+   interpreter (see fd_vm_interp_core.c).  Instead of tracking pc0 and
+   ic_correction, the compiled code keeps two running values in host
+   registers:
+
+     M = cu + idx(pc0)
+     K = ic - idx(pc0)
+
+   where idx(p) is the number of instructions (an LDQ counts as one)
+   that precede text word p.  Because idx is known at compile time for
+   every instruction, a branch at p bills its linear segment with a
+   single compare (M >= idx(p)+1, else SIGCOST) and a taken branch to t
+   just adds idx(t)-idx(p)-1 to M and subtracts it from K.  A fault at p
+   recovers ic = K+idx(p)+1 and cu = M-idx(p)-1 (saturated as in
+   FD_VM_INTERP_FAULT).
+
+   Memory accesses to the program, stack and heap regions are translated
+   inline against vm's region tables (including the v0 stack gaps).
+   Accesses to the input region (which may be fragmented and resizable)
+   and out of range regions go through fd_vm_mem_haddr.  Calls, exits
+   and syscalls go through small C helpers that mirror the interpreter
+   and then resume through a pc -> native code dispatch table.
+
+   sBPF registers live in vm->reg (they are not pinned to host
+   registers) such that syscalls and faults see them without any
+   spilling.
+
+   The compiled code is position independent (code and tables are
+   addressed relative to the start of the fd_vm_jit_t) such that it can
+   be written through a writable mapping of memory and executed through
+   a different executable mapping of the same memory (see
+   fd_vm_jit_cache.h). */
+
+#include "../fd_vm.h"
+
+#if FD_HAS_X86
+
+/* FD_VM_JIT_ALIGN gives the alignment of a region suitable for holding
+   compiled code. */
+
+#define FD_VM_JIT_ALIGN (64UL)
+
+/* FD_VM_JIT_TEXT_MAX gives the largest program (in text words) that
+   can be compiled. */
+
+#define FD_VM_JIT_TEXT_MAX (1UL<<26)
+
+struct fd_vm_jit;
+typedef struct fd_vm_jit fd_vm_jit_t;
+
+FD_PROTOTYPES_BEGIN
+
+/* fd_vm_jit_footprint returns an upper bound on the number of bytes
+   needed to compile a program with text_cnt text words.  Returns 0 if
+   text_cnt is not in [1,FD_VM_JIT_TEXT_MAX]. */
+
+FD_FN_CONST ulong
+fd_vm_jit_footprint( ulong text_cnt );
+
+/* fd_vm_jit_compile compiles the program attached to vm (text,
+   text_cnt and sbpf_version, the program is validated with
+   fd_vm_validate using vm's syscalls) into the mem_sz byte region
+   pointed to by mem (FD_VM_JIT_ALIGN aligned).  On success, returns mem
+   as a fd_vm_jit_t and, if _sz is non-NULL, *_sz holds the number of
+   bytes of mem used (a multiple of FD_VM_JIT_ALIGN).  On failure,
+   returns NULL and, if _sz is non-NULL, *_sz holds the number of bytes
+   needed if the failure was because mem_sz was too small and 0
+   otherwise.  Reasons for failure include the program failing
+   validation, the program being too large, an sBPF version the
+   interpreter does not implement (newer than v3) and mem_sz being too
+   small
+   (these are not logged, as the caller is expected to fall back to the
+   interpreter).
+
+   The returned fd_vm_jit_t is not executable until mem is made
+   executable (e.g. by mprotect or by executing through an alternate
+   executable mapping of mem).  The compiled code does not depend on the
+   address it is executed from nor on any vm fields other than text,
+   text_cnt and sbpf_version.  In particular, it can be run on vm's that
+   have different memory, syscalls, calldests and entry_pc. */
+
+fd_vm_jit_t *
+fd_vm_jit_compile( void *          mem,
+                   ulong           mem_sz,
+                   fd_vm_t const * vm,
+                   ulong *         _sz );
+
+/* fd_vm_jit_exec runs vm with the compiled program jit (the address of
+   the executable mapping of the compiled program).  vm should be set up
+   as for fd_vm_exec_notrace (the trace, if any, is ignored).  Returns
+   the same values as fd_vm_exec_notrace.  Returns FD_VM_ERR_INVAL if
+   jit is NULL or was not compiled for vm's text_cnt and sbpf_version
+   (vm is not modified in this case). */
+
+int
+fd_vm_jit_exec( fd_vm_jit_t const * jit,
+                fd_vm_t *           vm );
+
+FD_PROTOTYPES_END
+
+#endif /* FD_HAS_X86 */
+
+#endif /* HEADER_fd_src_flamenco_vm_jit_fd_vm_jit_h */
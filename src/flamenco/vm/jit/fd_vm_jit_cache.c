@@ -0,0 +1,248 @@
+#define _GNU_SOURCE
+#include "fd_vm_jit_cache.h"
+
+#if FD_HAS_X86
+
+#include <errno.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+static inline fd_vm_jit_cache_ent_t *
+fd_vm_jit_cache_ent( fd_vm_jit_cache_t * cache ) {
+  return (fd_vm_jit_cache_ent_t *)( cache+1 );
+}
+
+int
+fd_vm_jit_cache_code_map( ulong    code_max,
+                          uchar ** _code_rw,
+                          uchar ** _code_rx ) {
+  if( FD_UNLIKELY( (!code_max) | (!fd_ulong_is_aligned( code_max, FD_SHMEM_NORMAL_PAGE_SZ )) ) ) {
+    FD_LOG_WARNING(( "invalid code_max %lu", code_max ));
+    return EINVAL;
+  }
+
+  int fd = memfd_create( "fd_vm_jit", MFD_CLOEXEC );
+  if( FD_UNLIKELY( fd<0 ) ) {
+    FD_LOG_WARNING(( "memfd_create(fd_vm_jit) failed (%i-%s)", errno, fd_io_strerror( errno ) ));
+    return errno;
+  }
+
+  int err = 0;
+  if( FD_UNLIKELY( ftruncate( fd, (off_t)code_max ) ) ) {
+    err = errno;
+    FD_LOG_WARNING(( "ftruncate(fd_vm_jit,%lu KiB) failed (%i-%s)", code_max>>10, err, fd_io_strerror( err ) ));
+    goto done;
+  }
+
+  void * rw = mmap( NULL, code_max, PROT_READ|PROT_WRITE, MAP_SHARED, fd, (off_t)0 );
+  if( FD_UNLIKELY( rw==MAP_FAILED ) ) {
+    err = errno;
+    FD_LOG_WARNING(( "mmap(NULL,%lu KiB,PROT_READ|PROT_WRITE,MAP_SHARED,fd_vm_jit,0) failed (%i-%s)", code_max>>10, err, fd_io_strerror( err ) ));
+    goto done;
+  }
+
+  void * rx = mmap( NULL, code_max, PROT_READ|PROT_EXEC, MAP_SHARED, fd, (off_t)0 );
+  if( FD_UNLIKELY( rx==MAP_FAILED ) ) {
+    err = errno;
+    FD_LOG_WARNING(( "mmap(NULL,%lu KiB,PROT_READ|PROT_EXEC,MAP_SHARED,fd_vm_jit,0) failed (%i-%s)", code_max>>10, err, fd_io_strerror( err ) ));
+    if( FD_UNLIKELY( munmap( rw, code_max ) ) ) FD_LOG_WARNING(( "munmap failed (%i-%s)", errno, fd_io_strerror( errno ) ));
+    goto done;
+  }
+
+  *_code_rw = rw;
+  *_code_rx = rx;
+
+done:
+  if( FD_UNLIKELY( close( fd ) ) ) FD_LOG_WARNING(( "close(fd_vm_jit) failed (%i-%s)", errno, fd_io_strerror( errno ) ));
+  return err;
+}
+
+void
+fd_vm_jit_cache_code_unmap( uchar * code_rw,
+                            uchar * code_rx,
+                            ulong   code_max ) {
+  if( FD_UNLIKELY( code_rw && munmap( code_rw, code_max ) ) ) FD_LOG_WARNING(( "munmap failed (%i-%s)", errno, fd_io_strerror( errno ) ));
+  if( FD_UNLIKELY( code_rx && munmap( code_rx, code_max ) ) ) FD_LOG_WARNING(( "munmap failed (%i-%s)", errno, fd_io_strerror( errno ) ));
+}
+
+void *
+fd_vm_jit_cache_new( void *  shmem,
+                     ulong   ent_max,
+                     uchar * code_rw,
+                     uchar * code_rx,
+                     ulong   code_max ) {
+
+  if( FD_UNLIKELY( !shmem ) ) {
+    FD_LOG_WARNING(( "NULL shmem" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !fd_ulong_is_aligned( (ulong)shmem, fd_vm_jit_cache_align() ) ) ) {
+    FD_LOG_WARNING(( "misaligned shmem" ));
+    return NULL;
+  }
+
+  ulong footprint = fd_vm_jit_cache_footprint( ent_max );
+  if( FD_UNLIKELY( !footprint ) ) {
+    FD_LOG_WARNING(( "bad ent_max" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( (!code_rw) | (!code_rx) ) ) {
+    FD_LOG_WARNING(( "NULL code arena" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( (!fd_ulong_is_aligned( (ulong)code_rw, FD_VM_JIT_ALIGN )) |
+                   (!fd_ulong_is_aligned( (ulong)code_rx, FD_VM_JIT_ALIGN )) |
+                   (!fd_ulong_is_aligned( code_max,       FD_VM_JIT_ALIGN )) ) ) {
+    FD_LOG_WARNING(( "misaligned code arena" ));
+    return NULL;
+  }
+
+  fd_memset( shmem, 0, footprint );
+
+  fd_vm_jit_cache_t * cache = shmem;
+  cache->ent_max  = ent_max;
+  cache->code_rw  = code_rw;
+  cache->code_rx  = code_rx;
+  cache->code_max = code_max;
+
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( cache->magic ) = FD_VM_JIT_CACHE_MAGIC;
+  FD_COMPILER_MFENCE();
+
+  return shmem;
+}
+
+fd_vm_jit_cache_t *
+fd_vm_jit_cache_join( void * shcache ) {
+
+  if( FD_UNLIKELY( !shcache ) ) {
+    FD_LOG_WARNING(( "NULL shcache" ));
+    return NULL;
+  }
+
+  fd_vm_jit_cache_t * cache = shcache;
+  if( FD_UNLIKELY( cache->magic!=FD_VM_JIT_CACHE_MAGIC ) ) {
+    FD_LOG_WARNING(( "bad magic" ));
+    return NULL;
+  }
+
+  return cache;
+}
+
+void *
+fd_vm_jit_cache_leave( fd_vm_jit_cache_t * cache ) {
+
+  if( FD_UNLIKELY( !cache ) ) {
+    FD_LOG_WARNING(( "NULL cache" ));
+    return NULL;
+  }
+
+  return (void *)cache;
+}
+
+void *
+fd_vm_jit_cache_delete( void * shcache ) {
+
+  if( FD_UNLIKELY( !shcache ) ) {
+    FD_LOG_WARNING(( "NULL shcache" ));
+    return NULL;
+  }
+
+  fd_vm_jit_cache_t * cache = shcache;
+  if( FD_UNLIKELY( cache->magic!=FD_VM_JIT_CACHE_MAGIC ) ) {
+    FD_LOG_WARNING(( "bad magic" ));
+    return NULL;
+  }
+
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( cache->magic ) = 0UL;
+  FD_COMPILER_MFENCE();
+
+  return shcache;
+}
+
+void
+fd_vm_jit_cache_flush( fd_vm_jit_cache_t * cache ) {
+  if( FD_UNLIKELY( cache->exec_depth ) ) FD_LOG_CRIT(( "attempted to flush jit cache while running compiled code" ));
+  fd_memset( fd_vm_jit_cache_ent( cache ), 0, cache->ent_max*sizeof(fd_vm_jit_cache_ent_t) );
+  cache->code_used = 0UL;
+  cache->metrics->flush_cnt++;
+}
+
+/* fd_vm_jit_cache_compile compiles the program attached to vm into
+   the arena.  Returns the arena offset of the compiled program on
+   success, ULONG_MAX if the program cannot be compiled and ULONG_MAX-1
+   if the program could not be compiled due to lack of arena space. */
+
+static ulong
+fd_vm_jit_cache_compile( fd_vm_jit_cache_t * cache,
+                         fd_vm_t const *     vm ) {
+  for(;;) {
+    ulong off = cache->code_used;
+    ulong sz  = 0UL;
+    if( FD_LIKELY( fd_vm_jit_compile( cache->code_rw + off, cache->code_max - off, vm, &sz ) ) ) {
+      cache->code_used = off + sz;
+      cache->metrics->compile_cnt++;
+      cache->metrics->compile_tot_sz += sz;
+      return off;
+    }
+
+    if( !sz ) return ULONG_MAX; /* not compilable */
+
+    /* Out of space.  Reclaim the arena if possible and retry. */
+
+    if( FD_UNLIKELY( (!off) | (!!cache->exec_depth) | (sz>cache->code_max) ) ) return ULONG_MAX-1UL;
+    fd_vm_jit_cache_flush( cache );
+  }
+}
+
+int
+fd_vm_jit_cache_exec( fd_vm_jit_cache_t * cache,
+                      ulong               tag,
+                      fd_vm_t *           vm ) {
+
+  if( FD_UNLIKELY( (!cache) | (!tag) | (!!vm->trace) ) ) return fd_vm_exec( vm );
+
+  fd_vm_jit_cache_ent_t * ent = fd_vm_jit_cache_ent( cache ) + ( fd_ulong_hash( tag ) & (cache->ent_max-1UL) );
+
+  ulong off;
+  if( FD_LIKELY( (ent->tag==tag) & (ent->text==vm->text) & (ent->text_cnt==vm->text_cnt) ) ) {
+    off = ent->off;
+    if( FD_LIKELY( off!=ULONG_MAX ) ) cache->metrics->hit_cnt++;
+  } else {
+    off = fd_vm_jit_cache_compile( cache, vm );
+    if( FD_UNLIKELY( off==ULONG_MAX-1UL ) ) { /* Try again later */
+      cache->metrics->interp_cnt++;
+      return fd_vm_exec( vm );
+    }
+    /* Note: a flush in compile might have cleared ent */
+    if( FD_UNLIKELY( off==ULONG_MAX ) ) cache->metrics->compile_fail_cnt++;
+    ent->tag      = tag;
+    ent->off      = off;
+    ent->text     = vm->text;
+    ent->text_cnt = vm->text_cnt;
+  }
+
+  if( FD_UNLIKELY( off==ULONG_MAX ) ) {
+    cache->metrics->interp_cnt++;
+    return fd_vm_exec( vm );
+  }
+
+  cache->exec_depth++;
+  int err = fd_vm_jit_exec( (fd_vm_jit_t const *)( cache->code_rx + off ), vm );
+  cache->exec_depth--;
+
+  /* Same tag and text run with a different sbpf version (caller error) */
+
+  if( FD_UNLIKELY( err==FD_VM_ERR_INVAL ) ) {
+    cache->metrics->interp_cnt++;
+    return fd_vm_exec( vm );
+  }
+
+  return err;
+}
+
+#endif /* FD_HAS_X86 */
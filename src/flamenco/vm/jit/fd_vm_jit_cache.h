@@ -0,0 +1,157 @@
+#ifndef HEADER_fd_src_flamenco_vm_jit_fd_vm_jit_cache_h
+#define HEADER_fd_src_flamenco_vm_jit_fd_vm_jit_cache_h
+
+/* fd_vm_jit_cache is a tile local cache of compiled sBPF programs.
+
+   Programs are identified by a caller provided non-zero 64-bit tag
+   (e.g. the jit_tag of a program cache record, which changes whenever
+   the program is reloaded).  The first time a tag is executed, the
+   program attached to the vm is compiled into the cache's code arena.
+   Subsequent executions of the same tag with the same text (address
+   and length) run the compiled code.  A tag hit with a different text
+   (e.g. a stale tag) is treated as a miss and the program is compiled
+   again.  Programs that cannot be compiled are remembered as such and
+   run on the interpreter.
+
+   The code arena is a region of memory mapped twice: once writable
+   (for the compiler) and once executable (for running), such that no
+   mapping is ever both writable and executable.  The arena is a bump
+   allocator.  When it fills up, the cache is flushed (all compiled
+   programs are discarded).  Since a program can invoke other programs
+   (CPI), the cache is never flushed while compiled code is running;
+   programs that do not fit in this case run on the interpreter.
+
+   The cache lookup table is direct mapped.  A tag colliding with
+   another evicts it from the table (the code of the evicted program
+   stays in the arena until the next flush, such that it is safe to
+   evict a program that is currently running).
+
+   A fd_vm_jit_cache is not thread safe and should only be used by the
+   thread that created it. */
+
+#include "fd_vm_jit.h"
+
+#if FD_HAS_X86
+
+#define FD_VM_JIT_CACHE_ALIGN (64UL)
+#define FD_VM_JIT_CACHE_MAGIC (0xF17EDA2CE7CAC4E0UL) /* FIREDANCER JIT CACHE V0 */
+
+struct fd_vm_jit_cache_metrics {
+  ulong hit_cnt;          /* number of executions of previously compiled programs */
+  ulong compile_cnt;      /* number of programs compiled */
+  ulong compile_fail_cnt; /* number of programs that could not be compiled */
+  ulong compile_tot_sz;   /* cumulative size of compiled code in bytes */
+  ulong flush_cnt;        /* number of times the code arena was flushed */
+  ulong interp_cnt;       /* number of executions that fell back to the interpreter */
+};
+
+typedef struct fd_vm_jit_cache_metrics fd_vm_jit_cache_metrics_t;
+
+struct fd_vm_jit_cache_ent {
+  ulong         tag;      /* 0 if free */
+  ulong         off;      /* byte offset of the compiled program in the arena, ULONG_MAX if the program cannot be compiled */
+  ulong const * text;     /* text the program was compiled from */
+  ulong         text_cnt;
+};
+
+typedef struct fd_vm_jit_cache_ent fd_vm_jit_cache_ent_t;
+
+struct __attribute__((aligned(FD_VM_JIT_CACHE_ALIGN))) fd_vm_jit_cache {
+  ulong   magic;      /* ==FD_VM_JIT_CACHE_MAGIC */
+  ulong   ent_max;    /* power of 2 */
+  uchar * code_rw;    /* writable mapping of the code arena */
+  uchar * code_rx;    /* executable mapping of the code arena */
+  ulong   code_max;   /* arena size in bytes */
+  ulong   code_used;  /* bytes of arena in use */
+  ulong   exec_depth; /* number of compiled programs currently running */
+
+  fd_vm_jit_cache_metrics_t metrics[1];
+
+  /* ent_max fd_vm_jit_cache_ent_t follow */
+};
+
+typedef struct fd_vm_jit_cache fd_vm_jit_cache_t;
+
+FD_PROTOTYPES_BEGIN
+
+FD_FN_CONST static inline ulong
+fd_vm_jit_cache_align( void ) {
+  return FD_VM_JIT_CACHE_ALIGN;
+}
+
+/* fd_vm_jit_cache_footprint returns the footprint of a jit cache with
+   a lookup table of ent_max entries.  Returns 0 if ent_max is not a
+   power of 2.  The footprint does not include the code arena. */
+
+FD_FN_CONST static inline ulong
+fd_vm_jit_cache_footprint( ulong ent_max ) {
+  if( FD_UNLIKELY( (!ent_max) | (!fd_ulong_is_pow2( ent_max )) | (ent_max>(1UL<<32)) ) ) return 0UL;
+  return fd_ulong_align_up( sizeof(fd_vm_jit_cache_t) + ent_max*sizeof(fd_vm_jit_cache_ent_t), FD_VM_JIT_CACHE_ALIGN );
+}
+
+/* fd_vm_jit_cache_code_map creates a code arena of code_max bytes
+   (a multiple of the page size).  On success, returns 0 and sets
+   *_code_rw / *_code_rx to the writable / executable mappings of the
+   arena.  On failure, logs details and returns an errno compatible
+   error code.  This uses syscalls (memfd_create and mmap) and is
+   typically called during privileged tile initialization. */
+
+int
+fd_vm_jit_cache_code_map( ulong    code_max,
+                          uchar ** _code_rw,
+                          uchar ** _code_rx );
+
+/* fd_vm_jit_cache_code_unmap unmaps a code arena created with
+   fd_vm_jit_cache_code_map. */
+
+void
+fd_vm_jit_cache_code_unmap( uchar * code_rw,
+                            uchar * code_rx,
+                            ulong   code_max );
+
+/* fd_vm_jit_cache_new formats the memory region shmem (matching
+   fd_vm_jit_cache_{align,footprint}(ent_max)) as a jit cache using the
+   code arena [code_rw,code_rw+code_max) (executable at code_rx, see
+   fd_vm_jit_cache_code_map).  Returns shmem on success and NULL on
+   failure (logs details).  The caller retains ownership of the arena. */
+
+void *
+fd_vm_jit_cache_new( void *  shmem,
+                     ulong   ent_max,
+                     uchar * code_rw,
+                     uchar * code_rx,
+                     ulong   code_max );
+
+fd_vm_jit_cache_t *
+fd_vm_jit_cache_join( void * shcache );
+
+void *
+fd_vm_jit_cache_leave( fd_vm_jit_cache_t * cache );
+
+void *
+fd_vm_jit_cache_delete( void * shcache );
+
+/* fd_vm_jit_cache_flush discards all compiled programs.  Must not be
+   called while compiled code is running. */
+
+void
+fd_vm_jit_cache_flush( fd_vm_jit_cache_t * cache );
+
+/* fd_vm_jit_cache_exec is a drop-in replacement for fd_vm_exec that
+   runs vm with the compiled version of the program identified by tag
+   (compiling it as needed).  The program attached to vm should be the
+   same for all calls with the same tag (calls with the same tag and a
+   different text recompile).  Falls back to fd_vm_exec if
+   cache is NULL, tag is 0, vm is tracing or the program cannot be
+   compiled. */
+
+int
+fd_vm_jit_cache_exec( fd_vm_jit_cache_t * cache,
+                      ulong               tag,
+                      fd_vm_t *           vm );
+
+FD_PROTOTYPES_END
+
+#endif /* FD_HAS_X86 */
+
+#endif /* HEADER_fd_src_flamenco_vm_jit_fd_vm_jit_cache_h */
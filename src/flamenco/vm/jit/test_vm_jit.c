@@ -0,0 +1,558 @@
+#include "fd_vm_jit_cache.h"
+#include "../fd_vm_private.h"
+#include "../test_vm_util.h"
+#include "../../../ballet/murmur3/fd_murmur3.h"
+
+/* test_vm_jit runs randomly generated programs on the interpreter and
+   on compiled code and checks that both leave the vm in exactly the
+   same state. */
+
+#define TEXT_MAX  (96UL)
+#define INPUT_SZ  (256UL)
+#define CODE_MAX  (1UL<<20)
+
+static fd_vm_t _vm[2];
+static uchar   input[2][ INPUT_SZ ];
+
+static fd_sbpf_syscalls_t _syscalls[ FD_SBPF_SYSCALLS_SLOT_CNT ];
+static uchar              _calldests[ 4096 ] __attribute__((aligned(64)));
+static uchar              _cache[ 65536 ] __attribute__((aligned(FD_VM_JIT_CACHE_ALIGN)));
+static fd_vm_tcode_t      tcode[ TEXT_MAX ];
+
+static int
+accumulator_syscall( FD_PARAM_UNUSED void *  _vm,
+                     /**/            ulong   arg0,
+                     /**/            ulong   arg1,
+                     /**/            ulong   arg2,
+                     /**/            ulong   arg3,
+                     /**/            ulong   arg4,
+                     /**/            ulong * ret ) {
+  *ret = arg0 + arg1 + arg2 + arg3 + arg4;
+  return 0;
+}
+
+static int
+fail_syscall( void *                  _vm,
+              /**/            ulong   arg0,
+              FD_PARAM_UNUSED ulong   arg1,
+              FD_PARAM_UNUSED ulong   arg2,
+              FD_PARAM_UNUSED ulong   arg3,
+              FD_PARAM_UNUSED ulong   arg4,
+              /**/            ulong * ret ) {
+  fd_vm_t * vm = _vm;
+  *ret = arg0;
+  if( arg0 & 1UL ) return 0;
+  FD_VM_ERR_FOR_LOG_SYSCALL( vm, FD_VM_SYSCALL_ERR_ABORT );
+  return FD_VM_SYSCALL_ERR_ABORT;
+}
+
+static int
+burn_syscall( void *                  _vm,
+              /**/            ulong   arg0,
+              FD_PARAM_UNUSED ulong   arg1,
+              FD_PARAM_UNUSED ulong   arg2,
+              FD_PARAM_UNUSED ulong   arg3,
+              FD_PARAM_UNUSED ulong   arg4,
+              /**/            ulong * ret ) {
+  fd_vm_t * vm   = _vm;
+  ulong     cost = (arg0 & 0xffUL) + 1UL;
+  *ret = vm->cu;
+  if( FD_UNLIKELY( cost>vm->cu ) ) {
+    vm->cu = 0UL;
+    FD_VM_ERR_FOR_LOG_SYSCALL( vm, FD_VM_SYSCALL_ERR_COMPUTE_BUDGET_EXCEEDED );
+    return FD_VM_SYSCALL_ERR_COMPUTE_BUDGET_EXCEEDED;
+  }
+  vm->cu -= cost;
+  return 0;
+}
+
+static char const * syscall_name[3] = { "accumulator", "fail", "burn" };
+
+/* Program generator **************************************************/
+
+static uint
+rand_imm( fd_rng_t * rng ) {
+  switch( fd_rng_uint_roll( rng, 4U ) ) {
+  case 0U: return fd_rng_uint_roll( rng, 8U );
+  case 1U: return (uint)-(int)fd_rng_uint_roll( rng, 8U );
+  case 2U: return fd_rng_uint_roll( rng, 2U ) ? 0x80000000U : 0x7fffffffU;
+  default: return fd_rng_uint( rng );
+  }
+}
+
+static ulong
+rand_vaddr( fd_rng_t * rng,
+            ulong      text_cnt ) {
+  ulong region = fd_rng_uint_roll( rng, 7U );
+  ulong off;
+  switch( region ) {
+  case 1UL: off = fd_rng_ulong_roll( rng, 8UL*text_cnt+16UL );                       break;
+  case 2UL: off = fd_rng_ulong_roll( rng, 3UL*FD_VM_STACK_FRAME_SZ );                break;
+  case 3UL: off = fd_rng_ulong_roll( rng, 1024UL );                                   break;
+  case 4UL: off = fd_rng_ulong_roll( rng, INPUT_SZ+16UL );                            break;
+  default:  off = fd_rng_ulong_roll( rng, 64UL ); region = fd_rng_uint_roll( rng, 2U ) ? 0UL : 5UL+fd_rng_ulong_roll( rng, 3UL ); break;
+  }
+  if( fd_rng_uint_roll( rng, 16U )==0U ) off = 0xfffffff8UL + fd_rng_ulong_roll( rng, 8UL );
+  return (region<<32) | off;
+}
+
+/* alu_valid returns 1 if the non-branching instruction instr passes
+   validation in isolation for sBPF version v (probe is scratch). */
+
+static int
+alu_valid( fd_vm_t * probe,
+           ulong     v,
+           ulong     instr ) {
+  ulong text[3] = { fd_vm_instr( 0x07UL, 10UL, 0UL, 0, 0U ), instr,
+                    fd_vm_instr( FD_VM_SBPF_STATIC_SYSCALLS( v ) ? 0x9dUL : 0x95UL, 0UL, 0UL, 0, 0U ) };
+  ulong skip = fd_sbpf_enable_stricter_elf_headers_enabled( v ) ? 0UL : 1UL; /* function header only needed for v3+ */
+  probe->sbpf_version = v;
+  probe->rodata       = (uchar const *)( text+skip );
+  probe->rodata_sz    = 8UL*(3UL-skip);
+  probe->text         = text+skip;
+  probe->text_cnt     = 3UL-skip;
+  probe->text_sz      = 8UL*(3UL-skip);
+  return fd_vm_validate( probe )==FD_VM_SUCCESS;
+}
+
+/* gen_program generates a random program for the given sBPF version.
+   The program is not guaranteed to pass validation (non-branching
+   instructions are checked with alu_valid so most do).  Returns
+   text_cnt. */
+
+static ulong
+gen_program( fd_rng_t *            rng,
+             ulong                 v,
+             ulong *               text,
+             fd_sbpf_calldests_t * calldests,
+             fd_vm_t *             probe ) {
+  ulong text_cnt = 8UL + fd_rng_ulong_roll( rng, TEXT_MAX-8UL );
+
+  /* Functions (v3+ requires functions to start with add64 r10, imm and
+     to end with ja or exit) */
+
+  int   strict = fd_sbpf_enable_stricter_elf_headers_enabled( v );
+  uchar fstart[ TEXT_MAX ] = {0};
+  fstart[0] = 1;
+  for( ulong j=0UL; j<3UL; j++ ) fstart[ 4UL + fd_rng_ulong_roll( rng, text_cnt-4UL ) ] = 1;
+
+  ulong exit_op = FD_VM_SBPF_STATIC_SYSCALLS( v ) ? 0x9dUL : 0x95UL;
+
+  for( ulong pc=0UL; pc<text_cnt; pc++ ) {
+    ulong dst    = fd_rng_ulong_roll( rng, 10UL );
+    ulong src    = fd_rng_ulong_roll( rng, 11UL );
+    uint  imm    = rand_imm( rng );
+    short off    = (short)( (int)fd_rng_uint_roll( rng, 17U ) - 8 );
+    ulong opcode = 0xb7UL; /* mov64 dst, imm if the case below bails */
+
+    if( fstart[ pc ] ) {
+      if( strict || (fd_sbpf_dynamic_stack_frames_enabled( v ) && fd_rng_uint_roll( rng, 2U )) ) {
+        text[ pc ] = fd_vm_instr( 0x07UL, 10UL, 0UL, 0, (uint)( -64*(int)fd_rng_uint_roll( rng, 3U ) ) );
+        continue;
+      }
+    }
+
+    if( strict && (pc+1UL==text_cnt || fstart[ pc+1UL ]) ) {
+      text[ pc ] = fd_rng_uint_roll( rng, 2U ) ? fd_vm_instr( exit_op, 0UL, 0UL, 0, 0U )
+                                               : fd_vm_instr( 0x05UL, 0UL, 0UL, (short)-1, 0U );
+      continue;
+    }
+
+    /* Words available at pc in this function (the last word of a v3+
+       function is reserved for its ja / exit) */
+
+    ulong room = 1UL; while( pc+room<text_cnt && !fstart[ pc+room ] ) room++;
+    room -= (ulong)strict;
+
+    uint  kind = fd_rng_uint_roll( rng, 10U );
+    switch( kind ) {
+    case 0U: { /* memory access through a register holding a likely vaddr */
+      ulong vaddr = rand_vaddr( rng, text_cnt );
+      ulong base  = fd_rng_uint_roll( rng, 4U ) ? dst : 10UL;
+      if( base!=10UL ) {
+        if( FD_VM_SBPF_ENABLE_LDDW( v ) ) {
+          if( room<3UL ) break;
+          text[ pc++ ] = fd_vm_instr( 0x18UL, base,  0UL, 0, (uint)vaddr );
+          text[ pc++ ] = fd_vm_instr( 0x00UL, 0UL,   0UL, 0, (uint)( vaddr >> 32 ) );
+        } else {
+          if( room<3UL ) break;
+          text[ pc++ ] = fd_vm_instr( 0xb4UL, base,  0UL, 0, (uint)vaddr );
+          text[ pc++ ] = fd_vm_instr( 0xf7UL, base,  0UL, 0, (uint)( vaddr >> 32 ) );
+        }
+      } else {
+        off = (short)( -(int)fd_rng_uint_roll( rng, 2U*(uint)FD_VM_STACK_FRAME_SZ ) + 64 );
+      }
+      static uchar const mem_op_old[12] = { 0x71, 0x69, 0x61, 0x79, 0x72, 0x6a, 0x62, 0x7a, 0x73, 0x6b, 0x63, 0x7b };
+      static uchar const mem_op_new[12] = { 0x2c, 0x3c, 0x8c, 0x9c, 0x27, 0x37, 0x87, 0x97, 0x2f, 0x3f, 0x8f, 0x9f };
+      ulong k = fd_rng_ulong_roll( rng, 12UL );
+      opcode = FD_VM_SBPF_MOVE_MEMORY_IX_CLASSES( v ) ? mem_op_new[ k ] : mem_op_old[ k ];
+      if( k<4UL ) { src = base; }           /* load  dst, [src+off] */
+      else        { src = dst;  dst = base; } /* store [dst+off], src/imm */
+      break;
+    }
+    case 1U: { /* conditional or unconditional branch within the function */
+      static uchar const br_op[23] = { 0x05, 0x15, 0x1d, 0x25, 0x2d, 0x35, 0x3d, 0x45, 0x4d, 0x55, 0x5d, 0x65,
+                                       0x6d, 0x75, 0x7d, 0xa5, 0xad, 0xb5, 0xbd, 0xc5, 0xcd, 0xd5, 0xdd };
+      opcode = br_op[ fd_rng_ulong_roll( rng, 23UL ) ];
+      ulong lo = pc; while( lo && !fstart[ lo ] ) lo--;
+      ulong hi = pc+1UL; while( hi<text_cnt && !fstart[ hi ] ) hi++;
+      ulong target = lo + fd_rng_ulong_roll( rng, hi-lo );
+      off = (short)( (long)target - (long)pc - 1L );
+      if( fd_rng_uint_roll( rng, 4U ) ) imm = fd_rng_uint_roll( rng, 4U ); /* make branches more balanced */
+      break;
+    }
+    case 2U: { /* call */
+      ulong target = 0UL;
+      do target = fd_rng_ulong_roll( rng, text_cnt ); while( !fstart[ target ] && (strict || fd_rng_uint_roll( rng, 8U )) );
+      if( FD_VM_SBPF_STATIC_SYSCALLS( v ) ) {
+        if( fd_rng_uint_roll( rng, 2U ) ) { opcode = 0x85UL; imm = (uint)( (int)target - (int)pc - 1 ); }
+        else {
+          char const * name = syscall_name[ fd_rng_uint_roll( rng, 3U ) ];
+          opcode = 0x95UL; imm = fd_murmur3_32( name, strlen( name ), 0U );
+        }
+        src = 0UL;
+      } else {
+        opcode = 0x85UL;
+        switch( fd_rng_uint_roll( rng, 4U ) ) {
+        case 0U: { char const * name = syscall_name[ fd_rng_uint_roll( rng, 3U ) ]; imm = fd_murmur3_32( name, strlen( name ), 0U ); break; }
+        case 1U: imm = FD_SBPF_ENTRYPOINT_HASH; break;
+        case 2U: imm = fd_rng_uint( rng ); break;
+        default: imm = fd_pchash( (uint)target ); break;
+        }
+      }
+      break;
+    }
+    case 3U: { /* callx through a register holding a likely text address
+                  (not for v3+, the interpreter needs calldests for those) */
+      if( strict ) break;
+      ulong target = fd_rng_ulong_roll( rng, text_cnt+2UL );
+      ulong vaddr  = (1UL<<32) + 8UL*target + (fd_rng_uint_roll( rng, 8U ) ? 0UL : 3UL);
+      ulong reg    = fd_rng_ulong_roll( rng, 10UL );
+      if( room<3UL ) break;
+      if( FD_VM_SBPF_ENABLE_LDDW( v ) ) {
+        text[ pc++ ] = fd_vm_instr( 0x18UL, reg,  0UL, 0, (uint)vaddr );
+        text[ pc++ ] = fd_vm_instr( 0x00UL, 0UL,  0UL, 0, (uint)( vaddr >> 32 ) );
+      } else {
+        text[ pc++ ] = fd_vm_instr( 0xb4UL, reg,  0UL, 0, (uint)vaddr );
+        text[ pc++ ] = fd_vm_instr( 0xf7UL, reg,  0UL, 0, (uint)( vaddr >> 32 ) );
+      }
+      opcode = 0x8dUL;
+      if( fd_sbpf_callx_uses_src_reg_enabled( v ) ) { src = reg; imm = 0U; }
+      else                                          { src = 0UL; imm = (uint)reg; }
+      dst = 0UL;
+      break;
+    }
+    case 4U: /* exit */
+      opcode = exit_op; dst = 0UL; src = 0UL; imm = 0U;
+      break;
+    case 5U: /* lddw */
+      if( !FD_VM_SBPF_ENABLE_LDDW( v ) || room<2UL ) break;
+      opcode = 0x18UL;
+      break;
+    case 6U: /* shift by a small immediate or a large register */
+      opcode = (ulong)(uchar)"\x64\x67\x74\x77\xc4\xc7\x6c\x6f\x7c\x7f\xcc\xcf"[ fd_rng_uint_roll( rng, 12U ) ];
+      imm    = fd_rng_uint_roll( rng, 32U );
+      break;
+    case 7U: /* byte swap */
+      opcode = fd_rng_uint_roll( rng, 2U ) ? 0xd4UL : 0xdcUL;
+      imm    = 16U << fd_rng_uint_roll( rng, 3U );
+      break;
+    default: /* random alu op */
+      opcode = fd_rng_uint_roll( rng, 256U );
+      for( ulong t=0UL; t<16UL; t++ ) {
+        opcode = (opcode & 0xf0UL) | (ulong)(uchar)"\x04\x07\x0c\x0f\x06\x0e\x04\x07"[ fd_rng_uint_roll( rng, 8U ) ];
+        if( alu_valid( probe, v, fd_vm_instr( opcode, dst, src, off, imm ) ) ) break;
+        opcode = fd_rng_uint_roll( rng, 256U );
+        imm    = fd_rng_uint_roll( rng, 2U ) ? rand_imm( rng ) : fd_rng_uint_roll( rng, 64U );
+        src    = fd_rng_ulong_roll( rng, 10UL );
+      }
+      break;
+    }
+
+    if( opcode==0x18UL && room<2UL ) opcode = 0xb7UL;
+    if( (kind==0U || kind>=6U) && opcode!=0x18UL && !alu_valid( probe, v, fd_vm_instr( opcode, dst, src, off, imm ) ) ) opcode = 0xb7UL;
+    text[ pc ] = fd_vm_instr( opcode, dst, src, off, imm );
+    if( opcode==0x18UL ) text[ ++pc ] = fd_vm_instr( 0x00UL, 0UL, 0UL, 0, fd_rng_uint( rng ) );
+  }
+
+  /* Branches cannot target the second word of a lddw */
+
+  if( FD_VM_SBPF_ENABLE_LDDW( v ) ) {
+    uchar shadow[ TEXT_MAX ] = {0};
+    for( ulong pc=0UL; pc+1UL<text_cnt; pc++ ) if( fd_vm_instr_opcode( text[ pc ] )==0x18UL ) shadow[ ++pc ] = 1;
+    for( ulong pc=0UL; pc<text_cnt; pc++ ) {
+      ulong opcode = fd_vm_instr_opcode( text[ pc ] );
+      if( shadow[ pc ] || (opcode & 7UL)!=5UL || opcode==0x85UL || opcode==0x8dUL || opcode==0x95UL ) continue;
+      ulong instr  = text[ pc ];
+      ulong target = pc + 1UL + fd_vm_instr_offset( instr );
+      if( target<text_cnt && shadow[ target ] )
+        text[ pc ] = fd_vm_instr( opcode, fd_vm_instr_dst( instr ), fd_vm_instr_src( instr ),
+                                  (short)( (long)fd_vm_instr_offset( instr ) - 1L ), fd_vm_instr_imm( instr ) );
+    }
+  }
+
+  fd_sbpf_calldests_null( calldests );
+  for( ulong pc=0UL; pc<text_cnt; pc++ ) if( fstart[ pc ] ) fd_sbpf_calldests_insert( calldests, pc );
+  return text_cnt;
+}
+
+/* Test harness *******************************************************/
+
+static fd_vm_t *
+setup_vm( fd_vm_t *                  vm,
+          uchar *                    input_mem,
+          fd_vm_input_region_t *     input_region,
+          fd_exec_instr_ctx_t *      instr_ctx,
+          fd_sha256_t *              sha,
+          ulong const *              text,
+          ulong                      text_cnt,
+          ulong                      v,
+          ulong                      entry_cu,
+          fd_sbpf_calldests_t const * calldests,
+          fd_sbpf_syscalls_t *       syscalls,
+          fd_rng_t *                 rng_input ) {
+  for( ulong b=0UL; b<INPUT_SZ; b++ ) input_mem[ b ] = fd_rng_uchar( rng_input );
+  *input_region = (fd_vm_input_region_t){
+    .vaddr_offset           = 0UL,
+    .haddr                  = (ulong)input_mem,
+    .region_sz              = (uint)INPUT_SZ,
+    .address_space_reserved = INPUT_SZ,
+    .is_writable            = 1,
+    .acc_region_meta_idx    = 0UL
+  };
+
+  FD_TEST( fd_vm_init(
+      /* vm                                   */ vm,
+      /* instr_ctx                            */ instr_ctx,
+      /* heap_max                             */ FD_VM_HEAP_DEFAULT,
+      /* entry_cu                             */ entry_cu,
+      /* rodata                               */ (uchar const *)text,
+      /* rodata_sz                            */ 8UL*text_cnt,
+      /* text                                 */ text,
+      /* text_cnt                             */ text_cnt,
+      /* text_off                             */ 0UL,
+      /* text_sz                              */ 8UL*text_cnt,
+      /* entry_pc                             */ 0UL,
+      /* calldests                            */ fd_sbpf_enable_stricter_elf_headers_enabled( v ) ? NULL : calldests,
+      /* sbpf_version                         */ v,
+      /* syscalls                             */ syscalls,
+      /* trace                                */ NULL,
+      /* sha                                  */ sha,
+      /* mem_regions                          */ input_region,
+      /* mem_regions_cnt                      */ 1U,
+      /* mem_regions_accs                     */ NULL,
+      /* is_deprecated                        */ 0,
+      /* direct mapping                       */ 0,
+      /* stricter_abi_and_runtime_constraints */ 0,
+      /* dump_syscall_to_pb */ 0
+  ) );
+
+  vm->pc        = vm->entry_pc;
+  vm->ic        = 0UL;
+  vm->cu        = vm->entry_cu;
+  vm->frame_cnt = 0UL;
+  vm->heap_sz   = 0UL;
+  fd_vm_mem_cfg( vm );
+
+  fd_memset( vm->stack,  0, FD_VM_STACK_MAX );
+  fd_memset( vm->heap,   0, FD_VM_HEAP_MAX  );
+  fd_memset( vm->shadow, 0, sizeof(vm->shadow) );
+  vm->segv_vaddr       = 0UL;
+  vm->segv_access_len  = 0UL;
+  vm->segv_access_type = 0;
+  for( ulong r=1UL; r<10UL; r++ ) vm->reg[ r ] = fd_rng_ulong( rng_input ) >> (fd_rng_uint_roll( rng_input, 64U ));
+  return vm;
+}
+
+static void
+check_same( fd_vm_t const * a,
+            int             err_a,
+            fd_vm_t const * b,
+            int             err_b,
+            ulong           iter ) {
+  if( FD_UNLIKELY( err_a!=err_b || a->pc!=b->pc || a->ic!=b->ic || a->cu!=b->cu || a->frame_cnt!=b->frame_cnt ) ) {
+    FD_LOG_ERR(( "iter %lu (v%lu): interp err %i pc %lu ic %lu cu %lu frame_cnt %lu, jit err %i pc %lu ic %lu cu %lu frame_cnt %lu",
+                 iter, a->sbpf_version,
+                 err_a, a->pc, a->ic, a->cu, a->frame_cnt,
+                 err_b, b->pc, b->ic, b->cu, b->frame_cnt ));
+  }
+  for( ulong r=0UL; r<FD_VM_REG_CNT; r++ ) {
+    if( FD_UNLIKELY( a->reg[ r ]!=b->reg[ r ] ) ) FD_LOG_ERR(( "iter %lu: r%lu interp %lx jit %lx", iter, r, a->reg[ r ], b->reg[ r ] ));
+  }
+  FD_TEST( !memcmp( a->shadow, b->shadow, sizeof(a->shadow) ) );
+  FD_TEST( !memcmp( a->stack,  b->stack,  FD_VM_STACK_MAX   ) );
+  FD_TEST( !memcmp( a->heap,   b->heap,   FD_VM_HEAP_MAX    ) );
+  FD_TEST( !memcmp( input[0],  input[1],  INPUT_SZ          ) );
+  FD_TEST( a->segv_vaddr==b->segv_vaddr && a->segv_access_len==b->segv_access_len && a->segv_access_type==b->segv_access_type );
+}
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  ulong iter_max = fd_env_strip_cmdline_ulong( &argc, &argv, "--iter-max", NULL, 20000UL );
+
+  fd_rng_t _rng[1]; fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, 0U, 0UL ) );
+
+  fd_sbpf_syscalls_t * syscalls = fd_sbpf_syscalls_join( fd_sbpf_syscalls_new( _syscalls ) ); FD_TEST( syscalls );
+  FD_TEST( fd_vm_syscall_register( syscalls, "accumulator", accumulator_syscall )==FD_VM_SUCCESS );
+  FD_TEST( fd_vm_syscall_register( syscalls, "fail",        fail_syscall        )==FD_VM_SUCCESS );
+  FD_TEST( fd_vm_syscall_register( syscalls, "burn",        burn_syscall        )==FD_VM_SUCCESS );
+
+  FD_TEST( fd_sbpf_calldests_footprint( TEXT_MAX )<=sizeof(_calldests) );
+  fd_sbpf_calldests_t * calldests = fd_sbpf_calldests_join( fd_sbpf_calldests_new( _calldests, TEXT_MAX ) ); FD_TEST( calldests );
+
+  fd_exec_instr_ctx_t instr_ctx[1];
+  fd_exec_txn_ctx_t   txn_ctx[1];
+  test_vm_minimal_exec_instr_ctx( instr_ctx, txn_ctx );
+
+  fd_sha256_t _sha[1];
+  fd_sha256_t * sha = fd_sha256_join( fd_sha256_new( _sha ) );
+
+  fd_vm_t * vm_interp = fd_vm_join( fd_vm_new( _vm+0 ) ); FD_TEST( vm_interp );
+  fd_vm_t * vm_jit    = fd_vm_join( fd_vm_new( _vm+1 ) ); FD_TEST( vm_jit    );
+
+  fd_vm_input_region_t input_region[2];
+
+  uchar * code_rw;
+  uchar * code_rx;
+  FD_TEST( !fd_vm_jit_cache_code_map( CODE_MAX, &code_rw, &code_rx ) );
+
+  FD_TEST( fd_vm_jit_cache_footprint( 1024UL )<=sizeof(_cache) );
+  FD_TEST( !fd_vm_jit_cache_footprint( 1000UL ) );
+  fd_vm_jit_cache_t * cache = fd_vm_jit_cache_join( fd_vm_jit_cache_new( _cache, 1024UL, code_rw, code_rx, CODE_MAX ) );
+  FD_TEST( cache );
+
+  /* Minimal program (also tests the compile api) */
+
+  do {
+    ulong const text[3] = {
+      fd_vm_instr( FD_SBPF_OP_XOR64_REG, 0, 0, 0, 0 ),
+      fd_vm_instr( FD_SBPF_OP_ADD64_IMM, 0, 0, 0, 42 ),
+      fd_vm_instr( FD_SBPF_OP_EXIT,      0, 0, 0, 0 )
+    };
+    fd_rng_t _rng_in[1]; fd_rng_t * rng_in = fd_rng_join( fd_rng_new( _rng_in, 1U, 0UL ) );
+    setup_vm( vm_jit, input[1], input_region+1, instr_ctx, sha, text, 3UL, FD_SBPF_V0, 3UL, calldests, syscalls, rng_in );
+
+    ulong sz = 1UL;
+    FD_TEST( !fd_vm_jit_compile( code_rw, 64UL, vm_jit, &sz ) );
+    FD_TEST( sz>64UL && sz<=fd_vm_jit_footprint( 3UL ) );
+    FD_TEST( !fd_vm_jit_compile( code_rw+1, CODE_MAX-1UL, vm_jit, &sz ) );
+    FD_TEST( !sz );
+    fd_vm_jit_t * jit = fd_vm_jit_compile( code_rw, CODE_MAX, vm_jit, &sz );
+    FD_TEST( jit );
+    FD_TEST( fd_ulong_is_aligned( sz, FD_VM_JIT_ALIGN ) && sz<=fd_vm_jit_footprint( 3UL ) );
+
+    fd_vm_jit_t const * jit_rx = (fd_vm_jit_t const *)code_rx;
+    FD_TEST( fd_vm_jit_exec( NULL, vm_jit )==FD_VM_ERR_INVAL );
+    FD_TEST( fd_vm_jit_exec( jit_rx, vm_jit )==FD_VM_SUCCESS );
+    FD_TEST( vm_jit->reg[0]==42UL && vm_jit->cu==0UL && vm_jit->ic==3UL );
+
+    /* Running out of CUs at the exit */
+    setup_vm( vm_jit, input[1], input_region+1, instr_ctx, sha, text, 3UL, FD_SBPF_V0, 2UL, calldests, syscalls, rng_in );
+    FD_TEST( fd_vm_jit_exec( jit_rx, vm_jit )==FD_VM_ERR_EBPF_EXCEEDED_MAX_INSTRUCTIONS );
+
+    /* Version mismatch */
+    setup_vm( vm_jit, input[1], input_region+1, instr_ctx, sha, text, 3UL, FD_SBPF_V1, 3UL, calldests, syscalls, rng_in );
+    FD_TEST( fd_vm_jit_exec( jit_rx, vm_jit )==FD_VM_ERR_INVAL );
+
+    /* Unvalidated program */
+    ulong const bad[1] = { fd_vm_instr( 0xffUL, 0, 0, 0, 0 ) };
+    setup_vm( vm_jit, input[1], input_region+1, instr_ctx, sha, bad, 1UL, FD_SBPF_V0, 3UL, calldests, syscalls, rng_in );
+    FD_TEST( !fd_vm_jit_compile( code_rw, CODE_MAX, vm_jit, &sz ) );
+    FD_TEST( !sz );
+
+    fd_rng_delete( fd_rng_leave( rng_in ) );
+  } while(0);
+
+  /* A tag hit with a different text (e.g. a stale tag) recompiles */
+
+  do {
+    ulong const text_a[3] = {
+      fd_vm_instr( FD_SBPF_OP_XOR64_REG, 0, 0, 0, 0 ),
+      fd_vm_instr( FD_SBPF_OP_ADD64_IMM, 0, 0, 0, 42 ),
+      fd_vm_instr( FD_SBPF_OP_EXIT,      0, 0, 0, 0 )
+    };
+    ulong const text_b[3] = {
+      fd_vm_instr( FD_SBPF_OP_XOR64_REG, 0, 0, 0, 0 ),
+      fd_vm_instr( FD_SBPF_OP_ADD64_IMM, 0, 0, 0, 7 ),
+      fd_vm_instr( FD_SBPF_OP_EXIT,      0, 0, 0, 0 )
+    };
+    ulong const tag = ULONG_MAX; /* not used by the differential test */
+
+    fd_rng_t _rng_in[1]; fd_rng_t * rng_in = fd_rng_join( fd_rng_new( _rng_in, 1U, 0UL ) );
+    setup_vm( vm_jit, input[1], input_region+1, instr_ctx, sha, text_a, 3UL, FD_SBPF_V0, 3UL, calldests, syscalls, rng_in );
+    ulong compile_cnt = cache->metrics->compile_cnt;
+    FD_TEST( fd_vm_jit_cache_exec( cache, tag, vm_jit )==FD_VM_SUCCESS && vm_jit->reg[0]==42UL );
+    FD_TEST( cache->metrics->compile_cnt==compile_cnt+1UL );
+
+    setup_vm( vm_jit, input[1], input_region+1, instr_ctx, sha, text_b, 3UL, FD_SBPF_V0, 3UL, calldests, syscalls, rng_in );
+    FD_TEST( fd_vm_jit_cache_exec( cache, tag, vm_jit )==FD_VM_SUCCESS && vm_jit->reg[0]==7UL );
+    FD_TEST( cache->metrics->compile_cnt==compile_cnt+2UL );
+
+    ulong hit_cnt = cache->metrics->hit_cnt;
+    setup_vm( vm_jit, input[1], input_region+1, instr_ctx, sha, text_b, 3UL, FD_SBPF_V0, 3UL, calldests, syscalls, rng_in );
+    FD_TEST( fd_vm_jit_cache_exec( cache, tag, vm_jit )==FD_VM_SUCCESS && vm_jit->reg[0]==7UL );
+    FD_TEST( cache->metrics->compile_cnt==compile_cnt+2UL && cache->metrics->hit_cnt==hit_cnt+1UL );
+
+    fd_rng_delete( fd_rng_leave( rng_in ) );
+  } while(0);
+
+  /* Differential test against the interpreter */
+
+  ulong text[ TEXT_MAX ];
+  ulong valid_cnt = 0UL;
+  ulong run_cnt   = 0UL;
+  ulong err_hist[ 64 ] = {0};
+  for( ulong iter=0UL; iter<iter_max; iter++ ) {
+    ulong v        = fd_rng_ulong_roll( rng, FD_SBPF_V3+1UL ); /* interpreter supports v0..v3 */
+    ulong text_cnt = gen_program( rng, v, text, calldests, vm_interp );
+
+    fd_rng_t _rng_in[1]; fd_rng_t * rng_in = fd_rng_join( fd_rng_new( _rng_in, (uint)iter, 0UL ) );
+    setup_vm( vm_interp, input[0], input_region+0, instr_ctx, sha, text, text_cnt, v, 0UL, calldests, syscalls, rng_in );
+    if( fd_vm_validate( vm_interp )!=FD_VM_SUCCESS ) continue;
+    valid_cnt++;
+    fd_vm_tcode_build( tcode, vm_interp );
+
+    ulong tag = iter+1UL;
+    for( ulong rep=0UL; rep<3UL; rep++ ) {
+      ulong entry_cu = fd_rng_ulong_roll( rng, rep==2UL ? 64UL : 10000UL );
+      uint  seed     = fd_rng_uint( rng );
+
+      rng_in = fd_rng_join( fd_rng_new( _rng_in, seed, 0UL ) );
+      setup_vm( vm_interp, input[0], input_region+0, instr_ctx, sha, text, text_cnt, v, entry_cu, calldests, syscalls, rng_in );
+      if( rep==1UL ) vm_interp->tcode = tcode; /* also check the interpreter on pre-decoded text */
+      test_vm_clear_txn_ctx_err( txn_ctx );
+      int err_interp = fd_vm_exec( vm_interp );
+
+      rng_in = fd_rng_join( fd_rng_new( _rng_in, seed, 0UL ) );
+      setup_vm( vm_jit, input[1], input_region+1, instr_ctx, sha, text, text_cnt, v, entry_cu, calldests, syscalls, rng_in );
+      test_vm_clear_txn_ctx_err( txn_ctx );
+      int err_jit = fd_vm_jit_cache_exec( cache, tag, vm_jit );
+
+      check_same( vm_interp, err_interp, vm_jit, err_jit, iter );
+      err_hist[ (ulong)(-err_interp) & 63UL ]++;
+      run_cnt++;
+    }
+  }
+
+  FD_LOG_NOTICE(( "valid %lu / %lu programs, %lu runs", valid_cnt, iter_max, run_cnt ));
+  for( ulong e=0UL; e<64UL; e++ ) if( err_hist[ e ] ) FD_LOG_NOTICE(( "err %3i (%s): %lu", -(int)e, fd_vm_strerror( -(int)e ), err_hist[ e ] ));
+  FD_LOG_NOTICE(( "cache: hit %lu compile %lu fail %lu flush %lu interp %lu",
+                  cache->metrics->hit_cnt, cache->metrics->compile_cnt, cache->metrics->compile_fail_cnt,
+                  cache->metrics->flush_cnt, cache->metrics->interp_cnt ));
+  FD_TEST( cache->metrics->hit_cnt && cache->metrics->compile_cnt && !cache->metrics->compile_fail_cnt );
+
+  FD_TEST( fd_vm_jit_cache_delete( fd_vm_jit_cache_leave( cache ) )==_cache );
+  fd_vm_jit_cache_code_unmap( code_rw, code_rx, CODE_MAX );
+
+  fd_vm_delete( fd_vm_leave( vm_jit    ) );
+  fd_vm_delete( fd_vm_leave( vm_interp ) );
+  fd_sha256_delete( fd_sha256_leave( sha ) );
+  fd_rng_delete( fd_rng_leave( rng ) );
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
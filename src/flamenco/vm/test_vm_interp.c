@@ -16,6 +16,49 @@ accumulator_syscall( FD_PARAM_UNUSED void *  _vm,
   return 0;
 }
 
+/* test_tcode_exec runs vm from the program start with the program's
+   pre-decoded text and checks that the result matches the result of
+   the run of the interpreter that left vm in its current state (with
+   registers exp_reg before that run). */
+
+static void
+test_tcode_exec( fd_vm_t *     vm,
+                 int           exp_err,
+                 ulong const * exp_reg ) {
+  ulong exp_pc = vm->pc;
+  ulong exp_ic = vm->ic;
+  ulong exp_cu = vm->cu;
+  ulong res[ FD_VM_REG_MAX ];
+  memcpy( res, vm->reg, sizeof(res) );
+
+  fd_vm_tcode_t * tcode = (fd_vm_tcode_t *)aligned_alloc( fd_vm_tcode_align(), fd_ulong_max( fd_vm_tcode_footprint( vm->text_cnt ), 16UL ) );
+  FD_TEST( tcode );
+  FD_TEST( fd_vm_tcode_build( tcode, vm )==tcode );
+
+  memcpy( vm->reg, exp_reg, sizeof(res) );
+  vm->pc        = vm->entry_pc;
+  vm->ic        = 0UL;
+  vm->cu        = vm->entry_cu;
+  vm->frame_cnt = 0UL;
+  vm->heap_sz   = 0UL;
+  vm->tcode     = tcode;
+  fd_vm_mem_cfg( vm );
+
+  long dt = -fd_log_wallclock();
+  int err = fd_vm_exec( vm );
+  dt += fd_log_wallclock();
+
+  FD_TEST( err==exp_err );
+  FD_TEST( vm->pc==exp_pc );
+  FD_TEST( vm->ic==exp_ic );
+  FD_TEST( vm->cu==exp_cu );
+  FD_TEST( !memcmp( vm->reg, res, sizeof(res) ) );
+  FD_LOG_NOTICE(( "%-20s %11li ns (tcode)", "", dt ));
+
+  vm->tcode = NULL;
+  free( tcode );
+}
+
 static void
 test_program_success( char *                test_case_name,
                       ulong                 expected_result,
@@ -70,6 +113,9 @@ test_program_success( char *                test_case_name,
   int err = fd_vm_validate( vm );
   if( FD_UNLIKELY( err ) ) FD_LOG_ERR(( "validation failed: %i-%s", err, fd_vm_strerror( err ) ));
 
+  ulong reg0[ FD_VM_REG_MAX ];
+  memcpy( reg0, vm->reg, sizeof(reg0) );
+
   long dt = -fd_log_wallclock();
   err = fd_vm_exec( vm );
   dt += fd_log_wallclock();
@@ -83,6 +129,8 @@ test_program_success( char *                test_case_name,
 //FD_LOG_NOTICE(( "Instr counter: %lu", vm.ic ));
   FD_TEST( vm->reg[0]==expected_result );
   FD_LOG_NOTICE(( "%-20s %11li ns", test_case_name, dt ));
+
+  if( text_cnt<=(1UL<<20) ) test_tcode_exec( vm, err, reg0 );
 //FD_LOG_NOTICE(( "Time/Instr: %f ns", (double)dt / (double)vm.ic ));
 //FD_LOG_NOTICE(( "Mega Instr/Sec: %f", 1000.0 * ((double)vm.ic / (double) dt)));
 }
@@ -1086,6 +1134,52 @@ main( int     argc,
     FD_SBPF_INSTR(FD_SBPF_OP_EXIT,      0,      0,      0, 0),
   );
 
+  /* Sequences fused into superinstructions when pre-decoded (see
+     fd_vm_tcode.h), including faults midway and branches into the
+     middle of a sequence */
+
+  TEST_PROGRAM_SUCCESS("tcode-fused", 13, 13,
+    FD_SBPF_INSTR(FD_SBPF_OP_MOV64_REG, FD_SBPF_R1,  FD_SBPF_R10, 0, 0),
+    FD_SBPF_INSTR(FD_SBPF_OP_ADD64_IMM, FD_SBPF_R1,  0,           0, (uint)-8),
+    FD_SBPF_INSTR(FD_SBPF_OP_MOV64_IMM, FD_SBPF_R2,  0,           0, 5),
+    FD_SBPF_INSTR(FD_SBPF_OP_STXDW,     FD_SBPF_R1,  FD_SBPF_R2,  0, 0),
+    FD_SBPF_INSTR(FD_SBPF_OP_LDXDW,     FD_SBPF_R3,  FD_SBPF_R1,  0, 0),
+    FD_SBPF_INSTR(FD_SBPF_OP_ADD64_IMM, FD_SBPF_R3,  0,           0, 7),
+    FD_SBPF_INSTR(FD_SBPF_OP_STXDW,     FD_SBPF_R1,  FD_SBPF_R3,  0, 0),
+    FD_SBPF_INSTR(FD_SBPF_OP_LDXDW,     FD_SBPF_R0,  FD_SBPF_R1,  0, 0),
+    FD_SBPF_INSTR(FD_SBPF_OP_MOV64_REG, FD_SBPF_R4,  FD_SBPF_R0,  0, 0),
+    FD_SBPF_INSTR(FD_SBPF_OP_MOV64_REG, FD_SBPF_R5,  FD_SBPF_R4,  0, 0),
+    FD_SBPF_INSTR(FD_SBPF_OP_MOV64_REG, FD_SBPF_R0,  FD_SBPF_R5,  0, 0),
+    FD_SBPF_INSTR(FD_SBPF_OP_ADD64_IMM, FD_SBPF_R0,  0,           0, 1),
+    FD_SBPF_INSTR(FD_SBPF_OP_EXIT,      0,           0,           0, 0),
+  );
+
+  TEST_PROGRAM_SUCCESS("tcode-fused-ld-segv", 0, 6,
+    FD_SBPF_INSTR(FD_SBPF_OP_MOV64_IMM, FD_SBPF_R0,  0,           0, 0),
+    FD_SBPF_INSTR(FD_SBPF_OP_MOV64_IMM, FD_SBPF_R6,  0,           0, 0),
+    FD_SBPF_INSTR(FD_SBPF_OP_LDXDW,     FD_SBPF_R3,  FD_SBPF_R6,  0, 0),
+    FD_SBPF_INSTR(FD_SBPF_OP_ADD64_IMM, FD_SBPF_R3,  0,           0, 1),
+    FD_SBPF_INSTR(FD_SBPF_OP_STXDW,     FD_SBPF_R10, FD_SBPF_R3, -8, 0),
+    FD_SBPF_INSTR(FD_SBPF_OP_EXIT,      0,           0,           0, 0),
+  );
+
+  TEST_PROGRAM_SUCCESS("tcode-fused-st-segv", 0, 6,
+    FD_SBPF_INSTR(FD_SBPF_OP_MOV64_IMM, FD_SBPF_R0,  0,           0, 0),
+    FD_SBPF_INSTR(FD_SBPF_OP_MOV64_IMM, FD_SBPF_R6,  0,           0, 0),
+    FD_SBPF_INSTR(FD_SBPF_OP_LDXDW,     FD_SBPF_R3,  FD_SBPF_R10, -8, 0),
+    FD_SBPF_INSTR(FD_SBPF_OP_ADD64_IMM, FD_SBPF_R3,  0,           0, 1),
+    FD_SBPF_INSTR(FD_SBPF_OP_STXDW,     FD_SBPF_R6,  FD_SBPF_R3,  0, 0),
+    FD_SBPF_INSTR(FD_SBPF_OP_EXIT,      0,           0,           0, 0),
+  );
+
+  TEST_PROGRAM_SUCCESS("tcode-branch-into-fused", 3, 5,
+    FD_SBPF_INSTR(FD_SBPF_OP_MOV64_IMM, FD_SBPF_R0,  0,           0, 0),
+    FD_SBPF_INSTR(FD_SBPF_OP_JA,        0,           0,          +1, 0),
+    FD_SBPF_INSTR(FD_SBPF_OP_MOV64_REG, FD_SBPF_R0,  FD_SBPF_R10, 0, 0),
+    FD_SBPF_INSTR(FD_SBPF_OP_ADD64_IMM, FD_SBPF_R0,  0,           0, 3),
+    FD_SBPF_INSTR(FD_SBPF_OP_EXIT,      0,           0,           0, 0),
+  );
+
   ulong   text_cnt = 128*1024*1024;
   ulong * text     = (ulong *)malloc( sizeof(ulong)*text_cnt ); /* FIXME: gross */
 
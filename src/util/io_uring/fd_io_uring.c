@@ -0,0 +1,170 @@
+#define _GNU_SOURCE /* MAP_POPULATE, syscall */
+#include "fd_io_uring.h"
+
+#include "../log/fd_log.h"
+
+#include <errno.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+static inline int
+fd_io_uring_sys_setup( uint                      entries,
+                       struct io_uring_params *  p ) {
+  return (int)syscall( SYS_io_uring_setup, entries, p );
+}
+
+static inline int
+fd_io_uring_sys_enter( int  ring_fd,
+                       uint to_submit,
+                       uint min_complete,
+                       uint flags ) {
+  return (int)syscall( SYS_io_uring_enter, ring_fd, to_submit, min_complete, flags, NULL, 0UL );
+}
+
+static inline int
+fd_io_uring_sys_register( int          ring_fd,
+                          uint         opcode,
+                          void const * arg,
+                          uint         nr_args ) {
+  return (int)syscall( SYS_io_uring_register, ring_fd, opcode, arg, nr_args );
+}
+
+fd_io_uring_t *
+fd_io_uring_init( fd_io_uring_t * ring,
+                  uint            depth,
+                  uint            flags ) {
+
+  if( FD_UNLIKELY( !ring ) ) {
+    FD_LOG_WARNING(( "NULL ring" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !depth ) ) {
+    FD_LOG_WARNING(( "zero depth" ));
+    return NULL;
+  }
+
+  memset( ring, 0, sizeof(fd_io_uring_t) );
+  ring->ring_fd = -1;
+
+  struct io_uring_params p[1];
+  memset( p, 0, sizeof(struct io_uring_params) );
+  p->flags      = flags | IORING_SETUP_CQSIZE;
+  p->cq_entries = 2U*depth;
+
+  int ring_fd = fd_io_uring_sys_setup( depth, p );
+  if( FD_UNLIKELY( ring_fd<0 ) ) {
+    FD_LOG_WARNING(( "io_uring_setup(%u) failed (%i-%s)", depth, errno, fd_io_strerror( errno ) ));
+    return NULL;
+  }
+
+  ring->ring_fd = ring_fd;
+
+  /* Map the rings.  If the kernel supports it, the SQ and CQ rings
+     share a single mapping. */
+
+  ring->sq_mem_sz  = (ulong)p->sq_off.array + (ulong)p->sq_entries*sizeof(uint);
+  ring->cq_mem_sz  = (ulong)p->cq_off.cqes  + (ulong)p->cq_entries*sizeof(struct io_uring_cqe);
+  ring->sqe_mem_sz = (ulong)p->sq_entries*sizeof(struct io_uring_sqe);
+
+  int single_mmap = !!(p->features & IORING_FEAT_SINGLE_MMAP);
+  if( single_mmap ) ring->sq_mem_sz = ring->cq_mem_sz = fd_ulong_max( ring->sq_mem_sz, ring->cq_mem_sz );
+
+  ring->sq_mem = mmap( NULL, ring->sq_mem_sz, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, (off_t)IORING_OFF_SQ_RING );
+  if( FD_UNLIKELY( ring->sq_mem==MAP_FAILED ) ) {
+    FD_LOG_WARNING(( "mmap(IORING_OFF_SQ_RING) failed (%i-%s)", errno, fd_io_strerror( errno ) ));
+    ring->sq_mem = NULL;
+    fd_io_uring_fini( ring );
+    return NULL;
+  }
+
+  if( single_mmap ) ring->cq_mem = ring->sq_mem;
+  else {
+    ring->cq_mem = mmap( NULL, ring->cq_mem_sz, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, (off_t)IORING_OFF_CQ_RING );
+    if( FD_UNLIKELY( ring->cq_mem==MAP_FAILED ) ) {
+      FD_LOG_WARNING(( "mmap(IORING_OFF_CQ_RING) failed (%i-%s)", errno, fd_io_strerror( errno ) ));
+      ring->cq_mem = NULL;
+      fd_io_uring_fini( ring );
+      return NULL;
+    }
+  }
+
+  void * sqe_mem = mmap( NULL, ring->sqe_mem_sz, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, (off_t)IORING_OFF_SQES );
+  if( FD_UNLIKELY( sqe_mem==MAP_FAILED ) ) {
+    FD_LOG_WARNING(( "mmap(IORING_OFF_SQES) failed (%i-%s)", errno, fd_io_strerror( errno ) ));
+    fd_io_uring_fini( ring );
+    return NULL;
+  }
+
+  uchar * sq = (uchar *)ring->sq_mem;
+  uchar * cq = (uchar *)ring->cq_mem;
+
+  ring->sq_khead = (uint *)(sq + p->sq_off.head);
+  ring->sq_ktail = (uint *)(sq + p->sq_off.tail);
+  ring->sq_array = (uint *)(sq + p->sq_off.array);
+  ring->sqe      = (struct io_uring_sqe *)sqe_mem;
+  ring->sq_mask  = *(uint *)(sq + p->sq_off.ring_mask);
+  ring->sq_depth = *(uint *)(sq + p->sq_off.ring_entries);
+  ring->sq_tail  = *ring->sq_ktail;
+
+  ring->cq_khead = (uint *)(cq + p->cq_off.head);
+  ring->cq_ktail = (uint *)(cq + p->cq_off.tail);
+  ring->cqe      = (struct io_uring_cqe *)(cq + p->cq_off.cqes);
+  ring->cq_mask  = *(uint *)(cq + p->cq_off.ring_mask);
+  ring->cq_depth = *(uint *)(cq + p->cq_off.ring_entries);
+
+  return ring;
+}
+
+fd_io_uring_t *
+fd_io_uring_fini( fd_io_uring_t * ring ) {
+  if( FD_UNLIKELY( !ring ) ) return NULL;
+
+  if( ring->sqe && FD_UNLIKELY( munmap( ring->sqe, ring->sqe_mem_sz ) ) )
+    FD_LOG_WARNING(( "munmap(sqes) failed (%i-%s)", errno, fd_io_strerror( errno ) ));
+
+  if( ring->cq_mem && ring->cq_mem!=ring->sq_mem && FD_UNLIKELY( munmap( ring->cq_mem, ring->cq_mem_sz ) ) )
+    FD_LOG_WARNING(( "munmap(cq) failed (%i-%s)", errno, fd_io_strerror( errno ) ));
+
+  if( ring->sq_mem && FD_UNLIKELY( munmap( ring->sq_mem, ring->sq_mem_sz ) ) )
+    FD_LOG_WARNING(( "munmap(sq) failed (%i-%s)", errno, fd_io_strerror( errno ) ));
+
+  if( ring->ring_fd>=0 && FD_UNLIKELY( close( ring->ring_fd ) ) )
+    FD_LOG_WARNING(( "close(ring_fd) failed (%i-%s)", errno, fd_io_strerror( errno ) ));
+
+  memset( ring, 0, sizeof(fd_io_uring_t) );
+  ring->ring_fd = -1;
+  return ring;
+}
+
+int
+fd_io_uring_register_buffers( fd_io_uring_t *      ring,
+                              struct iovec const * iov,
+                              uint                 iov_cnt ) {
+  if( FD_UNLIKELY( fd_io_uring_sys_register( ring->ring_fd, IORING_REGISTER_BUFFERS, iov, iov_cnt ) ) ) {
+    int err = errno;
+    FD_LOG_WARNING(( "io_uring_register(IORING_REGISTER_BUFFERS,%u) failed (%i-%s)", iov_cnt, err, fd_io_strerror( err ) ));
+    return err;
+  }
+  return 0;
+}
+
+int
+fd_io_uring_submit( fd_io_uring_t * ring,
+                    uint            wait_cnt ) {
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( *ring->sq_ktail ) = ring->sq_tail;
+  FD_COMPILER_MFENCE();
+
+  /* SQEs published by a previous submit that the kernel did not consume
+     (partial submit, EAGAIN, EBUSY, EINTR) are still pending, so count
+     everything the kernel has not consumed yet. */
+
+  uint to_submit = ring->sq_tail - FD_VOLATILE_CONST( *ring->sq_khead );
+
+  if( FD_UNLIKELY( !(to_submit | wait_cnt) ) ) return 0;
+
+  int res = fd_io_uring_sys_enter( ring->ring_fd, to_submit, wait_cnt, wait_cnt ? IORING_ENTER_GETEVENTS : 0U );
+  return res<0 ? -errno : res;
+}
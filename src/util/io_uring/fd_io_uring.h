@@ -0,0 +1,193 @@
+#ifndef HEADER_fd_src_util_io_uring_fd_io_uring_h
+#define HEADER_fd_src_util_io_uring_fd_io_uring_h
+
+/* fd_io_uring provides a minimal wrapper around the Linux io_uring
+   submission and completion rings.  It talks to the kernel directly via
+   the io_uring_{setup,enter,register} syscalls (no liburing
+   dependency) and exposes just enough API for a single threaded owner
+   to prepare submission queue entries (SQEs), submit them and reap
+   completion queue entries (CQEs) with no locking.
+
+   Typical usage:
+
+     fd_io_uring_t ring[1];
+     if( FD_UNLIKELY( !fd_io_uring_init( ring, depth, 0U ) ) ) ... handle error (logs details)
+
+     struct io_uring_sqe * sqe = fd_io_uring_sqe_get( ring ); // NULL if the SQ is full
+     ... fill in sqe ...
+     fd_io_uring_submit( ring, 0U );                           // non-blocking submit
+
+     struct io_uring_cqe * cqe = fd_io_uring_cqe_peek( ring ); // NULL if nothing completed
+     ... process cqe ...
+     fd_io_uring_cqe_seen( ring );
+
+     fd_io_uring_fini( ring );
+
+   The rings themselves are allocated and mapped by the kernel (they
+   do not live in a caller provided memory region).  As such, a
+   fd_io_uring_t is a process local object and cannot be shared between
+   processes. */
+
+#if defined(__linux__)
+
+#include "../bits/fd_bits.h"
+
+#include <linux/io_uring.h>
+#include <sys/uio.h>
+
+struct fd_io_uring {
+  int                   ring_fd;
+
+  /* Submission queue (kernel shared) */
+
+  uint *                sq_khead;
+  uint *                sq_ktail;
+  uint *                sq_array;
+  struct io_uring_sqe * sqe;
+  uint                  sq_mask;
+  uint                  sq_depth;
+  uint                  sq_tail;      /* Local tail (SQEs in [*sq_ktail,sq_tail) are prepared but not published) */
+
+  /* Completion queue (kernel shared) */
+
+  uint *                cq_khead;
+  uint *                cq_ktail;
+  struct io_uring_cqe * cqe;
+  uint                  cq_mask;
+  uint                  cq_depth;
+
+  /* Mappings (for fini) */
+
+  void *                sq_mem;
+  ulong                 sq_mem_sz;
+  void *                cq_mem;       /* ==sq_mem if the kernel supports a single mmap */
+  ulong                 cq_mem_sz;
+  ulong                 sqe_mem_sz;
+};
+
+typedef struct fd_io_uring fd_io_uring_t;
+
+FD_PROTOTYPES_BEGIN
+
+/* fd_io_uring_init creates a new io_uring instance with (at least)
+   depth submission queue entries and at least 2*depth completion queue
+   entries.  flags is a bit-or of IORING_SETUP_* flags.  Returns ring on
+   success and NULL on failure (logs details).  Reasons for failure
+   include the kernel not supporting io_uring, io_uring being disabled
+   via sysctl or seccomp and memory limits. */
+
+fd_io_uring_t *
+fd_io_uring_init( fd_io_uring_t * ring,
+                  uint            depth,
+                  uint            flags );
+
+/* fd_io_uring_fini tears down the ring, unmapping the shared rings and
+   closing the ring file descriptor.  Any operations still in flight
+   are cancelled by the kernel (the caller should drain the ring first
+   if it cares about their completion).  Returns ring. */
+
+fd_io_uring_t *
+fd_io_uring_fini( fd_io_uring_t * ring );
+
+/* fd_io_uring_register_buffers registers iov_cnt memory regions with
+   the ring for use by IORING_OP_{READ,WRITE}_FIXED (buf_index is the
+   index into iov).  Returns 0 on success and an errno compatible error
+   code on failure (logs details). */
+
+int
+fd_io_uring_register_buffers( fd_io_uring_t *      ring,
+                              struct iovec const * iov,
+                              uint                 iov_cnt );
+
+/* fd_io_uring_submit publishes all prepared SQEs to the kernel, asks
+   the kernel to consume all published SQEs it has not consumed yet and
+   then waits for at least wait_cnt completions to be available.
+   Returns the number of SQEs consumed by the kernel (non-negative) on
+   success and a negative errno on failure (EINTR and EAGAIN / EBUSY are
+   transient and can be retried, other errors are typically fatal).
+   The kernel can consume fewer SQEs than asked for; the remaining ones
+   are resubmitted by the next call (see fd_io_uring_sq_pending).  Does
+   not log. */
+
+int
+fd_io_uring_submit( fd_io_uring_t * ring,
+                    uint            wait_cnt );
+
+/* fd_io_uring_sq_free returns the number of SQEs that can currently be
+   prepared.  fd_io_uring_sqe_get returns a zeroed SQE for the caller to
+   fill in or NULL if the submission queue is full (the caller should
+   submit and try again).  The SQE is published to the kernel on the
+   next submit. */
+
+static inline uint
+fd_io_uring_sq_free( fd_io_uring_t const * ring ) {
+  uint khead = FD_VOLATILE_CONST( *ring->sq_khead );
+  return ring->sq_depth - (ring->sq_tail - khead);
+}
+
+/* fd_io_uring_sq_pending returns the number of SQEs that have been
+   prepared but not yet consumed by the kernel. */
+
+static inline uint
+fd_io_uring_sq_pending( fd_io_uring_t const * ring ) {
+  return ring->sq_tail - FD_VOLATILE_CONST( *ring->sq_khead );
+}
+
+static inline struct io_uring_sqe *
+fd_io_uring_sqe_get( fd_io_uring_t * ring ) {
+  if( FD_UNLIKELY( !fd_io_uring_sq_free( ring ) ) ) return NULL;
+  uint idx = ring->sq_tail & ring->sq_mask;
+  ring->sq_array[ idx ] = idx;
+  ring->sq_tail++;
+  struct io_uring_sqe * sqe = ring->sqe + idx;
+  memset( sqe, 0, sizeof(struct io_uring_sqe) );
+  return sqe;
+}
+
+/* fd_io_uring_sqe_prep_rw populates sqe for a simple read/write style
+   op (e.g. IORING_OP_{READ,WRITE,READ_FIXED,WRITE_FIXED}) of sz bytes
+   at file offset off of fd from/to buf.  For the FIXED variants,
+   buf_idx is the registered buffer index (ignored otherwise). */
+
+static inline void
+fd_io_uring_sqe_prep_rw( struct io_uring_sqe * sqe,
+                         int                   op,
+                         int                   fd,
+                         void const *          buf,
+                         ulong                 sz,
+                         ulong                 off,
+                         uint                  buf_idx,
+                         ulong                 user_data ) {
+  sqe->opcode    = (uchar)op;
+  sqe->fd        = fd;
+  sqe->off       = off;
+  sqe->addr      = (ulong)buf;
+  sqe->len       = (uint)sz;
+  sqe->buf_index = (ushort)buf_idx;
+  sqe->user_data = user_data;
+}
+
+/* fd_io_uring_cqe_peek returns the oldest unconsumed CQE or NULL if
+   there are none.  The returned CQE is valid until the matching
+   fd_io_uring_cqe_seen. */
+
+static inline struct io_uring_cqe *
+fd_io_uring_cqe_peek( fd_io_uring_t * ring ) {
+  uint head = *ring->cq_khead;
+  uint tail = FD_VOLATILE_CONST( *ring->cq_ktail );
+  FD_COMPILER_MFENCE();
+  if( head==tail ) return NULL;
+  return ring->cqe + (head & ring->cq_mask);
+}
+
+static inline void
+fd_io_uring_cqe_seen( fd_io_uring_t * ring ) {
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( *ring->cq_khead ) = *ring->cq_khead + 1U;
+}
+
+FD_PROTOTYPES_END
+
+#endif /* defined(__linux__) */
+
+#endif /* HEADER_fd_src_util_io_uring_fd_io_uring_h */
@@ -0,0 +1,125 @@
+#include "../fd_util.h"
+#include "fd_io_uring.h"
+
+#include <errno.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+static uchar buf0[ 65536 ] __attribute__((aligned(4096)));
+static uchar buf1[ 65536 ] __attribute__((aligned(4096)));
+
+/* reap pops one completion from ring (blocking), returning the
+   completion's user_data and res. */
+
+static ulong
+reap( fd_io_uring_t * ring,
+      int *           _res ) {
+  struct io_uring_cqe * cqe;
+  while( !(cqe = fd_io_uring_cqe_peek( ring )) ) FD_TEST( fd_io_uring_submit( ring, 1U )>=0 );
+  ulong user_data = cqe->user_data;
+  *_res = cqe->res;
+  fd_io_uring_cqe_seen( ring );
+  return user_data;
+}
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  uint depth = fd_env_strip_cmdline_uint( &argc, &argv, "--depth", NULL, 16U );
+
+  fd_rng_t _rng[1]; fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, 0U, 0UL ) );
+
+  FD_TEST( !fd_io_uring_init( NULL, depth, 0U ) );
+
+  fd_io_uring_t ring[1];
+  FD_TEST( !fd_io_uring_init( ring, 0U, 0U ) );
+
+  if( FD_UNLIKELY( !fd_io_uring_init( ring, depth, 0U ) ) ) {
+    FD_LOG_WARNING(( "skip: io_uring not available in this environment" ));
+    fd_rng_delete( fd_rng_leave( rng ) );
+    fd_halt();
+    return 0;
+  }
+
+  FD_TEST( ring->sq_depth>=depth    );
+  FD_TEST( ring->cq_depth>=2U*depth );
+  FD_TEST( fd_io_uring_sq_free( ring )==ring->sq_depth );
+  FD_TEST( !fd_io_uring_cqe_peek( ring ) );
+
+  char tmp_path[] = "/tmp/test_io_uring.XXXXXX";
+  int fd = mkstemp( tmp_path );
+  if( FD_UNLIKELY( fd==-1 ) ) FD_LOG_ERR(( "mkstemp failed (%i-%s)", errno, fd_io_strerror( errno ) ));
+  if( FD_UNLIKELY( unlink( tmp_path ) ) ) FD_LOG_ERR(( "unlink failed (%i-%s)", errno, fd_io_strerror( errno ) ));
+
+  FD_LOG_NOTICE(( "Testing nop" ));
+
+  for( uint i=0U; i<depth; i++ ) {
+    struct io_uring_sqe * sqe = fd_io_uring_sqe_get( ring );
+    FD_TEST( sqe );
+    sqe->opcode    = IORING_OP_NOP;
+    sqe->user_data = (ulong)i;
+  }
+  FD_TEST( !fd_io_uring_sqe_get( ring ) ); /* SQ full */
+  FD_TEST( fd_io_uring_submit( ring, depth )==(int)depth );
+  for( uint i=0U; i<depth; i++ ) {
+    int res;
+    FD_TEST( reap( ring, &res )==(ulong)i ); /* NOPs complete in order */
+    FD_TEST( !res );
+  }
+  FD_TEST( !fd_io_uring_cqe_peek( ring ) );
+
+  FD_LOG_NOTICE(( "Testing registered buffers" ));
+
+  struct iovec iov[2] = { { .iov_base = buf0, .iov_len = sizeof(buf0) },
+                          { .iov_base = buf1, .iov_len = sizeof(buf1) } };
+  FD_TEST( !fd_io_uring_register_buffers( ring, iov, 2U ) );
+
+  FD_LOG_NOTICE(( "Testing write / read" ));
+
+  for( ulong iter=0UL; iter<1000UL; iter++ ) {
+    ulong off = 4096UL*fd_rng_ulong_roll( rng, 16UL );
+    ulong sz  = 1UL + fd_rng_ulong_roll( rng, sizeof(buf0) );
+    int   fix = (int)fd_rng_uint_roll( rng, 2U );
+
+    for( ulong b=0UL; b<sz; b++ ) buf0[b] = fd_rng_uchar( rng );
+    memset( buf1, 0, sz );
+
+    struct io_uring_sqe * sqe = fd_io_uring_sqe_get( ring ); FD_TEST( sqe );
+    fd_io_uring_sqe_prep_rw( sqe, fix ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE, fd, buf0, sz, off, 0U, 1UL );
+    sqe->flags |= IOSQE_IO_LINK;
+
+    sqe = fd_io_uring_sqe_get( ring ); FD_TEST( sqe );
+    fd_io_uring_sqe_prep_rw( sqe, fix ? IORING_OP_READ_FIXED  : IORING_OP_READ,  fd, buf1, sz, off, 1U, 2UL );
+
+    FD_TEST( fd_io_uring_submit( ring, 2U )==2 );
+
+    int res;
+    FD_TEST( reap( ring, &res )==1UL ); FD_TEST( res==(int)sz );
+    FD_TEST( reap( ring, &res )==2UL ); FD_TEST( res==(int)sz );
+    FD_TEST( !memcmp( buf0, buf1, sz ) );
+  }
+
+  FD_LOG_NOTICE(( "Testing errors" ));
+
+  struct io_uring_sqe * sqe = fd_io_uring_sqe_get( ring ); FD_TEST( sqe );
+  fd_io_uring_sqe_prep_rw( sqe, IORING_OP_READ, -1, buf1, 4096UL, 0UL, 0U, 3UL );
+  FD_TEST( fd_io_uring_submit( ring, 1U )==1 );
+  int res;
+  FD_TEST( reap( ring, &res )==3UL ); FD_TEST( res==-EBADF );
+
+  FD_LOG_NOTICE(( "Testing fini" ));
+
+  FD_TEST( !fd_io_uring_fini( NULL ) );
+  FD_TEST( fd_io_uring_fini( ring )==ring );
+  FD_TEST( ring->ring_fd==-1 );
+
+  if( FD_UNLIKELY( close( fd ) ) ) FD_LOG_WARNING(( "close failed (%i-%s)", errno, fd_io_strerror( errno ) ));
+
+  fd_rng_delete( fd_rng_leave( rng ) );
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
@@ -0,0 +1,362 @@
+#include "fd_vinyl_compact.h"
+
+/* FD_VINYL_COMPACT_PEND_MAX is the max number of pairs relocated by a
+   call to fd_vinyl_compact whose meta element update is pending (i.e.
+   waiting for the relocated copy to be committed). */
+
+#define FD_VINYL_COMPACT_PEND_MAX (64UL)
+
+struct fd_vinyl_compact_pend {
+  ulong ele_idx; /* Meta element of the relocated pair */
+  ulong ctl;     /* Pair ctl at the new location */
+  ulong seq;     /* New location */
+};
+
+typedef struct fd_vinyl_compact_pend fd_vinyl_compact_pend_t;
+
+/* fd_vinyl_compact_private_publish commits all the appends in progress
+   on io and then points the meta elements of the pend_cnt pending
+   pairs at their relocated copies.  This ends io's read interest in
+   the cold buffer. */
+
+static void
+fd_vinyl_compact_private_publish( fd_vinyl_io_t *                 io,
+                                  fd_vinyl_meta_t *               meta,
+                                  fd_vinyl_compact_pend_t const * pend,
+                                  ulong                           pend_cnt ) {
+
+  int err = fd_vinyl_io_commit( io, FD_VINYL_IO_FLAG_BLOCKING );
+  if( FD_UNLIKELY( err ) ) FD_LOG_CRIT(( "fd_vinyl_io_commit failed (%i-%s)", err, fd_vinyl_strerror( err ) ));
+
+  fd_vinyl_meta_ele_t * ele0       = meta->ele;
+  ulong *               lock       = meta->lock;
+  int                   lock_shift = meta->lock_shift;
+
+  for( ulong pend_idx=0UL; pend_idx<pend_cnt; pend_idx++ ) {
+    ulong                 ele_idx = pend[ pend_idx ].ele_idx;
+    fd_vinyl_meta_ele_t * ele     = ele0 + ele_idx;
+
+    fd_vinyl_meta_prepare_fast( lock, lock_shift, ele_idx );
+    ele->phdr.ctl = pend[ pend_idx ].ctl;
+    ele->seq      = pend[ pend_idx ].seq;
+    fd_vinyl_meta_publish_fast( lock, lock_shift, ele_idx );
+  }
+}
+
+fd_vinyl_compact_t *
+fd_vinyl_compact_init( fd_vinyl_compact_t * c,
+                       ulong                dev_sz,
+                       ulong                garbage_sz,
+                       ulong                gc_thresh,
+                       int                  gc_lg_eps,
+                       float                bw_rate,
+                       long                 bw_burst,
+                       long                 now ) {
+
+  if( FD_UNLIKELY( !c ) ) {
+    FD_LOG_WARNING(( "NULL c" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !fd_ulong_is_aligned( dev_sz, FD_VINYL_BSTREAM_BLOCK_SZ ) ) ) {
+    FD_LOG_WARNING(( "misaligned dev_sz" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !((0<=gc_lg_eps) & (gc_lg_eps<=63)) ) ) {
+    FD_LOG_WARNING(( "bad gc_lg_eps" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !(bw_rate>=0.f) ) ) { /* Note: also catches NaN */
+    FD_LOG_WARNING(( "bad bw_rate" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( bw_burst<=0L ) ) {
+    FD_LOG_WARNING(( "bad bw_burst" ));
+    return NULL;
+  }
+
+  c->dev_sz     = dev_sz;
+  c->gc_thresh  = gc_thresh;
+  c->gc_lg_eps  = gc_lg_eps;
+  c->bw_rate    = bw_rate;
+  c->bw_burst   = bw_burst;
+  c->cold_style = FD_VINYL_BSTREAM_CTL_STYLE_RAW;
+  c->cold_max   = 0UL;
+  c->cold_buf   = NULL;
+
+  c->garbage_sz = garbage_sz;
+  c->bw_avail   = bw_burst;
+  c->bw_last    = now;
+
+  c->scan_cnt   = 0UL;
+  c->copy_cnt   = 0UL;
+  c->copy_sz    = 0UL;
+  c->free_sz    = 0UL;
+  c->cold_cnt   = 0UL;
+  c->cold_sz    = 0UL;
+
+  return c;
+}
+
+fd_vinyl_compact_t *
+fd_vinyl_compact_cold( fd_vinyl_compact_t * c,
+                       int                  style,
+                       void *               scratch,
+                       ulong                scratch_sz ) {
+
+  if( FD_UNLIKELY( !c ) ) {
+    FD_LOG_WARNING(( "NULL c" ));
+    return NULL;
+  }
+
+  switch( style ) {
+  case FD_VINYL_BSTREAM_CTL_STYLE_RAW:
+    c->cold_style = style;
+    c->cold_max   = 0UL;
+    c->cold_buf   = NULL;
+    return c;
+  case FD_VINYL_BSTREAM_CTL_STYLE_LZ4:
+    break;
+  default:
+    FD_LOG_WARNING(( "unsupported style" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !scratch ) ) {
+    FD_LOG_WARNING(( "NULL scratch" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !fd_ulong_is_aligned( (ulong)scratch, FD_VINYL_BSTREAM_BLOCK_SZ ) ) ) {
+    FD_LOG_WARNING(( "misaligned scratch" ));
+    return NULL;
+  }
+
+  ulong cold_max = fd_ulong_align_dn( scratch_sz, FD_VINYL_BSTREAM_BLOCK_SZ );
+  if( FD_UNLIKELY( cold_max<fd_vinyl_bstream_pair_sz( FD_VINYL_BSTREAM_LZ4_VAL_THRESH+1UL ) ) ) {
+    FD_LOG_WARNING(( "scratch_sz too small" ));
+    return NULL;
+  }
+
+  c->cold_style = style;
+  c->cold_max   = cold_max;
+  c->cold_buf   = (uchar *)scratch;
+
+  return c;
+}
+
+ulong
+fd_vinyl_compact( fd_vinyl_compact_t * c,
+                  fd_vinyl_io_t *      io,
+                  fd_vinyl_meta_t *    meta,
+                  long                 now,
+                  ulong                obj_max ) {
+
+  /* Refill the bandwidth budget */
+
+  long bw_burst = c->bw_burst;
+  long bw_avail = c->bw_avail;
+
+  long dt = now - c->bw_last;
+  if( FD_LIKELY( dt>0L ) ) {
+    float refill = ((float)dt) * c->bw_rate;
+    bw_avail = (refill < (float)(bw_burst - bw_avail)) ? (bw_avail + (long)refill) : bw_burst;
+    c->bw_last = now;
+  }
+
+  /* Visit objects at the start of the bstream's past until the space
+     overhead is back in bounds or we run out of budget.  Note that past
+     sizes below include copies made by this call (i.e. measured to
+     seq_future) as those will be in the past once committed. */
+
+  ulong seq_past0   = fd_vinyl_io_seq_past   ( io );
+  ulong seq_present = fd_vinyl_io_seq_present( io );
+  ulong io_seed     = fd_vinyl_io_seed       ( io );
+
+  ulong gc_thresh  = c->gc_thresh;
+  int   gc_lg_eps  = c->gc_lg_eps;
+  ulong dev_sz     = c->dev_sz;
+  ulong garbage_sz = c->garbage_sz;
+
+  fd_vinyl_meta_ele_t * ele0       = meta->ele;
+  ulong                 ele_max    = meta->ele_max;
+  ulong                 meta_seed  = meta->seed;
+
+  int     cold_style = c->cold_style;
+  ulong   cold_max   = c->cold_max;
+  uchar * cold_buf   = c->cold_buf;
+  int     cold_busy  = 0;  /* 1 if io might have a read interest in cold_buf */
+
+  /* Relocated pairs are only visible to meta readers once their copy
+     is committed (see fd_vinyl_compact_private_publish). */
+
+  fd_vinyl_compact_pend_t pend[ FD_VINYL_COMPACT_PEND_MAX ];
+  ulong                   pend_cnt = 0UL;
+
+  fd_vinyl_bstream_block_t block[1];
+
+  ulong seq = seq_past0;
+
+  for( ulong obj_rem=obj_max; obj_rem; obj_rem-- ) {
+
+    ulong past_sz = fd_vinyl_io_seq_future( io ) - seq;
+
+    if( FD_UNLIKELY( fd_vinyl_seq_ge( seq, seq_present ) | (past_sz<=gc_thresh) |
+                     (garbage_sz<=(past_sz>>gc_lg_eps)) | (bw_avail<=0L) ) ) break;
+
+    fd_vinyl_io_read_imm( io, seq, block, FD_VINYL_BSTREAM_BLOCK_SZ );
+    bw_avail -= (long)FD_VINYL_BSTREAM_BLOCK_SZ;
+    c->scan_cnt++;
+
+    ulong ctl = block->ctl;
+    ulong obj_sz;
+
+    switch( fd_vinyl_bstream_ctl_type( ctl ) ) {
+
+    case FD_VINYL_BSTREAM_CTL_TYPE_PAIR: {
+      obj_sz = fd_vinyl_bstream_pair_sz( fd_vinyl_bstream_ctl_sz( ctl ) );
+
+      FD_CRIT( obj_sz<=(seq_present-seq), "corruption detected" );
+
+      /* The version of the pair at seq is current if the meta says the
+         pair's most recent version is at seq.  If so, move it to the
+         head of the bstream.  Otherwise, it is garbage. */
+
+      ulong memo = fd_vinyl_key_memo( meta_seed, &block->phdr.key );
+      ulong ele_idx;
+      int   err  = fd_vinyl_meta_query_fast( ele0, ele_max, &block->phdr.key, memo, &ele_idx ); /* FD_LOG_CRIT on corruption */
+
+      fd_vinyl_meta_ele_t * ele = ele0 + ele_idx;
+
+      if( FD_LIKELY( (!err) && fd_vinyl_meta_ele_in_bstream( ele ) && ele->seq==seq ) ) {
+
+        FD_CRIT( ele->phdr.ctl==ctl, "corruption detected" );
+
+        /* If the store doesn't have room for the copy (e.g. compacted
+           blocks haven't been synced yet), stop here. */
+
+        ulong dev_free = dev_sz - (fd_vinyl_io_seq_future( io ) - fd_vinyl_io_seq_ancient( io ));
+        if( FD_UNLIKELY( obj_sz>dev_free ) ) goto done;
+
+        if( FD_UNLIKELY( pend_cnt==FD_VINYL_COMPACT_PEND_MAX ) ) {
+          fd_vinyl_compact_private_publish( io, meta, pend, pend_cnt );
+          pend_cnt  = 0UL;
+          cold_busy = 0;
+        }
+
+        /* If the pair is cold (not cached, so no client has used it
+           recently), stored raw and big enough to benefit, re-encode
+           it.  Otherwise (or if the pair didn't encode usefully), the
+           copy below is a plain bulk copy. */
+
+        ulong val_sz = (ulong)block->phdr.info._val_sz;
+
+        if( FD_UNLIKELY( (cold_style!=FD_VINYL_BSTREAM_CTL_STYLE_RAW)                       &
+                         (fd_vinyl_bstream_ctl_style( ctl )==FD_VINYL_BSTREAM_CTL_STYLE_RAW) &
+                         (!fd_vinyl_meta_ele_in_cache( ele ))                                &
+                         (val_sz>FD_VINYL_BSTREAM_LZ4_VAL_THRESH)                            &
+                         (obj_sz<=cold_max) ) ) {
+
+          /* If the last cold pair was appended in place from the cold
+             buffer, io has a read interest in it until the next
+             commit. */
+
+          if( FD_UNLIKELY( cold_busy ) ) {
+            fd_vinyl_compact_private_publish( io, meta, pend, pend_cnt );
+            pend_cnt  = 0UL;
+            cold_busy = 0;
+          }
+
+          fd_vinyl_bstream_phdr_t * phdr = (fd_vinyl_bstream_phdr_t *)cold_buf;
+          fd_vinyl_io_read_imm( io, seq, phdr, obj_sz );
+
+          char const * _err = fd_vinyl_bstream_pair_test( io_seed, seq, (fd_vinyl_bstream_block_t *)phdr, obj_sz );
+          if( FD_UNLIKELY( _err ) ) FD_LOG_CRIT(( "bstream corruption detected at seq %016lx (%s)", seq, _err ));
+
+          int   style;
+          ulong val_esz;
+          ulong seq_future = fd_vinyl_io_seq_future( io );
+          ulong seq_new    = fd_vinyl_io_append_pair_inplace( io, cold_style, phdr, &style, &val_esz );
+          ulong new_sz     = fd_vinyl_bstream_pair_sz( val_esz );
+
+          cold_busy = (style==FD_VINYL_BSTREAM_CTL_STYLE_RAW); /* Encoded pairs are appended from the io's spad */
+
+          /* Any zero padding the append needed is garbage */
+
+          garbage_sz += seq_new - seq_future;
+
+          pend[ pend_cnt ].ele_idx = ele_idx;
+          pend[ pend_cnt ].ctl     = fd_vinyl_bstream_ctl( FD_VINYL_BSTREAM_CTL_TYPE_PAIR, style, val_esz );
+          pend[ pend_cnt ].seq     = seq_new;
+          pend_cnt++;
+
+          bw_avail -= (long)(obj_sz + new_sz);
+          c->copy_cnt++;
+          c->copy_sz += new_sz;
+          if( FD_LIKELY( style!=FD_VINYL_BSTREAM_CTL_STYLE_RAW ) ) {
+            c->cold_cnt++;
+            c->cold_sz += obj_sz - new_sz;
+          }
+
+        } else {
+
+          pend[ pend_cnt ].ele_idx = ele_idx;
+          pend[ pend_cnt ].ctl     = ctl;
+          pend[ pend_cnt ].seq     = fd_vinyl_io_copy( io, seq, obj_sz );
+          pend_cnt++;
+
+          bw_avail -= (long)obj_sz;
+          c->copy_cnt++;
+          c->copy_sz += obj_sz;
+
+        }
+
+      } else {
+
+        garbage_sz  = fd_ulong_sat_sub( garbage_sz, obj_sz );
+        c->free_sz += obj_sz;
+
+      }
+
+      break;
+    }
+
+    case FD_VINYL_BSTREAM_CTL_TYPE_DEAD:
+    case FD_VINYL_BSTREAM_CTL_TYPE_MOVE:
+    case FD_VINYL_BSTREAM_CTL_TYPE_PART:
+    case FD_VINYL_BSTREAM_CTL_TYPE_ZPAD: {
+
+      /* Control blocks only refer to blocks before them.  Since
+         everything before seq has been forgotten, these are garbage. */
+
+      obj_sz      = FD_VINYL_BSTREAM_BLOCK_SZ;
+      garbage_sz  = fd_ulong_sat_sub( garbage_sz, obj_sz );
+      c->free_sz += obj_sz;
+      break;
+    }
+
+    default:
+      FD_LOG_CRIT(( "bstream corruption detected at seq %016lx (unexpected ctl %016lx, io_seed %016lx)", seq, ctl, io_seed ));
+    }
+
+    seq += obj_sz;
+  }
+
+done:
+  c->garbage_sz = garbage_sz;
+  c->bw_avail   = bw_avail;
+
+  if( FD_UNLIKELY( fd_vinyl_seq_eq( seq, seq_past0 ) ) ) return 0UL;
+
+  /* Make the copies part of the bstream's past, point the meta at them
+     and then forget the compacted region. */
+
+  fd_vinyl_compact_private_publish( io, meta, pend, pend_cnt );
+
+  fd_vinyl_io_forget( io, seq );
+
+  return seq - seq_past0;
+}
@@ -0,0 +1,164 @@
+#ifndef HEADER_fd_src_vinyl_compact_fd_vinyl_compact_h
+#define HEADER_fd_src_vinyl_compact_fd_vinyl_compact_h
+
+/* A fd_vinyl_compact_t incrementally compacts the bstream's past in the
+   background.  Each call to fd_vinyl_compact looks at the objects at
+   the start of the bstream's past (i.e. the oldest objects).  Objects
+   that are not needed for recovery ("garbage": pairs that have since
+   been replaced or erased and all control blocks) are dropped.  Pairs
+   that are still current are bulk copied to the bstream's head via
+   fd_vinyl_io_copy (no decode, rehash or caller memory traffic as the
+   bstream pair representation is relocatable) and the corresponding
+   meta element seq is updated.  The bstream's past is then forgotten up
+   to the first unprocessed object.
+
+   Space overhead: the bstream writer is responsible for accounting for
+   garbage as it is created (fd_vinyl_compact_garbage).  Compaction is
+   triggered when the past is larger than gc_thresh bytes and garbage is
+   more than a 2^-gc_lg_eps fraction of the past.  It runs until the
+   garbage fraction is back under this bound (or the per call budgets
+   below are exhausted).  In steady state, this bounds the bstream's
+   past to roughly (1+2^-gc_lg_eps) times the live pair bytes (e.g.
+   gc_lg_eps 2 bounds the space overhead to ~25%).  Smaller overheads
+   cost more write amplification (roughly 2^gc_lg_eps bytes of live
+   data copied per byte of garbage reclaimed).
+
+   Bandwidth budget: compaction reads and copies consume device
+   bandwidth that would otherwise be used by foreground reads and
+   appends.  To keep compaction from starving the foreground, a call
+   only proceeds while there is budget available in a token bucket that
+   refills at bw_rate bytes per ns up to bw_burst bytes (the caller
+   provides the time).  Each object visited costs a block and each
+   pair copied costs its pair size.  obj_max additionally bounds the
+   number of objects visited per call (bounding the worst case latency
+   of a call for a tile's run loop).
+
+   Compaction is expected to be run by the bstream writer (i.e. the
+   vinyl tile) while it has no reads in progress.  Concurrent meta
+   readers that speculatively read pairs out of the bstream (e.g. the
+   accdb rooted tier) are supported: a relocated pair's meta element
+   (ele->seq and, for a cold re-encoding, ele->phdr.ctl) is only
+   updated once the relocated copy has been committed and the update is
+   done under the element's lock.  The original location is forgotten
+   only after that.  Note that blocks forgotten by compaction are not
+   reusable until the next fd_vinyl_io_sync (i.e. they are in the
+   bstream's antiquity until then). */
+
+#include "../io/fd_vinyl_io.h"
+#include "../meta/fd_vinyl_meta.h"
+
+struct fd_vinyl_compact {
+
+  /* Config */
+
+  ulong   dev_sz;      /* bstream store capacity in bytes (used to avoid copying into a full store) */
+  ulong   gc_thresh;   /* Don't compact pasts smaller than this (in bytes) */
+  int     gc_lg_eps;   /* Compact when garbage_sz > past_sz >> gc_lg_eps, in [0,63] */
+  float   bw_rate;     /* Budget refill rate in bytes per ns, non-negative */
+  long    bw_burst;    /* Budget max in bytes, positive */
+  int     cold_style;  /* Style cold pairs are re-encoded in, RAW if cold encoding is disabled */
+  ulong   cold_max;    /* Max pair size that can be re-encoded (bytes in the cold buffer) */
+  uchar * cold_buf;    /* Cold buffer, NULL if cold encoding is disabled */
+
+  /* State */
+
+  ulong   garbage_sz;  /* Number of garbage bytes in the bstream's past */
+  long    bw_avail;    /* Budget available in bytes (can be negative after a large copy) */
+  long    bw_last;     /* Time the budget was last refilled */
+
+  /* Stats (cumulative) */
+
+  ulong   scan_cnt;    /* Number of bstream objects visited */
+  ulong   copy_cnt;    /* Number of current pairs copied to the head */
+  ulong   copy_sz;     /* Number of bytes copied to the head */
+  ulong   free_sz;     /* Number of garbage bytes forgotten */
+  ulong   cold_cnt;    /* Number of cold pairs re-encoded (included in copy_cnt) */
+  ulong   cold_sz;     /* Number of bstream bytes saved by re-encoding cold pairs */
+};
+
+typedef struct fd_vinyl_compact fd_vinyl_compact_t;
+
+FD_PROTOTYPES_BEGIN
+
+/* fd_vinyl_compact_init initializes a compactor at c for a bstream with
+   a dev_sz byte store that currently has garbage_sz bytes of garbage in
+   its past (e.g. past_sz - live pair bytes as determined at recovery,
+   zero for a new bstream).  See above for the meaning of the other
+   parameters.  now is the current time in ns (e.g. fd_log_wallclock).
+   The budget starts full and cold encoding is disabled.  Returns c on
+   success and NULL on failure (logs details). */
+
+fd_vinyl_compact_t *
+fd_vinyl_compact_init( fd_vinyl_compact_t * c,
+                       ulong                dev_sz,
+                       ulong                garbage_sz,
+                       ulong                gc_thresh,
+                       int                  gc_lg_eps,
+                       float                bw_rate,
+                       long                 bw_burst,
+                       long                 now );
+
+/* fd_vinyl_compact_cold configures c to re-encode cold pairs in the
+   given style (a FD_VINYL_BSTREAM_CTL_STYLE_*, RAW disables cold
+   encoding).  scratch points to scratch_sz bytes of
+   FD_VINYL_BSTREAM_BLOCK_SZ aligned memory the compactor uses to stage
+   pairs (pairs larger than scratch_sz are not re-encoded and
+   fd_vinyl_bstream_pair_sz( FD_VINYL_VAL_MAX ) covers all pairs).
+   Note that readers of the bstream must be able to decode any pair
+   that fits in scratch_sz (e.g. a reader decoding pairs into a buffer
+   sized for the largest val it expects should not be paired with a
+   larger scratch_sz).
+   Returns c on success (c will have a read/write interest in scratch
+   until the next call to fd_vinyl_compact_cold or c is no longer used)
+   and NULL on failure (logs details, c is unchanged). */
+
+fd_vinyl_compact_t *
+fd_vinyl_compact_cold( fd_vinyl_compact_t * c,
+                       int                  style,
+                       void *               scratch,
+                       ulong                scratch_sz );
+
+/* fd_vinyl_compact_garbage notes that sz more bytes in the bstream's
+   past (or present) have become garbage.  The bstream writer should
+   call this with the old pair_sz when replacing or erasing a pair and
+   with the number of control block bytes (dead, move, part, zero
+   padding) it appends. */
+
+static inline void
+fd_vinyl_compact_garbage( fd_vinyl_compact_t * c,
+                          ulong                sz ) {
+  c->garbage_sz += sz;
+}
+
+/* fd_vinyl_compact_needed returns 1 if the bstream's past currently
+   exceeds the compactor's space overhead bound and 0 otherwise. */
+
+FD_FN_PURE static inline int
+fd_vinyl_compact_needed( fd_vinyl_compact_t const * c,
+                         fd_vinyl_io_t const *      io ) {
+  ulong past_sz = io->seq_present - io->seq_past;
+  return (past_sz > c->gc_thresh) & (c->garbage_sz > (past_sz >> c->gc_lg_eps));
+}
+
+/* fd_vinyl_compact does an incremental round of compaction of io's
+   bstream's past.  meta is the meta cache for the bstream.  now is the
+   current time in ns.  obj_max is the max number of bstream objects to
+   visit.  Returns the number of bytes by which the bstream's past was
+   shrunk (i.e. how far seq_past was advanced).
+
+   Assumes the caller is the bstream's only writer and there are no
+   reads in progress on io.  Any appends in progress will be committed
+   (blocking).  A call can commit more than once (e.g. to reuse the
+   cold buffer or to publish a batch of relocated pairs to the meta).  Cannot fail from the caller's perspective (will
+   FD_LOG_CRIT if bstream or meta corruption is detected). */
+
+ulong
+fd_vinyl_compact( fd_vinyl_compact_t * c,
+                  fd_vinyl_io_t *      io,
+                  fd_vinyl_meta_t *    meta,
+                  long                 now,
+                  ulong                obj_max );
+
+FD_PROTOTYPES_END
+
+#endif /* HEADER_fd_src_vinyl_compact_fd_vinyl_compact_h */
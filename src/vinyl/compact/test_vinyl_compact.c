@@ -0,0 +1,367 @@
+#include "../fd_vinyl.h"
+
+#include <lz4.h>
+
+#define KEY_MAX    (256UL)
+#define ELE_MAX    (1024UL)
+#define VAL_MAX    (4096UL)
+#define DEV_SZ     (FD_VINYL_BSTREAM_BLOCK_SZ + (16UL<<20))
+#define SPAD_MAX   (65536UL)
+
+static uchar dev[ DEV_SZ ] __attribute__((aligned(FD_VINYL_BSTREAM_BLOCK_SZ)));
+static uchar io_mem[ 1UL<<17 ] __attribute__((aligned(FD_VINYL_BSTREAM_BLOCK_SZ)));
+static uchar meta_mem[ 1UL<<16 ] __attribute__((aligned(128)));
+static fd_vinyl_meta_ele_t ele_mem[ ELE_MAX ];
+
+static uchar pair_buf[ VAL_MAX + 2UL*FD_VINYL_BSTREAM_BLOCK_SZ ] __attribute__((aligned(FD_VINYL_BSTREAM_BLOCK_SZ)));
+static uchar val_buf [ VAL_MAX ];
+static uchar cold_mem[ VAL_MAX + 2UL*FD_VINYL_BSTREAM_BLOCK_SZ ] __attribute__((aligned(FD_VINYL_BSTREAM_BLOCK_SZ)));
+
+/* Reference model */
+
+static int   ref_live  [ KEY_MAX ];
+static ulong ref_ver   [ KEY_MAX ];
+static ulong ref_val_sz[ KEY_MAX ];
+
+/* val_gen generates the val of version ver of key k.  Odd keys get
+   compressible vals. */
+
+static void
+val_gen( ulong   k,
+         ulong   ver,
+         uchar * val,
+         ulong   val_sz ) {
+  ulong x = fd_ulong_hash( (k<<32) ^ ver );
+  if( k & 1UL ) for( ulong b=0UL; b<val_sz; b++ ) val[b] = (uchar)(x >> ((b & 7UL)<<3));
+  else          for( ulong b=0UL; b<val_sz; b++ ) { val[b] = (uchar)x; x = fd_ulong_hash( x ); }
+}
+
+static fd_vinyl_key_t *
+key_gen( fd_vinyl_key_t * key,
+         ulong            k ) {
+  return fd_vinyl_key_init_ulong( key, 0x0123456789abcdefUL, k, ~k, k*k );
+}
+
+/* ele_pair_sz returns the bstream footprint of the current version of
+   the pair described by ele (cold pairs might have been re-encoded). */
+
+static inline ulong
+ele_pair_sz( fd_vinyl_meta_ele_t const * ele ) {
+  return fd_vinyl_bstream_pair_sz( fd_vinyl_bstream_ctl_sz( ele->phdr.ctl ) );
+}
+
+/* live_sz returns the number of bytes of current pairs */
+
+static ulong
+live_sz( fd_vinyl_meta_t * meta ) {
+  ulong sz = 0UL;
+  for( ulong k=0UL; k<KEY_MAX; k++ ) {
+    if( !ref_live[k] ) continue;
+    fd_vinyl_key_t key[1]; key_gen( key, k );
+    ulong ele_idx;
+    FD_TEST( !fd_vinyl_meta_query_fast( meta->ele, meta->ele_max, key, fd_vinyl_key_memo( meta->seed, key ), &ele_idx ) );
+    sz += ele_pair_sz( meta->ele + ele_idx );
+  }
+  return sz;
+}
+
+/* verify commits io and checks the bstream, meta and compactor agree
+   with the reference model */
+
+static void
+verify( fd_vinyl_io_t *      io,
+        fd_vinyl_meta_t *    meta,
+        fd_vinyl_compact_t * c ) {
+  FD_TEST( !fd_vinyl_io_commit( io, FD_VINYL_IO_FLAG_BLOCKING ) );
+
+  ulong past_sz = fd_vinyl_io_seq_present( io ) - fd_vinyl_io_seq_past( io );
+  FD_TEST( c->garbage_sz==past_sz-live_sz( meta ) );
+
+  for( ulong k=0UL; k<KEY_MAX; k++ ) {
+    fd_vinyl_key_t key[1]; key_gen( key, k );
+    ulong memo = fd_vinyl_key_memo( meta->seed, key );
+    ulong ele_idx;
+    int   err  = fd_vinyl_meta_query_fast( meta->ele, meta->ele_max, key, memo, &ele_idx );
+    if( !ref_live[k] ) { FD_TEST( err==FD_VINYL_ERR_KEY ); continue; }
+    FD_TEST( !err );
+
+    fd_vinyl_meta_ele_t const * ele = meta->ele + ele_idx;
+    ulong pair_sz = ele_pair_sz( ele );
+
+    FD_TEST( fd_vinyl_seq_le( fd_vinyl_io_seq_past( io ), ele->seq ) );
+    FD_TEST( fd_vinyl_seq_le( ele->seq + pair_sz, fd_vinyl_io_seq_present( io ) ) );
+
+    fd_vinyl_io_read_imm( io, ele->seq, pair_buf, pair_sz );
+    FD_TEST( !fd_vinyl_bstream_pair_test( fd_vinyl_io_seed( io ), ele->seq, (fd_vinyl_bstream_block_t *)pair_buf, pair_sz ) );
+
+    fd_vinyl_bstream_phdr_t const * phdr = (fd_vinyl_bstream_phdr_t const *)pair_buf;
+    FD_TEST( fd_vinyl_key_eq( &phdr->key, key ) );
+    FD_TEST( phdr->ctl==ele->phdr.ctl );
+    FD_TEST( (ulong)phdr->info._val_sz==ref_val_sz[k] );
+
+    val_gen( k, ref_ver[k], val_buf, ref_val_sz[k] );
+
+    ulong val_esz = fd_vinyl_bstream_ctl_sz( phdr->ctl );
+    switch( fd_vinyl_bstream_ctl_style( phdr->ctl ) ) {
+    case FD_VINYL_BSTREAM_CTL_STYLE_RAW:
+      FD_TEST( val_esz==ref_val_sz[k] );
+      FD_TEST( !memcmp( phdr+1, val_buf, ref_val_sz[k] ) );
+      break;
+    case FD_VINYL_BSTREAM_CTL_STYLE_LZ4: {
+      static uchar dec_buf[ VAL_MAX ];
+      FD_TEST( c->cold_style==FD_VINYL_BSTREAM_CTL_STYLE_LZ4 );
+      FD_TEST( val_esz<ref_val_sz[k] );
+      FD_TEST( ele->line_idx==ULONG_MAX );
+      FD_TEST( LZ4_decompress_safe( (char const *)(phdr+1), (char *)dec_buf, (int)val_esz, (int)VAL_MAX )==(int)ref_val_sz[k] );
+      FD_TEST( !memcmp( dec_buf, val_buf, ref_val_sz[k] ) );
+      break;
+    }
+    default:
+      FD_LOG_ERR(( "unexpected style" ));
+    }
+  }
+}
+
+/* dev_free returns the number of bytes the bstream store has free */
+
+static ulong
+dev_free( fd_vinyl_io_t * io ) {
+  return fd_vinyl_mmio_sz( io ) - (fd_vinyl_io_seq_future( io ) - fd_vinyl_io_seq_ancient( io ));
+}
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  ulong iter_cnt  = fd_env_strip_cmdline_ulong( &argc, &argv, "--iter-cnt",  NULL, 200000UL );
+  int   gc_lg_eps = fd_env_strip_cmdline_int  ( &argc, &argv, "--gc-lg-eps", NULL, 2        );
+  ulong seed      = fd_env_strip_cmdline_ulong( &argc, &argv, "--seed",      NULL, 1234UL   );
+  char const * _cold = fd_env_strip_cmdline_cstr( &argc, &argv, "--cold",     NULL, "lz4"    );
+
+  int cold_style = fd_cstr_to_vinyl_bstream_ctl_style( _cold );
+
+  FD_LOG_NOTICE(( "Testing with --iter-cnt %lu --gc-lg-eps %i --seed %lu --cold %s", iter_cnt, gc_lg_eps, seed, _cold ));
+
+  fd_rng_t _rng[1]; fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, 0U, 0UL ) );
+
+  FD_TEST( fd_vinyl_io_mm_footprint( SPAD_MAX )<=sizeof(io_mem) );
+  fd_vinyl_io_t * io = fd_vinyl_io_mm_init( io_mem, SPAD_MAX, dev, DEV_SZ, 1, NULL, 0UL, seed );
+  FD_TEST( io );
+
+  ulong lock_cnt  = fd_vinyl_meta_lock_cnt_est ( ELE_MAX );
+  ulong probe_max = fd_vinyl_meta_probe_max_est( ELE_MAX );
+  FD_TEST( fd_vinyl_meta_footprint( ELE_MAX, lock_cnt, probe_max )<=sizeof(meta_mem) );
+  memset( ele_mem, 0, sizeof(ele_mem) );
+  FD_TEST( fd_vinyl_meta_new( meta_mem, ELE_MAX, lock_cnt, probe_max, seed )==meta_mem );
+  fd_vinyl_meta_t meta[1]; FD_TEST( fd_vinyl_meta_join( meta, meta_mem, ele_mem )==meta );
+
+  ulong dev_sz = fd_vinyl_mmio_sz( io );
+
+  FD_LOG_NOTICE(( "Testing init" ));
+
+  fd_vinyl_compact_t c[1];
+
+  long now = 0L;
+
+  FD_TEST( !fd_vinyl_compact_init( NULL, dev_sz,     0UL, 0UL, gc_lg_eps, 1.f,  65536L, now ) );
+  FD_TEST( !fd_vinyl_compact_init( c,    dev_sz-1UL, 0UL, 0UL, gc_lg_eps, 1.f,  65536L, now ) );
+  FD_TEST( !fd_vinyl_compact_init( c,    dev_sz,     0UL, 0UL, -1,        1.f,  65536L, now ) );
+  FD_TEST( !fd_vinyl_compact_init( c,    dev_sz,     0UL, 0UL, 64,        1.f,  65536L, now ) );
+  FD_TEST( !fd_vinyl_compact_init( c,    dev_sz,     0UL, 0UL, gc_lg_eps, -1.f, 65536L, now ) );
+  FD_TEST( !fd_vinyl_compact_init( c,    dev_sz,     0UL, 0UL, gc_lg_eps, 1.f,  0L,     now ) );
+
+  FD_TEST( fd_vinyl_compact_init( c, dev_sz, 0UL, 0UL, gc_lg_eps, 1.f, 65536L, now )==c );
+  FD_TEST( c->bw_avail==65536L );
+  FD_TEST( !fd_vinyl_compact_needed( c, io ) );
+  FD_TEST( !fd_vinyl_compact( c, io, meta, now, ULONG_MAX ) );
+
+  FD_LOG_NOTICE(( "Testing cold" ));
+
+  FD_TEST( c->cold_style==FD_VINYL_BSTREAM_CTL_STYLE_RAW );
+
+  FD_TEST( !fd_vinyl_compact_cold( NULL, FD_VINYL_BSTREAM_CTL_STYLE_LZ4, cold_mem,       sizeof(cold_mem) ) );
+  FD_TEST( !fd_vinyl_compact_cold( c,    -1,                             cold_mem,       sizeof(cold_mem) ) );
+  FD_TEST( !fd_vinyl_compact_cold( c,    FD_VINYL_BSTREAM_CTL_STYLE_LZ4, NULL,           sizeof(cold_mem) ) );
+  FD_TEST( !fd_vinyl_compact_cold( c,    FD_VINYL_BSTREAM_CTL_STYLE_LZ4, cold_mem+1,     sizeof(cold_mem) ) );
+  FD_TEST( !fd_vinyl_compact_cold( c,    FD_VINYL_BSTREAM_CTL_STYLE_LZ4, cold_mem,       FD_VINYL_BSTREAM_BLOCK_SZ ) );
+  FD_TEST( c->cold_style==FD_VINYL_BSTREAM_CTL_STYLE_RAW );
+
+  FD_TEST( fd_vinyl_compact_cold( c, FD_VINYL_BSTREAM_CTL_STYLE_LZ4, cold_mem, sizeof(cold_mem) )==c );
+  FD_TEST( c->cold_style==FD_VINYL_BSTREAM_CTL_STYLE_LZ4 );
+  FD_TEST( c->cold_max  ==sizeof(cold_mem)                );
+  FD_TEST( fd_vinyl_compact_cold( c, FD_VINYL_BSTREAM_CTL_STYLE_RAW, NULL, 0UL )==c );
+  FD_TEST( c->cold_style==FD_VINYL_BSTREAM_CTL_STYLE_RAW );
+
+  FD_TEST( fd_vinyl_compact_cold( c, cold_style, cold_mem, sizeof(cold_mem) )==c );
+
+  FD_LOG_NOTICE(( "Testing churn" ));
+
+  ulong part_seq = 0UL;
+
+  for( ulong iter=0UL; iter<iter_cnt; iter++ ) {
+    ulong r = fd_rng_ulong( rng );
+    ulong k = fd_rng_ulong_roll( rng, KEY_MAX );
+
+    fd_vinyl_key_t key[1]; key_gen( key, k );
+    ulong memo = fd_vinyl_key_memo( meta->seed, key );
+
+    /* Make sure there is room for the worst case op */
+
+    while( FD_UNLIKELY( dev_free( io ) < 2UL*fd_vinyl_bstream_pair_sz( VAL_MAX ) ) ) {
+      now += 1000000000L;
+      fd_vinyl_compact( c, io, meta, now, ULONG_MAX );
+      FD_TEST( !fd_vinyl_io_sync( io, FD_VINYL_IO_FLAG_BLOCKING ) );
+    }
+
+    ulong seq_future = fd_vinyl_io_seq_future( io );
+
+    int op = (int)(r & 15UL); r >>= 4;
+    switch( op ) {
+
+    case 0: { /* erase */
+      ulong ele_idx;
+      int   err = fd_vinyl_meta_query_fast( meta->ele, meta->ele_max, key, memo, &ele_idx );
+      if( !ref_live[k] ) { FD_TEST( err==FD_VINYL_ERR_KEY ); break; }
+      FD_TEST( !err );
+      fd_vinyl_meta_ele_t * ele = meta->ele + ele_idx;
+      ulong seq = fd_vinyl_io_append_dead( io, &ele->phdr, NULL, 0UL );
+      fd_vinyl_compact_garbage( c, (seq - seq_future) + FD_VINYL_BSTREAM_BLOCK_SZ + ele_pair_sz( ele ) );
+      fd_vinyl_meta_remove_fast( meta->ele, meta->ele_max, meta->lock, meta->lock_shift, NULL, 0UL, ele_idx );
+      ref_live[k] = 0;
+      break;
+    }
+
+    case 1: { /* partition */
+      ulong seq = fd_vinyl_io_append_part( io, part_seq, 0UL, 0UL, NULL, 0UL );
+      fd_vinyl_compact_garbage( c, (seq - seq_future) + FD_VINYL_BSTREAM_BLOCK_SZ );
+      part_seq = seq;
+      break;
+    }
+
+    case 2: { /* commit */
+      FD_TEST( !fd_vinyl_io_commit( io, FD_VINYL_IO_FLAG_BLOCKING ) );
+      break;
+    }
+
+    case 3: { /* sync */
+      FD_TEST( !fd_vinyl_io_commit( io, FD_VINYL_IO_FLAG_BLOCKING ) );
+      FD_TEST( !fd_vinyl_io_sync  ( io, FD_VINYL_IO_FLAG_BLOCKING ) );
+      break;
+    }
+
+    case 4: case 5: { /* compact */
+      now += (long)fd_rng_ulong_roll( rng, 100000UL );
+      ulong seq_past = fd_vinyl_io_seq_past( io );
+      ulong sz = fd_vinyl_compact( c, io, meta, now, 1UL + fd_rng_ulong_roll( rng, 64UL ) );
+      FD_TEST( fd_vinyl_io_seq_past( io )==seq_past+sz );
+      break;
+    }
+
+    default: { /* upsert */
+      ulong val_sz = fd_rng_ulong_roll( rng, VAL_MAX+1UL );
+      ulong ver    = ref_ver[k] + 1UL;
+      val_gen( k, ver, val_buf, val_sz );
+
+      fd_vinyl_info_t info[1]; memset( info, 0, sizeof(fd_vinyl_info_t) );
+      info->_val_sz = (uint)val_sz;
+
+      ulong ele_idx;
+      int   err = fd_vinyl_meta_query_fast( meta->ele, meta->ele_max, key, memo, &ele_idx );
+      FD_TEST( err==(ref_live[k] ? FD_VINYL_SUCCESS : FD_VINYL_ERR_KEY) );
+      fd_vinyl_meta_ele_t * ele = meta->ele + ele_idx;
+
+      ulong seq = fd_vinyl_io_append_pair_raw( io, key, info, val_buf );
+
+      ulong garbage_sz = seq - seq_future;
+      if( ref_live[k] ) garbage_sz += ele_pair_sz( ele );
+      fd_vinyl_compact_garbage( c, garbage_sz );
+
+      if( err ) {
+        ele->memo     = memo;
+        ele->phdr.key = *key;
+        ele->line_idx = ULONG_MAX;
+      }
+      ele->phdr.info = *info;
+      ele->seq       = seq;
+      FD_COMPILER_MFENCE();
+      ele->phdr.ctl  = fd_vinyl_bstream_ctl( FD_VINYL_BSTREAM_CTL_TYPE_PAIR, FD_VINYL_BSTREAM_CTL_STYLE_RAW, val_sz );
+
+      ref_live  [k] = 1;
+      ref_ver   [k] = ver;
+      ref_val_sz[k] = val_sz;
+      break;
+    }
+
+    }
+
+    if( FD_UNLIKELY( !(iter & 4095UL) ) ) verify( io, meta, c );
+  }
+
+  verify( io, meta, c );
+
+  FD_LOG_NOTICE(( "scan_cnt %lu copy_cnt %lu copy_sz %lu free_sz %lu cold_cnt %lu cold_sz %lu garbage_sz %lu past_sz %lu live_sz %lu",
+                  c->scan_cnt, c->copy_cnt, c->copy_sz, c->free_sz, c->cold_cnt, c->cold_sz, c->garbage_sz,
+                  fd_vinyl_io_seq_present( io ) - fd_vinyl_io_seq_past( io ), live_sz( meta ) ));
+  if( cold_style!=FD_VINYL_BSTREAM_CTL_STYLE_RAW ) FD_TEST( c->cold_cnt && c->cold_sz );
+  else                                             FD_TEST( !c->cold_cnt );
+
+  FD_LOG_NOTICE(( "Testing space bound" ));
+
+  FD_TEST( !fd_vinyl_io_sync( io, FD_VINYL_IO_FLAG_BLOCKING ) );
+  now += 1000000000L;
+  fd_vinyl_compact( c, io, meta, now, ULONG_MAX );
+  FD_TEST( !fd_vinyl_compact_needed( c, io ) );
+  FD_TEST( !fd_vinyl_compact( c, io, meta, now, ULONG_MAX ) );
+  verify( io, meta, c );
+
+  FD_LOG_NOTICE(( "Testing bandwidth budget" ));
+
+  /* Overwrite everything to create lots of garbage */
+
+  for( ulong k=0UL; k<KEY_MAX; k++ ) {
+    fd_vinyl_key_t key[1]; key_gen( key, k );
+    if( !ref_live[k] ) continue;
+    ulong ele_idx;
+    FD_TEST( !fd_vinyl_meta_query_fast( meta->ele, meta->ele_max, key, fd_vinyl_key_memo( meta->seed, key ), &ele_idx ) );
+    fd_vinyl_meta_ele_t * ele = meta->ele + ele_idx;
+    ulong seq = fd_vinyl_io_append_dead( io, &ele->phdr, NULL, 0UL );
+    FD_TEST( seq==fd_vinyl_io_seq_future( io )-FD_VINYL_BSTREAM_BLOCK_SZ );
+    fd_vinyl_compact_garbage( c, FD_VINYL_BSTREAM_BLOCK_SZ + ele_pair_sz( ele ) );
+    fd_vinyl_meta_remove_fast( meta->ele, meta->ele_max, meta->lock, meta->lock_shift, NULL, 0UL, ele_idx );
+    ref_live[k] = 0;
+  }
+  FD_TEST( !fd_vinyl_io_commit( io, FD_VINYL_IO_FLAG_BLOCKING ) );
+  FD_TEST( fd_vinyl_compact_needed( c, io ) );
+
+  /* With no refill, a call should stop as soon as the budget is
+     exhausted */
+
+  c->bw_rate = 0.f;
+  c->bw_avail = 4L*(long)FD_VINYL_BSTREAM_BLOCK_SZ;
+  ulong scan_cnt = c->scan_cnt;
+  FD_TEST( fd_vinyl_compact( c, io, meta, now+1L, ULONG_MAX ) );
+  FD_TEST( c->scan_cnt-scan_cnt==4UL );
+  FD_TEST( c->bw_avail<=0L );
+  FD_TEST( !fd_vinyl_compact( c, io, meta, now+2L, ULONG_MAX ) );
+
+  /* With a refill, compaction can finish */
+
+  c->bw_rate = 1.f;
+  while( fd_vinyl_compact_needed( c, io ) ) {
+    now += 1000000L;
+    fd_vinyl_compact( c, io, meta, now, ULONG_MAX );
+  }
+  FD_TEST( c->bw_avail<=c->bw_burst );
+  verify( io, meta, c );
+
+  FD_TEST( fd_vinyl_io_fini( io )==io_mem );
+  fd_vinyl_meta_leave( meta );
+  fd_vinyl_meta_delete( meta_mem );
+
+  fd_rng_delete( fd_rng_leave( rng ) );
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
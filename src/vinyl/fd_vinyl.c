@@ -0,0 +1,909 @@
+#include "fd_vinyl.h"
+#include <errno.h>
+#include <lz4.h>
+
+/* FD_VINYL_COMPACT_OBJ_MAX bounds the number of bstream objects
+   visited by a single round of background compaction (bounds the
+   latency housekeeping adds to request processing). */
+
+#define FD_VINYL_COMPACT_OBJ_MAX (1024UL)
+
+ulong
+fd_vinyl_align( void ) {
+  return FD_VINYL_ALIGN;
+}
+
+ulong
+fd_vinyl_footprint( ulong line_cnt,
+                    ulong val_max ) {
+  if( FD_UNLIKELY( !((1UL<=line_cnt) & (line_cnt<=FD_VINYL_LINE_MAX) & (val_max<=FD_VINYL_VAL_MAX)) ) ) return 0UL;
+  return FD_LAYOUT_FINI( FD_LAYOUT_APPEND( FD_LAYOUT_APPEND( FD_LAYOUT_APPEND( FD_LAYOUT_APPEND( FD_LAYOUT_INIT,
+    FD_VINYL_ALIGN,            sizeof(fd_vinyl_t)                                  ),
+    alignof(fd_vinyl_line_t),  line_cnt*sizeof(fd_vinyl_line_t)                    ),
+    alignof(fd_vinyl_io_rd_t), FD_VINYL_REQ_BATCH_MAX*sizeof(fd_vinyl_io_rd_t)     ),
+    FD_VINYL_ALIGN,            fd_vinyl_line_data_sz( val_max )                    ),
+    FD_VINYL_ALIGN );
+}
+
+ulong
+fd_vinyl_data_align( void ) {
+  return FD_VINYL_BSTREAM_BLOCK_SZ;
+}
+
+ulong
+fd_vinyl_data_footprint( ulong line_cnt,
+                         ulong val_max ) {
+  if( FD_UNLIKELY( !((1UL<=line_cnt) & (line_cnt<=FD_VINYL_LINE_MAX) & (val_max<=FD_VINYL_VAL_MAX)) ) ) return 0UL;
+  return line_cnt*fd_vinyl_line_data_sz( val_max ); /* no overflow given above */
+}
+
+fd_vinyl_t *
+fd_vinyl_init( void *               lmem,
+               ulong                line_cnt,
+               ulong                val_max,
+               fd_vinyl_io_t *      io,
+               ulong                dev_sz,
+               fd_vinyl_meta_t *    meta,
+               void *               data,
+               fd_vinyl_compact_t * compact ) {
+
+  if( FD_UNLIKELY( !lmem ) ) {
+    FD_LOG_WARNING(( "NULL lmem" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !fd_ulong_is_aligned( (ulong)lmem, fd_vinyl_align() ) ) ) {
+    FD_LOG_WARNING(( "misaligned lmem" ));
+    return NULL;
+  }
+
+  ulong footprint = fd_vinyl_footprint( line_cnt, val_max );
+  if( FD_UNLIKELY( !footprint ) ) {
+    FD_LOG_WARNING(( "bad line_cnt or val_max" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !io ) ) {
+    FD_LOG_WARNING(( "NULL io" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !((0UL<dev_sz) & fd_ulong_is_aligned( dev_sz, FD_VINYL_BSTREAM_BLOCK_SZ )) ) ) {
+    FD_LOG_WARNING(( "bad dev_sz" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !meta ) ) {
+    FD_LOG_WARNING(( "NULL meta" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !data ) ) {
+    FD_LOG_WARNING(( "NULL data" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !fd_ulong_is_aligned( (ulong)data, fd_vinyl_data_align() ) ) ) {
+    FD_LOG_WARNING(( "misaligned data" ));
+    return NULL;
+  }
+
+  /* Reset the tile-only meta element fields and count the pairs.  Keys
+     that were in the process of being created indicate the meta was
+     not properly recovered. */
+
+  fd_vinyl_meta_ele_t * ele0    = meta->ele;
+  ulong                 ele_max = meta->ele_max;
+
+  ulong pair_cnt = 0UL;
+  for( ulong ele_idx=0UL; ele_idx<ele_max; ele_idx++ ) {
+    fd_vinyl_meta_ele_t * ele = ele0 + ele_idx;
+    if( !fd_vinyl_meta_ele_in_use( ele ) ) continue;
+    if( FD_UNLIKELY( !fd_vinyl_meta_ele_in_bstream( ele ) ) ) {
+      FD_LOG_WARNING(( "meta has keys being created" ));
+      return NULL;
+    }
+    ele->line_idx = ULONG_MAX;
+    pair_cnt++;
+  }
+
+  if( FD_UNLIKELY( pair_cnt>=ele_max ) ) {
+    FD_LOG_WARNING(( "meta is overfull" ));
+    return NULL;
+  }
+
+  FD_SCRATCH_ALLOC_INIT( l, lmem );
+  fd_vinyl_t *       vinyl   = FD_SCRATCH_ALLOC_APPEND( l, FD_VINYL_ALIGN,            sizeof(fd_vinyl_t)                              );
+  fd_vinyl_line_t *  line    = FD_SCRATCH_ALLOC_APPEND( l, alignof(fd_vinyl_line_t),  line_cnt*sizeof(fd_vinyl_line_t)                );
+  fd_vinyl_io_rd_t * rd      = FD_SCRATCH_ALLOC_APPEND( l, alignof(fd_vinyl_io_rd_t), FD_VINYL_REQ_BATCH_MAX*sizeof(fd_vinyl_io_rd_t) );
+  uchar *            scratch = FD_SCRATCH_ALLOC_APPEND( l, FD_VINYL_ALIGN,            fd_vinyl_line_data_sz( val_max )                );
+  FD_TEST( FD_SCRATCH_ALLOC_FINI( l, FD_VINYL_ALIGN )==(ulong)lmem + footprint );
+
+  memset( vinyl, 0, sizeof(fd_vinyl_t) );
+
+  vinyl->io        = io;
+  vinyl->meta      = meta;
+  vinyl->compact   = compact;
+  vinyl->dev_sz    = dev_sz;
+
+  vinyl->data      = (uchar *)data;
+  vinyl->val_max   = val_max;
+  vinyl->line_sz   = fd_vinyl_line_data_sz( val_max );
+  vinyl->line_cnt  = line_cnt;
+  vinyl->line_free = 0UL;
+  vinyl->line_hand = 0UL;
+  vinyl->line      = line;
+
+  vinyl->rd        = rd;
+  vinyl->scratch   = scratch;
+
+  vinyl->pair_cnt  = pair_cnt;
+  vinyl->pair_max  = ele_max - 1UL; /* keep at least one hole for meta probing */
+  vinyl->dirty     = 0;
+
+  vinyl->part_thresh   = FD_VINYL_PART_THRESH_DEFAULT;
+  vinyl->part_seq0     = fd_vinyl_recover_tail( io );
+  vinyl->part_dead_cnt = 0UL;
+
+  for( ulong line_idx=0UL; line_idx<line_cnt; line_idx++ ) {
+    line[ line_idx ].ele_idx  = ULONG_MAX;
+    line[ line_idx ].ref      = 0L;
+    line[ line_idx ].next_idx = fd_ulong_if( line_idx<line_cnt-1UL, line_idx+1UL, ULONG_MAX );
+    line[ line_idx ].used     = 0;
+  }
+
+  FD_LOG_INFO(( "vinyl config"
+                "\n\tline_cnt %lu"
+                "\n\tval_max  %lu"
+                "\n\tdev_sz   %lu"
+                "\n\tpair_cnt %lu"
+                "\n\tpair_max %lu"
+                "\n\tcompact  %s",
+                line_cnt, val_max, dev_sz, pair_cnt, vinyl->pair_max, compact ? "on" : "off" ));
+
+  return vinyl;
+}
+
+/* fd_vinyl_private_line_release unbinds line line_idx from its meta
+   element and returns it to the free list. */
+
+static inline void
+fd_vinyl_private_line_release( fd_vinyl_t * vinyl,
+                               ulong        line_idx ) {
+  fd_vinyl_line_t * line = vinyl->line + line_idx;
+
+  vinyl->meta->ele[ line->ele_idx ].line_idx = ULONG_MAX;
+
+  line->ele_idx  = ULONG_MAX;
+  line->ref      = 0L;
+  line->next_idx = vinyl->line_free;
+  line->used     = 0;
+
+  vinyl->line_free = line_idx;
+}
+
+/* fd_vinyl_private_line_evict evicts a cached line chosen by the clock
+   hand, returning it to the free list.  Returns 1 on success and 0 if
+   all lines are acquired.  Assumes there are no free lines (so all
+   lines are bound).  At most two revolutions of the hand are needed
+   (the first clears used on all cached lines). */
+
+static int
+fd_vinyl_private_line_evict( fd_vinyl_t * vinyl ) {
+  fd_vinyl_line_t * line     = vinyl->line;
+  ulong             line_cnt = vinyl->line_cnt;
+  ulong             hand     = vinyl->line_hand;
+
+  for( ulong rem=2UL*line_cnt; rem; rem-- ) {
+    ulong line_idx = hand;
+    hand = fd_ulong_if( hand+1UL<line_cnt, hand+1UL, 0UL );
+
+    fd_vinyl_line_t * l = line + line_idx;
+    if( l->ref  ) continue;                 /* pinned */
+    if( l->used ) { l->used = 0; continue; } /* second chance */
+
+    vinyl->line_hand = hand;
+    fd_vinyl_private_line_release( vinyl, line_idx );
+    vinyl->metrics.evict_cnt++;
+    return 1;
+  }
+
+  vinyl->line_hand = hand;
+  return 0;
+}
+
+/* fd_vinyl_private_line_acquire binds a line to meta element ele_idx
+   with the given ref count, evicting a cached line if there are no
+   free lines.  Returns the line index of the bound line or ULONG_MAX
+   if all lines are acquired. */
+
+static inline ulong
+fd_vinyl_private_line_acquire( fd_vinyl_t * vinyl,
+                               ulong        ele_idx,
+                               long         ref ) {
+  ulong line_idx = vinyl->line_free;
+  if( FD_UNLIKELY( line_idx==ULONG_MAX ) ) {
+    if( FD_UNLIKELY( !fd_vinyl_private_line_evict( vinyl ) ) ) return ULONG_MAX;
+    line_idx = vinyl->line_free;
+  }
+
+  fd_vinyl_line_t * line = vinyl->line + line_idx;
+  vinyl->line_free = line->next_idx;
+
+  line->ele_idx  = ele_idx;
+  line->ref      = ref;
+  line->next_idx = ULONG_MAX;
+  line->used     = 1;
+
+  vinyl->meta->ele[ ele_idx ].line_idx = line_idx;
+  return line_idx;
+}
+
+/* fd_vinyl_private_reserve returns 1 if there is room in the bstream's
+   store to append sz more bytes and 0 otherwise.  If there isn't room,
+   this will try to reclaim space forgotten since the last sync. */
+
+static int
+fd_vinyl_private_reserve( fd_vinyl_t * vinyl,
+                          ulong        sz ) {
+  fd_vinyl_io_t * io = vinyl->io;
+
+  if( FD_LIKELY( (fd_vinyl_io_seq_future( io ) - fd_vinyl_io_seq_ancient( io )) + sz <= vinyl->dev_sz ) ) return 1;
+
+  int err = fd_vinyl_io_commit( io, FD_VINYL_IO_FLAG_BLOCKING );
+  if( FD_UNLIKELY( err ) ) FD_LOG_CRIT(( "fd_vinyl_io_commit failed (%i-%s)", err, fd_vinyl_strerror( err ) ));
+
+  err = fd_vinyl_io_sync( io, FD_VINYL_IO_FLAG_BLOCKING );
+  if( FD_UNLIKELY( err ) ) FD_LOG_CRIT(( "fd_vinyl_io_sync failed (%i-%s)", err, fd_vinyl_strerror( err ) ));
+  vinyl->dirty = 0;
+  vinyl->metrics.sync_cnt++;
+
+  return (fd_vinyl_io_seq_future( io ) - fd_vinyl_io_seq_ancient( io )) + sz <= vinyl->dev_sz;
+}
+
+/* fd_vinyl_private_line_fill completes a read of a pair into a line,
+   validating the pair and decoding the val in place. */
+
+static void
+fd_vinyl_private_line_fill( fd_vinyl_t *       vinyl,
+                            fd_vinyl_io_rd_t * rd ) {
+
+  fd_vinyl_line_t *           line = vinyl->line + rd->ctx;
+  fd_vinyl_meta_ele_t const * ele  = vinyl->meta->ele + line->ele_idx;
+
+  fd_vinyl_bstream_phdr_t * phdr = (fd_vinyl_bstream_phdr_t *)rd->dst;
+
+  char const * _err = fd_vinyl_bstream_pair_test( fd_vinyl_io_seed( vinyl->io ), rd->seq, (fd_vinyl_bstream_block_t *)phdr, rd->sz );
+  if( FD_UNLIKELY( _err ) ) FD_LOG_CRIT(( "bstream corruption detected at seq %016lx (%s)", rd->seq, _err ));
+
+  ulong ctl = phdr->ctl;
+
+  FD_CRIT( ctl==ele->phdr.ctl,                             "corruption detected" );
+  FD_CRIT( fd_vinyl_key_eq( &phdr->key, &ele->phdr.key ), "corruption detected" );
+
+  ulong val_sz  = (ulong)phdr->info._val_sz;
+  ulong val_esz = fd_vinyl_bstream_ctl_sz( ctl );
+
+  switch( fd_vinyl_bstream_ctl_style( ctl ) ) {
+
+  case FD_VINYL_BSTREAM_CTL_STYLE_RAW: {
+    FD_CRIT( val_esz==val_sz, "corruption detected" );
+    break;
+  }
+
+  case FD_VINYL_BSTREAM_CTL_STYLE_LZ4: {
+    uchar * val = (uchar *)(phdr+1);
+    int     dsz = LZ4_decompress_safe( (char const *)val, (char *)vinyl->scratch, (int)val_esz, (int)val_sz );
+    if( FD_UNLIKELY( dsz!=(int)val_sz ) ) FD_LOG_CRIT(( "bstream corruption detected at seq %016lx (lz4 decode failed)", rd->seq ));
+    memcpy( val, vinyl->scratch, val_sz );
+    break;
+  }
+
+  default:
+    FD_LOG_CRIT(( "bstream corruption detected at seq %016lx (unsupported style %s)",
+                  rd->seq, fd_vinyl_bstream_ctl_style_cstr( fd_vinyl_bstream_ctl_style( ctl ) ) ));
+  }
+
+  phdr->ctl = fd_vinyl_bstream_ctl( FD_VINYL_BSTREAM_CTL_TYPE_PAIR, FD_VINYL_BSTREAM_CTL_STYLE_RAW, val_sz );
+}
+
+static ulong
+fd_vinyl_private_acquire( fd_vinyl_t *           vinyl,
+                          ulong                  flags,
+                          fd_vinyl_key_t const * key,
+                          ulong                  batch_cnt,
+                          ulong *                val_off,
+                          schar *                key_err ) {
+
+  int modify = !!(flags & FD_VINYL_REQ_FLAG_MODIFY);
+  int create = modify && !!(flags & FD_VINYL_REQ_FLAG_CREATE);
+  int ignore = modify && !!(flags & FD_VINYL_REQ_FLAG_IGNORE);
+
+  fd_vinyl_io_t *       io        = vinyl->io;
+  fd_vinyl_meta_ele_t * ele0      = vinyl->meta->ele;
+  ulong                 ele_max   = vinyl->meta->ele_max;
+  ulong                 meta_seed = vinyl->meta->seed;
+  ulong                 line_sz   = vinyl->line_sz;
+  ulong                 val_max   = vinyl->val_max;
+
+  ulong fail_cnt = 0UL;
+  ulong rd_cnt   = 0UL;
+
+  for( ulong batch_idx=0UL; batch_idx<batch_cnt; batch_idx++ ) {
+
+    fd_vinyl_key_t key_i = key[ batch_idx ]; /* Copy out from the client's memory */
+
+    ulong memo = fd_vinyl_key_memo( meta_seed, &key_i );
+    ulong ele_idx;
+    int   err  = fd_vinyl_meta_query_fast( ele0, ele_max, &key_i, memo, &ele_idx ); /* FD_LOG_CRIT on corruption */
+
+    fd_vinyl_meta_ele_t * ele = ele0 + ele_idx;
+
+    ulong line_idx;
+
+    if( FD_LIKELY( !err ) ) {
+
+      line_idx = ele->line_idx;
+
+      if( line_idx!=ULONG_MAX ) {
+
+        /* Key is cached or already acquired by a client (note that keys
+           being created are always acquired).  Readers can share the
+           line.  Cached lines hold the key's current version. */
+
+        fd_vinyl_line_t * line = vinyl->line + line_idx;
+        long              ref  = line->ref;
+        if( FD_UNLIKELY( (ref<0L) | (modify & (ref>0L)) ) ) { err = FD_VINYL_ERR_AGAIN; goto next; }
+
+        if( FD_UNLIKELY( modify ) ) {
+          line->ref = FD_VINYL_LINE_REF_MODIFY;
+          if( FD_UNLIKELY( ignore ) ) {
+            fd_vinyl_bstream_phdr_t * phdr = (fd_vinyl_bstream_phdr_t *)fd_vinyl_line_data( vinyl, line_idx );
+            phdr->ctl          = fd_vinyl_bstream_ctl( FD_VINYL_BSTREAM_CTL_TYPE_PAIR, FD_VINYL_BSTREAM_CTL_STYLE_RAW, 0UL );
+            phdr->info._val_sz = 0U;
+          }
+        } else {
+          line->ref = ref + 1L;
+        }
+        line->used = 1;
+
+        vinyl->metrics.hit_cnt++;
+
+      } else {
+
+        fd_vinyl_bstream_phdr_t const * ephdr = &ele->phdr;
+
+        if( FD_UNLIKELY( (ulong)ephdr->info._val_sz>val_max ) ) { err = FD_VINYL_ERR_FULL; goto next; }
+
+        line_idx = fd_vinyl_private_line_acquire( vinyl, ele_idx, modify ? FD_VINYL_LINE_REF_MODIFY : 1L );
+        if( FD_UNLIKELY( line_idx==ULONG_MAX ) ) { err = FD_VINYL_ERR_FULL; goto next; }
+
+        vinyl->metrics.miss_cnt++;
+
+        fd_vinyl_bstream_phdr_t * phdr = (fd_vinyl_bstream_phdr_t *)fd_vinyl_line_data( vinyl, line_idx );
+
+        if( FD_UNLIKELY( ignore ) ) {
+
+          phdr->ctl           = fd_vinyl_bstream_ctl( FD_VINYL_BSTREAM_CTL_TYPE_PAIR, FD_VINYL_BSTREAM_CTL_STYLE_RAW, 0UL );
+          phdr->key           = ephdr->key;
+          phdr->info          = ephdr->info;
+          phdr->info._val_sz  = 0U;
+
+        } else {
+
+          fd_vinyl_io_rd_t * rd = vinyl->rd + rd_cnt++;
+          rd->ctx = line_idx;
+          rd->seq = ele->seq;
+          rd->dst = phdr;
+          rd->sz  = fd_vinyl_bstream_pair_sz( fd_vinyl_bstream_ctl_sz( ephdr->ctl ) );
+          FD_CRIT( rd->sz<=line_sz, "corruption detected" ); /* encoded pairs are never larger than raw pairs */
+          fd_vinyl_io_read( io, rd );
+
+          vinyl->metrics.read_cnt++;
+          vinyl->metrics.read_sz += rd->sz;
+
+        }
+      }
+
+    } else {
+
+      if( FD_UNLIKELY( !create                          ) ) {                              goto next; } /* err is KEY */
+      if( FD_UNLIKELY( vinyl->pair_cnt>=vinyl->pair_max ) ) { err = FD_VINYL_ERR_FULL;     goto next; }
+
+      line_idx = fd_vinyl_private_line_acquire( vinyl, ele_idx, FD_VINYL_LINE_REF_MODIFY );
+      if( FD_UNLIKELY( line_idx==ULONG_MAX ) ) { err = FD_VINYL_ERR_FULL; goto next; }
+
+      /* Insert the key as being created.  ctl is set last so concurrent
+         meta readers see a consistent element (and will filter it out
+         as being created). */
+
+      ele->memo = memo;
+      ele->phdr.key = key_i;
+      memset( &ele->phdr.info, 0, sizeof(fd_vinyl_info_t) );
+      ele->seq = 0UL;
+      FD_COMPILER_MFENCE();
+      ele->phdr.ctl = ULONG_MAX;
+      FD_COMPILER_MFENCE();
+
+      vinyl->pair_cnt++;
+
+      fd_vinyl_bstream_phdr_t * phdr = (fd_vinyl_bstream_phdr_t *)fd_vinyl_line_data( vinyl, line_idx );
+
+      phdr->ctl = fd_vinyl_bstream_ctl( FD_VINYL_BSTREAM_CTL_TYPE_PAIR, FD_VINYL_BSTREAM_CTL_STYLE_RAW, 0UL );
+      phdr->key = key_i;
+      memset( &phdr->info, 0, sizeof(fd_vinyl_info_t) );
+
+      err = FD_VINYL_SUCCESS;
+
+    }
+
+  next:
+    val_off[ batch_idx ] = err ? ULONG_MAX : line_idx*line_sz;
+    key_err[ batch_idx ] = (schar)err;
+    fail_cnt += (ulong)!!err;
+  }
+
+  /* Wait for all the reads to complete */
+
+  while( rd_cnt ) {
+    fd_vinyl_io_rd_t * rd;
+    int err = fd_vinyl_io_poll( io, &rd, FD_VINYL_IO_FLAG_BLOCKING );
+    if( FD_UNLIKELY( err ) ) FD_LOG_CRIT(( "fd_vinyl_io_poll failed (%i-%s)", err, fd_vinyl_strerror( err ) ));
+    fd_vinyl_private_line_fill( vinyl, rd );
+    rd_cnt--;
+  }
+
+  return fail_cnt;
+}
+
+static ulong
+fd_vinyl_private_release( fd_vinyl_t *           vinyl,
+                          ulong                  flags,
+                          fd_vinyl_key_t const * key,
+                          ulong                  batch_cnt,
+                          ulong *                val_off,
+                          schar *                key_err ) {
+
+  int modify = !!(flags & FD_VINYL_REQ_FLAG_MODIFY);
+
+  fd_vinyl_io_t *       io         = vinyl->io;
+  fd_vinyl_compact_t *  compact    = vinyl->compact;
+  fd_vinyl_meta_ele_t * ele0       = vinyl->meta->ele;
+  ulong                 ele_max    = vinyl->meta->ele_max;
+  ulong *               lock       = vinyl->meta->lock;
+  int                   lock_shift = vinyl->meta->lock_shift;
+  ulong                 meta_seed  = vinyl->meta->seed;
+  ulong                 val_max    = vinyl->val_max;
+
+  ulong fail_cnt   = 0UL;
+  ulong append_cnt = 0UL;
+
+  for( ulong batch_idx=0UL; batch_idx<batch_cnt; batch_idx++ ) {
+
+    fd_vinyl_key_t key_i = key[ batch_idx ];
+
+    ulong memo = fd_vinyl_key_memo( meta_seed, &key_i );
+    ulong ele_idx;
+    int   err  = fd_vinyl_meta_query_fast( ele0, ele_max, &key_i, memo, &ele_idx );
+
+    fd_vinyl_meta_ele_t * ele = ele0 + ele_idx;
+
+    if( FD_UNLIKELY( err || ele->line_idx==ULONG_MAX ) ) { err = FD_VINYL_ERR_INVAL; goto next; }
+
+    ulong             line_idx = ele->line_idx;
+    fd_vinyl_line_t * line     = vinyl->line + line_idx;
+
+    if( FD_UNLIKELY( !line->ref ) ) { err = FD_VINYL_ERR_INVAL; goto next; } /* Cached, not acquired */
+
+    if( line->ref>0L ) {
+
+      /* Acquired for reading (the line stays cached after the last
+         reader releases it) */
+
+      if( FD_UNLIKELY( modify ) ) err = FD_VINYL_ERR_INVAL;
+      line->ref--;
+      goto next;
+
+    }
+
+    /* Acquired for modify */
+
+    if( modify ) {
+
+      fd_vinyl_bstream_phdr_t * phdr = (fd_vinyl_bstream_phdr_t *)fd_vinyl_line_data( vinyl, line_idx );
+
+      ulong val_sz  = (ulong)phdr->info._val_sz;
+      ulong pair_sz = fd_vinyl_bstream_pair_sz( val_sz );
+
+      if( FD_UNLIKELY( val_sz>val_max                                  ) ) err = FD_VINYL_ERR_INVAL;
+      else if( FD_UNLIKELY( !fd_vinyl_private_reserve( vinyl, pair_sz ) ) ) err = FD_VINYL_ERR_FULL;
+      else {
+
+        /* Append the pair from the line (the client might have
+           clobbered the ctl and key so we restore them) and make it the
+           key's current version. */
+
+        phdr->ctl = fd_vinyl_bstream_ctl( FD_VINYL_BSTREAM_CTL_TYPE_PAIR, FD_VINYL_BSTREAM_CTL_STYLE_RAW, val_sz );
+        phdr->key = ele->phdr.key;
+
+        int   style;
+        ulong val_esz;
+        ulong seq = fd_vinyl_io_append_pair_inplace( io, FD_VINYL_BSTREAM_CTL_STYLE_RAW, phdr, &style, &val_esz );
+
+        if( compact && fd_vinyl_meta_ele_in_bstream( ele ) )
+          fd_vinyl_compact_garbage( compact, fd_vinyl_bstream_pair_sz( fd_vinyl_bstream_ctl_sz( ele->phdr.ctl ) ) );
+
+        fd_vinyl_meta_prepare_fast( lock, lock_shift, ele_idx );
+        ele->phdr.info = phdr->info;
+        ele->phdr.ctl  = fd_vinyl_bstream_ctl( FD_VINYL_BSTREAM_CTL_TYPE_PAIR, style, val_esz );
+        ele->seq       = seq;
+        fd_vinyl_meta_publish_fast( lock, lock_shift, ele_idx );
+
+        append_cnt++;
+        vinyl->metrics.append_cnt++;
+        vinyl->metrics.append_sz += fd_vinyl_bstream_pair_sz( val_esz );
+
+        /* The line holds the key's new current version (the append
+           does not touch the pair header or val) so keep it cached. */
+
+        line->ref = 0L;
+        goto next;
+      }
+    }
+
+    /* Discard any modifications (the line's contents are no longer
+       valid so it is not kept cached).  If the key was being created,
+       remove it from the meta. */
+
+    fd_vinyl_private_line_release( vinyl, line_idx );
+
+    if( FD_UNLIKELY( !fd_vinyl_meta_ele_in_bstream( ele ) ) ) {
+      fd_vinyl_meta_remove_fast( ele0, ele_max, lock, lock_shift, vinyl->line, vinyl->line_cnt, ele_idx );
+      vinyl->pair_cnt--;
+    }
+
+  next:
+    val_off[ batch_idx ] = ULONG_MAX;
+    key_err[ batch_idx ] = (schar)err;
+    fail_cnt += (ulong)!!err;
+  }
+
+  /* Make the appends part of the bstream's past before completing the
+     request (this also ends the io's interest in the released lines). */
+
+  if( append_cnt ) {
+    int err = fd_vinyl_io_commit( io, FD_VINYL_IO_FLAG_BLOCKING );
+    if( FD_UNLIKELY( err ) ) FD_LOG_CRIT(( "fd_vinyl_io_commit failed (%i-%s)", err, fd_vinyl_strerror( err ) ));
+    vinyl->dirty = 1;
+  }
+
+  return fail_cnt;
+}
+
+static ulong
+fd_vinyl_private_erase( fd_vinyl_t *           vinyl,
+                        fd_vinyl_key_t const * key,
+                        ulong                  batch_cnt,
+                        ulong *                val_off,
+                        schar *                key_err ) {
+
+  fd_vinyl_io_t *       io         = vinyl->io;
+  fd_vinyl_compact_t *  compact    = vinyl->compact;
+  fd_vinyl_meta_ele_t * ele0       = vinyl->meta->ele;
+  ulong                 ele_max    = vinyl->meta->ele_max;
+  ulong *               lock       = vinyl->meta->lock;
+  int                   lock_shift = vinyl->meta->lock_shift;
+  ulong                 meta_seed  = vinyl->meta->seed;
+
+  ulong fail_cnt   = 0UL;
+  ulong append_cnt = 0UL;
+
+  for( ulong batch_idx=0UL; batch_idx<batch_cnt; batch_idx++ ) {
+
+    fd_vinyl_key_t key_i = key[ batch_idx ];
+
+    ulong memo = fd_vinyl_key_memo( meta_seed, &key_i );
+    ulong ele_idx;
+    int   err  = fd_vinyl_meta_query_fast( ele0, ele_max, &key_i, memo, &ele_idx );
+
+    fd_vinyl_meta_ele_t * ele = ele0 + ele_idx;
+
+    ulong line_idx = ele->line_idx;
+
+    if( FD_UNLIKELY( err                                                     ) ) goto next; /* err is KEY */
+    if( FD_UNLIKELY( (line_idx!=ULONG_MAX) && vinyl->line[ line_idx ].ref    ) ) { err = FD_VINYL_ERR_AGAIN; goto next; }
+    if( FD_UNLIKELY( !fd_vinyl_private_reserve( vinyl, FD_VINYL_BSTREAM_BLOCK_SZ ) ) ) { err = FD_VINYL_ERR_FULL; goto next; }
+
+    if( line_idx!=ULONG_MAX ) fd_vinyl_private_line_release( vinyl, line_idx ); /* Drop the key from the cache */
+
+    /* Note: keys being created are always acquired so ele is in the
+       bstream here. */
+
+    fd_vinyl_io_append_dead( io, &ele->phdr, NULL, 0UL );
+
+    if( compact ) fd_vinyl_compact_garbage( compact, fd_vinyl_bstream_pair_sz( fd_vinyl_bstream_ctl_sz( ele->phdr.ctl ) )
+                                                     + FD_VINYL_BSTREAM_BLOCK_SZ );
+
+    fd_vinyl_meta_remove_fast( ele0, ele_max, lock, lock_shift, vinyl->line, vinyl->line_cnt, ele_idx );
+    vinyl->pair_cnt--;
+    vinyl->part_dead_cnt++;
+
+    append_cnt++;
+    vinyl->metrics.append_cnt++;
+    vinyl->metrics.append_sz += FD_VINYL_BSTREAM_BLOCK_SZ;
+
+  next:
+    val_off[ batch_idx ] = ULONG_MAX;
+    key_err[ batch_idx ] = (schar)err;
+    fail_cnt += (ulong)!!err;
+  }
+
+  if( append_cnt ) {
+    int err = fd_vinyl_io_commit( io, FD_VINYL_IO_FLAG_BLOCKING );
+    if( FD_UNLIKELY( err ) ) FD_LOG_CRIT(( "fd_vinyl_io_commit failed (%i-%s)", err, fd_vinyl_strerror( err ) ));
+    vinyl->dirty = 1;
+  }
+
+  return fail_cnt;
+}
+
+ulong
+fd_vinyl_exec( fd_vinyl_t *           vinyl,
+               fd_vinyl_req_t const * req,
+               ulong                  req_sz,
+               fd_vinyl_comp_t *      comp ) {
+
+  /* Copy the request header out of the client's memory and validate */
+
+  fd_vinyl_req_t hdr[1];
+  if( FD_LIKELY( req_sz>=sizeof(fd_vinyl_req_t) ) ) *hdr = *req;
+  else                                              memset( hdr, 0, sizeof(fd_vinyl_req_t) );
+
+  ulong batch_cnt = (ulong)hdr->batch_cnt;
+
+  int bad = (req_sz<sizeof(fd_vinyl_req_t)) | (batch_cnt<1UL) | (batch_cnt>FD_VINYL_REQ_BATCH_MAX) ||
+            (req_sz!=fd_vinyl_req_sz( batch_cnt ));
+
+  comp->req_id    = hdr->req_id;
+  comp->type      = hdr->type;
+  comp->err       = FD_VINYL_SUCCESS;
+  comp->batch_cnt = bad ? 0U : (uint)batch_cnt;
+  comp->fail_cnt  = 0U;
+
+  vinyl->metrics.req_cnt++;
+
+  if( FD_UNLIKELY( bad ) ) {
+    comp->err = FD_VINYL_ERR_INVAL;
+    return fd_vinyl_comp_sz( 0UL );
+  }
+
+  fd_vinyl_key_t const * key     = (fd_vinyl_key_t const *)(req+1);
+  ulong *                val_off = fd_vinyl_comp_val_off( comp );
+  schar *                key_err = fd_vinyl_comp_err    ( comp );
+
+  ulong fail_cnt;
+
+  switch( hdr->type ) {
+  case FD_VINYL_REQ_TYPE_ACQUIRE: fail_cnt = fd_vinyl_private_acquire( vinyl, hdr->flags, key, batch_cnt, val_off, key_err ); break;
+  case FD_VINYL_REQ_TYPE_RELEASE: fail_cnt = fd_vinyl_private_release( vinyl, hdr->flags, key, batch_cnt, val_off, key_err ); break;
+  case FD_VINYL_REQ_TYPE_ERASE:   fail_cnt = fd_vinyl_private_erase  ( vinyl,             key, batch_cnt, val_off, key_err ); break;
+  default:
+    comp->err       = FD_VINYL_ERR_INVAL;
+    comp->batch_cnt = 0U;
+    return fd_vinyl_comp_sz( 0UL );
+  }
+
+  comp->fail_cnt = (uint)fail_cnt;
+
+  vinyl->metrics.key_cnt  += batch_cnt;
+  vinyl->metrics.fail_cnt += fail_cnt;
+
+  return fd_vinyl_comp_sz( batch_cnt );
+}
+
+void
+fd_vinyl_housekeep( fd_vinyl_t * vinyl,
+                    long         now ) {
+
+  fd_vinyl_io_t *      io      = vinyl->io;
+  fd_vinyl_compact_t * compact = vinyl->compact;
+
+  /* Requests are processed to completion so there are no reads in
+     progress here. */
+
+  if( compact && fd_vinyl_compact_needed( compact, io ) ) {
+    if( fd_vinyl_compact( compact, io, vinyl->meta, now, FD_VINYL_COMPACT_OBJ_MAX ) ) vinyl->dirty = 1;
+  }
+
+  /* Close the current partition if it is large enough.  Everything
+     appended has been committed at this point so the partition ends at
+     an object boundary.  Partition blocks are garbage as far as
+     compaction is concerned. */
+
+  if( FD_UNLIKELY( (fd_vinyl_io_seq_future( io ) - vinyl->part_seq0)>=vinyl->part_thresh ) &&
+      FD_LIKELY( fd_vinyl_private_reserve( vinyl, FD_VINYL_BSTREAM_BLOCK_SZ ) ) ) {
+    ulong seq = fd_vinyl_io_append_part( io, vinyl->part_seq0, vinyl->part_dead_cnt, 0UL, NULL, 0UL );
+    int err = fd_vinyl_io_commit( io, FD_VINYL_IO_FLAG_BLOCKING );
+    if( FD_UNLIKELY( err ) ) FD_LOG_CRIT(( "fd_vinyl_io_commit failed (%i-%s)", err, fd_vinyl_strerror( err ) ));
+    if( compact ) fd_vinyl_compact_garbage( compact, FD_VINYL_BSTREAM_BLOCK_SZ );
+    vinyl->part_seq0     = seq + FD_VINYL_BSTREAM_BLOCK_SZ;
+    vinyl->part_dead_cnt = 0UL;
+    vinyl->dirty         = 1;
+    vinyl->metrics.part_cnt++;
+  }
+
+  if( vinyl->dirty ) {
+    int err = fd_vinyl_io_sync( io, FD_VINYL_IO_FLAG_BLOCKING );
+    if( FD_UNLIKELY( err ) ) FD_LOG_CRIT(( "fd_vinyl_io_sync failed (%i-%s)", err, fd_vinyl_strerror( err ) ));
+    vinyl->dirty = 0;
+    vinyl->metrics.sync_cnt++;
+  }
+}
+
+void *
+fd_vinyl_fini( fd_vinyl_t * vinyl ) {
+
+  if( FD_UNLIKELY( !vinyl ) ) {
+    FD_LOG_WARNING(( "NULL vinyl" ));
+    return NULL;
+  }
+
+  /* Discard outstanding acquires */
+
+  fd_vinyl_meta_t * meta = vinyl->meta;
+
+  for( ulong line_idx=0UL; line_idx<vinyl->line_cnt; line_idx++ ) {
+    ulong ele_idx = vinyl->line[ line_idx ].ele_idx;
+    if( ele_idx==ULONG_MAX ) continue;
+    fd_vinyl_private_line_release( vinyl, line_idx );
+    if( !fd_vinyl_meta_ele_in_bstream( meta->ele + ele_idx ) ) {
+      fd_vinyl_meta_remove_fast( meta->ele, meta->ele_max, meta->lock, meta->lock_shift, vinyl->line, vinyl->line_cnt, ele_idx );
+      vinyl->pair_cnt--;
+    }
+  }
+
+  int err = fd_vinyl_io_commit( vinyl->io, FD_VINYL_IO_FLAG_BLOCKING );
+  if( FD_UNLIKELY( err ) ) FD_LOG_CRIT(( "fd_vinyl_io_commit failed (%i-%s)", err, fd_vinyl_strerror( err ) ));
+
+  err = fd_vinyl_io_sync( vinyl->io, FD_VINYL_IO_FLAG_BLOCKING );
+  if( FD_UNLIKELY( err ) ) FD_LOG_CRIT(( "fd_vinyl_io_sync failed (%i-%s)", err, fd_vinyl_strerror( err ) ));
+
+  return vinyl;
+}
+
+int
+fd_vinyl_run( fd_vinyl_t *      vinyl,
+              fd_cnc_t *        cnc,
+              ulong             link_cnt,
+              fd_vinyl_link_t * link,
+              long              lazy,
+              fd_rng_t *        rng ) {
+
+  if( FD_UNLIKELY( !vinyl ) ) { FD_LOG_WARNING(( "NULL vinyl" )); return EINVAL; }
+  if( FD_UNLIKELY( !cnc   ) ) { FD_LOG_WARNING(( "NULL cnc"   )); return EINVAL; }
+  if( FD_UNLIKELY( !rng   ) ) { FD_LOG_WARNING(( "NULL rng"   )); return EINVAL; }
+
+  if( FD_UNLIKELY( !((1UL<=link_cnt) & (link_cnt<=FD_VINYL_LINK_MAX)) ) ) {
+    FD_LOG_WARNING(( "bad link_cnt" ));
+    return EINVAL;
+  }
+
+  if( FD_UNLIKELY( !link ) ) { FD_LOG_WARNING(( "NULL link" )); return EINVAL; }
+
+  ulong cq_depth_max = 1UL;
+
+  for( ulong link_idx=0UL; link_idx<link_cnt; link_idx++ ) {
+    fd_vinyl_link_t * l = link + link_idx;
+
+    if( FD_UNLIKELY( (!l->rq_mcache) | (!l->rq_base) | (!l->cq_mcache) | (!l->cq_dcache) | (!l->cq_base) ) ) {
+      FD_LOG_WARNING(( "link %lu has NULL fields", link_idx ));
+      return EINVAL;
+    }
+
+    l->rq_depth = fd_mcache_depth( l->rq_mcache );
+    l->cq_depth = fd_mcache_depth( l->cq_mcache );
+
+    if( FD_UNLIKELY( !fd_dcache_compact_is_safe( l->cq_base, l->cq_dcache, fd_vinyl_comp_sz( FD_VINYL_REQ_BATCH_MAX ), l->cq_depth ) ) ) {
+      FD_LOG_WARNING(( "link %lu cq_dcache not compatible with cq_mcache depth and max completion size", link_idx ));
+      return EINVAL;
+    }
+
+    l->rq_seq    = fd_mcache_seq_query( fd_mcache_seq_laddr_const( l->rq_mcache ) );
+    l->cq_seq    = fd_mcache_seq_query( fd_mcache_seq_laddr_const( l->cq_mcache ) );
+    l->cq_chunk0 = fd_dcache_compact_chunk0( l->cq_base, l->cq_dcache );
+    l->cq_wmark  = fd_dcache_compact_wmark ( l->cq_base, l->cq_dcache, fd_vinyl_comp_sz( FD_VINYL_REQ_BATCH_MAX ) );
+    l->cq_chunk  = l->cq_chunk0;
+
+    cq_depth_max = fd_ulong_max( cq_depth_max, l->cq_depth );
+  }
+
+  if( lazy<=0L ) lazy = fd_tempo_lazy_default( cq_depth_max );
+  ulong async_min = fd_tempo_async_min( lazy, 1UL, (float)fd_tempo_tick_per_ns( NULL ) );
+  if( FD_UNLIKELY( !async_min ) ) {
+    FD_LOG_WARNING(( "bad lazy" ));
+    return EINVAL;
+  }
+
+  FD_LOG_INFO(( "Running vinyl (link_cnt %lu, lazy %li)", link_cnt, lazy ));
+
+  fd_cnc_signal( cnc, FD_CNC_SIGNAL_RUN );
+
+  long  then     = fd_tickcount();
+  ulong link_idx = 0UL;
+  ulong idle_cnt = 0UL;
+
+  for(;;) {
+
+    /* Do housekeeping in the background */
+
+    long now = fd_tickcount();
+    if( FD_UNLIKELY( (now-then)>=0L ) ) {
+
+      fd_cnc_heartbeat( cnc, now );
+
+      for( ulong idx=0UL; idx<link_cnt; idx++ ) fd_mcache_seq_update( fd_mcache_seq_laddr( link[ idx ].cq_mcache ), link[ idx ].cq_seq );
+
+      ulong s = fd_cnc_signal_query( cnc );
+      if( FD_UNLIKELY( s!=FD_CNC_SIGNAL_RUN ) ) {
+        if( FD_LIKELY( s==FD_CNC_SIGNAL_HALT ) ) break;
+        char buf[ FD_CNC_SIGNAL_CSTR_BUF_MAX ];
+        FD_LOG_WARNING(( "Unexpected signal %s (%lu) received; trying to resume", fd_cnc_signal_cstr( s, buf ), s ));
+        fd_cnc_signal( cnc, FD_CNC_SIGNAL_RUN );
+      }
+
+      fd_vinyl_housekeep( vinyl, fd_log_wallclock() );
+
+      then = now + (long)fd_tempo_async_reload( rng, async_min );
+    }
+
+    /* Poll the next link for a request */
+
+    fd_vinyl_link_t * l = link + link_idx;
+    link_idx = fd_ulong_if( link_idx+1UL<link_cnt, link_idx+1UL, 0UL );
+
+    ulong                  rq_seq    = l->rq_seq;
+    fd_frag_meta_t const * mline     = l->rq_mcache + fd_mcache_line_idx( rq_seq, l->rq_depth );
+    ulong                  seq_found = fd_frag_meta_seq_query( mline );
+    long                   diff      = fd_seq_diff( seq_found, rq_seq );
+
+    if( FD_LIKELY( diff<0L ) ) { /* Nothing to do on this link */
+      if( FD_UNLIKELY( ++idle_cnt>=link_cnt ) ) { FD_SPIN_PAUSE(); idle_cnt = 0UL; }
+      continue;
+    }
+
+    if( FD_UNLIKELY( diff>0L ) ) { /* Client overran the link (violated flow control) */
+      FD_LOG_WARNING(( "link %lu overrun (seq %lu, found %lu); requests were lost", (ulong)(l-link), rq_seq, seq_found ));
+      l->rq_seq = seq_found;
+      continue;
+    }
+
+    ulong chunk  = (ulong)mline->chunk;
+    ulong sz     = (ulong)mline->sz;
+    ulong tsorig = (ulong)mline->tsorig;
+    FD_COMPILER_MFENCE();
+    if( FD_UNLIKELY( fd_seq_ne( fd_frag_meta_seq_query( mline ), rq_seq ) ) ) continue; /* Overrun while reading, handled above on retry */
+
+    idle_cnt = 0UL;
+
+    /* Process the request and publish the completion */
+
+    fd_vinyl_req_t const * req  = (fd_vinyl_req_t const *)fd_chunk_to_laddr_const( l->rq_base, chunk );
+    fd_vinyl_comp_t *      comp = (fd_vinyl_comp_t *)     fd_chunk_to_laddr      ( l->cq_base, l->cq_chunk );
+
+    ulong comp_sz = fd_vinyl_exec( vinyl, req, sz, comp );
+
+    ulong tspub = (ulong)fd_frag_meta_ts_comp( fd_tickcount() );
+    fd_mcache_publish( l->cq_mcache, l->cq_depth, l->cq_seq, comp->req_id, l->cq_chunk, comp_sz,
+                       fd_frag_meta_ctl( 0UL, 1, 1, 0 ), tsorig, tspub );
+
+    l->cq_seq   = fd_seq_inc( l->cq_seq, 1UL );
+    l->cq_chunk = fd_dcache_compact_next( l->cq_chunk, comp_sz, l->cq_chunk0, l->cq_wmark );
+    l->rq_seq   = fd_seq_inc( rq_seq, 1UL );
+  }
+
+  for( ulong idx=0UL; idx<link_cnt; idx++ ) fd_mcache_seq_update( fd_mcache_seq_laddr( link[ idx ].cq_mcache ), link[ idx ].cq_seq );
+
+  fd_cnc_signal( cnc, FD_CNC_SIGNAL_BOOT );
+
+  return 0;
+}
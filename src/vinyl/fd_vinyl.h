@@ -5,5 +5,213 @@
 //#include "bstream/fd_vinyl_bstream.h" /* includes fd_vinyl_base.h */
 #include "io/fd_vinyl_io.h"             /* includes bstream/fd_vinyl_bstream.h */
 #include "meta/fd_vinyl_meta.h"         /* includes bstream/fd_vinyl_bstream.h */
+#include "line/fd_vinyl_line.h"         /* includes bstream/fd_vinyl_bstream.h */
+#include "compact/fd_vinyl_compact.h"   /* includes io/fd_vinyl_io.h, meta/fd_vinyl_meta.h */
+#include "rq/fd_vinyl_rq.h"             /* includes fd_vinyl_base.h */
+#include "rq/fd_vinyl_client.h"         /* includes rq/fd_vinyl_rq.h */
+#include "recover/fd_vinyl_recover.h"   /* includes io/fd_vinyl_io.h, meta/fd_vinyl_meta.h */
+
+/* A fd_vinyl_t is the state of a vinyl tile.  It owns the bstream's
+   io, is the only writer of the bstream's meta and manages the data
+   region that clients use to operate on acquired pairs.  Lines keep
+   their pair cached after the last client releases it (see
+   fd_vinyl_line.h) such that hot pairs are served without reading the
+   bstream.  Requests are processed one batch at a time: all the bstream reads for a batch are
+   issued to the io up front (so backends that support it can keep many
+   reads in flight) and the batch completes when they are all done.
+   Background compaction, bstream syncs and appending partition blocks
+   (so the bstream can be recovered in parallel, see
+   fd_vinyl_recover.h) are done in between batches by
+   fd_vinyl_housekeep.
+
+   The state is local to the thread running the vinyl tile.  The data
+   region and meta are shared with clients. */
+
+#define FD_VINYL_ALIGN (128UL)
+
+/* FD_VINYL_LINK_MAX gives the max number of client links fd_vinyl_run
+   can serve. */
+
+#define FD_VINYL_LINK_MAX (64UL)
+
+/* FD_VINYL_PART_THRESH_DEFAULT gives the default number of bytes
+   appended to the bstream between partition blocks.  Smaller values
+   give recovery more parallelism at the cost of more partition blocks
+   in the bstream. */
+
+#define FD_VINYL_PART_THRESH_DEFAULT (64UL<<20)
+
+struct __attribute__((aligned(FD_VINYL_ALIGN))) fd_vinyl_private {
+
+  fd_vinyl_io_t *      io;
+  fd_vinyl_meta_t *    meta;
+  fd_vinyl_compact_t * compact;    /* NULL if no compaction */
+  ulong                dev_sz;     /* bstream store capacity in bytes */
+
+  uchar *              data;       /* Data region, line i's slot is at data + i*line_sz */
+  ulong                val_max;    /* Max pair val byte size that can be acquired */
+  ulong                line_sz;    /* == fd_vinyl_line_data_sz( val_max ) */
+  ulong                line_cnt;   /* In [1,FD_VINYL_LINE_MAX] */
+  ulong                line_free;  /* Head of the free line list, ULONG_MAX if none */
+  ulong                line_hand;  /* Line cache clock hand, in [0,line_cnt) */
+  fd_vinyl_line_t *    line;       /* Indexed [0,line_cnt) */
+
+  fd_vinyl_io_rd_t *   rd;         /* Indexed [0,FD_VINYL_REQ_BATCH_MAX) */
+  uchar *              scratch;    /* line_sz bytes of decode scratch */
+
+  ulong                pair_cnt;   /* Number of keys in the meta */
+  ulong                pair_max;   /* Max number of keys in the meta */
+  int                  dirty;      /* 1 if the bstream has changed since the last sync */
+
+  ulong                part_thresh;   /* Append a partition block when at least this many bytes were appended since the last */
+  ulong                part_seq0;     /* Start of the bstream's current (not yet appended) partition */
+  ulong                part_dead_cnt; /* Number of dead blocks in the current partition */
+
+  struct {
+    ulong req_cnt;     /* Requests processed */
+    ulong key_cnt;     /* Keys processed */
+    ulong fail_cnt;    /* Keys that failed */
+    ulong read_cnt;    /* Pair reads issued to the io */
+    ulong read_sz;     /* Bytes read */
+    ulong append_cnt;  /* Pairs and dead blocks appended */
+    ulong append_sz;   /* Bytes appended */
+    ulong sync_cnt;    /* Bstream syncs */
+    ulong part_cnt;    /* Partition blocks appended */
+    ulong hit_cnt;     /* Acquires of existing keys served from a bound line */
+    ulong miss_cnt;    /* Acquires of existing keys that needed a line filled */
+    ulong evict_cnt;   /* Cached lines evicted to make room */
+  } metrics;
+
+};
+
+typedef struct fd_vinyl_private fd_vinyl_t;
+
+/* A fd_vinyl_link_t describes a client connection served by
+   fd_vinyl_run.  The caller populates the rq / cq fields (the vinyl
+   tile is the consumer of rq and the producer of cq).  The remaining
+   fields are managed by fd_vinyl_run. */
+
+struct fd_vinyl_link {
+
+  fd_frag_meta_t const * rq_mcache;  /* Local join to the link's request mcache */
+  void const *           rq_base;    /* Chunk base address for the request dcache (e.g. containing wksp) */
+  fd_frag_meta_t *       cq_mcache;  /* Local join to the link's completion mcache */
+  uchar *                cq_dcache;  /* Local join to the link's completion dcache, mtu at least fd_vinyl_comp_sz( FD_VINYL_REQ_BATCH_MAX ) */
+  void *                 cq_base;    /* Chunk base address for the completion dcache */
+
+  /* Private */
+
+  ulong rq_depth;
+  ulong rq_seq;
+  ulong cq_depth;
+  ulong cq_seq;
+  ulong cq_chunk0;
+  ulong cq_wmark;
+  ulong cq_chunk;
+};
+
+typedef struct fd_vinyl_link fd_vinyl_link_t;
+
+FD_PROTOTYPES_BEGIN
+
+/* fd_vinyl_{align,footprint} give the alignment and footprint of the
+   local memory region needed for a vinyl tile with line_cnt data lines
+   holding vals up to val_max bytes.  footprint returns 0 if line_cnt or
+   val_max are invalid.
+
+   fd_vinyl_data_{align,footprint} give the alignment and footprint of
+   the shared memory data region for such a vinyl tile (0 if
+   invalid). */
+
+FD_FN_CONST ulong fd_vinyl_align    ( void );
+FD_FN_CONST ulong fd_vinyl_footprint( ulong line_cnt, ulong val_max );
+
+FD_FN_CONST ulong fd_vinyl_data_align    ( void );
+FD_FN_CONST ulong fd_vinyl_data_footprint( ulong line_cnt, ulong val_max );
+
+/* fd_vinyl_init starts running a vinyl tile.  lmem points to a local
+   memory region with suitable alignment and footprint.  io is the
+   bstream's io (with no reads or appends in progress) and dev_sz is the
+   capacity of the io's store in bytes.  meta is a local join to the
+   bstream's meta, which should reflect the pairs at the bstream's
+   seq_present (e.g. a new meta for a new bstream or a meta rebuilt by
+   recovery).  data points to the data region (suitable alignment and
+   footprint, shared with clients).  compact is an initialized
+   compactor for the bstream or NULL to not do background compaction.
+   Partition blocks are appended every FD_VINYL_PART_THRESH_DEFAULT
+   bytes (vinyl->part_thresh can be changed by the caller after init).
+
+   Returns a handle to the vinyl tile on success (has ownership of lmem
+   and interest in io, meta, data and compact until fini) and NULL on
+   failure (logs details). */
+
+fd_vinyl_t *
+fd_vinyl_init( void *               lmem,
+               ulong                line_cnt,
+               ulong                val_max,
+               fd_vinyl_io_t *      io,
+               ulong                dev_sz,
+               fd_vinyl_meta_t *    meta,
+               void *               data,
+               fd_vinyl_compact_t * compact );
+
+/* fd_vinyl_fini stops running a vinyl tile.  Any outstanding acquires
+   are discarded (modifications by clients are lost) and the bstream is
+   synced.  Returns lmem on success (ownership returned to caller and
+   interest in io, meta, data and compact ended) and NULL on failure
+   (logs details). */
+
+void *
+fd_vinyl_fini( fd_vinyl_t * vinyl );
+
+/* fd_vinyl_exec processes the request req with req_sz payload bytes
+   and writes the completion to comp.  comp should have room for
+   fd_vinyl_comp_sz( FD_VINYL_REQ_BATCH_MAX ) bytes.  Returns the
+   number of completion bytes written.  See fd_vinyl_rq.h for request
+   semantics.  Cannot fail from the caller's perspective (malformed
+   requests are reported in the completion, FD_LOG_CRIT if bstream or
+   meta corruption is detected). */
+
+ulong
+fd_vinyl_exec( fd_vinyl_t *           vinyl,
+               fd_vinyl_req_t const * req,
+               ulong                  req_sz,
+               fd_vinyl_comp_t *      comp );
+
+/* fd_vinyl_housekeep does background work for the vinyl tile (an
+   incremental round of compaction if needed, appending a partition
+   block if enough has been appended since the last one and syncing the
+   bstream if it has changed).  now is the current time in ns.  Should be called
+   periodically by the vinyl tile between requests. */
+
+void
+fd_vinyl_housekeep( fd_vinyl_t * vinyl,
+                    long         now );
+
+/* fd_vinyl_run serves requests from link_cnt clients over the given
+   links until cnc is signaled to HALT.  lazy is the target interval in
+   ns between housekeeping rounds (<=0 for a reasonable default).  rng
+   is a local join to a rng.  Requests are processed from links in a
+   round robin fashion.  Returns 0 on a normal halt and an errno
+   compatible error code if the links are invalid (logs details). */
+
+int
+fd_vinyl_run( fd_vinyl_t *      vinyl,
+              fd_cnc_t *        cnc,
+              ulong             link_cnt,
+              fd_vinyl_link_t * link,
+              long              lazy,
+              fd_rng_t *        rng );
+
+/* fd_vinyl_line_data returns the location in the data region of line
+   line_idx's slot.  Assumes line_idx is in [0,line_cnt). */
+
+FD_FN_PURE static inline uchar *
+fd_vinyl_line_data( fd_vinyl_t const * vinyl,
+                    ulong              line_idx ) {
+  return vinyl->data + line_idx*vinyl->line_sz;
+}
+
+FD_PROTOTYPES_END
 
 #endif /* HEADER_fd_src_vinyl_fd_vinyl_h */
@@ -68,6 +68,7 @@
 
 #define FD_VINYL_IO_TYPE_MM (0)
 #define FD_VINYL_IO_TYPE_BD (1)
+#define FD_VINYL_IO_TYPE_UR (2)
 
 /* FD_VINYL_IO_FLAG_* are flags used by various vinyl IO APIs */
 
@@ -429,7 +430,7 @@ fd_vinyl_io_append_move( fd_vinyl_io_t *                 io,
 
 ulong
 fd_vinyl_io_append_part( fd_vinyl_io_t * io,
-                         ulong           seq_prev,  /* should be a part before seq or seq */
+                         ulong           seq0,      /* partition start (just after the previous part), at most seq */
                          ulong           dead_cnt,  /* number of dead blocks in the partition */
                          ulong           move_cnt,  /* number of move blocks in the partition */
                          void const *    info,      /* contains info_sz bytes, info_sz treated as 0 if NULL */
@@ -538,6 +539,77 @@ fd_vinyl_io_mm_init( void *       lmem,
                      ulong        info_sz,
                      ulong        io_seed );
 
+/* fd_vinyl_io_ur *****************************************************/
+
+/* FD_VINYL_IO_UR_DEPTH_MAX is the max io_uring submission queue depth
+   supported by fd_vinyl_io_ur. */
+
+#define FD_VINYL_IO_UR_DEPTH_MAX (4096UL)
+
+/* fd_vinyl_io_ur_* is the same as fd_vinyl_io_bd_* but reads and
+   appends are done asynchronously via a Linux io_uring with depth
+   submission queue entries.  The result is bit-level identical to
+   fd_vinyl_io_bd (and vice versa).
+
+   Unlike bd, reads posted by fd_vinyl_io_read are actually in flight
+   concurrently (they are submitted to the kernel in batches on poll)
+   and appends are not complete until commit.  Per the fd_vinyl_io API,
+   the caller should not modify appended memory until commit and should
+   not touch a read's destination until poll returns it.
+
+   The append scratch pad is registered with the ring such that appends
+   from it (and copies, which are bounced through it) use the kernel's
+   fixed buffer fast path.  If rd_mem is non-NULL, the rd_mem_sz byte
+   region at rd_mem is also registered and reads whose destination is
+   entirely within it also use the fixed buffer fast path (e.g. rd_mem
+   is typically the vinyl data cache).  rd_mem should be page aligned
+   and must outlive the io.  If the kernel refuses to register the
+   buffers (e.g. RLIMIT_MEMLOCK), the io falls back to unregistered
+   buffers (logs details).
+
+   dev_fd can be opened with O_DIRECT to bypass the page cache.  All
+   bstream offsets, sizes and buffers are FD_VINYL_BSTREAM_BLOCK_SZ
+   aligned so this works for devices with logical blocks up to that
+   size.  Fails if io_uring is not available (e.g. old kernel, disabled
+   by sysctl or seccomp). */
+
+ulong fd_vinyl_io_ur_align    ( void );
+ulong fd_vinyl_io_ur_footprint( ulong spad_max );
+
+fd_vinyl_io_t *
+fd_vinyl_io_ur_init( void *       lmem,
+                     ulong        spad_max,
+                     int          dev_fd,
+                     ulong        depth,
+                     void *       rd_mem,
+                     ulong        rd_mem_sz,
+                     int          reset,
+                     void const * info,
+                     ulong        info_sz,
+                     ulong        io_seed );
+
+/* fd_vinyl_io_ur_init_ring is fd_vinyl_io_ur_init for an io_uring ring
+   created by the caller with fd_io_uring_init (e.g. before entering a
+   sandbox that does not allow creating rings, the depth is the ring's).
+   The io takes ownership of the ring: on success, the ring is
+   finalized by fd_vinyl_io_fini and, on failure, it is finalized
+   before returning.  Either way, the caller should not use ring after
+   this call. */
+
+struct fd_io_uring;
+
+fd_vinyl_io_t *
+fd_vinyl_io_ur_init_ring( void *               lmem,
+                          ulong                spad_max,
+                          int                  dev_fd,
+                          struct fd_io_uring * ring,
+                          void *               rd_mem,
+                          ulong                rd_mem_sz,
+                          int                  reset,
+                          void const *         info,
+                          ulong                info_sz,
+                          ulong                io_seed );
+
 /* fd_vinyl_{mmio,mmio_sz} return {a pointer in the caller's address
    space to the raw bstream storage,the raw bstream storage byte size).
    These are a _subset_ of the dev / dev_sz region passed to mm_init and
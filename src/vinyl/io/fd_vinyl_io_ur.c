@@ -0,0 +1,969 @@
+#define _GNU_SOURCE /* O_DIRECT */
+#include "fd_vinyl_io.h"
+#include "../../util/io_uring/fd_io_uring.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+/* fd_vinyl_io_ur is an io_uring backed bstream store.  Reads and
+   appends are posted as io_uring SQEs and reaped asynchronously.  The
+   append scratch pad (and optionally a caller provided read
+   destination region) is registered with the ring so the kernel can
+   skip per-op page pinning (i.e. {READ,WRITE}_FIXED).
+
+   Ring ops are tagged via their SQE user_data:
+
+     low 2 bits 0: a read op for the fd_vinyl_io_ur_rd_t at user_data
+     low 2 bits 1: an append / copy write op of user_data>>2 bytes
+     low 2 bits 2: a copy read op of user_data>>2 bytes (linked to the
+                   write op that follows it)
+
+   SQEs are published to the kernel in batches (on poll, commit, or when
+   the submission queue fills up) so a caller can post hundreds of reads
+   for the cost of a single syscall. */
+
+#define FD_VINYL_IO_UR_TAG_WRITE   (1UL)
+#define FD_VINYL_IO_UR_TAG_COPY_RD (2UL)
+
+/* FD_VINYL_IO_UR_OP_MAX is the largest number of bytes transferred by
+   a single ring op (io_uring op sizes are 32-bit). */
+
+#define FD_VINYL_IO_UR_OP_MAX (1UL<<30)
+
+static inline void
+ur_pread( int    fd,
+          ulong  off,
+          void * buf,
+          ulong  sz ) {
+  ssize_t ssz = pread( fd, buf, sz, (off_t)off );
+  if( FD_LIKELY( ssz==(ssize_t)sz ) ) return;
+  if( ssz<(ssize_t)0 ) FD_LOG_CRIT(( "pread(fd %i,off %lu,sz %lu) failed (%i-%s)", fd, off, sz, errno, fd_io_strerror( errno ) ));
+  /**/                 FD_LOG_CRIT(( "pread(fd %i,off %lu,sz %lu) failed (unexpected sz %li)", fd, off, sz, (long)ssz ));
+}
+
+static inline void
+ur_pwrite( int          fd,
+           ulong        off,
+           void const * buf,
+           ulong        sz ) {
+  ssize_t ssz = pwrite( fd, buf, sz, (off_t)off );
+  if( FD_LIKELY( ssz==(ssize_t)sz ) ) return;
+  if( ssz<(ssize_t)0 ) FD_LOG_CRIT(( "pwrite(fd %i,off %lu,sz %lu) failed (%i-%s)", fd, off, sz, errno, fd_io_strerror( errno ) ));
+  else                 FD_LOG_CRIT(( "pwrite(fd %i,off %lu,sz %lu) failed (unexpected sz %li)", fd, off, sz, (long)ssz ));
+}
+
+struct fd_vinyl_io_ur_rd;
+typedef struct fd_vinyl_io_ur_rd fd_vinyl_io_ur_rd_t;
+
+struct fd_vinyl_io_ur_rd {
+  ulong                 ctx;  /* Must mirror fd_vinyl_io_rd_t */
+  ulong                 seq;  /* " */
+  void *                dst;  /* " */
+  ulong                 sz;   /* " */
+  fd_vinyl_io_ur_rd_t * next; /* Next element in ur completed rd queue */
+  ulong                 got;  /* Bytes read so far */
+  ulong                 pend; /* Number of ring ops in flight for this rd */
+};
+
+FD_STATIC_ASSERT( sizeof(fd_vinyl_io_ur_rd_t)<=sizeof(fd_vinyl_io_rd_t), layout );
+
+struct fd_vinyl_io_ur {
+  fd_vinyl_io_t            base[1];
+  int                      dev_fd;       /* File descriptor of block device */
+  int                      fixed;        /* 1 if the spad (and rd_mem, if any) are registered with the ring */
+  ulong                    dev_sync;     /* Offset to block that holds bstream sync (BLOCK_SZ multiple) */
+  ulong                    dev_base;     /* Offset to first block (BLOCK_SZ multiple) */
+  ulong                    dev_sz;       /* Block store byte size (BLOCK_SZ multiple) */
+  ulong                    rd_mem;       /* Registered read destination region [rd_mem,rd_mem+rd_mem_sz), 0 if none */
+  ulong                    rd_mem_sz;    /* " */
+  ulong                    op_max;       /* Max ring ops in flight (bounded by the CQ depth) */
+  ulong                    op_pend;      /* Ring ops prepared or in flight (not reaped yet) */
+  ulong                    wr_pend;      /* Append / copy ring ops not reaped yet */
+  ulong                    rd_pend;      /* Reads posted but not yet returned by poll */
+  fd_vinyl_io_ur_rd_t *    rd_head;      /* Pointer to completed queue head */
+  fd_vinyl_io_ur_rd_t **   rd_tail_next; /* Pointer to completed queue &tail->next or &rd_head if empty. */
+  fd_io_uring_t            ring[1];
+  fd_vinyl_bstream_block_t sync[1];
+  /* spad_max bytes follow */
+};
+
+typedef struct fd_vinyl_io_ur fd_vinyl_io_ur_t;
+
+/* ur_submit publishes prepared SQEs to the kernel and waits for at
+   least wait_cnt completions. */
+
+static void
+ur_submit( fd_vinyl_io_ur_t * ur,
+           uint               wait_cnt ) {
+  for(;;) {
+    int res = fd_io_uring_submit( ur->ring, wait_cnt );
+    if( FD_LIKELY( res>=0 ) ) return;
+    if( FD_LIKELY( (res==-EINTR) | (res==-EAGAIN) | (res==-EBUSY) ) ) { FD_SPIN_PAUSE(); continue; }
+    FD_LOG_CRIT(( "io_uring_enter failed (%i-%s)", -res, fd_io_strerror( -res ) ));
+  }
+}
+
+/* ur_reap processes all available completions.  Reads that are fully
+   complete are moved to the completed rd queue. */
+
+static void
+ur_reap( fd_vinyl_io_ur_t * ur ) {
+  for(;;) {
+    struct io_uring_cqe * cqe = fd_io_uring_cqe_peek( ur->ring );
+    if( !cqe ) break;
+
+    ulong user_data = cqe->user_data;
+    int   res       = cqe->res;
+    fd_io_uring_cqe_seen( ur->ring );
+
+    ur->op_pend--;
+
+    ulong tag = user_data & 3UL;
+    if( FD_LIKELY( !tag ) ) {
+
+      fd_vinyl_io_ur_rd_t * rd = (fd_vinyl_io_ur_rd_t *)user_data;
+      if( FD_UNLIKELY( res<0 ) )
+        FD_LOG_CRIT(( "bstream read [%016lx,%016lx)/%lu failed (%i-%s)", rd->seq, rd->seq+rd->sz, rd->sz, -res, fd_io_strerror( -res ) ));
+      rd->got += (ulong)res;
+      if( FD_LIKELY( --rd->pend ) ) continue;
+      if( FD_UNLIKELY( rd->got!=rd->sz ) )
+        FD_LOG_CRIT(( "bstream read [%016lx,%016lx)/%lu failed (unexpected sz %lu)", rd->seq, rd->seq+rd->sz, rd->sz, rd->got ));
+
+      rd->next         = NULL;
+      *ur->rd_tail_next = rd;
+      ur->rd_tail_next  = &rd->next;
+
+    } else {
+
+      ulong sz = user_data >> 2;
+      if( FD_UNLIKELY( (res<0) | ((ulong)res!=sz) ) ) {
+        char const * what = tag==FD_VINYL_IO_UR_TAG_WRITE ? "write" : "copy read";
+        if( res<0 ) FD_LOG_CRIT(( "bstream %s (sz %lu) failed (%i-%s)", what, sz, -res, fd_io_strerror( -res ) ));
+        else        FD_LOG_CRIT(( "bstream %s (sz %lu) failed (unexpected sz %i)", what, sz, res ));
+      }
+      ur->wr_pend--;
+
+    }
+  }
+}
+
+/* ur_reserve ensures that at least cnt SQEs can be prepared without
+   overflowing the submission or completion queues, blocking the caller
+   to reap completions if necessary. */
+
+static void
+ur_reserve( fd_vinyl_io_ur_t * ur,
+            ulong              cnt ) {
+  while( FD_UNLIKELY( ((ur->op_pend + cnt) > ur->op_max) | ((ulong)fd_io_uring_sq_free( ur->ring ) < cnt) ) ) {
+    ur_submit( ur, (ur->op_pend + cnt) > ur->op_max ? 1U : 0U );
+    ur_reap( ur );
+  }
+}
+
+static inline struct io_uring_sqe *
+ur_sqe( fd_vinyl_io_ur_t * ur ) {
+  ur->op_pend++;
+  return fd_io_uring_sqe_get( ur->ring ); /* guaranteed non-NULL by a preceding ur_reserve */
+}
+
+/* ur_buf_op returns the {READ,WRITE}{,_FIXED} op to use for a transfer
+   of sz bytes to/from buf and sets *_buf_idx appropriately. */
+
+static inline int
+ur_buf_op( fd_vinyl_io_ur_t const * ur,
+           int                      write,
+           void const *             buf,
+           ulong                    sz,
+           uint *                   _buf_idx ) {
+  ulong b0 = (ulong)buf;
+  ulong b1 = b0 + sz;
+
+  ulong spad0 = (ulong)(ur+1);
+  ulong spad1 = spad0 + ur->base->spad_max;
+
+  *_buf_idx = 0U;
+  if( FD_LIKELY( ur->fixed ) ) {
+    if( (spad0<=b0) & (b1<=spad1) ) return write ? IORING_OP_WRITE_FIXED : IORING_OP_READ_FIXED;
+    if( ur->rd_mem_sz && (ur->rd_mem<=b0) & (b1<=ur->rd_mem+ur->rd_mem_sz) ) {
+      *_buf_idx = 1U;
+      return write ? IORING_OP_WRITE_FIXED : IORING_OP_READ_FIXED;
+    }
+  }
+  return write ? IORING_OP_WRITE : IORING_OP_READ;
+}
+
+static void
+fd_vinyl_io_ur_read_imm( fd_vinyl_io_t * io,
+                         ulong           seq0,
+                         void *          _dst,
+                         ulong           sz ) {
+  fd_vinyl_io_ur_t * ur = (fd_vinyl_io_ur_t *)io;  /* Note: io must be non-NULL to have even been called */
+
+  /* If this is a request to read nothing, succeed immediately.  If
+     this is a request to read outside the bstream's past, fail. */
+
+  if( FD_UNLIKELY( !sz ) ) return;
+
+  uchar * dst  = (uchar *)_dst;
+  ulong   seq1 = seq0 + sz;
+
+  ulong seq_past    = ur->base->seq_past;
+  ulong seq_present = ur->base->seq_present;
+
+  int bad_seq  = !fd_ulong_is_aligned( seq0, FD_VINYL_BSTREAM_BLOCK_SZ );
+  int bad_dst  = (!fd_ulong_is_aligned( (ulong)dst, FD_VINYL_BSTREAM_BLOCK_SZ )) | !dst;
+  int bad_sz   = !fd_ulong_is_aligned( sz,   FD_VINYL_BSTREAM_BLOCK_SZ );
+  int bad_past = !(fd_vinyl_seq_le( seq_past, seq0 ) & fd_vinyl_seq_lt( seq0, seq1 ) & fd_vinyl_seq_le( seq1, seq_present ));
+
+  if( FD_UNLIKELY( bad_seq | bad_dst | bad_sz | bad_past ) )
+    FD_LOG_CRIT(( "bstream read_imm [%016lx,%016lx)/%lu failed (past [%016lx,%016lx)/%lu, %s)",
+                  seq0, seq1, sz, seq_past, seq_present, seq_present-seq_past,
+                  bad_seq ? "misaligned seq"         :
+                  bad_dst ? "misaligned or NULL dst" :
+                  bad_sz  ? "misaligned sz"          :
+                            "not in past" ));
+
+  /* At this point, we have a valid read request.  As this is blocking
+     and typically used for sequential iteration, we bypass the ring and
+     do the read directly (handling store wrap around). */
+
+  int   dev_fd   = ur->dev_fd;
+  ulong dev_base = ur->dev_base;
+  ulong dev_sz   = ur->dev_sz;
+
+  ulong dev_off = seq0 % dev_sz;
+
+  ulong rsz = fd_ulong_min( sz, dev_sz - dev_off );
+  ur_pread( dev_fd, dev_base + dev_off, dst, rsz );
+  sz -= rsz;
+
+  if( FD_UNLIKELY( sz ) ) ur_pread( dev_fd, dev_base, dst + rsz, sz );
+}
+
+static void
+fd_vinyl_io_ur_read( fd_vinyl_io_t *    io,
+                     fd_vinyl_io_rd_t * _rd ) {
+  fd_vinyl_io_ur_t *    ur = (fd_vinyl_io_ur_t *)   io;  /* Note: io must be non-NULL to have even been called */
+  fd_vinyl_io_ur_rd_t * rd = (fd_vinyl_io_ur_rd_t *)_rd;
+
+  ulong   seq0 =          rd->seq;
+  uchar * dst  = (uchar *)rd->dst;
+  ulong   sz   =          rd->sz;
+
+  rd->got  = 0UL;
+  rd->pend = 0UL;
+
+  ur->rd_pend++;
+
+  /* If this is a request to read nothing, it is complete immediately.
+     If this is a request to read outside the bstream's past, fail. */
+
+  if( FD_UNLIKELY( !sz ) ) {
+    rd->next          = NULL;
+    *ur->rd_tail_next = rd;
+    ur->rd_tail_next  = &rd->next;
+    return;
+  }
+
+  ulong seq1 = seq0 + sz;
+
+  ulong seq_past    = ur->base->seq_past;
+  ulong seq_present = ur->base->seq_present;
+
+  int bad_seq  = !fd_ulong_is_aligned( seq0, FD_VINYL_BSTREAM_BLOCK_SZ );
+  int bad_dst  = (!fd_ulong_is_aligned( (ulong)dst, FD_VINYL_BSTREAM_BLOCK_SZ )) | !dst;
+  int bad_sz   = !fd_ulong_is_aligned( sz,   FD_VINYL_BSTREAM_BLOCK_SZ );
+  int bad_past = !(fd_vinyl_seq_le( seq_past, seq0 ) & fd_vinyl_seq_lt( seq0, seq1 ) & fd_vinyl_seq_le( seq1, seq_present ));
+
+  if( FD_UNLIKELY( bad_seq | bad_dst | bad_sz | bad_past ) )
+    FD_LOG_CRIT(( "bstream read [%016lx,%016lx)/%lu failed (past [%016lx,%016lx)/%lu, %s)",
+                  seq0, seq1, sz, seq_past, seq_present, seq_present-seq_past,
+                  bad_seq ? "misaligned seq"         :
+                  bad_dst ? "misaligned or NULL dst" :
+                  bad_sz  ? "misaligned sz"          :
+                            "not in past" ));
+
+  /* At this point, we have a valid read request.  Map seq0 into the
+     bstream store and post ring ops for the lesser of sz bytes or until
+     the store end.  If we hit the store end with more to go, wrap
+     around and post the rest at the store start.  Note that rd->pend
+     is fully incremented before anything is submitted so the rd can't
+     complete early. */
+
+  int   dev_fd   = ur->dev_fd;
+  ulong dev_base = ur->dev_base;
+  ulong dev_sz   = ur->dev_sz;
+
+  ulong op_cnt = (sz + FD_VINYL_IO_UR_OP_MAX - 1UL) / FD_VINYL_IO_UR_OP_MAX + 1UL; /* worst case, includes wrap */
+  ur_reserve( ur, op_cnt );
+
+  ulong dev_off = seq0 % dev_sz;
+  while( sz ) {
+    ulong rsz = fd_ulong_min( fd_ulong_min( sz, dev_sz - dev_off ), FD_VINYL_IO_UR_OP_MAX );
+
+    uint buf_idx;
+    int  op = ur_buf_op( ur, 0, dst, rsz, &buf_idx );
+    fd_io_uring_sqe_prep_rw( ur_sqe( ur ), op, dev_fd, dst, rsz, dev_base + dev_off, buf_idx, (ulong)rd );
+    rd->pend++;
+
+    dst     += rsz;
+    sz      -= rsz;
+    dev_off += rsz; if( dev_off==dev_sz ) dev_off = 0UL;
+  }
+}
+
+static int
+fd_vinyl_io_ur_poll( fd_vinyl_io_t *     io,
+                     fd_vinyl_io_rd_t ** _rd,
+                     int                 flags ) {
+  fd_vinyl_io_ur_t * ur = (fd_vinyl_io_ur_t *)io; /* Note: io must be non-NULL to have even been called */
+
+  if( FD_UNLIKELY( !ur->rd_pend ) ) {
+    *_rd = NULL;
+    return FD_VINYL_ERR_EMPTY;
+  }
+
+  /* Submit any prepared ops and reap whatever is done.  If nothing is
+     done yet, block for a completion if allowed. */
+
+  if( !ur->rd_head ) {
+    ur_submit( ur, 0U );
+    ur_reap( ur );
+    if( !ur->rd_head ) {
+      if( !(flags & FD_VINYL_IO_FLAG_BLOCKING) ) {
+        *_rd = NULL;
+        return FD_VINYL_ERR_AGAIN;
+      }
+      do {
+        ur_submit( ur, 1U );
+        ur_reap( ur );
+      } while( !ur->rd_head );
+    }
+  }
+
+  fd_vinyl_io_ur_rd_t *  rd           = ur->rd_head;
+  fd_vinyl_io_ur_rd_t ** rd_tail_next = ur->rd_tail_next;
+  fd_vinyl_io_ur_rd_t *  rd_next      = rd->next;
+
+  ur->rd_head      = rd_next;
+  ur->rd_tail_next = fd_ptr_if( !!rd_next, rd_tail_next, &ur->rd_head );
+  ur->rd_pend--;
+
+  *_rd = (fd_vinyl_io_rd_t *)rd;
+  return FD_VINYL_SUCCESS;
+}
+
+static ulong
+fd_vinyl_io_ur_append( fd_vinyl_io_t * io,
+                       void const *    _src,
+                       ulong           sz ) {
+  fd_vinyl_io_ur_t * ur  = (fd_vinyl_io_ur_t *)io; /* Note: io must be non-NULL to have even been called */
+  uchar const *      src = (uchar const *)_src;
+
+  /* Validate the input args. */
+
+  ulong seq_future  = ur->base->seq_future;  if( FD_UNLIKELY( !sz ) ) return seq_future;
+  ulong seq_ancient = ur->base->seq_ancient;
+  int   dev_fd      = ur->dev_fd;
+  ulong dev_base    = ur->dev_base;
+  ulong dev_sz      = ur->dev_sz;
+
+  int bad_src      = !src;
+  int bad_align    = !fd_ulong_is_aligned( (ulong)src, FD_VINYL_BSTREAM_BLOCK_SZ );
+  int bad_sz       = !fd_ulong_is_aligned( sz,         FD_VINYL_BSTREAM_BLOCK_SZ );
+  int bad_capacity = sz > (dev_sz - (seq_future-seq_ancient));
+
+  if( FD_UNLIKELY( bad_src | bad_align | bad_sz | bad_capacity ) )
+    FD_LOG_CRIT(( bad_src   ? "NULL src"       :
+                  bad_align ? "misaligned src" :
+                  bad_sz    ? "misaligned sz"  :
+                              "device full" ));
+
+  /* At this point, we appear to have a valid append request.  Map it to
+     the bstream (updating seq_future) and map it to the device.  Then
+     post writes for the lesser of sz bytes or until the store end.  If
+     we hit the store end with more to go, wrap around and post the rest
+     at the store start.  The writes will be reaped by commit. */
+
+  ulong seq = seq_future;
+  ur->base->seq_future = seq + sz;
+
+  ulong dev_off = seq % dev_sz;
+  while( sz ) {
+    ulong wsz = fd_ulong_min( fd_ulong_min( sz, dev_sz - dev_off ), FD_VINYL_IO_UR_OP_MAX );
+
+    ur_reserve( ur, 1UL );
+
+    uint buf_idx;
+    int  op = ur_buf_op( ur, 1, src, wsz, &buf_idx );
+    fd_io_uring_sqe_prep_rw( ur_sqe( ur ), op, dev_fd, src, wsz, dev_base + dev_off, buf_idx, (wsz<<2) | FD_VINYL_IO_UR_TAG_WRITE );
+    ur->wr_pend++;
+
+    src     += wsz;
+    sz      -= wsz;
+    dev_off += wsz; if( dev_off==dev_sz ) dev_off = 0UL;
+  }
+
+  return seq;
+}
+
+static int
+fd_vinyl_io_ur_commit( fd_vinyl_io_t * io,
+                       int             flags ) {
+  fd_vinyl_io_ur_t * ur = (fd_vinyl_io_ur_t *)io; /* Note: io must be non-NULL to have even been called */
+
+  /* Submit any prepared ops and wait for all append / copy ops to
+     complete (if allowed). */
+
+  ur_submit( ur, 0U );
+  ur_reap( ur );
+
+  if( FD_UNLIKELY( ur->wr_pend ) ) {
+    if( !(flags & FD_VINYL_IO_FLAG_BLOCKING) ) return FD_VINYL_ERR_AGAIN;
+    do {
+      ur_submit( ur, 1U );
+      ur_reap( ur );
+    } while( ur->wr_pend );
+  }
+
+  ur->base->seq_present = ur->base->seq_future;
+  ur->base->spad_used   = 0UL;
+
+  return FD_VINYL_SUCCESS;
+}
+
+static ulong
+fd_vinyl_io_ur_hint( fd_vinyl_io_t * io,
+                     ulong           sz ) {
+  fd_vinyl_io_ur_t * ur = (fd_vinyl_io_ur_t *)io; /* Note: io must be non-NULL to have even been called */
+
+  ulong seq_future  = ur->base->seq_future;  if( FD_UNLIKELY( !sz ) ) return seq_future;
+  ulong seq_ancient = ur->base->seq_ancient;
+  ulong dev_sz      = ur->dev_sz;
+
+  int bad_sz       = !fd_ulong_is_aligned( sz, FD_VINYL_BSTREAM_BLOCK_SZ );
+  int bad_capacity = sz > (dev_sz - (seq_future-seq_ancient));
+
+  if( FD_UNLIKELY( bad_sz | bad_capacity ) ) FD_LOG_CRIT(( bad_sz ? "misaligned sz" : "device full" ));
+
+  return ur->base->seq_future;
+}
+
+static void *
+fd_vinyl_io_ur_alloc( fd_vinyl_io_t * io,
+                      ulong           sz,
+                      int             flags ) {
+  fd_vinyl_io_ur_t * ur = (fd_vinyl_io_ur_t *)io; /* Note: io must be non-NULL to have even been called */
+
+  ulong spad_max  = ur->base->spad_max;
+  ulong spad_used = ur->base->spad_used; if( FD_UNLIKELY( !sz ) ) return ((uchar *)(ur+1)) + spad_used;
+
+  int bad_align = !fd_ulong_is_aligned( sz, FD_VINYL_BSTREAM_BLOCK_SZ );
+  int bad_sz    = sz > spad_max;
+
+  if( FD_UNLIKELY( bad_align | bad_sz ) ) FD_LOG_CRIT(( bad_align ? "misaligned sz" : "sz too large" ));
+
+  if( FD_UNLIKELY( sz > (spad_max - spad_used ) ) ) {
+    if( FD_UNLIKELY( fd_vinyl_io_ur_commit( io, flags ) ) ) return NULL;
+    spad_used = 0UL;
+  }
+
+  ur->base->spad_used = spad_used + sz;
+
+  return ((uchar *)(ur+1)) + spad_used;
+}
+
+static ulong
+fd_vinyl_io_ur_copy( fd_vinyl_io_t * io,
+                     ulong           seq_src0,
+                     ulong           sz ) {
+  fd_vinyl_io_ur_t * ur = (fd_vinyl_io_ur_t *)io; /* Note: io must be non-NULL to have even been called */
+
+  /* Validate the input args */
+
+  ulong seq_ancient = ur->base->seq_ancient;
+  ulong seq_past    = ur->base->seq_past;
+  ulong seq_present = ur->base->seq_present;
+  ulong seq_future  = ur->base->seq_future;   if( FD_UNLIKELY( !sz ) ) return seq_future;
+  ulong spad_max    = ur->base->spad_max;
+  int   dev_fd      = ur->dev_fd;
+  ulong dev_base    = ur->dev_base;
+  ulong dev_sz      = ur->dev_sz;
+
+  ulong seq_src1 = seq_src0 + sz;
+
+  int bad_past     = !( fd_vinyl_seq_le( seq_past, seq_src0    ) &
+                        fd_vinyl_seq_lt( seq_src0, seq_src1    ) &
+                        fd_vinyl_seq_le( seq_src1, seq_present ) );
+  int bad_src      = !fd_ulong_is_aligned( seq_src0, FD_VINYL_BSTREAM_BLOCK_SZ );
+  int bad_sz       = !fd_ulong_is_aligned( sz,       FD_VINYL_BSTREAM_BLOCK_SZ );
+  int bad_capacity = sz > (dev_sz - (seq_future-seq_ancient));
+
+  if( FD_UNLIKELY( bad_past | bad_src | bad_sz | bad_capacity ) )
+    FD_LOG_CRIT(( bad_past ? "src is not in the past"    :
+                  bad_src  ? "misaligned src_seq"        :
+                  bad_sz   ? "misaligned sz"             :
+                             "device full" ));
+
+  /* At this point, we appear to have a valid copy request.  Copy as
+     much as we can at a time, handling device wrap around.  Each chunk
+     is bounced through scratch pad memory with a read linked to a
+     write, so the kernel does the whole copy without a round trip
+     through the caller.  The bounce memory stays allocated (and the
+     copy writes are reaped) at the next commit.  If we run out of
+     scratch pad, we do a blocking commit to free it up. */
+
+  ulong seq = seq_future;
+
+  ulong seq_dst0 = seq;
+
+  for(;;) {
+    ulong src_off = seq_src0 % dev_sz;
+    ulong dst_off = seq_dst0 % dev_sz;
+    ulong csz     = fd_ulong_min( fd_ulong_min( fd_ulong_min( sz, spad_max ), FD_VINYL_IO_UR_OP_MAX ),
+                                  fd_ulong_min( dev_sz - src_off, dev_sz - dst_off ) );
+
+    if( FD_UNLIKELY( csz>(spad_max-ur->base->spad_used) ) ) fd_vinyl_io_ur_commit( io, FD_VINYL_IO_FLAG_BLOCKING );
+
+    uchar * buf = (uchar *)(ur+1) + ur->base->spad_used;
+    ur->base->spad_used += csz;
+    ur->base->seq_future = seq_dst0 + csz;
+
+    ur_reserve( ur, 2UL ); /* linked ops must be contiguous in the SQ */
+
+    uint rd_idx; int rd_op = ur_buf_op( ur, 0, buf, csz, &rd_idx );
+    uint wr_idx; int wr_op = ur_buf_op( ur, 1, buf, csz, &wr_idx );
+
+    struct io_uring_sqe * sqe = ur_sqe( ur );
+    fd_io_uring_sqe_prep_rw( sqe, rd_op, dev_fd, buf, csz, dev_base + src_off, rd_idx, (csz<<2) | FD_VINYL_IO_UR_TAG_COPY_RD );
+    sqe->flags |= IOSQE_IO_LINK;
+    fd_io_uring_sqe_prep_rw( ur_sqe( ur ), wr_op, dev_fd, buf, csz, dev_base + dst_off, wr_idx, (csz<<2) | FD_VINYL_IO_UR_TAG_WRITE );
+    ur->wr_pend += 2UL;
+
+    sz -= csz;
+    if( !sz ) break;
+
+    seq_src0 += csz;
+    seq_dst0 += csz;
+  }
+
+  return seq;
+}
+
+static void
+fd_vinyl_io_ur_forget( fd_vinyl_io_t * io,
+                       ulong           seq ) {
+  fd_vinyl_io_ur_t * ur = (fd_vinyl_io_ur_t *)io; /* Note: io must be non-NULL to have even been called */
+
+  /* Validate input arguments.  Note that we don't allow forgetting into
+     the future even when we have no uncommitted blocks because the
+     resulting [seq_ancient,seq_future) might contain blocks that were
+     never written (which might not be an issue practically but it would
+     be a bit strange for something to try to scan starting from
+     seq_ancient and discover unwritten blocks). */
+
+  ulong seq_past    = ur->base->seq_past;
+  ulong seq_present = ur->base->seq_present;
+  ulong seq_future  = ur->base->seq_future;
+
+  int bad_seq    = !fd_ulong_is_aligned( seq, FD_VINYL_BSTREAM_BLOCK_SZ );
+  int bad_dir    = !(fd_vinyl_seq_le( seq_past, seq ) & fd_vinyl_seq_le( seq, seq_present ));
+  int bad_read   = !!ur->rd_pend;
+  int bad_append = fd_vinyl_seq_ne( seq_present, seq_future );
+
+  if( FD_UNLIKELY( bad_seq | bad_dir | bad_read | bad_append ) )
+    FD_LOG_CRIT(( "forget to seq %016lx failed (past [%016lx,%016lx)/%lu, %s)",
+                  seq, seq_past, seq_present, seq_present-seq_past,
+                  bad_seq  ? "misaligned seq"             :
+                  bad_dir  ? "seq out of bounds"          :
+                  bad_read ? "reads in progress"          :
+                             "appends/copies in progress" ));
+
+  ur->base->seq_past = seq;
+}
+
+static void
+fd_vinyl_io_ur_rewind( fd_vinyl_io_t * io,
+                       ulong           seq ) {
+  fd_vinyl_io_ur_t * ur = (fd_vinyl_io_ur_t *)io; /* Note: io must be non-NULL to have even been called */
+
+  /* Validate input argments.  Unlike forgot, we do allow rewinding to
+     before seq_ancient as the region of sequence space reported to the
+     caller as written is still accurate. */
+
+  ulong seq_ancient = ur->base->seq_ancient;
+  ulong seq_past    = ur->base->seq_past;
+  ulong seq_present = ur->base->seq_present;
+  ulong seq_future  = ur->base->seq_future;
+
+  int bad_seq    = !fd_ulong_is_aligned( seq, FD_VINYL_BSTREAM_BLOCK_SZ );
+  int bad_dir    = fd_vinyl_seq_gt( seq, seq_present );
+  int bad_read   = !!ur->rd_pend;
+  int bad_append = fd_vinyl_seq_ne( seq_present, seq_future );
+
+  if( FD_UNLIKELY( bad_seq | bad_dir | bad_read | bad_append ) )
+    FD_LOG_CRIT(( "rewind to seq %016lx failed (present %016lx, %s)", seq, seq_present,
+                  bad_seq  ? "misaligned seq"             :
+                  bad_dir  ? "seq after seq_present"      :
+                  bad_read ? "reads in progress"          :
+                             "appends/copies in progress" ));
+
+  ur->base->seq_ancient = fd_ulong_if( fd_vinyl_seq_ge( seq, seq_ancient ), seq_ancient, seq );
+  ur->base->seq_past    = fd_ulong_if( fd_vinyl_seq_ge( seq, seq_past    ), seq_past,    seq );
+  ur->base->seq_present = seq;
+  ur->base->seq_future  = seq;
+}
+
+static int
+fd_vinyl_io_ur_sync( fd_vinyl_io_t * io,
+                     int             flags ) {
+  fd_vinyl_io_ur_t * ur = (fd_vinyl_io_ur_t *)io; /* Note: io must be non-NULL to have even been called */
+  (void)flags;
+
+  ulong seed        = ur->base->seed;
+  ulong seq_past    = ur->base->seq_past;
+  ulong seq_present = ur->base->seq_present;
+
+  int   dev_fd       = ur->dev_fd;
+  ulong dev_sync     = ur->dev_sync;
+
+  fd_vinyl_bstream_block_t * block = ur->sync;
+
+  /* block->sync.ctl     current (static) */
+  block->sync.seq_past    = seq_past;
+  block->sync.seq_present = seq_present;
+  /* block->sync.info_sz current (static) */
+  /* block->sync.info    current (static) */
+
+  block->sync.hash_trail  = 0UL;
+  block->sync.hash_blocks = 0UL;
+  fd_vinyl_bstream_block_hash( seed, block ); /* sets hash_trail back to seed */
+
+  /* Note: every block in the bstream's past has been reaped by a
+     commit at this point so it is safe to write the sync block
+     directly. */
+
+  ur_pwrite( dev_fd, dev_sync, block, FD_VINYL_BSTREAM_BLOCK_SZ );
+
+  ur->base->seq_ancient = seq_past;
+
+  return FD_VINYL_SUCCESS;
+}
+
+static void *
+fd_vinyl_io_ur_fini( fd_vinyl_io_t * io ) {
+  fd_vinyl_io_ur_t * ur = (fd_vinyl_io_ur_t *)io; /* Note: io must be non-NULL to have even been called */
+
+  ulong seq_present = ur->base->seq_present;
+  ulong seq_future  = ur->base->seq_future;
+
+  if( FD_UNLIKELY( ur->rd_pend                                ) ) FD_LOG_WARNING(( "fini completing outstanding reads" ));
+  if( FD_UNLIKELY( fd_vinyl_seq_ne( seq_present, seq_future ) ) ) FD_LOG_WARNING(( "fini discarding uncommited blocks" ));
+
+  /* Drain the ring such that the kernel retains no interest in any
+     caller memory. */
+
+  ur_submit( ur, 0U );
+  ur_reap( ur );
+  while( ur->op_pend ) {
+    ur_submit( ur, 1U );
+    ur_reap( ur );
+  }
+
+  fd_io_uring_fini( ur->ring );
+
+  return io;
+}
+
+static fd_vinyl_io_impl_t fd_vinyl_io_ur_impl[1] = { {
+  fd_vinyl_io_ur_read_imm,
+  fd_vinyl_io_ur_read,
+  fd_vinyl_io_ur_poll,
+  fd_vinyl_io_ur_append,
+  fd_vinyl_io_ur_commit,
+  fd_vinyl_io_ur_hint,
+  fd_vinyl_io_ur_alloc,
+  fd_vinyl_io_ur_copy,
+  fd_vinyl_io_ur_forget,
+  fd_vinyl_io_ur_rewind,
+  fd_vinyl_io_ur_sync,
+  fd_vinyl_io_ur_fini
+} };
+
+FD_STATIC_ASSERT( alignof(fd_vinyl_io_ur_t)==FD_VINYL_BSTREAM_BLOCK_SZ, layout );
+
+ulong
+fd_vinyl_io_ur_align( void ) {
+  return alignof(fd_vinyl_io_ur_t);
+}
+
+ulong
+fd_vinyl_io_ur_footprint( ulong spad_max ) {
+  if( FD_UNLIKELY( !((0UL<spad_max) & (spad_max<(1UL<<63)) & fd_ulong_is_aligned( spad_max, FD_VINYL_BSTREAM_BLOCK_SZ )) ) )
+    return 0UL;
+  return sizeof(fd_vinyl_io_ur_t) + spad_max;
+}
+
+/* fd_vinyl_io_ur_private_init implements fd_vinyl_io_ur_init (ring
+   NULL, a ring with depth entries is created) and
+   fd_vinyl_io_ur_init_ring (ring non-NULL, depth is ignored).  A caller
+   provided ring is never finalized here. */
+
+static fd_vinyl_io_t *
+fd_vinyl_io_ur_private_init( void *          mem,
+                             ulong           spad_max,
+                             int             dev_fd,
+                             fd_io_uring_t * ring,
+                             ulong           depth,
+                             void *          rd_mem,
+                             ulong           rd_mem_sz,
+                             int             reset,
+                             void const *    info,
+                             ulong           info_sz,
+                             ulong           io_seed ) {
+  fd_vinyl_io_ur_t * ur = (fd_vinyl_io_ur_t *)mem;
+
+  if( ring ) depth = (ulong)ring->sq_depth;
+
+  if( FD_UNLIKELY( !ur ) ) {
+    FD_LOG_WARNING(( "NULL mem" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !fd_ulong_is_aligned( (ulong)ur, fd_vinyl_io_ur_align() ) ) ) {
+    FD_LOG_WARNING(( "misaligned mem" ));
+    return NULL;
+  }
+
+  ulong footprint = fd_vinyl_io_ur_footprint( spad_max );
+  if( FD_UNLIKELY( !footprint ) ) {
+    FD_LOG_WARNING(( "bad spad_max" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !((0UL<depth) & (depth<=FD_VINYL_IO_UR_DEPTH_MAX)) ) ) {
+    FD_LOG_WARNING(( "bad depth" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !rd_mem ) ) rd_mem_sz = 0UL;
+
+  off_t _dev_sz = lseek( dev_fd, (off_t)0, SEEK_END );
+  if( FD_UNLIKELY( _dev_sz<(off_t)0 ) ) {
+    FD_LOG_WARNING(( "lseek failed, bstream must be seekable (%i-%s)", errno, fd_io_strerror( errno ) ));
+    return NULL;
+  }
+  ulong dev_sz = (ulong)_dev_sz;
+
+  ulong dev_sz_min = 3UL*FD_VINYL_BSTREAM_BLOCK_SZ /* sync block, move block, closing partition */
+                   + fd_vinyl_bstream_pair_sz( FD_VINYL_VAL_MAX ); /* worst case pair (FIXME: LZ4_COMPRESSBOUND?) */
+
+  int too_small  = dev_sz < dev_sz_min;
+  int too_large  = dev_sz > (ulong)LONG_MAX;
+  int misaligned = !fd_ulong_is_aligned( dev_sz, FD_VINYL_BSTREAM_BLOCK_SZ );
+
+  if( FD_UNLIKELY( too_small | too_large | misaligned ) ) {
+    FD_LOG_WARNING(( "bstream size %s", too_small ? "too small" :
+                                        too_large ? "too large" :
+                                                    "not a block size multiple" ));
+    return NULL;
+  }
+
+  if( reset ) {
+    if( FD_UNLIKELY( !info ) ) info_sz = 0UL;
+    if( FD_UNLIKELY( info_sz>FD_VINYL_BSTREAM_SYNC_INFO_MAX ) ) {
+      FD_LOG_WARNING(( "info_sz too large" ));
+      return NULL;
+    }
+  }
+
+  int dev_flags = fcntl( dev_fd, F_GETFL );
+  int direct    = (dev_flags!=-1) && !!(dev_flags & O_DIRECT);
+
+  memset( ur, 0, footprint );
+
+  if( ring ) {
+    *ur->ring = *ring;
+  } else if( FD_UNLIKELY( !fd_io_uring_init( ur->ring, (uint)depth, 0U ) ) ) {
+    FD_LOG_WARNING(( "io_uring init failed" ));
+    return NULL;
+  }
+
+  /* Register the spad (and rd_mem if provided) with the ring.  If the
+     kernel won't let us (e.g. RLIMIT_MEMLOCK), we fall back to
+     unregistered buffers. */
+
+  struct iovec iov[2];
+  iov[0].iov_base = ur+1;   iov[0].iov_len = spad_max;
+  iov[1].iov_base = rd_mem; iov[1].iov_len = rd_mem_sz;
+
+  int fixed = !fd_io_uring_register_buffers( ur->ring, iov, rd_mem_sz ? 2U : 1U ); /* logs details */
+  if( FD_UNLIKELY( !fixed ) ) FD_LOG_WARNING(( "unable to register buffers, falling back to unregistered buffer ops" ));
+
+  ur->base->type = FD_VINYL_IO_TYPE_UR;
+
+  /* io_seed, seq_ancient, seq_past, seq_present, seq_future are init
+     below */
+
+  ur->base->spad_max  = spad_max;
+  ur->base->spad_used = 0UL;
+  ur->base->impl      = fd_vinyl_io_ur_impl;
+
+  ur->dev_fd    = dev_fd;
+  ur->fixed     = fixed;
+  ur->dev_sync  = 0UL;                            /* Use the beginning of the file for the sync block */
+  ur->dev_base  = FD_VINYL_BSTREAM_BLOCK_SZ;      /* Use the rest for the actual bstream store (at least 3.5 KiB) */
+  ur->dev_sz    = dev_sz - FD_VINYL_BSTREAM_BLOCK_SZ;
+  ur->rd_mem    = (ulong)rd_mem;
+  ur->rd_mem_sz = rd_mem_sz;
+  ur->op_max    = (ulong)ur->ring->cq_depth;
+  ur->op_pend   = 0UL;
+  ur->wr_pend   = 0UL;
+  ur->rd_pend   = 0UL;
+
+  ur->rd_head      = NULL;
+  ur->rd_tail_next = &ur->rd_head;
+
+  /* Note that [seq_ancient,seq_future) (cyclic) contains at most dev_sz
+     bytes, bstream's antiquity, past and present are subsets of this
+     range and dev_sz is less than 2^63 given the above (practically
+     much much less).  As such, differences between two ordered bstream
+     sequence numbers (e.g. ulong sz = seq_a - seq_b where a is
+     logically not before b) will "just work" regardless of wrapping
+     and/or amount of data stored. */
+
+  fd_vinyl_bstream_block_t * block = ur->sync;
+
+  if( reset ) {
+
+    /* We are starting a new bstream.  Write the initial sync block. */
+
+    ur->base->seed        = io_seed;
+    ur->base->seq_ancient = 0UL;
+    ur->base->seq_past    = 0UL;
+    ur->base->seq_present = 0UL;
+    ur->base->seq_future  = 0UL;
+
+    memset( block, 0, FD_VINYL_BSTREAM_BLOCK_SZ ); /* bulk zero */
+
+    block->sync.ctl         = fd_vinyl_bstream_ctl( FD_VINYL_BSTREAM_CTL_TYPE_SYNC, 0, FD_VINYL_VAL_MAX );
+  //block->sync.seq_past    = ...; /* init by sync */
+  //block->sync.seq_present = ...; /* init by sync */
+    block->sync.info_sz     = info_sz;
+    if( info_sz ) memcpy( block->sync.info, info, info_sz );
+  //block->sync.hash_trail  = ...; /* init by sync */
+  //block->sync.hash_blocks = ...; /* init by sync */
+
+    int err = fd_vinyl_io_ur_sync( ur->base, FD_VINYL_IO_FLAG_BLOCKING ); /* logs details */
+    if( FD_UNLIKELY( err ) ) {
+      FD_LOG_WARNING(( "sync block write failed (%i-%s)", err, fd_vinyl_strerror( err ) ));
+      if( !ring ) fd_io_uring_fini( ur->ring );
+      return NULL;
+    }
+
+  } else {
+
+    /* We are resuming an existing bstream.  Read and validate the
+       bstream's sync block. */
+
+    ur_pread( dev_fd, ur->dev_sync, block, FD_VINYL_BSTREAM_BLOCK_SZ ); /* logs details */
+
+    int   type        = fd_vinyl_bstream_ctl_type ( block->sync.ctl );
+    int   version     = fd_vinyl_bstream_ctl_style( block->sync.ctl );
+    ulong val_max     = fd_vinyl_bstream_ctl_sz   ( block->sync.ctl );
+    ulong seq_past    = block->sync.seq_past;
+    ulong seq_present = block->sync.seq_present;
+    /**/  info_sz     = block->sync.info_sz;    // overrides user info_sz
+    /**/  info        = block->sync.info;       // overrides user info
+    /**/  io_seed     = block->sync.hash_trail; // overrides user io_seed
+
+    int bad_type        = (type != FD_VINYL_BSTREAM_CTL_TYPE_SYNC);
+    int bad_version     = (version != 0);
+    int bad_val_max     = (val_max != FD_VINYL_VAL_MAX);
+    int bad_seq_past    = !fd_ulong_is_aligned( seq_past,    FD_VINYL_BSTREAM_BLOCK_SZ );
+    int bad_seq_present = !fd_ulong_is_aligned( seq_present, FD_VINYL_BSTREAM_BLOCK_SZ );
+    int bad_info_sz     = (info_sz > FD_VINYL_BSTREAM_SYNC_INFO_MAX);
+    int bad_past_order  = fd_vinyl_seq_gt( seq_past, seq_present );
+    int bad_past_sz     = ((seq_present-seq_past) > ur->dev_sz);
+
+    if( FD_UNLIKELY( bad_type | bad_version | bad_val_max | bad_seq_past | bad_seq_present | bad_info_sz |
+                     bad_past_order | bad_past_sz ) ) {
+      FD_LOG_WARNING(( "bad sync block when recovering bstream (%s)",
+                       bad_type        ? "unexpected type"                             :
+                       bad_version     ? "unexpected version"                          :
+                       bad_val_max     ? "unexpected max pair value decoded byte size" :
+                       bad_seq_past    ? "unaligned seq_past"                          :
+                       bad_seq_present ? "unaligned seq_present"                       :
+                       bad_info_sz     ? "unexpected info size"                        :
+                       bad_past_order  ? "unordered seq_past and seq_present"          :
+                                         "past size larger than bstream store" ));
+      if( !ring ) fd_io_uring_fini( ur->ring );
+      return NULL;
+    }
+
+    if( FD_UNLIKELY( fd_vinyl_bstream_block_test( io_seed, block ) ) ) {
+      FD_LOG_WARNING(( "corrupt sync block when recovering bstream" ));
+      if( !ring ) fd_io_uring_fini( ur->ring );
+      return NULL;
+    }
+
+    ur->base->seed        = io_seed;
+    ur->base->seq_ancient = seq_past;
+    ur->base->seq_past    = seq_past;
+    ur->base->seq_present = seq_present;
+    ur->base->seq_future  = seq_present;
+
+  }
+
+  FD_LOG_NOTICE(( "IO config"
+                  "\n\ttype      ur"
+                  "\n\tspad_max  %lu bytes"
+                  "\n\tdev_sz    %lu bytes"
+                  "\n\tdepth     %lu (sq %u, cq %u)"
+                  "\n\tdirect    %i"
+                  "\n\tfixed     %i (rd_mem_sz %lu bytes)"
+                  "\n\treset     %i"
+                  "\n\tinfo      \"%s\" (info_sz %lu%s)"
+                  "\n\tio_seed   0x%016lx%s",
+                  spad_max, dev_sz, depth, ur->ring->sq_depth, ur->ring->cq_depth, direct, fixed, rd_mem_sz, reset,
+                  info ? (char const *)info : "", info_sz, reset ? "" : ", discovered",
+                  io_seed, reset ? "" : " (discovered)" ));
+
+  return ur->base;
+}
+
+fd_vinyl_io_t *
+fd_vinyl_io_ur_init( void *       mem,
+                     ulong        spad_max,
+                     int          dev_fd,
+                     ulong        depth,
+                     void *       rd_mem,
+                     ulong        rd_mem_sz,
+                     int          reset,
+                     void const * info,
+                     ulong        info_sz,
+                     ulong        io_seed ) {
+  return fd_vinyl_io_ur_private_init( mem, spad_max, dev_fd, NULL, depth, rd_mem, rd_mem_sz, reset, info, info_sz, io_seed );
+}
+
+fd_vinyl_io_t *
+fd_vinyl_io_ur_init_ring( void *          mem,
+                          ulong           spad_max,
+                          int             dev_fd,
+                          fd_io_uring_t * ring,
+                          void *          rd_mem,
+                          ulong           rd_mem_sz,
+                          int             reset,
+                          void const *    info,
+                          ulong           info_sz,
+                          ulong           io_seed ) {
+  if( FD_UNLIKELY( !ring ) ) {
+    FD_LOG_WARNING(( "NULL ring" ));
+    return NULL;
+  }
+
+  fd_vinyl_io_t * io = fd_vinyl_io_ur_private_init( mem, spad_max, dev_fd, ring, 0UL, rd_mem, rd_mem_sz, reset, info, info_sz, io_seed );
+  if( FD_UNLIKELY( !io ) ) fd_io_uring_fini( ring );
+  return io;
+}
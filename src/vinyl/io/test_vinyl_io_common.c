@@ -10,6 +10,15 @@ static ulong seq_future;
 
 static uchar bcache[ BCACHE_SZ ];
 
+/* Appended bytes must not be modified until they are committed (the
+   io might still be writing them, e.g. fd_vinyl_io_ur).  So appends are
+   sourced from an arena that is only reused after a commit. */
+
+#define ARENA_SZ (1UL<<20)
+
+static uchar arena[ ARENA_SZ ] __attribute__((aligned(FD_VINYL_BSTREAM_BLOCK_SZ)));
+static ulong arena_used;
+
 static void
 bcache_read( ulong seq0, void * _dst, ulong sz ) {
   if( !sz ) return;
@@ -109,11 +118,17 @@ test( fd_vinyl_io_t * io,
       ulong dev_free = BCACHE_SZ - (seq_future-seq_ancient);
       ulong sz       = fd_ulong_min( FD_VINYL_BSTREAM_BLOCK_SZ*fd_rng_coin_tosses( rng ), fd_ulong_min( dev_free, 16384UL ) );
 
-      uchar buf[ 16384 ] __attribute__((aligned(FD_VINYL_BSTREAM_BLOCK_SZ)));
+      if( FD_UNLIKELY( sz>(ARENA_SZ-arena_used) ) ) {
+        FD_TEST( !bcache_commit() );
+        FD_TEST( !fd_vinyl_io_commit( io, FD_VINYL_IO_FLAG_BLOCKING ) );
+        arena_used = 0UL;
+      }
+
+      uchar * buf = arena + arena_used;
 
       void * src;
       if( !sz ) src = (void *)fd_rng_ulong( rng );
-      else      src = buf, memset( buf, (int)(fd_rng_uint( rng ) & 255U), sz );
+      else      src = buf, memset( buf, (int)(fd_rng_uint( rng ) & 255U), sz ), arena_used += sz;
 
       ulong seq_ref  =      bcache_append(     src, sz );
       ulong seq_tst  = fd_vinyl_io_append( io, src, sz );
@@ -142,6 +157,7 @@ test( fd_vinyl_io_t * io,
       int err_tst = fd_vinyl_io_commit( io, FD_VINYL_IO_FLAG_BLOCKING );
       FD_TEST( err_ref==err_tst );
       FD_TEST( !err_tst );
+      arena_used = 0UL;
       break;
     }
 
@@ -224,6 +240,7 @@ test( fd_vinyl_io_t * io,
 
   bcache_commit();
   FD_TEST( !fd_vinyl_io_commit( io, FD_VINYL_IO_FLAG_BLOCKING ) );
+  arena_used = 0UL;
 
   bcache_sync();
   FD_TEST( !fd_vinyl_io_sync( io, FD_VINYL_IO_FLAG_BLOCKING ) );
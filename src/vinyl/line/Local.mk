@@ -0,0 +1 @@
+$(call add-hdrs,fd_vinyl_line.h)
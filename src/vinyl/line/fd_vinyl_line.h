@@ -0,0 +1,57 @@
+#ifndef HEADER_fd_src_vinyl_line_fd_vinyl_line_h
+#define HEADER_fd_src_vinyl_line_fd_vinyl_line_h
+
+/* A vinyl line describes a slot of the vinyl data region (vinyl_data)
+   that can hold a decoded pair.  Lines are local to the vinyl tile (the
+   data region itself is shared with clients).  A line is either free
+   or bound to a meta element.  While bound, the line's data slot holds
+   a copy of the pair in its decoded form (i.e. a style RAW pair header
+   followed by the pair val).  The meta element's line_idx field and the
+   line's ele_idx field point at each other.
+
+   A bound line is either acquired by one or more clients (ref!=0) or
+   cached (ref==0).  A cached line holds the key's current version so
+   that subsequent acquires of the key can be served without reading
+   the bstream.  When there are no free lines, cached lines are evicted
+   with the CLOCK algorithm: used is set whenever a line is acquired and
+   the clock hand clears used on lines it passes over, evicting the
+   first cached line whose used is already clear.  Acquired lines are
+   pinned (never evicted). */
+
+#include "../bstream/fd_vinyl_bstream.h"
+
+/* FD_VINYL_LINE_MAX gives the max number of lines a vinyl instance can
+   have.  Limited such that line indices and line data offsets fit
+   comfortably. */
+
+#define FD_VINYL_LINE_MAX (1UL<<32)
+
+/* FD_VINYL_LINE_REF_MODIFY is the line ref count used to indicate the
+   line has been acquired for modify by a client. */
+
+#define FD_VINYL_LINE_REF_MODIFY (-1L)
+
+struct fd_vinyl_line {
+  ulong ele_idx;   /* Meta element bound to this line, ULONG_MAX if free */
+  long  ref;       /* 0: not acquired, positive: number of outstanding read acquires, FD_VINYL_LINE_REF_MODIFY: acquired for modify */
+  ulong next_idx;  /* If free, next line in the free list (ULONG_MAX if last) */
+  int   used;      /* If bound, 1 if the line was acquired since the clock hand last passed it */
+};
+
+typedef struct fd_vinyl_line fd_vinyl_line_t;
+
+FD_PROTOTYPES_BEGIN
+
+/* fd_vinyl_line_data_sz returns the footprint of a data region line
+   slot that can hold decoded pairs with vals up to val_max bytes.
+   Assumes val_max is in [0,FD_VINYL_VAL_MAX].  Will be a multiple of
+   FD_VINYL_BSTREAM_BLOCK_SZ. */
+
+FD_FN_CONST static inline ulong
+fd_vinyl_line_data_sz( ulong val_max ) {
+  return fd_vinyl_bstream_pair_sz( val_max );
+}
+
+FD_PROTOTYPES_END
+
+#endif /* HEADER_fd_src_vinyl_line_fd_vinyl_line_h */
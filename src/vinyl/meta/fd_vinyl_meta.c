@@ -51,7 +51,7 @@ fd_vinyl_meta_query_fast( fd_vinyl_meta_ele_t const * ele0,
   return err;
 }
 
-//#include "../line/fd_vinyl_line.h" /* FIXME: gross (maybe make line below meta in the API hierarchy?) */
+#include "../line/fd_vinyl_line.h"
 
 void
 fd_vinyl_meta_remove_fast( fd_vinyl_meta_ele_t * ele0,
@@ -141,9 +141,8 @@ fd_vinyl_meta_remove_fast( fd_vinyl_meta_ele_t * ele0,
 
       ulong line_idx = ele0[ ele_idx ].line_idx;
       if( FD_LIKELY( line_idx< line_cnt  ) ) {
-        (void)line;
-//      FD_CRIT( line[ line_idx ].ele_idx==ele_idx, "corruption detected" );
-//      line[ line_idx ].ele_idx = hole_idx;
+        FD_CRIT( line[ line_idx ].ele_idx==ele_idx, "corruption detected" );
+        line[ line_idx ].ele_idx = hole_idx;
       } else {
         FD_CRIT( line_idx==ULONG_MAX, "corruption detected" );
       }
@@ -0,0 +1,6 @@
+$(call add-hdrs,fd_vinyl_recover.h)
+$(call add-objs,fd_vinyl_recover,fd_vinyl)
+ifdef FD_HAS_LZ4
+$(call make-unit-test,test_vinyl_recover,test_vinyl_recover,fd_vinyl fd_tango fd_util)
+$(call run-unit-test,test_vinyl_recover)
+endif
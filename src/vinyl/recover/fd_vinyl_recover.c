@@ -0,0 +1,533 @@
+#include "fd_vinyl_recover.h"
+
+/* FD_VINYL_RECOVER_SCAN_BLOCK_CNT gives the number of blocks read from
+   the bstream at a time while scanning (scans are done with blocking
+   reads, so this amortizes the per read overhead of io backends that
+   do a syscall per read). */
+
+#define FD_VINYL_RECOVER_SCAN_BLOCK_CNT (64UL)
+
+/* A fd_vinyl_recover_private_rd_t buffers blocks of a bstream's past
+   read for scanning.  It is local to the thread doing the scan. */
+
+struct fd_vinyl_recover_private_rd {
+  fd_vinyl_io_t *          io;
+  ulong                    seq0;  /* buf holds bstream blocks [seq0,seq1) */
+  ulong                    seq1;
+  ulong                    end;   /* Never read at or after end */
+  fd_vinyl_bstream_block_t buf[ FD_VINYL_RECOVER_SCAN_BLOCK_CNT ];
+};
+
+typedef struct fd_vinyl_recover_private_rd fd_vinyl_recover_private_rd_t;
+
+/* fd_vinyl_recover_private_rd_block returns a pointer to the buffered
+   copy of the bstream block at seq, reading forward from seq if it is
+   not already buffered.  Assumes seq is a BLOCK_SZ multiple in the past
+   before end.  The returned block is valid until the next call. */
+
+static fd_vinyl_bstream_block_t *
+fd_vinyl_recover_private_rd_block( fd_vinyl_recover_private_rd_t * rd,
+                                   ulong                           seq ) {
+  if( FD_UNLIKELY( !(fd_vinyl_seq_le( rd->seq0, seq ) & fd_vinyl_seq_lt( seq, rd->seq1 )) ) ) {
+    ulong sz = fd_ulong_min( rd->end - seq, FD_VINYL_RECOVER_SCAN_BLOCK_CNT*FD_VINYL_BSTREAM_BLOCK_SZ );
+    fd_vinyl_io_read_imm( rd->io, seq, rd->buf, sz );
+    rd->seq0 = seq;
+    rd->seq1 = seq + sz;
+  }
+  return rd->buf + (seq - rd->seq0) / FD_VINYL_BSTREAM_BLOCK_SZ;
+}
+
+/* fd_vinyl_recover_private_is_part returns 1 if block (read from seq)
+   is a valid partition block and 0 otherwise. */
+
+static int
+fd_vinyl_recover_private_is_part( ulong                      io_seed,
+                                  ulong                      seq,
+                                  fd_vinyl_bstream_block_t * block ) {
+  if( FD_LIKELY( fd_vinyl_bstream_ctl_type( block->ctl )!=FD_VINYL_BSTREAM_CTL_TYPE_PART ) ) return 0;
+  fd_vinyl_bstream_block_t tmp[1]; *tmp = *block; /* part_test clobbers the block's hash */
+  return !fd_vinyl_bstream_part_test( io_seed, seq, tmp );
+}
+
+ulong
+fd_vinyl_recover_tail( fd_vinyl_io_t * io ) {
+
+  ulong seq_past    = fd_vinyl_io_seq_past   ( io );
+  ulong seq_present = fd_vinyl_io_seq_present( io );
+  ulong io_seed     = fd_vinyl_io_seed       ( io );
+
+  /* Scan backward from seq_present in chunks for the last partition
+     block.  Note that blocks in the interior of a pair can have
+     arbitrary contents but a block that has the ctl of a partition
+     block, the seq of where it is located and a valid hash (seeded
+     with io_seed) is a partition block for all practical purposes. */
+
+  fd_vinyl_bstream_block_t buf[ FD_VINYL_RECOVER_SCAN_BLOCK_CNT ];
+
+  ulong seq1 = seq_present;
+  while( fd_vinyl_seq_gt( seq1, seq_past ) ) {
+    ulong sz   = fd_ulong_min( seq1 - seq_past, FD_VINYL_RECOVER_SCAN_BLOCK_CNT*FD_VINYL_BSTREAM_BLOCK_SZ );
+    ulong seq0 = seq1 - sz;
+    fd_vinyl_io_read_imm( io, seq0, buf, sz );
+    for( ulong block_idx=sz/FD_VINYL_BSTREAM_BLOCK_SZ; block_idx; block_idx-- ) {
+      ulong seq = seq0 + (block_idx-1UL)*FD_VINYL_BSTREAM_BLOCK_SZ;
+      if( fd_vinyl_recover_private_is_part( io_seed, seq, buf + block_idx-1UL ) ) return seq + FD_VINYL_BSTREAM_BLOCK_SZ;
+    }
+    seq1 = seq0;
+  }
+
+  return seq_past;
+}
+
+/* fd_vinyl_recover_private_merge merges a reference to key by the
+   bstream object at seq into the meta.  ctl / info give the key's state
+   as of seq (for erases, ctl is the ctl of a dead block).  If the meta
+   already has a reference to key from a later object, this is a no-op.
+   Returns FD_VINYL_SUCCESS or FD_VINYL_ERR_FULL (no room in the meta
+   for key).  Increments *_ins_cnt if key was inserted into the meta. */
+
+static int
+fd_vinyl_recover_private_merge( fd_vinyl_meta_t *       meta,
+                                fd_vinyl_key_t const *  key,
+                                ulong                   ctl,
+                                fd_vinyl_info_t const * info,
+                                ulong                   seq,
+                                ulong *                 _ins_cnt ) {
+
+  fd_vinyl_meta_query_t query[1];
+
+  int err = fd_vinyl_meta_prepare( meta, key, NULL, query, FD_MAP_FLAG_BLOCKING );
+  if( FD_UNLIKELY( err ) ) return FD_VINYL_ERR_FULL; /* Only FULL is possible for a blocking prepare */
+
+  fd_vinyl_meta_ele_t * ele = fd_vinyl_meta_query_ele( query );
+
+  if( FD_LIKELY( !fd_vinyl_meta_ele_in_use( ele ) ) ) {
+    ele->memo     = fd_vinyl_meta_query_memo( query );
+    ele->phdr.key = *key;
+    ele->line_idx = ULONG_MAX;
+    (*_ins_cnt)++;
+  } else if( FD_UNLIKELY( fd_vinyl_seq_gt( ele->seq, seq ) ) ) {
+    fd_vinyl_meta_cancel( query );
+    return FD_VINYL_SUCCESS;
+  }
+
+  ele->phdr.info = *info;
+  ele->seq       = seq;
+  ele->phdr.ctl  = ctl;
+
+  fd_vinyl_meta_publish( query );
+  return FD_VINYL_SUCCESS;
+}
+
+/* fd_vinyl_recover_private_slice replays the objects in the slice
+   [seq0,seq1) of io's bstream past into meta.  Assumes seq0 and seq1
+   are object boundaries.  Returns FD_VINYL_SUCCESS on success and a
+   FD_VINYL_ERR code on failure (logs details).  Increments *_ins_cnt
+   by the number of keys inserted into meta. */
+
+static int
+fd_vinyl_recover_private_slice( fd_vinyl_io_t *   io,
+                                fd_vinyl_meta_t * meta,
+                                ulong             seq0,
+                                ulong             seq1,
+                                ulong *           _ins_cnt ) {
+
+  ulong io_seed  = fd_vinyl_io_seed( io );
+  ulong dead_ctl = fd_vinyl_bstream_ctl( FD_VINYL_BSTREAM_CTL_TYPE_DEAD, FD_VINYL_BSTREAM_CTL_STYLE_RAW,
+                                         FD_VINYL_BSTREAM_BLOCK_SZ );
+
+  fd_vinyl_recover_private_rd_t rd[1];
+  rd->io   = io;
+  rd->seq0 = seq0;
+  rd->seq1 = seq0;
+  rd->end  = seq1;
+
+  fd_vinyl_bstream_block_t block[1];
+
+  ulong seq = seq0;
+  while( fd_vinyl_seq_lt( seq, seq1 ) ) {
+
+    *block = *fd_vinyl_recover_private_rd_block( rd, seq );
+
+    ulong        ctl    = block->ctl;
+    ulong        obj_sz = FD_VINYL_BSTREAM_BLOCK_SZ;
+    char const * cerr   = NULL;
+    int          err    = FD_VINYL_SUCCESS;
+
+    switch( fd_vinyl_bstream_ctl_type( ctl ) ) {
+
+    case FD_VINYL_BSTREAM_CTL_TYPE_PAIR: {
+      obj_sz = fd_vinyl_bstream_pair_sz( fd_vinyl_bstream_ctl_sz( ctl ) );
+      if( FD_UNLIKELY( obj_sz>(seq1-seq) ) ) { cerr = "truncated pair"; break; }
+
+      /* Validate the pair header and footer without reading the val */
+
+      fd_vinyl_bstream_block_t * ftr = block;
+      if( obj_sz>FD_VINYL_BSTREAM_BLOCK_SZ )
+        ftr = fd_vinyl_recover_private_rd_block( rd, seq + obj_sz - FD_VINYL_BSTREAM_BLOCK_SZ );
+
+      cerr = fd_vinyl_bstream_pair_test_fast( io_seed, seq, block, ftr );
+      if( FD_UNLIKELY( cerr ) ) break;
+
+      err = fd_vinyl_recover_private_merge( meta, &block->phdr.key, ctl, &block->phdr.info, seq, _ins_cnt );
+      break;
+    }
+
+    case FD_VINYL_BSTREAM_CTL_TYPE_DEAD: {
+      cerr = fd_vinyl_bstream_dead_test( io_seed, seq, block );
+      if( FD_UNLIKELY( cerr ) ) break;
+
+      err = fd_vinyl_recover_private_merge( meta, &block->dead.phdr.key, dead_ctl, &block->dead.phdr.info, seq, _ins_cnt );
+      break;
+    }
+
+    case FD_VINYL_BSTREAM_CTL_TYPE_MOVE: {
+
+      /* The move's dst pair immediately follows (and is replayed as a
+         regular pair next iteration).  The move erases the src key. */
+
+      if( FD_UNLIKELY( 2UL*FD_VINYL_BSTREAM_BLOCK_SZ>(seq1-seq) ) ) { cerr = "truncated move"; break; }
+
+      fd_vinyl_bstream_block_t dst[1];
+      *dst = *fd_vinyl_recover_private_rd_block( rd, seq + FD_VINYL_BSTREAM_BLOCK_SZ );
+
+      cerr = fd_vinyl_bstream_move_test( io_seed, seq, block, dst );
+      if( FD_UNLIKELY( cerr ) ) break;
+
+      err = fd_vinyl_recover_private_merge( meta, &block->move.src.key, dead_ctl, &block->move.src.info, seq, _ins_cnt );
+      break;
+    }
+
+    case FD_VINYL_BSTREAM_CTL_TYPE_PART: {
+      cerr = fd_vinyl_bstream_part_test( io_seed, seq, block );
+      break;
+    }
+
+    case FD_VINYL_BSTREAM_CTL_TYPE_ZPAD: {
+      cerr = fd_vinyl_bstream_zpad_test( io_seed, seq, block );
+      break;
+    }
+
+    default:
+      cerr = "unexpected ctl";
+      break;
+    }
+
+    if( FD_UNLIKELY( cerr ) ) {
+      FD_LOG_WARNING(( "bstream corruption detected at seq %016lx (%s, ctl %016lx, io_seed %016lx)", seq, cerr, ctl, io_seed ));
+      return FD_VINYL_ERR_CORRUPT;
+    }
+
+    if( FD_UNLIKELY( err ) ) {
+      FD_LOG_WARNING(( "meta too small to recover bstream (%i-%s)", err, fd_vinyl_strerror( err ) ));
+      return err;
+    }
+
+    seq += obj_sz;
+  }
+
+  return FD_VINYL_SUCCESS;
+}
+
+/* A fd_vinyl_recover_private_t holds the state of a recovery shared by
+   the tpool threads. */
+
+struct fd_vinyl_recover_private {
+  fd_vinyl_io_t *   io;
+  fd_vinyl_meta_t * meta;
+  ulong const *     bnd;        /* Slice i is [bnd[i+1],bnd[i]), indexed [0,slice_cnt] */
+  ulong             slice_cnt;
+  ulong             slice_nxt;  /* Next slice to replay (shared, atomically incremented) */
+  ulong             t0;         /* Recovery uses tpool threads [t0,t1) */
+  ulong             t1;
+};
+
+typedef struct fd_vinyl_recover_private fd_vinyl_recover_private_t;
+
+/* fd_vinyl_recover_private_replay_node dispatches slice replay work to
+   tpool threads [t0,t1).  Returns (in the int location pointed to by
+   _err) the first error encountered on the lowest indexed thread and
+   (in the ulong location pointed to by _ins_cnt) the number of keys
+   inserted into the meta.  Assumes the caller is thread t0 and threads
+   (t0,t1) are available. */
+
+static void
+fd_vinyl_recover_private_replay_node( void * tpool,
+                                      ulong  t0,
+                                      ulong  t1,        /* Assumes t1>t0 */
+                                      void * _ctx,
+                                      void * _reduce,   /* Unused */
+                                      ulong  _stride,   /* Unused */
+                                      ulong  _err,
+                                      ulong  _ins_cnt,
+                                      ulong  _m0,       /* Unused */
+                                      ulong  _m1,       /* Unused */
+                                      ulong  _n0,       /* Unused */
+                                      ulong  _n1 ) {    /* Unused */
+  (void)_reduce; (void)_stride; (void)_m0; (void)_m1; (void)_n0; (void)_n1;
+
+  ulong tpool_cnt = t1 - t0;
+  if( tpool_cnt>1UL ) {
+    ulong ts = t0 + fd_tpool_private_split( tpool_cnt );
+
+    int   err0; ulong ins_cnt0;
+    int   err1; ulong ins_cnt1;
+
+    fd_tpool_exec( tpool, ts, fd_vinyl_recover_private_replay_node,
+                   tpool, ts, t1, _ctx, NULL, 0UL, (ulong)&err1, (ulong)&ins_cnt1, 0UL, 0UL, 0UL, 0UL );
+    fd_vinyl_recover_private_replay_node(
+                   tpool, t0, ts, _ctx, NULL, 0UL, (ulong)&err0, (ulong)&ins_cnt0, 0UL, 0UL, 0UL, 0UL );
+    fd_tpool_wait( tpool, ts );
+
+    *(int   *)_err     = fd_int_if( !!err0, err0, err1 ); /* Return first error encountered */
+    *(ulong *)_ins_cnt = ins_cnt0 + ins_cnt1;
+    return;
+  }
+
+  fd_vinyl_recover_private_t * ctx = (fd_vinyl_recover_private_t *)_ctx;
+
+  int   err     = FD_VINYL_SUCCESS;
+  ulong ins_cnt = 0UL;
+
+  for(;;) {
+
+    /* Get the next slice to replay.  Slices can have very different
+       sizes so we use a dynamic task queue model here.  Slices are
+       ordered from newest to oldest.  This assumes slice_cnt <<
+       ULONG_MAX - tile count. */
+
+#   if FD_HAS_ATOMIC
+    FD_COMPILER_MFENCE();
+    ulong slice_idx = FD_ATOMIC_FETCH_AND_ADD( &ctx->slice_nxt, 1UL );
+    FD_COMPILER_MFENCE();
+#   else /* Note: this assumes platforms without HAS_ATOMIC will not be running this multithreaded */
+    ulong slice_idx = ctx->slice_nxt++;
+#   endif
+
+    if( FD_UNLIKELY( slice_idx>=ctx->slice_cnt ) ) break; /* No more slices to replay */
+
+    err = fd_vinyl_recover_private_slice( ctx->io, ctx->meta, ctx->bnd[ slice_idx+1UL ], ctx->bnd[ slice_idx ], &ins_cnt );
+    if( FD_UNLIKELY( err ) ) break; /* abort if we encountered an error */
+  }
+
+  *(int   *)_err     = err;
+  *(ulong *)_ins_cnt = ins_cnt;
+}
+
+/* fd_vinyl_recover_private_clean_node removes tombstones from the meta
+   and counts the remaining pairs using tpool threads [t0,t1).  Each
+   thread handles a contiguous range of meta elements.  Returns (in the
+   ulong locations pointed to by _rm_cnt, _pair_cnt and _live_sz) the
+   number of tombstones removed, the number of pairs and the number of
+   bstream bytes used by the pairs.  Since removing a key can move other
+   keys (potentially across thread ranges), a pass that removed
+   anything can miss or double count keys.  The caller should repeat
+   passes until a pass removes nothing (the counts of that pass are
+   exact). */
+
+static void
+fd_vinyl_recover_private_clean_node( void * tpool,
+                                     ulong  t0,
+                                     ulong  t1,         /* Assumes t1>t0 */
+                                     void * _ctx,
+                                     void * _reduce,    /* Unused */
+                                     ulong  _stride,    /* Unused */
+                                     ulong  _rm_cnt,
+                                     ulong  _pair_cnt,
+                                     ulong  _live_sz,
+                                     ulong  _m1,        /* Unused */
+                                     ulong  _n0,        /* Unused */
+                                     ulong  _n1 ) {     /* Unused */
+  (void)_reduce; (void)_stride; (void)_m1; (void)_n0; (void)_n1;
+
+  ulong tpool_cnt = t1 - t0;
+  if( tpool_cnt>1UL ) {
+    ulong ts = t0 + fd_tpool_private_split( tpool_cnt );
+
+    ulong rm_cnt0; ulong pair_cnt0; ulong live_sz0;
+    ulong rm_cnt1; ulong pair_cnt1; ulong live_sz1;
+
+    fd_tpool_exec( tpool, ts, fd_vinyl_recover_private_clean_node,
+                   tpool, ts, t1, _ctx, NULL, 0UL, (ulong)&rm_cnt1, (ulong)&pair_cnt1, (ulong)&live_sz1, 0UL, 0UL, 0UL );
+    fd_vinyl_recover_private_clean_node(
+                   tpool, t0, ts, _ctx, NULL, 0UL, (ulong)&rm_cnt0, (ulong)&pair_cnt0, (ulong)&live_sz0, 0UL, 0UL, 0UL );
+    fd_tpool_wait( tpool, ts );
+
+    *(ulong *)_rm_cnt   = rm_cnt0   + rm_cnt1;
+    *(ulong *)_pair_cnt = pair_cnt0 + pair_cnt1;
+    *(ulong *)_live_sz  = live_sz0  + live_sz1;
+    return;
+  }
+
+  fd_vinyl_recover_private_t * ctx  = (fd_vinyl_recover_private_t *)_ctx;
+  fd_vinyl_meta_t *            meta = ctx->meta;
+  fd_vinyl_meta_ele_t *        ele0 = meta->ele;
+
+  ulong ele_idx; ulong ele_idx1;
+  FD_TPOOL_PARTITION( 0UL, meta->ele_max, 1UL, t0 - ctx->t0, ctx->t1 - ctx->t0, ele_idx, ele_idx1 );
+
+  ulong rm_cnt   = 0UL;
+  ulong pair_cnt = 0UL;
+  ulong live_sz  = 0UL;
+
+  while( ele_idx<ele_idx1 ) {
+    fd_vinyl_meta_ele_t * ele = ele0 + ele_idx;
+
+    ulong ctl = FD_VOLATILE_CONST( ele->phdr.ctl );
+
+    if( !ctl ) { ele_idx++; continue; }
+
+    if( FD_LIKELY( fd_vinyl_bstream_ctl_type( ctl )==FD_VINYL_BSTREAM_CTL_TYPE_PAIR ) ) {
+      pair_cnt++;
+      live_sz += fd_vinyl_bstream_pair_sz( fd_vinyl_bstream_ctl_sz( ctl ) );
+      ele_idx++;
+      continue;
+    }
+
+    /* ele looks like a tombstone.  If another thread is concurrently
+       removing keys, ele might be in the middle of being moved and the
+       key we read might be torn.  So we confirm key is a tombstone
+       under the key's lock before removing it.  Tombstones stay
+       tombstones until removed so it is safe to remove key after the
+       confirm.  If key is not a tombstone, somebody removed something
+       this pass and another pass will take care of what we skip here. */
+
+    fd_vinyl_key_t key[1]; *key = ele->phdr.key;
+
+    fd_vinyl_meta_query_t query[1];
+    int is_tomb = 0;
+    if( FD_LIKELY( !fd_vinyl_meta_prepare( meta, key, NULL, query, FD_MAP_FLAG_BLOCKING ) ) ) {
+      fd_vinyl_meta_ele_t const * tomb = fd_vinyl_meta_query_ele( query );
+      is_tomb = fd_vinyl_meta_ele_in_use( tomb ) &&
+                (fd_vinyl_bstream_ctl_type( tomb->phdr.ctl )!=FD_VINYL_BSTREAM_CTL_TYPE_PAIR);
+      fd_vinyl_meta_cancel( query );
+    }
+
+    if( FD_UNLIKELY( !is_tomb ) ) { ele_idx++; continue; }
+
+    if( FD_LIKELY( !fd_vinyl_meta_remove( meta, key, NULL, FD_MAP_FLAG_BLOCKING ) ) ) rm_cnt++;
+
+    /* Don't advance ele_idx (a later key might have moved into it) */
+  }
+
+  *(ulong *)_rm_cnt   = rm_cnt;
+  *(ulong *)_pair_cnt = pair_cnt;
+  *(ulong *)_live_sz  = live_sz;
+}
+
+int
+fd_vinyl_recover( fd_tpool_t *      tpool,
+                  ulong             t0,
+                  ulong             t1,
+                  fd_vinyl_io_t *   io,
+                  fd_vinyl_meta_t * meta,
+                  ulong *           _pair_cnt,
+                  ulong *           _garbage_sz ) {
+
+  if( FD_UNLIKELY( !io   ) ) { FD_LOG_WARNING(( "NULL io"   )); return FD_VINYL_ERR_INVAL; }
+  if( FD_UNLIKELY( !meta ) ) { FD_LOG_WARNING(( "NULL meta" )); return FD_VINYL_ERR_INVAL; }
+
+  if( FD_UNLIKELY( !(t0<t1) ) ) { FD_LOG_WARNING(( "bad tpool range" )); return FD_VINYL_ERR_INVAL; }
+
+  if( FD_UNLIKELY( (!tpool) & (t1-t0>1UL) ) ) { FD_LOG_WARNING(( "NULL tpool" )); return FD_VINYL_ERR_INVAL; }
+
+  ulong seq_past    = fd_vinyl_io_seq_past   ( io );
+  ulong seq_present = fd_vinyl_io_seq_present( io );
+  ulong io_seed     = fd_vinyl_io_seed       ( io );
+
+  /* Split the past into slices by walking the partition chain backward
+     from the last partition in the past.  The boundaries are recorded
+     newest first.  If there are more partitions than fit, we merge
+     adjacent slices (keeping every other boundary and only recording
+     every other boundary going forward).  If the chain is broken (e.g.
+     partitions were not emitted for a while), the rest of the past
+     becomes a single slice. */
+
+  ulong bnd[ FD_VINYL_RECOVER_SLICE_MAX+1UL ];
+  ulong bnd_cnt = 0UL;
+
+  bnd[ bnd_cnt++ ] = seq_present;
+
+  ulong stride = 1UL;
+  ulong skip   = 0UL;
+
+  ulong seq = fd_vinyl_recover_tail( io );
+  for(;;) {
+
+    /* At this point, seq is an object boundary in [seq_past,bnd[0]]
+       and all partitions in [seq,seq_present) have been visited. */
+
+    if( FD_UNLIKELY( fd_vinyl_seq_le( seq, seq_past ) ) ) break;
+
+    if( FD_LIKELY( fd_vinyl_seq_lt( seq, bnd[ bnd_cnt-1UL ] ) ) && FD_LIKELY( (++skip)>=stride ) ) {
+      skip = 0UL;
+      if( FD_UNLIKELY( bnd_cnt>=FD_VINYL_RECOVER_SLICE_MAX ) ) { /* Leave room for seq_past */
+        ulong cnt = 1UL;
+        for( ulong idx=2UL; idx<bnd_cnt; idx+=2UL ) bnd[ cnt++ ] = bnd[ idx ];
+        bnd_cnt = cnt;
+        stride *= 2UL;
+      }
+      bnd[ bnd_cnt++ ] = seq;
+    }
+
+    /* The block just before seq should be the partition covering the
+       region just before seq. */
+
+    fd_vinyl_bstream_block_t block[1];
+    fd_vinyl_io_read_imm( io, seq - FD_VINYL_BSTREAM_BLOCK_SZ, block, FD_VINYL_BSTREAM_BLOCK_SZ );
+    if( FD_UNLIKELY( !fd_vinyl_recover_private_is_part( io_seed, seq - FD_VINYL_BSTREAM_BLOCK_SZ, block ) ) ) break;
+
+    seq = block->part.seq0;
+  }
+
+  if( FD_LIKELY( fd_vinyl_seq_gt( bnd[ bnd_cnt-1UL ], seq_past ) ) ) bnd[ bnd_cnt++ ] = seq_past;
+
+  ulong slice_cnt = bnd_cnt - 1UL;
+
+  FD_LOG_INFO(( "recovering bstream past [%016lx,%016lx) (%lu bytes) in %lu slice(s) with %lu thread(s)",
+                seq_past, seq_present, seq_present - seq_past, slice_cnt, t1 - t0 ));
+
+  /* Replay the slices in parallel */
+
+  fd_vinyl_recover_private_t ctx[1];
+
+  ctx->io        = io;
+  ctx->meta      = meta;
+  ctx->bnd       = bnd;
+  ctx->slice_cnt = slice_cnt;
+  ctx->slice_nxt = 0UL;
+  ctx->t0        = t0;
+  ctx->t1        = t1;
+
+  FD_COMPILER_MFENCE();
+
+  int   err;
+  ulong ins_cnt;
+  fd_vinyl_recover_private_replay_node( tpool, t0, t1, ctx, NULL, 0UL, (ulong)&err, (ulong)&ins_cnt, 0UL, 0UL, 0UL, 0UL );
+  if( FD_UNLIKELY( err ) ) return err; /* logs details */
+
+  /* Keys in the meta include the tombstones.  Make sure the meta still
+     has a hole (required for removal). */
+
+  if( FD_UNLIKELY( ins_cnt>=meta->ele_max ) ) {
+    FD_LOG_WARNING(( "meta too small to recover bstream" ));
+    return FD_VINYL_ERR_FULL;
+  }
+
+  /* Remove the tombstones and count what is left */
+
+  ulong rm_cnt;
+  ulong pair_cnt;
+  ulong live_sz;
+  do {
+    fd_vinyl_recover_private_clean_node( tpool, t0, t1, ctx, NULL, 0UL,
+                                         (ulong)&rm_cnt, (ulong)&pair_cnt, (ulong)&live_sz, 0UL, 0UL, 0UL );
+  } while( rm_cnt );
+
+  FD_LOG_INFO(( "recovered %lu pairs (%lu bytes live, %lu tombstones removed)", pair_cnt, live_sz, ins_cnt - pair_cnt ));
+
+  fd_ulong_store_if( !!_pair_cnt,   _pair_cnt,   pair_cnt                                 );
+  fd_ulong_store_if( !!_garbage_sz, _garbage_sz, (seq_present - seq_past) - live_sz       );
+
+  return FD_VINYL_SUCCESS;
+}
@@ -0,0 +1,83 @@
+#ifndef HEADER_fd_src_vinyl_recover_fd_vinyl_recover_h
+#define HEADER_fd_src_vinyl_recover_fd_vinyl_recover_h
+
+/* fd_vinyl_recover rebuilds a bstream's meta from the bstream's past
+   using a thread pool.
+
+   The bstream writer periodically appends partition blocks (see
+   fd_vinyl_bstream.h and fd_vinyl_housekeep).  The part.seq0 of a
+   partition block gives the start of its partition (the location just
+   after the previous partition block).  Recovery finds the last
+   partition block in the past with a short backward scan from
+   seq_present and then walks the chain of partitions backward to
+   seq_past.  This splits the past at object boundaries into slices
+   that can be replayed independently.
+
+   Slices are replayed concurrently by the threads of a tpool (each
+   thread grabs the next unreplayed slice).  Each object in a slice is
+   validated (for pairs, the pair header and the hash_blocks /
+   hash_trail footer are checked without reading the pair val) and
+   then merged into the meta.  Because slices are replayed in arbitrary
+   order, the object with the highest seq that references a key
+   determines the key's state.  Erases (dead blocks and the source key
+   of move blocks) are merged as tombstones, which are removed from the
+   meta once all slices have been replayed.
+
+   If the past has no partition blocks (e.g. a bstream written before
+   partitions were emitted), the past is replayed as a single slice
+   (i.e. serially).  A NULL tpool (with t0=0 and t1=1) recovers
+   serially. */
+
+#include "../io/fd_vinyl_io.h"
+#include "../meta/fd_vinyl_meta.h"
+#include "../../util/tpool/fd_tpool.h"
+
+/* FD_VINYL_RECOVER_SLICE_MAX gives the max number of slices the past
+   is split into.  If the past has more partitions than this, adjacent
+   partitions are merged into the same slice. */
+
+#define FD_VINYL_RECOVER_SLICE_MAX (4096UL)
+
+FD_PROTOTYPES_BEGIN
+
+/* fd_vinyl_recover_tail returns the location just after the last
+   partition block in io's bstream past (seq_past if there are no
+   partition blocks in the past).  That is, [tail,seq_present) is the
+   part of the past not covered by a partition and tail is where the
+   next partition appended to the bstream should start.  Assumes there
+   are no reads posted on io.  The cost is proportional to the size of
+   the past's tail. */
+
+ulong
+fd_vinyl_recover_tail( fd_vinyl_io_t * io );
+
+/* fd_vinyl_recover replays io's bstream past [seq_past,seq_present)
+   into meta using tpool threads [t0,t1).  Assumes the caller is thread
+   t0, threads (t0,t1) are available, meta is a local join to an empty
+   meta and there are no reads posted on io.  io's read_imm is called
+   concurrently from threads [t0,t1) (this is fine for io backends that
+   read from a mapping or with pread, e.g. mm, bd and ur).
+
+   Returns FD_VINYL_SUCCESS (0) on success and a FD_VINYL_ERR code
+   (negative) on failure (logs details).  On success, meta holds the
+   pairs that are current at seq_present (with line_idx ULONG_MAX, ready
+   to pass to fd_vinyl_init).  Further, if _pair_cnt is non-NULL,
+   *_pair_cnt holds the number of pairs in meta and, if _garbage_sz is
+   non-NULL, *_garbage_sz holds the number of bytes in the past not used
+   by current pairs (ready to pass to fd_vinyl_compact_init).  Reasons
+   for failure include CORRUPT (the past is not a valid bstream) and
+   FULL (meta does not have room for the keys in the past).  On failure,
+   the meta contents are unspecified. */
+
+int
+fd_vinyl_recover( fd_tpool_t *      tpool,
+                  ulong             t0,
+                  ulong             t1,
+                  fd_vinyl_io_t *   io,
+                  fd_vinyl_meta_t * meta,
+                  ulong *           _pair_cnt,
+                  ulong *           _garbage_sz );
+
+FD_PROTOTYPES_END
+
+#endif /* HEADER_fd_src_vinyl_recover_fd_vinyl_recover_h */
@@ -0,0 +1,373 @@
+#include "../fd_vinyl.h"
+
+#define KEY_MAX    (256UL)
+#define ELE_MAX    (1024UL)
+#define VAL_MAX    (4096UL)
+#define DEV_SZ     (FD_VINYL_BSTREAM_BLOCK_SZ + (16UL<<20))
+#define SPAD_MAX   (65536UL)
+
+static uchar dev[ DEV_SZ ] __attribute__((aligned(FD_VINYL_BSTREAM_BLOCK_SZ)));
+static uchar io_mem[ 1UL<<17 ] __attribute__((aligned(FD_VINYL_BSTREAM_BLOCK_SZ)));
+static uchar meta_mem[ 1UL<<16 ] __attribute__((aligned(128)));
+static fd_vinyl_meta_ele_t ele_mem[ ELE_MAX ];
+
+/* Recovered meta */
+
+static uchar rmeta_mem[ 1UL<<16 ] __attribute__((aligned(128)));
+static fd_vinyl_meta_ele_t rele_mem[ ELE_MAX ];
+
+static uchar val_buf[ VAL_MAX ];
+
+static uchar _tpool[ FD_TPOOL_FOOTPRINT( FD_TILE_MAX ) ] __attribute__((aligned(FD_TPOOL_ALIGN)));
+
+/* Reference model (the val of key k is generated from key ref_gk[k]
+   and version ref_ver[k], moves carry the val over) */
+
+static int   ref_live  [ KEY_MAX ];
+static ulong ref_gk    [ KEY_MAX ];
+static ulong ref_ver   [ KEY_MAX ];
+static ulong ref_val_sz[ KEY_MAX ];
+
+static void
+val_gen( ulong   k,
+         ulong   ver,
+         uchar * val,
+         ulong   val_sz ) {
+  ulong x = fd_ulong_hash( (k<<32) ^ ver );
+  for( ulong b=0UL; b<val_sz; b++ ) { val[b] = (uchar)x; x = fd_ulong_hash( x ); }
+}
+
+static fd_vinyl_key_t *
+key_gen( fd_vinyl_key_t * key,
+         ulong            k ) {
+  return fd_vinyl_key_init_ulong( key, 0x0123456789abcdefUL, k, ~k, k*k );
+}
+
+static ulong
+live_cnt( void ) {
+  ulong cnt = 0UL;
+  for( ulong k=0UL; k<KEY_MAX; k++ ) cnt += (ulong)ref_live[k];
+  return cnt;
+}
+
+static ulong
+live_sz( void ) {
+  ulong sz = 0UL;
+  for( ulong k=0UL; k<KEY_MAX; k++ ) if( ref_live[k] ) sz += fd_vinyl_bstream_pair_sz( ref_val_sz[k] );
+  return sz;
+}
+
+static fd_vinyl_meta_t *
+rmeta_new( fd_vinyl_meta_t * rmeta,
+           ulong             ele_max,
+           ulong             seed ) {
+  ulong lock_cnt  = fd_vinyl_meta_lock_cnt_est ( ele_max );
+  ulong probe_max = fd_vinyl_meta_probe_max_est( ele_max );
+  FD_TEST( fd_vinyl_meta_footprint( ele_max, lock_cnt, probe_max )<=sizeof(rmeta_mem) );
+  memset( rele_mem, 0, sizeof(rele_mem) );
+  FD_TEST( fd_vinyl_meta_new( rmeta_mem, ele_max, lock_cnt, probe_max, seed )==rmeta_mem );
+  FD_TEST( fd_vinyl_meta_join( rmeta, rmeta_mem, rele_mem )==rmeta );
+  return rmeta;
+}
+
+static void
+rmeta_delete( fd_vinyl_meta_t * rmeta ) {
+  fd_vinyl_meta_leave( rmeta );
+  fd_vinyl_meta_delete( rmeta_mem );
+}
+
+/* verify syncs io, recovers the bstream's past with tpool threads
+   [t0,t1) and checks the recovered meta matches the meta maintained
+   by the writer and the reference model */
+
+static void
+verify( fd_vinyl_io_t *      io,
+        fd_vinyl_meta_t *    meta,
+        fd_vinyl_compact_t * c,
+        ulong                tail,
+        fd_tpool_t *         tpool,
+        ulong                t0,
+        ulong                t1 ) {
+  FD_TEST( !fd_vinyl_io_commit( io, FD_VINYL_IO_FLAG_BLOCKING ) );
+  FD_TEST( !fd_vinyl_io_sync  ( io, FD_VINYL_IO_FLAG_BLOCKING ) );
+
+  ulong seq_past    = fd_vinyl_io_seq_past   ( io );
+  ulong seq_present = fd_vinyl_io_seq_present( io );
+
+  if( fd_vinyl_seq_lt( tail, seq_past ) ) tail = seq_past; /* last partition was compacted away */
+  FD_TEST( fd_vinyl_recover_tail( io )==tail );
+
+  fd_vinyl_meta_t rmeta[1]; rmeta_new( rmeta, ELE_MAX, meta->seed );
+
+  ulong pair_cnt   = ULONG_MAX;
+  ulong garbage_sz = ULONG_MAX;
+  FD_TEST( !fd_vinyl_recover( tpool, t0, t1, io, rmeta, &pair_cnt, &garbage_sz ) );
+
+  FD_TEST( pair_cnt  ==live_cnt() );
+  FD_TEST( garbage_sz==(seq_present-seq_past)-live_sz() );
+  FD_TEST( garbage_sz==c->garbage_sz );
+
+  for( ulong k=0UL; k<KEY_MAX; k++ ) {
+    fd_vinyl_key_t key[1]; key_gen( key, k );
+
+    ulong memo = fd_vinyl_key_memo( meta->seed, key );
+    ulong ele_idx; int err = fd_vinyl_meta_query_fast( meta->ele,  meta->ele_max,  key, memo, &ele_idx  );
+    ulong rele_idx; int rerr = fd_vinyl_meta_query_fast( rmeta->ele, rmeta->ele_max, key, memo, &rele_idx );
+
+    if( !ref_live[k] ) { FD_TEST( err==FD_VINYL_ERR_KEY ); FD_TEST( rerr==FD_VINYL_ERR_KEY ); continue; }
+    FD_TEST( !err ); FD_TEST( !rerr );
+
+    fd_vinyl_meta_ele_t const * ele  = meta->ele  + ele_idx;
+    fd_vinyl_meta_ele_t const * rele = rmeta->ele + rele_idx;
+
+    FD_TEST( rele->phdr.ctl==ele->phdr.ctl );
+    FD_TEST( rele->seq     ==ele->seq      );
+    FD_TEST( rele->line_idx==ULONG_MAX     );
+    FD_TEST( !memcmp( &rele->phdr.info, &ele->phdr.info, sizeof(fd_vinyl_info_t) ) );
+    FD_TEST( (ulong)rele->phdr.info._val_sz==ref_val_sz[k] );
+  }
+
+  rmeta_delete( rmeta );
+}
+
+/* upsert appends a new version of key k (generated from key gk and
+   version ver) and updates meta and the reference model to match.
+   Returns the number of garbage bytes created. */
+
+static ulong
+upsert( fd_vinyl_io_t *   io,
+        fd_vinyl_meta_t * meta,
+        ulong             k,
+        ulong             gk,
+        ulong             ver,
+        ulong             val_sz ) {
+  fd_vinyl_key_t key[1]; key_gen( key, k );
+  ulong memo = fd_vinyl_key_memo( meta->seed, key );
+
+  val_gen( gk, ver, val_buf, val_sz );
+
+  fd_vinyl_info_t info[1]; memset( info, 0, sizeof(fd_vinyl_info_t) );
+  info->_val_sz = (uint)val_sz;
+
+  ulong seq_future = fd_vinyl_io_seq_future( io );
+  ulong seq        = fd_vinyl_io_append_pair_raw( io, key, info, val_buf );
+
+  ulong garbage_sz = seq - seq_future;
+  if( ref_live[k] ) garbage_sz += fd_vinyl_bstream_pair_sz( ref_val_sz[k] );
+
+  ulong ele_idx;
+  int   err = fd_vinyl_meta_query_fast( meta->ele, meta->ele_max, key, memo, &ele_idx );
+  FD_TEST( err==(ref_live[k] ? FD_VINYL_SUCCESS : FD_VINYL_ERR_KEY) );
+  fd_vinyl_meta_ele_t * ele = meta->ele + ele_idx;
+
+  if( err ) {
+    ele->memo     = memo;
+    ele->phdr.key = *key;
+    ele->line_idx = ULONG_MAX;
+  }
+  ele->phdr.info = *info;
+  ele->seq       = seq;
+  FD_COMPILER_MFENCE();
+  ele->phdr.ctl  = fd_vinyl_bstream_ctl( FD_VINYL_BSTREAM_CTL_TYPE_PAIR, FD_VINYL_BSTREAM_CTL_STYLE_RAW, val_sz );
+
+  ref_live  [k] = 1;
+  ref_gk    [k] = gk;
+  ref_ver   [k] = ver;
+  ref_val_sz[k] = val_sz;
+
+  return garbage_sz;
+}
+
+static ulong
+dev_free( fd_vinyl_io_t * io ) {
+  return fd_vinyl_mmio_sz( io ) - (fd_vinyl_io_seq_future( io ) - fd_vinyl_io_seq_ancient( io ));
+}
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  ulong iter_cnt = fd_env_strip_cmdline_ulong( &argc, &argv, "--iter-cnt", NULL, 100000UL );
+  ulong seed     = fd_env_strip_cmdline_ulong( &argc, &argv, "--seed",     NULL, 1234UL   );
+
+  ulong thread_cnt = fd_tile_cnt();
+
+  FD_LOG_NOTICE(( "Testing with --iter-cnt %lu --seed %lu (%lu threads)", iter_cnt, seed, thread_cnt ));
+
+  fd_rng_t _rng[1]; fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, 0U, 0UL ) );
+
+  fd_tpool_t * tpool = fd_tpool_init( _tpool, thread_cnt, 0UL ); FD_TEST( tpool );
+  for( ulong thread_idx=1UL; thread_idx<thread_cnt; thread_idx++ ) FD_TEST( fd_tpool_worker_push( tpool, thread_idx ) );
+
+  FD_TEST( fd_vinyl_io_mm_footprint( SPAD_MAX )<=sizeof(io_mem) );
+  fd_vinyl_io_t * io = fd_vinyl_io_mm_init( io_mem, SPAD_MAX, dev, DEV_SZ, 1, NULL, 0UL, seed );
+  FD_TEST( io );
+
+  ulong lock_cnt  = fd_vinyl_meta_lock_cnt_est ( ELE_MAX );
+  ulong probe_max = fd_vinyl_meta_probe_max_est( ELE_MAX );
+  FD_TEST( fd_vinyl_meta_footprint( ELE_MAX, lock_cnt, probe_max )<=sizeof(meta_mem) );
+  memset( ele_mem, 0, sizeof(ele_mem) );
+  FD_TEST( fd_vinyl_meta_new( meta_mem, ELE_MAX, lock_cnt, probe_max, seed )==meta_mem );
+  fd_vinyl_meta_t meta[1]; FD_TEST( fd_vinyl_meta_join( meta, meta_mem, ele_mem )==meta );
+
+  long now = 0L;
+
+  fd_vinyl_compact_t c[1];
+  FD_TEST( fd_vinyl_compact_init( c, fd_vinyl_mmio_sz( io ), 0UL, 0UL, 2, 1.f, 65536L, now )==c );
+
+  FD_LOG_NOTICE(( "Testing bad args and empty bstream" ));
+
+  fd_vinyl_meta_t rmeta[1]; rmeta_new( rmeta, ELE_MAX, seed );
+  FD_TEST( fd_vinyl_recover( tpool, 0UL, thread_cnt, NULL, rmeta, NULL, NULL )==FD_VINYL_ERR_INVAL );
+  FD_TEST( fd_vinyl_recover( tpool, 0UL, thread_cnt, io,   NULL,  NULL, NULL )==FD_VINYL_ERR_INVAL );
+  FD_TEST( fd_vinyl_recover( tpool, 1UL, 1UL,        io,   rmeta, NULL, NULL )==FD_VINYL_ERR_INVAL );
+  if( thread_cnt>1UL ) FD_TEST( fd_vinyl_recover( NULL, 0UL, 2UL, io, rmeta, NULL, NULL )==FD_VINYL_ERR_INVAL );
+  rmeta_delete( rmeta );
+
+  verify( io, meta, c, fd_vinyl_io_seq_past( io ), NULL,  0UL, 1UL        );
+  verify( io, meta, c, fd_vinyl_io_seq_past( io ), tpool, 0UL, thread_cnt );
+
+  FD_LOG_NOTICE(( "Testing churn" ));
+
+  ulong part_seq0 = fd_vinyl_io_seq_past( io ); /* Start of the current partition */
+  ulong tail      = part_seq0;                  /* Just after the last partition block */
+  ulong dead_cnt  = 0UL;
+  ulong move_cnt  = 0UL;
+
+  for( ulong iter=0UL; iter<iter_cnt; iter++ ) {
+    ulong r = fd_rng_ulong( rng );
+    ulong k = fd_rng_ulong_roll( rng, KEY_MAX );
+
+    fd_vinyl_key_t key[1]; key_gen( key, k );
+    ulong memo = fd_vinyl_key_memo( meta->seed, key );
+
+    while( FD_UNLIKELY( dev_free( io ) < 4UL*fd_vinyl_bstream_pair_sz( VAL_MAX ) ) ) {
+      now += 1000000000L;
+      fd_vinyl_compact( c, io, meta, now, ULONG_MAX );
+      FD_TEST( !fd_vinyl_io_sync( io, FD_VINYL_IO_FLAG_BLOCKING ) );
+    }
+
+    ulong seq_future = fd_vinyl_io_seq_future( io );
+
+    int op = (int)(r & 15UL); r >>= 4;
+    switch( op ) {
+
+    case 0: { /* erase */
+      if( !ref_live[k] ) break;
+      ulong ele_idx;
+      FD_TEST( !fd_vinyl_meta_query_fast( meta->ele, meta->ele_max, key, memo, &ele_idx ) );
+      fd_vinyl_meta_ele_t * ele = meta->ele + ele_idx;
+      ulong seq = fd_vinyl_io_append_dead( io, &ele->phdr, NULL, 0UL );
+      fd_vinyl_compact_garbage( c, (seq - seq_future) + FD_VINYL_BSTREAM_BLOCK_SZ + fd_vinyl_bstream_pair_sz( ref_val_sz[k] ) );
+      fd_vinyl_meta_remove_fast( meta->ele, meta->ele_max, meta->lock, meta->lock_shift, NULL, 0UL, ele_idx );
+      ref_live[k] = 0;
+      dead_cnt++;
+      break;
+    }
+
+    case 1: { /* move k to k_dst */
+      ulong k_dst = fd_rng_ulong_roll( rng, KEY_MAX );
+      if( (!ref_live[k]) | (k_dst==k) ) break;
+      ulong ele_idx;
+      FD_TEST( !fd_vinyl_meta_query_fast( meta->ele, meta->ele_max, key, memo, &ele_idx ) );
+      fd_vinyl_meta_ele_t * ele = meta->ele + ele_idx;
+
+      fd_vinyl_key_t key_dst[1]; key_gen( key_dst, k_dst );
+      ulong pair_sz = fd_vinyl_bstream_pair_sz( ref_val_sz[k] );
+      fd_vinyl_io_hint( io, FD_VINYL_BSTREAM_BLOCK_SZ + pair_sz );
+      ulong seq = fd_vinyl_io_append_move( io, &ele->phdr, key_dst, NULL, 0UL );
+      fd_vinyl_compact_garbage( c, (seq - seq_future) + FD_VINYL_BSTREAM_BLOCK_SZ + pair_sz );
+
+      ulong gk = ref_gk[k]; ulong ver = ref_ver[k]; ulong val_sz = ref_val_sz[k];
+      fd_vinyl_meta_remove_fast( meta->ele, meta->ele_max, meta->lock, meta->lock_shift, NULL, 0UL, ele_idx );
+      ref_live[k] = 0;
+
+      seq_future = fd_vinyl_io_seq_future( io );
+      fd_vinyl_compact_garbage( c, upsert( io, meta, k_dst, gk, ver, val_sz ) );
+      FD_TEST( fd_vinyl_io_seq_future( io )==seq_future + pair_sz ); /* dst immediately follows */
+      move_cnt++;
+      break;
+    }
+
+    case 2: { /* partition */
+      ulong seq = fd_vinyl_io_append_part( io, part_seq0, dead_cnt, move_cnt, NULL, 0UL );
+      fd_vinyl_compact_garbage( c, (seq - seq_future) + FD_VINYL_BSTREAM_BLOCK_SZ );
+      part_seq0 = seq + FD_VINYL_BSTREAM_BLOCK_SZ;
+      tail      = part_seq0;
+      dead_cnt  = 0UL;
+      move_cnt  = 0UL;
+      break;
+    }
+
+    case 3: { /* sync */
+      FD_TEST( !fd_vinyl_io_commit( io, FD_VINYL_IO_FLAG_BLOCKING ) );
+      FD_TEST( !fd_vinyl_io_sync  ( io, FD_VINYL_IO_FLAG_BLOCKING ) );
+      break;
+    }
+
+    case 4: { /* compact */
+      now += (long)fd_rng_ulong_roll( rng, 100000UL );
+      fd_vinyl_compact( c, io, meta, now, 1UL + fd_rng_ulong_roll( rng, 64UL ) );
+      break;
+    }
+
+    default: { /* upsert */
+      ulong val_sz = fd_rng_ulong_roll( rng, VAL_MAX+1UL );
+      fd_vinyl_compact_garbage( c, upsert( io, meta, k, k, ref_ver[k]+1UL, val_sz ) );
+      break;
+    }
+
+    }
+
+    if( FD_UNLIKELY( !(iter & 8191UL) ) ) {
+      verify( io, meta, c, tail, NULL,  0UL, 1UL        );
+      verify( io, meta, c, tail, tpool, 0UL, thread_cnt );
+    }
+  }
+
+  verify( io, meta, c, tail, NULL,  0UL, 1UL        );
+  verify( io, meta, c, tail, tpool, 0UL, thread_cnt );
+
+  FD_LOG_NOTICE(( "Testing too small meta" ));
+
+  if( live_cnt()>=4UL ) {
+    fd_vinyl_meta_t rmeta[1]; rmeta_new( rmeta, fd_ulong_pow2_dn( live_cnt() ), seed );
+    FD_TEST( fd_vinyl_recover( tpool, 0UL, thread_cnt, io, rmeta, NULL, NULL )==FD_VINYL_ERR_FULL );
+    rmeta_delete( rmeta );
+  }
+
+  FD_LOG_NOTICE(( "Testing corruption" ));
+
+  /* Flip a bit in the header of a current pair */
+
+  ulong k = 0UL;
+  while( !ref_live[k] ) k++;
+  fd_vinyl_key_t key[1]; key_gen( key, k );
+  ulong ele_idx;
+  FD_TEST( !fd_vinyl_meta_query_fast( meta->ele, meta->ele_max, key, fd_vinyl_key_memo( meta->seed, key ), &ele_idx ) );
+  uchar * mmio = (uchar *)fd_vinyl_mmio( io );
+  uchar * byte = mmio + (meta->ele[ ele_idx ].seq % fd_vinyl_mmio_sz( io )) + offsetof( fd_vinyl_bstream_phdr_t, key );
+  *byte ^= (uchar)1;
+
+  rmeta_new( rmeta, ELE_MAX, seed );
+  FD_TEST( fd_vinyl_recover( NULL,  0UL, 1UL,        io, rmeta, NULL, NULL )==FD_VINYL_ERR_CORRUPT ); rmeta_delete( rmeta );
+  rmeta_new( rmeta, ELE_MAX, seed );
+  FD_TEST( fd_vinyl_recover( tpool, 0UL, thread_cnt, io, rmeta, NULL, NULL )==FD_VINYL_ERR_CORRUPT ); rmeta_delete( rmeta );
+
+  *byte ^= (uchar)1;
+
+  verify( io, meta, c, tail, tpool, 0UL, thread_cnt );
+
+  FD_TEST( fd_vinyl_io_fini( io )==io_mem );
+  fd_vinyl_meta_leave( meta );
+  fd_vinyl_meta_delete( meta_mem );
+
+  fd_tpool_fini( tpool );
+
+  fd_rng_delete( fd_rng_leave( rng ) );
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
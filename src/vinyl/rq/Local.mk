@@ -0,0 +1 @@
+$(call add-hdrs,fd_vinyl_rq.h fd_vinyl_client.h)
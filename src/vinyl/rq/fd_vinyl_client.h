@@ -0,0 +1,125 @@
+#ifndef HEADER_fd_src_vinyl_rq_fd_vinyl_client_h
+#define HEADER_fd_src_vinyl_rq_fd_vinyl_client_h
+
+/* A fd_vinyl_client_t is the client side of a vinyl rq / cq link (see
+   fd_vinyl_rq.h) for clients that issue one request at a time and
+   block until it completes (e.g. a tile flushing rooted accounts to
+   the vinyl tile from deep inside a call chain).  With a single
+   request in flight, the client trivially respects the link's flow
+   control and the vinyl tile cannot overrun the completion before the
+   client has read it. */
+
+#include "fd_vinyl_rq.h"
+
+struct fd_vinyl_client {
+  fd_frag_meta_t *       rq_mcache;  /* Local join to the link's request mcache (client is the producer) */
+  uchar *                rq_dcache;  /* Local join to the link's request dcache */
+  void *                 rq_base;    /* Chunk base address for the request dcache */
+  fd_frag_meta_t const * cq_mcache;  /* Local join to the link's completion mcache (client is the consumer) */
+  void const *           cq_base;    /* Chunk base address for the completion dcache */
+
+  ulong rq_depth;
+  ulong rq_seq;
+  ulong rq_chunk0;
+  ulong rq_wmark;
+  ulong rq_chunk;
+  ulong cq_depth;
+  ulong cq_seq;
+  ulong req_id;                      /* Next request id */
+};
+
+typedef struct fd_vinyl_client fd_vinyl_client_t;
+
+FD_PROTOTYPES_BEGIN
+
+/* fd_vinyl_client_init starts using the given rq / cq link as a
+   client.  rq_dcache should have room for a request of
+   FD_VINYL_REQ_BATCH_MAX keys.  The client resumes at the link's
+   current sequence numbers.  Returns client on success and NULL on
+   failure (logs details). */
+
+static inline fd_vinyl_client_t *
+fd_vinyl_client_init( fd_vinyl_client_t *    client,
+                      fd_frag_meta_t *       rq_mcache,
+                      uchar *                rq_dcache,
+                      void *                 rq_base,
+                      fd_frag_meta_t const * cq_mcache,
+                      void const *           cq_base ) {
+  if( FD_UNLIKELY( (!client) | (!rq_mcache) | (!rq_dcache) | (!rq_base) | (!cq_mcache) | (!cq_base) ) ) {
+    FD_LOG_WARNING(( "NULL client, mcache, dcache or base" ));
+    return NULL;
+  }
+
+  ulong rq_depth = fd_mcache_depth( rq_mcache );
+  if( FD_UNLIKELY( !fd_dcache_compact_is_safe( rq_base, rq_dcache, fd_vinyl_req_sz( FD_VINYL_REQ_BATCH_MAX ), rq_depth ) ) ) {
+    FD_LOG_WARNING(( "rq_dcache not compatible with rq_mcache depth and max request size" ));
+    return NULL;
+  }
+
+  client->rq_mcache = rq_mcache;
+  client->rq_dcache = rq_dcache;
+  client->rq_base   = rq_base;
+  client->cq_mcache = cq_mcache;
+  client->cq_base   = cq_base;
+
+  client->rq_depth  = rq_depth;
+  client->rq_seq    = fd_mcache_seq_query( fd_mcache_seq_laddr_const( rq_mcache ) );
+  client->rq_chunk0 = fd_dcache_compact_chunk0( rq_base, rq_dcache );
+  client->rq_wmark  = fd_dcache_compact_wmark ( rq_base, rq_dcache, fd_vinyl_req_sz( FD_VINYL_REQ_BATCH_MAX ) );
+  client->rq_chunk  = client->rq_chunk0;
+  client->cq_depth  = fd_mcache_depth( cq_mcache );
+  client->cq_seq    = fd_mcache_seq_query( fd_mcache_seq_laddr_const( cq_mcache ) );
+  client->req_id    = 0UL;
+  return client;
+}
+
+/* fd_vinyl_client_exec sends the request req (req->req_id is assigned
+   by the client), spins until its completion arrives and copies the
+   completion to comp (like fd_vinyl_exec, comp should have room for
+   fd_vinyl_comp_sz( FD_VINYL_REQ_BATCH_MAX ) bytes).  Returns comp.
+   FD_LOG_CRIT if the completion link was overrun or the completion
+   does not match the request (the link is shared with another client
+   or corrupt). */
+
+static inline fd_vinyl_comp_t *
+fd_vinyl_client_exec( fd_vinyl_client_t * client,
+                      fd_vinyl_req_t *    req,
+                      fd_vinyl_comp_t *   comp ) {
+  req->req_id = client->req_id++;
+
+  ulong req_sz = fd_vinyl_req_sz( req->batch_cnt );
+  fd_memcpy( fd_chunk_to_laddr( client->rq_base, client->rq_chunk ), req, req_sz );
+  ulong tspub = (ulong)fd_frag_meta_ts_comp( fd_tickcount() );
+  fd_mcache_publish( client->rq_mcache, client->rq_depth, client->rq_seq, req->req_id, client->rq_chunk, req_sz,
+                     fd_frag_meta_ctl( 0UL, 1, 1, 0 ), tspub, tspub );
+  client->rq_seq   = fd_seq_inc( client->rq_seq, 1UL );
+  client->rq_chunk = fd_dcache_compact_next( client->rq_chunk, req_sz, client->rq_chunk0, client->rq_wmark );
+
+  fd_frag_meta_t const * mline = client->cq_mcache + fd_mcache_line_idx( client->cq_seq, client->cq_depth );
+  ulong seq_found;
+  for(;;) {
+    seq_found = fd_frag_meta_seq_query( mline );
+    if( FD_LIKELY( !fd_seq_lt( seq_found, client->cq_seq ) ) ) break;
+    FD_SPIN_PAUSE();
+  }
+  if( FD_UNLIKELY( seq_found!=client->cq_seq ) ) {
+    FD_LOG_CRIT(( "vinyl cq overrun (seq %lu, found %lu)", client->cq_seq, seq_found ));
+  }
+
+  ulong sig = mline->sig;
+  ulong sz  = (ulong)mline->sz;
+  if( FD_UNLIKELY( (sig!=req->req_id) | (sz<sizeof(fd_vinyl_comp_t)) | (sz>fd_vinyl_comp_sz( FD_VINYL_REQ_BATCH_MAX )) ) ) {
+    FD_LOG_CRIT(( "vinyl completion (sig %lu, sz %lu) does not match request %lu", sig, sz, req->req_id ));
+  }
+  fd_memcpy( comp, fd_chunk_to_laddr_const( client->cq_base, mline->chunk ), sz );
+  if( FD_UNLIKELY( (comp->req_id!=req->req_id) | (sz!=fd_vinyl_comp_sz( comp->batch_cnt )) ) ) {
+    FD_LOG_CRIT(( "vinyl completion does not match request %lu", req->req_id ));
+  }
+
+  client->cq_seq = fd_seq_inc( client->cq_seq, 1UL );
+  return comp;
+}
+
+FD_PROTOTYPES_END
+
+#endif /* HEADER_fd_src_vinyl_rq_fd_vinyl_client_h */
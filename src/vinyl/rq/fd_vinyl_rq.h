@@ -0,0 +1,157 @@
+#ifndef HEADER_fd_src_vinyl_rq_fd_vinyl_rq_h
+#define HEADER_fd_src_vinyl_rq_fd_vinyl_rq_h
+
+/* A vinyl request queue (vinyl_rq) is a tango mcache / dcache pair
+   used by a client to send batch requests to a vinyl tile.  A vinyl
+   completion queue (vinyl_cq) is a tango mcache / dcache pair used by
+   the vinyl tile to notify the client that a request has completed.
+   Each client has its own rq / cq pair (a "link").
+
+   A request is a single frag.  The frag payload is a fd_vinyl_req_t
+   immediately followed by the batch_cnt keys of the request.  The frag
+   sig should be the req_id and the frag sz should be
+   fd_vinyl_req_sz( batch_cnt ).
+
+   A completion is a single frag.  The frag payload is a
+   fd_vinyl_comp_t immediately followed by batch_cnt ulong val offsets
+   and batch_cnt schar per key error codes (in the same order as the
+   request keys).  The frag sig is the req_id.
+
+   Request types:
+
+   - ACQUIRE: acquire the batch of keys.  On success for a key, the val
+     offset gives the byte offset in the vinyl data region of a decoded
+     pair header (fd_vinyl_bstream_phdr_t) immediately followed by the
+     pair's val.  phdr->info (including the val size) is valid.  This
+     location is stable until the client releases the key.
+
+     By default, keys are acquired for reading and the client should not
+     modify the pair header or val.  Any number of clients can acquire a
+     key for reading concurrently.
+
+     If FLAG_MODIFY is set, keys are acquired exclusively for modify.
+     The client can modify the pair's info and val in place (with the
+     val size up to the val_max of the vinyl instance).  If FLAG_CREATE
+     is also set, keys that do not exist will be created (with a zero
+     info and a zero size val).  If FLAG_IGNORE is also set, the
+     existing val will not be read from the bstream (the val will be
+     zero sized but the info will be preserved).
+
+     Per key errors: KEY (key does not exist), AGAIN (key is being
+     modified by a client or, for modify, is acquired by any client),
+     FULL (no free lines in the data region, pair val is larger than
+     the instance's val_max or, for create, the meta is full).
+
+   - RELEASE: release the batch of keys previously acquired.  If
+     FLAG_MODIFY is set (only valid if the key was acquired for modify),
+     the pair as modified in the data region will be appended to the
+     bstream and will be the key's current version.  Otherwise, any
+     modifications are discarded (including the creation of a key).
+     Modifications are in the bstream's past when the completion is
+     published.
+
+     Per key errors: INVAL (key was not acquired, FLAG_MODIFY was given
+     for a key acquired for reading or the modified val size is too
+     large) and FULL (no room in the bstream's store for the modified
+     pair).  On INVAL and FULL, the key is still released if it was
+     acquired (and any modifications are discarded).
+
+   - ERASE: erase the batch of keys.  Erases are in the bstream's past
+     when the completion is published.
+
+     Per key errors: KEY (key does not exist) and AGAIN (key is
+     currently acquired).
+
+   Keys in a batch are processed in order.
+
+   If the request as a whole was malformed (e.g. bad type, bad batch
+   size or frag size), the completion err will be INVAL and the
+   completion batch_cnt will be zero (no per key results).  Otherwise,
+   the completion err will be SUCCESS and fail_cnt gives the number of
+   keys whose per key error is not SUCCESS.
+
+   Flow control: the vinyl tile does not return credits to clients.  A
+   client should not have more than min(rq depth, cq depth) requests in
+   flight and should not reuse a request's dcache chunk until the
+   request's completion has been received.  Completions are published
+   in request order per link. */
+
+#include "../fd_vinyl_base.h"
+
+#define FD_VINYL_REQ_TYPE_ACQUIRE (0)
+#define FD_VINYL_REQ_TYPE_RELEASE (1)
+#define FD_VINYL_REQ_TYPE_ERASE   (2)
+
+#define FD_VINYL_REQ_FLAG_MODIFY (1UL<<0)
+#define FD_VINYL_REQ_FLAG_CREATE (1UL<<1)
+#define FD_VINYL_REQ_FLAG_IGNORE (1UL<<2)
+
+/* FD_VINYL_REQ_BATCH_MAX gives the max number of keys in a request.
+   Sized such that the largest request and completion fit in a frag. */
+
+#define FD_VINYL_REQ_BATCH_MAX (1024UL)
+
+struct fd_vinyl_req {
+  ulong req_id;    /* Arbitrary, echoed in the completion */
+  ulong flags;     /* Bit-or of FD_VINYL_REQ_FLAG_* */
+  int   type;      /* FD_VINYL_REQ_TYPE_* */
+  uint  batch_cnt; /* In [1,FD_VINYL_REQ_BATCH_MAX] */
+  /* fd_vinyl_key_t key[ batch_cnt ] follows */
+};
+
+typedef struct fd_vinyl_req fd_vinyl_req_t;
+
+struct fd_vinyl_comp {
+  ulong req_id;    /* == req->req_id */
+  int   type;      /* == req->type */
+  int   err;       /* FD_VINYL_SUCCESS or FD_VINYL_ERR_INVAL (request malformed) */
+  uint  batch_cnt; /* == req->batch_cnt */
+  uint  fail_cnt;  /* Number of keys that failed, in [0,batch_cnt] */
+  /* ulong val_off [ batch_cnt ] follows */
+  /* schar key_err [ batch_cnt ] follows */
+};
+
+typedef struct fd_vinyl_comp fd_vinyl_comp_t;
+
+FD_PROTOTYPES_BEGIN
+
+/* fd_vinyl_{req,comp}_sz return the frag payload size of a request /
+   completion with batch_cnt keys.  Assumes batch_cnt is in
+   [0,FD_VINYL_REQ_BATCH_MAX]. */
+
+FD_FN_CONST static inline ulong
+fd_vinyl_req_sz( ulong batch_cnt ) {
+  return sizeof(fd_vinyl_req_t) + batch_cnt*sizeof(fd_vinyl_key_t);
+}
+
+FD_FN_CONST static inline ulong
+fd_vinyl_comp_sz( ulong batch_cnt ) {
+  return sizeof(fd_vinyl_comp_t) + batch_cnt*(sizeof(ulong) + sizeof(schar));
+}
+
+/* fd_vinyl_req_key returns the location of the request's keys.
+   fd_vinyl_comp_{val_off,err} return the location of the completion's
+   val offsets and per key error codes.  Assumes req / comp point to a
+   valid request / completion in the caller's address space. */
+
+FD_FN_CONST static inline fd_vinyl_key_t *
+fd_vinyl_req_key( fd_vinyl_req_t * req ) {
+  return (fd_vinyl_key_t *)(req+1);
+}
+
+FD_FN_CONST static inline ulong *
+fd_vinyl_comp_val_off( fd_vinyl_comp_t * comp ) {
+  return (ulong *)(comp+1);
+}
+
+FD_FN_PURE static inline schar *
+fd_vinyl_comp_err( fd_vinyl_comp_t * comp ) {
+  return (schar *)(fd_vinyl_comp_val_off( comp ) + comp->batch_cnt);
+}
+
+FD_PROTOTYPES_END
+
+FD_STATIC_ASSERT( sizeof(fd_vinyl_req_t )+FD_VINYL_REQ_BATCH_MAX*sizeof(fd_vinyl_key_t)        <=USHORT_MAX, req_sz  );
+FD_STATIC_ASSERT( sizeof(fd_vinyl_comp_t)+FD_VINYL_REQ_BATCH_MAX*(sizeof(ulong)+sizeof(schar))<=USHORT_MAX, comp_sz );
+
+#endif /* HEADER_fd_src_vinyl_rq_fd_vinyl_rq_h */
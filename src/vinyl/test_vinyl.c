@@ -0,0 +1,636 @@
+#include "fd_vinyl.h"
+
+#include <errno.h>
+
+#define KEY_MAX    (256UL)
+#define ELE_MAX    (1024UL)
+#define VAL_MAX    (4096UL)
+#define LINE_CNT   (64UL)
+#define BATCH_MAX  (16UL)
+#define DEV_SZ     (FD_VINYL_BSTREAM_BLOCK_SZ + (16UL<<20))
+#define SPAD_MAX   (65536UL)
+#define DEPTH      (128UL)
+
+static uchar dev     [ DEV_SZ     ] __attribute__((aligned(FD_VINYL_BSTREAM_BLOCK_SZ)));
+static uchar io_mem  [ 1UL<<17    ] __attribute__((aligned(FD_VINYL_BSTREAM_BLOCK_SZ)));
+static uchar meta_mem[ 1UL<<16    ] __attribute__((aligned(128)));
+static uchar vinyl_mem[ 1UL<<17   ] __attribute__((aligned(FD_VINYL_ALIGN)));
+static uchar data_mem[ LINE_CNT*5120UL ] __attribute__((aligned(FD_VINYL_BSTREAM_BLOCK_SZ)));
+static fd_vinyl_meta_ele_t ele_mem[ ELE_MAX ];
+
+static uchar rmeta_mem[ 1UL<<16   ] __attribute__((aligned(128)));
+static fd_vinyl_meta_ele_t rele_mem[ ELE_MAX ];
+
+static uchar cnc_mem      [ 16384UL ] __attribute__((aligned(FD_CNC_ALIGN)));
+static uchar rq_mcache_mem[ 16384UL ] __attribute__((aligned(FD_MCACHE_ALIGN)));
+static uchar cq_mcache_mem[ 16384UL ] __attribute__((aligned(FD_MCACHE_ALIGN)));
+static uchar rq_dcache_mem[ 1UL<<23 ] __attribute__((aligned(FD_DCACHE_ALIGN)));
+static uchar cq_dcache_mem[ 1UL<<22 ] __attribute__((aligned(FD_DCACHE_ALIGN)));
+
+static uchar req_buf [ 65536UL ] __attribute__((aligned(128)));
+static uchar comp_buf[ 65536UL ] __attribute__((aligned(128)));
+static uchar val_buf [ VAL_MAX ];
+
+/* Reference model */
+
+static int   ref_live  [ KEY_MAX ];
+static ulong ref_ver   [ KEY_MAX ];
+static ulong ref_val_sz[ KEY_MAX ];
+
+static void
+val_gen( ulong   k,
+         ulong   ver,
+         uchar * val,
+         ulong   val_sz ) {
+  ulong x = fd_ulong_hash( (k<<32) ^ ver );
+  for( ulong b=0UL; b<val_sz; b++ ) { val[b] = (uchar)x; x = fd_ulong_hash( x ); }
+}
+
+static fd_vinyl_key_t *
+key_gen( fd_vinyl_key_t * key,
+         ulong            k ) {
+  return fd_vinyl_key_init_ulong( key, 0xfedcba9876543210UL, k, ~k, k*k );
+}
+
+/* Transport.  If link is NULL, requests are executed directly.
+   Otherwise, they are sent over the link's rq and the completion is
+   received from the link's cq. */
+
+static fd_vinyl_t *      g_vinyl;
+static fd_vinyl_link_t *   g_link;
+static fd_vinyl_client_t g_client[1];
+
+static fd_vinyl_comp_t *
+rpc( fd_vinyl_req_t * req,
+     ulong            req_sz ) {
+  if( !g_link ) {
+    fd_vinyl_exec( g_vinyl, req, req_sz, (fd_vinyl_comp_t *)comp_buf );
+    return (fd_vinyl_comp_t *)comp_buf;
+  }
+
+  FD_TEST( req_sz==fd_vinyl_req_sz( req->batch_cnt ) );
+  return fd_vinyl_client_exec( g_client, req, (fd_vinyl_comp_t *)comp_buf );
+}
+
+static ulong req_id_next;
+
+static fd_vinyl_comp_t *
+send( int     type,
+      ulong   flags,
+      ulong * k,
+      ulong   batch_cnt ) {
+  fd_vinyl_req_t * req = (fd_vinyl_req_t *)req_buf;
+  req->req_id    = req_id_next++;
+  req->flags     = flags;
+  req->type      = type;
+  req->batch_cnt = (uint)batch_cnt;
+  for( ulong i=0UL; i<batch_cnt; i++ ) key_gen( fd_vinyl_req_key( req ) + i, k[i] );
+  fd_vinyl_comp_t * comp = rpc( req, fd_vinyl_req_sz( batch_cnt ) );
+  FD_TEST( comp->req_id==req->req_id );
+  FD_TEST( comp->type==type );
+  FD_TEST( comp->err==FD_VINYL_SUCCESS );
+  FD_TEST( comp->batch_cnt==batch_cnt );
+  return comp;
+}
+
+static fd_vinyl_bstream_phdr_t *
+pair( ulong off ) {
+  FD_TEST( off<LINE_CNT*g_vinyl->line_sz );
+  FD_TEST( fd_ulong_is_aligned( off, FD_VINYL_BSTREAM_BLOCK_SZ ) );
+  return (fd_vinyl_bstream_phdr_t *)(data_mem + off);
+}
+
+static void
+pair_check( fd_vinyl_bstream_phdr_t const * phdr,
+            ulong                           k ) {
+  FD_TEST( (ulong)phdr->info._val_sz==ref_val_sz[k] );
+  FD_TEST( phdr->info.ul[1]==ref_ver[k] );
+  val_gen( k, ref_ver[k], val_buf, ref_val_sz[k] );
+  FD_TEST( !memcmp( phdr+1, val_buf, ref_val_sz[k] ) );
+}
+
+/* line_of returns the line key k is bound to (ULONG_MAX if none).
+   Assumes k is in the meta. */
+
+static ulong
+line_of( fd_vinyl_meta_t const * meta,
+         ulong                   k ) {
+  fd_vinyl_key_t key[1]; key_gen( key, k );
+  ulong ele_idx;
+  FD_TEST( !fd_vinyl_meta_query_fast( meta->ele, meta->ele_max, key, fd_vinyl_key_memo( meta->seed, key ), &ele_idx ) );
+  return meta->ele[ ele_idx ].line_idx;
+}
+
+/* keys_gen picks batch_cnt distinct random keys */
+
+static ulong
+keys_gen( fd_rng_t * rng,
+          ulong *    k ) {
+  ulong batch_cnt = 1UL + fd_rng_ulong_roll( rng, BATCH_MAX );
+  for( ulong i=0UL; i<batch_cnt; i++ ) {
+  again:
+    k[i] = fd_rng_ulong_roll( rng, KEY_MAX );
+    for( ulong j=0UL; j<i; j++ ) if( k[j]==k[i] ) goto again;
+  }
+  return batch_cnt;
+}
+
+static ulong ver_next = 1UL;
+
+static void
+churn( fd_rng_t * rng,
+       ulong      iter_cnt,
+       long *     now ) {
+
+  ulong k [ BATCH_MAX ];
+  ulong ok[ BATCH_MAX ];
+  ulong off[ BATCH_MAX ];
+
+  for( ulong iter=0UL; iter<iter_cnt; iter++ ) {
+    uint r = fd_rng_uint_roll( rng, 8U );
+
+    switch( r ) {
+
+    case 0U: case 1U: case 2U: { /* read acquire / release */
+      ulong batch_cnt = keys_gen( rng, k );
+      if( fd_rng_uint( rng ) & 1U ) k[ batch_cnt-1UL ] = k[ 0 ]; /* test shared read acquires */
+
+      fd_vinyl_comp_t * comp = send( FD_VINYL_REQ_TYPE_ACQUIRE, 0UL, k, batch_cnt );
+      ulong * val_off = fd_vinyl_comp_val_off( comp );
+      schar * err     = fd_vinyl_comp_err    ( comp );
+      ulong   fail    = 0UL;
+      for( ulong i=0UL; i<batch_cnt; i++ ) {
+        if( ref_live[ k[i] ] ) { FD_TEST( err[i]==FD_VINYL_SUCCESS ); pair_check( pair( val_off[i] ), k[i] ); }
+        else                   { FD_TEST( err[i]==FD_VINYL_ERR_KEY ); FD_TEST( val_off[i]==ULONG_MAX ); fail++; }
+        ok[i] = !err[i];
+      }
+      FD_TEST( comp->fail_cnt==fail );
+
+      /* Writers are locked out while readers hold the key */
+
+      for( ulong i=0UL; i<batch_cnt; i++ ) if( ok[i] ) {
+        comp = send( FD_VINYL_REQ_TYPE_ACQUIRE, FD_VINYL_REQ_FLAG_MODIFY, k+i, 1UL );
+        FD_TEST( fd_vinyl_comp_err( comp )[0]==FD_VINYL_ERR_AGAIN );
+        comp = send( FD_VINYL_REQ_TYPE_ERASE, 0UL, k+i, 1UL );
+        FD_TEST( fd_vinyl_comp_err( comp )[0]==FD_VINYL_ERR_AGAIN );
+        break;
+      }
+
+      /* Release all (non-acquired ones give INVAL) */
+
+      comp = send( FD_VINYL_REQ_TYPE_RELEASE, 0UL, k, batch_cnt );
+      err  = fd_vinyl_comp_err( comp );
+      for( ulong i=0UL; i<batch_cnt; i++ ) FD_TEST( err[i]==(ok[i] ? FD_VINYL_SUCCESS : FD_VINYL_ERR_INVAL) );
+      break;
+    }
+
+    case 3U: case 4U: case 5U: { /* modify acquire / release */
+      ulong batch_cnt = keys_gen( rng, k );
+      int   create    = !!(fd_rng_uint( rng ) & 1U);
+      int   ignore    = !(fd_rng_uint( rng ) & 3U);
+      ulong flags     = FD_VINYL_REQ_FLAG_MODIFY | (create ? FD_VINYL_REQ_FLAG_CREATE : 0UL) | (ignore ? FD_VINYL_REQ_FLAG_IGNORE : 0UL);
+
+      fd_vinyl_comp_t * comp = send( FD_VINYL_REQ_TYPE_ACQUIRE, flags, k, batch_cnt );
+      ulong * val_off = fd_vinyl_comp_val_off( comp );
+      schar * err     = fd_vinyl_comp_err    ( comp );
+      for( ulong i=0UL; i<batch_cnt; i++ ) {
+        ok [i] = !err[i];
+        off[i] = val_off[i];
+        if( ref_live[ k[i] ] ) {
+          FD_TEST( err[i]==FD_VINYL_SUCCESS );
+          fd_vinyl_bstream_phdr_t * phdr = pair( off[i] );
+          if( ignore ) { FD_TEST( !phdr->info._val_sz ); FD_TEST( phdr->info.ul[1]==ref_ver[ k[i] ] ); }
+          else         pair_check( phdr, k[i] );
+        } else if( create ) {
+          FD_TEST( err[i]==FD_VINYL_SUCCESS );
+          fd_vinyl_bstream_phdr_t * phdr = pair( off[i] );
+          FD_TEST( !phdr->info.ul[0] && !phdr->info.ul[1] );
+        } else {
+          FD_TEST( err[i]==FD_VINYL_ERR_KEY );
+        }
+      }
+
+      /* Other clients are locked out */
+
+      for( ulong i=0UL; i<batch_cnt; i++ ) if( ok[i] ) {
+        comp = send( FD_VINYL_REQ_TYPE_ACQUIRE, 0UL, k+i, 1UL );
+        FD_TEST( fd_vinyl_comp_err( comp )[0]==FD_VINYL_ERR_AGAIN );
+        break;
+      }
+
+      /* Update the vals in place and then either write them back or
+         discard them */
+
+      int   commit = !!(fd_rng_uint_roll( rng, 4U ));
+      ulong ver    = ver_next++;
+      for( ulong i=0UL; i<batch_cnt; i++ ) if( ok[i] ) {
+        fd_vinyl_bstream_phdr_t * phdr = pair( off[i] );
+        ulong val_sz = fd_rng_ulong_roll( rng, VAL_MAX+1UL );
+        memset( phdr, 0xff, sizeof(ulong) + sizeof(fd_vinyl_key_t) ); /* clients can clobber ctl and key */
+        phdr->info._val_sz = (uint)val_sz;
+        phdr->info.ul[1]   = ver;
+        val_gen( k[i], ver, (uchar *)(phdr+1), val_sz );
+        if( commit ) { ref_live[ k[i] ] = 1; ref_ver[ k[i] ] = ver; ref_val_sz[ k[i] ] = val_sz; }
+      }
+
+      comp = send( FD_VINYL_REQ_TYPE_RELEASE, commit ? FD_VINYL_REQ_FLAG_MODIFY : 0UL, k, batch_cnt );
+      err  = fd_vinyl_comp_err( comp );
+      for( ulong i=0UL; i<batch_cnt; i++ ) FD_TEST( err[i]==(ok[i] ? FD_VINYL_SUCCESS : FD_VINYL_ERR_INVAL) );
+      break;
+    }
+
+    case 6U: { /* erase */
+      ulong batch_cnt = keys_gen( rng, k );
+      fd_vinyl_comp_t * comp = send( FD_VINYL_REQ_TYPE_ERASE, 0UL, k, batch_cnt );
+      schar * err = fd_vinyl_comp_err( comp );
+      for( ulong i=0UL; i<batch_cnt; i++ ) {
+        FD_TEST( err[i]==(ref_live[ k[i] ] ? FD_VINYL_SUCCESS : FD_VINYL_ERR_KEY) );
+        ref_live[ k[i] ] = 0;
+      }
+      break;
+    }
+
+    default: { /* housekeeping */
+      *now += (long)fd_rng_ulong_roll( rng, 100000UL );
+      if( !g_link ) fd_vinyl_housekeep( g_vinyl, *now );
+      break;
+    }
+
+    }
+  }
+}
+
+/* verify checks the meta agrees with the reference model */
+
+static void
+verify( fd_vinyl_meta_t * meta ) {
+  for( ulong k=0UL; k<KEY_MAX; k++ ) {
+    fd_vinyl_key_t  key[1]; key_gen( key, k );
+    fd_vinyl_info_t info[1];
+    int err = fd_vinyl_meta_query( meta, key, info );
+    if( ref_live[k] ) {
+      FD_TEST( !err );
+      FD_TEST( (ulong)info->_val_sz==ref_val_sz[k] );
+      FD_TEST( info->ul[1]==ref_ver[k] );
+    } else {
+      FD_TEST( err==FD_VINYL_ERR_KEY );
+    }
+  }
+}
+
+static int
+tile_main( int     argc,
+           char ** argv ) {
+  (void)argc;
+  fd_rng_t _rng[1]; fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, 1U, 0UL ) );
+  fd_cnc_t * cnc = (fd_cnc_t *)argv;
+  FD_TEST( !fd_vinyl_run( g_vinyl, cnc, 1UL, g_link, 0L, rng ) );
+  fd_rng_delete( fd_rng_leave( rng ) );
+  return 0;
+}
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  ulong iter_cnt  = fd_env_strip_cmdline_ulong( &argc, &argv, "--iter-cnt",  NULL, 100000UL );
+  ulong seed      = fd_env_strip_cmdline_ulong( &argc, &argv, "--seed",      NULL, 1234UL   );
+
+  FD_LOG_NOTICE(( "Testing with --iter-cnt %lu --seed %lu", iter_cnt, seed ));
+
+  fd_rng_t _rng[1]; fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, 0U, 0UL ) );
+
+  FD_TEST( fd_vinyl_io_mm_footprint( SPAD_MAX )<=sizeof(io_mem) );
+  fd_vinyl_io_t * io = fd_vinyl_io_mm_init( io_mem, SPAD_MAX, dev, DEV_SZ, 1, NULL, 0UL, seed );
+  FD_TEST( io );
+
+  ulong lock_cnt  = fd_vinyl_meta_lock_cnt_est ( ELE_MAX );
+  ulong probe_max = fd_vinyl_meta_probe_max_est( ELE_MAX );
+  FD_TEST( fd_vinyl_meta_footprint( ELE_MAX, lock_cnt, probe_max )<=sizeof(meta_mem) );
+  memset( ele_mem, 0, sizeof(ele_mem) );
+  FD_TEST( fd_vinyl_meta_new( meta_mem, ELE_MAX, lock_cnt, probe_max, seed )==meta_mem );
+  fd_vinyl_meta_t meta[1]; FD_TEST( fd_vinyl_meta_join( meta, meta_mem, ele_mem )==meta );
+
+  ulong dev_sz = fd_vinyl_mmio_sz( io );
+
+  long now = 0L;
+  fd_vinyl_compact_t compact[1];
+  FD_TEST( fd_vinyl_compact_init( compact, dev_sz, 0UL, 1UL<<20, 1, 1.f, 1L<<24, now )==compact );
+
+  FD_LOG_NOTICE(( "Testing construction" ));
+
+  FD_TEST( fd_vinyl_align()==FD_VINYL_ALIGN );
+  FD_TEST( !fd_vinyl_footprint( 0UL,      VAL_MAX                ) );
+  FD_TEST( !fd_vinyl_footprint( LINE_CNT, FD_VINYL_VAL_MAX+1UL   ) );
+  FD_TEST( !fd_vinyl_data_footprint( 0UL, VAL_MAX                ) );
+  ulong footprint = fd_vinyl_footprint( LINE_CNT, VAL_MAX );
+  FD_TEST( footprint && footprint<=sizeof(vinyl_mem) );
+  FD_TEST( fd_ulong_is_pow2( fd_vinyl_data_align() ) );
+  FD_TEST( fd_vinyl_data_footprint( LINE_CNT, VAL_MAX )<=sizeof(data_mem) );
+
+  FD_TEST( !fd_vinyl_init( NULL,            LINE_CNT, VAL_MAX,              io,   dev_sz,     meta, data_mem,       compact ) );
+  FD_TEST( !fd_vinyl_init( vinyl_mem+1UL,   LINE_CNT, VAL_MAX,              io,   dev_sz,     meta, data_mem,       compact ) );
+  FD_TEST( !fd_vinyl_init( vinyl_mem,       0UL,      VAL_MAX,              io,   dev_sz,     meta, data_mem,       compact ) );
+  FD_TEST( !fd_vinyl_init( vinyl_mem,       LINE_CNT, FD_VINYL_VAL_MAX+1UL, io,   dev_sz,     meta, data_mem,       compact ) );
+  FD_TEST( !fd_vinyl_init( vinyl_mem,       LINE_CNT, VAL_MAX,              NULL, dev_sz,     meta, data_mem,       compact ) );
+  FD_TEST( !fd_vinyl_init( vinyl_mem,       LINE_CNT, VAL_MAX,              io,   0UL,        meta, data_mem,       compact ) );
+  FD_TEST( !fd_vinyl_init( vinyl_mem,       LINE_CNT, VAL_MAX,              io,   dev_sz-1UL, meta, data_mem,       compact ) );
+  FD_TEST( !fd_vinyl_init( vinyl_mem,       LINE_CNT, VAL_MAX,              io,   dev_sz,     NULL, data_mem,       compact ) );
+  FD_TEST( !fd_vinyl_init( vinyl_mem,       LINE_CNT, VAL_MAX,              io,   dev_sz,     meta, NULL,           compact ) );
+  FD_TEST( !fd_vinyl_init( vinyl_mem,       LINE_CNT, VAL_MAX,              io,   dev_sz,     meta, data_mem+1UL,   compact ) );
+
+  fd_vinyl_t * vinyl = fd_vinyl_init( vinyl_mem, LINE_CNT, VAL_MAX, io, dev_sz, meta, data_mem, compact );
+  FD_TEST( vinyl );
+  g_vinyl = vinyl;
+
+  FD_TEST( vinyl->part_thresh==FD_VINYL_PART_THRESH_DEFAULT );
+  vinyl->part_thresh = 1UL<<18; /* Emit partitions often enough to exercise recovery below */
+
+  FD_LOG_NOTICE(( "Testing malformed requests" ));
+
+  do {
+    fd_vinyl_req_t  * req  = (fd_vinyl_req_t *)req_buf;
+    fd_vinyl_comp_t * comp = (fd_vinyl_comp_t *)comp_buf;
+    ulong comp_sz;
+
+    req->req_id = 42UL; req->flags = 0UL; req->type = FD_VINYL_REQ_TYPE_ACQUIRE; req->batch_cnt = 1U;
+    key_gen( fd_vinyl_req_key( req ), 0UL );
+
+    comp_sz = fd_vinyl_exec( vinyl, req, fd_vinyl_req_sz( 1UL )-1UL, comp );
+    FD_TEST( comp_sz==fd_vinyl_comp_sz( 0UL ) && comp->req_id==42UL && comp->err==FD_VINYL_ERR_INVAL && !comp->batch_cnt );
+
+    comp_sz = fd_vinyl_exec( vinyl, req, 8UL, comp );
+    FD_TEST( comp_sz==fd_vinyl_comp_sz( 0UL ) && comp->err==FD_VINYL_ERR_INVAL && !comp->batch_cnt );
+
+    req->batch_cnt = 0U;
+    comp_sz = fd_vinyl_exec( vinyl, req, fd_vinyl_req_sz( 0UL ), comp );
+    FD_TEST( comp_sz==fd_vinyl_comp_sz( 0UL ) && comp->err==FD_VINYL_ERR_INVAL && !comp->batch_cnt );
+
+    req->batch_cnt = (uint)FD_VINYL_REQ_BATCH_MAX+1U;
+    comp_sz = fd_vinyl_exec( vinyl, req, fd_vinyl_req_sz( FD_VINYL_REQ_BATCH_MAX+1UL ), comp );
+    FD_TEST( comp_sz==fd_vinyl_comp_sz( 0UL ) && comp->err==FD_VINYL_ERR_INVAL && !comp->batch_cnt );
+
+    req->batch_cnt = 1U; req->type = 3;
+    comp_sz = fd_vinyl_exec( vinyl, req, fd_vinyl_req_sz( 1UL ), comp );
+    FD_TEST( comp_sz==fd_vinyl_comp_sz( 0UL ) && comp->err==FD_VINYL_ERR_INVAL && !comp->batch_cnt );
+
+    req->type = FD_VINYL_REQ_TYPE_ACQUIRE;
+    comp_sz = fd_vinyl_exec( vinyl, req, fd_vinyl_req_sz( 1UL ), comp );
+    FD_TEST( comp_sz==fd_vinyl_comp_sz( 1UL ) && comp->err==FD_VINYL_SUCCESS && comp->batch_cnt==1U && comp->fail_cnt==1U );
+    FD_TEST( fd_vinyl_comp_err( comp )[0]==FD_VINYL_ERR_KEY );
+  } while(0);
+
+  FD_LOG_NOTICE(( "Testing line exhaustion" ));
+
+  do {
+    ulong batch_cnt = LINE_CNT/BATCH_MAX + 1UL;
+    ulong k[ LINE_CNT + BATCH_MAX ];
+    for( ulong i=0UL; i<LINE_CNT+BATCH_MAX; i++ ) k[i] = i;
+
+    for( ulong b=0UL; b<batch_cnt; b++ ) {
+      fd_vinyl_comp_t * comp = send( FD_VINYL_REQ_TYPE_ACQUIRE, FD_VINYL_REQ_FLAG_MODIFY | FD_VINYL_REQ_FLAG_CREATE, k + b*BATCH_MAX, BATCH_MAX );
+      schar * err = fd_vinyl_comp_err( comp );
+      for( ulong i=0UL; i<BATCH_MAX; i++ ) FD_TEST( err[i]==(b*BATCH_MAX+i<LINE_CNT ? FD_VINYL_SUCCESS : FD_VINYL_ERR_FULL) );
+    }
+    FD_TEST( vinyl->line_free==ULONG_MAX );
+    FD_TEST( vinyl->pair_cnt==LINE_CNT );
+
+    for( ulong b=0UL; b<batch_cnt; b++ ) {
+      fd_vinyl_comp_t * comp = send( FD_VINYL_REQ_TYPE_RELEASE, 0UL, k + b*BATCH_MAX, BATCH_MAX );
+      schar * err = fd_vinyl_comp_err( comp );
+      for( ulong i=0UL; i<BATCH_MAX; i++ ) FD_TEST( err[i]==(b*BATCH_MAX+i<LINE_CNT ? FD_VINYL_SUCCESS : FD_VINYL_ERR_INVAL) );
+    }
+    FD_TEST( vinyl->line_free!=ULONG_MAX );
+    FD_TEST( vinyl->pair_cnt==0UL ); /* discarded creates are removed */
+  } while(0);
+
+  FD_LOG_NOTICE(( "Testing line cache" ));
+
+  do {
+
+    /* Write keys [0,LINE_CNT] (one more than the number of lines) */
+
+    ulong k[ LINE_CNT+1UL ];
+    for( ulong i=0UL; i<=LINE_CNT; i++ ) k[i] = i;
+
+    ulong ver = ver_next++;
+    for( ulong i0=0UL; i0<=LINE_CNT; i0+=BATCH_MAX ) {
+      ulong batch_cnt = fd_ulong_min( BATCH_MAX, LINE_CNT+1UL-i0 );
+      fd_vinyl_comp_t * comp = send( FD_VINYL_REQ_TYPE_ACQUIRE, FD_VINYL_REQ_FLAG_MODIFY | FD_VINYL_REQ_FLAG_CREATE, k+i0, batch_cnt );
+      FD_TEST( !comp->fail_cnt );
+      for( ulong i=0UL; i<batch_cnt; i++ ) {
+        fd_vinyl_bstream_phdr_t * phdr = pair( fd_vinyl_comp_val_off( comp )[i] );
+        ulong val_sz = 1UL + k[i0+i];
+        phdr->info._val_sz = (uint)val_sz;
+        phdr->info.ul[1]   = ver;
+        val_gen( k[i0+i], ver, (uchar *)(phdr+1), val_sz );
+        ref_live[ k[i0+i] ] = 1; ref_ver[ k[i0+i] ] = ver; ref_val_sz[ k[i0+i] ] = val_sz;
+      }
+      comp = send( FD_VINYL_REQ_TYPE_RELEASE, FD_VINYL_REQ_FLAG_MODIFY, k+i0, batch_cnt );
+      FD_TEST( !comp->fail_cnt );
+    }
+
+    /* Writing more keys than lines evicted the least recently used
+       ones, and the most recent write is still cached */
+
+    FD_TEST( vinyl->metrics.evict_cnt>=1UL );
+    FD_TEST( vinyl->line_free==ULONG_MAX );
+
+    ulong hit_cnt  = vinyl->metrics.hit_cnt;
+    ulong miss_cnt = vinyl->metrics.miss_cnt;
+    ulong read_cnt = vinyl->metrics.read_cnt;
+
+    fd_vinyl_comp_t * comp = send( FD_VINYL_REQ_TYPE_ACQUIRE, 0UL, k+LINE_CNT, 1UL );
+    FD_TEST( !comp->fail_cnt ); pair_check( pair( fd_vinyl_comp_val_off( comp )[0] ), LINE_CNT );
+    FD_TEST( vinyl->metrics.hit_cnt==hit_cnt+1UL && vinyl->metrics.read_cnt==read_cnt );
+    comp = send( FD_VINYL_REQ_TYPE_RELEASE, 0UL, k+LINE_CNT, 1UL );
+    FD_TEST( !comp->fail_cnt );
+
+    /* Releasing a cached key that is not acquired fails */
+
+    comp = send( FD_VINYL_REQ_TYPE_RELEASE, 0UL, k+LINE_CNT, 1UL );
+    FD_TEST( fd_vinyl_comp_err( comp )[0]==FD_VINYL_ERR_INVAL );
+
+    /* Evicted keys get read back from the bstream */
+
+    ulong ke = 0UL;
+    while( line_of( meta, ke )!=ULONG_MAX ) ke++;
+    FD_TEST( ke<LINE_CNT );
+
+    comp = send( FD_VINYL_REQ_TYPE_ACQUIRE, 0UL, k+ke, 1UL );
+    FD_TEST( !comp->fail_cnt ); pair_check( pair( fd_vinyl_comp_val_off( comp )[0] ), ke );
+    FD_TEST( vinyl->metrics.miss_cnt==miss_cnt+1UL && vinyl->metrics.read_cnt==read_cnt+1UL );
+    FD_TEST( vinyl->metrics.evict_cnt>=2UL );
+
+    /* Pinned lines are never evicted */
+
+    ulong line_idx = line_of( meta, ke );
+    FD_TEST( line_idx<LINE_CNT );
+
+    for( ulong i=0UL; i<=LINE_CNT; i++ ) {
+      if( i==ke ) continue;
+      comp = send( FD_VINYL_REQ_TYPE_ACQUIRE, 0UL, k+i, 1UL );
+      FD_TEST( !comp->fail_cnt ); pair_check( pair( fd_vinyl_comp_val_off( comp )[0] ), i );
+      FD_TEST( fd_vinyl_comp_val_off( comp )[0]!=line_idx*vinyl->line_sz );
+      comp = send( FD_VINYL_REQ_TYPE_RELEASE, 0UL, k+i, 1UL );
+      FD_TEST( !comp->fail_cnt );
+    }
+    FD_TEST( line_of( meta, ke )==line_idx );
+
+    comp = send( FD_VINYL_REQ_TYPE_RELEASE, 0UL, k+ke, 1UL );
+    FD_TEST( !comp->fail_cnt );
+
+    /* Cached keys can be erased (freeing their line) */
+
+    comp = send( FD_VINYL_REQ_TYPE_ERASE, 0UL, k+ke, 1UL );
+    FD_TEST( !comp->fail_cnt );
+    ref_live[ ke ] = 0;
+    FD_TEST( vinyl->line_free==line_idx );
+
+    FD_LOG_NOTICE(( "hit_cnt %lu miss_cnt %lu evict_cnt %lu",
+                    vinyl->metrics.hit_cnt, vinyl->metrics.miss_cnt, vinyl->metrics.evict_cnt ));
+  } while(0);
+
+  verify( meta );
+
+  FD_LOG_NOTICE(( "Testing churn (direct)" ));
+
+  churn( rng, iter_cnt, &now );
+  verify( meta );
+
+  FD_LOG_NOTICE(( "line cache: hit_cnt %lu miss_cnt %lu evict_cnt %lu",
+                  vinyl->metrics.hit_cnt, vinyl->metrics.miss_cnt, vinyl->metrics.evict_cnt ));
+  FD_TEST( vinyl->metrics.hit_cnt && vinyl->metrics.evict_cnt );
+
+  FD_LOG_NOTICE(( "compact: scan_cnt %lu copy_cnt %lu copy_sz %lu free_sz %lu",
+                  compact->scan_cnt, compact->copy_cnt, compact->copy_sz, compact->free_sz ));
+  FD_TEST( compact->free_sz ); /* churn should have needed compaction */
+  FD_TEST( vinyl->metrics.part_cnt );
+
+  if( fd_tile_cnt()>1UL ) {
+
+    FD_LOG_NOTICE(( "Testing churn (over tango)" ));
+
+    FD_TEST( fd_cnc_footprint( 64UL )<=sizeof(cnc_mem) );
+    fd_cnc_t * cnc = fd_cnc_join( fd_cnc_new( cnc_mem, 64UL, 0UL, fd_log_wallclock() ) ); FD_TEST( cnc );
+
+    FD_TEST( fd_mcache_footprint( DEPTH, 0UL )<=sizeof(rq_mcache_mem) );
+    FD_TEST( fd_mcache_footprint( DEPTH, 0UL )<=sizeof(cq_mcache_mem) );
+    fd_frag_meta_t * rq_mcache = fd_mcache_join( fd_mcache_new( rq_mcache_mem, DEPTH, 0UL, 0UL ) ); FD_TEST( rq_mcache );
+    fd_frag_meta_t * cq_mcache = fd_mcache_join( fd_mcache_new( cq_mcache_mem, DEPTH, 0UL, 0UL ) ); FD_TEST( cq_mcache );
+
+    ulong rq_data_sz = fd_dcache_req_data_sz( fd_vinyl_req_sz ( FD_VINYL_REQ_BATCH_MAX ), DEPTH, 1UL, 1 );
+    ulong cq_data_sz = fd_dcache_req_data_sz( fd_vinyl_comp_sz( FD_VINYL_REQ_BATCH_MAX ), DEPTH, 1UL, 1 );
+    FD_TEST( fd_dcache_footprint( rq_data_sz, 0UL )<=sizeof(rq_dcache_mem) );
+    FD_TEST( fd_dcache_footprint( cq_data_sz, 0UL )<=sizeof(cq_dcache_mem) );
+    uchar * rq_dcache = fd_dcache_join( fd_dcache_new( rq_dcache_mem, rq_data_sz, 0UL ) ); FD_TEST( rq_dcache );
+    uchar * cq_dcache = fd_dcache_join( fd_dcache_new( cq_dcache_mem, cq_data_sz, 0UL ) ); FD_TEST( cq_dcache );
+
+    fd_vinyl_link_t link[1];
+    link->rq_mcache = rq_mcache;
+    link->rq_base   = rq_dcache;
+    link->cq_mcache = cq_mcache;
+    link->cq_dcache = cq_dcache;
+    link->cq_base   = cq_dcache;
+
+    FD_TEST( fd_vinyl_run( NULL,  cnc,  1UL,                   link, 0L, rng )==EINVAL );
+    FD_TEST( fd_vinyl_run( vinyl, NULL, 1UL,                   link, 0L, rng )==EINVAL );
+    FD_TEST( fd_vinyl_run( vinyl, cnc,  0UL,                   link, 0L, rng )==EINVAL );
+    FD_TEST( fd_vinyl_run( vinyl, cnc,  FD_VINYL_LINK_MAX+1UL, link, 0L, rng )==EINVAL );
+    FD_TEST( fd_vinyl_run( vinyl, cnc,  1UL,                   NULL, 0L, rng )==EINVAL );
+    FD_TEST( fd_vinyl_run( vinyl, cnc,  1UL,                   link, 0L, NULL )==EINVAL );
+
+    FD_TEST( !fd_vinyl_client_init( NULL,     rq_mcache, rq_dcache, rq_dcache, cq_mcache, cq_dcache ) );
+    FD_TEST( !fd_vinyl_client_init( g_client, NULL,      rq_dcache, rq_dcache, cq_mcache, cq_dcache ) );
+    FD_TEST( !fd_vinyl_client_init( g_client, rq_mcache, rq_dcache, rq_dcache, NULL,      cq_dcache ) );
+    FD_TEST( fd_vinyl_client_init( g_client, rq_mcache, rq_dcache, rq_dcache, cq_mcache, cq_dcache )==g_client );
+
+    g_link = link;
+
+    fd_tile_exec_t * exec = fd_tile_exec_new( 1UL, tile_main, 0, (char **)cnc ); FD_TEST( exec );
+    FD_TEST( fd_cnc_wait( cnc, FD_CNC_SIGNAL_BOOT, (long)5e9, NULL )==FD_CNC_SIGNAL_RUN );
+
+    churn( rng, iter_cnt/10UL, &now );
+
+    FD_TEST( !fd_cnc_open( cnc ) );
+    fd_cnc_signal( cnc, FD_CNC_SIGNAL_HALT );
+    FD_TEST( fd_cnc_wait( cnc, FD_CNC_SIGNAL_HALT, (long)5e9, NULL )==FD_CNC_SIGNAL_BOOT );
+    fd_cnc_close( cnc );
+
+    int ret; FD_TEST( !fd_tile_exec_delete( exec, &ret ) ); FD_TEST( !ret );
+
+    FD_TEST( fd_mcache_seq_query( fd_mcache_seq_laddr_const( cq_mcache ) )==g_client->cq_seq );
+
+    verify( meta );
+
+    g_link = NULL;
+
+    fd_dcache_delete( fd_dcache_leave( cq_dcache ) );
+    fd_dcache_delete( fd_dcache_leave( rq_dcache ) );
+    fd_mcache_delete( fd_mcache_leave( cq_mcache ) );
+    fd_mcache_delete( fd_mcache_leave( rq_mcache ) );
+    fd_cnc_delete   ( fd_cnc_leave   ( cnc       ) );
+
+  } else {
+    FD_LOG_WARNING(( "skip: tango test requires --tile-cpus with at least 2 tiles" ));
+  }
+
+  FD_LOG_NOTICE(( "Testing fini" ));
+
+  /* Leave some keys acquired (including one being created) */
+
+  do {
+    ulong k[2] = { 0UL, KEY_MAX };
+    send( FD_VINYL_REQ_TYPE_ACQUIRE, FD_VINYL_REQ_FLAG_MODIFY | FD_VINYL_REQ_FLAG_CREATE, k, 2UL );
+  } while(0);
+
+  FD_TEST( !fd_vinyl_fini( NULL ) );
+  FD_TEST( fd_vinyl_fini( vinyl )==vinyl_mem );
+
+  verify( meta );
+  for( ulong ele_idx=0UL; ele_idx<ELE_MAX; ele_idx++ )
+    if( fd_vinyl_meta_ele_in_use( ele_mem + ele_idx ) ) FD_TEST( ele_mem[ ele_idx ].line_idx==ULONG_MAX );
+
+  /* Resume on the same bstream and meta */
+
+  vinyl = fd_vinyl_init( vinyl_mem, LINE_CNT, VAL_MAX, io, dev_sz, meta, data_mem, NULL ); FD_TEST( vinyl );
+  g_vinyl = vinyl;
+  churn( rng, iter_cnt/100UL, &now );
+  verify( meta );
+  FD_TEST( fd_vinyl_fini( vinyl )==vinyl_mem );
+
+  FD_LOG_NOTICE(( "Testing recovery" ));
+
+  do {
+    FD_TEST( fd_vinyl_meta_new( rmeta_mem, ELE_MAX, lock_cnt, probe_max, seed )==rmeta_mem );
+    fd_vinyl_meta_t rmeta[1]; FD_TEST( fd_vinyl_meta_join( rmeta, rmeta_mem, rele_mem )==rmeta );
+
+    ulong pair_cnt;
+    FD_TEST( !fd_vinyl_recover( NULL, 0UL, 1UL, io, rmeta, &pair_cnt, NULL ) );
+
+    ulong live_cnt = 0UL;
+    for( ulong ele_idx=0UL; ele_idx<ELE_MAX; ele_idx++ ) {
+      fd_vinyl_meta_ele_t const * ele = ele_mem + ele_idx;
+      if( !fd_vinyl_meta_ele_in_use( ele ) ) continue;
+      ulong rele_idx;
+      FD_TEST( !fd_vinyl_meta_query_fast( rele_mem, ELE_MAX, &ele->phdr.key, ele->memo, &rele_idx ) );
+      FD_TEST( rele_mem[ rele_idx ].seq     ==ele->seq      );
+      FD_TEST( rele_mem[ rele_idx ].phdr.ctl==ele->phdr.ctl );
+      live_cnt++;
+    }
+    FD_TEST( pair_cnt==live_cnt );
+
+    fd_vinyl_meta_leave( rmeta );
+    fd_vinyl_meta_delete( rmeta_mem );
+  } while(0);
+
+  fd_vinyl_meta_leave( meta );
+  fd_vinyl_meta_delete( meta_mem );
+  FD_TEST( fd_vinyl_io_fini( io )==io_mem );
+  fd_rng_delete( fd_rng_leave( rng ) );
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
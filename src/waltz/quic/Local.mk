@@ -6,6 +6,9 @@ $(call add-objs,fd_quic,fd_quic)
 $(call add-hdrs,fd_quic_ack_tx.h)
 $(call add-objs,fd_quic_ack_tx,fd_quic)
 
+$(call add-hdrs,fd_quic_cc.h)
+$(call add-objs,fd_quic_cc,fd_quic)
+
 $(call add-hdrs,fd_quic_conn.h)
 $(call add-objs,fd_quic_conn,fd_quic)
 
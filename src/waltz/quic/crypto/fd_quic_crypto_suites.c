@@ -155,16 +155,17 @@ fd_quic_gen_keys(
      pkt_number_sz     the size of the packet number in bytes
      */
 
-int
-fd_quic_crypto_encrypt(
+static int
+fd_quic_crypto_encrypt_core(
     uchar *                        const out,
     ulong *                        const out_sz,
     uchar const *                  const hdr,
     ulong                          const hdr_sz,
     uchar const *                  const pkt,
     ulong                          const pkt_sz,
-    fd_quic_crypto_keys_t const *  const pkt_keys,
-    fd_quic_crypto_keys_t const *  const hp_keys,
+    fd_aes_gcm_t *                 const pkt_cipher,
+    uchar const *                  const pkt_iv,
+    fd_aes_key_t const *           const hp_cipher_key,
     ulong                          const pkt_number ) {
 
 
@@ -199,12 +200,11 @@ fd_quic_crypto_encrypt(
   uchar const * pkt_number_ptr = out + hdr_sz - pkt_number_sz;
 
   uchar nonce[FD_QUIC_NONCE_SZ] = {0};
-  fd_quic_get_nonce( nonce, pkt_keys->iv, pkt_number );
+  fd_quic_get_nonce( nonce, pkt_iv, pkt_number );
 
   // Initial packets cipher uses AEAD_AES_128_GCM with keys derived from the Destination Connection ID field of the
   // first Initial packet sent by the client; see rfc9001 Section 5.2.
-  fd_aes_gcm_t pkt_cipher[1];
-  fd_aes_128_gcm_init( pkt_cipher, pkt_keys->pkt_key, nonce );
+  fd_aes_gcm_set_iv( pkt_cipher, nonce );
 
   /* cipher_text is start of encrypted packet bytes, which starts after the header */
   uchar * cipher_text = out + hdr_sz;
@@ -221,10 +221,8 @@ fd_quic_crypto_encrypt(
      so shorter packet numbers means sample starts later in the cipher text */
   uchar const * sample = pkt_number_ptr + 4;
 
-  fd_aes_key_t ecb[1];
-  fd_aes_set_encrypt_key( hp_keys->hp_key, 128, ecb );
   uchar hp_cipher[16];
-  fd_aes_encrypt( sample, hp_cipher, ecb );
+  fd_aes_encrypt( sample, hp_cipher, hp_cipher_key );
 
   /* hp_cipher is mask */
   uchar const * mask = hp_cipher;
@@ -242,12 +240,47 @@ fd_quic_crypto_encrypt(
 }
 
 int
-fd_quic_crypto_decrypt(
+fd_quic_crypto_encrypt(
+    uchar *                        const out,
+    ulong *                        const out_sz,
+    uchar const *                  const hdr,
+    ulong                          const hdr_sz,
+    uchar const *                  const pkt,
+    ulong                          const pkt_sz,
+    fd_quic_crypto_keys_t const *  const pkt_keys,
+    fd_quic_crypto_keys_t const *  const hp_keys,
+    ulong                          const pkt_number ) {
+  fd_aes_gcm_t pkt_cipher[1];
+  fd_aes_128_gcm_init( pkt_cipher, pkt_keys->pkt_key, pkt_keys->iv );
+  fd_aes_key_t ecb[1];
+  fd_aes_set_encrypt_key( hp_keys->hp_key, 128, ecb );
+  return fd_quic_crypto_encrypt_core( out, out_sz, hdr, hdr_sz, pkt, pkt_sz,
+                                      pkt_cipher, pkt_keys->iv, ecb, pkt_number );
+}
+
+int
+fd_quic_crypto_ctx_encrypt(
+    uchar *                        const out,
+    ulong *                        const out_sz,
+    uchar const *                  const hdr,
+    ulong                          const hdr_sz,
+    uchar const *                  const pkt,
+    ulong                          const pkt_sz,
+    fd_quic_crypto_ctx_t *         const pkt_ctx,
+    fd_quic_crypto_ctx_t const *   const hp_ctx,
+    ulong                          const pkt_number ) {
+  return fd_quic_crypto_encrypt_core( out, out_sz, hdr, hdr_sz, pkt, pkt_sz,
+                                      pkt_ctx->gcm, pkt_ctx->keys.iv, hp_ctx->hp, pkt_number );
+}
+
+static int
+fd_quic_crypto_decrypt_core(
     uchar *                       buf,
     ulong                         buf_sz,
     ulong                         pkt_number_off,
     ulong                         pkt_number,
-    fd_quic_crypto_keys_t const * keys ) {
+    fd_aes_gcm_t *                pkt_cipher,
+    uchar const *                 pkt_iv ) {
 
   if( FD_UNLIKELY( ( pkt_number_off >= buf_sz      ) |
                    ( buf_sz < FD_QUIC_SHORTEST_PKT ) ) ) {
@@ -265,7 +298,7 @@ fd_quic_crypto_decrypt(
      nonce is quic-iv XORed with *reconstructed* packet-number
      packet number is 1-4 bytes, so only XOR last pkt_number_sz bytes */
   uchar nonce[FD_QUIC_NONCE_SZ] = {0};
-  fd_quic_get_nonce( nonce, keys->iv, pkt_number );
+  fd_quic_get_nonce( nonce, pkt_iv, pkt_number );
 
   if( FD_UNLIKELY( ( buf_sz < hdr_sz ) |
                    ( buf_sz < hdr_sz+FD_QUIC_CRYPTO_TAG_SZ ) ) )
@@ -286,8 +319,7 @@ fd_quic_crypto_decrypt(
   uchar * const gcm_tag = buf_end - FD_QUIC_CRYPTO_TAG_SZ;
   ulong   const gcm_sz  = (ulong)( gcm_tag - out );
 
-  fd_aes_gcm_t pkt_cipher[1];
-  fd_aes_128_gcm_init( pkt_cipher, keys->pkt_key, nonce );
+  fd_aes_gcm_set_iv( pkt_cipher, nonce );
 
   int decrypt_ok =
    fd_aes_gcm_decrypt( pkt_cipher,
@@ -303,13 +335,35 @@ fd_quic_crypto_decrypt(
   return FD_QUIC_SUCCESS;
 }
 
+int
+fd_quic_crypto_decrypt(
+    uchar *                       buf,
+    ulong                         buf_sz,
+    ulong                         pkt_number_off,
+    ulong                         pkt_number,
+    fd_quic_crypto_keys_t const * keys ) {
+  fd_aes_gcm_t pkt_cipher[1];
+  fd_aes_128_gcm_init( pkt_cipher, keys->pkt_key, keys->iv );
+  return fd_quic_crypto_decrypt_core( buf, buf_sz, pkt_number_off, pkt_number, pkt_cipher, keys->iv );
+}
 
 int
-fd_quic_crypto_decrypt_hdr(
+fd_quic_crypto_ctx_decrypt(
+    uchar *                       buf,
+    ulong                         buf_sz,
+    ulong                         pkt_number_off,
+    ulong                         pkt_number,
+    fd_quic_crypto_ctx_t *        ctx ) {
+  return fd_quic_crypto_decrypt_core( buf, buf_sz, pkt_number_off, pkt_number, ctx->gcm, ctx->keys.iv );
+}
+
+
+static int
+fd_quic_crypto_decrypt_hdr_core(
     uchar *                        buf,
     ulong                          buf_sz,
     ulong                          pkt_number_off,
-    fd_quic_crypto_keys_t const *  keys ) {
+    fd_aes_key_t const *           hp_cipher_key ) {
 
   /* bounds checks */
   if( FD_UNLIKELY( ( buf_sz < FD_QUIC_CRYPTO_TAG_SZ ) |
@@ -331,9 +385,7 @@ fd_quic_crypto_decrypt_hdr(
 
   /* TODO this is hardcoded to AES-128 */
   uchar hp_cipher[16];
-  fd_aes_key_t ecb[1];
-  fd_aes_set_encrypt_key( keys->hp_key, 128, ecb );
-  fd_aes_encrypt( sample, hp_cipher, ecb );
+  fd_aes_encrypt( sample, hp_cipher, hp_cipher_key );
 
   /* hp_cipher is mask */
   uchar const * mask = hp_cipher;
@@ -356,3 +408,47 @@ fd_quic_crypto_decrypt_hdr(
 
   return FD_QUIC_SUCCESS;
 }
+
+int
+fd_quic_crypto_decrypt_hdr(
+    uchar *                        buf,
+    ulong                          buf_sz,
+    ulong                          pkt_number_off,
+    fd_quic_crypto_keys_t const *  keys ) {
+  fd_aes_key_t ecb[1];
+  fd_aes_set_encrypt_key( keys->hp_key, 128, ecb );
+  return fd_quic_crypto_decrypt_hdr_core( buf, buf_sz, pkt_number_off, ecb );
+}
+
+int
+fd_quic_crypto_ctx_decrypt_hdr(
+    uchar *                        buf,
+    ulong                          buf_sz,
+    ulong                          pkt_number_off,
+    fd_quic_crypto_ctx_t const *   ctx ) {
+  return fd_quic_crypto_decrypt_hdr_core( buf, buf_sz, pkt_number_off, ctx->hp );
+}
+
+fd_quic_crypto_ctx_t *
+fd_quic_crypto_ctx_init( fd_quic_crypto_ctx_t *        ctx,
+                         fd_quic_crypto_keys_t const * keys ) {
+  ctx->keys = *keys;
+  fd_aes_128_gcm_init( ctx->gcm, keys->pkt_key, keys->iv );
+  fd_aes_set_encrypt_key( keys->hp_key, 128, ctx->hp );
+  ctx->valid = 1;
+  return ctx;
+}
+
+fd_quic_crypto_ctx_t *
+fd_quic_crypto_cache_query( fd_quic_crypto_ctx_t *        cache,
+                            ulong                         cache_cnt,
+                            fd_quic_crypto_keys_t const * keys ) {
+  /* Key material is uniformly random, so low key bits are a good
+     enough slot index */
+  ulong                  slot = FD_LOAD( ulong, keys->pkt_key ) & (cache_cnt-1UL);
+  fd_quic_crypto_ctx_t * ctx  = cache + slot;
+  if( FD_LIKELY( ctx->valid && 0==memcmp( &ctx->keys, keys, sizeof(fd_quic_crypto_keys_t) ) ) ) {
+    return ctx;
+  }
+  return fd_quic_crypto_ctx_init( ctx, keys );
+}
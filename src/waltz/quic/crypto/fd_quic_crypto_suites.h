@@ -2,6 +2,7 @@
 #define HEADER_fd_src_waltz_quic_crypto_fd_quic_crypto_suites_h
 
 #include "../fd_quic_enum.h"
+#include "../../../ballet/aes/fd_aes_base.h"
 #include "../../../ballet/aes/fd_aes_gcm.h"
 
 /* Defines the crypto suites used by QUIC v1.
@@ -42,6 +43,23 @@ struct fd_quic_crypto_keys {
   uchar hp_key [FD_AES_128_KEY_SZ];
 };
 
+/* fd_quic_crypto_ctx_t holds the expanded AES key schedules (AES-GCM
+   packet protection including GHASH key powers, and AES-ECB header
+   protection) for an fd_quic_crypto_keys_t.  Expanding keys costs
+   about as much as protecting a small packet, so contexts of hot keys
+   are cached in a direct-mapped cache (see fd_quic_crypto_cache_query)
+   instead of being rebuilt per packet.  An fd_quic_t sizes its cache
+   with limits->crypto_cache_cnt. */
+
+struct __attribute__((aligned(FD_AES_GCM_ALIGN))) fd_quic_crypto_ctx {
+  fd_aes_gcm_t          gcm[1]; /* packet protection, IV set per packet */
+  fd_aes_key_t          hp [1]; /* header protection */
+  fd_quic_crypto_keys_t keys;   /* keys gcm and hp were expanded from */
+  int                   valid;
+};
+
+typedef struct fd_quic_crypto_ctx fd_quic_crypto_ctx_t;
+
 /* define enums for encryption levels */
 #define fd_quic_enc_level_initial_id    0
 #define fd_quic_enc_level_early_data_id 1
@@ -235,6 +253,55 @@ fd_quic_crypto_decrypt_hdr(
     ulong                          pkt_number_off,
     fd_quic_crypto_keys_t const *  keys );
 
+/* fd_quic_crypto_ctx_init expands keys into ctx.  Returns ctx. */
+
+fd_quic_crypto_ctx_t *
+fd_quic_crypto_ctx_init( fd_quic_crypto_ctx_t *        ctx,
+                         fd_quic_crypto_keys_t const * keys );
+
+/* fd_quic_crypto_cache_query returns a crypto context for keys from
+   cache, expanding keys into a cache slot (evicting the previous
+   occupant) if they are not cached yet.  cache has cache_cnt slots
+   (a power of 2) and is zero-initialized before first use.  The
+   returned context is valid until the next query.  Never fails. */
+
+fd_quic_crypto_ctx_t *
+fd_quic_crypto_cache_query( fd_quic_crypto_ctx_t *        cache,
+                            ulong                         cache_cnt,
+                            fd_quic_crypto_keys_t const * keys );
+
+/* fd_quic_crypto_ctx_{encrypt,decrypt,decrypt_hdr} are equivalent to
+   fd_quic_crypto_{encrypt,decrypt,decrypt_hdr}, but use already
+   expanded keys.  Header protection always uses the hp_key of the
+   given context, packet protection its pkt_key and iv. */
+
+int
+fd_quic_crypto_ctx_encrypt(
+    uchar *                        const out,
+    ulong *                        const out_sz,
+    uchar const *                  const hdr,
+    ulong                          const hdr_sz,
+    uchar const *                  const pkt,
+    ulong                          const pkt_sz,
+    fd_quic_crypto_ctx_t *         const pkt_ctx,
+    fd_quic_crypto_ctx_t const *   const hp_ctx,
+    ulong                          const pkt_number );
+
+int
+fd_quic_crypto_ctx_decrypt(
+    uchar *                        buf,
+    ulong                          buf_sz,
+    ulong                          pkt_number_off,
+    ulong                          pkt_number,
+    fd_quic_crypto_ctx_t *         ctx );
+
+int
+fd_quic_crypto_ctx_decrypt_hdr(
+    uchar *                        buf,
+    ulong                          buf_sz,
+    ulong                          pkt_number_off,
+    fd_quic_crypto_ctx_t const *   ctx );
+
 /* nonce is quic-iv XORed with 62-bits of byte-order packet-number */
 static inline void
 fd_quic_get_nonce(
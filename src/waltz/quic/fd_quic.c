@@ -84,6 +84,11 @@ fd_quic_footprint_ext( fd_quic_limits_t const * limits,
   if( FD_UNLIKELY( conn_id_cnt < FD_QUIC_MIN_CONN_ID_CNT ))
     return 0UL;
 
+  /* Each conn uses one rx and one tx 1-RTT key */
+  ulong crypto_cache_cnt = limits->crypto_cache_cnt;
+  if( !crypto_cache_cnt ) crypto_cache_cnt = fd_ulong_min( fd_ulong_pow2_up( 2UL*conn_cnt ), FD_QUIC_CRYPTO_CACHE_CNT_DEFAULT_MAX );
+  if( FD_UNLIKELY( !fd_ulong_is_pow2( crypto_cache_cnt ) ) ) return 0UL;
+
   layout->meta_sz = sizeof(fd_quic_layout_t);
 
   ulong offs  = 0;
@@ -150,6 +155,12 @@ fd_quic_footprint_ext( fd_quic_limits_t const * limits,
   if( FD_UNLIKELY( !log_footprint ) ) { FD_LOG_WARNING(( "invalid fd_quic_log_buf_footprint for depth %lu", log_depth )); return 0UL; }
   offs += log_footprint;
 
+  /* allocate space for the crypto cache */
+  offs                      = fd_ulong_align_up( offs, alignof(fd_quic_crypto_ctx_t) );
+  layout->crypto_cache_off  = offs;
+  layout->crypto_cache_cnt  = crypto_cache_cnt;
+  offs                     += crypto_cache_cnt*sizeof(fd_quic_crypto_ctx_t);
+
   /* allocate space for service timers */
   offs                       = fd_ulong_align_up( offs, fd_quic_svc_timers_align() );
   layout->svc_timers_off     = offs;
@@ -244,6 +255,7 @@ fd_quic_limits_from_env( int  *   pargc,
   limits->handshake_cnt      = fd_env_strip_cmdline_uint ( pargc, pargv, "--quic-handshakes",    "QUIC_HANDSHAKE_CNT",      512UL );
   limits->inflight_frame_cnt = fd_env_strip_cmdline_ulong( pargc, pargv, "--quic-inflight-pkts", "QUIC_MAX_INFLIGHT_PKTS", 2500UL );
   limits->tx_buf_sz          = fd_env_strip_cmdline_ulong( pargc, pargv, "--quic-tx-buf-sz",     "QUIC_TX_BUF_SZ",         4096UL );
+  limits->crypto_cache_cnt   = fd_env_strip_cmdline_ulong( pargc, pargv, "--quic-crypto-cache",  "QUIC_CRYPTO_CACHE_CNT",     0UL );
 
   return limits;
 }
@@ -353,6 +365,14 @@ fd_quic_init( fd_quic_t * quic ) {
   if( FD_UNLIKELY( !config->idle_timeout  ) ) { FD_LOG_WARNING(( "zero cfg.idle_timeout" )); return NULL; }
   if( FD_UNLIKELY( !config->ack_delay     ) ) { FD_LOG_WARNING(( "zero cfg.ack_delay"    )); return NULL; }
   if( FD_UNLIKELY( !config->retry_ttl     ) ) { FD_LOG_WARNING(( "zero cfg.retry_ttl"    )); return NULL; }
+  if( FD_UNLIKELY( config->steer && config->steer_idx>0xffU ) ) {
+    FD_LOG_WARNING(( "cfg.steer_idx %u out of range [0,256)", config->steer_idx ));
+    return NULL;
+  }
+  if( FD_UNLIKELY( config->cc_algo>=FD_QUIC_CC_ALGO_CNT ) ) {
+    FD_LOG_WARNING(( "invalid cfg.cc_algo %u", config->cc_algo ));
+    return NULL;
+  }
 
   do {
     ulong x = 0U;
@@ -450,6 +470,11 @@ fd_quic_init( fd_quic_t * quic ) {
     return NULL;
   }
 
+  /* State: Initialize crypto cache */
+  state->crypto_cache     = (fd_quic_crypto_ctx_t *)( (ulong)quic + layout.crypto_cache_off );
+  state->crypto_cache_cnt = layout.crypto_cache_cnt;
+  memset( state->crypto_cache, 0, layout.crypto_cache_cnt*sizeof(fd_quic_crypto_ctx_t) );
+
   /* State: Initialize service queue */
   ulong svc_base    = (ulong)quic + layout.svc_timers_off;
   state->svc_timers = fd_quic_svc_timers_init( (void *)svc_base, limits->conn_cnt, state );
@@ -1479,13 +1504,13 @@ fd_quic_handle_v1_initial( fd_quic_t *               quic,
         - No retry token, retry request:  generate new random ID
         - Retry token, accepted:          reuse SCID from retry token */
     if( !quic->config.retry ) {
-      scid = fd_rng_ulong( state->_rng );
+      scid = fd_quic_conn_id_steer( fd_rng_ulong( state->_rng ), quic->config.steer, quic->config.steer_idx );
     } else { /* retry configured */
 
       /* Need to send retry? Do so before more work */
       if( initial->token_len != sizeof(fd_quic_retry_token_t) ) {
 
-        ulong new_conn_id_u64 = fd_rng_ulong( state->_rng );
+        ulong new_conn_id_u64 = fd_quic_conn_id_steer( fd_rng_ulong( state->_rng ), quic->config.steer, quic->config.steer_idx );
         if( FD_UNLIKELY( fd_quic_send_retry(
               quic, pkt,
               dcid, peer_scid, new_conn_id_u64 ) ) ) {
@@ -2108,10 +2133,11 @@ fd_quic_handle_v1_one_rtt( fd_quic_t *      quic,
   pkt->enc_level = fd_quic_enc_level_appdata_id;
 
 # if !FD_QUIC_DISABLE_CRYPTO
+  fd_quic_crypto_ctx_t const * hp_ctx = fd_quic_crypto_cache_query( state->crypto_cache, state->crypto_cache_cnt, &conn->keys[3][0] );
   if( FD_UNLIKELY(
-        fd_quic_crypto_decrypt_hdr( cur_ptr, tot_sz,
-                                    pn_offset,
-                                    &conn->keys[3][0] ) != FD_QUIC_SUCCESS ) ) {
+        fd_quic_crypto_ctx_decrypt_hdr( cur_ptr, tot_sz,
+                                        pn_offset,
+                                        hp_ctx ) != FD_QUIC_SUCCESS ) ) {
     FD_DEBUG( FD_LOG_DEBUG(( "fd_quic_crypto_decrypt_hdr failed" )) );
     quic->metrics.pkt_decrypt_fail_cnt[ fd_quic_enc_level_appdata_id ]++;
     return FD_QUIC_PARSE_FAIL;
@@ -2134,14 +2160,15 @@ fd_quic_handle_v1_one_rtt( fd_quic_t *      quic,
 # if !FD_QUIC_DISABLE_CRYPTO
   /* If the key phase bit flips, decrypt with the new pair of keys
       instead.  Note that the key phase bit is untrusted at this point. */
-  fd_quic_crypto_keys_t * keys = current_key_phase ? &conn->keys[3][0] : &conn->new_keys[0];
+  fd_quic_crypto_keys_t * keys    = current_key_phase ? &conn->keys[3][0] : &conn->new_keys[0];
+  fd_quic_crypto_ctx_t  * pkt_ctx = fd_quic_crypto_cache_query( state->crypto_cache, state->crypto_cache_cnt, keys );
 
   /* this decrypts the header and payload */
   if( FD_UNLIKELY(
-        fd_quic_crypto_decrypt( cur_ptr, tot_sz,
-                                pn_offset,
-                                pkt_number,
-                                keys ) != FD_QUIC_SUCCESS ) ) {
+        fd_quic_crypto_ctx_decrypt( cur_ptr, tot_sz,
+                                    pn_offset,
+                                    pkt_number,
+                                    pkt_ctx ) != FD_QUIC_SUCCESS ) ) {
     /* remove connection from map, and insert into free list */
     FD_DTRACE_PROBE_3( quic_err_decrypt_1rtt_pkt, pkt->ip4, conn->our_conn_id, pkt->pkt_number );
     quic->metrics.pkt_decrypt_fail_cnt[ fd_quic_enc_level_appdata_id ]++;
@@ -3497,6 +3524,94 @@ fd_quic_gen_stream_frames( fd_quic_conn_t             * conn,
   return payload_ptr;
 }
 
+/* fd_quic_conn_cc_can_send returns 1 if the congestion controller
+   permits sending new stream data now.  Otherwise, returns 0 and
+   arranges for the conn to get serviced once the pacer releases the
+   next packet (cwnd-limited conns get rescheduled on ACK or loss). */
+
+static int
+fd_quic_conn_cc_can_send( fd_quic_conn_t * conn,
+                          long             now ) {
+  long next = fd_quic_cc_next_send( conn->cc, now );
+  if( FD_LIKELY( next<=now ) ) return 1;
+
+  /* only count when there is actually stream data held back */
+  if( conn->send_streams->next->sentinel ) return 0;
+  fd_quic_metrics_t * metrics = &conn->quic->metrics;
+  if( next==LONG_MAX ) {
+    metrics->cc_cwnd_limited_cnt++;
+  } else {
+    metrics->cc_pacing_limited_cnt++;
+    fd_quic_svc_prep_schedule( conn, next );
+  }
+  return 0;
+}
+
+/* fd_quic_conn_cc_on_sent accounts a sent packet to the congestion
+   controller.  The packet size is remembered on the first pkt_meta of
+   the packet, so it can be subtracted from the bytes in flight when
+   the packet is acknowledged or lost. */
+
+static void
+fd_quic_conn_cc_on_sent( fd_quic_conn_t * conn,
+                         ulong            pkt_number,
+                         ulong            pkt_sz ) {
+  fd_quic_pkt_meta_tracker_t * tracker = &conn->pkt_meta_tracker;
+  fd_quic_pkt_meta_t         * pool    = tracker->pool;
+  fd_quic_pkt_meta_ds_t      * sent    = &tracker->sent_pkt_metas[ fd_quic_enc_level_appdata_id ];
+
+  fd_quic_pkt_meta_ds_fwd_iter_t iter = fd_quic_pkt_meta_ds_idx_ge( sent, pkt_number, pool );
+  if( FD_UNLIKELY( fd_quic_pkt_meta_ds_fwd_iter_done( iter ) ) ) return;
+  fd_quic_pkt_meta_t * pkt_meta = fd_quic_pkt_meta_ds_fwd_iter_ele( iter, pool );
+  if( FD_UNLIKELY( pkt_meta->key.pkt_num!=( pkt_number & FD_QUIC_PKT_META_PKT_NUM_MASK ) ) ) return;
+
+  pkt_meta->tx_sz = (ushort)pkt_sz;
+  fd_quic_cc_on_sent( conn->cc, pkt_sz );
+  conn->quic->metrics.cc_inflight_sz += pkt_sz;
+}
+
+/* fd_quic_conn_cc_on_ack removes an acknowledged packet from the
+   bytes in flight.  If stream data was held back by cwnd, reschedules
+   the conn so it gets sent. */
+
+static void
+fd_quic_conn_cc_on_ack( fd_quic_conn_t           * conn,
+                        fd_quic_pkt_meta_t const * pkt_meta,
+                        long                       now ) {
+  fd_quic_cc_t      * cc      = conn->cc;
+  fd_quic_metrics_t * metrics = &conn->quic->metrics;
+  ulong cwnd0     = cc->cwnd;
+  ulong inflight0 = cc->inflight;
+
+  fd_quic_cc_on_ack( cc, pkt_meta->tx_sz, pkt_meta->tx_time, conn->rtt, now );
+
+  metrics->cc_cwnd_sz     += cc->cwnd - cwnd0;
+  metrics->cc_inflight_sz -= inflight0 - cc->inflight;
+
+  if( !conn->send_streams->next->sentinel ) fd_quic_svc_prep_schedule( conn, now );
+}
+
+/* fd_quic_conn_cc_on_loss removes a lost packet from the bytes in
+   flight and lets the congestion controller react. */
+
+static void
+fd_quic_conn_cc_on_loss( fd_quic_conn_t           * conn,
+                         fd_quic_pkt_meta_t const * pkt_meta,
+                         long                       now ) {
+  fd_quic_cc_t      * cc      = conn->cc;
+  fd_quic_metrics_t * metrics = &conn->quic->metrics;
+  ulong cwnd0     = cc->cwnd;
+  ulong inflight0 = cc->inflight;
+
+  int event = fd_quic_cc_on_loss( cc, pkt_meta->tx_sz, pkt_meta->tx_time, conn->rtt, now );
+
+  metrics->cc_cwnd_sz              += cc->cwnd - cwnd0;
+  metrics->cc_inflight_sz          -= inflight0 - cc->inflight;
+  metrics->cc_pkt_lost_cnt         += 1UL;
+  metrics->cc_byte_lost_cnt        += pkt_meta->tx_sz;
+  metrics->cc_congestion_event_cnt += (ulong)event;
+}
+
 uchar *
 fd_quic_gen_frames( fd_quic_conn_t           * conn,
                     uchar                    * payload_ptr,
@@ -3528,7 +3643,7 @@ fd_quic_gen_frames( fd_quic_conn_t           * conn,
         payload_ptr += fd_quic_gen_max_streams_frame( conn, payload_ptr, payload_end, pkt_meta_tmpl, tracker );
         payload_ptr += fd_quic_gen_ping_frame       ( conn, payload_ptr, payload_end, pkt_meta_tmpl, tracker );
       }
-      if( FD_LIKELY( !conn->tls_hs ) ) {
+      if( FD_LIKELY( !conn->tls_hs ) && fd_quic_conn_cc_can_send( conn, now ) ) {
         payload_ptr = fd_quic_gen_stream_frames( conn, payload_ptr, payload_end, pkt_meta_tmpl, tracker );
       }
     }
@@ -3758,7 +3873,8 @@ fd_quic_conn_tx( fd_quic_t      * quic,
     /* payload_end leaves room for TAG */
     uchar * payload_end = payload_ptr + payload_sz - FD_QUIC_CRYPTO_TAG_SZ;
 
-    uchar * const frame_start = payload_ptr;
+    uchar * const frame_start   = payload_ptr;
+    ulong   const pkt_meta_cnt0 = conn->used_pkt_meta;
     payload_ptr = fd_quic_gen_frames( conn, frame_start, payload_end, pkt_meta_tmpl, now );
     if( FD_UNLIKELY( payload_ptr < frame_start ) ) FD_LOG_CRIT(( "fd_quic_gen_frames failed" ));
 
@@ -3820,6 +3936,7 @@ fd_quic_conn_tx( fd_quic_t      * quic,
     /* append MAC tag */
     memset( conn->tx_ptr, 0, FD_QUIC_CRYPTO_TAG_SZ );
     conn->tx_ptr += FD_QUIC_CRYPTO_TAG_SZ;
+    ulong tx_pkt_sz = quic_pkt_sz + FD_QUIC_CRYPTO_TAG_SZ;
 #else
     ulong   cipher_text_sz = fd_quic_conn_tx_buf_remaining( conn );
     ulong   frames_sz      = (ulong)( payload_ptr - frame_start ); /* including padding */
@@ -3827,8 +3944,19 @@ fd_quic_conn_tx( fd_quic_t      * quic,
     fd_quic_crypto_keys_t * hp_keys  = &conn->keys[enc_level][1];
     fd_quic_crypto_keys_t * pkt_keys = key_phase_upd ? &conn->new_keys[1] : &conn->keys[enc_level][1];
 
-    if( FD_UNLIKELY( fd_quic_crypto_encrypt( conn->tx_ptr, &cipher_text_sz, hdr_ptr, hdr_sz,
-          frame_start, frames_sz, pkt_keys, hp_keys, pkt_number ) != FD_QUIC_SUCCESS ) ) {
+    /* 1-RTT keys are long-lived, use cached key schedules.  (Both keys
+       are looked up with one query, so skip the cache while a key
+       update is in progress) */
+    int encrypt_rc;
+    if( FD_LIKELY( enc_level==fd_quic_enc_level_appdata_id && pkt_keys==hp_keys ) ) {
+      fd_quic_crypto_ctx_t * ctx = fd_quic_crypto_cache_query( state->crypto_cache, state->crypto_cache_cnt, pkt_keys );
+      encrypt_rc = fd_quic_crypto_ctx_encrypt( conn->tx_ptr, &cipher_text_sz, hdr_ptr, hdr_sz,
+                                               frame_start, frames_sz, ctx, ctx, pkt_number );
+    } else {
+      encrypt_rc = fd_quic_crypto_encrypt( conn->tx_ptr, &cipher_text_sz, hdr_ptr, hdr_sz,
+                                           frame_start, frames_sz, pkt_keys, hp_keys, pkt_number );
+    }
+    if( FD_UNLIKELY( encrypt_rc != FD_QUIC_SUCCESS ) ) {
       FD_LOG_WARNING(( "fd_quic_crypto_encrypt failed" ));
 
       /* this situation is unlikely to improve, so kill the connection */
@@ -3839,11 +3967,19 @@ fd_quic_conn_tx( fd_quic_t      * quic,
     }
 
     conn->tx_ptr += cipher_text_sz;
+    ulong tx_pkt_sz = cipher_text_sz;
 #endif
 
     /* we have committed the packet into the buffer, so inc pkt_number */
     conn->pkt_number[pn_space]++;
 
+    /* ack-eliciting 1-RTT packets count towards bytes in flight */
+    if( ( enc_level==fd_quic_enc_level_appdata_id         ) &
+        ( conn->used_pkt_meta!=pkt_meta_cnt0              ) &
+        ( conn->cc->algo!=FD_QUIC_CC_ALGO_NONE            ) ) {
+      fd_quic_conn_cc_on_sent( conn, pkt_number, tx_pkt_sz );
+    }
+
     if( enc_level == fd_quic_enc_level_appdata_id ) {
       /* short header must be last in datagram
          so send in packet immediately */
@@ -4070,6 +4206,10 @@ fd_quic_conn_free( fd_quic_t *      quic,
   state->free_conn_list = conn->conn_idx;
 
   quic->metrics.conn_alloc_cnt--;
+  if( conn->cc->algo!=FD_QUIC_CC_ALGO_NONE ) {
+    quic->metrics.cc_cwnd_sz     -= conn->cc->cwnd;
+    quic->metrics.cc_inflight_sz -= conn->cc->inflight;
+  }
 
   /* clear keys */
   memset( &conn->secrets, 0, sizeof(fd_quic_crypto_secrets_t) );
@@ -4098,7 +4238,7 @@ fd_quic_connect( fd_quic_t * quic,
 
   /* create conn ids for us and them
      client creates connection id for the peer, peer immediately replaces it */
-  ulong our_conn_id_u64 = fd_rng_ulong( rng );
+  ulong our_conn_id_u64 = fd_quic_conn_id_steer( fd_rng_ulong( rng ), quic->config.steer, quic->config.steer_idx );
   fd_quic_conn_id_t peer_conn_id;  fd_quic_conn_id_rand( &peer_conn_id, rng );
 
   fd_quic_conn_t * conn = fd_quic_conn_create(
@@ -4313,6 +4453,10 @@ fd_quic_conn_create( fd_quic_t *               quic,
   rtt->var_rtt                   = FD_QUIC_INITIAL_RTT_US * 1e3f * 0.5f;
   conn->rtt_period_ns            = FD_QUIC_RTT_PERIOD_US  * 1e3f;
 
+  /* congestion control */
+  fd_quic_cc_init( conn->cc, quic->config.cc_algo, conn->tx_max_datagram_sz, rtt, state->now );
+  if( conn->cc->algo!=FD_QUIC_CC_ALGO_NONE ) quic->metrics.cc_cwnd_sz += conn->cc->cwnd;
+
   /* idle timeout */
   conn->idle_timeout_ns      = config->idle_timeout;
   conn->last_activity        = state->now;
@@ -4520,6 +4664,8 @@ fd_quic_pkt_meta_retry( fd_quic_t      *  quic,
         break;
     }
 
+    if( pkt_meta->tx_sz ) fd_quic_conn_cc_on_loss( conn, pkt_meta, now );
+
     /* reschedule to ensure the data gets processed */
     fd_quic_svc_prep_schedule_now( conn );
 
@@ -4748,6 +4894,7 @@ fd_quic_process_ack_range( fd_quic_conn_t      * conn,
       pkt->rtt_ack_time   = now - e->tx_time; /* in ns         */
       pkt->rtt_ack_delay  = ack_delay;        /* in peer units */
     }
+    if( e->tx_sz ) fd_quic_conn_cc_on_ack( conn, e, now );
     fd_quic_reclaim_pkt_meta( conn, e, enc_level );
   }
 
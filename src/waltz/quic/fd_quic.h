@@ -118,9 +118,18 @@ struct __attribute__((aligned(16UL))) fd_quic_limits {
   /* the user consumes rx directly from the network buffer */
 
   ulong  stream_pool_cnt;           /* instance-wide, number of streams in stream pool */
+
+  ulong  crypto_cache_cnt;          /* instance-wide, expanded 1-RTT key cache slots (power of 2),
+                                       0 for 2 per conn up to FD_QUIC_CRYPTO_CACHE_CNT_DEFAULT_MAX */
 };
 typedef struct fd_quic_limits fd_quic_limits_t;
 
+/* FD_QUIC_CRYPTO_CACHE_CNT_DEFAULT_MAX caps the number of crypto cache
+   slots derived from conn_cnt when limits->crypto_cache_cnt is 0 (each
+   slot is about 1.2 KiB). */
+
+#define FD_QUIC_CRYPTO_CACHE_CNT_DEFAULT_MAX (1UL<<14)
+
 /* fd_quic_layout_t is an offset table describing the memory layout of
    an fd_quic_t object.  It is deived from fd_quic_limits_t. */
 
@@ -135,6 +144,8 @@ struct fd_quic_layout {
   ulong stream_pool_off;   /* offset of the stream pool        */
   ulong svc_timers_off;    /* offset of the service timers     */
   ulong pkt_meta_pool_off; /* offset of the pkt_meta pool      */
+  ulong crypto_cache_off;  /* offset of the crypto cache       */
+  ulong crypto_cache_cnt;  /* slots in the crypto cache        */
 };
 
 typedef struct fd_quic_layout fd_quic_layout_t;
@@ -162,7 +173,10 @@ struct __attribute__((aligned(16UL))) fd_quic_config {
   X( sign_ctx,                    "%p",     ptr,   "",             __VA_ARGS__ ) \
   X( keylog_file,                 "%s",     value, "",             __VA_ARGS__ ) \
   X( initial_rx_max_stream_data,  "%lu",    units, "bytes",        __VA_ARGS__ ) \
-  X( net.dscp,                    "0x%02x", value, "",             __VA_ARGS__ )
+  X( net.dscp,                    "0x%02x", value, "",             __VA_ARGS__ ) \
+  X( steer,                       "%d",     bool,  "bool",         __VA_ARGS__ ) \
+  X( steer_idx,                   "%u",     value, "",             __VA_ARGS__ ) \
+  X( cc_algo,                     "%u",     value, "",             __VA_ARGS__ )
 
   /* Protocol config ***************************************/
 
@@ -224,6 +238,22 @@ struct __attribute__((aligned(16UL))) fd_quic_config {
        Set on all outgoing IPv4 packets. */
     uchar dscp;
   } net;
+
+  /* Flow steering config **********************************/
+
+  /* steer: if non-zero, the first byte of every conn ID issued by this
+     endpoint is set to steer_idx (see fd_quic_conn_id_steer).  Used to
+     shard connections across multiple fd_quic instances behind a
+     stateless load balancer.  steer_idx should be in [0,256). */
+  int  steer;
+  uint steer_idx;
+
+  /* Congestion control config *****************************/
+
+  /* cc_algo: one of FD_QUIC_CC_ALGO_{NONE,NEWRENO,BBR} (see
+     fd_quic_cc.h).  Selects the congestion controller and pacer used
+     for 1-RTT packets on every conn.  Default is NONE. */
+  uint cc_algo;
 };
 
 /* Callback API *******************************************************/
@@ -336,6 +366,15 @@ union fd_quic_metrics {
     ulong pkt_retransmissions_cnt[ 4 ]; /* number of pkt_meta retries */
     ulong initial_token_len_cnt[ 3 ];   /* number of Initial packets grouped by token length */
 
+    /* Congestion control metrics (only with cc_algo!=NONE) */
+    ulong cc_cwnd_sz;              /* sum of congestion windows across conns (bytes) */
+    ulong cc_inflight_sz;          /* sum of bytes in flight across conns */
+    ulong cc_pkt_lost_cnt;         /* number of congestion controlled packets declared lost */
+    ulong cc_byte_lost_cnt;        /* bytes in congestion controlled packets declared lost */
+    ulong cc_congestion_event_cnt; /* number of congestion window reductions */
+    ulong cc_cwnd_limited_cnt;     /* number of times stream data was held back by cwnd */
+    ulong cc_pacing_limited_cnt;   /* number of times stream data was held back by the pacer */
+
     /* Frame metrics */
     ulong frame_rx_cnt[ 22 ];      /* number of frames received (indexed by implementation-defined IDs) */
     ulong frame_rx_err_cnt;        /* number of frames failed */
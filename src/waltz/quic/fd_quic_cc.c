@@ -0,0 +1,308 @@
+#include "fd_quic_cc.h"
+
+/* RFC 9002 Appendix B.2 constants */
+
+#define FD_QUIC_CC_LOSS_REDUCTION (0.5f)
+
+static inline ulong
+fd_quic_cc_initial_window( ulong mtu ) {
+  return fd_ulong_min( 10UL*mtu, fd_ulong_max( 14720UL, 2UL*mtu ) );
+}
+
+static inline ulong
+fd_quic_cc_min_window( fd_quic_cc_t const * cc ) {
+  return 2UL*cc->mtu;
+}
+
+/* BBR gains (BBRv2 draft, Section 4.6) */
+
+#define FD_QUIC_CC_BBR_STARTUP_GAIN  (2.885f) /* 2/ln(2) */
+#define FD_QUIC_CC_BBR_CWND_GAIN     (2.0f)
+#define FD_QUIC_CC_BBR_BETA          (0.7f)   /* inflight_hi reduction on loss */
+#define FD_QUIC_CC_BBR_LOSS_THRESH   (50UL)   /* 1/50 == 2% loss rate */
+#define FD_QUIC_CC_BBR_MIN_PIPE_CNT  (4UL)    /* min cwnd in datagrams */
+#define FD_QUIC_CC_BBR_FULL_BW_CNT   (3U)     /* rounds w/o growth to exit startup */
+#define FD_QUIC_CC_BBR_CYCLE_CNT     (8U)
+
+static float const fd_quic_cc_bbr_cycle_gain[ FD_QUIC_CC_BBR_CYCLE_CNT ] = {
+  1.25f, 0.75f, 1.f, 1.f, 1.f, 1.f, 1.f, 1.f
+};
+
+static inline float
+fd_quic_cc_srtt( fd_rtt_estimate_t const * rtt ) {
+  return fmaxf( rtt->smoothed_rtt, 1.f );
+}
+
+static inline float
+fd_quic_cc_bbr_bw( fd_quic_cc_t const * cc ) {
+  float bw = 0.f;
+  for( ulong j=0UL; j<FD_QUIC_CC_BBR_BW_WIN; j++ ) bw = fmaxf( bw, cc->bbr_bw[j] );
+  return bw;
+}
+
+static inline ulong
+fd_quic_cc_bbr_min_window( fd_quic_cc_t const * cc ) {
+  return FD_QUIC_CC_BBR_MIN_PIPE_CNT * cc->mtu;
+}
+
+/* fd_quic_cc_update_pacing recomputes the pacing rate after a change
+   to cwnd or the path model.  The rate never drops below one datagram
+   per smoothed RTT. */
+
+static void
+fd_quic_cc_update_pacing( fd_quic_cc_t *            cc,
+                          fd_rtt_estimate_t const * rtt ) {
+  float srtt = fd_quic_cc_srtt( rtt );
+  float rate;
+  switch( cc->algo ) {
+  case FD_QUIC_CC_ALGO_NEWRENO: {
+    /* Pace at a multiple of cwnd/srtt so that ACK clocking, not the
+       pacer, remains the limiting factor (RFC 9002 Section 7.7) */
+    float gain = cc->cwnd < cc->ssthresh ? 2.0f : 1.25f;
+    rate = gain * (float)cc->cwnd / srtt;
+    break;
+  }
+  case FD_QUIC_CC_ALGO_BBR: {
+    float bw = fd_quic_cc_bbr_bw( cc );
+    if( bw<=0.f ) {
+      rate = FD_QUIC_CC_BBR_STARTUP_GAIN * (float)cc->cwnd / srtt;
+      break;
+    }
+    float gain;
+    switch( cc->bbr_state ) {
+    case FD_QUIC_CC_BBR_STATE_STARTUP: gain = FD_QUIC_CC_BBR_STARTUP_GAIN;        break;
+    case FD_QUIC_CC_BBR_STATE_DRAIN:   gain = 1.f/FD_QUIC_CC_BBR_STARTUP_GAIN;    break;
+    default:                           gain = fd_quic_cc_bbr_cycle_gain[ cc->bbr_cycle_idx ]; break;
+    }
+    rate = gain * bw;
+    break;
+  }
+  default:
+    return;
+  }
+  cc->pace_rate = fmaxf( rate, (float)cc->mtu / srtt );
+}
+
+fd_quic_cc_t *
+fd_quic_cc_init( fd_quic_cc_t *            cc,
+                 uint                      algo,
+                 ulong                     mtu,
+                 fd_rtt_estimate_t const * rtt,
+                 long                      now ) {
+  memset( cc, 0, sizeof(fd_quic_cc_t) );
+  cc->algo           = algo;
+  cc->mtu            = (uint)mtu;
+  cc->cwnd           = algo==FD_QUIC_CC_ALGO_NONE ? ULONG_MAX : fd_quic_cc_initial_window( mtu );
+  cc->recovery_start = LONG_MIN;
+  cc->pace_tokens    = (float)( FD_QUIC_CC_PACE_BURST_CNT * mtu );
+  cc->pace_ts        = now;
+  cc->ssthresh       = ULONG_MAX;
+  cc->bbr_state      = FD_QUIC_CC_BBR_STATE_STARTUP;
+  cc->bbr_min_rtt    = rtt->min_rtt;
+  cc->round_start    = now;
+  cc->inflight_hi    = ULONG_MAX;
+  fd_quic_cc_update_pacing( cc, rtt );
+  return cc;
+}
+
+static void
+fd_quic_cc_newreno_on_ack( fd_quic_cc_t * cc,
+                           ulong          sz,
+                           long           tx_time ) {
+  /* No window growth during recovery (RFC 9002 Section 7.3.2) */
+  if( tx_time <= cc->recovery_start ) return;
+
+  /* Only grow the window while it is being utilized (RFC 9002 Section
+     7.8).  Like Linux, treat the window as utilized if at least half
+     of it was in flight during the last two rounds, so that bursty
+     senders (e.g. votes sent at slot boundaries) still open it up. */
+  ulong inflight_max = fd_ulong_max( cc->round_inflight, cc->prev_round_inflight );
+  if( 2UL*inflight_max < cc->cwnd ) return;
+
+  if( cc->cwnd < cc->ssthresh ) {
+    /* Slow start */
+    cc->cwnd += sz;
+  } else {
+    /* Congestion avoidance: one datagram per cwnd acknowledged */
+    cc->ack_acc += sz;
+    while( cc->ack_acc >= cc->cwnd ) {
+      cc->ack_acc -= cc->cwnd;
+      cc->cwnd    += cc->mtu;
+    }
+  }
+}
+
+static int
+fd_quic_cc_newreno_on_loss( fd_quic_cc_t * cc,
+                            long           tx_time,
+                            long           now ) {
+  if( tx_time <= cc->recovery_start ) return 0;
+  cc->recovery_start = now;
+  cc->ssthresh       = fd_ulong_max( (ulong)( (float)cc->cwnd * FD_QUIC_CC_LOSS_REDUCTION ), fd_quic_cc_min_window( cc ) );
+  cc->cwnd           = cc->ssthresh;
+  cc->ack_acc        = 0UL;
+  return 1;
+}
+
+/* fd_quic_cc_bbr_round_end is called once per round trip, before the
+   round counters are reset.  It takes a delivery rate sample and
+   advances the state machine. */
+
+static void
+fd_quic_cc_bbr_round_end( fd_quic_cc_t * cc,
+                          long           now ) {
+  long  elapsed   = now - cc->round_start;
+  ulong delivered = cc->delivered - cc->round_delivered;
+  float bw_max    = fd_quic_cc_bbr_bw( cc );
+
+  if( elapsed>0L ) {
+    float sample = (float)delivered / (float)elapsed;
+    /* Application-limited rounds (less than half the window was ever
+       in flight) underestimate the path bandwidth.  Only let them
+       raise the estimate. */
+    int app_limited = 2UL*cc->round_inflight < cc->cwnd;
+    if( !app_limited || sample>bw_max ) {
+      cc->bbr_bw[ cc->bbr_bw_idx ] = sample;
+      cc->bbr_bw_idx = (uint)( ( cc->bbr_bw_idx+1UL ) % FD_QUIC_CC_BBR_BW_WIN );
+      bw_max = fmaxf( bw_max, sample );
+    }
+  }
+
+  switch( cc->bbr_state ) {
+  case FD_QUIC_CC_BBR_STATE_STARTUP:
+    if( bw_max >= cc->bbr_full_bw * 1.25f ) {
+      cc->bbr_full_bw     = bw_max;
+      cc->bbr_full_bw_cnt = 0U;
+    } else if( ++cc->bbr_full_bw_cnt >= FD_QUIC_CC_BBR_FULL_BW_CNT ) {
+      cc->bbr_state = FD_QUIC_CC_BBR_STATE_DRAIN;
+    }
+    break;
+  case FD_QUIC_CC_BBR_STATE_PROBE_BW:
+    /* A loss-free probe round raises the inflight bound again */
+    if( fd_quic_cc_bbr_cycle_gain[ cc->bbr_cycle_idx ]>1.f &&
+        !cc->round_lost && cc->inflight_hi!=ULONG_MAX ) {
+      cc->inflight_hi += cc->inflight_hi>>2;
+    }
+    cc->bbr_cycle_idx = ( cc->bbr_cycle_idx+1U ) % FD_QUIC_CC_BBR_CYCLE_CNT;
+    break;
+  default:
+    break;
+  }
+}
+
+static void
+fd_quic_cc_bbr_set_cwnd( fd_quic_cc_t * cc,
+                         ulong          sz ) {
+  float bw = fd_quic_cc_bbr_bw( cc );
+  if( bw>0.f ) {
+    float bdp    = bw * cc->bbr_min_rtt;
+    float gain   = cc->bbr_state==FD_QUIC_CC_BBR_STATE_STARTUP ? FD_QUIC_CC_BBR_STARTUP_GAIN : FD_QUIC_CC_BBR_CWND_GAIN;
+    ulong target = fd_ulong_max( (ulong)( gain*bdp ), fd_quic_cc_bbr_min_window( cc ) );
+
+    /* Grow towards the target as data is acknowledged, shrink at once */
+    if( cc->cwnd < target ) cc->cwnd = fd_ulong_min( cc->cwnd + sz, target );
+    else                    cc->cwnd = target;
+
+    if( cc->bbr_state==FD_QUIC_CC_BBR_STATE_DRAIN && (float)cc->inflight <= bdp ) {
+      cc->bbr_state     = FD_QUIC_CC_BBR_STATE_PROBE_BW;
+      cc->bbr_cycle_idx = 0U;
+    }
+  }
+  cc->cwnd = fd_ulong_min( cc->cwnd, fd_ulong_max( cc->inflight_hi, fd_quic_cc_bbr_min_window( cc ) ) );
+}
+
+
+static int
+fd_quic_cc_bbr_on_loss( fd_quic_cc_t * cc,
+                        long           tx_time,
+                        long           now ) {
+  /* BBRv2 tolerates a small loss rate.  Once the loss rate in this
+     round exceeds the threshold, bound inflight at BETA of what was
+     in flight and stop probing.  At most once per round trip. */
+  if( tx_time <= cc->recovery_start ) return 0;
+  ulong round_tot = cc->delivered - cc->round_delivered + cc->round_lost;
+  if( cc->round_lost*FD_QUIC_CC_BBR_LOSS_THRESH <= round_tot ) return 0;
+
+  cc->recovery_start = now;
+  ulong bound     = fd_ulong_min( cc->inflight_hi, cc->cwnd );
+  cc->inflight_hi = fd_ulong_max( (ulong)( (float)bound * FD_QUIC_CC_BBR_BETA ), fd_quic_cc_bbr_min_window( cc ) );
+  cc->cwnd        = fd_ulong_min( cc->cwnd, cc->inflight_hi );
+  if( cc->bbr_state==FD_QUIC_CC_BBR_STATE_STARTUP ) cc->bbr_state = FD_QUIC_CC_BBR_STATE_DRAIN;
+  return 1;
+}
+
+void
+fd_quic_cc_on_ack( fd_quic_cc_t *            cc,
+                   ulong                     sz,
+                   long                      tx_time,
+                   fd_rtt_estimate_t const * rtt,
+                   long                      now ) {
+  if( cc->algo==FD_QUIC_CC_ALGO_NONE ) return;
+
+  cc->inflight  -= fd_ulong_min( sz, cc->inflight );
+  cc->delivered += sz;
+
+  if( tx_time >= cc->round_start ) {
+    if( cc->algo==FD_QUIC_CC_ALGO_BBR ) fd_quic_cc_bbr_round_end( cc, now );
+    cc->round_start         = now;
+    cc->round_delivered     = cc->delivered;
+    cc->round_lost          = 0UL;
+    cc->prev_round_inflight = cc->round_inflight;
+    cc->round_inflight      = cc->inflight;
+  }
+
+  switch( cc->algo ) {
+  case FD_QUIC_CC_ALGO_NEWRENO:
+    fd_quic_cc_newreno_on_ack( cc, sz, tx_time );
+    break;
+  case FD_QUIC_CC_ALGO_BBR:
+    cc->bbr_min_rtt = rtt->min_rtt;
+    fd_quic_cc_bbr_set_cwnd( cc, sz );
+    break;
+  }
+  fd_quic_cc_update_pacing( cc, rtt );
+}
+
+int
+fd_quic_cc_on_loss( fd_quic_cc_t *            cc,
+                    ulong                     sz,
+                    long                      tx_time,
+                    fd_rtt_estimate_t const * rtt,
+                    long                      now ) {
+  if( cc->algo==FD_QUIC_CC_ALGO_NONE ) return 0;
+
+  cc->inflight   -= fd_ulong_min( sz, cc->inflight );
+  cc->round_lost += sz;
+
+  int event;
+  switch( cc->algo ) {
+  case FD_QUIC_CC_ALGO_NEWRENO:
+    event = fd_quic_cc_newreno_on_loss( cc, tx_time, now );
+    break;
+  case FD_QUIC_CC_ALGO_BBR:
+    event = fd_quic_cc_bbr_on_loss( cc, tx_time, now );
+    break;
+  default:
+    return 0;
+  }
+  if( event ) fd_quic_cc_update_pacing( cc, rtt );
+  return event;
+}
+
+char const *
+fd_quic_cc_algo_name( uint algo ) {
+  switch( algo ) {
+  case FD_QUIC_CC_ALGO_NONE:    return "none";
+  case FD_QUIC_CC_ALGO_NEWRENO: return "newreno";
+  case FD_QUIC_CC_ALGO_BBR:     return "bbr";
+  default:                      return "unknown";
+  }
+}
+
+int
+fd_quic_cc_algo_from_cstr( char const * name ) {
+  if( !strcmp( name, "none"    ) ) return FD_QUIC_CC_ALGO_NONE;
+  if( !strcmp( name, "newreno" ) ) return FD_QUIC_CC_ALGO_NEWRENO;
+  if( !strcmp( name, "bbr"     ) ) return FD_QUIC_CC_ALGO_BBR;
+  return -1;
+}
@@ -0,0 +1,178 @@
+#ifndef HEADER_fd_src_waltz_quic_fd_quic_cc_h
+#define HEADER_fd_src_waltz_quic_fd_quic_cc_h
+
+/* fd_quic_cc.h provides congestion control and pacing for fd_quic
+   connections.
+
+   fd_quic only congestion controls 1-RTT packets carrying ack-eliciting
+   frames.  Each such packet is "in flight" from the time it is sent
+   until it is either acknowledged or declared lost (RFC 9002, Section
+   2).  Initial and Handshake packets are small and bounded by the TLS
+   flight sizes, so they bypass the controller.
+
+   A controller decides how many bytes may be in flight (cwnd) and how
+   quickly those bytes are released onto the wire (pacing rate).  Pacing
+   uses a token bucket that permits bursts of up to
+   FD_QUIC_CC_PACE_BURST_CNT datagrams, which smooths out the bursts
+   that otherwise cause tail drops on long paths with shallow buffers.
+
+   The algorithm is selected per fd_quic_t via config.cc_algo:
+
+     FD_QUIC_CC_ALGO_NONE      no congestion control (cwnd unlimited,
+                               no pacing).  Zero overhead.
+     FD_QUIC_CC_ALGO_NEWRENO   RFC 9002 Section 7 / Appendix B NewReno
+     FD_QUIC_CC_ALGO_BBR       Simplified BBRv2-style model-based
+                               controller.  Estimates bottleneck
+                               bandwidth per round trip, sizes cwnd to
+                               a multiple of the bandwidth-delay
+                               product, and bounds inflight on loss.
+
+   All times are in ns (same as fd_rtt_estimate_t).  None of these
+   functions allocate or fail. */
+
+#include "fd_quic_common.h"
+#include "../fd_rtt_est.h"
+
+#define FD_QUIC_CC_ALGO_NONE    (0)
+#define FD_QUIC_CC_ALGO_NEWRENO (1)
+#define FD_QUIC_CC_ALGO_BBR     (2)
+#define FD_QUIC_CC_ALGO_CNT     (3)
+
+/* FD_QUIC_CC_PACE_BURST_CNT is the max number of datagrams released
+   back-to-back by the pacer.  Matches the initial window, as permitted
+   by RFC 9002 Section 7.7. */
+
+#define FD_QUIC_CC_PACE_BURST_CNT (10UL)
+
+/* FD_QUIC_CC_BBR_BW_WIN is the number of round trips in the bottleneck
+   bandwidth max filter window. */
+
+#define FD_QUIC_CC_BBR_BW_WIN (10UL)
+
+#define FD_QUIC_CC_BBR_STATE_STARTUP  (0)
+#define FD_QUIC_CC_BBR_STATE_DRAIN    (1)
+#define FD_QUIC_CC_BBR_STATE_PROBE_BW (2)
+
+struct fd_quic_cc {
+  uint  algo;           /* FD_QUIC_CC_ALGO_{...} */
+  uint  mtu;            /* max datagram size in bytes */
+  ulong cwnd;           /* congestion window in bytes */
+  ulong inflight;       /* bytes in flight */
+  long  recovery_start; /* packets sent before this time do not trigger
+                           another congestion event (RFC 9002 7.3.2) */
+
+  /* Pacer */
+  float pace_rate;      /* bytes per ns */
+  float pace_tokens;    /* bytes, may go negative */
+  long  pace_ts;        /* last token refill */
+
+  /* NewReno */
+  ulong ssthresh;       /* slow start threshold in bytes */
+  ulong ack_acc;        /* bytes acked towards next cwnd increment */
+
+  /* Round trip tracking.  A round ends when a packet sent after the
+     start of the round is acknowledged. */
+  long  round_start;         /* start time of current round */
+  ulong delivered;           /* cumulative bytes acked */
+  ulong round_delivered;     /* delivered at start of round */
+  ulong round_lost;          /* bytes lost during round */
+  ulong round_inflight;      /* max inflight during round */
+  ulong prev_round_inflight; /* max inflight during previous round */
+
+  /* BBR */
+  uint  bbr_state;      /* FD_QUIC_CC_BBR_STATE_{...} */
+  uint  bbr_cycle_idx;  /* index into PROBE_BW gain cycle */
+  uint  bbr_full_bw_cnt;/* rounds without significant bw growth */
+  uint  bbr_bw_idx;     /* next slot in bbr_bw */
+  float bbr_full_bw;    /* bw at last significant growth, bytes per ns */
+  float bbr_bw[ FD_QUIC_CC_BBR_BW_WIN ]; /* per-round delivery rates */
+  float bbr_min_rtt;    /* min RTT in ns */
+  ulong inflight_hi;    /* upper bound on inflight, reduced on loss */
+};
+
+typedef struct fd_quic_cc fd_quic_cc_t;
+
+FD_PROTOTYPES_BEGIN
+
+/* fd_quic_cc_init initializes a congestion controller for a new
+   connection.  mtu is the max datagram size.  rtt is the connection's
+   initial RTT estimate.  Returns cc. */
+
+fd_quic_cc_t *
+fd_quic_cc_init( fd_quic_cc_t *            cc,
+                 uint                      algo,
+                 ulong                     mtu,
+                 fd_rtt_estimate_t const * rtt,
+                 long                      now );
+
+/* fd_quic_cc_next_send returns the earliest time >= now at which an
+   ack-eliciting packet may be sent.  Returns now if the packet may be
+   sent immediately, LONG_MAX if the connection is cwnd-limited (the
+   caller should wait for an ACK or loss), or the time the pacer
+   releases the next packet otherwise. */
+
+static inline long
+fd_quic_cc_next_send( fd_quic_cc_t * cc,
+                      long           now ) {
+  if( cc->algo==FD_QUIC_CC_ALGO_NONE ) return now;
+  if( cc->inflight >= cc->cwnd       ) return LONG_MAX;
+
+  float burst  = (float)( FD_QUIC_CC_PACE_BURST_CNT * cc->mtu );
+  float tokens = cc->pace_tokens + (float)( now - cc->pace_ts ) * cc->pace_rate;
+  cc->pace_tokens = fminf( tokens, burst );
+  cc->pace_ts     = now;
+
+  if( cc->pace_tokens >= 0.f ) return now;
+  return now + 1L + (long)( -cc->pace_tokens / cc->pace_rate );
+}
+
+/* fd_quic_cc_on_sent records that an ack-eliciting packet of sz bytes
+   was sent.  Should be called shortly after fd_quic_cc_next_send
+   returned a time <= now. */
+
+static inline void
+fd_quic_cc_on_sent( fd_quic_cc_t * cc,
+                    ulong          sz ) {
+  cc->inflight       += sz;
+  cc->pace_tokens    -= (float)sz;
+  cc->round_inflight  = fd_ulong_max( cc->round_inflight, cc->inflight );
+}
+
+/* fd_quic_cc_on_ack records that a packet of sz bytes sent at tx_time
+   was acknowledged at time now.  rtt is the connection's current RTT
+   estimate. */
+
+void
+fd_quic_cc_on_ack( fd_quic_cc_t *            cc,
+                   ulong                     sz,
+                   long                      tx_time,
+                   fd_rtt_estimate_t const * rtt,
+                   long                      now );
+
+/* fd_quic_cc_on_loss records that a packet of sz bytes sent at tx_time
+   was declared lost at time now.  Returns 1 if this loss started a new
+   congestion event (i.e. the congestion window was reduced), 0
+   otherwise. */
+
+int
+fd_quic_cc_on_loss( fd_quic_cc_t *            cc,
+                    ulong                     sz,
+                    long                      tx_time,
+                    fd_rtt_estimate_t const * rtt,
+                    long                      now );
+
+/* fd_quic_cc_algo_name returns a cstr with the name of the given
+   algorithm ("none", "newreno", "bbr") or "unknown". */
+
+FD_FN_CONST char const *
+fd_quic_cc_algo_name( uint algo );
+
+/* fd_quic_cc_algo_from_cstr returns the FD_QUIC_CC_ALGO_{...} matching
+   name, or -1 if name is not a known algorithm. */
+
+FD_FN_PURE int
+fd_quic_cc_algo_from_cstr( char const * name );
+
+FD_PROTOTYPES_END
+
+#endif /* HEADER_fd_src_waltz_quic_fd_quic_cc_h */
@@ -4,6 +4,7 @@
 #include "fd_quic.h"
 #include "fd_quic_common.h"
 #include "fd_quic_ack_tx.h"
+#include "fd_quic_cc.h"
 #include "fd_quic_stream.h"
 #include "fd_quic_conn_id.h"
 #include "crypto/fd_quic_crypto_suites.h"
@@ -222,6 +223,9 @@ struct fd_quic_conn {
   float peer_ack_delay_scale;  /* convert ACK delay units to nanoseconds */
   float peer_max_ack_delay_ns; /* peer max ack delay in nanoseconds */
 
+  /* congestion control and pacing */
+  fd_quic_cc_t cc[1];
+
   ulong token_len;
   uchar token[ FD_QUIC_RETRY_MAX_TOKEN_SZ ];
 
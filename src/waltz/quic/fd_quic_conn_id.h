@@ -51,7 +51,7 @@ fd_quic_conn_id_rand( fd_quic_conn_id_t * conn_id,
        the endpoint upon receipt. */
   /* this means we can generate a connection id with the property that it can
      be delivered to the same endpoint by flow control */
-  /* TODO load balancing / flow steering */
+  /* flow steering of server conn IDs is done by fd_quic_conn_id_steer */
 
   /* padding must be set to zero also */
   *conn_id = (fd_quic_conn_id_t){ .sz = 8u, .conn_id = {0u}, .pad = {0u} };
@@ -59,6 +59,49 @@ fd_quic_conn_id_rand( fd_quic_conn_id_t * conn_id,
   return conn_id;
 }
 
+/* fd_quic_conn_id_steer tags a locally issued 8 byte conn ID with a
+   steering index.  conn_id is the conn ID as an integer (as it appears
+   on the wire in little endian order).  If steer is non-zero, the low
+   byte (the first conn ID byte on the wire) is replaced with the low 8
+   bits of steer_idx.  The remaining 56 bits stay random.  This allows a
+   stateless load balancer to route all packets of a conn to the same
+   QUIC instance (see fd_quic_steer_idx). */
+
+FD_FN_CONST static inline ulong
+fd_quic_conn_id_steer( ulong conn_id,
+                       int   steer,
+                       uint  steer_idx ) {
+  if( !steer ) return conn_id;
+  return ( conn_id & ~0xffUL ) | (ulong)( steer_idx & 0xffU );
+}
+
+/* fd_quic_steer_idx peeks at the destination conn ID of a raw QUIC
+   datagram (payload points to the first byte of the UDP payload, sz is
+   the UDP payload size) and returns the steering index that was tagged
+   by fd_quic_conn_id_steer.  Only packets that can carry a conn ID
+   issued by a Firedancer server are considered: 1-RTT (short header)
+   packets and Handshake packets with an 8 byte DCID.  Returns -1 for
+   Initial, 0-RTT and Retry packets (the DCID was picked by the client),
+   and for malformed or truncated packets.  Does not validate that the
+   packet is authentic, so the result should only be used as a hint. */
+
+FD_FN_PURE static inline int
+fd_quic_steer_idx( uchar const * payload,
+                   ulong         sz ) {
+  if( FD_UNLIKELY( sz<1UL ) ) return -1;
+  uint h0 = payload[0];
+  if( !( h0 & 0x80U ) ) {
+    /* short header: DCID follows the first byte, length is implied */
+    if( FD_UNLIKELY( sz<1UL+FD_QUIC_CONN_ID_SZ ) ) return -1;
+    return (int)payload[1];
+  }
+  /* long header: 1 byte flags, 4 byte version, 1 byte DCID len */
+  if( ( (h0>>4) & 3U )!=2U ) return -1; /* not Handshake */
+  if( FD_UNLIKELY( sz<6UL+FD_QUIC_CONN_ID_SZ ) ) return -1;
+  if( payload[5]!=FD_QUIC_CONN_ID_SZ ) return -1;
+  return (int)payload[6];
+}
+
 FD_PROTOTYPES_END
 
 /* Defines a NULL connection id
@@ -66,6 +66,8 @@ struct fd_quic_pkt_meta {
   fd_quic_pkt_meta_value_t val;
   uchar                    enc_level: 2;
   uchar                    pn_space;    /* packet number space (derived from enc_level) */
+  ushort                   tx_sz;       /* if non-zero, size of the congestion controlled
+                                           packet (set on one pkt_meta per packet) */
   long                     tx_time;     /* transmit time */
   long                     expiry;      /* time pkt_meta expires... this is the time the
                                          ack is expected by */
@@ -100,6 +100,11 @@ struct __attribute__((aligned(16UL))) fd_quic_state_private {
   /* Scratch space for packet protection */
   uchar                   crypt_scratch[FD_QUIC_MTU];
 
+  /* Expanded 1-RTT packet protection keys of recently active conns,
+     crypto_cache_cnt slots (see fd_quic_limits_t) */
+  fd_quic_crypto_ctx_t  * crypto_cache;
+  ulong                   crypto_cache_cnt;
+
   /* the timer structs, large private fields / data follow */
   fd_quic_svc_timers_t  * svc_timers;
 };
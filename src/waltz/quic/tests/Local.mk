@@ -19,6 +19,7 @@ $(call make-unit-test,test_quic_svc_q,test_quic_svc_q,$(QUIC_TEST_LIBS))
 $(call make-unit-test,test_quic_pkt_meta,test_quic_pkt_meta,$(QUIC_TEST_LIBS))
 $(call make-unit-test,test_quic_keep_alive,test_quic_keep_alive,$(QUIC_TEST_LIBS))
 $(call make-unit-test,test_quic_retx,test_quic_retx,$(QUIC_TEST_LIBS))
+$(call make-unit-test,test_quic_cc,test_quic_cc,fd_quic fd_util)
 $(call run-unit-test,test_quic_proto)
 $(call run-unit-test,test_quic_hs)
 $(call run-unit-test,test_quic_streams)
@@ -32,6 +33,7 @@ $(call run-unit-test,test_quic_concurrency)
 $(call run-unit-test,test_quic_svc_q)
 $(call run-unit-test,test_quic_pkt_meta)
 $(call run-unit-test,test_quic_keep_alive)
+$(call run-unit-test,test_quic_cc)
 
 # fd_quic_tls unit tests
 $(call make-unit-test,test_quic_tls_hs,test_quic_tls_hs,$(QUIC_TEST_LIBS))
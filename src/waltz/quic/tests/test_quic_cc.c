@@ -0,0 +1,192 @@
+#include "../../../util/fd_util.h"
+#include "../fd_quic_cc.h"
+
+#define MTU (1200UL)
+
+static fd_rtt_estimate_t
+test_rtt( float rtt_ns ) {
+  return (fd_rtt_estimate_t){
+    .latest_rtt   = rtt_ns,
+    .min_rtt      = rtt_ns,
+    .smoothed_rtt = rtt_ns,
+    .var_rtt      = rtt_ns*0.5f,
+    .is_rtt_valid = 1
+  };
+}
+
+static void
+test_cc_none( void ) {
+  fd_rtt_estimate_t rtt = test_rtt( 100e6f );
+  fd_quic_cc_t cc[1];
+  fd_quic_cc_init( cc, FD_QUIC_CC_ALGO_NONE, MTU, &rtt, 1L );
+  FD_TEST( cc->cwnd==ULONG_MAX );
+  for( ulong j=0UL; j<1000UL; j++ ) {
+    FD_TEST( fd_quic_cc_next_send( cc, 1L )==1L );
+    fd_quic_cc_on_sent( cc, MTU );
+  }
+  FD_TEST( !fd_quic_cc_on_loss( cc, MTU, 1L, &rtt, 2L ) );
+}
+
+static void
+test_cc_newreno( void ) {
+  fd_rtt_estimate_t rtt = test_rtt( 100e6f );
+  long now = 1000L;
+  fd_quic_cc_t cc[1];
+  fd_quic_cc_init( cc, FD_QUIC_CC_ALGO_NEWRENO, MTU, &rtt, now );
+
+  /* Initial window is 10 datagrams (RFC 9002 Section 7.2) */
+  ulong const iw = 10UL*MTU;
+  FD_TEST( cc->cwnd==iw );
+
+  /* Initial window may be sent as one burst */
+  ulong sent = 0UL;
+  while( fd_quic_cc_next_send( cc, now )==now ) {
+    fd_quic_cc_on_sent( cc, MTU );
+    sent++;
+  }
+  FD_TEST( sent==10UL );
+  FD_TEST( cc->inflight==iw );
+  FD_TEST( fd_quic_cc_next_send( cc, now )==LONG_MAX ); /* cwnd-limited */
+
+  /* Slow start: each ACK grows cwnd by the acked bytes */
+  long tx_time = now;
+  now += 100000000L;
+  for( ulong j=0UL; j<10UL; j++ ) fd_quic_cc_on_ack( cc, MTU, tx_time, &rtt, now );
+  FD_TEST( cc->inflight==0UL );
+  FD_TEST( cc->cwnd==2UL*iw );
+
+  /* The pacer now spreads packets out over the RTT */
+  FD_TEST( cc->pace_rate>0.f );
+  sent = 0UL;
+  while( fd_quic_cc_next_send( cc, now )==now ) {
+    fd_quic_cc_on_sent( cc, MTU );
+    sent++;
+  }
+  FD_TEST( sent<20UL );
+  long next = fd_quic_cc_next_send( cc, now );
+  FD_TEST( next>now && next!=LONG_MAX );
+  FD_TEST( fd_quic_cc_next_send( cc, next )==next );
+
+  /* Loss halves the window, once per recovery period */
+  tx_time = now;
+  now    += 100000000L;
+  ulong cwnd0 = cc->cwnd;
+  FD_TEST(  fd_quic_cc_on_loss( cc, MTU, tx_time, &rtt, now ) );
+  FD_TEST( cc->cwnd==cwnd0/2UL );
+  FD_TEST( cc->ssthresh==cc->cwnd );
+  FD_TEST( !fd_quic_cc_on_loss( cc, MTU, tx_time, &rtt, now ) );
+  FD_TEST( cc->cwnd==cwnd0/2UL );
+
+  /* No growth for packets sent before recovery started */
+  ulong cwnd1 = cc->cwnd;
+  cc->inflight = cc->cwnd;
+  fd_quic_cc_on_ack( cc, MTU, tx_time, &rtt, now );
+  FD_TEST( cc->cwnd==cwnd1 );
+
+  /* Congestion avoidance: one datagram per window acked */
+  tx_time = now + 1L;
+  now    += 200000000L;
+  ulong acked = 0UL;
+  while( acked<cwnd1 ) {
+    cc->inflight = cc->cwnd;
+    fd_quic_cc_on_ack( cc, MTU, tx_time, &rtt, now );
+    acked += MTU;
+  }
+  FD_TEST( cc->cwnd==cwnd1+MTU );
+
+  /* Window never drops below the minimum */
+  for( ulong j=0UL; j<32UL; j++ ) {
+    tx_time = now + 1L;
+    now    += 1000L;
+    fd_quic_cc_on_loss( cc, MTU, tx_time, &rtt, now );
+  }
+  FD_TEST( cc->cwnd==2UL*MTU );
+
+  /* Window does not grow while application-limited */
+  fd_quic_cc_init( cc, FD_QUIC_CC_ALGO_NEWRENO, MTU, &rtt, now );
+  for( ulong j=0UL; j<8UL; j++ ) {
+    tx_time = now;
+    now    += 100000000L;
+    fd_quic_cc_on_sent( cc, MTU );
+    fd_quic_cc_on_ack( cc, MTU, tx_time, &rtt, now );
+  }
+  FD_TEST( cc->cwnd==iw );
+}
+
+/* test_cc_bbr simulates a sender against a fixed rate bottleneck with
+   a fixed propagation delay.  Checks that BBR converges to a window
+   close to the bandwidth-delay product, and that excess loss bounds
+   inflight. */
+
+static void
+test_cc_bbr( void ) {
+  float const rtt_ns = 50e6f;            /* 50 ms */
+  float const bw     = 12.5e6f / 1e9f;   /* 100 Mbps in bytes/ns */
+  float const bdp    = bw * rtt_ns;      /* 625 KB */
+
+  fd_rtt_estimate_t rtt = test_rtt( rtt_ns );
+  long now = 1L;
+  fd_quic_cc_t cc[1];
+  fd_quic_cc_init( cc, FD_QUIC_CC_ALGO_BBR, MTU, &rtt, now );
+  FD_TEST( cc->bbr_state==FD_QUIC_CC_BBR_STATE_STARTUP );
+
+  /* Each step is one RTT.  The bottleneck delivers up to one BDP of
+     the queued packets (in send order), then the sender fills the
+     window back up. */
+# define TX_RING_CNT (8192UL)
+  static long tx_ring[ TX_RING_CNT ];
+  ulong tx_head = 0UL; /* next packet to send */
+  ulong tx_tail = 0UL; /* oldest unacked packet */
+  ulong const cap_pkts = (ulong)bdp / MTU;
+  for( ulong step=0UL; step<60UL; step++ ) {
+    now += (long)rtt_ns;
+    for( ulong j=0UL; j<cap_pkts && tx_tail<tx_head; j++, tx_tail++ ) {
+      fd_quic_cc_on_ack( cc, MTU, tx_ring[ tx_tail%TX_RING_CNT ], &rtt, now );
+    }
+    while( cc->inflight < cc->cwnd ) {
+      FD_TEST( tx_head-tx_tail < TX_RING_CNT );
+      tx_ring[ (tx_head++)%TX_RING_CNT ] = now;
+      fd_quic_cc_on_sent( cc, MTU );
+    }
+  }
+# undef TX_RING_CNT
+
+  FD_TEST( cc->bbr_state==FD_QUIC_CC_BBR_STATE_PROBE_BW );
+  FD_TEST( (float)cc->cwnd >= 1.0f*bdp );
+  FD_TEST( (float)cc->cwnd <= 3.0f*bdp );
+  FD_TEST( cc->pace_rate >= 0.5f*bw && cc->pace_rate <= 1.5f*bw );
+
+  /* Heavy loss bounds inflight */
+  ulong cwnd0   = cc->cwnd;
+  long  tx_time = now;
+  now += (long)rtt_ns;
+  int event = 0;
+  for( ulong j=0UL; j<100UL; j++ ) event |= fd_quic_cc_on_loss( cc, MTU, tx_time, &rtt, now );
+  FD_TEST( event );
+  FD_TEST( cc->inflight_hi < cwnd0 );
+  FD_TEST( cc->cwnd <= cc->inflight_hi );
+}
+
+static void
+test_cc_algo_name( void ) {
+  for( uint algo=0U; algo<FD_QUIC_CC_ALGO_CNT; algo++ ) {
+    FD_TEST( fd_quic_cc_algo_from_cstr( fd_quic_cc_algo_name( algo ) )==(int)algo );
+  }
+  FD_TEST( !strcmp( fd_quic_cc_algo_name( FD_QUIC_CC_ALGO_CNT ), "unknown" ) );
+  FD_TEST( fd_quic_cc_algo_from_cstr( "cubic" )==-1 );
+}
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  test_cc_none();
+  test_cc_newreno();
+  test_cc_bbr();
+  test_cc_algo_name();
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
@@ -1,5 +1,7 @@
 #include "../crypto/fd_quic_crypto_suites.h"
 
+#define TEST_CRYPTO_CACHE_CNT (64UL)
+
 FD_IMPORT_BINARY( test_client_initial,   "src/waltz/quic/fixtures/rfc9001-client-initial-payload.bin"   );
 FD_IMPORT_BINARY( test_client_encrypted, "src/waltz/quic/fixtures/rfc9001-client-initial-encrypted.bin" );
 
@@ -285,6 +287,44 @@ main( int     argc,
 
   FD_LOG_INFO(( "decrypted packet matches original packet" ));
 
+  /* Cached key schedules give identical results, including when
+     reused across multiple packets */
+  static fd_quic_crypto_ctx_t cache[ TEST_CRYPTO_CACHE_CNT ];
+  fd_quic_crypto_ctx_t * ctx = fd_quic_crypto_cache_query( cache, TEST_CRYPTO_CACHE_CNT, &client_keys );
+  FD_TEST( ctx->valid );
+  FD_TEST( fd_quic_crypto_cache_query( cache, TEST_CRYPTO_CACHE_CNT, &client_keys )==ctx );
+  for( ulong rep=0UL; rep<2UL; rep++ ) {
+    ulong ctx_cipher_sz = sizeof(cipher_text_);
+    uchar ctx_cipher[4096];
+    FD_TEST( fd_quic_crypto_ctx_encrypt(
+        ctx_cipher, &ctx_cipher_sz,
+        hdr,        hdr_sz,
+        pkt,        pkt_sz,
+        ctx, ctx,
+        pkt_number )==FD_QUIC_SUCCESS );
+    FD_TEST( ctx_cipher_sz==test_client_encrypted_sz );
+    FD_TEST( fd_memeq( ctx_cipher, test_client_encrypted, test_client_encrypted_sz ) );
+
+    FD_TEST( fd_quic_crypto_ctx_decrypt_hdr( ctx_cipher, ctx_cipher_sz, pn_offset,             ctx )==FD_QUIC_SUCCESS );
+    FD_TEST( fd_quic_crypto_ctx_decrypt    ( ctx_cipher, ctx_cipher_sz, pn_offset, pkt_number, ctx )==FD_QUIC_SUCCESS );
+    FD_TEST( 0==memcmp( ctx_cipher,          hdr,                 hdr_sz                 ) );
+    FD_TEST( 0==memcmp( ctx_cipher + hdr_sz, test_client_initial, test_client_initial_sz ) );
+  }
+
+  /* Different keys never alias a cached context */
+  fd_quic_crypto_ctx_t * server_ctx = fd_quic_crypto_cache_query( cache, TEST_CRYPTO_CACHE_CNT, &server_keys );
+  FD_TEST( 0==memcmp( &server_ctx->keys, &server_keys, sizeof(fd_quic_crypto_keys_t) ) );
+  ctx = fd_quic_crypto_cache_query( cache, TEST_CRYPTO_CACHE_CNT, &client_keys );
+  FD_TEST( 0==memcmp( &ctx->keys, &client_keys, sizeof(fd_quic_crypto_keys_t) ) );
+
+  /* A single slot cache still never aliases */
+  static fd_quic_crypto_ctx_t cache1[ 1 ];
+  FD_TEST( fd_quic_crypto_cache_query( cache1, 1UL, &client_keys )==cache1 );
+  FD_TEST( 0==memcmp( &cache1->keys, &client_keys, sizeof(fd_quic_crypto_keys_t) ) );
+  FD_TEST( fd_quic_crypto_cache_query( cache1, 1UL, &server_keys )==cache1 );
+  FD_TEST( 0==memcmp( &cache1->keys, &server_keys, sizeof(fd_quic_crypto_keys_t) ) );
+  FD_TEST( 0==memcmp( &ctx->keys, &client_keys, sizeof(fd_quic_crypto_keys_t) ) );
+
   /* Undersz header */
   fd_memcpy( revert, cipher_text, cipher_text_sz );
   FD_TEST( fd_quic_crypto_decrypt_hdr(
@@ -367,6 +407,16 @@ main( int     argc,
     dt += fd_log_wallclock();
     float gbps = ((float)(8UL*(70UL+sz)*iter)) / ((float)dt);
     FD_LOG_NOTICE(( "~%6.3f Gbps Ethernet equiv throughput / core (sz %4lu)", (double)gbps, sz ));
+
+    /* with cached key schedules */
+    dt = -fd_log_wallclock();
+    for( ulong rem=iter; rem; rem-- ) {
+      fd_quic_crypto_ctx_decrypt_hdr( buf2, sz, 0,       fd_quic_crypto_cache_query( cache, TEST_CRYPTO_CACHE_CNT, &client_keys ) );
+      fd_quic_crypto_ctx_decrypt    ( buf2, sz, 0, 1234, fd_quic_crypto_cache_query( cache, TEST_CRYPTO_CACHE_CNT, &client_keys ) );
+    }
+    dt += fd_log_wallclock();
+    gbps = ((float)(8UL*(70UL+sz)*iter)) / ((float)dt);
+    FD_LOG_NOTICE(( "~%6.3f Gbps Ethernet equiv throughput / core (sz %4lu, cached keys)", (double)gbps, sz ));
   } while(0);
 
   FD_LOG_NOTICE(( "Benchmarking header+payload encrypt" ));
@@ -391,6 +441,17 @@ main( int     argc,
     dt += fd_log_wallclock();
     float gbps = ((float)(8UL*(70UL+out_sz)*iter)) / ((float)dt);
     FD_LOG_NOTICE(( "~%6.3f Gbps Ethernet equiv throughput / core (sz %4lu)", (double)gbps, out_sz ));
+
+    /* with cached key schedules */
+    dt = -fd_log_wallclock();
+    for( ulong rem=iter; rem; rem-- ) {
+      ulong out_sz_ = out_sz;
+      fd_quic_crypto_ctx_t * ctx = fd_quic_crypto_cache_query( cache, TEST_CRYPTO_CACHE_CNT, &client_keys );
+      fd_quic_crypto_ctx_encrypt( buf2, &out_sz_, hdr, hdr_sz, buf1, sz, ctx, ctx, 1234 );
+    }
+    dt += fd_log_wallclock();
+    gbps = ((float)(8UL*(70UL+out_sz)*iter)) / ((float)dt);
+    FD_LOG_NOTICE(( "~%6.3f Gbps Ethernet equiv throughput / core (sz %4lu, cached keys)", (double)gbps, out_sz ));
   } while(0);
 
   test_quic_short_pn();
@@ -76,6 +76,37 @@ validate_quic_hs_tls_cache( fd_quic_t * quic ) {
 /* global "clock" */
 long now = 123;
 
+static void
+test_quic_steer_idx( void ) {
+  FD_LOG_NOTICE(( "Testing QUIC conn ID steering" ));
+
+  FD_TEST( fd_quic_conn_id_steer( 0x0123456789abcdefUL, 0, 0x42U )==0x0123456789abcdefUL );
+  FD_TEST( fd_quic_conn_id_steer( 0x0123456789abcdefUL, 1, 0x42U )==0x0123456789abcd42UL );
+
+  uchar pkt[ 32 ];
+  fd_memset( pkt, 0, sizeof(pkt) );
+
+  /* 1-RTT (short header) */
+  pkt[0] = 0x40; FD_STORE( ulong, pkt+1, fd_quic_conn_id_steer( 0UL, 1, 7U ) );
+  FD_TEST( fd_quic_steer_idx( pkt, sizeof(pkt) )==7 );
+  FD_TEST( fd_quic_steer_idx( pkt, 9UL         )==7 );
+  FD_TEST( fd_quic_steer_idx( pkt, 8UL         )==-1 );
+  FD_TEST( fd_quic_steer_idx( pkt, 0UL         )==-1 );
+
+  /* Handshake (long header, 8 byte DCID) */
+  pkt[0] = 0xe0; pkt[5] = 8; pkt[6] = 0x99;
+  FD_TEST( fd_quic_steer_idx( pkt, sizeof(pkt) )==0x99 );
+  FD_TEST( fd_quic_steer_idx( pkt, 13UL        )==-1 );
+  pkt[5] = 20;
+  FD_TEST( fd_quic_steer_idx( pkt, sizeof(pkt) )==-1 );
+
+  /* Initial, 0-RTT, Retry: DCID chosen by client */
+  pkt[5] = 8;
+  pkt[0] = 0xc0; FD_TEST( fd_quic_steer_idx( pkt, sizeof(pkt) )==-1 );
+  pkt[0] = 0xd0; FD_TEST( fd_quic_steer_idx( pkt, sizeof(pkt) )==-1 );
+  pkt[0] = 0xf0; FD_TEST( fd_quic_steer_idx( pkt, sizeof(pkt) )==-1 );
+}
+
 static void
 test_quic_hs( fd_quic_t * server_quic,
               fd_quic_t * client_quic ) {
@@ -108,6 +139,13 @@ test_quic_hs( fd_quic_t * server_quic,
   fflush( fd_quic_test_pcap );
   FD_TEST( server_complete && client_complete );
 
+  /* The server's conn ID as seen by the client carries the steering
+     index in its first byte */
+  if( server_quic->config.steer ) {
+    FD_TEST( client_conn->peer_cids[0].sz==FD_QUIC_CONN_ID_SZ );
+    FD_TEST( client_conn->peer_cids[0].conn_id[0]==(uchar)server_quic->config.steer_idx );
+  }
+
   /* TODO detect missing QUIC transport params */
 
   /* TODO we get callback before the call to fd_quic_conn_new_stream can complete
@@ -426,6 +464,11 @@ main( int argc, char ** argv ) {
   server_quic->config.initial_rx_max_stream_data = 1<<16;
   client_quic->config.initial_rx_max_stream_data = 1<<16;
 
+  server_quic->config.steer     = 1;
+  server_quic->config.steer_idx = 0x5aU;
+
+  test_quic_steer_idx();
+
   FD_LOG_NOTICE(( "Creating virtual pair" ));
   fd_quic_virtual_pair_t vp;
   fd_quic_virtual_pair_init( &vp, server_quic, client_quic );